@@ -3,3 +3,5 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 // Automatically @generated lib.rs for the cc_libary string_type.
+
+extern crate string_interner_sys;
@@ -5,3 +5,4 @@
 // Automatically @generated lib.rs for the cc_libary ast_consumer.
 
 extern crate importer_sys;
+extern crate timing_report_sys;
@@ -6,4 +6,5 @@
 
 extern crate cc_ir_sys;
 extern crate lifetime_annotations_sys;
+extern crate timing_report_sys;
 extern crate type_lifetimes_sys;
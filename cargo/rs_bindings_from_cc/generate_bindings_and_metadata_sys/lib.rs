@@ -11,3 +11,4 @@ extern crate cmdline_sys;
 extern crate collect_namespaces_sys;
 extern crate ir_from_cc_sys;
 extern crate src_code_gen_sys;
+extern crate timing_report_sys;
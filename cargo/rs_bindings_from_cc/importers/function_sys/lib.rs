@@ -4,10 +4,12 @@
 
 // Automatically @generated lib.rs for the cc_libary function.
 
+extern crate annotation_reader_sys;
 extern crate ast_util_sys;
 extern crate cc_ir_sys;
 extern crate lifetime_annotations_sys;
 extern crate lifetime_symbol_table_sys;
 extern crate lifetime_sys;
 extern crate recording_diagnostic_consumer_sys;
+extern crate status_macros_sys;
 extern crate type_lifetimes_sys;
@@ -6,3 +6,4 @@
 
 extern crate cc_ir_sys;
 extern crate frontend_action_sys;
+extern crate timing_report_sys;
@@ -0,0 +1,8 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Automatically @generated lib.rs for the cc_libary precompiled_module.
+
+extern crate cc_ir_sys;
+extern crate file_io_sys;
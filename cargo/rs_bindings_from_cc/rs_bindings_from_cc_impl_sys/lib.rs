@@ -9,3 +9,6 @@ extern crate cmdline_sys;
 extern crate collect_namespaces_sys;
 extern crate file_io_sys;
 extern crate generate_bindings_and_metadata_sys;
+extern crate persistent_worker_sys;
+extern crate precompiled_module_sys;
+extern crate timing_report_sys;
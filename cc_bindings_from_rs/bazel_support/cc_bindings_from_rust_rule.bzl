@@ -130,7 +130,14 @@ def _generate_bindings(ctx, target, basename, inputs, args, rustc_env):
     for feature in features:
         crubit_args.add("--crate-feature", "self=" + feature)
 
-    outputs = [h_out_file, rs_out_file]
+    api_hash_file = ctx.actions.declare_file(basename + "_cc_api_hash.txt")
+    crubit_args.add("--api-hash-out", api_hash_file.path)
+    outputs = [h_out_file, rs_out_file, api_hash_file]
+    h_modules_dir = None
+    if ctx.attr._split_h_by_module[BuildSettingInfo].value:
+        h_modules_dir = ctx.actions.declare_directory(basename + "_modules")
+        crubit_args.add("--h-out-modules-dir", h_modules_dir.path)
+        outputs.append(h_modules_dir)
     if ctx.attr._generate_error_report[BuildSettingInfo].value:
         error_report_output = ctx.actions.declare_file(basename + "_cc_api_error_report.json")
         crubit_args.add(
@@ -138,6 +145,10 @@ def _generate_bindings(ctx, target, basename, inputs, args, rustc_env):
             error_report_output.path,
         )
         outputs.append(error_report_output)
+    if ctx.attr._prune_crate_header_includes[BuildSettingInfo].value:
+        crubit_args.add("--prune-crate-header-includes")
+    if ctx.attr._inline_trivial_functions[BuildSettingInfo].value:
+        crubit_args.add("--inline-trivial-functions")
     config = crate_name_to_library_config(ctx)
     current_config = config.get("self", None)
     for crate_name, crate_config in config.items():
@@ -173,17 +184,20 @@ def _generate_bindings(ctx, target, basename, inputs, args, rustc_env):
 
     generated_bindings_info = GeneratedBindingsInfo(
         h_file = h_out_file,
+        h_modules_dir = h_modules_dir,
         rust_file = rs_out_file,
+        api_hash_file = api_hash_file,
     )
 
     return generated_bindings_info, features, current_config
 
-def _make_cc_info_for_h_out_file(ctx, h_out_file, extra_cc_hdrs, extra_cc_srcs, cc_infos):
+def _make_cc_info_for_h_out_file(ctx, h_out_file, h_modules_dirs, extra_cc_hdrs, extra_cc_srcs, cc_infos):
     """Creates and returns CcInfo for the generated ..._cc_api.h header file.
 
     Args:
       ctx: The rule context.
       h_out_file: The generated "..._cc_api.h" header file
+      h_modules_dirs: The directories with the headers that h_out_file includes, if any
       cc_infos: cc_infos for dependencies of the h_out_file - should include both:
           1) the target `crate` and
           2) the compiled Rust glue crate (`..._cc_api_impl.rs` file).
@@ -207,7 +221,7 @@ def _make_cc_info_for_h_out_file(ctx, h_out_file, extra_cc_hdrs, extra_cc_srcs,
         feature_configuration = feature_configuration,
         cc_toolchain = cc_toolchain,
         srcs = extra_cc_srcs,
-        public_hdrs = [h_out_file] + extra_cc_hdrs,
+        public_hdrs = [h_out_file] + h_modules_dirs + extra_cc_hdrs,
         compilation_contexts = [cc_info.compilation_context],
     )
     (linking_context, _) = cc_common.create_linking_context_from_compilation_outputs(
@@ -349,6 +363,7 @@ def _cc_bindings_from_rust_aspect_impl(target, ctx):
     cc_info = _make_cc_info_for_h_out_file(
         ctx,
         bindings_info.h_file,
+        [bindings_info.h_modules_dir] if bindings_info.h_modules_dir else [],
         extra_cc_hdrs,
         extra_cc_srcs,
         cc_infos = [target[CcInfo], impl_cc_info] + [
@@ -386,7 +401,12 @@ cc_bindings_from_rust_aspect = aspect(
             doc = "Dependencies needed to build the C++ sources generated by cc_bindings_from_rs.",
             default = [
                 "//support/internal:bindings_support",
+                "//support/rs_std:boxed_future",
+                "//support/rs_std:boxed_iterator",
+                "//support/rs_std:dyn_callback",
+                "//support/rs_std:owned_slice",
                 "//support/rs_std:rs_char",
+                "//support/rs_std:str_ref",
                 "//support/public:slice_ref",
             ],
         ),
@@ -419,6 +439,15 @@ cc_bindings_from_rust_aspect = aspect(
         "_generate_error_report": attr.label(
             default = "//cc_bindings_from_rs/bazel_support:generate_error_report",
         ),
+        "_split_h_by_module": attr.label(
+            default = "//cc_bindings_from_rs/bazel_support:split_h_by_module",
+        ),
+        "_prune_crate_header_includes": attr.label(
+            default = "//cc_bindings_from_rs/bazel_support:prune_crate_header_includes",
+        ),
+        "_inline_trivial_functions": attr.label(
+            default = "//cc_bindings_from_rs/bazel_support:inline_trivial_functions",
+        ),
         "_globally_enabled_features": attr.label(
             default = "//common/bazel_support:globally_enabled_features",
         ),
@@ -22,7 +22,13 @@ GeneratedBindingsInfo = provider(
     doc = "A provider that contains the generated C++ and Rust files.",
     fields = {
         "h_file": "The generated C++ header file.",
+        "h_modules_dir": "The directory with the generated C++ headers of the top-level modules, " +
+                         "or None if the header isn't split by module.",
         "rust_file": "The generated Rust source file.",
+        "api_hash_file": ("A file with a hash of the API of the generated C++ headers, which " +
+                          "ignores comments and formatting. Unlike the headers, it doesn't change " +
+                          "when only implementation details of the crate do, so dependents can " +
+                          "key on it instead."),
     },
 )
 
@@ -4,6 +4,7 @@
 #![feature(rustc_private)]
 #![deny(rustc::internal)]
 
+extern crate rustc_ast;
 extern crate rustc_attr;
 extern crate rustc_hir;
 extern crate rustc_infer;
@@ -21,6 +22,7 @@ use error_report::{anyhow, bail, ensure, ErrorReporting};
 use itertools::Itertools;
 use proc_macro2::{Ident, Literal, TokenStream};
 use quote::{format_ident, quote, ToTokens};
+use rustc_ast::LitKind;
 use rustc_attr::find_deprecation;
 use rustc_hir::def::{DefKind, Res};
 use rustc_hir::{AssocItemKind, HirId, Item, ItemKind, Node, Safety, UseKind, UsePath};
@@ -29,12 +31,13 @@ use rustc_middle::dep_graph::DepContext;
 use rustc_middle::mir::ConstValue;
 use rustc_middle::mir::Mutability;
 use rustc_middle::ty::{self, AdtDef, GenericArg, IntTy, Region, Ty, TyCtxt, UintTy};
-use rustc_span::def_id::{CrateNum, DefId, LocalDefId, LocalModDefId, LOCAL_CRATE};
+use rustc_span::def_id::{CrateNum, DefId, LocalDefId, LocalModDefId, CRATE_DEF_ID, LOCAL_CRATE};
 use rustc_span::symbol::{kw, sym, Symbol};
 use rustc_target::abi::{
     AddressSpace, BackendRepr, FieldIdx, FieldsShape, Integer, Layout, Primitive, Scalar,
     VariantIdx, Variants,
 };
+use rustc_target::spec::PanicStrategy;
 use rustc_trait_selection::infer::InferCtxtExt;
 use rustc_type_ir::RegionKind;
 use std::collections::{BTreeSet, HashMap, HashSet};
@@ -92,6 +95,40 @@ memoized::query_group! {
         #[input]
         fn h_out_include_guard(&self) -> IncludeGuard;
 
+        /// If set, the C++ bindings are split into one header per top-level
+        /// module of the crate (see `Output::h_modules`), and the main header
+        /// includes them from this path, relative to the main header.
+        #[input]
+        fn h_out_modules_include_prefix(&self) -> Option<Rc<str>>;
+
+        /// Whether the C++ bindings of trivial Rust functions (e.g. getters of
+        /// fields, or functions returning a literal) should replicate the body of
+        /// the Rust function, instead of calling a thunk.  See
+        /// `format_trivial_fn_body_for_cc`.
+        #[input]
+        fn inline_trivial_functions(&self) -> bool;
+
+        /// Whether the `crate_name_to_include_paths` headers should only be
+        /// included if a complete type from the other crate is needed.  Types
+        /// from other crates that are only used through pointers or references
+        /// are forward-declared instead (see `CcPrerequisites::extern_defs`).
+        #[input]
+        fn prune_crate_header_includes(&self) -> bool;
+
+        /// Whether the C++ bindings of Rust functions returning structs by value
+        /// should have the thunk construct the return value directly in the
+        /// caller's return location, instead of moving it out of a
+        /// `crubit::ReturnValueSlot`.  See `format_in_place_ctor`.
+        #[input]
+        fn return_values_in_place(&self) -> bool;
+
+        /// If set, bindings are only generated for the items with these paths
+        /// (e.g. `some_module::SomeStruct`, as printed by `TyCtxt::def_path_str`)
+        /// and for the items of the crate that their C++ bindings depend on.
+        /// See `items_to_emit`.
+        #[input]
+        fn emit_items(&self) -> Option<Rc<HashSet<Rc<str>>>>;
+
         fn support_header(&self, suffix: &'tcx str) -> CcInclude;
 
         fn repr_attrs(&self, did: DefId) -> Rc<[rustc_attr::ReprAttr]>;
@@ -150,10 +187,41 @@ fn top_level_ns_for_crate(db: &dyn BindingsGenerator<'_>, krate: CrateNum) -> Sy
 pub struct Output {
     pub h_body: TokenStream,
     pub rs_body: TokenStream,
+    /// If `BindingsGenerator::h_out_modules_include_prefix` is set, the names
+    /// (without the `.h` extension) and the bodies of the headers with the C++
+    /// bindings of the top-level modules of the crate, which `h_body` includes.
+    pub h_modules: Vec<(String, TokenStream)>,
+    /// The body of a C++ header with only the forward declarations of the
+    /// structs, enums and unions from `h_body` (see `format_crate_fwd_decls`).
+    pub h_fwd_body: TokenStream,
+}
+
+/// Returns the include guard of the header with the bindings of the module
+/// `module_header_name` (see `Output::h_modules`), given the `guard` of the
+/// main header.
+///
+/// The module name keeps its case, so that e.g. `Foo` and `foo` get different
+/// guards, and follows a `_MOD_` separator, so that no module guard is the same
+/// as the `_FWD` guard of the forward declarations header. `_` is escaped as
+/// `0_`, which keeps the escaping injective and the guard free of `__` (which
+/// is reserved in C++).
+fn module_include_guard(guard: &str, module_header_name: &str) -> String {
+    let mut result = format!("{guard}_MOD_");
+    for c in module_header_name.chars() {
+        match c {
+            '_' => result.push_str("0_"),
+            _ => result.push(c),
+        }
+    }
+    result
 }
 
-fn add_include_guard(db: &dyn BindingsGenerator<'_>, h_body: TokenStream) -> Result<TokenStream> {
-    match db.h_out_include_guard() {
+fn add_include_guard(
+    db: &dyn BindingsGenerator<'_>,
+    include_guard: IncludeGuard,
+    h_body: TokenStream,
+) -> Result<TokenStream> {
+    match include_guard {
         IncludeGuard::PragmaOnce => Ok(quote! {
             __HASH_TOKEN__ pragma once __NEWLINE__
             __NEWLINE__
@@ -200,17 +268,39 @@ pub fn generate_bindings(db: &Database) -> Result<Output> {
         quote! { __COMMENT__ #txt __NEWLINE__ }
     };
 
-    let Output { h_body, rs_body } = format_crate(db).unwrap_or_else(|err| {
-        let txt = format!("Failed to generate bindings for the crate: {err}");
-        let src = quote! { __COMMENT__ #txt };
-        Output { h_body: src.clone(), rs_body: src }
-    });
-    let h_body = add_include_guard(db, h_body)?;
+    let Output { h_body, rs_body, h_modules, h_fwd_body } =
+        format_crate(db).unwrap_or_else(|err| {
+            let txt = format!("Failed to generate bindings for the crate: {err}");
+            let src = quote! { __COMMENT__ #txt };
+            Output { h_body: src.clone(), rs_body: src.clone(), h_modules: vec![], h_fwd_body: src }
+        });
+    let h_body = add_include_guard(db, db.h_out_include_guard(), h_body)?;
     let h_body = quote! {
         #top_comment
 
         #h_body
     };
+    let h_modules = h_modules
+        .into_iter()
+        .map(|(name, h_module)| {
+            let include_guard = match db.h_out_include_guard() {
+                IncludeGuard::PragmaOnce => IncludeGuard::PragmaOnce,
+                IncludeGuard::Guard(guard) => {
+                    IncludeGuard::Guard(module_include_guard(&guard, &name))
+                }
+            };
+            let h_module = add_include_guard(db, include_guard, h_module)?;
+            Ok((name, quote! { #top_comment #h_module }))
+        })
+        .collect::<Result<Vec<_>>>()?;
+    let h_fwd_body = {
+        let include_guard = match db.h_out_include_guard() {
+            IncludeGuard::PragmaOnce => IncludeGuard::PragmaOnce,
+            IncludeGuard::Guard(guard) => IncludeGuard::Guard(format!("{guard}_FWD")),
+        };
+        let h_fwd_body = add_include_guard(db, include_guard, h_fwd_body)?;
+        quote! { #top_comment #h_fwd_body }
+    };
 
     let rs_body = quote! {
         #top_comment
@@ -225,7 +315,7 @@ pub fn generate_bindings(db: &Database) -> Result<Output> {
         #rs_body
     };
 
-    Ok(Output { h_body, rs_body })
+    Ok(Output { h_body, rs_body, h_modules, h_fwd_body })
 }
 
 fn crate_features(
@@ -392,6 +482,19 @@ struct CcPrerequisites {
     /// contain `LocalDefId` corresponding to `S`).
     fwd_decls: HashSet<LocalDefId>,
 
+    /// Set of definitions from other crates that a `CcSnippet` depends on.
+    /// They are provided by the `--crate-header`s of the other crates, which
+    /// are only added to `includes` by `format_cc_items` - this way a header
+    /// isn't included if all its types are only used through pointers or
+    /// references.  Only used if
+    /// `BindingsGenerator::prune_crate_header_includes` is set (otherwise
+    /// the `--crate-header`s are directly added to `includes`).
+    extern_defs: HashSet<DefId>,
+
+    /// Set of forward declarations of items from other crates that a
+    /// `CcSnippet` depends on.  See also `fwd_decls` and `extern_defs`.
+    extern_fwd_decls: HashSet<DefId>,
+
     /// Set of Crubit feature flags required for the CcSnippet to be valid.
     required_features: flagset::FlagSet<FineGrainedFeature>,
 }
@@ -399,10 +502,13 @@ struct CcPrerequisites {
 impl CcPrerequisites {
     #[cfg(test)]
     fn is_empty(&self) -> bool {
-        let Self { includes, defs, fwd_decls, required_features } = self;
+        let Self { includes, defs, fwd_decls, extern_defs, extern_fwd_decls, required_features } =
+            self;
         includes.is_empty()
             && defs.is_empty()
             && fwd_decls.is_empty()
+            && extern_defs.is_empty()
+            && extern_fwd_decls.is_empty()
             && required_features.is_empty()
     }
 
@@ -413,13 +519,21 @@ impl CcPrerequisites {
     /// - Computing prerequisites of function declarations (parameter types and
     ///   return type can just be forward-declared).
     fn move_defs_to_fwd_decls(&mut self) {
-        self.fwd_decls.extend(std::mem::take(&mut self.defs))
+        self.fwd_decls.extend(std::mem::take(&mut self.defs));
+        self.extern_fwd_decls.extend(std::mem::take(&mut self.extern_defs));
     }
 }
 
 impl AddAssign for CcPrerequisites {
     fn add_assign(&mut self, rhs: Self) {
-        let Self { mut includes, defs, fwd_decls, required_features } = rhs;
+        let Self {
+            mut includes,
+            defs,
+            fwd_decls,
+            extern_defs,
+            extern_fwd_decls,
+            required_features,
+        } = rhs;
 
         // `BTreeSet::append` is used because it _seems_ to be more efficient than
         // calling `extend`.  This is because `extend` takes an iterator
@@ -432,6 +546,8 @@ impl AddAssign for CcPrerequisites {
 
         self.defs.extend(defs);
         self.fwd_decls.extend(fwd_decls);
+        self.extern_defs.extend(extern_defs);
+        self.extern_fwd_decls.extend(extern_fwd_decls);
         self.required_features |= required_features;
     }
 }
@@ -657,30 +773,33 @@ use sugared_ty::SugaredTy;
 
 /// Whether functions using `extern "C"` ABI can safely handle values of type
 /// `ty` (e.g. when passing by value arguments or return values of such type).
-fn is_c_abi_compatible_by_value(ty: Ty) -> bool {
+fn is_c_abi_compatible_by_value<'tcx>(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> bool {
     match ty.kind() {
+        // C++ passes these as a `rs_std::DynFnMut` or `rs_std::DynFn`, rather than as a
+        // fat pointer (see `DynCallback`).
+        ty::TyKind::Ref { .. } if DynCallback::new(db, ty).is_some() => false,
+
         // `improper_ctypes_definitions` warning doesn't complain about the following types:
-        ty::TyKind::Bool |
-        ty::TyKind::Float{..} |
-        ty::TyKind::Int{..} |
-        ty::TyKind::Uint{..} |
-        ty::TyKind::Never |
-        ty::TyKind::RawPtr{..} |
-        ty::TyKind::Ref{..} |
-        ty::TyKind::FnPtr{..} => true,
+        ty::TyKind::Bool
+        | ty::TyKind::Float { .. }
+        | ty::TyKind::Int { .. }
+        | ty::TyKind::Uint { .. }
+        | ty::TyKind::Never
+        | ty::TyKind::RawPtr { .. }
+        | ty::TyKind::Ref { .. }
+        | ty::TyKind::FnPtr { .. } => true,
         ty::TyKind::Tuple(types) if types.len() == 0 => true,
 
         // Crubit assumes that `char` is compatible with a certain `extern "C"` ABI.
         // See `rust_builtin_type_abi_assumptions.md` for more details.
         ty::TyKind::Char => true,
 
-        // TODO(b/271016831): When launching `&[T]` (not just `*const T`), consider returning
-        // `true` for `TyKind::Ref` and document the rationale for such decision - maybe
-        // something like this will be sufficient:
-        // - In general `TyKind::Ref` should have the same ABI as `TyKind::RawPtr`
-        // - References to slices (`&[T]`) or strings (`&str`) rely on assumptions
-        //   spelled out in `rust_builtin_type_abi_assumptions.md`.
-        ty::TyKind::Slice{..} => false,
+        // `TyKind::Ref` is handled above, because:
+        // - In general `TyKind::Ref` has the same ABI as `TyKind::RawPtr`.
+        // - References to slices (`&[T]`) and strings (`&str`) rely on the assumptions
+        //   spelled out in `rust_builtin_type_abi_assumptions.md` (and verified by
+        //   `check_slice_layout`).
+        ty::TyKind::Slice { .. } => false,
 
         // Crubit's C++ bindings for tuples, structs, and other ADTs may not preserve
         // their ABI (even if they *do* preserve their memory layout).  For example:
@@ -691,19 +810,23 @@ fn is_c_abi_compatible_by_value(ty: Ty) -> bool {
         // - To replicate field offsets, Crubit may insert explicit padding fields. These
         //   extra fields may also impact the ABI of the generated bindings.
         //
+        // `#[repr(C)]` structs get an exception when their C++ bindings are known to preserve
+        // the ABI - see `is_c_abi_compatible_adt`.
+        //
         // TODO(lukasza): In the future, some additional performance gains may be realized by
-        // returning `true` in a few limited cases (this may require additional complexity to
-        // ensure that `format_adt` never injects explicit padding into such structs):
-        // - `#[repr(C)]` structs and unions,
+        // returning `true` in a few more limited cases:
+        // - `#[repr(C)]` unions,
         // - `#[repr(transparent)]` struct that wraps an ABI-safe type,
         // - Discriminant-only enums (b/259984090).
-        ty::TyKind::Tuple{..} |  // An empty tuple (`()` - the unit type) is handled above.
-        ty::TyKind::Adt{..} => false,
+        // `Option<&T>` and `Option<NonNull<T>>` have the ABI of a raw pointer (see
+        // `NullablePointer`).
+        ty::TyKind::Adt(..) if NullablePointer::new(db, ty).is_some() => true,
+        ty::TyKind::Adt(adt, substs) => is_c_abi_compatible_adt(db, ty, adt, substs),
+        ty::TyKind::Tuple { .. } => false, // An empty tuple (`()` - the unit type) is handled above.
 
         // These kinds of reference-related types are not implemented yet - `is_c_abi_compatible_by_value`
         // should never need to handle them, because `format_ty_for_cc` fails for such types.
-        ty::TyKind::Str |
-        ty::TyKind::Array{..} => unimplemented!(),
+        ty::TyKind::Str | ty::TyKind::Array { .. } => unimplemented!(),
 
         // `format_ty_for_cc` is expected to fail for other kinds of types
         // and therefore `is_c_abi_compatible_by_value` should never be called for
@@ -712,6 +835,86 @@ fn is_c_abi_compatible_by_value(ty: Ty) -> bool {
     }
 }
 
+/// Whether values of the `#[repr(C)]` struct `ty` can be passed by value to and
+/// from `extern "C"` functions, without going through a pointer (to a
+/// `crubit::ReturnValueSlot` on the C++ side, and to a `MaybeUninit` on the Rust
+/// side).
+///
+/// This requires that the struct's C++ bindings have the same ABI as the Rust
+/// struct, which holds when:
+/// - `format_fields` declares all the fields with their actual C++ types, so that
+///   the struct doesn't get opaque blobs of bytes or explicit padding in C++ (both
+///   may change the ABI classification - see b/270454629),
+/// - all the fields are themselves ABI-compatible, and
+/// - the struct is `Copy`, so that it is trivially copyable on the C++ side and
+///   passing it by value doesn't leave a moved-from C++ object behind.
+///
+/// `format_adt` verifies the C++ side of these assumptions at compile time.
+fn is_c_abi_compatible_adt<'tcx>(
+    db: &dyn BindingsGenerator<'tcx>,
+    ty: Ty<'tcx>,
+    adt: &AdtDef<'tcx>,
+    substs: &[GenericArg<'tcx>],
+) -> bool {
+    let tcx = db.tcx();
+    let def_id = adt.did();
+
+    // Structs from other crates are excluded, because their C++ bindings may have been
+    // formatted with a different set of Crubit features.
+    if !adt.is_struct() || !substs.is_empty() || !def_id.is_local() {
+        return false;
+    }
+    let repr_attrs = db.repr_attrs(def_id);
+    if !repr_attrs.contains(&rustc_attr::ReprC)
+        || repr_attrs.iter().any(|repr| {
+            matches!(repr, rustc_attr::ReprAlign { .. } | rustc_attr::ReprPacked { .. })
+        })
+    {
+        return false;
+    }
+    // Types with a custom `cpp_type` (including bridged types) don't get their C++
+    // definition from `format_adt`.
+    if !matches!(crubit_attr::get_attrs(tcx, def_id), Ok(attrs) if attrs.cpp_type.is_none()) {
+        return false;
+    }
+    if !ty.is_copy_modulo_regions(tcx, tcx.param_env(def_id))
+        || db.format_ty_for_cc(SugaredTy::new(ty, None), TypeLocation::Other).is_err()
+    {
+        return false;
+    }
+
+    adt.all_fields().all(|field| {
+        let field_ty = field.ty(tcx, ty::List::empty());
+
+        // ZST fields are skipped by `format_fields` (b/258259459).
+        let is_zst = get_layout(tcx, field_ty).map_or(true, |layout| layout.size().bytes() == 0);
+
+        // Formatting function pointers calls `is_c_abi_compatible_by_value` for their
+        // parameters, so skipping them avoids cycles when a struct has a field like
+        // `extern "C" fn(Self)`.
+        let has_fn_ptr = field_ty.walk().any(|generic_arg| {
+            matches!(generic_arg.unpack(), ty::GenericArgKind::Type(ty) if ty.is_fn_ptr())
+        });
+
+        // Mirrors how `format_fields` formats the field type (fields with an unsupported type
+        // are replaced with an opaque blob of bytes).  This needs to be checked before the
+        // recursive call, because `is_c_abi_compatible_by_value` only handles types that
+        // `format_ty_for_cc` supports.
+        let is_supported_field_ty = || {
+            db.format_ty_for_cc(SugaredTy::new(field_ty, None), TypeLocation::Other)
+                .and_then(|snippet| {
+                    snippet.resolve_feature_requirements(crate_features(db, LOCAL_CRATE))
+                })
+                .is_ok()
+        };
+
+        !is_zst
+            && !has_fn_ptr
+            && is_supported_field_ty()
+            && is_c_abi_compatible_by_value(db, field_ty)
+    })
+}
+
 /// Location where a type is used.
 #[derive(PartialEq, Eq, Hash, Copy, Clone, Debug)]
 enum TypeLocation {
@@ -738,84 +941,102 @@ enum TypeLocation {
     Other,
 }
 
-fn create_canonical_name_from_foreign_path(
-    db: &dyn BindingsGenerator<'_>,
-    path_segments: &[rustc_hir::PathSegment<'_>],
-    res: &Res,
-) -> Option<(DefId, FullyQualifiedName)> {
-    let tcx = db.tcx();
-    let Res::Def(_, def_id) = res else {
+/// Returns the `DefId` of the item from another crate that `path` refers to,
+/// and the segments of `path` (without a leading `::`), if `path` spells out
+/// the crate name of the item (rather than using a local alias).
+///
+/// This is cheap, so that it can be checked for every path in the crate before
+/// computing the canonical name only once per item.
+fn foreign_path_target<'hir>(
+    tcx: TyCtxt<'_>,
+    path: &rustc_hir::Path<'hir>,
+) -> Option<(DefId, &'hir [rustc_hir::PathSegment<'hir>])> {
+    let Res::Def(_, def_id) = path.res else {
         return None;
     };
     if def_id.is_local() {
         return None;
     }
-    let mut segments = path_segments.to_vec();
-    if segments.is_empty() {
-        return None;
-    }
-
     // The starting `::` will become `{{root}}` and should be removed.
-    if segments[0].ident.name.as_str() == "{{root}}" {
-        segments.remove(0);
-    }
-    let segment_len = segments.len();
-    if segment_len < 2 {
+    let segments = match path.segments {
+        [first, rest @ ..] if first.ident.name.as_str() == "{{root}}" => rest,
+        segments => segments,
+    };
+    if segments.len() < 2 {
         return None;
     }
 
-    let krate = tcx.crate_name(def_id.krate);
     // If the crate name is different from the first segment, the path is using an
     // local alias.
-    if krate.as_str() != segments[0].ident.name.as_str() {
+    if tcx.crate_name(def_id.krate).as_str() != segments[0].ident.name.as_str() {
         return None;
     }
-    let item_name = tcx.opt_item_name(*def_id)?;
+    tcx.opt_item_name(def_id)?;
+    Some((def_id, segments))
+}
+
+/// Computes the `FullyQualifiedName` of `def_id` spelled as `segments`, which
+/// must have been returned by `foreign_path_target`.
+fn create_canonical_name_from_foreign_path(
+    db: &dyn BindingsGenerator<'_>,
+    def_id: DefId,
+    segments: &[rustc_hir::PathSegment<'_>],
+) -> Option<FullyQualifiedName> {
+    let tcx = db.tcx();
+    let krate = tcx.crate_name(def_id.krate);
+    let item_name = tcx.opt_item_name(def_id)?;
     let rs_name = Some(item_name);
     let cpp_name = rs_name;
     let rs_mod_path = NamespaceQualifier::new(
-        segments[1..segment_len - 1].iter().map(|s| Rc::<str>::from(s.ident.name.as_str())),
+        segments[1..segments.len() - 1].iter().map(|s| Rc::<str>::from(s.ident.name.as_str())),
     );
     let cpp_ns_path = rs_mod_path.clone();
-    let attributes = crubit_attr::get_attrs(tcx, *def_id).unwrap();
+    let attributes = crubit_attr::get_attrs(tcx, def_id).unwrap();
     let cpp_type = attributes.cpp_type;
-    Some((
-        *def_id,
-        FullyQualifiedName {
-            krate,
-            rs_name,
-            rs_mod_path,
-            cpp_top_level_ns: top_level_ns_for_crate(db, def_id.krate),
-            cpp_ns_path,
-            cpp_name,
-            cpp_type,
-        },
-    ))
+    Some(FullyQualifiedName {
+        krate,
+        rs_name,
+        rs_mod_path,
+        cpp_top_level_ns: top_level_ns_for_crate(db, def_id.krate),
+        cpp_ns_path,
+        cpp_name,
+        cpp_type,
+    })
 }
 
+/// Computes the canonical names of the items from other crates that are
+/// referred to by their full path in this crate.
+///
+/// Paths to the same item are usually repeated many times (e.g. at each use
+/// of a type), so the visitor only records the last path to each item, and the
+/// name (which needs the attributes of the item) is computed once per item.
 fn symbols_from_extern_crate(db: &dyn BindingsGenerator<'_>) -> Vec<(DefId, FullyQualifiedName)> {
     use rustc_hir::intravisit::Visitor;
     let tcx = db.tcx();
-    struct ForeignSymbols<'a, 'tcx> {
-        pub symbols: Vec<(DefId, FullyQualifiedName)>,
-        pub db: &'a dyn BindingsGenerator<'tcx>,
+    struct ForeignSymbols<'tcx> {
+        pub tcx: TyCtxt<'tcx>,
+        pub paths: HashMap<DefId, &'tcx [rustc_hir::PathSegment<'tcx>]>,
     }
 
-    impl<'tcx> Visitor<'tcx> for ForeignSymbols<'_, '_> {
+    impl<'tcx> Visitor<'tcx> for ForeignSymbols<'tcx> {
         fn visit_path(&mut self, path: &rustc_hir::Path<'tcx>, _id: rustc_hir::HirId) {
-            let db = self.db;
-            if let Some((def_id, fully_qualified_name)) =
-                create_canonical_name_from_foreign_path(db, path.segments, &path.res)
-            {
-                self.symbols.push((def_id, fully_qualified_name));
+            if let Some((def_id, segments)) = foreign_path_target(self.tcx, path) {
+                self.paths.insert(def_id, segments);
             }
         }
     }
 
-    let mut visitor = ForeignSymbols { symbols: Vec::new(), db };
+    let mut visitor = ForeignSymbols { tcx, paths: HashMap::new() };
     tcx.hir().visit_all_item_likes_in_crate(&mut visitor);
 
-    visitor.symbols
+    visitor
+        .paths
+        .into_iter()
+        .filter_map(|(def_id, segments)| {
+            create_canonical_name_from_foreign_path(db, def_id, segments)
+                .map(|fully_qualified_name| (def_id, fully_qualified_name))
+        })
+        .collect()
 }
 
 /// Computes a mapping from a `DefId` to a `FullyQualifiedName` for all
@@ -1038,6 +1259,344 @@ fn check_slice_layout<'tcx>(tcx: TyCtxt<'tcx>, ty: Ty<'tcx>) {
     ));
 }
 
+/// An owned, heap-allocated Rust buffer that is returned to C++ without copying
+/// its contents - see `rs_std::OwnedSlice` and `rs_std::OwnedStr` in
+/// `crubit/support/rs_std/owned_slice.h`.
+#[derive(Clone, Copy, Debug)]
+enum OwnedBuffer<'tcx> {
+    /// `String` - translated into `rs_std::OwnedStr`.
+    String,
+
+    /// `Vec<T>` (using the global allocator) - translated into
+    /// `rs_std::OwnedSlice<T>`.
+    Vec(Ty<'tcx>),
+}
+
+impl<'tcx> OwnedBuffer<'tcx> {
+    /// Returns `Some(...)` if `ty` is a `String` or a `Vec<T>`.
+    fn new(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Option<Self> {
+        let ty::TyKind::Adt(adt, substs) = ty.kind() else {
+            return None;
+        };
+        if substs.is_empty()
+            && matches_qualified_name(db, adt.did(), ":: alloc :: string :: String")
+        {
+            return Some(Self::String);
+        }
+        if substs.len() != 2 || !matches_qualified_name(db, adt.did(), ":: alloc :: vec :: Vec") {
+            return None;
+        }
+        let is_global_allocator = match substs[1].expect_ty().kind() {
+            ty::TyKind::Adt(alloc, _) => {
+                matches_qualified_name(db, alloc.did(), ":: alloc :: alloc :: Global")
+            }
+            _ => false,
+        };
+        is_global_allocator.then(|| Self::Vec(substs[0].expect_ty()))
+    }
+
+    /// The type of the elements of the buffer.
+    fn elem_ty(self, tcx: TyCtxt<'tcx>) -> Ty<'tcx> {
+        match self {
+            Self::String => tcx.types.u8,
+            Self::Vec(elem_ty) => elem_ty,
+        }
+    }
+
+    /// Verifies that the elements of the buffer can be owned by C++: C++ never
+    /// runs the destructors of the elements (it only hands the allocation back to
+    /// Rust), and it can't track the lifetimes of borrowed elements.
+    fn check_elem_ty(self, tcx: TyCtxt<'tcx>) -> Result<()> {
+        let elem_ty = self.elem_ty(tcx);
+        ensure!(
+            !elem_ty.needs_drop(tcx, ty::ParamEnv::empty()),
+            "Elements of an owned buffer can't have drop glue, but `{elem_ty}` does"
+        );
+        ensure!(
+            !elem_ty
+                .walk()
+                .any(|generic_arg| matches!(generic_arg.unpack(), ty::GenericArgKind::Lifetime(_))),
+            "Elements of an owned buffer can't have lifetimes, but `{elem_ty}` does"
+        );
+        Ok(())
+    }
+}
+
+/// A boxed Rust iterator (`Box<dyn Iterator<Item = T>>`, using the global
+/// allocator) that is returned to C++ as an input range - see
+/// `rs_std::BoxedIterator` in `crubit/support/rs_std/boxed_iterator.h`.  C++
+/// pulls the items in batches, to amortize the cost of calling into Rust.
+#[derive(Clone, Copy, Debug)]
+struct BoxedIterator<'tcx> {
+    /// The `Item` type of the iterator.
+    item_ty: Ty<'tcx>,
+    /// The lifetime bound of the `dyn Iterator` (`'static` unless spelled out,
+    /// e.g. as `dyn Iterator<Item = T> + '_`).
+    region: ty::Region<'tcx>,
+}
+
+impl<'tcx> BoxedIterator<'tcx> {
+    /// Returns `Some(...)` if `ty` is a `Box<dyn Iterator<Item = T>>`.  Auto
+    /// traits (e.g. `dyn Iterator<Item = T> + Send`) are allowed.
+    fn new(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Option<Self> {
+        let ty::TyKind::Adt(adt, substs) = ty.kind() else {
+            return None;
+        };
+        if substs.len() != 2 || !matches_qualified_name(db, adt.did(), ":: alloc :: boxed :: Box") {
+            return None;
+        }
+        let is_global_allocator = match substs[1].expect_ty().kind() {
+            ty::TyKind::Adt(alloc, _) => {
+                matches_qualified_name(db, alloc.did(), ":: alloc :: alloc :: Global")
+            }
+            _ => false,
+        };
+        let ty::TyKind::Dynamic(preds, region, ty::DynKind::Dyn) = substs[0].expect_ty().kind()
+        else {
+            return None;
+        };
+        let iterator = db.tcx().get_diagnostic_item(sym::Iterator)?;
+        if !is_global_allocator || preds.principal_def_id() != Some(iterator) {
+            return None;
+        }
+        let item_ty = preds.projection_bounds().exactly_one().ok()?.skip_binder().term.as_type()?;
+        Some(Self { item_ty, region: *region })
+    }
+
+    /// Verifies that the iterator is `'static`, so that C++ can hold on to it
+    /// (and so that the thunk's nested `extern "C" fn`s can name its type), and
+    /// that the items can be moved into C++: like the elements of an
+    /// `OwnedBuffer`, they can't have drop glue or lifetimes.
+    fn check(self, tcx: TyCtxt<'tcx>) -> Result<()> {
+        ensure!(
+            self.region.is_static(),
+            "Boxed iterators that borrow their arguments (or capture other lifetimes) \
+             are not supported"
+        );
+        let item_ty = self.item_ty;
+        ensure!(
+            !item_ty.needs_drop(tcx, ty::ParamEnv::empty()),
+            "Items of a boxed iterator can't have drop glue, but `{item_ty}` does"
+        );
+        ensure!(
+            !item_ty
+                .walk()
+                .any(|generic_arg| matches!(generic_arg.unpack(), ty::GenericArgKind::Lifetime(_))),
+            "Items of a boxed iterator can't have lifetimes, but `{item_ty}` does"
+        );
+        Ok(())
+    }
+}
+
+/// An `Option<&T>`, `Option<&mut T>` or `Option<NonNull<T>>`, which Rust
+/// guarantees to have the same ABI as a raw pointer, with `None` represented by
+/// null.  These are translated into nullable C++ pointers, and passed without
+/// any conversion (in particular, without a thunk for the `Option`).
+#[derive(Clone, Copy, Debug)]
+struct NullablePointer<'tcx> {
+    /// The `&T`, `&mut T` or `NonNull<T>` type inside the `Option`.
+    ptr_ty: Ty<'tcx>,
+}
+
+impl<'tcx> NullablePointer<'tcx> {
+    /// Returns `Some(...)` if `ty` is an `Option` of a reference or of a
+    /// `NonNull` pointer to a sized type.  (Pointers to slices, strings and
+    /// trait objects are fat pointers, which C++ can't represent as a single
+    /// nullable pointer.)
+    fn new(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Option<Self> {
+        let ty::TyKind::Adt(adt, substs) = ty.kind() else {
+            return None;
+        };
+        let option = db.tcx().get_diagnostic_item(sym::Option)?;
+        if substs.len() != 1 || adt.did() != option {
+            return None;
+        }
+        let ptr_ty = substs[0].expect_ty();
+        let pointee_ty = match ptr_ty.kind() {
+            ty::TyKind::Ref(_, referent_ty, _) => *referent_ty,
+            ty::TyKind::Adt(ptr_adt, ptr_substs)
+                if ptr_substs.len() == 1
+                    && matches_qualified_name(
+                        db,
+                        ptr_adt.did(),
+                        ":: core :: ptr :: non_null :: NonNull",
+                    ) =>
+            {
+                ptr_substs[0].expect_ty()
+            }
+            _ => return None,
+        };
+        if matches!(
+            pointee_ty.kind(),
+            ty::TyKind::Slice(_) | ty::TyKind::Str | ty::TyKind::Dynamic(..)
+        ) {
+            return None;
+        }
+        Some(Self { ptr_ty })
+    }
+
+    /// The type that the pointer points to, and whether it can be mutated
+    /// through the pointer.  (`NonNull<T>` is covariant like `*const T`, but
+    /// allows mutation like `*mut T`.)
+    fn pointee(self) -> (Ty<'tcx>, Mutability) {
+        match self.ptr_ty.kind() {
+            ty::TyKind::Ref(_, referent_ty, mutability) => (*referent_ty, *mutability),
+            ty::TyKind::Adt(_, substs) => (substs[0].expect_ty(), Mutability::Mut),
+            _ => unreachable!("`NullablePointer::new` only accepts references and `NonNull`"),
+        }
+    }
+}
+
+/// The future returned by an `async fn` (or by any function returning an
+/// `impl Future<Output = T>`), which is boxed and returned to C++ as an
+/// `rs_std::BoxedFuture<T>` - see `crubit/support/rs_std/boxed_future.h`.  The
+/// C++ caller polls it from its own executor, passing a wake hook that Rust
+/// calls when the future can make progress.
+#[derive(Clone, Copy, Debug)]
+struct BoxedFuture<'tcx> {
+    /// The `impl Future` type.
+    future_ty: Ty<'tcx>,
+    /// The `Output` type of the future.
+    output_ty: Ty<'tcx>,
+}
+
+impl<'tcx> BoxedFuture<'tcx> {
+    /// Returns `Some(...)` if `ty` is an opaque `impl Future<Output = T>`.
+    fn new(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Option<Self> {
+        let ty::TyKind::Alias(ty::AliasTyKind::Opaque, _) = ty.kind() else {
+            return None;
+        };
+        let tcx = db.tcx();
+        let future_output = tcx.lang_items().future_output()?;
+        let output_ty = tcx
+            .try_normalize_erasing_regions(
+                ty::ParamEnv::empty(),
+                Ty::new_projection(tcx, future_output, [ty]),
+            )
+            .ok()?;
+        if matches!(output_ty.kind(), ty::TyKind::Alias(..)) {
+            return None;
+        }
+        Some(Self { future_ty: ty, output_ty })
+    }
+
+    /// Verifies that the future is `'static`, so that C++ can hold on to it,
+    /// and that its output can be moved into C++: like the items of a
+    /// `BoxedIterator`, it can't have drop glue or lifetimes.
+    fn check(self, tcx: TyCtxt<'tcx>) -> Result<()> {
+        let has_lifetimes = |ty: Ty<'tcx>| {
+            ty.walk()
+                .any(|generic_arg| matches!(generic_arg.unpack(), ty::GenericArgKind::Lifetime(_)))
+        };
+        ensure!(
+            !has_lifetimes(self.future_ty),
+            "Async functions that borrow their arguments (or capture other lifetimes) \
+             are not supported"
+        );
+        let output_ty = self.output_ty;
+        ensure!(
+            !output_ty.needs_drop(tcx, ty::ParamEnv::empty()),
+            "The output of a future can't have drop glue, but `{output_ty}` does"
+        );
+        ensure!(
+            !has_lifetimes(output_ty),
+            "The output of a future can't have lifetimes, but `{output_ty}` does"
+        );
+        Ok(())
+    }
+}
+
+/// A `&mut dyn FnMut(A...) -> R` or `&dyn Fn(A...) -> R` parameter, which C++
+/// passes as an `rs_std::DynFnMut<R(A...)>` or `rs_std::DynFn<R(A...)>` - see
+/// `crubit/support/rs_std/dyn_callback.h`.  Neither the C++ callable nor the
+/// Rust closure that stands in for it is boxed: the thunk wraps the callable
+/// in a closure on its stack, so that each call from Rust is a single indirect
+/// call into C++.
+#[derive(Clone, Copy, Debug)]
+struct DynCallback<'tcx> {
+    /// `Mutability::Mut` for `FnMut`, and `Mutability::Not` for `Fn`.
+    mutability: Mutability,
+    /// The parameter types of the callback.
+    inputs: &'tcx ty::List<Ty<'tcx>>,
+    /// The return type of the callback.
+    output: Ty<'tcx>,
+    /// Whether the signature of the callback has higher-ranked lifetimes (e.g.
+    /// `&mut dyn FnMut(&i32)`).
+    has_bound_vars: bool,
+}
+
+impl<'tcx> DynCallback<'tcx> {
+    /// Returns `Some(...)` if `ty` is a `&mut dyn FnMut(...)` or a
+    /// `&dyn Fn(...)`, without auto traits (e.g. `&dyn Fn() + Send`).
+    fn new(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Option<Self> {
+        let ty::TyKind::Ref(_, referent_ty, mutability) = ty.kind() else {
+            return None;
+        };
+        let ty::TyKind::Dynamic(preds, _, ty::DynKind::Dyn) = referent_ty.kind() else {
+            return None;
+        };
+        let lang_items = db.tcx().lang_items();
+        let fn_trait = match mutability {
+            Mutability::Mut => lang_items.fn_mut_trait()?,
+            Mutability::Not => lang_items.fn_trait()?,
+        };
+        if preds.principal_def_id() != Some(fn_trait) || preds.auto_traits().next().is_some() {
+            return None;
+        }
+        let principal = preds.principal()?;
+        let output = preds.projection_bounds().exactly_one().ok()?;
+        let ty::TyKind::Tuple(inputs) = principal.skip_binder().args.first()?.as_type()?.kind()
+        else {
+            return None;
+        };
+        Some(Self {
+            mutability: *mutability,
+            inputs,
+            output: output.skip_binder().term.as_type()?,
+            has_bound_vars: !principal.bound_vars().is_empty() || !output.bound_vars().is_empty(),
+        })
+    }
+
+    /// Verifies that the arguments and the return value of the callback can
+    /// be passed by value between Rust and C++.
+    fn check(self, db: &dyn BindingsGenerator<'tcx>) -> Result<()> {
+        ensure!(!self.has_bound_vars, "Callbacks that take or return references are not supported");
+        ensure!(!self.output.is_never(), "Callbacks that never return are not supported");
+        for ty in self.inputs.iter().chain([self.output]) {
+            ensure!(
+                is_c_abi_compatible_by_value(db, ty),
+                "Callback parameter and return types have to be C ABI compatible, \
+                 but `{ty}` isn't"
+            );
+        }
+        Ok(())
+    }
+}
+
+/// Returns whether `hir_ty` spells a type alias anywhere (e.g. `c_char`, or
+/// `*const c_char`).  Type aliases are the only sugar that `format_ty_for_cc`
+/// looks at (see `format_core_alias_for_cc`).
+fn hir_ty_contains_type_alias<'tcx>(hir_ty: &'tcx rustc_hir::Ty<'tcx>) -> bool {
+    use rustc_hir::intravisit::Visitor;
+    struct TypeAliasFinder {
+        found: bool,
+    }
+
+    impl<'tcx> Visitor<'tcx> for TypeAliasFinder {
+        fn visit_path(&mut self, path: &rustc_hir::Path<'tcx>, _id: rustc_hir::HirId) {
+            if matches!(path.res, Res::Def(DefKind::TyAlias, _)) {
+                self.found = true;
+            } else {
+                rustc_hir::intravisit::walk_path(self, path);
+            }
+        }
+    }
+
+    let mut visitor = TypeAliasFinder { found: false };
+    visitor.visit_ty(hir_ty);
+    visitor.found
+}
+
 /// Formats `ty` into a `CcSnippet` that represents how the type should be
 /// spelled in a C++ declaration of a function parameter or field.
 fn format_ty_for_cc<'tcx>(
@@ -1046,6 +1605,16 @@ fn format_ty_for_cc<'tcx>(
     location: TypeLocation,
 ) -> Result<CcSnippet> {
     let tcx = db.tcx();
+
+    // The `db.format_ty_for_cc` query is keyed on the `HirId` of `ty`, so each
+    // place that spells out the same type is a separate cache entry.  When the
+    // HIR can't affect the result, delegate to the desugared type instead, so
+    // that all of these places share a single cache entry.
+    if let Some(hir_ty) = ty.hir(db) {
+        if !hir_ty_contains_type_alias(hir_ty) {
+            return db.format_ty_for_cc(SugaredTy::new(ty.mid(), None), location);
+        }
+    }
     fn cstdint(tokens: TokenStream) -> CcSnippet {
         CcSnippet::with_include(tokens, CcInclude::cstdint())
     }
@@ -1159,6 +1728,110 @@ fn format_ty_for_cc<'tcx>(
             bail!("C++ doesn't have a standard equivalent of `{ty}` (b/254094650)");
         }
 
+        ty::TyKind::Adt(..) if OwnedBuffer::new(db, ty.mid()).is_some() => {
+            let owned_buffer = OwnedBuffer::new(db, ty.mid()).unwrap();
+            ensure!(
+                location == TypeLocation::FnReturn,
+                "Can't format `{ty}`, because owned buffers are only supported in \
+                 function return types"
+            );
+            owned_buffer.check_elem_ty(tcx)?;
+            let mut prereqs = CcPrerequisites::default();
+            prereqs.includes.insert(db.support_header("rs_std/owned_slice.h"));
+            let tokens = match owned_buffer {
+                OwnedBuffer::String => quote! { rs_std::OwnedStr },
+                OwnedBuffer::Vec(elem_ty) => {
+                    let elem_ty = db
+                        .format_ty_for_cc(SugaredTy::new(elem_ty, None), TypeLocation::Other)
+                        .with_context(|| format!("Failed to format the element type of `{ty}`"))?
+                        .into_tokens(&mut prereqs);
+                    quote! { rs_std::OwnedSlice<#elem_ty> }
+                }
+            };
+            CcSnippet { tokens, prereqs }
+        }
+
+        ty::TyKind::Adt(..) if BoxedIterator::new(db, ty.mid()).is_some() => {
+            let boxed_iterator = BoxedIterator::new(db, ty.mid()).unwrap();
+            ensure!(
+                location == TypeLocation::FnReturn,
+                "Can't format `{ty}`, because boxed iterators are only supported in \
+                 function return types"
+            );
+            boxed_iterator.check(tcx)?;
+            let mut prereqs = CcPrerequisites::default();
+            prereqs.includes.insert(db.support_header("rs_std/boxed_iterator.h"));
+            let item_ty = db
+                .format_ty_for_cc(SugaredTy::new(boxed_iterator.item_ty, None), TypeLocation::Other)
+                .with_context(|| format!("Failed to format the item type of `{ty}`"))?
+                .into_tokens(&mut prereqs);
+            CcSnippet { tokens: quote! { rs_std::BoxedIterator<#item_ty> }, prereqs }
+        }
+
+        ty::TyKind::Adt(..) if NullablePointer::new(db, ty.mid()).is_some() => {
+            let nullable_pointer = NullablePointer::new(db, ty.mid()).unwrap();
+            let (pointee_mid, mutability) = nullable_pointer.pointee();
+            let ty::TyKind::Ref(region, ..) = nullable_pointer.ptr_ty.kind() else {
+                let pointee = SugaredTy::new(pointee_mid, None);
+                return format_pointer_or_reference_ty_for_cc(
+                    db,
+                    pointee,
+                    mutability,
+                    quote! { * },
+                )
+                .with_context(|| format!("Failed to format the pointee of `{ty}`"));
+            };
+
+            // The same restrictions as for non-optional references apply (see the
+            // `ty::TyKind::Ref` case below).
+            match location {
+                TypeLocation::FnReturn | TypeLocation::FnParam => (),
+                TypeLocation::Other => bail!(
+                    "Can't format `{ty}`, because references are only supported in \
+                     function parameter types and return types (b/286256327)",
+                ),
+            };
+            let lifetime = format_region_as_cc_lifetime(region);
+            let pointee = SugaredTy::new(pointee_mid, None);
+            let mut cc_type = format_pointer_or_reference_ty_for_cc(
+                db,
+                pointee,
+                mutability,
+                quote! { * #lifetime },
+            )
+            .with_context(|| format!("Failed to format the referent of `{ty}`"))?;
+            if location != TypeLocation::FnParam {
+                cc_type.prereqs.required_features |= FineGrainedFeature::References;
+            } else if !region.is_param() {
+                cc_type.prereqs.required_features |= FineGrainedFeature::NonFreeReferenceParams;
+            }
+            cc_type
+        }
+
+        ty::TyKind::Alias(ty::AliasTyKind::Opaque, _)
+            if BoxedFuture::new(db, ty.mid()).is_some() =>
+        {
+            let boxed_future = BoxedFuture::new(db, ty.mid()).unwrap();
+            ensure!(
+                location == TypeLocation::FnReturn,
+                "Can't format `{ty}`, because futures are only supported in function return types"
+            );
+            boxed_future.check(tcx)?;
+            let mut prereqs = CcPrerequisites::default();
+            prereqs.includes.insert(db.support_header("rs_std/boxed_future.h"));
+            let output_ty = if boxed_future.output_ty.is_unit() {
+                quote! { void }
+            } else {
+                db.format_ty_for_cc(
+                    SugaredTy::new(boxed_future.output_ty, None),
+                    TypeLocation::Other,
+                )
+                .with_context(|| format!("Failed to format the output type of `{ty}`"))?
+                .into_tokens(&mut prereqs)
+            };
+            CcSnippet { tokens: quote! { rs_std::BoxedFuture<#output_ty> }, prereqs }
+        }
+
         ty::TyKind::Adt(adt, substs) => {
             // If a type needs to be bridged, we ingore the fact that it has generic
             // parameters (lifetime, const or type) but trust the type
@@ -1176,7 +1849,8 @@ fn format_ty_for_cc<'tcx>(
             let def_id = adt.did();
             let mut prereqs = CcPrerequisites::default();
 
-            if let Some(user_header) = crubit_attr::get_attrs(tcx, adt.did())?.cpp_type_include {
+            let attrs = crubit_attr::get_attrs(tcx, adt.did())?;
+            if let Some(user_header) = attrs.cpp_type_include {
                 prereqs.includes.insert(CcInclude::user_header(user_header.as_str().into()));
             } else if def_id.krate == LOCAL_CRATE {
                 prereqs.defs.insert(def_id.expect_local());
@@ -1191,7 +1865,13 @@ fn format_ty_for_cc<'tcx>(
                              but no `--crate-header` was specified for this crate"
                         )
                     })?;
-                prereqs.includes.extend(includes.iter().cloned());
+                // Types with a custom `cpp_type` can't be forward-declared by
+                // `format_extern_fwd_decls`, which only knows their Rust name.
+                if db.prune_crate_header_includes() && attrs.cpp_type.is_none() {
+                    prereqs.extern_defs.insert(def_id);
+                } else {
+                    prereqs.includes.extend(includes.iter().cloned());
+                }
             }
 
             // Verify if definition of `ty` can be succesfully imported and bail otherwise.
@@ -1243,8 +1923,40 @@ fn format_ty_for_cc<'tcx>(
             )?
         }
 
+        ty::TyKind::Ref(..) if DynCallback::new(db, ty.mid()).is_some() => {
+            let callback = DynCallback::new(db, ty.mid()).unwrap();
+            ensure!(
+                location == TypeLocation::FnParam,
+                "Can't format `{ty}`, because callbacks are only supported in function \
+                 parameter types"
+            );
+            callback.check(db)?;
+            let mut prereqs = CcPrerequisites::default();
+            prereqs.includes.insert(db.support_header("rs_std/dyn_callback.h"));
+            let output = db
+                .format_ty_for_cc(SugaredTy::new(callback.output, None), TypeLocation::FnReturn)
+                .with_context(|| format!("Failed to format the return type of `{ty}`"))?
+                .into_tokens(&mut prereqs);
+            let inputs = callback
+                .inputs
+                .iter()
+                .enumerate()
+                .map(|(i, input)| {
+                    Ok(db
+                        .format_ty_for_cc(SugaredTy::new(input, None), TypeLocation::Other)
+                        .with_context(|| format!("Failed to format parameter #{i} of `{ty}`"))?
+                        .into_tokens(&mut prereqs))
+                })
+                .collect::<Result<Vec<_>>>()?;
+            let tokens = match callback.mutability {
+                Mutability::Mut => quote! { rs_std::DynFnMut< #output ( #( #inputs ),* ) > },
+                Mutability::Not => quote! { rs_std::DynFn< #output ( #( #inputs ),* ) > },
+            };
+            CcSnippet { tokens, prereqs }
+        }
+
         ty::TyKind::Ref(region, referent_mid, mutability) => {
-            if let ty::TyKind::Slice(_) = referent_mid.kind() {
+            if let ty::TyKind::Slice(_) | ty::TyKind::Str = referent_mid.kind() {
                 check_slice_layout(db.tcx(), ty.mid());
             }
 
@@ -1264,27 +1976,58 @@ fn format_ty_for_cc<'tcx>(
             };
             let lifetime = format_region_as_cc_lifetime(region);
 
-            // Early return in case we handle a transparent reference type.
-            if let Some(snippet) = format_transparent_pointee_or_reference_for_cc(
-                db,
-                *referent_mid,
-                referent_hir,
-                *mutability,
-                quote! { & #lifetime },
-            ) {
-                return Ok(snippet);
-            }
+            let mut cc_type = match referent_mid.kind() {
+                // `&[T]` and `&str` have the same ABI as `rs_std::SliceRef` (see
+                // `check_slice_layout` above) and are passed without copying the
+                // elements.
+                ty::TyKind::Slice(slice_ty) => {
+                    let slice_hir_ty =
+                        referent_hir.and_then(|referent_hir| match &referent_hir.kind {
+                            rustc_hir::TyKind::Slice(slice_hir_ty) => Some(*slice_hir_ty),
+                            _ => None,
+                        });
+                    format_slice_pointer_for_cc(
+                        db,
+                        SugaredTy::new(*slice_ty, slice_hir_ty),
+                        *mutability,
+                    )?
+                }
+                ty::TyKind::Str => {
+                    // `rs_std::StrRef` only gives `const` access to the string, because C++
+                    // code could otherwise break the UTF-8 guarantee of Rust strings.
+                    ensure!(
+                        *mutability == Mutability::Not,
+                        "Can't format `{ty}`, because `&mut str` is not supported"
+                    );
+                    CcSnippet::with_include(
+                        quote! { rs_std::StrRef },
+                        db.support_header("rs_std/str_ref.h"),
+                    )
+                }
+                _ => {
+                    // Early return in case we handle a transparent reference type.
+                    if let Some(snippet) = format_transparent_pointee_or_reference_for_cc(
+                        db,
+                        *referent_mid,
+                        referent_hir,
+                        *mutability,
+                        quote! { & #lifetime },
+                    ) {
+                        return Ok(snippet);
+                    }
 
-            let referent = SugaredTy::new(*referent_mid, referent_hir);
-            let mut cc_type = format_pointer_or_reference_ty_for_cc(
-                db,
-                referent,
-                *mutability,
-                quote! { & #lifetime },
-            )
-            .with_context(|| {
-                format!("Failed to format the referent of the reference type `{ty}`")
-            })?;
+                    let referent = SugaredTy::new(*referent_mid, referent_hir);
+                    format_pointer_or_reference_ty_for_cc(
+                        db,
+                        referent,
+                        *mutability,
+                        quote! { & #lifetime },
+                    )
+                    .with_context(|| {
+                        format!("Failed to format the referent of the reference type `{ty}`")
+                    })?
+                }
+            };
             // For function parameters which are `'_`, we allow the caller to decide whether
             // to require the reference feature. Some use cases are safe (e.g.
             // if it's the only reference/pointer parameter.)
@@ -1313,7 +2056,7 @@ fn format_ty_for_cc<'tcx>(
             };
 
             check_fn_sig(&sig)?;
-            is_thunk_required(&sig).context("Function pointers can't have a thunk")?;
+            is_thunk_required(db, &sig).context("Function pointers can't have a thunk")?;
 
             // `is_thunk_required` check above implies `extern "C"` (or `"C-unwind"`).
             // This assertion reinforces that the generated C++ code doesn't need
@@ -1553,8 +2296,13 @@ fn format_param_types_for_cc<'tcx>(
                 // (non-static) references. We need to decide which references we
                 // allow -- in this case, we choose to allow references _only_ if
                 // the reference cannot mutably alias, and does not have any lifetime
-                // requirements from the caller.
-                match mid.kind() {
+                // requirements from the caller.  Optional references follow the same
+                // rules.
+                let ref_ty = NullablePointer::new(db, mid).map_or(mid, |p| p.ptr_ty);
+                match ref_ty.kind() {
+                    // The callee only gets a reference to a closure in its thunk (see
+                    // `format_dyn_callback_conversion`), which can't alias anything.
+                    ty::TyKind::Ref(..) if DynCallback::new(db, ref_ty).is_some() => {}
                     ty::TyKind::Ref(input_region, .., Mutability::Not) => {
                         if region_counts[input_region] > 1 {
                             cc_type.prereqs.required_features |= FineGrainedFeature::LifetimeReuse;
@@ -1616,10 +2364,44 @@ fn format_ty_for_rs<'tcx>(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Res
                 bail!("Tuples are not supported yet: {} (b/254099023)", ty);
             }
         }
-        ty::TyKind::Adt(adt, substs) => {
-            ensure!(substs.len() == 0, "Generic types are not supported yet (b/259749095)");
-            FullyQualifiedName::new(db, adt.did()).format_for_rs()
+        ty::TyKind::Adt(..) if BoxedIterator::new(db, ty).is_some() => {
+            let item_ty = format_ty_for_rs(db, BoxedIterator::new(db, ty).unwrap().item_ty)
+                .with_context(|| format!("Failed to format the item type of `{ty}`"))?;
+            quote! { ::std::boxed::Box<dyn ::core::iter::Iterator<Item = #item_ty>> }
+        }
+        ty::TyKind::Alias(ty::AliasTyKind::Opaque, _) if BoxedFuture::new(db, ty).is_some() => {
+            let output_ty = format_ty_for_rs(db, BoxedFuture::new(db, ty).unwrap().output_ty)
+                .with_context(|| format!("Failed to format the output type of `{ty}`"))?;
+            quote! {
+                ::core::pin::Pin<
+                    ::std::boxed::Box<dyn ::core::future::Future<Output = #output_ty>>
+                >
+            }
+        }
+        ty::TyKind::Adt(..) if NullablePointer::new(db, ty).is_some() => {
+            let ptr_ty = NullablePointer::new(db, ty).unwrap().ptr_ty;
+            let ptr_ty = match ptr_ty.kind() {
+                ty::TyKind::Adt(_, substs) => {
+                    let pointee = format_ty_for_rs(db, substs[0].expect_ty())
+                        .with_context(|| format!("Failed to format the pointee of `{ty}`"))?;
+                    quote! { ::core::ptr::NonNull<#pointee> }
+                }
+                _ => format_ty_for_rs(db, ptr_ty)?,
+            };
+            quote! { ::core::option::Option<#ptr_ty> }
         }
+        ty::TyKind::Adt(adt, substs) => match OwnedBuffer::new(db, ty) {
+            Some(OwnedBuffer::String) => quote! { ::std::string::String },
+            Some(OwnedBuffer::Vec(elem_ty)) => {
+                let elem_ty = format_ty_for_rs(db, elem_ty)
+                    .with_context(|| format!("Failed to format the element type of `{ty}`"))?;
+                quote! { ::std::vec::Vec<#elem_ty> }
+            }
+            None => {
+                ensure!(substs.len() == 0, "Generic types are not supported yet (b/259749095)");
+                FullyQualifiedName::new(db, adt.did()).format_for_rs()
+            }
+        },
         ty::TyKind::RawPtr(pointee_ty, mutbl) => {
             let qualifier = match mutbl {
                 Mutability::Mut => quote! { mut },
@@ -1633,6 +2415,21 @@ fn format_ty_for_rs<'tcx>(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Res
             };
             quote! { * #qualifier #ty }
         }
+        ty::TyKind::Ref(..) if DynCallback::new(db, ty).is_some() => {
+            let callback = DynCallback::new(db, ty).unwrap();
+            let output = format_ty_for_rs(db, callback.output)?;
+            let inputs = callback
+                .inputs
+                .iter()
+                .map(|input| format_ty_for_rs(db, input))
+                .collect::<Result<Vec<_>>>()?;
+            match callback.mutability {
+                Mutability::Mut => {
+                    quote! { &mut dyn ::core::ops::FnMut(#( #inputs ),*) -> #output }
+                }
+                Mutability::Not => quote! { &dyn ::core::ops::Fn(#( #inputs ),*) -> #output },
+            }
+        }
         ty::TyKind::Ref(region, referent_ty, mutability) => {
             let mutability = match mutability {
                 Mutability::Mut => quote! { mut },
@@ -1653,6 +2450,7 @@ fn format_ty_for_rs<'tcx>(db: &dyn BindingsGenerator<'tcx>, ty: Ty<'tcx>) -> Res
             })?;
             quote! { [#ty] }
         }
+        ty::TyKind::Str => quote! { str },
         _ => bail!("The following Rust type is not supported yet: {ty}"),
     })
 }
@@ -1763,6 +2561,18 @@ fn get_fn_sig(tcx: TyCtxt, local_def_id: LocalDefId) -> (ty::FnSig, &rustc_hir::
     (sig_mid, sig_hir.decl)
 }
 
+/// Formats the `noexcept` specifier of the C++ functions that call into Rust:
+/// with `panic=abort`, a Rust panic aborts before unwinding anything, so these
+/// functions never throw, and C++ callers need no exception-handling tables for
+/// the calls.  With `panic=unwind`, the functions are left potentially-throwing
+/// (see also `is_thunk_required`).
+fn format_noexcept(tcx: TyCtxt) -> TokenStream {
+    match tcx.sess().panic_strategy() {
+        PanicStrategy::Abort => quote! { noexcept },
+        PanicStrategy::Unwind => quote! {},
+    }
+}
+
 /// Formats a C++ function declaration of a thunk that wraps a Rust function.
 fn format_thunk_decl<'tcx>(
     db: &dyn BindingsGenerator<'tcx>,
@@ -1782,8 +2592,10 @@ fn format_thunk_decl<'tcx>(
             .zip(cpp_types.into_iter())
             .map(|(&ty, cpp_type)| -> Result<TokenStream> {
                 let cpp_type = cpp_type.into_tokens(&mut prereqs);
-                if is_c_abi_compatible_by_value(ty) {
+                if is_c_abi_compatible_by_value(db, ty) {
                     Ok(quote! { #cpp_type })
+                } else if DynCallback::new(db, ty).is_some() {
+                    Ok(quote! { const #cpp_type* })
                 } else if let Some(adt_def) = ty.ty_adt_def() {
                     let core = db.format_adt_core(adt_def.did())?;
                     db.format_move_ctor_and_assignment_operator(core).map_err(|_| {
@@ -1798,22 +2610,58 @@ fn format_thunk_decl<'tcx>(
     };
 
     let thunk_ret_type: TokenStream;
-    if is_c_abi_compatible_by_value(sig_mid.output()) {
+    if is_c_abi_compatible_by_value(db, sig_mid.output()) {
         thunk_ret_type = main_api_ret_type;
     } else {
         thunk_ret_type = quote! { void };
         thunk_params.push(quote! { #main_api_ret_type* __ret_ptr });
     };
+    let noexcept = format_noexcept(db.tcx());
     Ok(CcSnippet {
         prereqs,
         tokens: quote! {
             namespace __crubit_internal {
-                extern "C" #thunk_ret_type #thunk_name ( #( #thunk_params ),* );
+                extern "C" #thunk_ret_type #thunk_name ( #( #thunk_params ),* ) #noexcept;
             }
         },
     })
 }
 
+/// Formats the statements of a Rust thunk that shadow the `param_name`
+/// parameter - a pointer to the C++ `rs_std::DynFnMut` or `rs_std::DynFn` -
+/// with a closure that calls the C++ callable.
+fn format_dyn_callback_conversion<'tcx>(
+    db: &dyn BindingsGenerator<'tcx>,
+    callback: DynCallback<'tcx>,
+    param_name: &Ident,
+) -> Result<TokenStream> {
+    let output = format_ty_for_rs(db, callback.output)?;
+    let inputs = callback
+        .inputs
+        .iter()
+        .map(|input| format_ty_for_rs(db, input))
+        .collect::<Result<Vec<_>>>()?;
+    let arg_names = (0..inputs.len()).map(|i| format_ident!("__arg_{i}")).collect_vec();
+    let mutability = match callback.mutability {
+        Mutability::Mut => quote! { mut },
+        Mutability::Not => quote! {},
+    };
+    Ok(quote! {
+        let #mutability #param_name = {
+            #[repr(C)]
+            #[derive(Clone, Copy)]
+            struct __CrubitDynCallback {
+                callable: *mut ::core::ffi::c_void,
+                invoke: unsafe extern "C" fn(*mut ::core::ffi::c_void, #( #inputs ),*) -> #output,
+            }
+            let __callback = unsafe { (#param_name as *const __CrubitDynCallback).read() };
+            move |#( #arg_names: #inputs ),*| -> #output {
+                unsafe { (__callback.invoke)(__callback.callable, #( #arg_names ),*) }
+            }
+        };
+    })
+}
+
 /// Formats a thunk implementation in Rust that provides an `extern "C"` ABI for
 /// calling a Rust function identified by `fn_def_id`.  `format_thunk_impl` may
 /// panic if `fn_def_id` doesn't identify a function.
@@ -1852,9 +2700,9 @@ fn format_thunk_impl<'tcx>(
             let rs_type = format_ty_for_rs(db, *ty)
                 .with_context(|| format!("Error handling parameter `{param_name}`"))?;
 
-            if is_bridged_type(tcx, *ty)?.is_some() {
+            if is_bridged_type(tcx, *ty)?.is_some() || DynCallback::new(db, *ty).is_some() {
                 Ok(quote! { #param_name: *const std::ffi::c_void })
-            } else if is_c_abi_compatible_by_value(*ty) {
+            } else if is_c_abi_compatible_by_value(db, *ty) {
                 Ok(quote! { #param_name: #rs_type })
             } else {
                 Ok(quote! { #param_name: &mut ::core::mem::MaybeUninit<#rs_type> })
@@ -1870,6 +2718,9 @@ fn format_thunk_impl<'tcx>(
             let rs_type = format_ty_for_rs(db, *ty)
                 .with_context(|| format!("Error handling parameter `{param_name}`"))?;
 
+            if let Some(callback) = DynCallback::new(db, *ty) {
+                return format_dyn_callback_conversion(db, callback, param_name);
+            }
             match is_bridged_type(tcx, *ty)? {
                 None => Ok(quote! {}),
                 Some(crubit_attr::BridgedTypeAttrs { cpp_to_rust_converter, .. }) => {
@@ -1899,7 +2750,13 @@ fn format_thunk_impl<'tcx>(
             if is_bridged_type(tcx, *ty)?.is_some() {
                 let varname_rs_out = format_ident!("__crubit_{}_uninit", rs_name);
                 Ok(quote! { unsafe { #varname_rs_out.assume_init() } })
-            } else if is_c_abi_compatible_by_value(*ty) {
+            } else if let Some(callback) = DynCallback::new(db, *ty) {
+                // `rs_name` is the closure that `format_dyn_callback_conversion` defined.
+                match callback.mutability {
+                    Mutability::Mut => Ok(quote! { &mut #rs_name }),
+                    Mutability::Not => Ok(quote! { &#rs_name }),
+                }
+            } else if is_c_abi_compatible_by_value(db, *ty) {
                 Ok(quote! { #rs_name })
             } else if let Safety::Unsafe = sig.safety {
                 // The whole call will be wrapped in `unsafe` below.
@@ -1919,7 +2776,253 @@ fn format_thunk_impl<'tcx>(
                 #fully_qualified_fn_name( #( #fn_args ),* )
             };
 
-            if !is_c_abi_compatible_by_value(sig.output()) {
+            if OwnedBuffer::new(db, sig.output()).is_some() {
+                // The C++ side owns the buffer from now on, and hands it back to Rust
+                // through `__crubit_drop` (see `rs_std::OwnedSlice` for the layout of
+                // `__CrubitOwnedSlice`).
+                let owned_ty = thunk_ret_type;
+                thunk_params.push(quote! { __ret_ptr: *mut ::core::ffi::c_void });
+                thunk_ret_type = quote! { () };
+                thunk_body = quote! {
+                    #[repr(C)]
+                    struct __CrubitOwnedSlice {
+                        data: *mut ::core::ffi::c_void,
+                        size: usize,
+                        capacity: usize,
+                        drop: extern "C" fn(*mut ::core::ffi::c_void, usize, usize),
+                    }
+                    extern "C" fn __crubit_drop(
+                        data: *mut ::core::ffi::c_void,
+                        size: usize,
+                        capacity: usize,
+                    ) {
+                        ::core::mem::drop(unsafe {
+                            <#owned_ty>::from_raw_parts(data as *mut _, size, capacity)
+                        });
+                    }
+                    let mut __rs_val = ::core::mem::ManuallyDrop::new({ #thunk_body });
+                    unsafe {
+                        (__ret_ptr as *mut __CrubitOwnedSlice).write(__CrubitOwnedSlice {
+                            data: __rs_val.as_mut_ptr() as *mut ::core::ffi::c_void,
+                            size: __rs_val.len(),
+                            capacity: __rs_val.capacity(),
+                            drop: __crubit_drop,
+                        });
+                    }
+                };
+            } else if BoxedIterator::new(db, sig.output()).is_some() {
+                // The C++ side owns the iterator from now on: it pulls the items in batches
+                // through `__crubit_next_batch`, and hands the iterator back to Rust through
+                // `__crubit_drop` (see `rs_std::BoxedIterator` for the layout of
+                // `__CrubitBoxedIterator`).  The iterator is boxed once more, because C++
+                // only holds a thin pointer to it.
+                let boxed_ty = thunk_ret_type;
+                let item_ty =
+                    format_ty_for_rs(db, BoxedIterator::new(db, sig.output()).unwrap().item_ty)?;
+                thunk_params.push(quote! { __ret_ptr: *mut ::core::ffi::c_void });
+                thunk_ret_type = quote! { () };
+                thunk_body = quote! {
+                    #[repr(C)]
+                    struct __CrubitBoxedIterator {
+                        state: *mut ::core::ffi::c_void,
+                        next_batch: extern "C" fn(
+                            *mut ::core::ffi::c_void,
+                            *mut ::core::ffi::c_void,
+                            usize,
+                        ) -> usize,
+                        drop: extern "C" fn(*mut ::core::ffi::c_void),
+                        batch: *mut ::core::ffi::c_void,
+                    }
+                    extern "C" fn __crubit_next_batch(
+                        state: *mut ::core::ffi::c_void,
+                        out: *mut ::core::ffi::c_void,
+                        capacity: usize,
+                    ) -> usize {
+                        let iter = unsafe { &mut *(state as *mut #boxed_ty) };
+                        let out = out as *mut #item_ty;
+                        let mut size = 0;
+                        while size < capacity {
+                            let Some(item) = iter.next() else { break };
+                            unsafe { out.add(size).write(item) };
+                            size += 1;
+                        }
+                        size
+                    }
+                    extern "C" fn __crubit_drop(state: *mut ::core::ffi::c_void) {
+                        ::core::mem::drop(unsafe {
+                            ::std::boxed::Box::from_raw(state as *mut #boxed_ty)
+                        });
+                    }
+                    let __rs_val: #boxed_ty = { #thunk_body };
+                    unsafe {
+                        (__ret_ptr as *mut __CrubitBoxedIterator).write(__CrubitBoxedIterator {
+                            state: ::std::boxed::Box::into_raw(::std::boxed::Box::new(__rs_val))
+                                as *mut ::core::ffi::c_void,
+                            next_batch: __crubit_next_batch,
+                            drop: __crubit_drop,
+                            batch: ::core::ptr::null_mut(),
+                        });
+                    }
+                };
+            } else if let Some(boxed_future) = BoxedFuture::new(db, sig.output()) {
+                // The C++ side owns the future from now on: it polls it through
+                // `__crubit_poll`, and hands it back to Rust through `__crubit_drop` (see
+                // `rs_std::BoxedFuture` for the layout of `__CrubitBoxedFuture`).  The
+                // future is boxed once more, because C++ only holds a thin pointer to it.
+                //
+                // The `Waker` passed to the future calls the C++ wake hook.  The one that
+                // `__crubit_poll` creates borrows the hook, so that polling doesn't allocate.
+                // Its clones share a reference-counted copy, which releases the C++ context
+                // once the last clone is dropped.  Either way, each call to `__crubit_poll`
+                // releases its context exactly once (see `rs_std::BoxedFuture::poll`).
+                let boxed_ty = thunk_ret_type;
+                let output_ty = format_ty_for_rs(db, boxed_future.output_ty)?;
+                let write_output = if boxed_future.output_ty.is_unit() {
+                    quote! { let () = output; }
+                } else {
+                    quote! { unsafe { (out as *mut #output_ty).write(output) }; }
+                };
+                thunk_params.push(quote! { __ret_ptr: *mut ::core::ffi::c_void });
+                thunk_ret_type = quote! { () };
+                thunk_body = quote! {
+                    #[repr(C)]
+                    struct __CrubitBoxedFuture {
+                        state: *mut ::core::ffi::c_void,
+                        poll: extern "C" fn(
+                            *mut ::core::ffi::c_void,
+                            *mut ::core::ffi::c_void,
+                            extern "C" fn(*mut ::core::ffi::c_void),
+                            extern "C" fn(*mut ::core::ffi::c_void),
+                            *mut ::core::ffi::c_void,
+                        ) -> bool,
+                        drop: extern "C" fn(*mut ::core::ffi::c_void),
+                    }
+                    #[derive(Clone, Copy)]
+                    struct __CrubitWakeHook {
+                        wake: extern "C" fn(*mut ::core::ffi::c_void),
+                        release: extern "C" fn(*mut ::core::ffi::c_void),
+                        context: *mut ::core::ffi::c_void,
+                    }
+                    struct __CrubitSharedWakeHook(__CrubitWakeHook);
+                    // `rs_std::BoxedFuture::poll` requires the hooks to be callable from any
+                    // thread.
+                    unsafe impl Send for __CrubitSharedWakeHook {}
+                    unsafe impl Sync for __CrubitSharedWakeHook {}
+                    impl Drop for __CrubitSharedWakeHook {
+                        fn drop(&mut self) {
+                            (self.0.release)(self.0.context);
+                        }
+                    }
+                    struct __CrubitPollWaker {
+                        hook: __CrubitWakeHook,
+                        shared: ::std::sync::OnceLock<
+                            ::std::sync::Arc<__CrubitSharedWakeHook>
+                        >,
+                    }
+                    unsafe fn __crubit_clone_poll_waker(data: *const ()) -> ::core::task::RawWaker {
+                        let poll_waker = unsafe { &*(data as *const __CrubitPollWaker) };
+                        let shared = poll_waker.shared.get_or_init(|| {
+                            ::std::sync::Arc::new(__CrubitSharedWakeHook(poll_waker.hook))
+                        });
+                        ::core::task::RawWaker::new(
+                            ::std::sync::Arc::into_raw(::std::sync::Arc::clone(shared))
+                                as *const (),
+                            &__CRUBIT_SHARED_WAKER_VTABLE,
+                        )
+                    }
+                    unsafe fn __crubit_wake_poll_waker_by_ref(data: *const ()) {
+                        let hook = unsafe { &(*(data as *const __CrubitPollWaker)).hook };
+                        (hook.wake)(hook.context);
+                    }
+                    unsafe fn __crubit_drop_poll_waker(_data: *const ()) {}
+                    static __CRUBIT_POLL_WAKER_VTABLE: ::core::task::RawWakerVTable =
+                        ::core::task::RawWakerVTable::new(
+                            __crubit_clone_poll_waker,
+                            __crubit_wake_poll_waker_by_ref,
+                            __crubit_wake_poll_waker_by_ref,
+                            __crubit_drop_poll_waker,
+                        );
+                    unsafe fn __crubit_clone_shared_waker(
+                        data: *const (),
+                    ) -> ::core::task::RawWaker {
+                        unsafe {
+                            ::std::sync::Arc::increment_strong_count(
+                                data as *const __CrubitSharedWakeHook,
+                            )
+                        };
+                        ::core::task::RawWaker::new(data, &__CRUBIT_SHARED_WAKER_VTABLE)
+                    }
+                    unsafe fn __crubit_wake_shared_waker(data: *const ()) {
+                        unsafe {
+                            __crubit_wake_shared_waker_by_ref(data);
+                            __crubit_drop_shared_waker(data);
+                        }
+                    }
+                    unsafe fn __crubit_wake_shared_waker_by_ref(data: *const ()) {
+                        let hook = unsafe { &(*(data as *const __CrubitSharedWakeHook)).0 };
+                        (hook.wake)(hook.context);
+                    }
+                    unsafe fn __crubit_drop_shared_waker(data: *const ()) {
+                        ::core::mem::drop(unsafe {
+                            ::std::sync::Arc::from_raw(data as *const __CrubitSharedWakeHook)
+                        });
+                    }
+                    static __CRUBIT_SHARED_WAKER_VTABLE: ::core::task::RawWakerVTable =
+                        ::core::task::RawWakerVTable::new(
+                            __crubit_clone_shared_waker,
+                            __crubit_wake_shared_waker,
+                            __crubit_wake_shared_waker_by_ref,
+                            __crubit_drop_shared_waker,
+                        );
+                    extern "C" fn __crubit_poll(
+                        state: *mut ::core::ffi::c_void,
+                        out: *mut ::core::ffi::c_void,
+                        wake: extern "C" fn(*mut ::core::ffi::c_void),
+                        release: extern "C" fn(*mut ::core::ffi::c_void),
+                        context: *mut ::core::ffi::c_void,
+                    ) -> bool {
+                        let future = unsafe { &mut *(state as *mut #boxed_ty) };
+                        let poll_waker = __CrubitPollWaker {
+                            hook: __CrubitWakeHook { wake, release, context },
+                            shared: ::std::sync::OnceLock::new(),
+                        };
+                        // Never dropped, since it doesn't own `poll_waker`.
+                        let waker = ::core::mem::ManuallyDrop::new(unsafe {
+                            ::core::task::Waker::from_raw(::core::task::RawWaker::new(
+                                &poll_waker as *const __CrubitPollWaker as *const (),
+                                &__CRUBIT_POLL_WAKER_VTABLE,
+                            ))
+                        });
+                        let mut cx = ::core::task::Context::from_waker(&waker);
+                        let done = match future.as_mut().poll(&mut cx) {
+                            ::core::task::Poll::Ready(output) => {
+                                #write_output
+                                true
+                            }
+                            ::core::task::Poll::Pending => false,
+                        };
+                        // If the waker was cloned, the last clone releases the context.
+                        if poll_waker.shared.into_inner().is_none() {
+                            release(context);
+                        }
+                        done
+                    }
+                    extern "C" fn __crubit_drop(state: *mut ::core::ffi::c_void) {
+                        ::core::mem::drop(unsafe {
+                            ::std::boxed::Box::from_raw(state as *mut #boxed_ty)
+                        });
+                    }
+                    let __rs_val: #boxed_ty = ::std::boxed::Box::pin({ #thunk_body });
+                    unsafe {
+                        (__ret_ptr as *mut __CrubitBoxedFuture).write(__CrubitBoxedFuture {
+                            state: ::std::boxed::Box::into_raw(::std::boxed::Box::new(__rs_val))
+                                as *mut ::core::ffi::c_void,
+                            poll: __crubit_poll,
+                            drop: __crubit_drop,
+                        });
+                    }
+                };
+            } else if !is_c_abi_compatible_by_value(db, sig.output()) {
                 thunk_params.push(quote! {
                     __ret_slot: &mut ::core::mem::MaybeUninit<#thunk_ret_type>
                 });
@@ -2025,7 +3128,7 @@ fn check_fn_sig(sig: &ty::FnSig) -> Result<()> {
 
 /// Returns `Ok(())` if no thunk is required.
 /// Otherwise returns an error the describes why the thunk is needed.
-fn is_thunk_required(sig: &ty::FnSig) -> Result<()> {
+fn is_thunk_required<'tcx>(db: &dyn BindingsGenerator<'tcx>, sig: &ty::FnSig<'tcx>) -> Result<()> {
     match sig.abi {
         // "C" ABI is okay: since https://rust-lang.github.io/rfcs/2945-c-unwind-abi.html has been
         // accepted, a Rust panic that "escapes" a "C" ABI function is a defined crash. See
@@ -2043,9 +3146,12 @@ fn is_thunk_required(sig: &ty::FnSig) -> Result<()> {
         _ => bail!("Any calling convention other than `extern \"C\"` requires a thunk"),
     };
 
-    ensure!(is_c_abi_compatible_by_value(sig.output()), "Return type requires a thunk");
+    ensure!(is_c_abi_compatible_by_value(db, sig.output()), "Return type requires a thunk");
     for (i, param_ty) in sig.inputs().iter().enumerate() {
-        ensure!(is_c_abi_compatible_by_value(*param_ty), "Type of parameter #{i} requires a thunk");
+        ensure!(
+            is_c_abi_compatible_by_value(db, *param_ty),
+            "Type of parameter #{i} requires a thunk"
+        );
     }
 
     Ok(())
@@ -2315,9 +3421,10 @@ fn format_const(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Res
     Ok(ApiSnippets {
         main_api: CcSnippet {
             tokens: match hir_node {
+                // `inline` avoids a separate (internal linkage) copy per translation unit.
                 Node::Item(_) => {
                     quote! {
-                        constexpr #cc_type #cc_name = #cc_value;
+                        inline constexpr #cc_type #cc_name = #cc_value;
                     }
                 }
                 Node::ImplItem(_) => {
@@ -2374,6 +3481,176 @@ fn create_type_alias<'tcx>(
     })
 }
 
+/// Formats the body of the Rust function `local_def_id` as the body of its C++
+/// bindings, if the Rust function is trivial enough to be translated (see
+/// `BindingsGenerator::inline_trivial_functions`).  This way the C++ bindings
+/// can be inlined into their C++ callers, instead of calling a thunk.
+///
+/// The following function bodies are supported:
+/// - an empty body of a function returning `()`,
+/// - a `bool`, integer or floating-point literal (e.g. `{ 42 }` or `{ -1.5 }`),
+/// - a `bool`, integer or floating-point field of `self` in a method that takes
+///   `self` by reference (e.g. `{ self.x }`).
+///
+/// Returns `None` if the function is not trivial.
+fn format_trivial_fn_body_for_cc<'tcx>(
+    db: &dyn BindingsGenerator<'tcx>,
+    local_def_id: LocalDefId,
+    sig_mid: &ty::FnSig<'tcx>,
+    method_kind: &FunctionKind,
+) -> Option<TokenStream> {
+    let tcx = db.tcx();
+
+    // Other parameters would be unused by the C++ function (or, if taken by value, might need
+    // to be dropped by the Rust function).
+    let num_self_params = if *method_kind == FunctionKind::MethodTakingSelfByRef { 1 } else { 0 };
+    if sig_mid.inputs().len() != num_self_params {
+        return None;
+    }
+
+    let body = tcx.hir().body(tcx.hir_node_by_def_id(local_def_id).body_id()?);
+    let rustc_hir::ExprKind::Block(block, None) = body.value.kind else {
+        return None;
+    };
+    if !block.stmts.is_empty() || !matches!(block.rules, rustc_hir::BlockCheckMode::DefaultBlock) {
+        return None;
+    }
+    let output = sig_mid.output();
+    let Some(expr) = block.expr else {
+        return output.is_unit().then(|| quote! {});
+    };
+    if !matches!(
+        output.kind(),
+        ty::TyKind::Bool | ty::TyKind::Int(_) | ty::TyKind::Uint(_) | ty::TyKind::Float(_)
+    ) {
+        return None;
+    }
+    let typeck_results = tcx.typeck(local_def_id);
+    if typeck_results.expr_ty_adjusted(expr) != output {
+        return None;
+    }
+
+    let value = match expr.kind {
+        rustc_hir::ExprKind::Lit(lit) => format_lit_for_cc(&lit.node, output, false)?,
+        rustc_hir::ExprKind::Unary(rustc_hir::UnOp::Neg, operand) => match operand.kind {
+            rustc_hir::ExprKind::Lit(lit) => format_lit_for_cc(&lit.node, output, true)?,
+            _ => return None,
+        },
+        rustc_hir::ExprKind::Field(base, _)
+            if *method_kind == FunctionKind::MethodTakingSelfByRef =>
+        {
+            let rustc_hir::PatKind::Binding(_, self_hir_id, _, None) = body.params[0].pat.kind
+            else {
+                return None;
+            };
+            let rustc_hir::ExprKind::Path(rustc_hir::QPath::Resolved(None, path)) = base.kind
+            else {
+                return None;
+            };
+            if path.res != Res::Local(self_hir_id) {
+                return None;
+            }
+            let field_cc_name = format_self_field_cc_name(
+                db,
+                local_def_id,
+                typeck_results.expr_ty_adjusted(base).peel_refs(),
+                typeck_results.field_index(expr.hir_id),
+            )?;
+            quote! { this->#field_cc_name }
+        }
+        _ => return None,
+    };
+    Some(quote! { return #value; })
+}
+
+/// Formats the literal `lit` of type `ty` (negated if `negate` is true) as a
+/// C++ expression with the same value.  Returns `None` for unsupported
+/// literals.
+fn format_lit_for_cc(lit: &LitKind, ty: Ty, negate: bool) -> Option<TokenStream> {
+    let text = match (lit, ty.kind()) {
+        (LitKind::Bool(value), ty::TyKind::Bool) if !negate => value.to_string(),
+        (LitKind::Int(value, _), ty::TyKind::Int(_) | ty::TyKind::Uint(_)) => {
+            // Unsuffixed decimal C++ literals have a signed type, so big values need a `u`
+            // suffix, and `i64::MIN` can't be spelled as a negated literal.
+            let value = value.get();
+            match (negate, value) {
+                (false, value) if value > i64::MAX as u128 => format!("{value}u"),
+                (false, value) => value.to_string(),
+                (true, value) if value == i64::MIN.unsigned_abs() as u128 => {
+                    "(-9223372036854775807 - 1)".to_string()
+                }
+                (true, value) => format!("-{value}"),
+            }
+        }
+        (LitKind::Float(symbol, _), ty::TyKind::Float(float_ty)) => {
+            let mut text = symbol.as_str().replace('_', "");
+            if text.ends_with('.') {
+                text.push('0');
+            } else if !text.contains(['.', 'e', 'E']) {
+                text.push_str(".0");
+            }
+            // Parsing an `f32` literal as a `double` first could round it differently.
+            if *float_ty == ty::FloatTy::F32 {
+                text.push('f');
+            }
+            if negate {
+                format!("-{text}")
+            } else {
+                text
+            }
+        }
+        _ => return None,
+    };
+    text.parse().ok()
+}
+
+/// Formats the C++ name of the field `field_index` of the struct `self_ty`,
+/// for reading it in the C++ bindings of the method `local_def_id`.
+///
+/// Returns `None` if the name depends on whether the bindings of other methods
+/// of the struct can be generated (see the `member_function_names` passed to
+/// `format_field_cc_name` by `format_adt`).
+fn format_self_field_cc_name<'tcx>(
+    db: &dyn BindingsGenerator<'tcx>,
+    local_def_id: LocalDefId,
+    self_ty: Ty<'tcx>,
+    field_index: FieldIdx,
+) -> Option<TokenStream> {
+    let tcx = db.tcx();
+    let ty::TyKind::Adt(adt, _) = self_ty.kind() else {
+        return None;
+    };
+    if !adt.is_struct() {
+        return None;
+    }
+    let variant = adt.non_enum_variant();
+    let field_def = &variant.fields[field_index];
+    let index = variant
+        .fields
+        .iter()
+        .sorted_by_key(|field| tcx.def_span(field.did))
+        .position(|field| field.did == field_def.did)?;
+    let name = field_def.ident(tcx).to_string();
+
+    let def_id = local_def_id.to_def_id();
+    let has_other_method_with_field_name = tcx
+        .inherent_impls(adt.did())
+        .iter()
+        .flat_map(|impl_id| tcx.associated_items(*impl_id).in_definition_order())
+        .filter(|item| item.kind == ty::AssocKind::Fn && item.def_id != def_id)
+        .filter(|item| is_exported(tcx, item.def_id))
+        .any(|item| {
+            FullyQualifiedName::new(db, item.def_id).cpp_name.is_some_and(|n| n.as_str() == name)
+        });
+    if has_other_method_with_field_name {
+        return None;
+    }
+    // `format_adt` will see that the bindings of this method were generated.
+    let member_function_names =
+        HashSet::from([FullyQualifiedName::new(db, def_id).cpp_name?.to_string()]);
+    Some(format_field_cc_name(db, &name, index, &member_function_names))
+}
+
 /// Formats a function with the given `local_def_id`.
 ///
 /// Will panic if `local_def_id`
@@ -2393,7 +3670,8 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
     // TODO(b/262904507): Don't require thunks for mangled extern "C" functions.
     let has_export_name = tcx.get_attr(def_id, rustc_span::symbol::sym::export_name).is_some();
     let has_no_mangle = tcx.get_attr(def_id, rustc_span::symbol::sym::no_mangle).is_some();
-    let needs_thunk = is_thunk_required(&sig_mid).is_err() || (!has_no_mangle && !has_export_name);
+    let needs_thunk =
+        is_thunk_required(db, &sig_mid).is_err() || (!has_no_mangle && !has_export_name);
     let thunk_name = {
         let symbol_name = if db.no_thunk_name_mangling() {
             if has_export_name {
@@ -2516,6 +3794,12 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
         None => None,
     };
     let needs_definition = unqualified_rust_fn_name.as_str() != thunk_name;
+    let trivial_body = if db.inline_trivial_functions() && needs_thunk {
+        format_trivial_fn_body_for_cc(db, local_def_id, &sig_mid, &method_kind)
+    } else {
+        None
+    };
+    let noexcept = format_noexcept(tcx);
     let main_api_params = params
         .iter()
         .skip(if method_kind.has_self_param() { 1 } else { 0 })
@@ -2573,7 +3857,7 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
                 #extern_c #(#attributes)* #static_
                     #main_api_ret_type #main_api_fn_name (
                         #( #main_api_params ),*
-                    ) #method_qualifiers;
+                    ) #method_qualifiers #noexcept;
                 __NEWLINE__
             },
         }
@@ -2593,21 +3877,26 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
         };
 
         let mut prereqs = main_api_prereqs;
-        let thunk_decl =
+        let thunk_decl = if trivial_body.is_some() {
+            quote! {}
+        } else {
             format_thunk_decl(db, &sig_mid, Some(sig_hir), &thunk_name, AllowReferences::Safe)?
-                .into_tokens(&mut prereqs);
+                .into_tokens(&mut prereqs)
+        };
 
         let mut thunk_args = params
             .iter()
             .enumerate()
             .map(|(i, Param { cc_name, cpp_type, ty, .. })| {
                 if i == 0 && method_kind.has_self_param() {
-                    if method_kind == FunctionKind::MethodTakingSelfByValue {
+                    if method_kind == FunctionKind::MethodTakingSelfByValue
+                        && !is_c_abi_compatible_by_value(db, *ty)
+                    {
                         Ok(quote! { this })
                     } else {
                         Ok(quote! { *this })
                     }
-                } else if is_c_abi_compatible_by_value(*ty) {
+                } else if is_c_abi_compatible_by_value(db, *ty) {
                     Ok(quote! { #cc_name })
                 } else if !ty.needs_drop(tcx, tcx.param_env(def_id)) {
                     // As an optimization, if the type is trivially destructible, we don't
@@ -2627,7 +3916,9 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
             })
             .collect::<Result<Vec<_>>>()?;
         let impl_body: TokenStream;
-        if let Some(attrs) = is_bridged_type(db.tcx(), sig_mid.output())? {
+        if let Some(trivial_body) = &trivial_body {
+            impl_body = trivial_body.clone();
+        } else if let Some(attrs) = is_bridged_type(db.tcx(), sig_mid.output())? {
             let cpp_type = format_cc_ident(db, attrs.cpp_type.as_str())?;
             thunk_args.push(quote! { &__ret_val_holder.val });
 
@@ -2647,23 +3938,50 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
 
                 return std::move(__ret_val_holder.val);
             };
-        } else if is_c_abi_compatible_by_value(sig_mid.output()) {
+        } else if is_c_abi_compatible_by_value(db, sig_mid.output()) {
             impl_body = quote! {
                 return __crubit_internal :: #thunk_name( #( #thunk_args ),* );
             };
         } else {
-            if let Some(adt_def) = sig_mid.output().ty_adt_def() {
+            // Owned buffers (see `OwnedBuffer`), boxed iterators (see `BoxedIterator`) and
+            // futures (see `BoxedFuture`) are initialized in place by the thunk and don't
+            // have `format_adt_core` bindings.
+            let is_owned_buffer = OwnedBuffer::new(db, sig_mid.output()).is_some()
+                || BoxedIterator::new(db, sig_mid.output()).is_some()
+                || BoxedFuture::new(db, sig_mid.output()).is_some();
+            let mut has_in_place_ctor = false;
+            if let Some(adt_def) = sig_mid.output().ty_adt_def().filter(|_| !is_owned_buffer) {
                 let core = db.format_adt_core(adt_def.did())?;
                 db.format_move_ctor_and_assignment_operator(core).map_err(|_| {
                     anyhow!("Can't pass the return type by value without a move constructor")
                 })?;
+                // ADTs from other crates may have been generated without the in-place constructor,
+                // and ADTs with a `cpp_type` don't get a C++ definition (see `format_item`), so
+                // they don't have one either.
+                has_in_place_ctor = db.return_values_in_place()
+                    && adt_def.did().is_local()
+                    && crubit_attr::get_attrs(db.tcx(), adt_def.did())?.cpp_type.is_none();
+            }
+            if has_in_place_ctor {
+                // The thunk initializes the return value directly in the caller's return
+                // location (see `format_in_place_ctor`), avoiding the move out of a
+                // `crubit::ReturnValueSlot`.
+                thunk_args.push(quote! { __ret_ptr });
+                impl_body = quote! {
+                    return #main_api_ret_type(
+                        crubit::InPlaceInitTag(),
+                        [&](#main_api_ret_type* __ret_ptr) {
+                            __crubit_internal :: #thunk_name( #( #thunk_args ),* );
+                        });
+                };
+            } else {
+                thunk_args.push(quote! { __ret_slot.Get() });
+                impl_body = quote! {
+                    crubit::ReturnValueSlot<#main_api_ret_type> __ret_slot;
+                    __crubit_internal :: #thunk_name( #( #thunk_args ),* );
+                    return std::move(__ret_slot).AssumeInitAndTakeValue();
+                };
             }
-            thunk_args.push(quote! { __ret_slot.Get() });
-            impl_body = quote! {
-                crubit::ReturnValueSlot<#main_api_ret_type> __ret_slot;
-                __crubit_internal :: #thunk_name( #( #thunk_args ),* );
-                return std::move(__ret_slot).AssumeInitAndTakeValue();
-            };
             prereqs.includes.insert(CcInclude::utility()); // for `std::move`
             prereqs.includes.insert(db.support_header("internal/return_value_slot.h"));
         };
@@ -2673,7 +3991,7 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
                 __NEWLINE__
                 #thunk_decl
                 inline #main_api_ret_type #struct_name #main_api_fn_name (
-                        #( #main_api_params ),* ) #method_qualifiers {
+                        #( #main_api_params ),* ) #method_qualifiers #noexcept {
                     #impl_body
                 }
                 __NEWLINE__
@@ -2681,7 +3999,7 @@ fn format_fn(db: &dyn BindingsGenerator<'_>, local_def_id: LocalDefId) -> Result
         }
     };
 
-    let rs_details = if !needs_thunk {
+    let rs_details = if !needs_thunk || trivial_body.is_some() {
         quote! {}
     } else {
         let fully_qualified_fn_name = match struct_name.as_ref() {
@@ -2957,6 +4275,28 @@ fn get_tag_size_with_padding(layout: Layout<'_>) -> u64 {
     }
 }
 
+/// Formats the C++ name of the field `name` (the `index`-th field of its
+/// variant, in source order).  Fields get a `_` suffix if they have the same
+/// name as one of the `member_function_names`.
+fn format_field_cc_name(
+    db: &dyn BindingsGenerator<'_>,
+    name: &str,
+    index: usize,
+    member_function_names: &HashSet<String>,
+) -> TokenStream {
+    let cc_name = if member_function_names.contains(name) {
+        // TODO: Handle the case of name_ itself also being taken? e.g. the
+        // Rust struct struct S {a: i32, a_:
+        // i32} impl S { fn a() {} fn a_()
+        // {} fn a__(){}.
+        format!("{name}_")
+    } else {
+        name.to_string()
+    };
+    format_cc_ident(db, cc_name.as_str())
+        .unwrap_or_else(|_err| format_ident!("__field{index}").into_token_stream())
+}
+
 /// Returns the body of the C++ struct that represents the given ADT.
 fn format_fields<'tcx>(
     db: &dyn BindingsGenerator<'tcx>,
@@ -3129,19 +4469,8 @@ fn format_fields<'tcx>(
                                 })
                             });
                             let name = field_def.ident(tcx).to_string();
-                            let cc_name = if member_function_names.contains(&name) {
-                                // TODO: Handle the case of name_ itself also being taken? e.g. the
-                                // Rust struct struct S {a: i32, a_:
-                                // i32} impl S { fn a() {} fn a_()
-                                // {} fn a__(){}.
-                                format!("{name}_")
-                            } else {
-                                name.clone()
-                            };
                             let cc_name =
-                                format_cc_ident(db, cc_name.as_str()).unwrap_or_else(|_err| {
-                                    format_ident!("__field{index}").into_token_stream()
-                                });
+                                format_field_cc_name(db, &name, index, member_function_names);
                             let rs_name = {
                                 let name_starts_with_digit = name
                                     .as_str()
@@ -3845,9 +5174,10 @@ fn format_default_ctor<'tcx>(
         } = format_trait_thunks(db, trait_id, &core)?;
 
         let cc_struct_name = &core.cc_short_name;
+        let noexcept = format_noexcept(tcx);
         let main_api = CcSnippet::new(quote! {
             __NEWLINE__ __COMMENT__ "Default::default"
-            #cc_struct_name(); __NEWLINE__ __NEWLINE__
+            #cc_struct_name() #noexcept; __NEWLINE__ __NEWLINE__
         });
         let cc_details = {
             let thunk_name = method_name_to_cc_thunk_name
@@ -3858,10 +5188,18 @@ fn format_default_ctor<'tcx>(
             let mut prereqs = CcPrerequisites::default();
             let cc_thunk_decls = cc_thunk_decls.into_tokens(&mut prereqs);
 
+            let body = if is_c_abi_compatible_by_value(db, core.self_ty) {
+                // The thunk returns the value directly (rather than through `this` used as
+                // an out-parameter) and the struct is trivially copyable (see
+                // `is_c_abi_compatible_adt`).
+                quote! { *this = __crubit_internal::#thunk_name(); }
+            } else {
+                quote! { __crubit_internal::#thunk_name(this); }
+            };
             let tokens = quote! {
                 #cc_thunk_decls
-                inline #cc_struct_name::#cc_struct_name() {
-                    __crubit_internal::#thunk_name(this);
+                inline #cc_struct_name::#cc_struct_name() #noexcept {
+                    #body
                 }
             };
             CcSnippet { tokens, prereqs }
@@ -3930,11 +5268,12 @@ fn format_copy_ctor_and_assignment_operator<'tcx>(
             cc_thunk_decls,
             rs_thunk_impls: rs_details,
         } = format_trait_thunks(db, trait_id, &core)?;
+        let noexcept = format_noexcept(tcx);
         let main_api = CcSnippet::new(quote! {
             __NEWLINE__ __COMMENT__ "Clone::clone"
-            #cc_struct_name(const #cc_struct_name&); __NEWLINE__
+            #cc_struct_name(const #cc_struct_name&) #noexcept; __NEWLINE__
             __NEWLINE__ __COMMENT__ "Clone::clone_from"
-            #cc_struct_name& operator=(const #cc_struct_name&); __NEWLINE__ __NEWLINE__
+            #cc_struct_name& operator=(const #cc_struct_name&) #noexcept; __NEWLINE__ __NEWLINE__
         });
         let cc_details = {
             // `unwrap` calls are okay because `Clone` trait always has these methods.
@@ -3946,10 +5285,11 @@ fn format_copy_ctor_and_assignment_operator<'tcx>(
 
             let tokens = quote! {
                 #cc_thunk_decls
-                inline #cc_struct_name::#cc_struct_name(const #cc_struct_name& other) {
+                inline #cc_struct_name::#cc_struct_name(const #cc_struct_name& other) #noexcept {
                     __crubit_internal::#clone_thunk_name(other, this);
                 }
-                inline #cc_struct_name& #cc_struct_name::operator=(const #cc_struct_name& other) {
+                inline #cc_struct_name& #cc_struct_name::operator=(
+                        const #cc_struct_name& other) #noexcept {
                     if (this != &other) {
                         __crubit_internal::#clone_from_thunk_name(*this, other);
                     }
@@ -3992,19 +5332,20 @@ fn format_move_ctor_and_assignment_operator<'tcx>(
             let has_default_ctor = db.format_default_ctor(core.clone()).is_ok();
             let is_unpin = core.self_ty.is_unpin(tcx, tcx.param_env(core.def_id));
             if has_default_ctor && is_unpin {
+                let noexcept = format_noexcept(tcx);
                 let main_api = CcSnippet::new(quote! {
-                    #adt_cc_name(#adt_cc_name&&); __NEWLINE__
-                    #adt_cc_name& operator=(#adt_cc_name&&); __NEWLINE__
+                    #adt_cc_name(#adt_cc_name&&) #noexcept; __NEWLINE__
+                    #adt_cc_name& operator=(#adt_cc_name&&) #noexcept; __NEWLINE__
                 });
                 let mut prereqs = CcPrerequisites::default();
                 prereqs.includes.insert(db.support_header("internal/memswap.h"));
                 prereqs.includes.insert(CcInclude::utility()); // for `std::move`
                 let tokens = quote! {
-                    inline #adt_cc_name::#adt_cc_name(#adt_cc_name&& other)
+                    inline #adt_cc_name::#adt_cc_name(#adt_cc_name&& other) #noexcept
                             : #adt_cc_name() {
                         *this = std::move(other);
                     }
-                    inline #adt_cc_name& #adt_cc_name::operator=(#adt_cc_name&& other) {
+                    inline #adt_cc_name& #adt_cc_name::operator=(#adt_cc_name&& other) #noexcept {
                         crubit::MemSwap(*this, other);
                         return *this;
                     }
@@ -4087,6 +5428,38 @@ fn format_move_ctor_and_assignment_operator<'tcx>(
     })
 }
 
+/// Formats a constructor that lets `format_fn` construct a returned ADT in place
+/// (if `BindingsGenerator::return_values_in_place` is set).  The constructor
+/// leaves the fields uninitialized and passes `this` to `init`, which calls a
+/// thunk that writes the Rust value there - like the thunk of `Default::default`
+/// does for the default constructor.  Since the constructor is called in a
+/// `return` statement, C++17 guaranteed copy elision makes `this` the caller's
+/// return location.
+fn format_in_place_ctor<'tcx>(
+    db: &dyn BindingsGenerator<'tcx>,
+    core: &AdtCoreBindings<'tcx>,
+) -> ApiSnippets {
+    if !db.return_values_in_place() {
+        return ApiSnippets::default();
+    }
+    let adt_cc_name = &core.cc_short_name;
+    let mut prereqs = CcPrerequisites::default();
+    prereqs.includes.insert(db.support_header("internal/return_value_slot.h"));
+    prereqs.includes.insert(CcInclude::utility()); // for `std::forward`
+    let main_api = CcSnippet {
+        tokens: quote! {
+            __NEWLINE__ __COMMENT__ "For internal use by the bindings of functions returning this type."
+            template <typename F> __NEWLINE__
+            #adt_cc_name(crubit::InPlaceInitTag, F&& init) {
+                std::forward<F>(init)(this);
+            }
+            __NEWLINE__
+        },
+        prereqs,
+    };
+    ApiSnippets { main_api, ..Default::default() }
+}
+
 /// Formats an algebraic data type (an ADT - a struct, an enum, or a union)
 /// represented by `core`.  This function is infallible - after
 /// `format_adt_core` returns success we have committed to emitting C++ bindings
@@ -4151,6 +5524,8 @@ fn format_adt<'tcx>(
     let move_ctor_and_assignment_snippets =
         db.format_move_ctor_and_assignment_operator(core.clone()).unwrap_or_else(|err| err);
 
+    let in_place_ctor_snippets = format_in_place_ctor(db, &core);
+
     let mut member_function_names = HashSet::<String>::new();
     let impl_items_snippets = tcx
         .inherent_impls(core.def_id)
@@ -4203,6 +5578,7 @@ fn format_adt<'tcx>(
         destructor_snippets,
         move_ctor_and_assignment_snippets,
         copy_ctor_and_assignment_snippets,
+        in_place_ctor_snippets,
         impl_items_snippets,
     ]
     .into_iter()
@@ -4274,6 +5650,17 @@ fn format_adt<'tcx>(
         let public_functions_cc_details = public_functions_cc_details.into_tokens(&mut prereqs);
         let fields_cc_details = fields_cc_details.into_tokens(&mut prereqs);
         prereqs.defs.insert(local_def_id);
+        let abi_assertion = if is_c_abi_compatible_by_value(db, core.self_ty) {
+            // Field offsets are verified by `format_fields`.
+            prereqs.includes.insert(CcInclude::type_traits());
+            quote! {
+                static_assert(
+                    std::is_trivially_copyable_v<#adt_cc_name>,
+                    "The ADT is passed by value to and from `extern \"C\"` functions");
+            }
+        } else {
+            quote! {}
+        };
         CcSnippet {
             prereqs,
             tokens: quote! {
@@ -4284,6 +5671,7 @@ fn format_adt<'tcx>(
                 static_assert(
                     alignof(#adt_cc_name) == #alignment,
                     "Verify that ADT layout didn't change since this header got generated");
+                #abi_assertion
                 __NEWLINE__
                 #public_functions_cc_details
                 #fields_cc_details
@@ -4322,6 +5710,40 @@ fn format_fwd_decl(db: &Database<'_>, def_id: LocalDefId) -> TokenStream {
     quote! { #keyword #cc_short_name; }
 }
 
+/// Formats the forward declarations of `extern_fwd_decls` (ADTs from other
+/// crates - see `CcPrerequisites::extern_fwd_decls`), each in the namespace of
+/// its crate.  The result should be placed outside of the top-level namespace
+/// of the current crate.
+fn format_extern_fwd_decls(db: &Database<'_>, extern_fwd_decls: HashSet<DefId>) -> TokenStream {
+    let tcx = db.tcx();
+    let extern_fwd_decls = extern_fwd_decls
+        .into_iter()
+        .map(|def_id| {
+            // `extern_fwd_decls` only contain ADTs for which `format_ty_for_cc`
+            // has already verified that `format_adt_core` succeeds.
+            let core_bindings = db.format_adt_core(def_id).expect(
+                "`format_extern_fwd_decls` should only be called if `format_adt_core` succeeded",
+            );
+            let AdtCoreBindings { keyword, cc_short_name, .. } = &*core_bindings;
+            let FullyQualifiedName { cpp_top_level_ns, cpp_ns_path, .. } =
+                FullyQualifiedName::new(db, def_id);
+            let ns = NamespaceQualifier::new(
+                once(Rc::<str>::from(cpp_top_level_ns.as_str())).chain(cpp_ns_path.0),
+            );
+            (tcx.def_path_str(def_id), ns, quote! { #keyword #cc_short_name; })
+        })
+        .sorted_by(|(lhs_path, lhs_ns, _), (rhs_path, rhs_ns, _)| {
+            (&lhs_ns.0, lhs_path).cmp(&(&rhs_ns.0, rhs_path))
+        })
+        .map(|(_, ns, tokens)| (None, ns, tokens));
+    let extern_fwd_decls = format_namespace_bound_cc_tokens(db, extern_fwd_decls, tcx);
+    if extern_fwd_decls.is_empty() {
+        extern_fwd_decls
+    } else {
+        quote! { #extern_fwd_decls __NEWLINE__ __NEWLINE__ }
+    }
+}
+
 fn format_source_location(tcx: TyCtxt, local_def_id: LocalDefId) -> String {
     let def_span = tcx.def_span(local_def_id);
     let rustc_span::FileLines { file, lines } =
@@ -4504,48 +5926,171 @@ fn format_namespace_bound_cc_tokens(
     iter.collect()
 }
 
+/// Returns the items that `format_crate` generates bindings for: all the items
+/// of the crate, or - if `BindingsGenerator::emit_items` is set - only the
+/// requested items and, transitively, the items of the crate that their C++
+/// bindings depend on (`CcPrerequisites::defs` and `CcPrerequisites::fwd_decls`).
+/// The other items are never formatted, so that large crates don't pay for the
+/// bindings (e.g. the special member functions of ADTs) that no C++ code uses.
+///
+/// The items are returned in HIR order, so that sorting them by span (with a
+/// stable sort) gives a deterministic order even for items with equal spans
+/// (e.g. items generated by the same macro invocation).
+fn items_to_emit(db: &Database) -> Result<Vec<LocalDefId>> {
+    let tcx = db.tcx();
+    let all_items = tcx.hir().items().map(|item_id| item_id.owner_id.def_id);
+    let Some(emit_items) = db.emit_items() else {
+        return Ok(all_items.collect());
+    };
+
+    let mut found_paths = HashSet::new();
+    let mut worklist = vec![];
+    for def_id in all_items {
+        let path = tcx.def_path_str(def_id.to_def_id());
+        if emit_items.contains(path.as_str()) {
+            found_paths.insert(path);
+            worklist.push(def_id);
+        }
+    }
+    if let Some(missing) = emit_items.iter().find(|path| !found_paths.contains(path.as_ref())) {
+        bail!("`--emit-item={missing}` doesn't name an item of the crate");
+    }
+
+    let mut items: HashSet<LocalDefId> = worklist.iter().copied().collect();
+    while let Some(def_id) = worklist.pop() {
+        let Ok(Some(api_snippets)) = db.format_item(def_id) else {
+            continue;
+        };
+        for prereqs in [&api_snippets.main_api.prereqs, &api_snippets.cc_details.prereqs] {
+            for &dep in prereqs.defs.iter().chain(prereqs.fwd_decls.iter()) {
+                if items.insert(dep) {
+                    worklist.push(dep);
+                }
+            }
+        }
+    }
+    Ok(tcx
+        .hir()
+        .items()
+        .map(|item_id| item_id.owner_id.def_id)
+        .filter(|def_id| items.contains(def_id))
+        .collect())
+}
+
 /// Formats all public items from the Rust crate being compiled.
 fn format_crate(db: &Database) -> Result<Output> {
     let tcx = db.tcx();
-    let mut cc_details_prereqs = CcPrerequisites::default();
-    let mut cc_details: Vec<(LocalDefId, TokenStream)> = vec![];
     let mut rs_body = TokenStream::default();
-    let mut main_apis = HashMap::<LocalDefId, CcSnippet>::new();
-    let formatted_items = tcx
-        .hir()
-        .items()
-        .filter_map(|item_id| {
-            let def_id: LocalDefId = item_id.owner_id.def_id;
+    let mut cc_items: Vec<(LocalDefId, CcSnippet, CcSnippet)> = vec![];
+    let items = items_to_emit(db)?;
+    let formatted_items = items
+        .iter()
+        .filter_map(|&def_id| {
             db.format_item(def_id)
                 .unwrap_or_else(|err| Some(format_unsupported_def(db, def_id, err)))
                 .map(|api_snippets| (def_id, api_snippets))
         })
         .sorted_by_key(|(def_id, _)| tcx.def_span(*def_id));
     for (def_id, api_snippets) in formatted_items {
-        let old_item = main_apis.insert(def_id, api_snippets.main_api);
-        assert!(old_item.is_none(), "Duplicated key: {def_id:?}");
-
-        // `cc_details` don't participate in the toposort, because
-        // `CcPrerequisites::defs` always use `main_api` as the predecessor
-        // - `chain`ing `cc_details` after `ordered_main_apis` trivially
-        // meets the prerequisites.
-        cc_details.push((def_id, api_snippets.cc_details.into_tokens(&mut cc_details_prereqs)));
+        cc_items.push((def_id, api_snippets.main_api, api_snippets.cc_details));
         rs_body.extend(api_snippets.rs_details);
     }
 
-    // Find the order of `main_apis` that 1) meets the requirements of
-    // `CcPrerequisites::defs` and 2) makes a best effort attempt to keep the
-    // `main_apis` in the same order as the source order of the Rust APIs.
-    let ordered_ids = {
-        let toposort::TopoSortResult { ordered: ordered_ids, failed: failed_ids } = {
-            let nodes = main_apis.keys().copied();
-            let deps = main_apis.iter().flat_map(|(&successor, main_api)| {
-                let predecessors = main_api.prereqs.defs.iter().copied();
-                predecessors.map(move |predecessor| toposort::Dependency { predecessor, successor })
-            });
-            toposort::toposort(nodes, deps, move |lhs_id, rhs_id| {
-                tcx.def_span(*lhs_id).cmp(&tcx.def_span(*rhs_id))
-            })
+    let h_fwd_body =
+        format_cc_header_body(db, &BTreeSet::new(), quote! {}, format_crate_fwd_decls(db, &items))?;
+
+    if db.h_out_modules_include_prefix().is_some() {
+        match split_cc_items_by_module(db, cc_items) {
+            Ok((h_body, h_modules)) => {
+                return Ok(Output { h_body, rs_body, h_modules, h_fwd_body });
+            }
+            // The modules depend on each other cyclically, so the header can't be split.
+            Err(unsplit_cc_items) => cc_items = unsplit_cc_items,
+        }
+    }
+    let (includes, extern_fwd_decls, ordered_cc) = format_cc_items(db, cc_items);
+    let h_body = format_cc_header_body(db, &includes, extern_fwd_decls, ordered_cc)?;
+    Ok(Output { h_body, rs_body, h_modules: vec![], h_fwd_body })
+}
+
+/// Formats the forward declarations of the structs, enums and unions among
+/// `items` that have C++ bindings, for `format_cc_header_body`.  This allows
+/// C++ code that only uses these types through pointers or references to avoid
+/// including the (bigger) header with their definitions.
+fn format_crate_fwd_decls(
+    db: &Database,
+    items: &[LocalDefId],
+) -> Vec<(Option<DefId>, NamespaceQualifier, TokenStream)> {
+    let tcx = db.tcx();
+    items
+        .iter()
+        .copied()
+        .filter(|&def_id| {
+            matches!(tcx.def_kind(def_id), DefKind::Struct | DefKind::Enum | DefKind::Union)
+                && matches!(db.format_item(def_id), Ok(Some(_)))
+        })
+        .sorted_by_key(|&def_id| tcx.def_span(def_id))
+        .map(|def_id| {
+            let ns_def_id = tcx.opt_parent(def_id.to_def_id());
+            let mod_path = FullyQualifiedName::new(db, def_id.to_def_id()).cpp_ns_path;
+            (ns_def_id, mod_path, format_fwd_decl(db, def_id))
+        })
+        .collect_vec()
+}
+
+/// Orders the C++ bindings of `cc_items` (tuples of the `LocalDefId`, the
+/// `ApiSnippets::main_api` and the `ApiSnippets::cc_details` of an item, in
+/// source order) for `format_namespace_bound_cc_tokens`, and returns them
+/// together with the `#include`s and the forward declarations of the items
+/// from other crates (see `format_extern_fwd_decls`) that they need.
+///
+/// `CcPrerequisites::defs` that are not in `cc_items` are assumed to be
+/// provided by an `#include` instead.
+fn format_cc_items(
+    db: &Database,
+    cc_items: Vec<(LocalDefId, CcSnippet, CcSnippet)>,
+) -> (BTreeSet<CcInclude>, TokenStream, Vec<(Option<DefId>, NamespaceQualifier, TokenStream)>) {
+    let tcx = db.tcx();
+    let mut cc_details_prereqs = CcPrerequisites::default();
+    let mut cc_details: Vec<(LocalDefId, TokenStream)> = vec![];
+    let mut main_apis = HashMap::<LocalDefId, CcSnippet>::new();
+    let mut main_api_ids = Vec::<LocalDefId>::with_capacity(cc_items.len());
+    for (def_id, main_api, item_cc_details) in cc_items {
+        main_api_ids.push(def_id);
+        let old_item = main_apis.insert(def_id, main_api);
+        assert!(old_item.is_none(), "Duplicated key: {def_id:?}");
+
+        // `cc_details` don't participate in the toposort, because
+        // `CcPrerequisites::defs` always use `main_api` as the predecessor
+        // - `chain`ing `cc_details` after `ordered_main_apis` trivially
+        // meets the prerequisites.
+        cc_details.push((def_id, item_cc_details.into_tokens(&mut cc_details_prereqs)));
+    }
+
+    // Find the order of `main_apis` that 1) meets the requirements of
+    // `CcPrerequisites::defs` and 2) makes a best effort attempt to keep the
+    // `main_apis` in the same order as the source order of the Rust APIs.
+    let ordered_ids = {
+        let toposort::TopoSortResult { ordered: ordered_ids, failed: failed_ids } = {
+            let main_apis = &main_apis;
+            // Iterating over `main_api_ids` (rather than over the keys of the `main_apis`
+            // hash map) keeps the order of items with the same span deterministic.
+            let nodes = main_api_ids;
+            let deps = nodes
+                .iter()
+                .map(|id| (*id, &main_apis[id]))
+                .flat_map(move |(successor, main_api)| {
+                    let predecessors = main_api
+                        .prereqs
+                        .defs
+                        .iter()
+                        .copied()
+                        .filter(move |predecessor| main_apis.contains_key(predecessor));
+                    predecessors
+                        .map(move |predecessor| toposort::Dependency { predecessor, successor })
+                })
+                .collect_vec();
+            toposort::toposort_by_cached_key(nodes, deps, |id| tcx.def_span(*id))
         };
         assert_eq!(
             0,
@@ -4559,69 +6104,199 @@ fn format_crate(db: &Database) -> Result<Output> {
 
     // Destructure/rebuild `main_apis` (in the same order as `ordered_ids`) into
     // `includes`, and `ordered_cc` (mixing in `fwd_decls` and `cc_details`).
-    let (includes, ordered_cc) = {
-        let mut already_declared = HashSet::new();
-        let mut fwd_decls = HashSet::new();
-        let mut includes = cc_details_prereqs.includes;
-        let mut ordered_main_apis: Vec<(LocalDefId, TokenStream)> = Vec::new();
-        for def_id in ordered_ids.into_iter() {
-            let CcSnippet {
-                tokens: cc_tokens,
-                prereqs: CcPrerequisites {
-                    includes: mut inner_includes,
-                    fwd_decls: inner_fwd_decls,
-                    .. // `defs` have already been utilized by `toposort` above
-                }
-            } = main_apis.remove(&def_id).unwrap();
-
-            fwd_decls.extend(inner_fwd_decls.difference(&already_declared).copied());
-            already_declared.insert(def_id);
-            already_declared.extend(inner_fwd_decls.into_iter());
-
-            includes.append(&mut inner_includes);
-            ordered_main_apis.push((def_id, cc_tokens));
-        }
-
-        let fwd_decls = fwd_decls
-            .into_iter()
-            .sorted_by_key(|def_id| tcx.def_span(*def_id))
-            .map(|local_def_id| (local_def_id, format_fwd_decl(db, local_def_id)));
-
-        // The first item of the tuple here is the DefId of the namespace.
-        let ordered_cc: Vec<(Option<DefId>, NamespaceQualifier, TokenStream)> = fwd_decls
-            .into_iter()
-            .chain(ordered_main_apis)
-            .chain(cc_details)
-            .map(|(local_def_id, tokens)| {
-                let ns_def_id = tcx.opt_parent(local_def_id.to_def_id());
-                let mod_path = FullyQualifiedName::new(db, local_def_id.to_def_id()).cpp_ns_path;
-                (ns_def_id, mod_path, tokens)
-            })
-            .collect_vec();
+    let mut already_declared = HashSet::new();
+    let mut fwd_decls = HashSet::new();
+    let mut includes = cc_details_prereqs.includes;
+    let mut extern_defs = cc_details_prereqs.extern_defs;
+    let mut extern_fwd_decls = cc_details_prereqs.extern_fwd_decls;
+    let mut ordered_main_apis: Vec<(LocalDefId, TokenStream)> = Vec::new();
+    for def_id in ordered_ids.into_iter() {
+        let CcSnippet {
+            tokens: cc_tokens,
+            prereqs: CcPrerequisites {
+                includes: mut inner_includes,
+                fwd_decls: inner_fwd_decls,
+                extern_defs: inner_extern_defs,
+                extern_fwd_decls: inner_extern_fwd_decls,
+                .. // `defs` have already been utilized by `toposort` above
+            }
+        } = main_apis.remove(&def_id).unwrap();
+
+        fwd_decls.extend(inner_fwd_decls.difference(&already_declared).copied());
+        already_declared.insert(def_id);
+        already_declared.extend(inner_fwd_decls.into_iter());
+
+        includes.append(&mut inner_includes);
+        extern_defs.extend(inner_extern_defs);
+        extern_fwd_decls.extend(inner_extern_fwd_decls);
+        ordered_main_apis.push((def_id, cc_tokens));
+    }
+
+    // The headers of other crates are only included if a definition from the
+    // crate is needed.  Otherwise the items of other crates are
+    // forward-declared.
+    let crate_name_to_include_paths = db.crate_name_to_include_paths();
+    for def_id in &extern_defs {
+        // `format_ty_for_cc` has already verified that the crate has a header.
+        if let Some(crate_includes) =
+            crate_name_to_include_paths.get(tcx.crate_name(def_id.krate).as_str())
+        {
+            includes.extend(crate_includes.iter().cloned());
+        }
+    }
+    extern_fwd_decls.retain(|def_id| !extern_defs.contains(def_id));
+    let extern_fwd_decls = format_extern_fwd_decls(db, extern_fwd_decls);
 
-        (includes, ordered_cc)
-    };
+    let fwd_decls = fwd_decls
+        .into_iter()
+        .sorted_by_key(|def_id| tcx.def_span(*def_id))
+        .map(|local_def_id| (local_def_id, format_fwd_decl(db, local_def_id)));
+
+    // The first item of the tuple here is the DefId of the namespace.
+    let ordered_cc: Vec<(Option<DefId>, NamespaceQualifier, TokenStream)> = fwd_decls
+        .into_iter()
+        .chain(ordered_main_apis)
+        .chain(cc_details)
+        .map(|(local_def_id, tokens)| {
+            let ns_def_id = tcx.opt_parent(local_def_id.to_def_id());
+            let mod_path = FullyQualifiedName::new(db, local_def_id.to_def_id()).cpp_ns_path;
+            (ns_def_id, mod_path, tokens)
+        })
+        .collect_vec();
 
-    // Generate top-level elements of the C++ header file.
-    let h_body = {
-        let cpp_top_level_ns = top_level_ns_for_crate(db, LOCAL_CRATE);
-        let cpp_top_level_ns = format_cc_ident(db, cpp_top_level_ns.as_str())?;
+    (includes, extern_fwd_decls, ordered_cc)
+}
 
-        let includes = format_cc_includes(&includes);
-        let ordered_cc = format_namespace_bound_cc_tokens(db, ordered_cc, tcx);
-        quote! {
-            #includes
-            __NEWLINE__ __NEWLINE__
-            namespace #cpp_top_level_ns {
-                __NEWLINE__
-                #ordered_cc
-                __NEWLINE__
-            }
+/// Generates the top-level elements of a C++ header file with the
+/// `includes`, the `extern_fwd_decls` and the `ordered_cc` returned by
+/// `format_cc_items`.
+fn format_cc_header_body(
+    db: &Database,
+    includes: &BTreeSet<CcInclude>,
+    extern_fwd_decls: TokenStream,
+    ordered_cc: Vec<(Option<DefId>, NamespaceQualifier, TokenStream)>,
+) -> Result<TokenStream> {
+    let cpp_top_level_ns = top_level_ns_for_crate(db, LOCAL_CRATE);
+    let cpp_top_level_ns = format_cc_ident(db, cpp_top_level_ns.as_str())?;
+
+    let includes = format_cc_includes(includes);
+    let ordered_cc = format_namespace_bound_cc_tokens(db, ordered_cc, db.tcx());
+    Ok(quote! {
+        #includes
+        __NEWLINE__ __NEWLINE__
+        #extern_fwd_decls
+        namespace #cpp_top_level_ns {
+            __NEWLINE__
+            #ordered_cc
             __NEWLINE__
         }
+        __NEWLINE__
+    })
+}
+
+/// The name of the header (without the `.h` extension) that contains the C++
+/// bindings of the items directly in the crate root, when the bindings are
+/// split by module (see `Output::h_modules`). No module can have this name,
+/// because `crate` is a keyword.
+const CRATE_ROOT_HEADER_NAME: &str = "crate";
+
+/// Returns the name of the top-level module of the crate that contains
+/// `def_id`, or `None` if `def_id` is directly in the crate root.
+fn top_level_module_name(tcx: TyCtxt, def_id: LocalDefId) -> Option<Symbol> {
+    let mut module = tcx.parent_module_from_def_id(def_id).to_local_def_id();
+    if module == CRATE_DEF_ID {
+        return None;
+    }
+    while let Some(parent) = tcx.opt_local_parent(module) {
+        if parent == CRATE_DEF_ID {
+            break;
+        }
+        module = parent;
+    }
+    Some(tcx.item_name(module.to_def_id()))
+}
+
+/// Splits the C++ bindings of `cc_items` (see `format_cc_items`) into one
+/// header per top-level module of the crate, and returns the body of the main
+/// header, which includes all of them, along with `Output::h_modules`.
+///
+/// Every module header includes the headers of the modules whose definitions
+/// it depends on. If the modules depend on each other cyclically, then
+/// `cc_items` are returned as an error, and the bindings have to go into a
+/// single header.
+fn split_cc_items_by_module(
+    db: &Database,
+    cc_items: Vec<(LocalDefId, CcSnippet, CcSnippet)>,
+) -> Result<(TokenStream, Vec<(String, TokenStream)>), Vec<(LocalDefId, CcSnippet, CcSnippet)>> {
+    let tcx = db.tcx();
+    let header_name = |module: Option<Symbol>| match module {
+        Some(module) => module.to_string(),
+        None => CRATE_ROOT_HEADER_NAME.to_string(),
     };
 
-    Ok(Output { h_body, rs_body })
+    // The modules in the order of their first item, and their dependencies.
+    let mut modules: Vec<Option<Symbol>> = vec![];
+    let mut module_deps: HashSet<(Option<Symbol>, Option<Symbol>)> = HashSet::new();
+    for (def_id, main_api, cc_details) in &cc_items {
+        let module = top_level_module_name(tcx, *def_id);
+        if !modules.contains(&module) {
+            modules.push(module);
+        }
+        for predecessor in main_api.prereqs.defs.iter().chain(&cc_details.prereqs.defs) {
+            let predecessor_module = top_level_module_name(tcx, *predecessor);
+            if predecessor_module != module {
+                module_deps.insert((predecessor_module, module));
+            }
+        }
+    }
+    let toposort::TopoSortResult { ordered: ordered_modules, failed } = toposort::toposort(
+        modules.iter().copied(),
+        module_deps
+            .iter()
+            .map(|&(predecessor, successor)| toposort::Dependency { predecessor, successor }),
+        // `modules` are already in the preferred order (and `toposort` uses a stable sort).
+        |_, _| std::cmp::Ordering::Equal,
+    );
+    if !failed.is_empty() {
+        return Err(cc_items);
+    }
+
+    let mut items_by_module: HashMap<Option<Symbol>, Vec<_>> = HashMap::new();
+    for cc_item in cc_items {
+        items_by_module.entry(top_level_module_name(tcx, cc_item.0)).or_default().push(cc_item);
+    }
+    let h_modules = ordered_modules
+        .iter()
+        .map(|&module| {
+            let (mut includes, extern_fwd_decls, ordered_cc) =
+                format_cc_items(db, items_by_module.remove(&module).unwrap());
+            // The module headers are all in the same directory, so they include
+            // each other relative to the including file.
+            for &(predecessor, successor) in &module_deps {
+                if successor == module {
+                    includes.insert(CcInclude::user_header(
+                        format!("{}.h", header_name(predecessor)).into(),
+                    ));
+                }
+            }
+            let h_body = format_cc_header_body(db, &includes, extern_fwd_decls, ordered_cc)
+                .unwrap_or_else(|err| {
+                    let txt = format!("Failed to generate bindings for the module: {err}");
+                    quote! { __COMMENT__ #txt }
+                });
+            (header_name(module), h_body)
+        })
+        .collect_vec();
+
+    let include_prefix = db.h_out_modules_include_prefix().unwrap();
+    let includes = ordered_modules
+        .iter()
+        .map(|&module| {
+            CcInclude::user_header(format!("{include_prefix}/{}.h", header_name(module)).into())
+        })
+        .collect::<BTreeSet<_>>();
+    let includes = format_cc_includes(&includes);
+    Ok((quote! { #includes __NEWLINE__ }, h_modules))
 }
 
 #[cfg(test)]
@@ -4693,6 +6368,201 @@ pub mod tests {
         });
     }
 
+    /// Tests that with `h_out_modules_include_prefix`, the bindings of every
+    /// top-level module go into a separate header, which includes the headers
+    /// of the modules that it depends on.
+    #[test]
+    fn test_generated_bindings_split_by_module() {
+        let test_src = r#"
+                pub mod inner {
+                    pub struct Inner(pub bool);
+                }
+                pub mod outer {
+                    pub struct Outer(pub crate::inner::Inner);
+                }
+            "#;
+        run_compiler_for_testing(test_src, |tcx| {
+            let db = Database::new(
+                tcx,
+                /* crubit_support_path_format= */
+                "<crubit/support/for/tests/{header}>".into(),
+                /* default_features= */ Default::default(),
+                /* crate_name_to_include_paths= */ Default::default(),
+                /* crate_name_to_features= */
+                Rc::new(HashMap::from([(
+                    Rc::from("self"),
+                    crubit_feature::CrubitFeature::Experimental
+                        | crubit_feature::CrubitFeature::Supported,
+                )])),
+                /* crate_name_to_namespace= */ HashMap::default().into(),
+                /* errors = */ Rc::new(IgnoreErrors),
+                /* no_thunk_name_mangling= */ true,
+                /* include_guard */ IncludeGuard::PragmaOnce,
+                /* h_out_modules_include_prefix= */ Some("rust_out_modules".into()),
+                /* inline_trivial_functions= */ false,
+                /* prune_crate_header_includes= */ false,
+                /* return_values_in_place= */ false,
+                /* emit_items= */ None,
+            );
+            let bindings = generate_bindings(&db).unwrap();
+            assert_cc_matches!(
+                bindings.h_body,
+                quote! {
+                    __HASH_TOKEN__ include "rust_out_modules/inner.h"
+                    __HASH_TOKEN__ include "rust_out_modules/outer.h"
+                }
+            );
+            assert_cc_not_matches!(bindings.h_body, quote! { Inner });
+
+            let h_modules: HashMap<String, TokenStream> = bindings.h_modules.into_iter().collect();
+            assert_cc_matches!(
+                h_modules["inner"],
+                quote! {
+                    namespace rust_out {
+                        namespace inner {
+                            ...
+                            struct CRUBIT_INTERNAL_RUST_TYPE(...) alignas(1) [[clang::trivial_abi]] Inner final { ... }
+                            ...
+                        }
+                    }
+                }
+            );
+            assert_cc_not_matches!(h_modules["inner"], quote! { Outer });
+            assert_cc_matches!(h_modules["outer"], quote! { __HASH_TOKEN__ include "inner.h" });
+            assert_cc_matches!(
+                h_modules["outer"],
+                quote! {
+                    namespace rust_out {
+                        namespace outer {
+                            ...
+                            struct CRUBIT_INTERNAL_RUST_TYPE(...) alignas(1) [[clang::trivial_abi]] Outer final { ... }
+                            ...
+                        }
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_generated_bindings_emit_items() {
+        let test_src = r#"
+                pub struct Used(pub i32);
+                pub struct UsedThroughPointer(pub i32);
+                pub struct Unused(pub i32);
+                pub fn requested(_x: Used, _y: *const UsedThroughPointer) {}
+                pub fn not_requested() {}
+            "#;
+        run_compiler_for_testing(test_src, |tcx| {
+            let db = Database::new(
+                tcx,
+                /* crubit_support_path_format= */
+                "<crubit/support/for/tests/{header}>".into(),
+                /* default_features= */ Default::default(),
+                /* crate_name_to_include_paths= */ Default::default(),
+                /* crate_name_to_features= */
+                Rc::new(HashMap::from([(
+                    Rc::from("self"),
+                    crubit_feature::CrubitFeature::Experimental
+                        | crubit_feature::CrubitFeature::Supported,
+                )])),
+                /* crate_name_to_namespace= */ HashMap::default().into(),
+                /* errors = */ Rc::new(IgnoreErrors),
+                /* no_thunk_name_mangling= */ true,
+                /* include_guard */ IncludeGuard::PragmaOnce,
+                /* h_out_modules_include_prefix= */ None,
+                /* inline_trivial_functions= */ false,
+                /* prune_crate_header_includes= */ false,
+                /* return_values_in_place= */ false,
+                /* emit_items= */ Some(Rc::new(HashSet::from([Rc::from("requested")]))),
+            );
+            let bindings = generate_bindings(&db).unwrap();
+            assert_cc_matches!(bindings.h_body, quote! { void requested(...) });
+            assert_cc_matches!(bindings.h_body, quote! { struct ... Used final { ... } });
+            assert_cc_matches!(
+                bindings.h_body,
+                quote! { struct ... UsedThroughPointer final { ... } }
+            );
+            assert_cc_not_matches!(bindings.h_body, quote! { Unused });
+            assert_cc_not_matches!(bindings.h_body, quote! { not_requested });
+            assert_rs_not_matches!(bindings.rs_body, quote! { Unused });
+            assert_cc_not_matches!(bindings.h_fwd_body, quote! { Unused });
+        });
+    }
+
+    #[test]
+    fn test_generated_bindings_emit_items_missing() {
+        let test_src = r#"
+                pub fn requested() {}
+            "#;
+        run_compiler_for_testing(test_src, |tcx| {
+            let db = Database::new(
+                tcx,
+                /* crubit_support_path_format= */
+                "<crubit/support/for/tests/{header}>".into(),
+                /* default_features= */ Default::default(),
+                /* crate_name_to_include_paths= */ Default::default(),
+                /* crate_name_to_features= */ Default::default(),
+                /* crate_name_to_namespace= */ HashMap::default().into(),
+                /* errors = */ Rc::new(IgnoreErrors),
+                /* no_thunk_name_mangling= */ true,
+                /* include_guard */ IncludeGuard::PragmaOnce,
+                /* h_out_modules_include_prefix= */ None,
+                /* inline_trivial_functions= */ false,
+                /* prune_crate_header_includes= */ false,
+                /* return_values_in_place= */ false,
+                /* emit_items= */ Some(Rc::new(HashSet::from([Rc::from("no_such_item")]))),
+            );
+            let err = format_crate(&db).err().unwrap();
+            assert_eq!(
+                format!("{err:#}"),
+                "`--emit-item=no_such_item` doesn't name an item of the crate"
+            );
+        });
+    }
+
+    #[test]
+    fn test_module_include_guard() {
+        assert_eq!(module_include_guard("GUARD", "inner_mod"), "GUARD_MOD_inner0_mod");
+        let guards = ["fwd", "FWD", "Foo", "foo", "_foo", "a0_b", "a_0b", "a__b", "crate"]
+            .map(|name| module_include_guard("GUARD", name));
+        assert_eq!(guards.iter().collect::<HashSet<_>>().len(), guards.len(), "{guards:?}");
+        assert!(!guards.contains(&"GUARD_FWD".to_string()));
+        assert!(guards.iter().all(|guard| !guard.contains("__")), "{guards:?}");
+    }
+
+    /// Tests that `Output::h_fwd_body` forward-declares the ADTs of the crate
+    /// (and nothing else).
+    #[test]
+    fn test_generated_bindings_fwd_decls_header() {
+        let test_src = r#"
+                pub struct Point {
+                    pub x: i32,
+                }
+                pub mod inner {
+                    pub enum Color { Red }
+                }
+                pub fn get_x(p: &crate::Point) -> i32 { p.x }
+            "#;
+        test_generated_bindings(test_src, |bindings| {
+            let bindings = bindings.unwrap();
+            assert_cc_matches!(
+                bindings.h_fwd_body,
+                quote! {
+                    __HASH_TOKEN__ pragma once
+                    namespace rust_out {
+                        struct Point;
+                        namespace inner {
+                            struct Color;
+                        }
+                    }
+                }
+            );
+            assert_cc_not_matches!(bindings.h_fwd_body, quote! { get_x });
+            assert_cc_not_matches!(bindings.h_fwd_body, quote! { __HASH_TOKEN__ include });
+        });
+    }
+
     /// The `test_generated_bindings_struct` test covers only a single example
     /// of an ADT (struct/enum/union) that should get a C++ binding.
     /// Additional coverage of how items are formatted is provided by
@@ -5396,7 +7266,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr bool BOOL_TRUE = true;
+                    inline constexpr bool BOOL_TRUE = true;
                 }
             );
         });
@@ -5406,7 +7276,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr bool BOOL_FALSE = false;
+                    inline constexpr bool BOOL_FALSE = false;
                 }
             );
         });
@@ -5416,7 +7286,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::int32_t INT_POS = 42;
+                    inline constexpr std::int32_t INT_POS = 42;
                 }
             );
         });
@@ -5426,7 +7296,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::int64_t LARGE_INT = 9223372036854775807;
+                    inline constexpr std::int64_t LARGE_INT = 9223372036854775807;
                 }
             );
         });
@@ -5436,7 +7306,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::uint32_t UNSIGNED_INT = 4294967295;
+                    inline constexpr std::uint32_t UNSIGNED_INT = 4294967295;
                 }
             );
         });
@@ -5446,7 +7316,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::int32_t INT_NEG = -17;
+                    inline constexpr std::int32_t INT_NEG = -17;
                 }
             );
         });
@@ -5456,7 +7326,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr float FLOAT_32 = 0.125;
+                    inline constexpr float FLOAT_32 = 0.125;
                 }
             );
         });
@@ -5466,7 +7336,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr double FLOAT_64 = 0.0078125;
+                    inline constexpr double FLOAT_64 = 0.0078125;
                 }
             );
         });
@@ -5477,7 +7347,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::uintptr_t SLICE_LENGTH = 11;
+                    inline constexpr std::uintptr_t SLICE_LENGTH = 11;
                 }
             );
         });
@@ -5487,7 +7357,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::intptr_t ISIZE = 42;
+                    inline constexpr std::intptr_t ISIZE = 42;
                 }
             );
         });
@@ -5497,7 +7367,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr char CHAR = 42;
+                    inline constexpr char CHAR = 42;
                 }
             );
         });
@@ -5511,7 +7381,7 @@ pub mod tests {
             assert_cc_matches!(
                 result.main_api.tokens,
                 quote! {
-                    constexpr std::uint32_t reinterpret_cast_ = 42;
+                    inline constexpr std::uint32_t reinterpret_cast_ = 42;
                 }
             );
         });
@@ -6708,6 +8578,315 @@ pub mod tests {
         });
     }
 
+    #[test]
+    fn test_format_item_slice_and_str_references() {
+        let test_src = r#"
+                pub fn foo<'a>(_a: &'a [u32], _b: &'a mut [i16], _c: &'a str) -> &'a str {
+                    todo!()
+                }
+            "#;
+        test_format_item(test_src, "foo", |result| {
+            let result = result.unwrap().unwrap();
+            let main_api = &result.main_api;
+            assert_cc_matches!(
+                main_api.tokens,
+                quote! {
+                  rs_std::StrRef
+                  foo(
+                    rs_std::SliceRef<const std::uint32_t> _a,
+                    rs_std::SliceRef<std::int16_t> _b,
+                    rs_std::StrRef _c
+                  );
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" rs_std::StrRef ...(
+                            rs_std::SliceRef<const std::uint32_t>,
+                            rs_std::SliceRef<std::int16_t>,
+                            rs_std::StrRef);
+                    }
+                    inline rs_std::StrRef foo(
+                            rs_std::SliceRef<const std::uint32_t> _a,
+                            rs_std::SliceRef<std::int16_t> _b,
+                            rs_std::StrRef _c) {
+                        return __crubit_internal::...(_a, _b, _c);
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...<'a>(
+                        _a: &'a [u32],
+                        _b: &'a mut [i16],
+                        _c: &'a str
+                    ) -> &'a str {
+                        ::rust_out::foo(_a, _b, _c)
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_optional_references_and_non_null() {
+        let test_src = r#"
+                use std::ptr::NonNull;
+                pub fn foo(_a: Option<&i32>, _b: Option<NonNull<u8>>) -> Option<NonNull<u8>> {
+                    todo!()
+                }
+            "#;
+        test_format_item(test_src, "foo", |result| {
+            let result = result.unwrap().unwrap();
+            let main_api = &result.main_api;
+            assert_cc_matches!(
+                main_api.tokens,
+                quote! {
+                  std::uint8_t* foo(
+                    std::int32_t const* [[clang::annotate_type("lifetime", "__anon1")]] _a,
+                    std::uint8_t* _b
+                  );
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" std::uint8_t* ...(
+                            std::int32_t const* [[clang::annotate_type("lifetime", "__anon1")]],
+                            std::uint8_t*);
+                    }
+                    inline std::uint8_t* foo(
+                            std::int32_t const* [[clang::annotate_type("lifetime", "__anon1")]] _a,
+                            std::uint8_t* _b) {
+                        return __crubit_internal::...(_a, _b);
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...<'__anon1>(
+                        _a: ::core::option::Option<&'__anon1 i32>,
+                        _b: ::core::option::Option<::core::ptr::NonNull<u8> >
+                    ) -> ::core::option::Option<::core::ptr::NonNull<u8> > {
+                        ::rust_out::foo(_a, _b)
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_mut_str_reference() {
+        let test_src = r#"
+                pub fn foo(_s: &mut str) {}
+            "#;
+        test_format_item(test_src, "foo", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error handling parameter #0: \
+                 Can't format `&'__anon1 mut str`, because `&mut str` is not supported"
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_returning_owned_buffers() {
+        let test_src = r#"
+                pub fn get_string() -> String { todo!() }
+                pub fn get_bytes() -> Vec<u8> { todo!() }
+            "#;
+        test_format_item(test_src, "get_string", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    rs_std::OwnedStr get_string();
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" void ...(rs_std::OwnedStr* __ret_ptr);
+                    }
+                    inline rs_std::OwnedStr get_string() {
+                        crubit::ReturnValueSlot<rs_std::OwnedStr> __ret_slot;
+                        __crubit_internal::...(__ret_slot.Get());
+                        return std::move(__ret_slot).AssumeInitAndTakeValue();
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...(__ret_ptr: *mut ::core::ffi::c_void) -> () {
+                        ...
+                        extern "C" fn __crubit_drop(
+                            data: *mut ::core::ffi::c_void,
+                            size: usize,
+                            capacity: usize,
+                        ) {
+                            ::core::mem::drop(unsafe {
+                                <::std::string::String>::from_raw_parts(
+                                    data as *mut _, size, capacity)
+                            });
+                        }
+                        let mut __rs_val =
+                            ::core::mem::ManuallyDrop::new({ ::rust_out::get_string() });
+                        ...
+                    }
+                }
+            );
+        });
+        test_format_item(test_src, "get_bytes", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    rs_std::OwnedSlice<std::uint8_t> get_bytes();
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    <::std::vec::Vec<u8> >::from_raw_parts(data as *mut _, size, capacity)
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_unsupported_owned_buffers() {
+        let test_src = r#"
+                pub fn take_string(_s: String) {}
+                pub fn get_strings() -> Vec<String> { todo!() }
+                pub fn get_refs() -> Vec<&'static i32> { todo!() }
+            "#;
+        test_format_item(test_src, "take_string", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error handling parameter #0: Can't format `std::string::String`, because \
+                 owned buffers are only supported in function return types"
+            );
+        });
+        test_format_item(test_src, "get_strings", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error formatting function return type: Elements of an owned buffer can't \
+                 have drop glue, but `std::string::String` does"
+            );
+        });
+        test_format_item(test_src, "get_refs", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error formatting function return type: Elements of an owned buffer can't \
+                 have lifetimes, but `&'static i32` does"
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_returning_boxed_iterator() {
+        let test_src = r#"
+                pub fn get_numbers() -> Box<dyn Iterator<Item = i32>> { todo!() }
+            "#;
+        test_format_item(test_src, "get_numbers", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    rs_std::BoxedIterator<std::int32_t> get_numbers();
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" void ...(rs_std::BoxedIterator<std::int32_t>* __ret_ptr);
+                    }
+                    inline rs_std::BoxedIterator<std::int32_t> get_numbers() {
+                        crubit::ReturnValueSlot<rs_std::BoxedIterator<std::int32_t>> __ret_slot;
+                        __crubit_internal::...(__ret_slot.Get());
+                        return std::move(__ret_slot).AssumeInitAndTakeValue();
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...(__ret_ptr: *mut ::core::ffi::c_void) -> () {
+                        ...
+                        extern "C" fn __crubit_next_batch(
+                            state: *mut ::core::ffi::c_void,
+                            out: *mut ::core::ffi::c_void,
+                            capacity: usize,
+                        ) -> usize {
+                            let iter = unsafe {
+                                &mut *(state as *mut ::std::boxed::Box<
+                                    dyn ::core::iter::Iterator<Item = i32> >)
+                            };
+                            let out = out as *mut i32;
+                            ...
+                        }
+                        ...
+                        let __rs_val: ::std::boxed::Box<dyn ::core::iter::Iterator<Item = i32> > =
+                            { ::rust_out::get_numbers() };
+                        ...
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_unsupported_boxed_iterators() {
+        let test_src = r#"
+                pub fn take_numbers(_i: Box<dyn Iterator<Item = i32>>) {}
+                pub fn get_strings() -> Box<dyn Iterator<Item = String>> { todo!() }
+                pub fn count_from(_n: &mut i32) -> Box<dyn Iterator<Item = i32> + '_> {
+                    todo!()
+                }
+            "#;
+        test_format_item(test_src, "take_numbers", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error handling parameter #0: Can't format \
+                 `std::boxed::Box<dyn std::iter::Iterator<Item = i32>>`, because boxed \
+                 iterators are only supported in function return types"
+            );
+        });
+        test_format_item(test_src, "get_strings", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error formatting function return type: Items of a boxed iterator can't \
+                 have drop glue, but `std::string::String` does"
+            );
+        });
+        test_format_item(test_src, "count_from", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error formatting function return type: Boxed iterators that borrow their \
+                 arguments (or capture other lifetimes) are not supported"
+            );
+        });
+    }
+
     /// Test of lifetime-generic function with a `where` clause.
     ///
     /// The `where` constraint below is a bit silly (why not just use `'static`
@@ -6805,17 +8984,237 @@ pub mod tests {
     }
 
     #[test]
-    fn test_format_item_unsupported_fn_async() {
+    fn test_format_item_fn_async() {
+        let test_src = r#"
+                pub async fn add_one(x: i32) -> i32 { x + 1 }
+            "#;
+        test_format_item(test_src, "add_one", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    rs_std::BoxedFuture<std::int32_t> add_one(std::int32_t x);
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" void ...(std::int32_t, rs_std::BoxedFuture<std::int32_t>* __ret_ptr);
+                    }
+                    inline rs_std::BoxedFuture<std::int32_t> add_one(std::int32_t x) {
+                        crubit::ReturnValueSlot<rs_std::BoxedFuture<std::int32_t>> __ret_slot;
+                        __crubit_internal::...(x, __ret_slot.Get());
+                        return std::move(__ret_slot).AssumeInitAndTakeValue();
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...(x: i32, __ret_ptr: *mut ::core::ffi::c_void) -> () {
+                        ...
+                        extern "C" fn __crubit_poll(
+                            state: *mut ::core::ffi::c_void,
+                            out: *mut ::core::ffi::c_void,
+                            wake: extern "C" fn(*mut ::core::ffi::c_void),
+                            release: extern "C" fn(*mut ::core::ffi::c_void),
+                            context: *mut ::core::ffi::c_void,
+                        ) -> bool {
+                            let future = unsafe {
+                                &mut *(state as *mut ::core::pin::Pin<
+                                    ::std::boxed::Box<dyn ::core::future::Future<Output = i32> >
+                                >)
+                            };
+                            ...
+                            let done = match future.as_mut().poll(&mut cx) {
+                                ::core::task::Poll::Ready(output) => {
+                                    unsafe { (out as *mut i32).write(output) };
+                                    true
+                                }
+                                ::core::task::Poll::Pending => false,
+                            };
+                            if poll_waker.shared.into_inner().is_none() {
+                                release(context);
+                            }
+                            done
+                        }
+                        ...
+                        let __rs_val: ::core::pin::Pin<
+                            ::std::boxed::Box<dyn ::core::future::Future<Output = i32> >
+                        > = ::std::boxed::Box::pin({ ::rust_out::add_one(x) });
+                        ...
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_async_unit() {
         let test_src = r#"
                 pub async fn async_function() {}
             "#;
         test_format_item(test_src, "async_function", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    rs_std::BoxedFuture<void> async_function();
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    ::core::task::Poll::Ready(output) => {
+                        let () = output;
+                        true
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_unsupported_fn_async() {
+        let test_src = r#"
+                pub async fn borrows(x: &i32) -> i32 { *x }
+                pub async fn get_string() -> String { String::new() }
+            "#;
+        test_format_item(test_src, "borrows", |result| {
             let err = result.unwrap_err();
             assert_eq!(
                 err,
-                "Error formatting function return type: \
-                             The following Rust type is not supported yet: \
-                             impl std::future::Future<Output = ()>"
+                "Error formatting function return type: Async functions that borrow their \
+                 arguments (or capture other lifetimes) are not supported"
+            );
+        });
+        test_format_item(test_src, "get_string", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error formatting function return type: The output of a future can't have \
+                 drop glue, but `std::string::String` does"
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_dyn_fn_mut_callback() {
+        let test_src = r#"
+                pub fn for_each(n: i32, f: &mut dyn FnMut(i32) -> i32) -> i32 {
+                    (0..n).map(f).sum()
+                }
+            "#;
+        test_format_item(test_src, "for_each", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    std::int32_t for_each(
+                        std::int32_t n,
+                        rs_std::DynFnMut<std::int32_t(std::int32_t)> f);
+                }
+            );
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" std::int32_t ...(
+                            std::int32_t,
+                            const rs_std::DynFnMut<std::int32_t(std::int32_t)>*);
+                    }
+                    inline std::int32_t for_each(
+                        std::int32_t n,
+                        rs_std::DynFnMut<std::int32_t(std::int32_t)> f) {
+                        return __crubit_internal::...(n, &f);
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C" fn ...(n: i32, f: *const std::ffi::c_void) -> i32 {
+                        let mut f = {
+                            #[repr(C)]
+                            #[derive(Clone, Copy)]
+                            struct __CrubitDynCallback {
+                                callable: *mut ::core::ffi::c_void,
+                                invoke: unsafe extern "C" fn(*mut ::core::ffi::c_void, i32) -> i32,
+                            }
+                            let __callback = unsafe { (f as *const __CrubitDynCallback).read() };
+                            move |__arg_0: i32| -> i32 {
+                                unsafe { (__callback.invoke)(__callback.callable, __arg_0) }
+                            }
+                        };
+                        ::rust_out::for_each(n, &mut f)
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_dyn_fn_callback() {
+        let test_src = r#"
+                pub fn call_twice(f: &dyn Fn(f64, bool)) {
+                    f(1.0, true);
+                    f(2.0, false);
+                }
+            "#;
+        test_format_item(test_src, "call_twice", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.main_api.tokens,
+                quote! {
+                    void call_twice(rs_std::DynFn<void(double, bool)> f);
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    let f = {
+                        ...
+                        move |__arg_0: f64, __arg_1: bool| -> () {
+                            unsafe { (__callback.invoke)(__callback.callable, __arg_0, __arg_1) }
+                        }
+                    };
+                    ::rust_out::call_twice(&f)
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_unsupported_fn_dyn_callback() {
+        let test_src = r#"
+                pub fn takes_ref(_f: &mut dyn FnMut(&i32)) {}
+                pub fn takes_string(_f: &dyn Fn(String)) {}
+                pub fn returns_callback(f: &dyn Fn()) -> &dyn Fn() { f }
+            "#;
+        test_format_item(test_src, "takes_ref", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error handling parameter #0: \
+                 Callbacks that take or return references are not supported"
+            );
+        });
+        test_format_item(test_src, "takes_string", |result| {
+            let err = result.unwrap_err();
+            assert_eq!(
+                err,
+                "Error handling parameter #0: \
+                 Callback parameter and return types have to be C ABI compatible, but \
+                 `std::string::String` isn't"
+            );
+        });
+        test_format_item(test_src, "returns_callback", |result| {
+            let err = result.unwrap_err();
+            assert!(
+                err.contains("because callbacks are only supported in function parameter types")
             );
         });
     }
@@ -6988,6 +9387,252 @@ pub mod tests {
         });
     }
 
+    #[test]
+    fn test_format_item_fn_rust_abi_returning_struct_by_value_in_place() {
+        let test_src = r#"
+                #![allow(dead_code)]
+
+                pub struct S(i32);
+                pub fn create(i: i32) -> S { S(i) }
+            "#;
+        test_format_item_returning_values_in_place(test_src, "create", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" void ...(std::int32_t, ::rust_out::S* __ret_ptr);
+                    }
+                    ...
+                    inline ::rust_out::S create(std::int32_t i) {
+                        return ::rust_out::S(
+                            crubit::InPlaceInitTag(),
+                            [&](::rust_out::S* __ret_ptr) {
+                                __crubit_internal::...(i, __ret_ptr);
+                            });
+                    }
+                }
+            );
+            assert_cc_not_matches!(result.cc_details.tokens, quote! { ReturnValueSlot });
+        });
+    }
+
+    /// Types with a `cpp_type` don't get the in-place constructor, so they are
+    /// returned through a `crubit::ReturnValueSlot` even if
+    /// `return_values_in_place` is set.
+    #[test]
+    fn test_format_item_fn_returning_cpp_type_struct_by_value_in_place() {
+        let test_src = r#"
+                #![feature(register_tool)]
+                #![register_tool(__crubit)]
+
+                #[__crubit::annotate(cpp_type="cpp_ns::CppType")]
+                pub struct RustType(i32);
+
+                pub fn create(i: i32) -> RustType { RustType(i) }
+            "#;
+        test_format_item_returning_values_in_place(test_src, "create", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    inline cpp_ns::CppType create(std::int32_t i) {
+                        ...
+                        __crubit_internal::...(i, __ret_slot.Get());
+                        return std::move(__ret_slot).AssumeInitAndTakeValue();
+                    }
+                }
+            );
+            assert_cc_not_matches!(result.cc_details.tokens, quote! { InPlaceInitTag });
+        });
+    }
+
+    #[test]
+    fn test_format_item_struct_with_in_place_ctor() {
+        let test_src = r#"
+                pub struct S(i32);
+            "#;
+        test_format_item_returning_values_in_place(test_src, "S", |result| {
+            let result = result.unwrap().unwrap();
+            let main_api = &result.main_api;
+            assert_cc_matches!(
+                format_cc_includes(&main_api.prereqs.includes),
+                quote! { include <crubit/support/for/tests/internal/return_value_slot.h> }
+            );
+            assert_cc_matches!(
+                main_api.tokens,
+                quote! {
+                    struct ... S final {
+                        ...
+                        template <typename F>
+                        S(crubit::InPlaceInitTag, F&& init) {
+                            std::forward<F>(init)(this);
+                        }
+                        ...
+                    };
+                }
+            );
+        });
+        // Without `return_values_in_place` the constructor isn't generated.
+        test_format_item(test_src, "S", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_not_matches!(result.main_api.tokens, quote! { InPlaceInitTag });
+        });
+    }
+
+    /// `#[repr(C)]`, `Copy` structs are passed by value to and from thunks,
+    /// without a `crubit::ReturnValueSlot` or `MaybeUninit` indirection.
+    #[test]
+    fn test_format_item_fn_rust_abi_repr_c_copy_struct_by_value() {
+        let test_src = r#"
+                #[derive(Clone, Copy)]
+                #[repr(C)]
+                pub struct S {
+                    pub x: f64,
+                    pub y: i32,
+                }
+                pub fn scale(s: S, factor: i32) -> S { S { x: s.x, y: s.y * factor } }
+            "#;
+        test_format_item(test_src, "scale", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" ::rust_out::S ...(::rust_out::S, std::int32_t);
+                    }
+                    inline ::rust_out::S scale(::rust_out::S s, std::int32_t factor) {
+                        return __crubit_internal::...(s, factor);
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                    #[unsafe(no_mangle)]
+                    extern "C"
+                    fn ...(s: ::rust_out::S, factor: i32) -> ::rust_out::S {
+                        ::rust_out::scale(s, factor)
+                    }
+                }
+            );
+        });
+    }
+
+    /// `#[repr(C)]`, `Copy` structs are passed by value only if their C++
+    /// bindings preserve the ABI - e.g. not if a field is replaced with an
+    /// opaque blob of bytes.
+    #[test]
+    fn test_format_item_fn_rust_abi_repr_c_copy_struct_with_unsupported_field() {
+        let test_src = r#"
+                #[derive(Clone, Copy)]
+                #[repr(C)]
+                pub struct S {
+                    pub x: f64,
+                    pub y: (i32, i32),
+                }
+                pub fn get_x(s: S) -> f64 { s.x }
+            "#;
+        test_format_item(test_src, "get_x", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    namespace __crubit_internal {
+                        extern "C" double ...(::rust_out::S*);
+                    }
+                    ...
+                    inline double get_x(::rust_out::S s) {
+                        return __crubit_internal::...(&s);
+                    }
+                }
+            );
+        });
+    }
+
+    #[test]
+    fn test_format_item_fn_inlined_trivial_body_literal() {
+        let test_src = r#"
+                pub fn answer() -> i32 { 42 }
+                pub fn min() -> i64 { -9223372036854775808 }
+                pub fn max() -> u64 { 0xFFFF_FFFF_FFFF_FFFF }
+                pub fn ratio() -> f64 { -1_000.5 }
+                pub fn whole() -> f64 { 2. }
+                pub fn yes() -> bool { true }
+                pub fn nothing() {}
+            "#;
+        let test_cases = [
+            ("answer", quote! { inline std::int32_t answer() { return 42; } }),
+            ("min", quote! { inline std::int64_t min() { return (-9223372036854775807 - 1); } }),
+            ("max", quote! { inline std::uint64_t max() { return 18446744073709551615u; } }),
+            ("ratio", quote! { inline double ratio() { return -1000.5; } }),
+            ("whole", quote! { inline double whole() { return 2.0; } }),
+            ("yes", quote! { inline bool yes() { return true; } }),
+            ("nothing", quote! { inline void nothing() {} }),
+        ];
+        for (name, expected_cc_details) in test_cases {
+            test_format_item_inlining_trivial_functions(test_src, name, |result| {
+                let result = result.unwrap().unwrap();
+                assert_cc_matches!(result.cc_details.tokens, expected_cc_details);
+                assert_cc_not_matches!(result.cc_details.tokens, quote! { __crubit_internal });
+                assert!(result.rs_details.is_empty());
+            });
+        }
+    }
+
+    #[test]
+    fn test_format_item_fn_inlined_trivial_body_field_getter() {
+        let test_src = r#"
+                pub struct S {
+                    pub x: f32,
+                    y: i32,
+                }
+                impl S {
+                    pub fn x(&self) -> f32 { self.x }
+                    pub fn get_y(&self) -> i32 { self.y }
+                }
+            "#;
+        test_format_item_inlining_trivial_functions(test_src, "x", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! { inline float S::x() const [[clang::annotate_type("lifetime", "__anon1")]] {
+                    return this->x_;
+                } }
+            );
+            assert!(result.rs_details.is_empty());
+        });
+        test_format_item_inlining_trivial_functions(test_src, "get_y", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! { inline std::int32_t S::get_y() const ... { return this->y; } }
+            );
+            assert!(result.rs_details.is_empty());
+        });
+    }
+
+    /// Functions that aren't trivial still call a thunk when
+    /// `inline_trivial_functions` is enabled.
+    #[test]
+    fn test_format_item_fn_inlined_trivial_body_not_trivial() {
+        let test_src = r#"
+                pub fn add_one(x: i32) -> i32 { x + 1 }
+            "#;
+        test_format_item_inlining_trivial_functions(test_src, "add_one", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    inline std::int32_t add_one(std::int32_t x) {
+                        return __crubit_internal::...(x);
+                    }
+                }
+            );
+            assert_rs_matches!(result.rs_details, quote! { ::rust_out::add_one(x) });
+        });
+    }
+
     /// `test_format_item_fn_rust_abi` tests a function call that is not a
     /// C-ABI, and is not the default Rust ABI.  It can't use `"stdcall"`,
     /// because it is not supported on the targets where Crubit's tests run.
@@ -8078,6 +10723,45 @@ pub mod tests {
         });
     }
 
+    /// The default constructor of a `#[repr(C)]`, `Copy` struct gets the value
+    /// returned by the thunk directly.  The C++ side of the ABI assumptions is
+    /// verified with a `static_assert`.
+    #[test]
+    fn test_format_item_repr_c_copy_struct_with_default_constructor() {
+        let test_src = r#"
+                #[derive(Clone, Copy, Default)]
+                #[repr(C)]
+                pub struct Point(pub i32, pub i32);
+            "#;
+        test_format_item(test_src, "Point", |result| {
+            let result = result.unwrap().unwrap();
+            assert_cc_matches!(
+                result.cc_details.tokens,
+                quote! {
+                    static_assert(
+                        std::is_trivially_copyable_v<Point>,
+                        "The ADT is passed by value to and from `extern \"C\"` functions");
+                    ...
+                    namespace __crubit_internal {
+                        extern "C" ::rust_out::Point ...();
+                    }
+                    inline Point::Point() {
+                        *this = __crubit_internal::...();
+                    }
+                }
+            );
+            assert_rs_matches!(
+                result.rs_details,
+                quote! {
+                   #[unsafe(no_mangle)]
+                   extern "C" fn ...() -> ::rust_out::Point {
+                       <::rust_out::Point as ::core::default::Default>::default()
+                   }
+                }
+            );
+        });
+    }
+
     #[test]
     fn test_format_item_struct_with_copy_trait() {
         let test_src = r#"
@@ -9755,6 +12439,22 @@ pub mod tests {
                 prereq_def: "SomeStruct"
 
             ),
+            // References to slices and strings:
+            case!(
+                rs: "&'static [i32]",
+                cc: "rs_std::SliceRef<const std::int32_t>",
+                includes: ["<cstdint>", "<crubit/support/for/tests/rs_std/slice_ref.h>"]
+            ),
+            case!(
+                rs: "&'static mut [f64]",
+                cc: "rs_std::SliceRef<double>",
+                includes: ["<crubit/support/for/tests/rs_std/slice_ref.h>"]
+            ),
+            case!(
+                rs: "&'static str",
+                cc: "rs_std::StrRef",
+                includes: ["<crubit/support/for/tests/rs_std/str_ref.h>"]
+            ),
             // `SomeStruct` is a `fwd_decls` prerequisite (not `defs` prerequisite):
             case!(
                 rs: "*mut SomeStruct",
@@ -9807,6 +12507,23 @@ pub mod tests {
                 cc: "std :: int32_t & [[clang :: annotate_type (\"lifetime\" , \"__anon1\")]]",
                 includes: ["<cstdint>"]
             ),
+            // Optional references and `NonNull` pointers are nullable pointers:
+            case!(
+                rs: "Option<&'static i32>",
+                cc: "std :: int32_t const * [[clang :: annotate_type (\"lifetime\" , \"static\")]]",
+                includes: ["<cstdint>"]
+            ),
+            case!(
+                rs: "Option<&'static mut SomeStruct>",
+                cc: ":: rust_out :: SomeStruct * [[clang :: annotate_type (\"lifetime\" , \"static\")]]",
+                includes: [],
+                prereq_fwd_decl: "SomeStruct"
+            ),
+            case!(
+                rs: "Option<std::ptr::NonNull<i32>>",
+                cc: "std :: int32_t *",
+                includes: ["<cstdint>"]
+            ),
         ];
         let preamble = quote! {
             #![allow(unused_parens)]
@@ -9953,18 +12670,6 @@ pub mod tests {
                 "[i32; 42]", // TyKind::Array
                 "The following Rust type is not supported yet: [i32; 42]",
             ),
-            (
-                // Check that the failure for slices is about not being supported and not failed
-                // asserts about ABI and layout.
-                "&'static [i32]", // TyKind::Slice (nested underneath TyKind::Ref)
-                "Failed to format the referent of the reference type `&'static [i32]`: \
-                 The following Rust type is not supported yet: [i32]",
-            ),
-            (
-                "&'static str", // TyKind::Str (nested underneath TyKind::Ref)
-                "Failed to format the referent of the reference type `&'static str`: \
-                 The following Rust type is not supported yet: str",
-            ),
             (
                 "impl Eq", // TyKind::Alias
                 "The following Rust type is not supported yet: impl Eq",
@@ -10088,6 +12793,12 @@ pub mod tests {
             ("extern \"C\" fn(i32) -> i32", "extern \"C\" fn(i32) -> i32"),
             // Pointer to a Slice:
             ("*mut [i32]", "*mut [i32]"),
+            // References to a Slice and to a Str:
+            ("&'static [i32]", "& 'static [i32]"),
+            ("&'static str", "& 'static str"),
+            // Owned buffers:
+            ("String", "::std::string::String"),
+            ("Vec<u8>", "::std::vec::Vec<u8>"),
             // MaybeUninit:
             ("&'static std::mem::MaybeUninit<i32>", "& 'static std :: mem :: MaybeUninit < i32 >"),
             (
@@ -10096,6 +12807,12 @@ pub mod tests {
             ),
             ("*const std::mem::MaybeUninit<i32>", "*const std::mem::MaybeUninit<i32>"),
             ("*mut std::mem::MaybeUninit<i32>", "*mut std::mem::MaybeUninit<i32>"),
+            // Optional references and `NonNull` pointers:
+            ("Option<&'static i32>", "::core::option::Option<& 'static i32>"),
+            (
+                "Option<std::ptr::NonNull<SomeStruct>>",
+                "::core::option::Option<::core::ptr::NonNull<:: rust_out :: SomeStruct> >",
+            ),
         ];
         let preamble = quote! {
             #![feature(never_type)]
@@ -10121,6 +12838,30 @@ pub mod tests {
         });
     }
 
+    #[test]
+    fn test_hir_ty_contains_type_alias() {
+        let testcases = [
+            // ( <Rust type>, <expected result> )
+            ("i32", false),
+            ("*const SomeStruct", false),
+            ("&'static [u8]", false),
+            ("c_char", true),
+            ("std::ffi::c_char", true),
+            ("*mut *const c_char", true),
+            ("&'static [c_char]", true),
+            ("extern \"C\" fn (c_char)", true),
+        ];
+        let preamble = quote! {
+            use std::ffi::c_char;
+            pub struct SomeStruct;
+        };
+        test_ty(TypeLocation::FnParam, &testcases, preamble, |desc, tcx, ty, expected| {
+            let db = bindings_db_for_tests(tcx);
+            let hir_ty = ty.hir(&db).expect("`test_ty` should provide the HIR of the type");
+            assert_eq!(hir_ty_contains_type_alias(hir_ty), *expected, "{desc}");
+        });
+    }
+
     #[test]
     fn test_format_ty_for_rs_failures() {
         // This test provides coverage for cases where `format_ty_for_rs` returns an
@@ -10135,11 +12876,6 @@ pub mod tests {
                 "[i32; 42]", // TyKind::Array
                 "The following Rust type is not supported yet: [i32; 42]",
             ),
-            (
-                "&'static str", // TyKind::Str (nested underneath TyKind::Ref)
-                "Failed to format the referent of the reference type `&'static str`: \
-                 The following Rust type is not supported yet: str",
-            ),
             (
                 "impl Eq", // TyKind::Alias
                 "The following Rust type is not supported yet: impl Eq",
@@ -11340,6 +14076,74 @@ pub mod tests {
         })
     }
 
+    /// Like `test_format_item`, but with
+    /// `BindingsGenerator::inline_trivial_functions` enabled.
+    fn test_format_item_inlining_trivial_functions<F, T>(
+        source: &str,
+        name: &str,
+        test_function: F,
+    ) -> T
+    where
+        F: FnOnce(Result<Option<ApiSnippets>, String>) -> T + Send,
+        T: Send,
+    {
+        test_format_item_with_options(source, name, true, false, test_function)
+    }
+
+    /// Like `test_format_item`, but with
+    /// `BindingsGenerator::return_values_in_place` enabled.
+    fn test_format_item_returning_values_in_place<F, T>(
+        source: &str,
+        name: &str,
+        test_function: F,
+    ) -> T
+    where
+        F: FnOnce(Result<Option<ApiSnippets>, String>) -> T + Send,
+        T: Send,
+    {
+        test_format_item_with_options(source, name, false, true, test_function)
+    }
+
+    fn test_format_item_with_options<F, T>(
+        source: &str,
+        name: &str,
+        inline_trivial_functions: bool,
+        return_values_in_place: bool,
+        test_function: F,
+    ) -> T
+    where
+        F: FnOnce(Result<Option<ApiSnippets>, String>) -> T + Send,
+        T: Send,
+    {
+        run_compiler_for_testing(source, |tcx| {
+            let def_id = find_def_id_by_name(tcx, name);
+            let db = Database::new(
+                tcx,
+                /* crubit_support_path_format= */
+                "<crubit/support/for/tests/{header}>".into(),
+                /* default_features= */ Default::default(),
+                /* crate_name_to_include_paths= */ Default::default(),
+                /* crate_name_to_features= */
+                Rc::new(HashMap::from([(
+                    Rc::from("self"),
+                    crubit_feature::CrubitFeature::Experimental
+                        | crubit_feature::CrubitFeature::Supported,
+                )])),
+                /* crate_name_to_namespace= */ HashMap::default().into(),
+                /* errors = */ Rc::new(IgnoreErrors),
+                /* no_thunk_name_mangling= */ true,
+                /* include_guard */ IncludeGuard::PragmaOnce,
+                /* h_out_modules_include_prefix= */ None,
+                inline_trivial_functions,
+                /* prune_crate_header_includes= */ false,
+                return_values_in_place,
+                /* emit_items= */ None,
+            );
+            let result = db.format_item(def_id).map_err(|anyhow_err| format!("{anyhow_err:#}"));
+            test_function(result)
+        })
+    }
+
     /// Tests invoking `format_item` on the item with the specified `name` from
     /// the given Rust `source`, with the specified features  Returns the result
     /// of calling `test_function` with `format_item`'s result as an
@@ -11383,6 +14187,11 @@ pub mod tests {
             /* errors = */ Rc::new(IgnoreErrors),
             /* no_thunk_name_mangling= */ true,
             /* include_guard */ IncludeGuard::PragmaOnce,
+            /* h_out_modules_include_prefix= */ None,
+            /* inline_trivial_functions= */ false,
+            /* prune_crate_header_includes= */ false,
+            /* return_values_in_place= */ false,
+            /* emit_items= */ None,
         )
     }
 
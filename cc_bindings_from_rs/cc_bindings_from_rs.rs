@@ -11,7 +11,7 @@ extern crate rustc_middle;
 use arc_anyhow::{Context, Result};
 use itertools::Itertools;
 use rustc_middle::ty::TyCtxt; // See also <internal link>/ty.html#import-conventions
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::path::Path;
 use std::rc::Rc;
 
@@ -19,11 +19,16 @@ use bindings::{Database, IncludeGuard};
 use cmdline::Cmdline;
 use code_gen_utils::CcInclude;
 use error_report::{ErrorReport, ErrorReporting, IgnoreErrors};
-use run_compiler::run_compiler;
+use run_compiler::{run_compiler, run_compiler_and_continue};
 use token_stream_printer::{
-    cc_tokens_to_formatted_string, rs_tokens_to_formatted_string, RustfmtConfig,
+    rs_and_many_cc_tokens_to_formatted_strings, tokens_to_api_hash, RustfmtConfig,
 };
 
+/// The minimum size of the chunks of the generated Rust code that are formatted
+/// by concurrent `rustfmt` processes. Smaller chunks are not worth an extra
+/// process.
+const RS_MIN_CHUNK_LEN: usize = 64 * 1024;
+
 fn turn_off_clang_format(mut h_body: String) -> String {
     h_body.insert_str(
         h_body.find("#ifndef").unwrap_or_else(|| h_body.find("#pragma once").unwrap()),
@@ -69,11 +74,20 @@ fn new_db<'tcx>(
     } else {
         IncludeGuard::PragmaOnce
     };
+    // `Cmdline::new` has verified that the modules directory is below the
+    // directory of the main header.
+    let h_out_modules_include_prefix: Option<Rc<str>> =
+        cmdline.h_out_modules_dir.as_ref().map(|dir| {
+            let h_out_dir = cmdline.h_out.parent().unwrap_or(Path::new(""));
+            dir.strip_prefix(h_out_dir).unwrap().to_string_lossy().into()
+        });
     let mut crate_name_to_namespace = <HashMap<Rc<str>, Rc<str>>>::new();
     for (crate_name, namespace) in &cmdline.crate_namespaces {
         // TODO: Check dup.
         crate_name_to_namespace.insert(crate_name.as_str().into(), namespace.as_str().into());
     }
+    let emit_items: Option<Rc<HashSet<Rc<str>>>> = (!cmdline.emit_items.is_empty())
+        .then(|| Rc::new(cmdline.emit_items.iter().map(|path| path.as_str().into()).collect()));
     Database::new(
         tcx,
         crubit_support_path_format,
@@ -84,6 +98,11 @@ fn new_db<'tcx>(
         errors,
         cmdline.no_thunk_name_mangling,
         include_guard,
+        h_out_modules_include_prefix,
+        cmdline.inline_trivial_functions,
+        cmdline.prune_crate_header_includes,
+        cmdline.return_values_in_place,
+        emit_items,
     )
 }
 
@@ -96,27 +115,52 @@ fn run_with_tcx(cmdline: &Cmdline, tcx: TyCtxt) -> Result<()> {
         Rc::new(IgnoreErrors)
     };
 
-    let Output { h_body, rs_body } = {
+    let Output { h_body, rs_body, h_modules, h_fwd_body } = {
         let db = new_db(cmdline, tcx, errors.clone());
         generate_bindings(&db)?
     };
 
-    {
-        let h_body = cc_tokens_to_formatted_string(h_body, &cmdline.clang_format_exe_path)?;
-        let h_body = turn_off_clang_format(h_body);
-        write_file(&cmdline.h_out, &h_body)?;
+    // The headers and the Rust source code are formatted concurrently.
+    let (h_module_names, h_module_bodies): (Vec<_>, Vec<_>) = h_modules.into_iter().unzip();
+    // The forward declarations header only repeats declarations of the main
+    // header, so it doesn't contribute to the hash.
+    let api_hash = cmdline.api_hash_out.as_ref().map(|api_hash_out| {
+        let api_tokens =
+            h_body.clone().into_iter().chain(h_module_bodies.iter().cloned().flatten()).collect();
+        (api_hash_out, tokens_to_api_hash(api_tokens))
+    });
+    let h_fwd_body = cmdline.h_out_fwd.as_ref().map(|_| h_fwd_body);
+    let rustfmt_config =
+        RustfmtConfig::new(&cmdline.rustfmt_exe_path, cmdline.rustfmt_config_path.as_deref());
+    let (rs_body, mut h_bodies) = rs_and_many_cc_tokens_to_formatted_strings(
+        rs_body,
+        &rustfmt_config,
+        RS_MIN_CHUNK_LEN,
+        std::iter::once(h_body).chain(h_fwd_body).chain(h_module_bodies).collect(),
+        &cmdline.clang_format_exe_path,
+    )?;
+
+    let h_body = h_bodies.remove(0);
+    write_file(&cmdline.h_out, &turn_off_clang_format(h_body))?;
+    if let Some(h_out_fwd) = &cmdline.h_out_fwd {
+        write_file(h_out_fwd, &turn_off_clang_format(h_bodies.remove(0)))?;
     }
-
-    {
-        let rustfmt_config =
-            RustfmtConfig::new(&cmdline.rustfmt_exe_path, cmdline.rustfmt_config_path.as_deref());
-        let rs_body = rs_tokens_to_formatted_string(rs_body, &rustfmt_config)?;
-        write_file(&cmdline.rs_out, &rs_body)?;
+    if let Some(h_out_modules_dir) = &cmdline.h_out_modules_dir {
+        std::fs::create_dir_all(h_out_modules_dir)
+            .with_context(|| format!("Error when creating {}", h_out_modules_dir.display()))?;
+        for (name, h_module) in h_module_names.iter().zip(h_bodies) {
+            let path = h_out_modules_dir.join(format!("{name}.h"));
+            write_file(&path, &turn_off_clang_format(h_module))?;
+        }
     }
+    write_file(&cmdline.rs_out, &rs_body)?;
 
     if let Some(error_report_out) = &cmdline.error_report_out {
         write_file(error_report_out, &errors.serialize_to_string().unwrap())?;
     }
+    if let Some((api_hash_out, api_hash)) = &api_hash {
+        write_file(api_hash_out, api_hash)?;
+    }
 
     Ok(())
 }
@@ -126,7 +170,11 @@ fn run_with_tcx(cmdline: &Cmdline, tcx: TyCtxt) -> Result<()> {
 /// `init_env_logger`) and therefore can be used from the tests module below.
 fn run_with_cmdline_args(args: &[String]) -> Result<()> {
     let cmdline = Cmdline::new(args)?;
-    run_compiler(&cmdline.rustc_args, |tcx| run_with_tcx(&cmdline, tcx))
+    if cmdline.continue_compilation {
+        run_compiler_and_continue(&cmdline.rustc_args, |tcx| run_with_tcx(&cmdline, tcx))
+    } else {
+        run_compiler(&cmdline.rustc_args, |tcx| run_with_tcx(&cmdline, tcx))
+    }
 }
 
 fn main() -> Result<()> {
@@ -422,13 +470,13 @@ namespace public_module {
 "#,
  // TODO(b/261185414): Avoid assuming that all source code paths are google3 paths.
 format!("// Generated from: google3/{temp_dir_str}/test_crate.rs;l=2"),
-r#"void public_function();
+r#"void public_function() noexcept;
 
 namespace __crubit_internal {
 extern "C" void
-__crubit_thunk_ANY_IDENTIFIER_CHARACTERS();
+__crubit_thunk_ANY_IDENTIFIER_CHARACTERS() noexcept;
 }
-inline void public_function() {
+inline void public_function() noexcept {
   return __crubit_internal::
       __crubit_thunk_ANY_IDENTIFIER_CHARACTERS();
 }
@@ -469,13 +517,13 @@ namespace public_module {
 "#,
  // TODO(b/261185414): Avoid assuming that all source code paths are google3 paths.
 format!("// Generated from: google3/{temp_dir_str}/test_crate.rs;l=2"),
-r#"void public_function();
+r#"void public_function() noexcept;
 
 namespace __crubit_internal {
 extern "C" void
-__crubit_thunk_ANY_IDENTIFIER_CHARACTERS();
+__crubit_thunk_ANY_IDENTIFIER_CHARACTERS() noexcept;
 }
-inline void public_function() {
+inline void public_function() noexcept {
   return __crubit_internal::
       __crubit_thunk_ANY_IDENTIFIER_CHARACTERS();
 }
@@ -546,19 +594,27 @@ extern "C" fn __crubit_thunk_ANY_IDENTIFIER_CHARACTERS()
     /// support specifying a custom panic mechanism.
     #[test]
     fn test_rustc_with_panic_unwind() -> Result<()> {
-        let _ = TestArgs::default_args()?
+        let test_result = TestArgs::default_args()?
             .with_panic_mechanism("unwind")
             .run()
             .expect("panic=unwind should not cause an error");
+
+        // Rust panics may unwind into C++.
+        let h_body = std::fs::read_to_string(&test_result.h_path)?;
+        assert!(!h_body.contains("noexcept"), "h_body:\n{h_body}");
         Ok(())
     }
 
     #[test]
     fn test_rustc_with_panic_abort() -> Result<()> {
-        let _ = TestArgs::default_args()?
+        let test_result = TestArgs::default_args()?
             .with_panic_mechanism("abort")
             .run()
             .expect("panic=abort should not cause an error");
+
+        // Rust panics can't unwind into C++, so the bindings don't throw.
+        let h_body = std::fs::read_to_string(&test_result.h_path)?;
+        assert!(h_body.contains("void public_function() noexcept;"), "h_body:\n{h_body}");
         Ok(())
     }
 
@@ -584,6 +640,35 @@ extern "C" fn __crubit_thunk_ANY_IDENTIFIER_CHARACTERS()
         );
     }
 
+    #[test]
+    fn test_h_out_fwd() -> Result<()> {
+        let test_args = TestArgs::default_args()?;
+        let h_fwd_path = test_args.tempdir.path().join("test_crate_cc_api_fwd.h");
+        let h_fwd_arg = format!("--h-out-fwd={}", h_fwd_path.display());
+        let test_args = test_args
+            .with_extra_crubit_args(&["--default-features=supported", &h_fwd_arg])
+            .with_rs_input(
+                r#" pub mod public_module {
+                        pub struct SomeStruct(i32);
+                        pub fn public_function(_: &SomeStruct) {}
+                    }
+                "#,
+            );
+        test_args.run()?;
+
+        let h_fwd_body = std::fs::read_to_string(&h_fwd_path)?;
+        assert_starts_with(
+            &h_fwd_body,
+            "// Automatically @generated C++ bindings for the following Rust crate:\n\
+            // test_crate\n\
+            // Features: supported",
+        );
+        assert!(h_fwd_body.contains("struct SomeStruct;"), "h_fwd_body:\n{h_fwd_body}");
+        assert!(!h_fwd_body.contains("public_function"), "h_fwd_body:\n{h_fwd_body}");
+        assert!(!h_fwd_body.contains("#include"), "h_fwd_body:\n{h_fwd_body}");
+        Ok(())
+    }
+
     #[test]
     fn test_crate_features() -> Result<()> {
         let test_args = TestArgs::default_args()?.with_extra_crubit_args(&[
@@ -12,7 +12,7 @@ use anyhow::{bail, ensure, Result};
 use clap::Parser;
 use rustc_session::config::ErrorOutputType;
 use rustc_session::EarlyDiagCtxt;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 #[derive(Debug, Parser)]
 #[clap(name = "cc_bindings_from_rs")]
@@ -26,6 +26,17 @@ pub struct Cmdline {
     #[clap(long, value_parser, value_name = "STRING")]
     pub h_out_include_guard: Option<String>,
 
+    /// Output directory for C++ header files with the bindings of the top-level
+    /// modules of the crate, which the `--h-out` header includes. It should be
+    /// a subdirectory of the directory of `--h-out`.
+    #[clap(long, value_parser, value_name = "DIR")]
+    pub h_out_modules_dir: Option<PathBuf>,
+
+    /// Output path for a C++ header file with only the forward declarations of
+    /// the structs, enums and unions from the `--h-out` header.
+    #[clap(long, value_parser, value_name = "FILE")]
+    pub h_out_fwd: Option<PathBuf>,
+
     /// Output path for Rust implementation of the bindings.
     #[clap(long, value_parser, value_name = "FILE")]
     pub rs_out: PathBuf,
@@ -101,6 +112,13 @@ pub struct Cmdline {
     #[clap(long, value_parser, value_name = "FILE")]
     pub error_report_out: Option<PathBuf>,
 
+    /// Path to the output file with a hash of the API of the generated C++
+    /// headers, which ignores comments and formatting. It only changes when
+    /// the API does, so that dependents can key on it instead of the contents
+    /// of the headers.
+    #[clap(long, value_parser, value_name = "FILE")]
+    pub api_hash_out: Option<PathBuf>,
+
     /// This is for golden tests only. Using this in production may cause
     /// undefined behavior.
     #[clap(long, value_parser, value_name = "BOOL")]
@@ -112,6 +130,38 @@ pub struct Cmdline {
     #[clap(long = "crate-namespace", value_parser = parse_crate_namespace,
            value_name = "CRATE_NAME=NAMESPACE")]
     pub crate_namespaces: Vec<(String, String)>,
+
+    /// Continue the compilation of the crate after generating the bindings,
+    /// so that the same invocation also produces the outputs requested by the
+    /// Rust compiler arguments (e.g. `--emit=link,metadata`) instead of the
+    /// crate being analyzed by a separate compilation.
+    #[clap(long, value_parser, value_name = "BOOL")]
+    pub continue_compilation: bool,
+
+    /// Generate C++ bindings of trivial Rust functions (e.g. field getters or
+    /// functions returning a literal) that replicate the body of the Rust
+    /// function instead of calling a thunk, so that C++ callers can inline
+    /// them.
+    #[clap(long, value_parser, value_name = "BOOL")]
+    pub inline_trivial_functions: bool,
+
+    /// Only `#include` the `--crate-header` of a dependency crate if the
+    /// generated bindings need a complete type from that crate. Types that are
+    /// only used through pointers or references are forward-declared instead.
+    #[clap(long, value_parser, value_name = "BOOL")]
+    pub prune_crate_header_includes: bool,
+
+    /// Construct structs returned by value from Rust functions directly in the
+    /// C++ caller's return location, instead of moving them out of a temporary.
+    #[clap(long, value_parser, value_name = "BOOL")]
+    pub return_values_in_place: bool,
+
+    /// Only generate bindings for the item with the given path (e.g.
+    /// `some_module::SomeStruct`) and for the items that its bindings depend
+    /// on. Can be repeated. Without this flag, bindings are generated for all
+    /// the public items of the crate.
+    #[clap(long = "emit-item", value_parser, value_name = "PATH")]
+    pub emit_items: Vec<String>,
 }
 
 impl Cmdline {
@@ -137,6 +187,17 @@ impl Cmdline {
         // Parse `args` using the parser `derive`d by the `clap` crate.
         let mut cmdline = Self::try_parse_from(args)?;
 
+        if let Some(h_out_modules_dir) = &cmdline.h_out_modules_dir {
+            let h_out_dir = cmdline.h_out.parent().unwrap_or(Path::new(""));
+            ensure!(
+                h_out_modules_dir.starts_with(h_out_dir) && h_out_modules_dir != h_out_dir,
+                "`--h-out-modules-dir` ({}) should be a subdirectory of the directory of \
+                 `--h-out` ({})",
+                h_out_modules_dir.display(),
+                cmdline.h_out.display(),
+            );
+        }
+
         // For compatibility with `rustc_driver` expectations, we prepend `exe_name` to
         // `rustc_args.  This is needed, because `rustc_driver::RunCompiler::new`
         // expects that its `at_args` includes the name of the executable -
@@ -326,6 +387,12 @@ Options:
       --h-out-include-guard <STRING>
           Include guard for the C++ header file with bindings
 
+      --h-out-modules-dir <DIR>
+          Output directory for C++ header files with the bindings of the top-level modules of the crate, which the `--h-out` header includes. It should be a subdirectory of the directory of `--h-out`
+
+      --h-out-fwd <FILE>
+          Output path for a C++ header file with only the forward declarations of the structs, enums and unions from the `--h-out` header
+
       --rs-out <FILE>
           Output path for Rust implementation of the bindings
 
@@ -366,12 +433,30 @@ Options:
       --error-report-out <FILE>
           Path to the error reporting output file
 
+      --api-hash-out <FILE>
+          Path to the output file with a hash of the API of the generated C++ headers, which ignores comments and formatting. It only changes when the API does, so that dependents can key on it instead of the contents of the headers
+
       --no-thunk-name-mangling
           This is for golden tests only. Using this in production may cause undefined behavior
 
       --crate-namespace <CRATE_NAME=NAMESPACE>
           The top level namespace of the C++ bindings for a given crate. Keys are crate names, and values are namespaces. Example: "--crate-namespace=foo=a_namespace::b_namespace
 
+      --continue-compilation
+          Continue the compilation of the crate after generating the bindings, so that the same invocation also produces the outputs requested by the Rust compiler arguments (e.g. `--emit=link,metadata`) instead of the crate being analyzed by a separate compilation
+
+      --inline-trivial-functions
+          Generate C++ bindings of trivial Rust functions (e.g. field getters or functions returning a literal) that replicate the body of the Rust function instead of calling a thunk, so that C++ callers can inline them
+
+      --prune-crate-header-includes
+          Only `#include` the `--crate-header` of a dependency crate if the generated bindings need a complete type from that crate. Types that are only used through pointers or references are forward-declared instead
+
+      --return-values-in-place
+          Construct structs returned by value from Rust functions directly in the C++ caller's return location, instead of moving them out of a temporary
+
+      --emit-item <PATH>
+          Only generate bindings for the item with the given path (e.g. `some_module::SomeStruct`) and for the items that its bindings depend on. Can be repeated. Without this flag, bindings are generated for all the public items of the crate
+
   -h, --help
           Print help (see a summary with '-h')
 "#;
@@ -533,6 +618,31 @@ Options:
         );
     }
 
+    #[test]
+    fn test_h_out_modules_dir() {
+        let cmdline = new_cmdline([
+            "--h-out=out/foo.h",
+            "--h-out-modules-dir=out/foo_modules",
+            "--rs-out=foo_impl.rs",
+            "--crubit-support-path-format=<crubit/support/{header}>",
+            "--clang-format-exe-path=clang-format.exe",
+            "--rustfmt-exe-path=rustfmt.exe",
+        ])
+        .unwrap();
+        assert_eq!(Some(Path::new("out/foo_modules")), cmdline.h_out_modules_dir.as_deref());
+
+        let anyhow_err = new_cmdline([
+            "--h-out=out/foo.h",
+            "--h-out-modules-dir=elsewhere/foo_modules",
+            "--rs-out=foo_impl.rs",
+            "--crubit-support-path-format=<crubit/support/{header}>",
+            "--clang-format-exe-path=clang-format.exe",
+            "--rustfmt-exe-path=rustfmt.exe",
+        ])
+        .expect_err("--h-out-modules-dir outside of the directory of --h-out should be rejected");
+        assert!(anyhow_err.to_string().contains("should be a subdirectory"));
+    }
+
     #[test]
     fn test_crubit_support_path_format_arg_happy_path() {
         let cmdline = new_cmdline([
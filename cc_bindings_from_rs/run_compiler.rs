@@ -33,6 +33,34 @@ use rustc_session::EarlyDiagCtxt;
 /// - Is safe to run from unit tests (which may run in parallel / on multiple
 ///   threads).
 pub fn run_compiler<F, R>(rustc_args: &[String], callback: F) -> Result<R>
+where
+    F: FnOnce(TyCtxt) -> Result<R> + Send,
+    R: Send,
+{
+    run_compiler_impl(rustc_args, callback, /* continue_compilation= */ false)
+}
+
+/// Like `run_compiler`, but if the `callback` succeeds, then the compilation
+/// continues after it, and produces the outputs requested by `rustc_args`
+/// (e.g. `--emit=link,metadata`).
+///
+/// This lets a single Rust compiler invocation both build the crate and run
+/// the `callback`, instead of running the parsing and analysis of the crate a
+/// second time. Unlike in `run_compiler`, the warnings of the crate are
+/// reported as usual.
+pub fn run_compiler_and_continue<F, R>(rustc_args: &[String], callback: F) -> Result<R>
+where
+    F: FnOnce(TyCtxt) -> Result<R> + Send,
+    R: Send,
+{
+    run_compiler_impl(rustc_args, callback, /* continue_compilation= */ true)
+}
+
+fn run_compiler_impl<F, R>(
+    rustc_args: &[String],
+    callback: F,
+    continue_compilation: bool,
+) -> Result<R>
 where
     F: FnOnce(TyCtxt) -> Result<R> + Send,
     R: Send,
@@ -55,7 +83,7 @@ where
     });
     LazyLock::force(&ENV_LOGGER_INIT);
 
-    AfterAnalysisCallback::new(rustc_args, callback).run()
+    AfterAnalysisCallback::new(rustc_args, callback, continue_compilation).run()
 }
 
 struct AfterAnalysisCallback<'a, F, R>
@@ -65,6 +93,7 @@ where
 {
     args: &'a [String],
     callback_or_result: Either<F, Result<R>>,
+    continue_compilation: bool,
 }
 
 impl<'a, F, R> AfterAnalysisCallback<'a, F, R>
@@ -72,8 +101,8 @@ where
     F: FnOnce(TyCtxt) -> Result<R> + Send,
     R: Send,
 {
-    fn new(args: &'a [String], callback: F) -> Self {
-        Self { args, callback_or_result: Either::Left(callback) }
+    fn new(args: &'a [String], callback: F, continue_compilation: bool) -> Self {
+        Self { args, callback_or_result: Either::Left(callback), continue_compilation }
     }
 
     /// Runs Rust compiler, and then invokes the stored callback (with
@@ -117,7 +146,11 @@ where
         // Silence warnings in the target crate to avoid reporting them twice: once when
         // compiling the crate via `rustc` and once when "compiling" the crate
         // via `cc_bindings_from_rs` (the `config` here affects the latter one).
-        config.opts.lint_opts.push(("warnings".to_string(), rustc_lint_defs::Level::Allow));
+        // There is no separate compilation of the crate when it continues after
+        // the callback.
+        if !self.continue_compilation {
+            config.opts.lint_opts.push(("warnings".to_string(), rustc_lint_defs::Level::Allow));
+        }
     }
 
     fn after_analysis<'tcx>(
@@ -140,7 +173,11 @@ where
             self.callback_or_result = Either::Right(callback(tcx));
         });
 
-        rustc_driver::Compilation::Stop
+        if self.continue_compilation && self.callback_or_result.as_ref().right().unwrap().is_ok() {
+            rustc_driver::Compilation::Continue
+        } else {
+            rustc_driver::Compilation::Stop
+        }
     }
 }
 
@@ -231,4 +268,45 @@ mod tests {
         assert!(!out_path.exists());
         Ok(())
     }
+
+    /// `test_run_compiler_and_continue_output_file` tests that the compilation
+    /// continues after the callback (i.e. that we return `Continue` from
+    /// `after_analysis`), unless the callback fails.
+    #[test]
+    fn test_run_compiler_and_continue_output_file() -> Result<()> {
+        let tmpdir = tempdir()?;
+
+        let rs_path = tmpdir.path().join("input_crate.rs");
+        std::fs::write(&rs_path, DEFAULT_RUST_SOURCE_FOR_TESTING)?;
+
+        let rustc_args_for_output = |out_path: &std::path::Path| {
+            let mut rustc_args = vec![
+                "run_compiler_unittest_executable".to_string(),
+                "--crate-type=lib".to_string(),
+                "--emit=metadata".to_string(),
+                format!("--sysroot={}", get_sysroot_for_testing().display()),
+                rs_path.display().to_string(),
+                "-o".to_string(),
+                out_path.display().to_string(),
+            ];
+            if let Some(target_arg) = setup_rustc_target_for_testing(tmpdir.path()) {
+                rustc_args.push(format!("--target={}", target_arg));
+            }
+            rustc_args
+        };
+
+        let out_path = tmpdir.path().join("expected_output.rmeta");
+        let result = run_compiler_and_continue(&rustc_args_for_output(&out_path), |_tcx| Ok(123))?;
+        assert_eq!(123, result);
+        assert!(out_path.exists());
+
+        let out_path = tmpdir.path().join("unexpected_output.rmeta");
+        let err = run_compiler_and_continue(&rustc_args_for_output(&out_path), |_tcx| {
+            Err::<(), _>(anyhow!("callback error"))
+        })
+        .expect_err("the error of the callback should be propagated");
+        assert_eq!("callback error", format!("{err:#}"));
+        assert!(!out_path.exists());
+        Ok(())
+    }
 }
@@ -6,6 +6,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "cc_bindings_from_rs/test/bazel/cross_crate/pruned_api.h"
 #include "cc_bindings_from_rs/test/bazel/cross_crate/test_api.h"
 
 namespace crubit {
@@ -17,6 +18,15 @@ TEST(CrossCrateTests, BasicEndToEndTest) {
   EXPECT_EQ(123, i);
 }
 
+TEST(CrossCrateTests, PrunedCrateHeaderIncludes) {
+  other_crate::SomeStruct s = test_api::create_struct(123);
+  EXPECT_EQ(123, pruned_api::extract_int(s));
+  // `SomeCppStruct` is spelled `other_crate::SomeStruct` in C++, which the
+  // bindings can't forward-declare, so `pruned_api.h` still includes the header
+  // of `other_crate`.
+  EXPECT_EQ(123, pruned_api::extract_int_from_cpp_struct(s));
+}
+
 // b/292231336
 // TEST(CrossCrateTests, RustToolchainCrate) {
 //   ::alloc::string::String s =
@@ -5,4 +5,13 @@
 //! This crate is used as a dependency of `test_api.rs` - types exported by
 //! `other_crate.rs` are used in public API exposed by `test_api.rs`.
 
+#![feature(register_tool)]
+#![register_tool(__crubit)]
+
 pub struct SomeStruct(pub i32);
+
+/// The C++ bindings of `SomeStruct` stand in for a C++ type that a Rust type
+/// is mapped to with `cpp_type`, such as the Rust bindings of a C++ struct.
+#[__crubit::annotate(cpp_type = "other_crate::SomeStruct")]
+#[repr(transparent)]
+pub struct SomeCppStruct(pub i32);
@@ -0,0 +1,16 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! Like `test_api.rs`, but the bindings are generated with
+//! `--prune-crate-header-includes`.  Types from `other_crate` that are only
+//! used through references are forward-declared, except for types with a
+//! `cpp_type`, which need the header of `other_crate`.
+
+pub fn extract_int(s: &other_crate::SomeStruct) -> i32 {
+    s.0
+}
+
+pub fn extract_int_from_cpp_struct(s: &other_crate::SomeCppStruct) -> i32 {
+    s.0
+}
@@ -23,6 +23,45 @@ pub mod repr_c {
     }
 }
 
+/// Test for `#[repr(C)]`, `Copy` structs.  Such structs are passed by value
+/// to and from the thunks (rather than through an out-pointer).
+pub mod repr_c_copy {
+    #[derive(Clone, Copy, Default)]
+    #[repr(C)]
+    pub struct Point {
+        pub x: i32,
+        pub y: i32,
+    }
+
+    /// Expected ABI classification: SSE and integer.  The C++ bindings must
+    /// not replace the implicit tail padding with explicit padding fields.
+    #[derive(Clone, Copy)]
+    #[repr(C)]
+    pub struct Scaled {
+        pub point: Point,
+        pub scale: f64,
+        pub id: u8,
+    }
+
+    pub fn create(x: i32, y: i32) -> Point {
+        Point { x, y }
+    }
+
+    pub fn scale(s: Scaled) -> Point {
+        Point { x: (s.point.x as f64 * s.scale) as i32, y: (s.point.y as f64 * s.scale) as i32 }
+    }
+
+    impl Point {
+        pub fn get_x(self) -> i32 {
+            self.x
+        }
+
+        pub fn with_id(self, scale: f64, id: u8) -> Scaled {
+            Scaled { point: self, scale, id }
+        }
+    }
+}
+
 /// Test for a struct using default layout (i.e. one without an explicit
 /// `#[repr(C)]` or similar attribute).  Among other things, it tests that
 /// building generated `..._cc_api_impl.rs` will not warn about
@@ -20,6 +20,26 @@ TEST(StructsTest, ReprCPointReturnedOrTakenByValue) {
   EXPECT_EQ(123, structs::repr_c::get_x(std::move(p)));
 }
 
+TEST(StructsTest, ReprCCopyStructsReturnedOrTakenByValue) {
+  namespace test = structs::repr_c_copy;
+  static_assert(std::is_trivially_copyable_v<test::Point>);
+  static_assert(std::is_trivially_copyable_v<test::Scaled>);
+
+  test::Point default_point;
+  EXPECT_EQ(0, default_point.x);
+  EXPECT_EQ(0, default_point.y);
+
+  test::Point p = test::create(123, 456);
+  EXPECT_EQ(123, test::Point(p).get_x());
+  test::Scaled s = std::move(p).with_id(2.0, 7);
+  EXPECT_EQ(123, s.point.x);
+  EXPECT_EQ(2.0, s.scale);
+  EXPECT_EQ(7, s.id);
+  test::Point scaled = test::scale(s);
+  EXPECT_EQ(246, scaled.x);
+  EXPECT_EQ(912, scaled.y);
+}
+
 TEST(StructsTest, ZstFieldsReturnedOrTakenByValue) {
   structs::zst_fields::ZstFields x = structs::zst_fields::create(42);
   EXPECT_EQ(42, x.value);
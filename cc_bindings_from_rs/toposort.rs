@@ -2,7 +2,7 @@
 // Exceptions. See /LICENSE for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-use std::cmp::Ordering;
+use std::cmp::{Ordering, Reverse};
 use std::collections::{BinaryHeap, HashMap};
 use std::fmt::Debug;
 use std::hash::Hash;
@@ -63,10 +63,17 @@ use std::hash::Hash;
 /// queue](https://en.wikipedia.org/wiki/Priority_queue) - this helps remove nodes in the desired
 /// order.
 ///
-/// Rust's standard library conveniently provides a priority queue as
-/// `std::collections::BinaryHeap`.  The `preferred_order` function is exposed
-/// to the `BinaryHeap` via the `Ord` implementation of the private `HeapNode`
-/// struct below.
+/// `preferred_order` is only used to sort `nodes` once (a stable sort, so ties
+/// are broken by the order of `nodes`).  The rest of the algorithm works with
+/// the positions in the sorted vector, so that the priority queue (Rust's
+/// `std::collections::BinaryHeap`) and the graph bookkeeping compare and index
+/// plain `usize`s instead of calling `preferred_order` and hashing `NodeId`s.
+/// This makes the whole algorithm `O(n log n + e)` and deterministic.
+///
+/// When the preferred order already *is* a topological order (which is the
+/// common case - e.g. when re-generating bindings after a small source edit),
+/// the result is the sorted `nodes` vector and the priority queue is skipped
+/// altogether.
 ///
 /// # Why not use an existing Cargo crate?
 ///
@@ -126,58 +133,107 @@ where
     NodeId: Clone + Debug + Eq + Hash,
     CmpFn: Fn(&NodeId, &NodeId) -> Ordering,
 {
-    // Translating `nodes` and `deps` into a `graph` that maps node ids into 1)
-    // `count_of_predecessors` and 2) a set of `successor` ids.
-    let mut graph: HashMap<NodeId, GraphNode<NodeId>> =
-        nodes.into_iter().map(|id| (id, GraphNode::default())).collect();
+    let mut nodes: Vec<NodeId> = nodes.into_iter().collect();
+    nodes.sort_by(preferred_order);
+    toposort_sorted_nodes(nodes, deps)
+}
+
+/// Like `toposort`, but the preferred order is given by the `key_fn` that is
+/// called only once per node (similarly to `slice::sort_by_cached_key`).  This
+/// should be preferred over `toposort` when comparing nodes is expensive (e.g.
+/// requires looking up their source spans).
+pub fn toposort_by_cached_key<NodeId, K, KeyFn>(
+    nodes: impl IntoIterator<Item = NodeId>,
+    deps: impl IntoIterator<Item = Dependency<NodeId>>,
+    key_fn: KeyFn,
+) -> TopoSortResult<NodeId>
+where
+    NodeId: Clone + Debug + Eq + Hash,
+    K: Ord,
+    KeyFn: FnMut(&NodeId) -> K,
+{
+    let mut nodes: Vec<NodeId> = nodes.into_iter().collect();
+    nodes.sort_by_cached_key(key_fn);
+    toposort_sorted_nodes(nodes, deps)
+}
+
+/// Implementation of `toposort` for `nodes` that are already sorted in the
+/// preferred order.
+fn toposort_sorted_nodes<NodeId>(
+    nodes: Vec<NodeId>,
+    deps: impl IntoIterator<Item = Dependency<NodeId>>,
+) -> TopoSortResult<NodeId>
+where
+    NodeId: Clone + Debug + Eq + Hash,
+{
+    // Translating `nodes` and `deps` into a `graph` that maps the positions of
+    // the nodes in the preferred order into 1) `count_of_predecessors` and 2) a
+    // list of positions of `successors`.
+    let index_of: HashMap<&NodeId, usize> =
+        nodes.iter().enumerate().map(|(index, id)| (id, index)).collect();
+    let mut graph: Vec<GraphNode> = (0..nodes.len()).map(|_| GraphNode::default()).collect();
+    let mut is_preferred_order_topological = true;
     for Dependency { predecessor, successor } in deps.into_iter() {
-        graph
-            .get_mut(&successor)
-            .unwrap_or_else(|| panic!(
+        let successor_index = *index_of.get(&successor).unwrap_or_else(|| {
+            panic!(
                 "`Dependency::successor` should refer to a NodeId in the `nodes` parameter. \
-                 predecessor = {predecessor:?}; successor = {successor:?}"))
-            .count_of_predecessors += 1;
-        graph
-            .get_mut(&predecessor)
-            .unwrap_or_else(|| panic!(
+                 predecessor = {predecessor:?}; successor = {successor:?}"
+            )
+        });
+        let predecessor_index = *index_of.get(&predecessor).unwrap_or_else(|| {
+            panic!(
                 "`Dependency::predecessor` should refer to a NodeId in the `nodes` parameter. \
-                 predecessor = {predecessor:?}; successor = {successor:?}"))
-            .successors
-            .push(successor);
+                 predecessor = {predecessor:?}; successor = {successor:?}"
+            )
+        });
+        is_preferred_order_topological &= predecessor_index < successor_index;
+        graph[successor_index].count_of_predecessors += 1;
+        graph[predecessor_index].successors.push(successor_index);
     }
 
-    // `ready` contains ids of nodes which have no remaining predecessors (and which
-    // therefore are ready to be added to the `ordered` result of the
-    // topological sort).  Using a BinaryHeap to store the `ready` nodes helps
-    // to extract them in the `preferred_order`.  (This is the `S` data structure from
-    // https://en.wikipedia.org/wiki/Topological_sorting#Kahn%27s_algorithm.)
-    let mut ready: BinaryHeap<HeapNode<'_, NodeId, CmpFn>> = graph
+    if is_preferred_order_topological {
+        return TopoSortResult { ordered: nodes, failed: vec![] };
+    }
+
+    // `ready` contains the positions of nodes which have no remaining
+    // predecessors (and which therefore are ready to be added to the `ordered`
+    // result of the topological sort).  Using a BinaryHeap to store the `ready`
+    // nodes helps to extract them in the preferred order.  (This is the `S` data
+    // structure from https://en.wikipedia.org/wiki/Topological_sorting#Kahn%27s_algorithm.)
+    let mut ready: BinaryHeap<Reverse<usize>> = graph
         .iter()
+        .enumerate()
         .filter(|(_, graph_node)| graph_node.count_of_predecessors == 0)
-        .map(|(id, _)| HeapNode { id: id.clone(), cmp_fn: &preferred_order })
+        .map(|(index, _)| Reverse(index))
         .collect();
 
-    // `ordered` contains the topologically ordered results.  (This is the `L` list
-    // from https://en.wikipedia.org/wiki/Topological_sorting#Kahn%27s_algorithm.)
-    let mut ordered: Vec<NodeId> = Vec::with_capacity(graph.len());
-    while let Some(HeapNode { id: removed_id, .. }) = ready.pop() {
-        let removed_graph_node = graph.remove(&removed_id).unwrap();
-        for succ_id in removed_graph_node.successors.into_iter() {
-            let succ = graph.get_mut(&succ_id).unwrap();
+    // `ordered_indices` contains the topologically ordered results.  (This is the
+    // `L` list from https://en.wikipedia.org/wiki/Topological_sorting#Kahn%27s_algorithm.)
+    let mut ordered_indices: Vec<usize> = Vec::with_capacity(graph.len());
+    while let Some(Reverse(removed_index)) = ready.pop() {
+        for succ_index in std::mem::take(&mut graph[removed_index].successors).into_iter() {
+            let succ = &mut graph[succ_index];
             assert!(succ.count_of_predecessors > 0);
             succ.count_of_predecessors -= 1;
             if succ.count_of_predecessors == 0 {
-                ready.push(HeapNode { id: succ_id, cmp_fn: &preferred_order });
+                ready.push(Reverse(succ_index));
             }
         }
-        ordered.push(removed_id);
+        graph[removed_index].is_ordered = true;
+        ordered_indices.push(removed_index);
     }
 
     // `failed` contains the remaining nodes - ones that either formed a dependency
     // cycle or (possibly indirectly) depended on a node participating in a
-    // cycle.
-    let mut failed: Vec<NodeId> = graph.into_keys().collect();
-    failed.sort_by(preferred_order);
+    // cycle.  Iterating over `nodes` keeps them in the preferred order.
+    let mut nodes: Vec<Option<NodeId>> = nodes.into_iter().map(Some).collect();
+    let ordered = ordered_indices.into_iter().map(|index| nodes[index].take().unwrap()).collect();
+    let failed = nodes
+        .into_iter()
+        .zip(graph)
+        .filter(|(_, graph_node)| !graph_node.is_ordered)
+        .map(|(id, _)| id.unwrap())
+        .collect();
 
     TopoSortResult { ordered, failed }
 }
@@ -201,63 +257,11 @@ pub struct TopoSortResult<NodeId> {
     pub failed: Vec<NodeId>,
 }
 
-struct GraphNode<NodeId> {
+#[derive(Default)]
+struct GraphNode {
     count_of_predecessors: usize,
-    successors: Vec<NodeId>,
-}
-
-// TODO(https://github.com/rust-lang/rust/issues/26925): It should be possible to
-// `#[derive(Default)]` here, but `derive` insists that `NodeId` has to
-// implement `Default` even though the default vector doesn't contain any
-// `NodeId`s.
-impl<NodeId> Default for GraphNode<NodeId> {
-    fn default() -> Self {
-        Self { count_of_predecessors: 0, successors: Vec::new() }
-    }
-}
-
-struct HeapNode<'a, NodeId, CmpFn>
-where
-    CmpFn: Fn(&NodeId, &NodeId) -> Ordering,
-{
-    id: NodeId,
-    cmp_fn: &'a CmpFn,
-}
-
-impl<'a, NodeId, CmpFn> Ord for HeapNode<'a, NodeId, CmpFn>
-where
-    CmpFn: Fn(&NodeId, &NodeId) -> Ordering,
-{
-    fn cmp(&self, other: &Self) -> Ordering {
-        // https://doc.rust-lang.org/stable/std/collections/struct.BinaryHeap.html#method.pop
-        // "removes the greatest item from the binary heap" and therefore to pop items
-        // in the `cmp_fn`-described preferred order we need to call `reverse()`
-        // below.
-        (self.cmp_fn)(&self.id, &other.id).reverse()
-    }
-}
-
-impl<'a, NodeId, CmpFn> PartialOrd for HeapNode<'a, NodeId, CmpFn>
-where
-    CmpFn: Fn(&NodeId, &NodeId) -> Ordering,
-{
-    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
-        Some(self.cmp(other))
-    }
-}
-
-impl<'a, NodeId, CmpFn> PartialEq for HeapNode<'a, NodeId, CmpFn>
-where
-    CmpFn: Fn(&NodeId, &NodeId) -> Ordering,
-{
-    fn eq(&self, other: &Self) -> bool {
-        self.cmp(other) == Ordering::Equal
-    }
-}
-
-impl<'a, NodeId, CmpFn> Eq for HeapNode<'a, NodeId, CmpFn> where
-    CmpFn: Fn(&NodeId, &NodeId) -> Ordering
-{
+    successors: Vec<usize>,
+    is_ordered: bool,
 }
 
 #[cfg(test)]
@@ -316,6 +320,61 @@ mod tests {
         assert_eq!(failed, vec![5, 6, 7]);
     }
 
+    #[test]
+    fn test_toposort_ties_keep_the_order_of_nodes() {
+        // All nodes compare as equal, so the order of `nodes` is the preferred order.
+        let result = super::toposort(
+            vec![4, 1, 3, 2],
+            vec![super::Dependency { predecessor: 2, successor: 3 }],
+            |_, _| std::cmp::Ordering::Equal,
+        );
+        assert_eq!(result.ordered, vec![4, 1, 2, 3]);
+        assert_eq!(result.failed, vec![]);
+    }
+
+    #[test]
+    fn test_toposort_by_cached_key() {
+        use super::{toposort_by_cached_key, Dependency};
+        let mut key_fn_calls = 0;
+        let result = toposort_by_cached_key(
+            vec![1, 2, 3, 4],
+            vec![Dependency { predecessor: 1, successor: 4 }],
+            |&id| {
+                key_fn_calls += 1;
+                -id
+            },
+        );
+        assert_eq!(result.ordered, vec![3, 2, 1, 4]);
+        assert_eq!(result.failed, vec![]);
+        assert_eq!(key_fn_calls, 4);
+    }
+
+    /// Test that `toposort` scales to the size of big crates with dense
+    /// dependency edges (this would time out with a quadratic implementation).
+    #[test]
+    fn test_toposort_large_graph() {
+        const N: i32 = 100_000;
+        let nodes: Vec<i32> = (0..N).collect();
+
+        // Each node depends on the next 4 nodes, so the preferred order needs to be
+        // reversed.
+        let deps: Vec<(i32, i32)> = (0..N)
+            .flat_map(|successor| {
+                (successor + 1..N.min(successor + 5))
+                    .map(move |predecessor| (predecessor, successor))
+            })
+            .collect();
+        let (ordered, failed) = toposort(&nodes, &deps);
+        assert_eq!(ordered, (0..N).rev().collect::<Vec<_>>());
+        assert_eq!(failed, vec![]);
+
+        // Dependencies that are compatible with the preferred order.
+        let deps: Vec<(i32, i32)> = deps.into_iter().map(|(lhs, rhs)| (rhs, lhs)).collect();
+        let (ordered, failed) = toposort(&nodes, &deps);
+        assert_eq!(ordered, nodes);
+        assert_eq!(failed, vec![]);
+    }
+
     #[test]
     fn test_example() {
         // TODO: Remove this test once rustdoc examples of the `toposort` function are
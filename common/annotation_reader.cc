@@ -7,6 +7,7 @@
 #include <optional>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -52,16 +53,51 @@ absl::StatusOr<absl::string_view> GetAnnotateArgAsStringLiteral(
   return {string_literal->getString()};
 }
 
+namespace {
+
+absl::Status RepeatedAttributeError(absl::string_view attribute) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Only one `", attribute,
+                   "` attribute may be placed on a declaration."));
+}
+
+std::optional<std::string> GetStringArg(
+    const absl::StatusOr<const clang::AnnotateAttr*>& attr,
+    const clang::ASTContext& ast_context) {
+  if (!attr.ok() || *attr == nullptr) {
+    return std::nullopt;
+  }
+  absl::StatusOr<absl::string_view> arg =
+      GetAnnotateArgAsStringLiteral(**attr, ast_context);
+  if (!arg.ok()) {
+    return std::nullopt;
+  }
+  return std::string(*arg);
+}
+
+absl::Status RequireSingleStringArg(
+    const absl::StatusOr<const clang::AnnotateAttr*>& attr,
+    const clang::ASTContext& ast_context, absl::string_view attribute) {
+  if (!attr.ok() || *attr == nullptr) {
+    return absl::OkStatus();
+  }
+  if (attr.value()->args_size() != 1 ||
+      !GetAnnotateArgAsStringLiteral(**attr, ast_context).ok()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Attribute ", attribute, " must have a single string argument."));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
 absl::StatusOr<const clang::AnnotateAttr*> GetAnnotateAttr(
     const clang::Decl& decl, absl::string_view attribute) {
   const clang::AnnotateAttr* found_attr = nullptr;
   for (clang::AnnotateAttr* attr : decl.specific_attrs<clang::AnnotateAttr>()) {
     if (attr->getAnnotation() != llvm::StringRef(attribute)) continue;
 
-    if (found_attr != nullptr)
-      return absl::InvalidArgumentError(
-          absl::StrCat("Only one `", attribute,
-                       "` attribute may be placed on a declaration."));
+    if (found_attr != nullptr) return RepeatedAttributeError(attribute);
     found_attr = attr;
   }
   return found_attr;
@@ -69,38 +105,54 @@ absl::StatusOr<const clang::AnnotateAttr*> GetAnnotateAttr(
 
 std::optional<std::string> GetAnnotateArgAsStringByAttribute(
     const clang::Decl* decl, absl::string_view attribute) {
-  absl::StatusOr<const clang::AnnotateAttr*> bridging_type_annotation =
-      GetAnnotateAttr(*decl, attribute);
-  if (!bridging_type_annotation.ok() || *bridging_type_annotation == nullptr) {
-    return std::nullopt;
-  }
-  absl::StatusOr<absl::string_view> bridging_type =
-      GetAnnotateArgAsStringLiteral(**bridging_type_annotation,
-                                    decl->getASTContext());
-  if (!bridging_type.ok()) {
-    return std::nullopt;
-  }
-  return std::string(*bridging_type);
+  return GetStringArg(GetAnnotateAttr(*decl, attribute),
+                      decl->getASTContext());
 }
 
 absl::Status RequireSingleStringArgIfExists(const clang::Decl* decl,
                                             absl::string_view attribute) {
-  absl::StatusOr<const clang::AnnotateAttr*> attr =
-      GetAnnotateAttr(*decl, attribute);
-  if (!attr.ok() || *attr == nullptr) {
-    return absl::OkStatus();
-  }
-  if (attr.value()->args_size() != 1) {
-    return absl::InvalidArgumentError(absl::StrCat(
-        "Attribute ", attribute, " must have a single string argument."));
-  }
-  absl::StatusOr<absl::string_view> arg =
-      GetAnnotateArgAsStringLiteral(**attr, decl->getASTContext());
-  if (!arg.ok()) {
-    return absl::InvalidArgumentError(absl::StrCat(
-        "Attribute ", attribute, " must have a single string argument."));
+  return RequireSingleStringArg(GetAnnotateAttr(*decl, attribute),
+                                decl->getASTContext(), attribute);
+}
+
+AnnotateAttrIndex::AnnotateAttrIndex(const clang::Decl& decl)
+    : ast_context_(decl.getASTContext()) {
+  for (const clang::AnnotateAttr* attr :
+       decl.specific_attrs<clang::AnnotateAttr>()) {
+    llvm::StringRef annotation = attr->getAnnotation();
+    auto [it, inserted] = attrs_.try_emplace(
+        absl::string_view(annotation.data(), annotation.size()),
+        Entry{.attr = attr, .is_repeated = false});
+    if (!inserted) it->second.is_repeated = true;
   }
-  return absl::OkStatus();
+}
+
+absl::StatusOr<const clang::AnnotateAttr*> AnnotateAttrIndex::Get(
+    absl::string_view attribute) const {
+  auto it = attrs_.find(attribute);
+  if (it == attrs_.end()) return nullptr;
+  if (it->second.is_repeated) return RepeatedAttributeError(attribute);
+  return it->second.attr;
+}
+
+absl::StatusOr<bool> AnnotateAttrIndex::HasWithoutArgs(
+    absl::string_view attribute) const {
+  absl::StatusOr<const clang::AnnotateAttr*> attr = Get(attribute);
+  if (!attr.ok()) return attr.status();
+  if (*attr != nullptr && (*attr)->args_size() != 0)
+    return absl::InvalidArgumentError(
+        absl::StrCat("The `", attribute, "` attribute takes no arguments."));
+  return *attr != nullptr;
+}
+
+std::optional<std::string> AnnotateAttrIndex::GetArgAsString(
+    absl::string_view attribute) const {
+  return GetStringArg(Get(attribute), ast_context_);
+}
+
+absl::Status AnnotateAttrIndex::RequireSingleStringArgIfExists(
+    absl::string_view attribute) const {
+  return RequireSingleStringArg(Get(attribute), ast_context_, attribute);
 }
 
 }  // namespace crubit
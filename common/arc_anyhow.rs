@@ -58,11 +58,32 @@ impl Error {
         if let Some(e) = e.downcast_ref::<StdError>() { e.0.root_cause() } else { e }
     }
 
+    /// Wraps this error with a higher-level `context` message.
+    ///
+    /// Similar to [`anyhow::Error::context`], but cheaper: the new frame
+    /// refers to this error's `Arc` directly, rather than boxing it into
+    /// another `anyhow::Error` first.
     pub fn context<C>(self, context: C) -> Self
     where
         C: Display + Send + Sync + 'static,
     {
-        self.into_anyhow().context(context).into()
+        anyhow::Error::from(ContextError { context, source: StdError(self.0) }).into()
+    }
+
+    /// Wraps this error with a context message that is only formatted when the
+    /// error is displayed.
+    ///
+    /// This is for contexts with runtime parameters on paths where most errors
+    /// are handled without ever being displayed. For example:
+    ///
+    /// ```ignore
+    /// err.with_lazy_context(move |f| write!(f, "Failed to format parameter {i}"))
+    /// ```
+    pub fn with_lazy_context<F>(self, f: F) -> Self
+    where
+        F: Fn(&mut std::fmt::Formatter<'_>) -> std::fmt::Result + Send + Sync + 'static,
+    {
+        self.context(LazyContext(f))
     }
 
     pub fn downcast_ref<E>(&self) -> Option<&E>
@@ -141,6 +162,49 @@ impl From<Error> for StdError {
     }
 }
 
+/// A context frame added by [`Error::context`].
+///
+/// Displays as `context`, with `source` as the next error in the chain, like
+/// the frames that `anyhow::Error::context` creates.
+struct ContextError<C> {
+    context: C,
+    source: StdError,
+}
+
+impl<C: Display> Display for ContextError<C> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> Result<(), std::fmt::Error> {
+        Display::fmt(&self.context, f)
+    }
+}
+
+impl<C: Display> Debug for ContextError<C> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> Result<(), std::fmt::Error> {
+        f.debug_struct("Error")
+            .field("context", &self.context.to_string())
+            .field("source", &self.source)
+            .finish()
+    }
+}
+
+impl<C: Display> std::error::Error for ContextError<C> {
+    fn source(&self) -> Option<&(dyn std::error::Error + 'static)> {
+        Some(&self.source)
+    }
+}
+
+/// A context message that is formatted by calling a closure, each time it is
+/// displayed.
+struct LazyContext<F>(F);
+
+impl<F> Display for LazyContext<F>
+where
+    F: Fn(&mut std::fmt::Formatter<'_>) -> std::fmt::Result,
+{
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> Result<(), std::fmt::Error> {
+        (self.0)(f)
+    }
+}
+
 pub type Result<T, E = Error> = std::result::Result<T, E>;
 
 /// A replacement for anyhow::Context.
@@ -155,6 +219,16 @@ pub trait Context<T, E> {
     where
         C: Display + Send + Sync + 'static,
         F: FnOnce() -> C;
+
+    /// Like [`Context::with_context`], but the context is only formatted when
+    /// the error is displayed. See [`Error::with_lazy_context`].
+    fn with_lazy_context<F>(self, f: F) -> Result<T, Error>
+    where
+        Self: Sized,
+        F: Fn(&mut std::fmt::Formatter<'_>) -> std::fmt::Result + Send + Sync + 'static,
+    {
+        self.context(LazyContext(f))
+    }
 }
 
 // Note: can't use `where Result<T, E>: anyhow::Context<T, E>` due to coherence
@@ -201,16 +275,14 @@ impl<T> Context<T, Error> for Result<T, Error> {
     where
         C: Display + Send + Sync + 'static,
     {
-        let e: Result<T, StdError> = self.map_err(|e| e.into());
-        e.context(context)
+        self.map_err(|e| e.context(context))
     }
     fn with_context<C, F>(self, f: F) -> Result<T, Error>
     where
         C: Display + Send + Sync + 'static,
         F: FnOnce() -> C,
     {
-        let e: Result<T, StdError> = self.map_err(|e| e.into());
-        e.with_context(f)
+        self.map_err(|e| e.context(f()))
     }
 }
 
@@ -313,6 +385,25 @@ mod tests {
         );
     }
 
+    #[gtest]
+    fn test_lazy_context() {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+        let calls = Arc::new(AtomicUsize::new(0));
+        let calls_in_context = calls.clone();
+        let result: AAResult<()> = AAResult::Err(anyhow!("Something went wrong!"))
+            .with_lazy_context(move |f| {
+                calls_in_context.fetch_add(1, Ordering::Relaxed);
+                write!(f, "context {}", 1)
+            })
+            .context("context 2");
+        let err = result.unwrap_err();
+        assert_eq!(calls.load(Ordering::Relaxed), 0);
+
+        assert_eq!(&format!("{err:#}"), "context 2: context 1: Something went wrong!",);
+        assert_eq!(calls.load(Ordering::Relaxed), 1);
+        assert_eq!(&format!("{}", err.root_cause()), "Something went wrong!");
+    }
+
     #[gtest]
     fn test_macro_anyhow() {
         assert_eq!(&format!("{}", anyhow!("message")), "message");
@@ -3,14 +3,14 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 use arc_anyhow::{anyhow, ensure, Result};
-use proc_macro2::{Ident, TokenStream};
+use proc_macro2::{Ident, Span, TokenStream};
 use quote::{format_ident, quote, ToTokens};
-use std::collections::{BTreeSet, HashSet};
+use std::collections::BTreeSet;
+use std::fmt::Write as _;
 use std::rc::Rc;
-use std::sync::LazyLock;
 
 pub fn is_cpp_reserved_keyword(ident: &str) -> bool {
-    RESERVED_CC_KEYWORDS.contains(ident)
+    is_reserved_cc_keyword(ident)
 }
 
 /// Formats a C++ (qualified) identifier. Returns an error when `ident` is a C++
@@ -22,7 +22,7 @@ pub fn format_cc_ident(ident: &str) -> Result<TokenStream> {
     // https://doc.rust-lang.org/rust-by-example/compatibility/raw_identifiers.html and therefore
     // an error is returned when `ident` is a C++ reserved keyword.
     ensure!(
-        !RESERVED_CC_KEYWORDS.contains(ident),
+        !is_reserved_cc_keyword(ident),
         "`{}` is a C++ reserved keyword and can't be used as a C++ identifier",
         ident
     );
@@ -37,6 +37,11 @@ pub fn format_cc_ident(ident: &str) -> Result<TokenStream> {
         "The following character can't be used as a start of a C++ identifier: {first_char}",
     );
 
+    // Fast path for the common case, which avoids running the lexer.
+    if is_plain_ascii_identifier(ident) {
+        return Ok(Ident::new(ident, Span::call_site()).into_token_stream());
+    }
+
     ident.parse().map_err(
         // Explicitly mapping the error via `anyhow!`, because `LexError` is not `Sync`
         // (required for `anyhow::Error` to implement `From<LexError>`) and
@@ -48,11 +53,13 @@ pub fn format_cc_ident(ident: &str) -> Result<TokenStream> {
 /// Makes an 'Ident' to be used in the Rust source code. Escapes Rust keywords.
 /// Panics if `ident` is empty or is otherwise an invalid identifier.
 pub fn make_rs_ident(ident: &str) -> Ident {
-    // TODO(https://github.com/dtolnay/syn/pull/1098): Remove the hardcoded list once syn recognizes
-    // 2018 and 2021 keywords.
-    if ["async", "await", "try", "dyn"].contains(&ident) {
+    if is_reserved_rust_keyword(ident) {
         return format_ident!("r#{}", ident);
     }
+    // Fast path for the common case, which avoids running `syn`'s parser.
+    if is_plain_ascii_identifier(ident) {
+        return Ident::new(ident, Span::call_site());
+    }
     match syn::parse_str::<syn::Ident>(ident) {
         Ok(_) => format_ident!("{}", ident),
         Err(_) => format_ident!("r#{}", ident),
@@ -95,8 +102,7 @@ pub fn escape_non_identifier_chars(symbol: &str) -> String {
                 if is_valid_identifier_char {
                     result.push(c);
                 } else {
-                    result.push_str("_x");
-                    result.push_str(&format!("{:08x}", c as u32));
+                    write!(result, "_x{:08x}", c as u32).unwrap();
                 };
             }
         }
@@ -275,110 +281,181 @@ pub fn format_cc_includes(set_of_includes: &BTreeSet<CcInclude>) -> TokenStream
     tokens
 }
 
-static RESERVED_CC_KEYWORDS: LazyLock<HashSet<&'static str>> = LazyLock::new(|| {
-    // `RESERVED_CC_KEYWORDS` are based on https://en.cppreference.com/w/cpp/keyword
-    [
-        "alignas",
-        "alignof",
-        "and",
-        "and_eq",
-        "asm",
-        "atomic_cancel",
-        "atomic_commit",
-        "atomic_noexcept",
-        "auto",
-        "bitand",
-        "bitor",
-        "bool",
-        "break",
-        "case",
-        "catch",
-        "char",
-        "char8_t",
-        "char16_t",
-        "char32_t",
-        "class",
-        "compl",
-        "concept",
-        "const",
-        "consteval",
-        "constexpr",
-        "constinit",
-        "const_cast",
-        "continue",
-        "co_await",
-        "co_return",
-        "co_yield",
-        "decltype",
-        "default",
-        "delete",
-        "do",
-        "double",
-        "dynamic_cast",
-        "else",
-        "enum",
-        "explicit",
-        "export",
-        "extern",
-        "false",
-        "float",
-        "for",
-        "friend",
-        "goto",
-        "if",
-        "inline",
-        "int",
-        "long",
-        "mutable",
-        "namespace",
-        "new",
-        "noexcept",
-        "not",
-        "not_eq",
-        "nullptr",
-        "operator",
-        "or",
-        "or_eq",
-        "private",
-        "protected",
-        "public",
-        "reflexpr",
-        "register",
-        "reinterpret_cast",
-        "requires",
-        "return",
-        "short",
-        "signed",
-        "sizeof",
-        "static",
-        "static_assert",
-        "static_cast",
-        "struct",
-        "switch",
-        "synchronized",
-        "template",
-        "this",
-        "thread_local",
-        "throw",
-        "true",
-        "try",
-        "typedef",
-        "typeid",
-        "typename",
-        "union",
-        "unsigned",
-        "using",
-        "virtual",
-        "void",
-        "volatile",
-        "wchar_t",
-        "while",
-        "xor",
-        "xor_eq",
-    ]
-    .into_iter()
-    .collect()
-});
+/// Returns whether `ident` is a reserved C++ keyword. The `match` compiles into a
+/// decision tree over the string, without hashing or allocating.
+fn is_reserved_cc_keyword(ident: &str) -> bool {
+    // Based on https://en.cppreference.com/w/cpp/keyword
+    matches!(
+        ident,
+        "alignas"
+            | "alignof"
+            | "and"
+            | "and_eq"
+            | "asm"
+            | "atomic_cancel"
+            | "atomic_commit"
+            | "atomic_noexcept"
+            | "auto"
+            | "bitand"
+            | "bitor"
+            | "bool"
+            | "break"
+            | "case"
+            | "catch"
+            | "char"
+            | "char8_t"
+            | "char16_t"
+            | "char32_t"
+            | "class"
+            | "compl"
+            | "concept"
+            | "const"
+            | "consteval"
+            | "constexpr"
+            | "constinit"
+            | "const_cast"
+            | "continue"
+            | "co_await"
+            | "co_return"
+            | "co_yield"
+            | "decltype"
+            | "default"
+            | "delete"
+            | "do"
+            | "double"
+            | "dynamic_cast"
+            | "else"
+            | "enum"
+            | "explicit"
+            | "export"
+            | "extern"
+            | "false"
+            | "float"
+            | "for"
+            | "friend"
+            | "goto"
+            | "if"
+            | "inline"
+            | "int"
+            | "long"
+            | "mutable"
+            | "namespace"
+            | "new"
+            | "noexcept"
+            | "not"
+            | "not_eq"
+            | "nullptr"
+            | "operator"
+            | "or"
+            | "or_eq"
+            | "private"
+            | "protected"
+            | "public"
+            | "reflexpr"
+            | "register"
+            | "reinterpret_cast"
+            | "requires"
+            | "return"
+            | "short"
+            | "signed"
+            | "sizeof"
+            | "static"
+            | "static_assert"
+            | "static_cast"
+            | "struct"
+            | "switch"
+            | "synchronized"
+            | "template"
+            | "this"
+            | "thread_local"
+            | "throw"
+            | "true"
+            | "try"
+            | "typedef"
+            | "typeid"
+            | "typename"
+            | "union"
+            | "unsigned"
+            | "using"
+            | "virtual"
+            | "void"
+            | "volatile"
+            | "wchar_t"
+            | "while"
+            | "xor"
+            | "xor_eq"
+    )
+}
+
+/// Returns whether `syn` refuses to parse `ident` as an identifier, i.e. whether it
+/// needs to be written as a raw identifier.
+fn is_reserved_rust_keyword(ident: &str) -> bool {
+    // Based on `syn`'s `accept_as_ident` (and
+    // https://doc.rust-lang.org/1.65.0/reference/keywords.html).
+    matches!(
+        ident,
+        "_" | "abstract"
+            | "as"
+            | "async"
+            | "await"
+            | "become"
+            | "box"
+            | "break"
+            | "const"
+            | "continue"
+            | "crate"
+            | "do"
+            | "dyn"
+            | "else"
+            | "enum"
+            | "extern"
+            | "false"
+            | "final"
+            | "fn"
+            | "for"
+            | "if"
+            | "impl"
+            | "in"
+            | "let"
+            | "loop"
+            | "macro"
+            | "match"
+            | "mod"
+            | "move"
+            | "mut"
+            | "override"
+            | "priv"
+            | "pub"
+            | "ref"
+            | "return"
+            | "Self"
+            | "self"
+            | "static"
+            | "struct"
+            | "super"
+            | "trait"
+            | "true"
+            | "try"
+            | "type"
+            | "typeof"
+            | "unsafe"
+            | "unsized"
+            | "use"
+            | "virtual"
+            | "where"
+            | "while"
+            | "yield"
+    )
+}
+
+/// Returns whether `ident` consists of ASCII letters, digits and underscores,
+/// and doesn't start with a digit. Such identifiers can be turned into an `Ident`
+/// directly, without running a lexer or parser.
+fn is_plain_ascii_identifier(ident: &str) -> bool {
+    let mut bytes = ident.bytes();
+    matches!(bytes.next(), Some(b'a'..=b'z' | b'A'..=b'Z' | b'_'))
+        && bytes.all(|b| b.is_ascii_alphanumeric() || b == b'_')
+}
 
 #[cfg(test)]
 pub mod tests {
@@ -503,6 +580,19 @@ pub mod tests {
         assert_rs_matches!(quote! { #id }, quote! { r#impl });
     }
 
+    #[gtest]
+    fn test_make_rs_ident_agrees_with_syn() {
+        for ident in
+            ["foo", "Foo_1", "_x", "__", "r", "raw", "gen", "union", "fn", "async", "yield"]
+        {
+            let expected = match syn::parse_str::<syn::Ident>(ident) {
+                Ok(_) => ident.to_string(),
+                Err(_) => format!("r#{ident}"),
+            };
+            assert_eq!(make_rs_ident(ident).to_string(), expected, "{ident}");
+        }
+    }
+
     #[gtest]
     #[should_panic]
     fn test_make_rs_ident_unfinished_group() {
@@ -7,6 +7,7 @@ use std::borrow::Cow;
 use std::cell::RefCell;
 use std::collections::BTreeMap;
 use std::fmt::{self, Arguments, Display, Formatter};
+use std::sync::LazyLock;
 
 use serde::Serialize;
 
@@ -136,16 +137,22 @@ impl ErrorReporting for IgnoreErrors {
 }
 
 fn hide_unstable_details(input: &str) -> String {
+    static DEF_ID_PREFIX: LazyLock<Regex> =
+        LazyLock::new(|| Regex::new(r"DefId\(\d+:\d+ ~ ").unwrap());
+    static HASH: LazyLock<Regex> = LazyLock::new(|| Regex::new(r"\[[0-9a-fA-F]{4}\]").unwrap());
+
     // Remove line:column in def id
-    let regex = Regex::new(r"DefId\(\d+:\d+ ~ ").unwrap();
-    let res = regex.replace_all(input, "DefId(").to_string();
+    let res = DEF_ID_PREFIX.replace_all(input, "DefId(");
 
     // Remove all hash id in the def id
-    let regex = Regex::new(r"\[[0-9a-fA-F]{4}\]").unwrap();
-    regex.replace_all(res.as_str(), "").to_string()
+    HASH.replace_all(&res, "").into_owned()
 }
 
 /// An aggregate of zero or more errors.
+///
+/// Inserting an error only counts it (and keeps a reference to the first error
+/// with each format string); the sample messages are only rendered when the
+/// report is serialized.
 #[derive(Default, Debug)]
 pub struct ErrorReport {
     // The interior mutability / borrow_mut will never panic: it is never borrowed for longer than
@@ -157,52 +164,59 @@ impl ErrorReport {
     pub fn new() -> Self {
         Self::default()
     }
+
+    fn serializable_map(&self) -> BTreeMap<Cow<'static, str>, SerializedErrorReportEntry> {
+        self.map.borrow().iter().map(|(fmt, entry)| (fmt.clone(), entry.to_serialized())).collect()
+    }
 }
 
 impl ErrorReporting for ErrorReport {
     fn insert(&self, error: &arc_anyhow::Error) {
-        let root_cause = error.root_cause();
-        if let Some(error) = root_cause.downcast_ref::<FormattedError>() {
-            let sample_message = if error.message != error.fmt { &*error.message } else { "" };
-            self.map
-                .borrow_mut()
-                .entry(error.fmt.clone())
-                .or_default()
-                .add(Cow::Owned(hide_unstable_details(sample_message)));
+        let root_cause = error.root_cause().downcast_ref::<FormattedError>();
+        let fmt: &str = root_cause.map_or("{}", |root_cause| &*root_cause.fmt);
+        let mut map = self.map.borrow_mut();
+        if let Some(entry) = map.get_mut(fmt) {
+            entry.count += 1;
         } else {
-            self.map
-                .borrow_mut()
-                .entry(Cow::Borrowed("{}"))
-                .or_default()
-                .add(Cow::Owned(hide_unstable_details(&format!("{error}"))));
+            let fmt = root_cause.map_or(Cow::Borrowed("{}"), |root_cause| root_cause.fmt.clone());
+            map.insert(fmt, ErrorReportEntry { count: 1, sample: error.clone() });
         }
     }
 
     fn serialize_to_vec(&self) -> anyhow::Result<Vec<u8>> {
-        Ok(serde_json::to_vec(&*self.map.borrow())?)
+        Ok(serde_json::to_vec(&self.serializable_map())?)
     }
 
     fn serialize_to_string(&self) -> anyhow::Result<String> {
-        Ok(serde_json::to_string_pretty(&*self.map.borrow())?)
+        Ok(serde_json::to_string_pretty(&self.serializable_map())?)
     }
 }
 
-#[derive(Default, Debug, Serialize)]
+#[derive(Debug)]
 struct ErrorReportEntry {
     count: u64,
-    #[serde(skip_serializing_if = "String::is_empty")]
-    sample_message: String,
+    /// The first error with this format string.
+    sample: arc_anyhow::Error,
 }
 
 impl ErrorReportEntry {
-    fn add(&mut self, message: Cow<str>) {
-        if self.count == 0 {
-            self.sample_message = message.into_owned();
-        }
-        self.count += 1;
+    fn to_serialized(&self) -> SerializedErrorReportEntry {
+        let sample_message = match self.sample.root_cause().downcast_ref::<FormattedError>() {
+            Some(error) if error.message != error.fmt => hide_unstable_details(&error.message),
+            Some(_) => String::new(),
+            None => hide_unstable_details(&format!("{}", self.sample)),
+        };
+        SerializedErrorReportEntry { count: self.count, sample_message }
     }
 }
 
+#[derive(Debug, Serialize)]
+struct SerializedErrorReportEntry {
+    count: u64,
+    #[serde(skip_serializing_if = "String::is_empty")]
+    sample_message: String,
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -423,6 +437,23 @@ mod tests {
     "count": 1,
     "sample_message": "not attributed"
   }
+}"#,
+        );
+    }
+
+    #[gtest]
+    fn error_report_hides_unstable_details() {
+        let report = ErrorReport::new();
+        report.insert(&anyhow!("unsupported item: {}", "DefId(0:12 ~ krate[1a2b]::f)"));
+        report.insert(&anyhow!("unsupported item: {}", "DefId(0:13 ~ krate[1a2b]::g)"));
+
+        assert_eq!(
+            report.serialize_to_string().unwrap(),
+            r#"{
+  "unsupported item: {}": {
+    "count": 2,
+    "sample_message": "unsupported item: DefId(krate::f)"
+  }
 }"#,
         );
     }
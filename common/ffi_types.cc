@@ -19,4 +19,17 @@ absl::string_view StringViewFromFfiU8Slice(FfiU8Slice ffi_u8_slice) {
   return absl::string_view(ffi_u8_slice.ptr, ffi_u8_slice.size);
 }
 
+UniqueFfiU8SliceBox& UniqueFfiU8SliceBox::operator=(
+    UniqueFfiU8SliceBox&& other) noexcept {
+  if (this != &other) {
+    UniqueFfiU8SliceBox old(release());
+    box_ = other.release();
+  }
+  return *this;
+}
+
+UniqueFfiU8SliceBox::~UniqueFfiU8SliceBox() {
+  if (box_.ptr != nullptr) FreeFfiU8SliceBox(box_);
+}
+
 }  // namespace crubit
@@ -39,6 +39,42 @@ extern "C" FfiU8SliceBox AllocFfiU8SliceBox(FfiU8Slice ffi_u8_slice);
 // Implemented in Rust.
 extern "C" void FreeFfiU8SliceBox(FfiU8SliceBox);
 
+// Owns an `FfiU8SliceBox`, and frees it with `FreeFfiU8SliceBox` when
+// destroyed. This lets C++ use the bytes that Rust allocated (e.g. generated
+// source code, which can be tens of MB) without copying them into a
+// `std::string`.
+class UniqueFfiU8SliceBox {
+ public:
+  UniqueFfiU8SliceBox() = default;
+  explicit UniqueFfiU8SliceBox(FfiU8SliceBox box) : box_(box) {}
+
+  UniqueFfiU8SliceBox(UniqueFfiU8SliceBox&& other) noexcept
+      : box_(other.release()) {}
+  UniqueFfiU8SliceBox& operator=(UniqueFfiU8SliceBox&& other) noexcept;
+  UniqueFfiU8SliceBox(const UniqueFfiU8SliceBox&) = delete;
+  UniqueFfiU8SliceBox& operator=(const UniqueFfiU8SliceBox&) = delete;
+
+  ~UniqueFfiU8SliceBox();
+
+  // Returns a `string_view` referencing the owned bytes, which is valid for as
+  // long as `*this` is neither destroyed nor assigned to.
+  absl::string_view view() const {
+    return absl::string_view(box_.ptr, box_.size);
+  }
+
+  // Gives up the ownership of the bytes, which the caller then has to free by
+  // calling `FreeFfiU8SliceBox()`.
+  FfiU8SliceBox release() {
+    FfiU8SliceBox box = box_;
+    box_ = {nullptr, 0};
+    return box;
+  }
+
+ private:
+  // `ptr` is null if there is nothing to free.
+  FfiU8SliceBox box_ = {nullptr, 0};
+};
+
 // Whether or not the generated binding will have doc comments indicating their
 // source location.
 enum SourceLocationDocComment {
@@ -46,6 +82,19 @@ enum SourceLocationDocComment {
   Enabled,
 };
 
+// How the generated bindings are formatted.
+enum GeneratedCodeFormatting {
+  // Run `rustfmt` on the whole Rust file and `clang-format` on the whole C++
+  // file.
+  ExternalFormatters,
+  // Like `ExternalFormatters`, but split the Rust file into chunks of
+  // top-level items that are formatted by concurrent `rustfmt` processes.
+  ExternalFormattersInChunks,
+  // Don't run external formatters, and use Crubit's built-in pretty-printer
+  // instead.
+  BuiltinPrettyPrinter,
+};
+
 }  // namespace crubit
 
 #endif  // CRUBIT_COMMON_FFI_TYPES_H_
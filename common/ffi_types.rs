@@ -100,6 +100,21 @@ pub enum SourceLocationDocComment {
     Enabled,
 }
 
+/// How the generated bindings are formatted.
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub enum GeneratedCodeFormatting {
+    /// Run `rustfmt` on the whole Rust file and `clang-format` on the whole
+    /// C++ file.
+    ExternalFormatters,
+    /// Like `ExternalFormatters`, but split the Rust file into chunks of
+    /// top-level items that are formatted by concurrent `rustfmt` processes.
+    ExternalFormattersInChunks,
+    /// Don't run external formatters, and use Crubit's built-in
+    /// pretty-printer instead.
+    BuiltinPrettyPrinter,
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
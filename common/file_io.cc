@@ -7,19 +7,38 @@
 #include <memory>
 #include <string>
 #include <system_error>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace crubit {
 
+absl::StatusOr<FileView> GetFileView(absl::string_view path) {
+  // Without a null terminator, the buffer can be memory-mapped regardless of
+  // the size of the file.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> err_or_buffer =
+      llvm::MemoryBuffer::getFileOrSTDIN(llvm::StringRef(path.data(),
+                                                         path.size()),
+                                         /*IsText=*/false,
+                                         /*RequiresNullTerminator=*/false);
+  if (std::error_code err = err_or_buffer.getError()) {
+    return absl::Status(absl::StatusCode::kInternal, err.message());
+  }
+  return FileView(std::move(*err_or_buffer));
+}
+
 absl::StatusOr<std::string> GetFileContents(absl::string_view path) {
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> err_or_buffer =
-      llvm::MemoryBuffer::getFileOrSTDIN(path.data(), /* IsText= */ true);
+      llvm::MemoryBuffer::getFileOrSTDIN(
+          llvm::StringRef(path.data(), path.size()), /* IsText= */ true);
   if (std::error_code err = err_or_buffer.getError()) {
     return absl::Status(absl::StatusCode::kInternal, err.message());
   }
@@ -27,14 +46,16 @@ absl::StatusOr<std::string> GetFileContents(absl::string_view path) {
   return std::string((*err_or_buffer)->getBuffer());
 }
 
-absl::Status SetFileContents(absl::string_view path,
-                             absl::string_view contents) {
+namespace {
+
+// Writes `contents` to the stream for `path`.
+absl::Status WriteToStream(llvm::StringRef path, absl::string_view contents) {
   std::error_code error_code;
   llvm::raw_fd_ostream stream(path, error_code);
   if (error_code) {
     return absl::Status(absl::StatusCode::kInternal, error_code.message());
   }
-  stream << contents;
+  stream << llvm::StringRef(contents.data(), contents.size());
   stream.close();
   if (stream.has_error()) {
     return absl::Status(absl::StatusCode::kInternal, stream.error().message());
@@ -42,4 +63,46 @@ absl::Status SetFileContents(absl::string_view path,
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status SetFileContents(absl::string_view path,
+                             absl::string_view contents) {
+  llvm::StringRef path_ref(path.data(), path.size());
+  llvm::sys::fs::file_status status;
+  bool exists = !llvm::sys::fs::status(path_ref, status);
+  // Stdout ("-") and special files such as /dev/null can't be replaced.
+  if (path_ref == "-" || (exists && !llvm::sys::fs::is_regular_file(status))) {
+    return WriteToStream(path_ref, contents);
+  }
+  // Only read the existing file if its size matches.
+  if (exists && status.getSize() == contents.size()) {
+    absl::StatusOr<FileView> view = GetFileView(path);
+    if (view.ok() && view->contents() == contents) return absl::OkStatus();
+  }
+
+  // Write to a temporary file next to `path` and rename it, so that readers
+  // never see a partially written file.
+  llvm::SmallString<256> temp_path;
+  int fd;
+  if (std::error_code error_code = llvm::sys::fs::createUniqueFile(
+          path_ref + ".tmp-%%%%%%", fd, temp_path)) {
+    return absl::Status(absl::StatusCode::kInternal, error_code.message());
+  }
+  {
+    llvm::raw_fd_ostream stream(fd, /*shouldClose=*/true);
+    stream << llvm::StringRef(contents.data(), contents.size());
+    stream.close();
+    if (stream.has_error()) {
+      llvm::sys::fs::remove(temp_path);
+      return absl::Status(absl::StatusCode::kInternal,
+                          stream.error().message());
+    }
+  }
+  if (std::error_code error_code = llvm::sys::fs::rename(temp_path, path_ref)) {
+    llvm::sys::fs::remove(temp_path);
+    return absl::Status(absl::StatusCode::kInternal, error_code.message());
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace crubit
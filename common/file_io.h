@@ -5,16 +5,43 @@
 #ifndef CRUBIT_COMMON_FILE_IO_H_
 #define CRUBIT_COMMON_FILE_IO_H_
 
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 namespace crubit {
 
+// The contents of a file, without copying them: large files are memory-mapped.
+// The contents stay valid for the lifetime of the view, even if the file is
+// replaced by `SetFileContents` in the meantime.
+class FileView {
+ public:
+  explicit FileView(std::unique_ptr<llvm::MemoryBuffer> buffer)
+      : buffer_(std::move(buffer)) {}
+
+  absl::string_view contents() const {
+    return absl::string_view(buffer_->getBufferStart(),
+                             buffer_->getBufferSize());
+  }
+
+ private:
+  std::unique_ptr<llvm::MemoryBuffer> buffer_;
+};
+
+// Returns a view of the contents of `path` ("-" for stdin).
+absl::StatusOr<FileView> GetFileView(absl::string_view path);
+
 absl::StatusOr<std::string> GetFileContents(absl::string_view path);
 
+// Writes `contents` to `path`, unless the file already has these contents, in
+// which case it is left untouched (so that its modification time doesn't
+// change). The file is replaced atomically: the contents are written to a
+// temporary file, which is then renamed to `path`.
 absl::Status SetFileContents(absl::string_view path,
                              absl::string_view contents);
 
@@ -0,0 +1,100 @@
+#!/bin/bash
+# Part of the Crubit project, under the Apache License v2.0 with LLVM
+# Exceptions. See /LICENSE for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Checks that the generated bindings of golden tests don't grow beyond the
+# metrics recorded in a metrics file:
+#
+#   golden_metrics_test.sh METRICS_FILE (NAME RS_API_FILE RS_API_IMPL_FILE)...
+#
+# The metrics file has one line per golden test:
+#
+#   NAME THUNKS RS_API_BYTES RS_API_IMPL_BYTES STATIC_ASSERTIONS
+#
+# A metric may grow by up to $GOLDEN_METRICS_MAX_GROWTH_PERCENT percent (10 by
+# default). The goldens themselves are checked by golden_test.sh; this catches
+# changes that are correct, but make the generated code (and so the builds of
+# everyone who uses it) considerably larger or slower to compile.
+
+MAX_GROWTH_PERCENT="${GOLDEN_METRICS_MAX_GROWTH_PERCENT:-10}"
+METRIC_NAMES=(thunks rs_api_bytes rs_api_impl_bytes static_assertions)
+
+function count_matches() {
+  grep -oE "$1" "$2" | wc -l
+}
+
+# Prints the metrics of the given `_rs_api.rs` and `_rs_api_impl.cc` files.
+function metrics() {
+  local rs_api="$1"
+  local rs_api_impl="$2"
+  local thunks
+  thunks="$(grep -oE '__rust_thunk___[A-Za-z0-9_]+' "$rs_api_impl" \
+    | sort -u | wc -l)"
+  local static_assertions=$((
+    $(count_matches 'static_assert\(' "$rs_api_impl") +
+    $(count_matches '\bassert!\(|static_assertions::assert_[a-z_]+!' \
+        "$rs_api")
+  ))
+  echo "$thunks $(wc -c < "$rs_api") $(wc -c < "$rs_api_impl")" \
+    "$static_assertions"
+}
+
+if (("$#" == 0)); then
+  echo >&2 "INTERNAL ERROR: golden_metrics_test.sh requires a metrics file."
+  exit 1
+fi
+METRICS_FILE="$1"
+shift
+
+declare -A RECORDED
+while read -r name values; do
+  if [[ -z "$name" || "$name" == \#* ]]; then
+    continue
+  fi
+  RECORDED["$name"]="$values"
+done < "$METRICS_FILE"
+
+STATUS=0
+NEW_METRICS=""
+while (("$#" != 0)); do
+  if (("$#" < 3)); then
+    echo >&2 "INTERNAL ERROR: golden_metrics_test.sh requires triples of" \
+      "arguments after the metrics file."
+    exit 1
+  fi
+  name="$1"
+  read -r -a actual <<< "$(metrics "$2" "$3")"
+  shift 3
+  NEW_METRICS+="$name ${actual[*]}"$'\n'
+
+  if [[ -z "${RECORDED[$name]}" ]]; then
+    echo >&2 "$name: no metrics recorded in $METRICS_FILE"
+    STATUS=1
+    continue
+  fi
+  read -r -a recorded <<< "${RECORDED[$name]}"
+  for i in "${!METRIC_NAMES[@]}"; do
+    limit=$((recorded[i] + recorded[i] * MAX_GROWTH_PERCENT / 100))
+    if ((actual[i] > limit)); then
+      echo >&2 "$name: ${METRIC_NAMES[i]} grew from ${recorded[i]} to" \
+        "${actual[i]} (more than $MAX_GROWTH_PERCENT%)"
+      STATUS=1
+    fi
+  done
+done
+
+if [ $STATUS != 0 ]; then
+  if [ -n "$WRITE_GOLDEN_METRICS" ]; then
+    # Keep the comments at the top of the file.
+    HEADER="$(awk '/^[^#]/ { exit } { print }' "$METRICS_FILE")"
+    {
+      echo "$HEADER"
+      echo -n "$NEW_METRICS"
+    } > "$METRICS_FILE"
+    exit 0
+  fi
+  echo >&2 "If the growth is expected, record the new metrics by running the" \
+    "test with --test_strategy=local --test_env=WRITE_GOLDEN_METRICS=1"
+  exit 1
+fi
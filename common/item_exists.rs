@@ -102,6 +102,122 @@ pub fn value_exists(path: TokenStream) -> TokenStream {
     })
 }
 
+/// Returns whether each of the named types exists, as a `[bool; N]` in the
+/// order of the paths.
+///
+/// `types_exist!(a::A, a::B, b::A)` has the same value as
+/// `[type_exists!(a::A), type_exists!(a::B), type_exists!(b::A)]`, but
+/// expands to less code, which matters when checking many items, as the tests
+/// of generated bindings do: each `type_exists!` defines a fallback struct and
+/// a scope with a glob import of its own, so that rustc resolves and
+/// type-checks one of each per probe. `types_exist!` defines one fallback
+/// struct per distinct name, and one scope per distinct module (`a` and `b`
+/// above), so its compile time grows with the number of names and modules
+/// rather than with the number of probes.
+///
+/// It has the same limitations as `type_exists!`.
+#[proc_macro]
+pub fn types_exist(paths: TokenStream) -> TokenStream {
+    items_exist(
+        paths,
+        |name| quote! { struct #name; },
+        |name| {
+            quote! { ::core::any::TypeId::of::<#name>() }
+        },
+    )
+}
+
+/// Returns whether each of the named statics, constants, or functions exists,
+/// as a `[bool; N]` in the order of the paths.
+///
+/// This is the batched version of `value_exists!`, in the same way that
+/// `types_exist!` is the batched version of `type_exists!`, and has the same
+/// limitations as `value_exists!`.
+#[proc_macro]
+pub fn values_exist(paths: TokenStream) -> TokenStream {
+    items_exist(
+        paths,
+        |name| {
+            quote! {
+                struct #name {}
+                #[allow(non_upper_case_globals)]
+                static #name : #name = #name {};
+            }
+        },
+        |name| quote! { ::std::any::Any::type_id(&#name) },
+    )
+}
+
+/// Expands `types_exist!` and `values_exist!`: `fallback` defines the item
+/// that a name resolves to if the probed module doesn't shadow it, and `id`
+/// identifies the item that a name resolves to.
+fn items_exist(
+    paths: TokenStream,
+    fallback: impl Fn(&syn::PathSegment) -> proc_macro2::TokenStream,
+    id: impl Fn(&syn::PathSegment) -> proc_macro2::TokenStream,
+) -> TokenStream {
+    let parser = syn::punctuated::Punctuated::<syn::Path, syn::Token![,]>::parse_terminated;
+    let paths = syn::parse_macro_input!(paths with parser);
+    if paths.is_empty() {
+        return TokenStream::from(quote! { [false; 0] });
+    }
+    let mut fallbacks = vec![];
+    let mut fallback_names = std::collections::HashSet::new();
+    // The probes, grouped by module, so that each module is glob-imported
+    // once.
+    let mut modules: Vec<(String, syn::Path, Vec<(usize, syn::PathSegment)>)> = vec![];
+    for (index, path) in paths.into_iter().enumerate() {
+        let (path, name) = match extract_last(path) {
+            Ok((path, name)) => (path, name),
+            Err(e) => return e.into_compile_error().into(),
+        };
+        if fallback_names.insert(quote! {#name}.to_string()) {
+            fallbacks.push(fallback(&name));
+        }
+        let key = quote! {#path}.to_string();
+        match modules.iter_mut().find(|(module_key, ..)| *module_key == key) {
+            Some((_, _, probes)) => probes.push((index, name)),
+            None => modules.push((key, path, vec![(index, name)])),
+        }
+    }
+    let count = modules.iter().map(|(_, _, probes)| probes.len()).sum::<usize>();
+    let indices = 0..count;
+    let fallback_ids = modules.iter().flat_map(|(_, _, probes)| {
+        probes.iter().map(|(index, name)| {
+            let id = id(name);
+            quote! { fallback_ids[#index] = #id; }
+        })
+    });
+    let scopes = modules.iter().map(|(_, path, probes)| {
+        let ids = probes.iter().map(|(index, name)| {
+            let id = id(name);
+            quote! { ids[#index] = #id; }
+        });
+        quote! {
+            // introduce a new scope, so that we can shadow the names.
+            {
+                #[allow(unused_imports)]
+                use #path *;
+                #(#ids)*
+            }
+        }
+    });
+
+    TokenStream::from(quote! {
+        {
+            #(
+                #[allow(non_camel_case_types)]
+                #fallbacks
+            )*
+            let mut fallback_ids = [::core::any::TypeId::of::<()>(); #count];
+            #(#fallback_ids)*
+            let mut ids = fallback_ids;
+            #(#scopes)*
+            [#(fallback_ids[#indices] != ids[#indices]),*]
+        }
+    })
+}
+
 fn extract_last(mut path: syn::Path) -> Result<(syn::Path, syn::PathSegment), syn::Error> {
     let name = match path.segments.pop() {
         None => {
@@ -282,3 +282,85 @@ mod value_exists {
         assert!(item_exists::value_exists!(m::X));
     }
 }
+
+mod types_exist {
+    #[allow(unused_imports)]
+    use super::*;
+
+    #[gtest]
+    fn no_types() {
+        let exist: [bool; 0] = item_exists::types_exist!();
+        assert!(exist.is_empty());
+    }
+
+    #[gtest]
+    fn same_module() {
+        mod m {
+            pub struct S;
+            pub enum E {}
+        }
+        assert_eq!(item_exists::types_exist!(m::S, m::DoesNotExist, m::E), [true, false, true]);
+    }
+
+    #[gtest]
+    fn same_name_in_different_modules() {
+        mod m {
+            pub struct S;
+            pub mod m2 {}
+        }
+        assert_eq!(item_exists::types_exist!(m::S, m::m2::S, m::S), [true, false, true]);
+    }
+
+    #[gtest]
+    fn agrees_with_type_exists() {
+        mod m {
+            pub struct S;
+            #[allow(dead_code)]
+            pub fn foo() {}
+        }
+        assert_eq!(
+            item_exists::types_exist!(m::S, m::foo, ::std::num::NonZeroU8),
+            [
+                item_exists::type_exists!(m::S),
+                item_exists::type_exists!(m::foo),
+                item_exists::type_exists!(::std::num::NonZeroU8),
+            ]
+        );
+    }
+}
+
+mod values_exist {
+    #[allow(unused_imports)]
+    use super::*;
+
+    #[gtest]
+    fn values_in_different_modules() {
+        mod m {
+            pub fn foo() {}
+            pub mod m2 {
+                pub const X: () = ();
+            }
+        }
+        assert_eq!(
+            item_exists::values_exist!(m::foo, m::X, m::m2::X, m::m2::foo),
+            [true, false, true, false]
+        );
+    }
+
+    #[gtest]
+    fn agrees_with_value_exists() {
+        mod m {
+            pub struct S;
+            #[allow(dead_code)]
+            pub enum E {}
+        }
+        assert_eq!(
+            item_exists::values_exist!(m::S, m::E, ::std::f32::consts::E),
+            [
+                item_exists::value_exists!(m::S),
+                item_exists::value_exists!(m::E),
+                item_exists::value_exists!(::std::f32::consts::E),
+            ]
+        );
+    }
+}
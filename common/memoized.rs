@@ -145,7 +145,45 @@
 /// And so you may need to specify the lifetime in some uses.
 #[macro_export]
 macro_rules! query_group {
+  ($($tokens:tt)*) => {
+    $crate::internal_query_group! { [MemoizationTable] [] $($tokens)* }
+  };
+}
+
+/// A variant of `query_group!` whose database can be shared between threads.
+///
+/// The syntax is the same as for `query_group!`. The differences are:
+///
+/// * The trait has `Sync` as a supertrait, so `&dyn QueryGroupName` can be
+///   passed to other threads (e.g. with `std::thread::scope`), and memoized
+///   functions can fan out their work while sharing the memoized results.
+/// * The database is `Sync` if all inputs are `Sync`, and all parameters and
+///   return types of the memoized functions are `Send`. In practice, this means
+///   using `Arc` instead of `Rc`.
+/// * Memoized values are stored in a fixed number of independently locked
+///   shards, so that threads calling different functions, or the same function
+///   with different arguments, rarely contend.
+/// * If two threads call a memoized function with the same arguments at the
+///   same time, both may run it, and both then return the value that was
+///   stored first. Waiting for the other thread instead could deadlock, if
+///   each thread waited for a value the other one is computing.
+///
+/// Cycles (a memoized function depending on its own return value) are still
+/// detected, by tracking which thread is computing which call.
+#[macro_export]
+macro_rules! sync_query_group {
+  ($($tokens:tt)*) => {
+    $crate::internal_query_group! { [SyncMemoizationTable] [: Sync] $($tokens)* }
+  };
+}
+
+/// The implementation of `query_group!` and `sync_query_group!`, parameterized
+/// by the type of the memoization tables and the supertraits of the trait.
+#[doc(hidden)]
+#[macro_export]
+macro_rules! internal_query_group {
   (
+    [$table:ident] [$($supertraits:tt)*]
     $trait_vis:vis trait $trait:ident $(<$($type_param:tt),*>)?{
       $(
         $(#[doc = $input_doc:literal])*
@@ -169,7 +207,7 @@ macro_rules! query_group {
     $struct_vis:vis struct $database_struct:ident;
   ) => {
     // First, yes, generate the trait.
-    $trait_vis trait $trait $(<$($type_param),*>)?{
+    $trait_vis trait $trait $(<$($type_param),*>)? $($supertraits)* {
       $(
         $(#[doc = $input_doc])*
         fn $input_function(&self) -> $input_type
@@ -190,7 +228,7 @@ macro_rules! query_group {
         $input_function: $input_type,
       )*
       $(
-        $function: $crate::internal::MemoizationTable<($($arg_type,)*), $return_type>,
+        $function: $crate::internal::$table<($($arg_type,)*), $return_type>,
       )*
     }
 
@@ -243,8 +281,12 @@ macro_rules! query_group {
 #[doc(hidden)]
 pub mod internal {
     use std::cell::RefCell;
+    use std::collections::hash_map::RandomState;
     use std::collections::{HashMap, HashSet};
-    use std::hash::Hash;
+    use std::hash::{BuildHasher, Hash};
+    use std::sync::{Mutex, MutexGuard};
+    use std::thread::ThreadId;
+
     pub struct MemoizationTable<Args, Return>
     where
         Args: Clone + Eq + Hash,
@@ -290,6 +332,66 @@ pub mod internal {
             return_value
         }
     }
+
+    /// The number of independently locked shards of a `SyncMemoizationTable`.
+    const SHARDS: usize = 16;
+
+    pub struct SyncMemoizationTable<Args, Return>
+    where
+        Args: Clone + Eq + Hash,
+        Return: Clone,
+    {
+        hasher: RandomState,
+        memoized: [Mutex<HashMap<Args, Return>>; SHARDS],
+        /// The calls that are being computed, together with the thread that is
+        /// computing each of them.
+        active: Mutex<HashSet<(ThreadId, Args)>>,
+    }
+
+    impl<Args, Return> Default for SyncMemoizationTable<Args, Return>
+    where
+        Args: Clone + Eq + Hash,
+        Return: Clone,
+    {
+        fn default() -> Self {
+            Self {
+                hasher: RandomState::new(),
+                memoized: std::array::from_fn(|_| Mutex::new(HashMap::new())),
+                active: Mutex::new(HashSet::new()),
+            }
+        }
+    }
+
+    /// Locks `mutex`. The locks of a `SyncMemoizationTable` are never held while
+    /// running a memoized function, so they can't be poisoned by its panics.
+    fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+        mutex.lock().unwrap()
+    }
+
+    impl<Args, Return> SyncMemoizationTable<Args, Return>
+    where
+        Args: Clone + Eq + Hash,
+        Return: Clone,
+    {
+        pub fn internal_memoized_call<F>(&self, args: Args, f: F) -> Return
+        where
+            F: FnOnce(Args) -> Return,
+        {
+            let shard = &self.memoized[self.hasher.hash_one(&args) as usize % SHARDS];
+            if let Some(return_value) = lock(shard).get(&args) {
+                return return_value.clone();
+            }
+            let active_call = (std::thread::current().id(), args.clone());
+            if !lock(&self.active).insert(active_call.clone()) {
+                panic!("Cycle detected: a memoized function depends on its own return value");
+            }
+            let return_value = f(args.clone());
+            lock(&self.active).remove(&active_call);
+            // Another thread may have stored a value in the meantime. Keep that one, so that all
+            // callers observe the same value.
+            lock(shard).entry(args).or_insert(return_value).clone()
+        }
+    }
 }
 
 #[cfg(test)]
@@ -297,6 +399,8 @@ pub mod tests {
     use googletest::prelude::*;
     use std::cell::Cell;
     use std::rc::Rc;
+    use std::sync::atomic::{AtomicI32, Ordering};
+    use std::sync::Arc;
 
     #[gtest]
     fn test_basic_memoization() {
@@ -451,4 +555,94 @@ pub mod tests {
         assert_eq!(db.call_counter().get(), 1);
         assert!(Rc::ptr_eq(&argless_return, &argless_return_2));
     }
+
+    #[gtest]
+    fn test_sync_memoization_across_threads() {
+        crate::sync_query_group! {
+          pub trait Add10 {
+            #[input]
+            fn call_counter(&self) -> Arc<AtomicI32>;
+            fn add10(&self, arg: i32) -> i32;
+            fn boxed(&self, arg: i32) -> Arc<i32>;
+          }
+          pub struct Database;
+        }
+        fn add10(db: &dyn Add10, arg: i32) -> i32 {
+            db.call_counter().fetch_add(1, Ordering::SeqCst);
+            arg + 10
+        }
+        fn boxed(_db: &dyn Add10, arg: i32) -> Arc<i32> {
+            Arc::new(arg)
+        }
+        let db = Database::new(Arc::new(AtomicI32::new(0)));
+
+        let boxed_values = std::thread::scope(|scope| {
+            let threads = (0..8)
+                .map(|_| {
+                    scope.spawn(|| {
+                        for arg in 0..100 {
+                            assert_eq!(db.add10(arg), arg + 10);
+                        }
+                        db.boxed(1)
+                    })
+                })
+                .collect::<Vec<_>>();
+            threads.into_iter().map(|thread| thread.join().unwrap()).collect::<Vec<_>>()
+        });
+
+        // Threads may race to compute the same call, but all of them observe the same value.
+        assert!(boxed_values.iter().all(|boxed| Arc::ptr_eq(boxed, &db.boxed(1))));
+        let call_count = db.call_counter().load(Ordering::SeqCst);
+        assert!((100..=800).contains(&call_count));
+        assert_eq!(db.add10(50), 60);
+        assert_eq!(db.call_counter().load(Ordering::SeqCst), call_count);
+    }
+
+    /// Memoized functions can fan out their work to other threads, which share the memoized
+    /// results.
+    #[gtest]
+    fn test_sync_memoization_fan_out() {
+        crate::sync_query_group! {
+          pub trait Sum<'a> {
+            #[input]
+            fn values(&self) -> &'a [i32];
+            fn sum(&self) -> i32;
+            fn value(&self, index: usize) -> i32;
+          }
+          pub struct Database;
+        }
+        fn sum(db: &dyn Sum) -> i32 {
+            std::thread::scope(|scope| {
+                let threads = (0..db.values().len())
+                    .map(|index| scope.spawn(move || db.value(index)))
+                    .collect::<Vec<_>>();
+                threads.into_iter().map(|thread| thread.join().unwrap()).sum()
+            })
+        }
+        fn value(db: &dyn Sum, index: usize) -> i32 {
+            db.values()[index]
+        }
+        let values = [1, 2, 3, 4];
+        let db = Database::new(&values);
+        assert_eq!(db.sum(), 10);
+        assert_eq!(db.value(2), 3);
+    }
+
+    #[gtest]
+    #[should_panic(
+        expected = "Cycle detected: a memoized function depends on its own return value"
+    )]
+    fn test_sync_cycle() {
+        crate::sync_query_group! {
+          pub trait Add10 {
+            fn add10(&self, arg: i32) -> i32;
+          }
+          pub struct Database;
+        }
+        fn add10(db: &dyn Add10, arg: i32) -> i32 {
+            db.add10(arg) // infinite recursion!
+        }
+        let db = Database::new();
+        db.add10(1);
+    }
 }
@@ -0,0 +1,62 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "common/string_interner.h"
+
+#include <string>
+
+#include "absl/base/const_init.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace crubit {
+
+namespace {
+
+ABSL_CONST_INIT absl::Mutex interned_strings_mutex(absl::kConstInit);
+
+// A node-based set, so that the interned strings never move.
+absl::node_hash_set<std::string>& InternedStrings()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(interned_strings_mutex) {
+  static absl::NoDestructor<absl::node_hash_set<std::string>> interned_strings;
+  return *interned_strings;
+}
+
+// The strings interned while a `StringInternerScope` is alive, or null.
+absl::node_hash_set<std::string>* scoped_strings
+    ABSL_GUARDED_BY(interned_strings_mutex) = nullptr;
+
+}  // namespace
+
+const std::string& InternString(absl::string_view s) {
+  absl::MutexLock lock(&interned_strings_mutex);
+  absl::node_hash_set<std::string>& interned_strings = InternedStrings();
+  auto it = interned_strings.find(s);
+  if (it != interned_strings.end()) {
+    return *it;
+  }
+  // Strings are only looked up in (and added to) `scoped_strings` if they
+  // aren't in `interned_strings`, so every string is stored at most once.
+  absl::node_hash_set<std::string>& strings =
+      scoped_strings != nullptr ? *scoped_strings : interned_strings;
+  return *strings.emplace(s).first;
+}
+
+StringInternerScope::StringInternerScope() {
+  absl::MutexLock lock(&interned_strings_mutex);
+  CHECK(scoped_strings == nullptr) << "StringInternerScopes can't be nested";
+  scoped_strings = new absl::node_hash_set<std::string>();
+}
+
+StringInternerScope::~StringInternerScope() {
+  absl::MutexLock lock(&interned_strings_mutex);
+  delete scoped_strings;
+  scoped_strings = nullptr;
+}
+
+}  // namespace crubit
@@ -0,0 +1,40 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_COMMON_STRING_INTERNER_H_
+#define CRUBIT_COMMON_STRING_INTERNER_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace crubit {
+
+// Returns the interned copy of `s`, which lives until the end of the program,
+// or - if `s` is first interned while a `StringInternerScope` is alive - until
+// the end of that scope.
+//
+// Every distinct string is stored only once, so the addresses of two interned
+// strings are equal if and only if the strings are equal. This is thread-safe.
+const std::string& InternString(absl::string_view s);
+
+// Frees the strings interned during a unit of work (e.g. a request of a
+// persistent worker) at the end of it, so that the interned strings don't
+// accumulate across units of work.
+//
+// Strings interned before the scope was created stay interned. Nothing that
+// refers to a string interned during the scope may be used after the scope is
+// destroyed. At most one scope may be alive at a time.
+class StringInternerScope {
+ public:
+  StringInternerScope();
+  ~StringInternerScope();
+
+  StringInternerScope(const StringInternerScope&) = delete;
+  StringInternerScope& operator=(const StringInternerScope&) = delete;
+};
+
+}  // namespace crubit
+
+#endif  // CRUBIT_COMMON_STRING_INTERNER_H_
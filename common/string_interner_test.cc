@@ -0,0 +1,51 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "common/string_interner.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crubit {
+namespace {
+
+TEST(StringInternerTest, EqualStringsAreInternedOnce) {
+  std::string foo = "foo";
+  const std::string& interned_foo = InternString(foo);
+  EXPECT_EQ(interned_foo, "foo");
+  EXPECT_NE(&interned_foo, &foo);
+  EXPECT_EQ(&InternString("foo"), &interned_foo);
+  EXPECT_NE(&InternString("bar"), &interned_foo);
+}
+
+TEST(StringInternerTest, EmptyString) {
+  EXPECT_EQ(InternString(""), "");
+  EXPECT_EQ(&InternString(""), &InternString(std::string()));
+}
+
+TEST(StringInternerTest, ScopeKeepsStringsInternedBeforeIt) {
+  const std::string& before = InternString("interned before the scope");
+  {
+    StringInternerScope scope;
+    EXPECT_EQ(&InternString("interned before the scope"), &before);
+  }
+  EXPECT_EQ(&InternString("interned before the scope"), &before);
+}
+
+TEST(StringInternerTest, ScopeInternsStringsOnce) {
+  StringInternerScope scope;
+  const std::string& in_scope = InternString("interned in the scope");
+  EXPECT_EQ(in_scope, "interned in the scope");
+  EXPECT_EQ(&InternString("interned in the scope"), &in_scope);
+  EXPECT_NE(&InternString("also interned in the scope"), &in_scope);
+}
+
+TEST(StringInternerDeathTest, ScopesDontNest) {
+  StringInternerScope scope;
+  EXPECT_DEATH(StringInternerScope(), "can't be nested");
+}
+
+}  // namespace
+}  // namespace crubit
@@ -35,6 +35,7 @@
 
 #include "absl/flags/marshalling.h"
 #include "absl/strings/string_view.h"
+#include "common/string_interner.h"
 
 // Defines the StringType using StringTypeRepresentation and provides a type
 // alias to string_type_name.  The struct string_type_name ## _tag_ trickery is
@@ -50,6 +51,14 @@
 #define CRUBIT_DEFINE_STRING_TYPE(string_type_name) \
   using string_type_name = ::crubit::StringType<class string_type_name##_tag_>;
 
+// Like CRUBIT_DEFINE_STRING_TYPE, but the values are interned (see
+// `InternString`): copies don't allocate, and equality and hashing don't look
+// at the characters. Suited to types with few distinct values which are copied
+// a lot.
+#define CRUBIT_DEFINE_INTERNED_STRING_TYPE(string_type_name) \
+  using string_type_name =                                   \
+      ::crubit::InternedStringType<class string_type_name##_tag_>;
+
 namespace crubit {
 
 // StringType provides these operations:
@@ -108,6 +117,63 @@ class StringType {
   std::string s_;
 };
 
+// An interned StringType, with the same operations. `value()` returns a
+// reference to the interned string, which stays valid as long as
+// `InternString` keeps it.
+template <typename Tag>
+class InternedStringType {
+ public:
+  InternedStringType() : InternedStringType(absl::string_view()) {}
+  explicit InternedStringType(absl::string_view value)
+      : s_(&InternString(value)) {}
+
+  const std::string& value() const { return *s_; }
+
+  bool empty() const { return value().empty(); }
+
+  int compare(const InternedStringType& other) const {
+    return s_ == other.s_ ? 0 : value().compare(other.value());
+  }
+  friend bool operator==(const InternedStringType& left,
+                         const InternedStringType& right) {
+    return left.s_ == right.s_;
+  }
+  friend bool operator<(const InternedStringType& left,
+                        const InternedStringType& right) {
+    return left.compare(right) < 0;
+  }
+
+  friend bool operator!=(const InternedStringType& left,
+                         const InternedStringType& right) {
+    return !(left == right);
+  }
+  friend bool operator>(const InternedStringType& left,
+                        const InternedStringType& right) {
+    return right < left;
+  }
+  friend bool operator<=(const InternedStringType& left,
+                         const InternedStringType& right) {
+    return !(left > right);
+  }
+  friend bool operator>=(const InternedStringType& left,
+                         const InternedStringType& right) {
+    return !(left < right);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const InternedStringType& s) {
+    return H::combine(std::move(h), s.s_);
+  }
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const InternedStringType& s) {
+    return os << s.value();
+  }
+
+ private:
+  const std::string* s_;
+};
+
 // Allows typed strings to be used as ABSL_FLAG values.
 //
 // This is equivalent in behavior to just using a raw std::string.
@@ -123,6 +189,18 @@ std::string AbslUnparseFlag(const StringType<Tag>& val) {
   return absl::UnparseFlag(std::string(val.value()));
 }
 
+template <typename Tag>
+bool AbslParseFlag(absl::string_view text, InternedStringType<Tag>* out,
+                   std::string* error) {
+  *out = InternedStringType<Tag>(text);
+  return true;
+}
+
+template <typename Tag>
+std::string AbslUnparseFlag(const InternedStringType<Tag>& val) {
+  return absl::UnparseFlag(val.value());
+}
+
 }  // namespace crubit
 
 #endif  // CRUBIT_COMMON_STRING_TYPE_H_
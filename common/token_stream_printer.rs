@@ -79,6 +79,132 @@ pub fn rs_tokens_to_formatted_string(
     rustfmt(tokens_to_string(tokens)?, config)
 }
 
+/// Like `rs_tokens_to_formatted_string`, but splits the top-level items of
+/// `tokens` into chunks of at least `min_chunk_len` bytes and formats the
+/// chunks with concurrent `rustfmt` processes.
+///
+/// The result is the same as formatting the whole file at once, except for
+/// formatting decisions that span items (e.g. sorting of `use` declarations).
+/// If any chunk fails to format, the whole file is formatted at once instead,
+/// so that errors are reported the same way as by
+/// `rs_tokens_to_formatted_string`.
+pub fn rs_tokens_to_formatted_string_in_chunks(
+    tokens: TokenStream,
+    config: &RustfmtConfig,
+    min_chunk_len: usize,
+) -> Result<String> {
+    let items = split_top_level_items(tokens)?;
+    let total_len: usize = items.iter().map(String::len).sum();
+    let parallelism = std::thread::available_parallelism().map_or(1, |n| n.get());
+    let chunk_len = std::cmp::max(min_chunk_len, total_len / parallelism);
+    let mut chunks = vec![String::new()];
+    for item in items {
+        let last = chunks.last_mut().unwrap();
+        if !last.is_empty() && last.len() + item.len() > chunk_len {
+            chunks.push(item);
+        } else {
+            last.push_str(&item);
+        }
+    }
+    if chunks.len() == 1 {
+        return rustfmt(chunks.pop().unwrap(), config);
+    }
+
+    let formatted_chunks: Vec<Result<String>> = std::thread::scope(|scope| {
+        let handles = chunks
+            .iter()
+            .map(|chunk| scope.spawn(|| rustfmt(chunk.clone(), config)))
+            .collect::<Vec<_>>();
+        handles.into_iter().map(|handle| handle.join().unwrap()).collect()
+    });
+    if formatted_chunks.iter().any(Result::is_err) {
+        return rustfmt(chunks.concat(), config);
+    }
+    let mut result = String::new();
+    for (chunk, formatted_chunk) in chunks.iter().zip(formatted_chunks) {
+        // `rustfmt` drops the leading newlines of a chunk, but keeps one blank line
+        // between items when formatting the whole file.
+        if !result.is_empty() && chunk.starts_with('\n') {
+            result.push('\n');
+        }
+        result.push_str(&formatted_chunk?);
+    }
+    Ok(result)
+}
+
+/// Splits `tokens` into the source code of their top-level items.
+///
+/// An item ends at a `__NEWLINE__` that follows a top-level `;` or `{ ... }`,
+/// which is how the generated code separates items.
+fn split_top_level_items(tokens: TokenStream) -> Result<Vec<String>> {
+    let mut items = vec![];
+    let mut current = vec![];
+    let mut ends_item = false;
+    for tt in tokens {
+        let is_newline = matches!(&tt, TokenTree::Ident(id) if id == "__NEWLINE__");
+        let next_ends_item = match &tt {
+            TokenTree::Punct(p) => p.as_char() == ';',
+            TokenTree::Group(g) => g.delimiter() == Delimiter::Brace,
+            _ => false,
+        };
+        current.push(tt);
+        if is_newline && ends_item {
+            items.push(tokens_to_string(current.drain(..).collect())?);
+        }
+        ends_item = next_ends_item;
+    }
+    if !current.is_empty() {
+        items.push(tokens_to_string(current.into_iter().collect())?);
+    }
+    Ok(items)
+}
+
+/// Like `rs_tokens_to_formatted_string_in_chunks` and
+/// `cc_tokens_to_formatted_string`, but running `rustfmt` and `clang-format`
+/// concurrently. Returns the formatted Rust and C++ source code.
+pub fn rs_and_cc_tokens_to_formatted_strings(
+    rs_tokens: TokenStream,
+    rustfmt_config: &RustfmtConfig,
+    rs_min_chunk_len: usize,
+    cc_tokens: TokenStream,
+    clang_format_exe_path: &Path,
+) -> Result<(String, String)> {
+    let (rs, mut cc) = rs_and_many_cc_tokens_to_formatted_strings(
+        rs_tokens,
+        rustfmt_config,
+        rs_min_chunk_len,
+        vec![cc_tokens],
+        clang_format_exe_path,
+    )?;
+    Ok((rs, cc.pop().unwrap()))
+}
+
+/// Like `rs_and_cc_tokens_to_formatted_strings`, but for any number of C++
+/// files, which are formatted by concurrent `clang-format` processes. Returns
+/// the formatted Rust source code, and the C++ source code in the order of
+/// `cc_tokens`.
+pub fn rs_and_many_cc_tokens_to_formatted_strings(
+    rs_tokens: TokenStream,
+    rustfmt_config: &RustfmtConfig,
+    rs_min_chunk_len: usize,
+    cc_tokens: Vec<TokenStream>,
+    clang_format_exe_path: &Path,
+) -> Result<(String, Vec<String>)> {
+    // `TokenStream` is not `Send`, so only the C++ source code can be moved to
+    // other threads.
+    let cc_sources = cc_tokens.into_iter().map(tokens_to_string).collect::<Result<Vec<_>>>()?;
+    std::thread::scope(|scope| {
+        let cc_handles = cc_sources
+            .into_iter()
+            .map(|cc_source| scope.spawn(|| clang_format(cc_source, clang_format_exe_path)))
+            .collect::<Vec<_>>();
+        let rs =
+            rs_tokens_to_formatted_string_in_chunks(rs_tokens, rustfmt_config, rs_min_chunk_len);
+        let cc = cc_handles.into_iter().map(|handle| handle.join().unwrap()).collect::<Vec<_>>();
+        Ok((rs?, cc.into_iter().collect::<Result<Vec<_>>>()?))
+    })
+}
+
 /// Like `rs_tokens_to_formatted_string`, but always using a Crubit-internal,
 /// default rustfmt config.  This should only be called by tests - product code
 /// should support custom `rustfmt.toml` and take the path to `rustfmt` binary
@@ -142,16 +268,20 @@ pub fn write_unformatted_tokens(
                     bail!("__COMMENT__ must be followed by a literal")
                 }
             }
-            TokenTree::Group(ref tt) => {
-                let (open_delimiter, closed_delimiter) = match tt.delimiter() {
+            TokenTree::Group(group) => {
+                let (open_delimiter, closed_delimiter) = match group.delimiter() {
                     Delimiter::Parenthesis => ("(", ")"),
                     Delimiter::Bracket => ("[", "]"),
                     Delimiter::Brace => ("{ ", " }"),
                     Delimiter::None => ("", ""),
                 };
-                write!(result, "{}", open_delimiter)?;
-                write_unformatted_tokens(result, tt.stream())?;
-                write!(result, "{}", closed_delimiter)?;
+                result.write_str(open_delimiter)?;
+                write_unformatted_tokens(result, group_into_stream(group))?;
+                result.write_str(closed_delimiter)?;
+                // A group is never a `:`, which is all that `tokens_require_whitespace`
+                // looks for in the previous token.
+                tt_prev = None;
+                continue;
             }
             _ => {
                 write!(result, "{}", tt)?;
@@ -171,6 +301,365 @@ pub fn write_unformatted_tokens(
     Ok(())
 }
 
+/// Returns a hash of the API that the token stream declares, as 32 hex digits.
+///
+/// Comments (`__COMMENT__` placeholders and `#[doc = ...]` attributes) and
+/// the other placeholders of `write_unformatted_tokens` don't contribute to the
+/// hash, so that edits that only change documentation or source locations
+/// keep it unchanged, and so does formatting. The hash is a 128-bit FNV-1a,
+/// which is stable across runs and platforms.
+pub fn tokens_to_api_hash(tokens: TokenStream) -> String {
+    let mut hash = ApiHash(ApiHash::OFFSET_BASIS);
+    hash.add_tokens(tokens);
+    format!("{:032x}", hash.0)
+}
+
+struct ApiHash(u128);
+
+impl ApiHash {
+    const OFFSET_BASIS: u128 = 0x6c62272e07bb014262b821756295c58d;
+    const PRIME: u128 = 0x0000000001000000000000000000013B;
+
+    fn add(&mut self, bytes: &[u8]) {
+        for byte in bytes {
+            self.0 ^= u128::from(*byte);
+            self.0 = self.0.wrapping_mul(Self::PRIME);
+        }
+    }
+
+    fn add_tokens(&mut self, tokens: TokenStream) {
+        let tokens: Vec<TokenTree> = tokens.into_iter().collect();
+        let mut i = 0;
+        while i < tokens.len() {
+            if let Some(len) = comment_len(&tokens[i..]) {
+                i += len;
+                continue;
+            }
+            match &tokens[i] {
+                TokenTree::Group(group) => {
+                    let (open, close) = match group.delimiter() {
+                        Delimiter::Parenthesis => (b"(", b")"),
+                        Delimiter::Bracket => (b"[", b"]"),
+                        Delimiter::Brace => (b"{", b"}"),
+                        Delimiter::None => (b"<", b">"),
+                    };
+                    self.add(open);
+                    self.add_tokens(group.stream());
+                    self.add(close);
+                }
+                TokenTree::Punct(punct) => {
+                    let spacing = match punct.spacing() {
+                        proc_macro2::Spacing::Joint => b'j',
+                        proc_macro2::Spacing::Alone => b'a',
+                    };
+                    self.add(&[punct.as_char() as u8, spacing]);
+                }
+                TokenTree::Ident(_) | TokenTree::Literal(_) => {
+                    // The separator tells `a b` apart from `ab`.
+                    self.add(tokens[i].to_string().as_bytes());
+                    self.add(b" ");
+                }
+            }
+            i += 1;
+        }
+    }
+}
+
+/// Returns the number of tokens at the start of `tokens` that are a comment
+/// (`__COMMENT__ "..."`, `#[doc = ...]` or `#![doc = ...]`) or a whitespace
+/// placeholder, if any.
+fn comment_len(tokens: &[TokenTree]) -> Option<usize> {
+    match tokens {
+        [TokenTree::Ident(id), TokenTree::Literal(_), ..] if id == "__COMMENT__" => Some(2),
+        [TokenTree::Ident(id), ..] if id == "__NEWLINE__" || id == "__SPACE__" => Some(1),
+        [TokenTree::Punct(hash), TokenTree::Group(attr), ..]
+            if hash.as_char() == '#' && is_doc_attribute(attr) =>
+        {
+            Some(2)
+        }
+        [TokenTree::Punct(hash), TokenTree::Punct(bang), TokenTree::Group(attr), ..]
+            if hash.as_char() == '#' && bang.as_char() == '!' && is_doc_attribute(attr) =>
+        {
+            Some(3)
+        }
+        _ => None,
+    }
+}
+
+fn is_doc_attribute(attr: &proc_macro2::Group) -> bool {
+    if attr.delimiter() != Delimiter::Bracket {
+        return false;
+    }
+    let mut it = attr.stream().into_iter();
+    matches!(
+        (it.next(), it.next()),
+        (Some(TokenTree::Ident(id)), Some(TokenTree::Punct(eq))) if id == "doc" && eq.as_char() == '='
+    )
+}
+
+/// Produces readable source code out of the token stream, without running
+/// `rustfmt` or `clang-format`.
+///
+/// The output is deterministic and is valid Rust or C++ whenever the
+/// input is, but it is only roughly formatted: it breaks lines after `;`,
+/// attributes and `,` in braces, and indents the contents of braces. Otherwise
+/// it handles the placeholders of `write_unformatted_tokens` the same way.
+pub fn tokens_to_pretty_string(tokens: TokenStream) -> Result<String> {
+    let mut printer = PrettyPrinter::default();
+    printer.print(tokens, /* in_braces= */ true)?;
+    printer.line_break();
+    Ok(printer.out)
+}
+
+#[derive(Default)]
+struct PrettyPrinter {
+    out: String,
+    indent: usize,
+    at_line_start: bool,
+    /// True if the current line was started by `line_break` rather than by a
+    /// `__NEWLINE__`.
+    at_implicit_line_start: bool,
+}
+
+impl PrettyPrinter {
+    const INDENT: &'static str = "    ";
+
+    fn write(&mut self, s: &str) {
+        if s.is_empty() {
+            return;
+        }
+        self.indent_line_start();
+        self.out.push_str(s);
+    }
+
+    /// Like `write`, but formats `tt` straight into the output.
+    fn write_display(&mut self, tt: &TokenTree) {
+        use std::fmt::Write as _;
+        self.indent_line_start();
+        write!(self.out, "{tt}").unwrap();
+    }
+
+    fn indent_line_start(&mut self) {
+        if self.at_line_start {
+            for _ in 0..self.indent {
+                self.out.push_str(Self::INDENT);
+            }
+            self.at_line_start = false;
+            self.at_implicit_line_start = false;
+        }
+    }
+
+    fn space(&mut self) {
+        if !self.at_line_start && !self.out.is_empty() && !self.out.ends_with([' ', '(', '[']) {
+            self.out.push(' ');
+        }
+    }
+
+    /// Starts a new line for a `__NEWLINE__`. A `__NEWLINE__` right after a
+    /// `line_break` is redundant, and consecutive calls produce at most one
+    /// blank line.
+    fn newline(&mut self) {
+        if self.at_implicit_line_start {
+            self.at_implicit_line_start = false;
+        } else if !self.out.is_empty() && !self.out.ends_with("\n\n") {
+            self.push_newline();
+        }
+    }
+
+    /// Starts a new line, unless the current line is empty.
+    fn line_break(&mut self) {
+        if !self.at_line_start && !self.out.is_empty() {
+            self.push_newline();
+            self.at_implicit_line_start = true;
+        }
+    }
+
+    fn push_newline(&mut self) {
+        while self.out.ends_with(' ') {
+            self.out.pop();
+        }
+        self.out.push('\n');
+        self.at_line_start = true;
+    }
+
+    /// Prints `tokens`. `in_braces` is true for the top level and the contents
+    /// of `{ ... }`, where statements, items and fields go on separate lines.
+    fn print(&mut self, tokens: TokenStream, in_braces: bool) -> Result<()> {
+        let mut it = tokens.into_iter().peekable();
+        let mut tt_prev: Option<TokenTree> = None;
+        // The characters of the current multi-character punctuation, e.g. `::`.
+        let mut op = String::new();
+        // True after a `#` or `#!` that may start an attribute.
+        let mut attribute_start = false;
+        // The nesting depth of `<...>`, where `,` doesn't break lines.
+        let mut angle_depth = 0usize;
+        while let Some(tt) = it.next() {
+            match tt {
+                TokenTree::Ident(ref id) if id == "__NEWLINE__" => self.newline(),
+                TokenTree::Ident(ref id) if id == "__SPACE__" => self.space(),
+                TokenTree::Ident(ref id) if id == "__HASH_TOKEN__" => {
+                    self.write("#");
+                    tt_prev = None;
+                    continue;
+                }
+                TokenTree::Ident(ref id) if id == "__COMMENT__" => {
+                    let Some(TokenTree::Literal(lit)) = it.next() else {
+                        bail!("__COMMENT__ must be followed by a literal")
+                    };
+                    let text = lit.to_string();
+                    for line in text.trim_matches('"').split("\\n") {
+                        self.write("// ");
+                        self.write(line);
+                        self.line_break();
+                    }
+                }
+                TokenTree::Group(group) => {
+                    let delimiter = group.delimiter();
+                    let is_attribute = attribute_start && delimiter == Delimiter::Bracket;
+                    let stream = group_into_stream(group);
+                    match delimiter {
+                        Delimiter::Brace => {
+                            self.space();
+                            self.write("{");
+                            if stream.is_empty() {
+                                self.write("}");
+                            } else {
+                                self.indent += 1;
+                                self.line_break();
+                                self.print(stream, /* in_braces= */ true)?;
+                                self.indent -= 1;
+                                self.line_break();
+                                self.write("}");
+                            }
+                            if in_braces && starts_new_line_after_braces(it.peek()) {
+                                self.line_break();
+                            }
+                        }
+                        Delimiter::Parenthesis | Delimiter::Bracket => {
+                            let (open, close) = if delimiter == Delimiter::Parenthesis {
+                                ("(", ")")
+                            } else {
+                                ("[", "]")
+                            };
+                            self.write(open);
+                            self.print(stream, /* in_braces= */ false)?;
+                            self.write(close);
+                            if is_attribute && in_braces {
+                                self.line_break();
+                            }
+                        }
+                        Delimiter::None => self.print(stream, in_braces)?,
+                    }
+                    attribute_start = false;
+                    // Like in `write_unformatted_tokens`, a previous group is
+                    // treated the same as no previous token.
+                    tt_prev = None;
+                    continue;
+                }
+                TokenTree::Punct(ref punct) => {
+                    op.push(punct.as_char());
+                    if punct.spacing() == proc_macro2::Spacing::Joint {
+                        if let Some(TokenTree::Punct(next)) = it.peek() {
+                            op.push(next.as_char());
+                            let is_prefix = MULTI_CHAR_OPERATORS.contains(&op.as_str());
+                            op.pop();
+                            if is_prefix {
+                                tt_prev = Some(tt);
+                                continue;
+                            }
+                        }
+                    }
+                    if op == "!" && matches!(&tt_prev, Some(TokenTree::Ident(id)) if id == "impl") {
+                        self.space();
+                    }
+                    attribute_start = op == "#" || (op == "!" && attribute_start);
+                    let closes_angle_brackets = op.chars().all(|c| c == '>');
+                    if op.chars().all(|c| c == '<') {
+                        angle_depth += op.len();
+                    } else if closes_angle_brackets {
+                        angle_depth = angle_depth.saturating_sub(op.len());
+                    }
+                    if closes_angle_brackets && matches!(it.peek(), Some(TokenTree::Ident(_))) {
+                        self.write(&op);
+                        self.space();
+                        op.clear();
+                        tt_prev = Some(tt);
+                        continue;
+                    }
+                    match op.as_str() {
+                        "=" | "==" | "!=" | "=>" | "->" | "+=" | "-=" | "&&" | "||" => {
+                            self.space();
+                            self.write(&op);
+                            self.space();
+                        }
+                        ";" if in_braces => {
+                            self.write(";");
+                            self.line_break();
+                        }
+                        "," if in_braces && angle_depth == 0 => {
+                            self.write(",");
+                            self.line_break();
+                        }
+                        "," | ";" => {
+                            self.write(&op);
+                            self.space();
+                        }
+                        _ => {
+                            self.write(&op);
+                            if let Some(tt_next) = it.peek() {
+                                if tokens_require_whitespace(tt_prev.as_ref(), &tt, tt_next) {
+                                    self.space();
+                                }
+                            }
+                        }
+                    }
+                    op.clear();
+                }
+                _ => {
+                    if tt_prev.as_ref().is_some_and(is_ident_or_literal) && is_ident_or_literal(&tt)
+                    {
+                        self.space();
+                    }
+                    let is_include_directive = self.out.ends_with('#')
+                        && matches!(&tt, TokenTree::Ident(id) if id == "include");
+                    self.write_display(&tt);
+                    if is_include_directive {
+                        // `#include <cstddef>`, like clang-format prints it.
+                        self.space();
+                    }
+                    attribute_start = false;
+                }
+            }
+            tt_prev = Some(tt);
+        }
+        Ok(())
+    }
+}
+
+/// The operators made of more than one `Punct`, and their prefixes.
+const MULTI_CHAR_OPERATORS: &[&str] = &[
+    "::", "->", "=>", "==", "!=", "<=", ">=", "&&", "||", "+=", "-=", "*=", "/=", "%=", "^=", "&=",
+    "|=", "<<", ">>", "<<=", ">>=", "..", "...", "..=",
+];
+
+/// Returns true if the token after a `{ ... }` block starts a new item or
+/// statement (as opposed to e.g. `else` or `;`).
+fn starts_new_line_after_braces(next: Option<&TokenTree>) -> bool {
+    match next {
+        Some(TokenTree::Ident(id)) => id != "else" && id != "as" && id != "__NEWLINE__",
+        Some(TokenTree::Punct(p)) => p.as_char() == '#',
+        _ => false,
+    }
+}
+
+/// Returns the tokens of `group`.
+///
+/// `Group::stream` shares the tokens with `group`, so iterating over the
+/// result would copy every token, unless `group` is dropped first.
+fn group_into_stream(group: proc_macro2::Group) -> TokenStream {
+    group.stream()
+}
+
 fn tokens_to_string(tokens: TokenStream) -> Result<String> {
     let mut result = String::new();
     write_unformatted_tokens(&mut result, tokens)?;
@@ -420,6 +909,20 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_tokens_after_groups() -> Result<()> {
+        let input = || quote! { fn f() { g(a)::b(); x[0] >>= (1); impl !Send for T {} ((y)) } };
+        assert_eq!(
+            tokens_to_string(input())?,
+            "fn f(){ g(a)::b();x[0]>>=(1);impl!Send for T{  }((y)) }"
+        );
+        assert_eq!(
+            tokens_to_pretty_string(input())?,
+            "fn f() {\n    g(a)::b();\n    x[0]>>=(1);\n    impl !Send for T {}((y))\n}\n"
+        );
+        Ok(())
+    }
+
     #[gtest]
     fn test_rs_tokens_to_formatted_string_for_tests() {
         let input = quote! {
@@ -502,4 +1005,93 @@ void bar() {}
 }  // namespace ns"#
         );
     }
+
+    #[gtest]
+    fn test_tokens_to_pretty_string() -> Result<()> {
+        let input = quote! {
+            #[repr(C)]
+            pub struct Foo<T, U> { x: i32, y: [u8; 4], }
+            impl Foo { pub fn bar(&self, a: i32) -> i32 { let b = a; b } }
+        };
+        assert_eq!(
+            tokens_to_pretty_string(input)?,
+            r#"#[repr(C)]
+pub struct Foo<T, U> {
+    x: i32,
+    y: [u8; 4],
+}
+impl Foo {
+    pub fn bar(&self, a: i32) -> i32 {
+        let b = a;
+        b
+    }
+}
+"#
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_tokens_to_pretty_string_placeholders() -> Result<()> {
+        let input = quote! {
+            __HASH_TOKEN__ include <cstddef> __NEWLINE__ __NEWLINE__ __NEWLINE__
+            __COMMENT__ "a\nb"
+            namespace ns { void f() {} }
+        };
+        assert_eq!(
+            tokens_to_pretty_string(input)?,
+            "#include <cstddef>\n\n// a\n// b\nnamespace ns {\n    void f() {}\n}\n"
+        );
+        assert!(tokens_to_pretty_string(quote! { __COMMENT__ }).is_err());
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_tokens_to_api_hash_ignores_comments() {
+        let hash = tokens_to_api_hash(quote! { pub fn f(x: i32) {} });
+        assert_eq!(hash.len(), 32);
+        assert_eq!(
+            tokens_to_api_hash(quote! {
+                #![doc = " Crate docs."]
+                __COMMENT__ "Generated from: a.h;l=1"
+                #[doc = " Docs."]
+                pub fn f(x: i32) __NEWLINE__ {}
+            }),
+            hash
+        );
+        assert_ne!(tokens_to_api_hash(quote! { pub fn f(x: i64) {} }), hash);
+        assert_ne!(tokens_to_api_hash(quote! { pub fn f(x: i32) { g() } }), hash);
+        assert_ne!(tokens_to_api_hash(quote! { #[doc(hidden)] pub fn f(x: i32) {} }), hash);
+        assert_ne!(tokens_to_api_hash(quote! { a b }), tokens_to_api_hash(quote! { ab }));
+    }
+
+    #[gtest]
+    fn test_split_top_level_items() -> Result<()> {
+        let input = quote! {
+            struct X {} __NEWLINE__
+            const Y: X = X {}; __NEWLINE__ __NEWLINE__
+            fn f() { a; __NEWLINE__ b; } __NEWLINE__
+            type Z = X;
+        };
+        assert_eq!(
+            split_top_level_items(input)?,
+            vec!["struct X{  }\n", "const Y: X=X{  };\n", "\nfn f(){ a;\nb; }\n", "type Z=X;",]
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_rs_tokens_to_formatted_string_in_chunks() -> Result<()> {
+        let input = quote! {
+            fn foo() {} __NEWLINE__
+            __NEWLINE__
+            fn bar() {} __NEWLINE__
+            fn baz() {}
+        };
+        assert_eq!(
+            rs_tokens_to_formatted_string_in_chunks(input, &RustfmtConfig::for_testing(), 1)?,
+            "fn foo() {}\n\nfn bar() {}\nfn baz() {}\n"
+        );
+        Ok(())
+    }
 }
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -20,6 +21,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "lifetime_analysis/function_lifetimes_cache.h"
 #include "lifetime_analysis/lifetime_analysis.h"
 #include "lifetime_analysis/lifetime_constraints.h"
 #include "lifetime_analysis/lifetime_lattice.h"
@@ -32,12 +34,14 @@
 #include "lifetime_annotations/lifetime.h"
 #include "lifetime_annotations/lifetime_annotations.h"
 #include "lifetime_annotations/lifetime_substitutions.h"
+#include "lifetime_annotations/pointee_type.h"
 #include "lifetime_annotations/type_lifetimes.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/Type.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "clang/ASTMatchers/ASTMatchers.h"
@@ -50,15 +54,19 @@
 #include "clang/Basic/DiagnosticIDs.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Index/USRGeneration.h"
 #include "clang/Lex/Lexer.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace clang {
@@ -320,9 +328,7 @@ std::string CfgBlockLabel(const clang::CFGBlock* block, const clang::CFG& cfg,
 
 std::string CreateCfgDot(
     const clang::CFG& cfg, const clang::ASTContext& ast_context,
-    const std::vector<
-        std::optional<clang::dataflow::DataflowAnalysisState<LifetimeLattice>>>&
-        block_to_output_state,
+    const std::vector<std::optional<LifetimeLattice>>& block_to_output_state,
     const ObjectRepository& object_repository) {
   std::string result = "digraph d {\ncompound=true;\nedge [minlen=2];\n";
 
@@ -347,7 +353,7 @@ std::string CreateCfgDot(
 
     const auto& block_state = block_to_output_state[id];
     if (block_state) {
-      auto lattice = block_state->Lattice;
+      const LifetimeLattice& lattice = *block_state;
       if (!lattice.IsError()) {
         absl::StrAppend(&result,
                         PointsToEdgesDot(object_repository, lattice.PointsTo(),
@@ -540,7 +546,8 @@ llvm::Error AnalyzeFunctionBody(
         callee_lifetimes,
     const DiagnosticReporter& diag_reporter,
     ObjectRepository& object_repository, PointsToMap& points_to_map,
-    LifetimeConstraints& constraints, std::string* cfg_dot) {
+    LifetimeConstraints& constraints, std::string* cfg_dot,
+    FunctionAnalysisStats* stats) {
   auto acfg = clang::dataflow::AdornedCFG::build(*func);
   if (!acfg) return acfg.takeError();
 
@@ -551,10 +558,10 @@ llvm::Error AnalyzeFunctionBody(
   LifetimeAnalysis analysis(func, object_repository, callee_lifetimes,
                             diag_reporter);
 
-  llvm::Expected<std::vector<
-      std::optional<clang::dataflow::DataflowAnalysisState<LifetimeLattice>>>>
-      maybe_block_to_output_state =
-          clang::dataflow::runDataflowAnalysis(*acfg, analysis, environment);
+  llvm::Expected<std::vector<std::optional<LifetimeLattice>>>
+      maybe_block_to_output_state = RunLifetimeAnalysis(
+          *acfg, analysis, environment, stats ? &stats->num_joins : nullptr);
+  if (stats) stats->num_transfers += analysis.NumTransfers();
   if (!maybe_block_to_output_state) {
     return maybe_block_to_output_state.takeError();
   }
@@ -570,7 +577,7 @@ llvm::Error AnalyzeFunctionBody(
                      "' unexpectedly does not exist"));
   }
 
-  auto exit_lattice = exit_block_state->Lattice;
+  auto exit_lattice = *exit_block_state;
   if (exit_lattice.IsError()) {
     return llvm::createStringError(llvm::inconvertibleErrorCode(),
                                    exit_lattice.Error());
@@ -621,7 +628,18 @@ llvm::Error AnalyzeFunctionBody(
 llvm::Expected<FunctionAnalysis> AnalyzeSingleFunction(
     const clang::FunctionDecl* func,
     const FunctionLifetimesMap& callee_lifetimes,
-    const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info) {
+    const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info,
+    FunctionAnalysisStatsMap* stats_map) {
+  FunctionAnalysisStats* stats =
+      stats_map ? &(*stats_map)[func->getCanonicalDecl()] : nullptr;
+  auto start_time = std::chrono::steady_clock::now();
+  auto record_time = llvm::make_scope_exit([stats, start_time]() {
+    if (stats) {
+      stats->time += std::chrono::steady_clock::now() - start_time;
+      ++stats->num_analyses;
+    }
+  });
+
   llvm::Expected<ObjectRepository> object_repository =
       ObjectRepository::Create(func, callee_lifetimes);
   if (auto err = object_repository.takeError()) {
@@ -664,7 +682,7 @@ llvm::Expected<FunctionAnalysis> AnalyzeSingleFunction(
     std::string* cfg_dot = debug_info ? &(*debug_info)[func].cfg_dot : nullptr;
     if (llvm::Error err = AnalyzeFunctionBody(
             func, callee_lifetimes, diag_reporter, analysis.object_repository,
-            analysis.points_to_map, analysis.constraints, cfg_dot)) {
+            analysis.points_to_map, analysis.constraints, cfg_dot, stats)) {
       return std::move(err);
     }
   } else {
@@ -686,6 +704,17 @@ llvm::Expected<FunctionAnalysis> AnalyzeSingleFunction(
         ConstraintsDot(analysis.object_repository, analysis.constraints);
   }
 
+  if (stats) {
+    stats->num_objects = analysis.object_repository.NumObjects();
+    stats->num_pointers = analysis.points_to_map.PointerPointsTos().size();
+    stats->num_points_to_edges = 0;
+    for (const auto& [_, pointees] :
+         analysis.points_to_map.PointerPointsTos()) {
+      stats->num_points_to_edges += pointees.size();
+    }
+    stats->num_constraints = analysis.constraints.AllConstraints().size();
+  }
+
   if (llvm::Error err =
           PropagateStaticToPointees(analysis.subst, analysis.points_to_map)) {
     return std::move(err);
@@ -1015,9 +1044,11 @@ llvm::Error UpdateFunctionLifetimesWithOverrides(
 
 llvm::Error AnalyzeRecursiveFunctions(
     llvm::ArrayRef<VisitedCallStackEntry> funcs, FunctionLifetimesMap& analyzed,
-    const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info) {
+    const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info,
+    FunctionAnalysisStatsMap* stats) {
   for (const auto [func, in_cycle, _] : funcs) {
     assert(in_cycle);
+    if (stats) (*stats)[func->getCanonicalDecl()].cycle_size = funcs.size();
 
     // Construct an initial FunctionLifetimes for each function in the cycle,
     // without doing a dataflow analysis, which would need other functions
@@ -1055,8 +1086,8 @@ llvm::Error AnalyzeRecursiveFunctions(
     }
 
     for (const auto [func, in_cycle, _] : funcs) {
-      auto analysis_result =
-          AnalyzeSingleFunction(func, analyzed, diag_reporter, debug_info);
+      auto analysis_result = AnalyzeSingleFunction(
+          func, analyzed, diag_reporter, debug_info, stats);
       if (!analysis_result) {
         return analysis_result.takeError();
       }
@@ -1065,12 +1096,10 @@ llvm::Error AnalyzeRecursiveFunctions(
       if (!func_lifetimes_result) {
         return func_lifetimes_result.takeError();
       }
-      // TODO(danakj): We can avoid this structural comparison and just do a
-      // check for equality if AnalyzeSingleFunction would reuse Lifetimes
-      // from the existing FunctionLifetime for its parameters/return/this.
-      // Currently it makes a new set of Lifetimes each time we do the analyze
-      // step, but the actual Lifetime ids aren't meaningful, only where and
-      // how often a given Lifetime repeats is meaningful.
+      // AnalyzeSingleFunction makes a new set of Lifetimes each time we do the
+      // analyze step, but the actual Lifetime ids aren't meaningful, only where
+      // and how often a given Lifetime repeats is meaningful, so compare the
+      // results structurally.
       FunctionLifetimesOrError& existing_result =
           analyzed[func->getCanonicalDecl()];
       if (std::holds_alternative<FunctionLifetimes>(existing_result) &&
@@ -1085,6 +1114,98 @@ llvm::Error AnalyzeRecursiveFunctions(
   return llvm::Error::success();
 }
 
+// Returns whether values of `type` can't have lifetimes, or refer to objects
+// that have lifetimes. Pointers and references to functions are allowed if the
+// function's signature only has such types. Records are never allowed, as they
+// may have lifetime parameters, and methods called on them get a `this`
+// pointer.
+bool IsValueType(clang::QualType type) {
+  type = type.getCanonicalType();
+  if (clang::QualType pointee = PointeeType(type); !pointee.isNull()) {
+    return pointee->isFunctionProtoType() && IsValueType(pointee);
+  }
+  if (const auto* func_type = type->getAs<clang::FunctionProtoType>()) {
+    return IsValueType(func_type->getReturnType()) &&
+           llvm::all_of(func_type->getParamTypes(), IsValueType);
+  }
+  if (const clang::ArrayType* array_type = type->getAsArrayTypeUnsafe()) {
+    return IsValueType(array_type->getElementType());
+  }
+  return !type->isRecordType() && !type->isMemberPointerType() &&
+         !type->isFunctionType() && !type->isObjCObjectPointerType() &&
+         !type->isBlockPointerType() && !type->isDependentType();
+}
+
+// Finds expressions and variables in a function body that may take part in
+// pointer flow, and references to callees whose lifetimes are unknown.
+class PointerFlowFinder : public clang::RecursiveASTVisitor<PointerFlowFinder> {
+ public:
+  explicit PointerFlowFinder(const FunctionLifetimesMap& callee_lifetimes)
+      : callee_lifetimes_(callee_lifetimes) {}
+
+  bool VisitExpr(clang::Expr* expr) {
+    found_ = !IsValueType(expr->getType());
+    return !found_;
+  }
+
+  bool VisitVarDecl(clang::VarDecl* var) {
+    found_ = !IsValueType(var->getType());
+    return !found_;
+  }
+
+  bool VisitDeclRefExpr(clang::DeclRefExpr* decl_ref) {
+    // The dataflow analysis fails if it doesn't know the lifetimes of a
+    // callee, even if they are trivial.
+    if (const auto* callee =
+            clang::dyn_cast<clang::FunctionDecl>(decl_ref->getDecl())) {
+      found_ = std::holds_alternative<FunctionAnalysisError>(
+          GetFunctionLifetimes(callee, callee_lifetimes_));
+    }
+    return !found_;
+  }
+
+  bool found() const { return found_; }
+
+ private:
+  const FunctionLifetimesMap& callee_lifetimes_;
+  bool found_ = false;
+};
+
+// Returns the lifetimes of `func` if it is a function without pointer flow,
+// i.e. neither its signature nor its body have pointer-like types. For such a
+// function, the dataflow analysis could only produce trivial lifetimes, so it
+// doesn't need to run.
+std::optional<FunctionLifetimes> GetLifetimesWithoutPointerFlow(
+    const clang::FunctionDecl* func,
+    const FunctionLifetimesMap& callee_lifetimes) {
+  if (const auto* method = clang::dyn_cast<clang::CXXMethodDecl>(func);
+      method && !method->isStatic()) {
+    return std::nullopt;
+  }
+  const clang::FunctionDecl* definition = func->getDefinition();
+  if (definition == nullptr || definition->getBody() == nullptr ||
+      !IsValueType(definition->getType())) {
+    return std::nullopt;
+  }
+
+  PointerFlowFinder finder(callee_lifetimes);
+  finder.TraverseStmt(definition->getBody());
+  if (finder.found()) return std::nullopt;
+
+  FunctionLifetimes lifetimes;
+  if (llvm::Error err =
+          FunctionLifetimes::CreateForDecl(
+              func, FunctionLifetimeFactorySingleCallback(
+                        [](const clang::Expr*) -> llvm::Expected<Lifetime> {
+                          return Lifetime::CreateVariable();
+                        }))
+              .moveInto(lifetimes)) {
+    llvm::consumeError(std::move(err));
+    return std::nullopt;
+  }
+  return lifetimes;
+}
+
 // The entry point for analyzing a function named by `func`.
 //
 // This function is recursive as it searches for and walks through all CallExpr
@@ -1104,6 +1225,9 @@ llvm::Error AnalyzeRecursiveFunctions(
 //    affect the callers to it.
 // 4. Thus we repeat step 3 until we see that the FunctionLifetimes have stopped
 //    changing when we analyze each function in the cycle.
+//
+// This runs on a single thread; see `AnalyzeTranslationUnit()` for why the
+// cycles of the call graph are not analyzed in parallel.
 void AnalyzeFunctionRecursive(
     llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>&
         analyzed,
@@ -1111,7 +1235,8 @@ void AnalyzeFunctionRecursive(
     const clang::FunctionDecl* func,
     const LifetimeAnnotationContext& lifetime_context,
     const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info,
-    const BaseToOverrides& base_to_overrides) {
+    const BaseToOverrides& base_to_overrides, FunctionLifetimesCache* cache,
+    FunctionAnalysisStatsMap* stats) {
   // Make sure we're always using the canonical declaration when using the
   // function as a key in maps and sets.
   func = func->getCanonicalDecl();
@@ -1188,7 +1313,8 @@ void AnalyzeFunctionRecursive(
       continue;
     }
     AnalyzeFunctionRecursive(analyzed, visited, callee, lifetime_context,
-                             diag_reporter, debug_info, base_to_overrides);
+                             diag_reporter, debug_info, base_to_overrides,
+                             cache, stats);
   }
 
   llvm::DenseSet<const clang::CXXMethodDecl*> bases;
@@ -1206,7 +1332,8 @@ void AnalyzeFunctionRecursive(
       GetBaseMethods(cxxmethod, bases);
       for (const auto* base : bases) {
         AnalyzeFunctionRecursive(analyzed, visited, base, lifetime_context,
-                                 diag_reporter, debug_info, base_to_overrides);
+                                 diag_reporter, debug_info, base_to_overrides,
+                                 cache, stats);
       }
     } else {
       // We are in an overrides traversal for a virtual method starting from its
@@ -1218,8 +1345,8 @@ void AnalyzeFunctionRecursive(
         overrides = iter->second;
         for (const auto* derived : overrides) {
           AnalyzeFunctionRecursive(analyzed, visited, derived, lifetime_context,
-                                   diag_reporter, debug_info,
-                                   base_to_overrides);
+                                   diag_reporter, debug_info, base_to_overrides,
+                                   cache, stats);
         }
       }
     }
@@ -1257,11 +1384,31 @@ void AnalyzeFunctionRecursive(
   }
   if (!visited[func_in_visited].in_cycle) {
     // Case 2. Not part of a cycle.
+    std::optional<std::string> cache_key;
+    std::optional<FunctionLifetimes> cached;
+    std::optional<FunctionLifetimes> without_pointer_flow;
     if (bases.empty()) {
+      without_pointer_flow = GetLifetimesWithoutPointerFlow(func, analyzed);
+    }
+    if (cache != nullptr && bases.empty() && !without_pointer_flow) {
+      llvm::SmallVector<const clang::FunctionDecl*> callees(
+          maybe_callees.get().begin(), maybe_callees.get().end());
+      cache_key = FunctionLifetimesCache::GetKey(func, callees, analyzed,
+                                                 lifetime_context);
+      if (cache_key.has_value()) cached = cache->Lookup(func, *cache_key);
+    }
+    if (without_pointer_flow.has_value()) {
+      analyzed[func] = *std::move(without_pointer_flow);
+    } else if (cached.has_value()) {
+      // Analyzed before, possibly in another translation unit, with the same
+      // definition and callee lifetimes. Diagnostics, debug info and stats are
+      // only produced by that analysis.
+      analyzed[func] = *std::move(cached);
+    } else if (bases.empty()) {
       // This function is not where we initiated an overrides traversal from its
       // base methods.
-      auto analysis_result =
-          AnalyzeSingleFunction(func, analyzed, diag_reporter, debug_info);
+      auto analysis_result = AnalyzeSingleFunction(
+          func, analyzed, diag_reporter, debug_info, stats);
       if (!analysis_result) {
         analyzed[func] = FunctionAnalysisError(analysis_result.takeError());
       } else {
@@ -1271,6 +1418,9 @@ void AnalyzeFunctionRecursive(
           analyzed[func] =
               FunctionAnalysisError(func_lifetimes_result.takeError());
         } else {
+          if (cache_key.has_value()) {
+            cache->Insert(*cache_key, func_lifetimes_result.get());
+          }
           analyzed[func] = func_lifetimes_result.get();
         }
       }
@@ -1287,7 +1437,7 @@ void AnalyzeFunctionRecursive(
         llvm::ArrayRef<VisitedCallStackEntry>(visited).drop_front(
             func_in_visited);
     if (llvm::Error err = AnalyzeRecursiveFunctions(
-            funcs_in_cycle, analyzed, diag_reporter, debug_info)) {
+            funcs_in_cycle, analyzed, diag_reporter, debug_info, stats)) {
       for (const auto [func_in_cycle, _1, _2] : funcs_in_cycle) {
         analyzed[func_in_cycle] = FunctionAnalysisError(err);
       }
@@ -1316,7 +1466,8 @@ AnalyzeTranslationUnitAndCollectTemplates(
     const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info,
     llvm::DenseMap<clang::FunctionTemplateDecl*, const clang::FunctionDecl*>&
         uninstantiated_templates,
-    const BaseToOverrides& base_to_overrides) {
+    const BaseToOverrides& base_to_overrides, FunctionLifetimesCache* cache,
+    FunctionAnalysisStatsMap* stats) {
   llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError> result;
   llvm::SmallVector<VisitedCallStackEntry> visited;
 
@@ -1344,7 +1495,8 @@ AnalyzeTranslationUnitAndCollectTemplates(
     // function before.
 
     AnalyzeFunctionRecursive(result, visited, func, lifetime_context,
-                             diag_reporter, debug_info, base_to_overrides);
+                             diag_reporter, debug_info, base_to_overrides,
+                             cache, stats);
   }
 
   return result;
@@ -1362,8 +1514,8 @@ std::string GetFunctionUSRString(const clang::Decl* func) {
 }
 
 // Run AnalyzeFunctionRecursive with `context`. Report results through
-// `result_callback` and update `debug_info` using USR strings to map functions
-// to the original ASTContext.
+// `result_callback` and update `debug_info` and `stats` using USR strings to
+// map functions to the original ASTContext.
 void AnalyzeTemplateFunctionsInSeparateASTContext(
     const LifetimeAnnotationContext& lifetime_context,
     const llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>&
@@ -1372,20 +1524,29 @@ void AnalyzeTemplateFunctionsInSeparateASTContext(
     const DiagnosticReporter& diag_reporter, FunctionDebugInfoMap* debug_info,
     const std::map<std::string, const clang::FunctionDecl*>&
         template_usr_to_decl,
-    const BaseToOverrides& base_to_overrides, clang::ASTContext& context) {
+    const BaseToOverrides& base_to_overrides, FunctionLifetimesCache* cache,
+    FunctionAnalysisStatsMap* stats, clang::ASTContext& context) {
   llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
       inner_result;
   llvm::SmallVector<VisitedCallStackEntry> inner_visited;
   FunctionDebugInfoMap inner_debug_info;
+  FunctionAnalysisStatsMap inner_stats;
 
   for (const clang::FunctionDecl* func :
        GetAllFunctionDefinitions(context.getTranslationUnitDecl())) {
-    // Skip templated functions.
-    if (func->isTemplated()) continue;
+    // Only the placeholder instantiations need to be analyzed; the results for
+    // the other functions of the original translation unit are already known.
+    // Those that the instantiations call are analyzed again as their callees,
+    // or found in `cache`.
+    if (func->isTemplated() || !func->isFunctionTemplateSpecialization()) {
+      continue;
+    }
+    auto* tmpl = func->getTemplateSpecializationInfo()->getTemplate();
+    if (!template_usr_to_decl.count(GetFunctionUSRString(tmpl))) continue;
 
     AnalyzeFunctionRecursive(inner_result, inner_visited, func,
                              lifetime_context, diag_reporter, &inner_debug_info,
-                             base_to_overrides);
+                             base_to_overrides, cache, &inner_stats);
   }
 
   // We need to remap the results with FunctionDecl* in the
@@ -1410,6 +1571,16 @@ void AnalyzeTemplateFunctionsInSeparateASTContext(
     auto iter = template_usr_to_decl.find(GetFunctionUSRString(tmpl));
     if (iter != template_usr_to_decl.end()) (*debug_info)[iter->second] = info;
   }
+  if (stats) {
+    for (const auto& [decl, func_stats] : inner_stats) {
+      if (!decl->isFunctionTemplateSpecialization()) continue;
+      auto* tmpl = decl->getTemplateSpecializationInfo()->getTemplate();
+      auto iter = template_usr_to_decl.find(GetFunctionUSRString(tmpl));
+      if (iter != template_usr_to_decl.end()) {
+        (*stats)[iter->second] = func_stats;
+      }
+    }
+  }
 }
 
 DiagnosticReporter DiagReporterForDiagEngine(
@@ -1425,7 +1596,49 @@ DiagnosticReporter DiagReporterForDiagEngine(
 
 }  // namespace
 
+std::string FunctionAnalysisStatsToJson(const FunctionAnalysisStatsMap& stats) {
+  std::vector<std::pair<const clang::FunctionDecl*, FunctionAnalysisStats>>
+      sorted(stats.begin(), stats.end());
+  llvm::sort(sorted, [](const auto& a, const auto& b) {
+    return a.second.time > b.second.time;
+  });
+
+  llvm::json::Array result;
+  for (const auto& [func, func_stats] : sorted) {
+    const clang::SourceManager& source_manager =
+        func->getASTContext().getSourceManager();
+    result.push_back(llvm::json::Object{
+        {"function", func->getQualifiedNameAsString()},
+        {"location", func->getLocation().printToString(source_manager)},
+        {"time_us",
+         std::chrono::duration_cast<std::chrono::microseconds>(func_stats.time)
+             .count()},
+        {"num_analyses", static_cast<int64_t>(func_stats.num_analyses)},
+        {"cycle_size", static_cast<int64_t>(func_stats.cycle_size)},
+        {"num_transfers", static_cast<int64_t>(func_stats.num_transfers)},
+        {"num_joins", static_cast<int64_t>(func_stats.num_joins)},
+        {"num_objects", static_cast<int64_t>(func_stats.num_objects)},
+        {"num_pointers", static_cast<int64_t>(func_stats.num_pointers)},
+        {"num_points_to_edges",
+         static_cast<int64_t>(func_stats.num_points_to_edges)},
+        {"num_constraints", static_cast<int64_t>(func_stats.num_constraints)},
+    });
+  }
+
+  std::string json;
+  llvm::raw_string_ostream os(json);
+  os << llvm::json::Value(std::move(result));
+  os.flush();
+  return json;
+}
+
 bool IsIsomorphic(const FunctionLifetimes& a, const FunctionLifetimes& b) {
+  // Equal canonical forms are the common case when iterating a recursive cycle
+  // to a fixpoint, and are much cheaper to check than substitution
+  // constraints.
+  if (a.CanonicalForm() == b.CanonicalForm()) {
+    return true;
+  }
   return LifetimeConstraints::ForCallableSubstitution(a, b)
              .AllConstraints()
              .empty() &&
@@ -1448,7 +1661,8 @@ FunctionLifetimesOrError AnalyzeFunction(
       DiagReporterForDiagEngine(func->getASTContext().getDiagnostics());
   AnalyzeFunctionRecursive(
       analyzed, visited, func, lifetime_context, diag_reporter,
-      debug_info_map ? &debug_info_map.value() : nullptr, BaseToOverrides());
+      debug_info_map ? &debug_info_map.value() : nullptr, BaseToOverrides(),
+      /*cache=*/nullptr, /*stats=*/nullptr);
   if (debug_info) {
     *debug_info = debug_info_map->lookup(func);
   }
@@ -1459,7 +1673,9 @@ llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
 AnalyzeTranslationUnit(const clang::TranslationUnitDecl* tu,
                        const LifetimeAnnotationContext& lifetime_context,
                        DiagnosticReporter diag_reporter,
-                       FunctionDebugInfoMap* debug_info) {
+                       FunctionDebugInfoMap* debug_info,
+                       FunctionLifetimesCache* cache,
+                       FunctionAnalysisStatsMap* stats) {
   if (!diag_reporter) {
     diag_reporter =
         DiagReporterForDiagEngine(tu->getASTContext().getDiagnostics());
@@ -1476,7 +1692,7 @@ AnalyzeTranslationUnit(const clang::TranslationUnitDecl* tu,
   llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError> result =
       AnalyzeTranslationUnitAndCollectTemplates(
           tu, lifetime_context, diag_reporter, debug_info,
-          uninstantiated_templates, base_to_overrides);
+          uninstantiated_templates, base_to_overrides, cache, stats);
 
   return result;
 }
@@ -1485,7 +1701,8 @@ void AnalyzeTranslationUnitWithTemplatePlaceholder(
     const clang::TranslationUnitDecl* tu,
     const LifetimeAnnotationContext& lifetime_context,
     const FunctionAnalysisResultCallback& result_callback,
-    DiagnosticReporter diag_reporter, FunctionDebugInfoMap* debug_info) {
+    DiagnosticReporter diag_reporter, FunctionDebugInfoMap* debug_info,
+    FunctionLifetimesCache* cache, FunctionAnalysisStatsMap* stats) {
   if (!diag_reporter) {
     diag_reporter =
         DiagReporterForDiagEngine(tu->getASTContext().getDiagnostics());
@@ -1499,10 +1716,17 @@ void AnalyzeTranslationUnitWithTemplatePlaceholder(
   // all the base methods that this TU implements.
   auto base_to_overrides = BuildBaseToOverrides(tu);
 
+  // The placeholder instantiations are analyzed in a separate ASTContext, where
+  // the functions of this TU that they call need to be analyzed again. Without
+  // a `cache` from the caller, a cache for this TU avoids repeating those
+  // analyses.
+  FunctionLifetimesCache tu_cache;
+  if (cache == nullptr) cache = &tu_cache;
+
   llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
       initial_result = AnalyzeTranslationUnitAndCollectTemplates(
           tu, lifetime_context, diag_reporter, debug_info,
-          uninstantiated_templates, base_to_overrides);
+          uninstantiated_templates, base_to_overrides, cache, stats);
 
   // Make a map from USRString to funcDecls in the original ASTContext.
   std::map<std::string, const clang::FunctionDecl*> template_usr_to_decl;
@@ -1525,11 +1749,12 @@ void AnalyzeTranslationUnitWithTemplatePlaceholder(
   // placeholders. This is passed to RunToolOnCodeWithOverlay below.
   auto analyze_with_placeholder =
       [&lifetime_context, &initial_result, &result_callback, &diag_reporter,
-       &debug_info, &template_usr_to_decl,
-       &base_to_overrides](clang::ASTContext& context) {
+       &debug_info, &template_usr_to_decl, &base_to_overrides, cache,
+       stats](clang::ASTContext& context) {
         AnalyzeTemplateFunctionsInSeparateASTContext(
             lifetime_context, initial_result, result_callback, diag_reporter,
-            debug_info, template_usr_to_decl, base_to_overrides, context);
+            debug_info, template_usr_to_decl, base_to_overrides, cache, stats,
+            context);
       };
 
   // Run `analyze_with_placeholder` in a separate ASTContext on top of an
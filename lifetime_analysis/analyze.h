@@ -5,9 +5,12 @@
 #ifndef DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_ANALYZE_H_
 #define DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_ANALYZE_H_
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <string>
 
+#include "lifetime_analysis/function_lifetimes_cache.h"
 #include "lifetime_analysis/lifetime_analysis.h"
 #include "lifetime_annotations/function_lifetimes.h"
 #include "lifetime_annotations/lifetime_annotations.h"
@@ -36,6 +39,50 @@ struct FunctionDebugInfo {
   std::string constraints_dot;
 };
 
+// Numeric statistics about the lifetime analysis of a single function, for
+// finding the functions that make the analysis of a translation unit slow.
+struct FunctionAnalysisStats {
+  // Time spent analyzing the function, summed over all its analyses.
+  std::chrono::nanoseconds time{0};
+
+  // Number of times the function was analyzed. Functions in a recursive cycle
+  // are analyzed repeatedly, until the lifetimes of the cycle converge.
+  size_t num_analyses = 0;
+
+  // Number of functions in the recursive cycle containing the function, or 1
+  // if it is not part of a cycle.
+  size_t cycle_size = 1;
+
+  // Number of CFG elements processed by the dataflow analysis, summed over
+  // all analyses of the function.
+  size_t num_transfers = 0;
+
+  // Number of joins of lattices at the start of basic blocks, summed over all
+  // analyses of the function.
+  size_t num_joins = 0;
+
+  // The following are for the last analysis of the function.
+
+  // Number of `Object`s in the function's ObjectRepository.
+  size_t num_objects = 0;
+
+  // Number of pointers, and of pointer-to-pointee edges, in the exit-block's
+  // points-to map.
+  size_t num_pointers = 0;
+  size_t num_points_to_edges = 0;
+
+  // Number of constraints between lifetimes.
+  size_t num_constraints = 0;
+};
+
+// A map from an analyzed function to the corresponding statistics.
+using FunctionAnalysisStatsMap =
+    llvm::DenseMap<const clang::FunctionDecl*, FunctionAnalysisStats>;
+
+// Returns `stats` as a JSON array with an object for each function, with the
+// function's qualified name and location. The slowest functions come first.
+std::string FunctionAnalysisStatsToJson(const FunctionAnalysisStatsMap& stats);
+
 // Returns if the two FunctionLifetimes have the same structures, without
 // requiring them to have the same exact Lifetimes. They have the same
 // structure if unique vs reoccuring Lifetimes in `a` and `b` are found
@@ -54,11 +101,26 @@ FunctionLifetimesOrError AnalyzeFunction(
 
 // Runs a static analysis on all function definitions in `tu`.
 // The map that is returned references functions by their canonical declaration.
+// If `cache` is provided, functions whose lifetimes are cached are not
+// analyzed again, and the lifetimes of analyzed functions are added to it.
+// If `stats` is provided, statistics for each analyzed function are added to
+// it.
+//
+// Functions are analyzed one at a time, callees first. Independent parts of
+// the call graph are not analyzed concurrently, because all functions share
+// `tu`'s ASTContext, which the analysis modifies without synchronization
+// (e.g. building CFGs and lazily deserializing declarations), and because
+// diagnostics go to a single DiagnosticsEngine. The analysis of a virtual
+// method may also update the results of its base methods, which would order
+// otherwise independent functions. Separate translation units can be analyzed
+// in parallel.
 llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
 AnalyzeTranslationUnit(const clang::TranslationUnitDecl* tu,
                        const LifetimeAnnotationContext& lifetime_context,
                        DiagnosticReporter diag_reporter = {},
-                       FunctionDebugInfoMap* debug_info = nullptr);
+                       FunctionDebugInfoMap* debug_info = nullptr,
+                       FunctionLifetimesCache* cache = nullptr,
+                       FunctionAnalysisStatsMap* stats = nullptr);
 
 // Callback that is used to report function analysis results.
 // Do not retain the `FunctionDecl*`, the `FunctionLifetimes`, or other objects
@@ -73,12 +135,15 @@ using FunctionAnalysisResultCallback =
 // Runs a static analysis on all function definitions in `tu`.
 // Analyzes and reports results for uninstantiated templates by instantiating
 // them with placeholder types, reporting results via `result_callback`.
+// `cache` and `stats` are as for `AnalyzeTranslationUnit()`.
 void AnalyzeTranslationUnitWithTemplatePlaceholder(
     const clang::TranslationUnitDecl* tu,
     const LifetimeAnnotationContext& lifetime_context,
     const FunctionAnalysisResultCallback& result_callback,
     DiagnosticReporter diag_reporter = {},
-    FunctionDebugInfoMap* debug_info = nullptr);
+    FunctionDebugInfoMap* debug_info = nullptr,
+    FunctionLifetimesCache* cache = nullptr,
+    FunctionAnalysisStatsMap* stats = nullptr);
 
 }  // namespace lifetimes
 }  // namespace tidy
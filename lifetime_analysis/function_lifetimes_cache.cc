@@ -0,0 +1,265 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "lifetime_analysis/function_lifetimes_cache.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "lifetime_annotations/function_lifetimes.h"
+#include "lifetime_annotations/lifetime.h"
+#include "lifetime_annotations/lifetime_annotations.h"
+#include "lifetime_annotations/lifetime_substitutions.h"
+#include "lifetime_annotations/type_lifetimes.h"
+#include "clang/AST/Attr.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ODRHash.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Index/USRGeneration.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+namespace clang {
+namespace tidy {
+namespace lifetimes {
+namespace {
+
+// Encodes the lifetime at each position of `lifetimes`, in the order of
+// `FunctionLifetimes::Traverse()`, as "s" for 'static or as the index of the
+// first position with the same lifetime variable. Returns nullopt if
+// `lifetimes` contains other lifetimes, e.g. local lifetimes.
+std::optional<std::string> EncodeLifetimes(
+    const FunctionLifetimes& lifetimes) {
+  std::string result;
+  llvm::DenseMap<Lifetime, size_t> variables;
+  bool ok = true;
+  lifetimes.Traverse([&](const Lifetime& lifetime, Variance) {
+    if (!result.empty()) result += ' ';
+    if (lifetime == Lifetime::Static()) {
+      result += 's';
+    } else if (lifetime.IsVariable()) {
+      size_t index = variables.size();
+      absl::StrAppend(&result, variables.try_emplace(lifetime, index)
+                                   .first->second);
+    } else {
+      ok = false;
+    }
+  });
+  if (!ok) return std::nullopt;
+  return result;
+}
+
+// Recreates the lifetimes encoded by `EncodeLifetimes()` for `func`. Returns
+// nullopt if they don't fit the signature of `func`.
+std::optional<FunctionLifetimes> DecodeLifetimes(
+    const clang::FunctionDecl* func, llvm::StringRef encoded) {
+  FunctionLifetimes result;
+  if (llvm::Error err =
+          FunctionLifetimes::CreateForDecl(
+              func, FunctionLifetimeFactorySingleCallback(
+                        [](const clang::Expr*) -> llvm::Expected<Lifetime> {
+                          return Lifetime::CreateVariable();
+                        }))
+              .moveInto(result)) {
+    llvm::consumeError(std::move(err));
+    return std::nullopt;
+  }
+
+  llvm::SmallVector<llvm::StringRef> tokens;
+  encoded.split(tokens, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  // The lifetime that each fresh lifetime of `result` is replaced with.
+  llvm::DenseMap<Lifetime, Lifetime> replacements;
+  // The first fresh lifetime at which each encoded variable appears.
+  llvm::SmallVector<Lifetime> variables;
+  size_t position = 0;
+  bool ok = true;
+  std::as_const(result).Traverse([&](const Lifetime& lifetime, Variance) {
+    if (!ok || position == tokens.size()) {
+      ok = false;
+      return;
+    }
+    llvm::StringRef token = tokens[position++];
+    std::optional<Lifetime> replacement;
+    size_t index;
+    if (token == "s") {
+      replacement = Lifetime::Static();
+    } else if (!token.getAsInteger(10, index) && index <= variables.size()) {
+      if (index == variables.size()) variables.push_back(lifetime);
+      replacement = variables[index];
+    } else {
+      ok = false;
+      return;
+    }
+    auto [iter, inserted] = replacements.try_emplace(lifetime, *replacement);
+    if (!inserted && iter->second != *replacement) ok = false;
+  });
+  if (!ok || position != tokens.size()) return std::nullopt;
+
+  LifetimeSubstitutions subst;
+  for (const auto& [fresh, replacement] : replacements) {
+    subst.Add(fresh, replacement);
+  }
+  result.SubstituteLifetimes(subst);
+  return result;
+}
+
+std::optional<std::string> GetUSR(const clang::Decl* decl) {
+  llvm::SmallString</*inline size=*/128> usr;
+  if (clang::index::generateUSRForDecl(decl, usr)) return std::nullopt;
+  return std::string(usr);
+}
+
+// Appends what the lifetime annotations of `func` are read from to `out`: the
+// canonical type of `func`, and for each of its declarations, the type as
+// written (which keeps `annotate_type` attributes), the attributes (e.g.
+// `lifetimes` annotations of `this`) and whether the `lifetime_elision` pragma
+// applies.
+void AppendAnnotationInputs(const clang::FunctionDecl* func,
+                            const LifetimeAnnotationContext& lifetime_context,
+                            std::string& out) {
+  const clang::ASTContext& ast_context = func->getASTContext();
+  const clang::SourceManager& source_manager = ast_context.getSourceManager();
+  llvm::raw_string_ostream os(out);
+  os << "\n" << func->getType().getCanonicalType().getAsString();
+  for (const clang::FunctionDecl* redecl : func->redecls()) {
+    os << "\n" << redecl->getType().getAsString();
+    for (const clang::Attr* attr : redecl->attrs()) {
+      attr->printPretty(os, ast_context.getPrintingPolicy());
+    }
+    clang::FileID file_id =
+        source_manager.getFileID(redecl->getSourceRange().getBegin());
+    os << (lifetime_context.lifetime_elision_files.contains(file_id)
+               ? "\telided"
+               : "\tunelided");
+  }
+}
+
+}  // namespace
+
+llvm::Expected<FunctionLifetimesCache> FunctionLifetimesCache::Parse(
+    llvm::StringRef text) {
+  FunctionLifetimesCache result;
+  llvm::SmallVector<llvm::StringRef> lines;
+  text.split(lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (llvm::StringRef line : lines) {
+    // Each line is "<USR>\t<fingerprint>\t<lifetimes>".
+    auto [key, encoded] = line.rsplit('\t');
+    if (!key.contains('\t')) {
+      return llvm::createStringError(
+          llvm::inconvertibleErrorCode(),
+          absl::StrCat("malformed lifetimes cache entry: ", line.str()));
+    }
+    result.summaries_[key] = encoded.str();
+  }
+  return result;
+}
+
+std::string FunctionLifetimesCache::Serialize() const {
+  std::vector<std::pair<llvm::StringRef, llvm::StringRef>> entries;
+  for (const auto& entry : summaries_) {
+    entries.emplace_back(entry.getKey(), entry.getValue());
+  }
+  llvm::sort(entries);
+  std::string result;
+  for (const auto& [key, encoded] : entries) {
+    absl::StrAppend(&result, key.str(), "\t", encoded.str(), "\n");
+  }
+  return result;
+}
+
+std::optional<std::string> FunctionLifetimesCache::GetKey(
+    const clang::FunctionDecl* func,
+    llvm::ArrayRef<const clang::FunctionDecl*> callees,
+    const FunctionLifetimesMap& analyzed,
+    const LifetimeAnnotationContext& lifetime_context) {
+  const clang::FunctionDecl* definition = nullptr;
+  if (!func->hasBody(definition)) return std::nullopt;
+  std::optional<std::string> usr = GetUSR(func);
+  if (!usr.has_value()) return std::nullopt;
+
+  const clang::ASTContext& ast_context = func->getASTContext();
+  const clang::SourceManager& source_manager = ast_context.getSourceManager();
+  bool invalid = false;
+  llvm::StringRef text = clang::Lexer::getSourceText(
+      source_manager.getExpansionRange(definition->getSourceRange()),
+      source_manager, ast_context.getLangOpts(), &invalid);
+  if (invalid || text.empty()) return std::nullopt;
+
+  // The analysis of `func` depends on its definition, on its annotations and
+  // on the lifetimes of its callees (which may be defined elsewhere, and
+  // differ between translation units). For template specializations, the
+  // definition is that of the template, and the template arguments are part of
+  // the USR. The source text of the definition doesn't cover the definitions
+  // of macros that it expands, or of the types that it uses. `ODRHash`
+  // does, as it hashes the AST.
+  clang::ODRHash odr_hash;
+  odr_hash.AddFunctionDecl(definition);
+  std::string fingerprint_input =
+      absl::StrCat(text.str(), "\n", odr_hash.CalculateHash());
+  AppendAnnotationInputs(func, lifetime_context, fingerprint_input);
+
+  std::vector<std::pair<std::string, std::string>> callee_lifetimes;
+  for (const clang::FunctionDecl* callee : callees) {
+    std::optional<std::string> callee_usr = GetUSR(callee);
+    if (!callee_usr.has_value()) return std::nullopt;
+    std::string encoded = "?";
+    auto iter = analyzed.find(callee->getCanonicalDecl());
+    if (iter != analyzed.end()) {
+      if (const auto* lifetimes =
+              std::get_if<FunctionLifetimes>(&iter->second)) {
+        std::optional<std::string> maybe_encoded = EncodeLifetimes(*lifetimes);
+        if (!maybe_encoded.has_value()) return std::nullopt;
+        encoded = *std::move(maybe_encoded);
+      } else {
+        encoded = "error";
+      }
+    }
+    // The lifetimes of callees that weren't analyzed in this translation unit
+    // come from their annotations.
+    AppendAnnotationInputs(callee, lifetime_context, encoded);
+    callee_lifetimes.emplace_back(*std::move(callee_usr), std::move(encoded));
+  }
+  llvm::sort(callee_lifetimes);
+
+  for (const auto& [callee_usr, encoded] : callee_lifetimes) {
+    absl::StrAppend(&fingerprint_input, "\n", callee_usr, "\t", encoded);
+  }
+  uint64_t fingerprint = llvm::xxh3_64bits(fingerprint_input);
+  return absl::StrCat(*usr, "\t", absl::Hex(fingerprint, absl::kZeroPad16));
+}
+
+std::optional<FunctionLifetimes> FunctionLifetimesCache::Lookup(
+    const clang::FunctionDecl* func, llvm::StringRef key) {
+  auto iter = summaries_.find(key);
+  if (iter == summaries_.end()) return std::nullopt;
+  std::optional<FunctionLifetimes> result =
+      DecodeLifetimes(func, iter->getValue());
+  if (result.has_value()) ++hits_;
+  return result;
+}
+
+void FunctionLifetimesCache::Insert(llvm::StringRef key,
+                                    const FunctionLifetimes& lifetimes) {
+  if (std::optional<std::string> encoded = EncodeLifetimes(lifetimes)) {
+    summaries_[key] = *std::move(encoded);
+  }
+}
+
+}  // namespace lifetimes
+}  // namespace tidy
+}  // namespace clang
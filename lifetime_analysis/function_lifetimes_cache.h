@@ -0,0 +1,76 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_FUNCTION_LIFETIMES_CACHE_H_
+#define DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_FUNCTION_LIFETIMES_CACHE_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "lifetime_annotations/function_lifetimes.h"
+#include "lifetime_annotations/lifetime_annotations.h"
+#include "clang/AST/Decl.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace clang {
+namespace tidy {
+namespace lifetimes {
+
+// A cache of analyzed function lifetimes that can be shared between the
+// analyses of different translation units, e.g. for the inline functions of a
+// header that many translation units include.
+//
+// Entries are keyed by the function's USR and a fingerprint of its definition
+// (its source text and AST), of the lifetime annotations of its declarations
+// and of the lifetimes of its callees, so an entry is only used if the
+// function would be analyzed with the same inputs. Lifetimes are stored
+// independently of any ASTContext, as the lifetimes at each position of the
+// function's signature, and are recreated for the function's declaration in
+// the translation unit that looks them up.
+class FunctionLifetimesCache {
+ public:
+  FunctionLifetimesCache() = default;
+
+  // Parses a cache that was returned by `Serialize()`.
+  static llvm::Expected<FunctionLifetimesCache> Parse(llvm::StringRef text);
+
+  // Returns a representation of the cache that can be passed to `Parse()`.
+  std::string Serialize() const;
+
+  // Returns the key for the lifetimes of `func`, given the results in
+  // `analyzed` for its `callees`, or nullopt if the lifetimes of `func`
+  // can't be cached. `lifetime_context` is the context that the annotations
+  // of `func` and its callees are read with.
+  static std::optional<std::string> GetKey(
+      const clang::FunctionDecl* func,
+      llvm::ArrayRef<const clang::FunctionDecl*> callees,
+      const FunctionLifetimesMap& analyzed,
+      const LifetimeAnnotationContext& lifetime_context);
+
+  // Returns the cached lifetimes for `func`, if any.
+  std::optional<FunctionLifetimes> Lookup(const clang::FunctionDecl* func,
+                                          llvm::StringRef key);
+
+  // Caches `lifetimes` under `key`. Does nothing if they can't be cached.
+  void Insert(llvm::StringRef key, const FunctionLifetimes& lifetimes);
+
+  size_t size() const { return summaries_.size(); }
+
+  // Returns the number of successful calls to `Lookup()`.
+  size_t hits() const { return hits_; }
+
+ private:
+  llvm::StringMap<std::string> summaries_;
+  size_t hits_ = 0;
+};
+
+}  // namespace lifetimes
+}  // namespace tidy
+}  // namespace clang
+
+#endif  // DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_FUNCTION_LIFETIMES_CACHE_H_
@@ -30,12 +30,17 @@
 #include "clang/AST/StmtVisitor.h"
 #include "clang/AST/TemplateBase.h"
 #include "clang/AST/Type.h"
+#include "clang/Analysis/Analyses/PostOrderCFGView.h"
 #include "clang/Analysis/CFG.h"
+#include "clang/Analysis/FlowSensitive/AdornedCFG.h"
 #include "clang/Analysis/FlowSensitive/DataflowEnvironment.h"
+#include "clang/Analysis/FlowSensitive/DataflowLattice.h"
+#include "clang/Analysis/FlowSensitive/DataflowWorklist.h"
 #include "clang/Basic/DiagnosticIDs.h"
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -351,6 +356,7 @@ bool LifetimeAnalysis::IsEqual(const LifetimeLattice& state1,
 void LifetimeAnalysis::transfer(const clang::CFGElement& elt,
                                 LifetimeLattice& state,
                                 clang::dataflow::Environment& /*environment*/) {
+  ++num_transfers_;
   if (state.IsError()) return;
 
   auto cfg_stmt = elt.getAs<clang::CFGStmt>();
@@ -819,7 +825,7 @@ std::optional<std::string> TransferStmtVisitor::VisitCallExpr(
       [&callees, call,
        this](const clang::FunctionDecl* decl) -> std::optional<std::string> {
     const FunctionLifetimesOrError& callee_lifetimes_or_error =
-        GetFunctionLifetimes(decl, callee_lifetimes_);
+        object_repository_.GetCalleeLifetimes(decl, callee_lifetimes_);
 
     if (!std::holds_alternative<FunctionLifetimes>(callee_lifetimes_or_error)) {
       // Note: It is possible that this does not have an entry if the function
@@ -956,6 +962,70 @@ std::optional<std::string> TransferStmtVisitor::VisitCXXConstructExpr(
 
 }  // namespace
 
+llvm::Expected<std::vector<std::optional<LifetimeLattice>>>
+RunLifetimeAnalysis(const clang::dataflow::AdornedCFG& acfg,
+                    LifetimeAnalysis& analysis,
+                    clang::dataflow::Environment& environment,
+                    size_t* num_joins) {
+  // The same limit as the default of `clang::dataflow::runDataflowAnalysis()`.
+  constexpr size_t kMaxBlockVisits = 20'000;
+
+  const clang::CFG& cfg = acfg.getCFG();
+  clang::PostOrderCFGView post_order(&cfg);
+  clang::ForwardDataflowWorklist worklist(cfg, &post_order);
+
+  // The join of the outputs of the predecessors of each block that have been
+  // computed so far.
+  std::vector<std::optional<LifetimeLattice>> input_states(
+      cfg.getNumBlockIDs());
+  std::vector<std::optional<LifetimeLattice>> output_states(
+      cfg.getNumBlockIDs());
+
+  const clang::CFGBlock& entry = cfg.getEntry();
+  input_states[entry.getBlockID()] = analysis.initialElement();
+  worklist.enqueueBlock(&entry);
+
+  size_t num_block_visits = 0;
+  while (const clang::CFGBlock* block = worklist.dequeue()) {
+    if (++num_block_visits > kMaxBlockVisits) {
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "maximum number of blocks processed");
+    }
+
+    unsigned id = block->getBlockID();
+    assert(input_states[id].has_value());
+    LifetimeLattice state = *input_states[id];
+    for (const clang::CFGElement& elt : *block) {
+      analysis.transfer(elt, state, environment);
+    }
+
+    std::optional<LifetimeLattice>& output_state = output_states[id];
+    if (output_state.has_value() && analysis.IsEqual(*output_state, state)) {
+      // Nothing new to propagate to the successors.
+      continue;
+    }
+
+    for (const clang::CFGBlock* succ : block->succs()) {
+      if (succ == nullptr) continue;
+      std::optional<LifetimeLattice>& succ_input =
+          input_states[succ->getBlockID()];
+      if (!succ_input.has_value()) {
+        succ_input = state;
+      } else {
+        if (num_joins) ++*num_joins;
+        if (succ_input->join(state) ==
+            clang::dataflow::LatticeJoinEffect::Unchanged) {
+          continue;
+        }
+      }
+      worklist.enqueueBlock(succ);
+    }
+    output_state = std::move(state);
+  }
+
+  return output_states;
+}
+
 }  // namespace lifetimes
 }  // namespace tidy
 }  // namespace clang
@@ -5,8 +5,11 @@
 #ifndef DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_LIFETIME_ANALYSIS_H_
 #define DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_LIFETIME_ANALYSIS_H_
 
+#include <cstddef>
 #include <functional>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "lifetime_analysis/lifetime_constraints.h"
 #include "lifetime_analysis/lifetime_lattice.h"
@@ -19,6 +22,7 @@
 #include "clang/AST/Expr.h"
 #include "clang/AST/Type.h"
 #include "clang/Analysis/CFG.h"
+#include "clang/Analysis/FlowSensitive/AdornedCFG.h"
 #include "clang/Analysis/FlowSensitive/DataflowAnalysis.h"
 #include "clang/Analysis/FlowSensitive/DataflowEnvironment.h"
 #include "clang/Basic/Diagnostic.h"
@@ -26,6 +30,7 @@
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/SourceLocation.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Error.h"
 
 namespace clang {
 namespace tidy {
@@ -88,14 +93,38 @@ class LifetimeAnalysis
   void transfer(const clang::CFGElement& elt, LifetimeLattice& state,
                 clang::dataflow::Environment& environment);
 
+  // Returns the number of calls to `transfer()` so far.
+  size_t NumTransfers() const { return num_transfers_; }
+
  private:
   const clang::FunctionDecl* func_;
   ObjectRepository& object_repository_;
   const llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>&
       callee_lifetimes_;
   const DiagnosticReporter& diag_reporter_;
+  size_t num_transfers_ = 0;
 };
 
+// Runs `analysis` over `acfg` until it reaches a fixed point, and returns the
+// lattice at the end of each basic block, indexed by block ID. Blocks that are
+// never reached have no lattice.
+//
+// This replaces `clang::dataflow::runDataflowAnalysis()`, because joins of
+// `LifetimeLattice`s are expensive, and the generic solver recomputes the
+// input of a block by joining the outputs of all of its predecessors every
+// time the block is visited. Instead, the input of each block is accumulated:
+// only a predecessor output that changed is joined into it, and a successor is
+// only revisited if that join changed its input. Blocks are visited in reverse
+// post-order, so that the blocks of an inner loop reach their fixed point
+// before the blocks after the loop are visited.
+//
+// If `num_joins` is not null, it is incremented by the number of joins.
+llvm::Expected<std::vector<std::optional<LifetimeLattice>>>
+RunLifetimeAnalysis(const clang::dataflow::AdornedCFG& acfg,
+                    LifetimeAnalysis& analysis,
+                    clang::dataflow::Environment& environment,
+                    size_t* num_joins = nullptr);
+
 }  // namespace lifetimes
 }  // namespace tidy
 }  // namespace clang
@@ -0,0 +1,302 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks for the lifetime analysis on generated code that approximates
+// the shapes of real-world code: deep call chains, recursive cycles, wide
+// structs, loops over many pointers and template instantiations.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "third_party/benchmark/include/benchmark/benchmark.h"
+#include "lifetime_analysis/analyze.h"
+#include "lifetime_annotations/lifetime_annotations.h"
+#include "lifetime_annotations/test/run_on_code.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclBase.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Process.h"
+
+namespace clang {
+namespace tidy {
+namespace lifetimes {
+namespace {
+
+// Heap usage above the baseline at construction time. Sampled only when
+// `Sample()` is called, so the result is a lower bound of the actual peak.
+class HeapUsage {
+ public:
+  void Sample() {
+    peak_ = std::max(peak_, llvm::sys::Process::GetMallocUsage());
+  }
+  size_t PeakAboveBaseline() const { return peak_ - baseline_; }
+
+ private:
+  size_t baseline_ = llvm::sys::Process::GetMallocUsage();
+  size_t peak_ = baseline_;
+};
+
+// Reports the per-function statistics of a single analysis, and the time per
+// analyzed function, as counters alongside the timings.
+void ReportStats(benchmark::State& state, const FunctionAnalysisStatsMap& stats,
+                 const HeapUsage& heap) {
+  size_t num_analyses = 0;
+  size_t num_transfers = 0;
+  size_t num_joins = 0;
+  size_t num_objects = 0;
+  size_t num_constraints = 0;
+  for (const auto& [func, func_stats] : stats) {
+    num_analyses += func_stats.num_analyses;
+    num_transfers += func_stats.num_transfers;
+    num_joins += func_stats.num_joins;
+    num_objects += func_stats.num_objects;
+    num_constraints += func_stats.num_constraints;
+  }
+  state.counters["functions"] = stats.size();
+  state.counters["analyses"] = num_analyses;
+  state.counters["transfers"] = num_transfers;
+  state.counters["joins"] = num_joins;
+  state.counters["objects"] = num_objects;
+  state.counters["constraints"] = num_constraints;
+  state.counters["time_per_function"] = benchmark::Counter(
+      stats.size(), benchmark::Counter::kIsIterationInvariantRate |
+                        benchmark::Counter::kInvert);
+  state.counters["peak_heap_bytes"] =
+      benchmark::Counter(heap.PeakAboveBaseline(),
+                         benchmark::Counter::kDefaults,
+                         benchmark::Counter::kIs1024);
+}
+
+// Parses `code` and calls `operation` on the result, failing if the code
+// doesn't compile.
+void RunOnCode(llvm::StringRef code,
+               const std::function<void(clang::ASTContext&,
+                                        const LifetimeAnnotationContext&)>&
+                   operation) {
+  bool compiled = false;
+  CHECK(runOnCodeWithLifetimeHandlers(
+      code,
+      [&](clang::ASTContext& ast_context,
+          const LifetimeAnnotationContext& lifetime_context) {
+        CHECK(!ast_context.getDiagnostics().hasUncompilableErrorOccurred());
+        operation(ast_context, lifetime_context);
+        compiled = true;
+      },
+      {"-fsyntax-only", "-std=c++17"}));
+  CHECK(compiled);
+}
+
+// Benchmarks `AnalyzeTranslationUnit()` on all functions in `code`.
+void BenchmarkTranslationUnit(benchmark::State& state, llvm::StringRef code) {
+  RunOnCode(code, [&state](clang::ASTContext& ast_context,
+                           const LifetimeAnnotationContext& lifetime_context) {
+    const clang::TranslationUnitDecl* tu = ast_context.getTranslationUnitDecl();
+
+    // Collect the statistics in a separate, untimed run.
+    {
+      HeapUsage heap;
+      FunctionAnalysisStatsMap stats;
+      auto result = AnalyzeTranslationUnit(tu, lifetime_context,
+                                           /*diag_reporter=*/{},
+                                           /*debug_info=*/nullptr,
+                                           /*cache=*/nullptr, &stats);
+      heap.Sample();
+      ReportStats(state, stats, heap);
+    }
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(AnalyzeTranslationUnit(tu, lifetime_context));
+    }
+  });
+}
+
+// Benchmarks `AnalyzeFunction()` on the function named `target` in `code`.
+void BenchmarkFunction(benchmark::State& state, llvm::StringRef code) {
+  RunOnCode(code, [&state](clang::ASTContext& ast_context,
+                           const LifetimeAnnotationContext& lifetime_context) {
+    auto lookup = ast_context.getTranslationUnitDecl()->lookup(
+        &ast_context.Idents.get("target"));
+    CHECK(lookup.isSingleResult());
+    const auto* target = clang::cast<clang::FunctionDecl>(lookup.front());
+
+    HeapUsage heap;
+    benchmark::DoNotOptimize(AnalyzeFunction(target, lifetime_context));
+    heap.Sample();
+    state.counters["peak_heap_bytes"] =
+        benchmark::Counter(heap.PeakAboveBaseline(),
+                           benchmark::Counter::kDefaults,
+                           benchmark::Counter::kIs1024);
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(AnalyzeFunction(target, lifetime_context));
+    }
+  });
+}
+
+// A chain of `length` functions, each of which passes its pointer parameters
+// (swapped) to the previous one.
+std::string CallChainCode(int64_t length) {
+  std::string code = "int* f0(int* p, int* q) { return p; }\n";
+  for (int64_t i = 1; i < length; ++i) {
+    absl::StrAppend(&code, "int* f", i, "(int* p, int* q) { return f", i - 1,
+                    "(q, p); }\n");
+  }
+  absl::StrAppend(&code, "int* target(int* p, int* q) { return f", length - 1,
+                  "(p, q); }\n");
+  return code;
+}
+
+void BM_LifetimeAnalysisCallChain(benchmark::State& state) {
+  BenchmarkTranslationUnit(state, CallChainCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisCallChain)->Arg(10)->Arg(100)->Arg(500);
+
+void BM_LifetimeAnalysisCallChainFunction(benchmark::State& state) {
+  BenchmarkFunction(state, CallChainCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisCallChainFunction)->Arg(10)->Arg(100);
+
+// A cycle of `size` mutually recursive functions, which are analyzed together
+// until their lifetimes converge.
+std::string RecursiveCycleCode(int64_t size) {
+  std::string code;
+  for (int64_t i = 0; i < size; ++i) {
+    absl::StrAppend(&code, "int* f", i, "(int* p, int* q, int n);\n");
+  }
+  for (int64_t i = 0; i < size; ++i) {
+    absl::StrAppend(&code, "int* f", i, "(int* p, int* q, int n) {\n",
+                    "  if (n == 0) return ", i % 2 ? "q" : "p", ";\n",
+                    "  return f", (i + 1) % size, "(q, p, n - 1);\n}\n");
+  }
+  absl::StrAppend(&code,
+                  "int* target(int* p, int* q) { return f0(p, q, 10); }\n");
+  return code;
+}
+
+void BM_LifetimeAnalysisRecursiveCycle(benchmark::State& state) {
+  BenchmarkTranslationUnit(state, RecursiveCycleCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisRecursiveCycle)->Arg(2)->Arg(10)->Arg(50);
+
+// A struct with `width` pointer fields (and as many fields without
+// lifetimes), all of which are assigned.
+std::string WideStructCode(int64_t width) {
+  std::string code =
+      R"cpp(struct [[clang::annotate("lifetime_params", "a")]] S {)cpp";
+  for (int64_t i = 0; i < width; ++i) {
+    absl::StrAppend(&code,
+                    R"cpp([[clang::annotate("member_lifetimes", "a")]])cpp",
+                    " int* p", i, ";\n  int v", i, ";\n");
+  }
+  absl::StrAppend(&code, "};\nint* target(S* s, int* p) {\n");
+  for (int64_t i = 0; i < width; ++i) {
+    absl::StrAppend(&code, "  s->p", i, " = p;\n  s->v", i, " = *s->p", i,
+                    ";\n");
+  }
+  absl::StrAppend(&code, "  return s->p0;\n}\n");
+  return code;
+}
+
+void BM_LifetimeAnalysisWideStruct(benchmark::State& state) {
+  BenchmarkFunction(state, WideStructCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisWideStruct)->Arg(10)->Arg(100)->Arg(400);
+
+// A loop that rotates the values of `num_pointers` local pointers, so that
+// the points-to sets only converge after `num_pointers` iterations.
+std::string PointerLoopCode(int64_t num_pointers) {
+  std::string code = "int* target(int* a, int* b) {\n";
+  for (int64_t i = 0; i < num_pointers; ++i) {
+    absl::StrAppend(&code, "  int* p", i, " = ", i % 2 ? "b" : "a", ";\n");
+  }
+  absl::StrAppend(&code, "  for (int i = 0; i < *a; ++i) {\n",
+                  "    int* t = p0;\n");
+  for (int64_t i = 1; i < num_pointers; ++i) {
+    absl::StrAppend(&code, "    p", i - 1, " = p", i, ";\n");
+  }
+  absl::StrAppend(&code, "    p", num_pointers - 1, " = t;\n  }\n",
+                  "  return p0;\n}\n");
+  return code;
+}
+
+void BM_LifetimeAnalysisPointerLoop(benchmark::State& state) {
+  BenchmarkFunction(state, PointerLoopCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisPointerLoop)->Arg(10)->Arg(50)->Arg(200);
+
+// `num_instantiations` instantiations of a function template, called from a
+// single function.
+std::string TemplateInstantiationsCode(int64_t num_instantiations) {
+  std::string code = R"cpp(
+    template <typename T>
+    T* choose(T* a, T* b, bool c) {
+      T* result = c ? a : b;
+      return result;
+    }
+  )cpp";
+  for (int64_t i = 0; i < num_instantiations; ++i) {
+    absl::StrAppend(&code, "struct S", i, " { int v; };\n");
+  }
+  absl::StrAppend(&code, "int target(bool c) {\n  int sum = 0;\n");
+  for (int64_t i = 0; i < num_instantiations; ++i) {
+    absl::StrAppend(&code, "  S", i, " a", i, ", b", i, ";\n",
+                    "  sum += choose(&a", i, ", &b", i, ", c)->v;\n");
+  }
+  absl::StrAppend(&code, "  return sum;\n}\n");
+  return code;
+}
+
+void BM_LifetimeAnalysisTemplateInstantiations(benchmark::State& state) {
+  BenchmarkTranslationUnit(state, TemplateInstantiationsCode(state.range(0)));
+}
+BENCHMARK(BM_LifetimeAnalysisTemplateInstantiations)->Arg(10)->Arg(100);
+
+// `num_templates` uninstantiated function templates, which are analyzed by
+// instantiating them with placeholder types in a separate ASTContext.
+void BM_LifetimeAnalysisTemplatePlaceholders(benchmark::State& state) {
+  std::string code;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    absl::StrAppend(&code, "template <typename T>\n", "T* choose", i,
+                    "(T* a, T* b, bool c) { return c ? a : b; }\n");
+  }
+  RunOnCode(code, [&state](clang::ASTContext& ast_context,
+                           const LifetimeAnnotationContext& lifetime_context) {
+    const clang::TranslationUnitDecl* tu = ast_context.getTranslationUnitDecl();
+    auto ignore_result = [](const clang::FunctionDecl*,
+                            const FunctionLifetimesOrError&) {};
+
+    {
+      HeapUsage heap;
+      FunctionAnalysisStatsMap stats;
+      AnalyzeTranslationUnitWithTemplatePlaceholder(
+          tu, lifetime_context, ignore_result, /*diag_reporter=*/{},
+          /*debug_info=*/nullptr, /*cache=*/nullptr, &stats);
+      heap.Sample();
+      ReportStats(state, stats, heap);
+    }
+
+    for (auto _ : state) {
+      AnalyzeTranslationUnitWithTemplatePlaceholder(tu, lifetime_context,
+                                                    ignore_result);
+    }
+  });
+}
+BENCHMARK(BM_LifetimeAnalysisTemplatePlaceholders)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace lifetimes
+}  // namespace tidy
+}  // namespace clang
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
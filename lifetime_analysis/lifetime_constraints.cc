@@ -19,18 +19,27 @@
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Error.h"
 
 namespace clang {
 namespace tidy {
 namespace lifetimes {
 
+void LifetimeConstraints::AddOutlivesConstraint(Lifetime shorter,
+                                                Lifetime longer) {
+  if (!outlives_constraints_.insert({shorter, longer}).second) return;
+  longer_lifetimes_[shorter].push_back(longer);
+  outliving_cache_.clear();
+}
+
 clang::dataflow::LatticeJoinEffect LifetimeConstraints::join(
     const LifetimeConstraints& other) {
-  bool changed = false;
-  for (auto p : other.outlives_constraints_) {
-    changed |= outlives_constraints_.insert(p).second;
+  size_t old_size = outlives_constraints_.size();
+  for (auto [shorter, longer] : other.outlives_constraints_) {
+    AddOutlivesConstraint(shorter, longer);
   }
+  bool changed = outlives_constraints_.size() != old_size;
   return changed ? clang::dataflow::LatticeJoinEffect::Changed
                  : clang::dataflow::LatticeJoinEffect::Unchanged;
 }
@@ -62,9 +71,9 @@ class LifetimeDSU {
 
 llvm::DenseSet<Lifetime> LifetimeConstraints::GetOutlivingLifetimes(
     const Lifetime l) const {
-  // TODO(veluca): here we could certainly reduce complexity, for example by
-  // constructing the constraint graph instead of iterating over all constraints
-  // each time.
+  auto cached = outliving_cache_.find(l);
+  if (cached != outliving_cache_.end()) return cached->second;
+
   std::vector<Lifetime> stack{l};
   llvm::DenseSet<Lifetime> visited;
   while (!stack.empty()) {
@@ -72,13 +81,12 @@ llvm::DenseSet<Lifetime> LifetimeConstraints::GetOutlivingLifetimes(
     stack.pop_back();
     if (visited.contains(v)) continue;
     visited.insert(v);
-    for (auto [shorter, longer] : outlives_constraints_) {
-      if (shorter == v) {
-        stack.push_back(longer);
-      }
-    }
+    auto longer = longer_lifetimes_.find(v);
+    if (longer == longer_lifetimes_.end()) continue;
+    stack.insert(stack.end(), longer->second.begin(), longer->second.end());
   }
   visited.erase(l);
+  outliving_cache_[l] = visited;
   return visited;
 }
 
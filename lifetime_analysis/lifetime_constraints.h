@@ -10,7 +10,9 @@
 #include "lifetime_annotations/function_lifetimes.h"
 #include "lifetime_annotations/lifetime.h"
 #include "clang/Analysis/FlowSensitive/DataflowLattice.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Error.h"
 
 namespace clang {
@@ -35,12 +37,12 @@ class LifetimeConstraints {
       const FunctionLifetimes& replacement_callable);
 
   // Imposes the constraint shorter <= longer.
-  void AddOutlivesConstraint(Lifetime shorter, Lifetime longer) {
-    outlives_constraints_.insert({shorter, longer});
-  }
+  void AddOutlivesConstraint(Lifetime shorter, Lifetime longer);
 
   // Returns all the lifetimes that this set of constraints implies must outlive
   // the given lifetime l.
+  // The result is cached until the constraints are next modified, so repeated
+  // queries don't need to search the constraint graph again.
   llvm::DenseSet<Lifetime> GetOutlivingLifetimes(Lifetime l) const;
 
   // Merges this set of constraints with the provided constraints, returning
@@ -62,6 +64,11 @@ class LifetimeConstraints {
  private:
   // Constraints of the form p.first <= p.second
   llvm::DenseSet<std::pair<Lifetime, Lifetime>> outlives_constraints_;
+  // The same constraints as `outlives_constraints_`, as a map from each
+  // lifetime to the lifetimes that must directly outlive it.
+  llvm::DenseMap<Lifetime, llvm::SmallVector<Lifetime, 2>> longer_lifetimes_;
+  // Results of `GetOutlivingLifetimes()` since the last modification.
+  mutable llvm::DenseMap<Lifetime, llvm::DenseSet<Lifetime>> outliving_cache_;
 };
 
 }  // namespace lifetimes
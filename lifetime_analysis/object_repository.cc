@@ -274,7 +274,7 @@ class ObjectRepository::VarDeclVisitor
     }
 
     FunctionLifetimesOrError func_lifetimes =
-        GetFunctionLifetimes(func, callee_lifetimes_);
+        object_repository_.GetCalleeLifetimes(func, callee_lifetimes_);
     if (std::holds_alternative<FunctionAnalysisError>(func_lifetimes)) {
       error_ = "No lifetimes for callee '" + func->getNameAsString() +
                "': " + std::get<FunctionAnalysisError>(func_lifetimes).message;
@@ -540,6 +540,20 @@ std::string ObjectRepository::DebugString() const {
   return result;
 }
 
+FunctionLifetimesOrError ObjectRepository::GetCalleeLifetimes(
+    const clang::FunctionDecl* decl,
+    const llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>&
+        callee_lifetimes) const {
+  if (decl->getBuiltinID() == 0) {
+    return GetFunctionLifetimes(decl, callee_lifetimes);
+  }
+  if (auto it = builtin_lifetimes_.find(decl); it != builtin_lifetimes_.end()) {
+    return it->second;
+  }
+  return builtin_lifetimes_.try_emplace(decl, GetBuiltinLifetimes(decl))
+      .first->second;
+}
+
 const Object* ObjectRepository::GetDeclObject(
     const clang::ValueDecl* decl) const {
   auto iter = object_repository_.find(decl);
@@ -727,15 +741,16 @@ ObjectSet ObjectRepository::GetFieldObject(
 const Object* ObjectRepository::GetBaseClassObject(
     const Object* struct_object, const clang::Type* base) const {
   base = base->getCanonicalTypeInternal().getTypePtr();
-  auto iter = base_object_map_.find(std::make_pair(struct_object, base));
-  if (iter == base_object_map_.end()) {
+  std::optional<const Object*> base_object =
+      GetBaseClassObjectInternal(struct_object, base);
+  if (!base_object.has_value()) {
     llvm::errs() << "On object " << struct_object->DebugString()
                  << ", trying to get base:\n";
     base->dump();
     llvm::errs() << "\n" << DebugString();
     llvm::report_fatal_error("Didn't find base object");
   }
-  return iter->second;
+  return *base_object;
 }
 
 ObjectSet ObjectRepository::GetBaseClassObject(const ObjectSet& struct_objects,
@@ -855,12 +870,20 @@ class ObjectRepository::ObjectCreator {
           type, object_lifetimes,
           [this, obj](const ObjectLifetimes& field_lifetimes,
                       const clang::FieldDecl* f) {
+            if (object_repository_.IsLifetimeLessRecordMember(
+                    field_lifetimes.Type())) {
+              return;
+            }
             const Object* field = CreateObjectsRecursively(field_lifetimes);
             object_repository_.field_object_map_[std::make_pair(obj, f)] =
                 field;
           },
           [this, obj](const ObjectLifetimes& base_lifetimes,
                       const clang::Type* base_type) {
+            if (object_repository_.IsLifetimeLessRecordMember(
+                    base_lifetimes.Type())) {
+              return;
+            }
             const Object* base_obj = CreateObjectsRecursively(base_lifetimes);
             object_repository_
                 .base_object_map_[std::make_pair(obj, base_type)] = base_obj;
@@ -896,11 +919,14 @@ const Object* ObjectRepository::CreateObject(clang::QualType type,
 }
 
 template <typename... Args>
-const Object* ObjectRepository::ConstructObject(Args&&... args) {
+const Object* ObjectRepository::ConstructObject(Args&&... args) const {
+  ++num_objects_;
   return new (object_allocator_.Allocate()) Object(args...);
 }
 
-// Clones an object and its base classes and fields, if any.
+// Clones an object and its base classes and fields, if any. Fields and bases
+// that have not been created yet are left to be created for the clone when it
+// is first used.
 const Object* ObjectRepository::CloneObject(const Object* object) {
   struct ObjectPair {
     const Object* orig_object;
@@ -929,19 +955,23 @@ const Object* ObjectRepository::CloneObject(const Object* object) {
     if (auto* cxxrecord =
             clang::dyn_cast<clang::CXXRecordDecl>(record_type->getDecl())) {
       for (const clang::CXXBaseSpecifier& base : cxxrecord->bases()) {
-        const Object* base_obj =
-            GetBaseClassObject(orig_object, base.getType());
+        const clang::Type* base_type =
+            base.getType().getCanonicalType().getTypePtr();
+        auto iter =
+            base_object_map_.find(std::make_pair(orig_object, base_type));
+        if (iter == base_object_map_.end()) continue;
+        const Object* base_obj = iter->second;
         const Object* new_base_obj = clone(base_obj);
-        base_object_map_[std::make_pair(
-            new_object, base.getType().getCanonicalType().getTypePtr())] =
-            new_base_obj;
+        base_object_map_[std::make_pair(new_object, base_type)] = new_base_obj;
         object_stack.push_back(ObjectPair{base_obj, new_base_obj});
       }
     }
 
     // Fields.
     for (auto f : record_type->getDecl()->fields()) {
-      const Object* field_obj = GetFieldObject(orig_object, f);
+      auto iter = field_object_map_.find(std::make_pair(orig_object, f));
+      if (iter == field_object_map_.end()) continue;
+      const Object* field_obj = iter->second;
       const Object* new_field_obj = clone(field_obj);
       field_object_map_[std::make_pair(new_object, f)] = new_field_obj;
       object_stack.push_back(ObjectPair{field_obj, new_field_obj});
@@ -956,9 +986,28 @@ std::optional<const Object*> ObjectRepository::GetFieldObjectInternal(
   if (iter != field_object_map_.end()) {
     return iter->second;
   }
-  if (auto* cxxrecord = clang::dyn_cast<clang::CXXRecordDecl>(
-          struct_object->Type()->getAs<clang::RecordType>()->getDecl())) {
+  const clang::RecordDecl* record =
+      struct_object->Type()->getAs<clang::RecordType>()->getDecl();
+  if (field->getParent()->getCanonicalDecl() == record->getCanonicalDecl()) {
+    if (!IsLifetimeLessRecordMember(field->getType())) return std::nullopt;
+    // Like the struct it is a part of, the field only has the lifetime of the
+    // struct object; see ObjectLifetimes::GetFieldOrBaseLifetimes().
+    const Object* field_object = ConstructObject(
+        struct_object->GetLifetime(), field->getType(), std::nullopt);
+    field_object_map_[std::make_pair(struct_object, field)] = field_object;
+    return field_object;
+  }
+  if (auto* cxxrecord = clang::dyn_cast<clang::CXXRecordDecl>(record)) {
+    const auto* field_record =
+        clang::dyn_cast<clang::CXXRecordDecl>(field->getParent());
     for (const clang::CXXBaseSpecifier& base : cxxrecord->bases()) {
+      // Don't create objects for bases that can't contain `field`.
+      const auto* base_record = base.getType()->getAsCXXRecordDecl();
+      if (field_record && base_record &&
+          base_record->getCanonicalDecl() != field_record->getCanonicalDecl() &&
+          !base_record->isDerivedFrom(field_record)) {
+        continue;
+      }
       std::optional<const Object*> field_object = GetFieldObjectInternal(
           GetBaseClassObject(struct_object, base.getType()), field);
       if (field_object.has_value()) {
@@ -969,6 +1018,75 @@ std::optional<const Object*> ObjectRepository::GetFieldObjectInternal(
   return std::nullopt;
 }
 
+std::optional<const Object*> ObjectRepository::GetBaseClassObjectInternal(
+    const Object* struct_object, const clang::Type* base) const {
+  auto iter = base_object_map_.find(std::make_pair(struct_object, base));
+  if (iter != base_object_map_.end()) {
+    return iter->second;
+  }
+  const auto* cxxrecord = struct_object->Type()->getAsCXXRecordDecl();
+  const auto* base_record = base->getAsCXXRecordDecl();
+  if (!cxxrecord || !base_record) return std::nullopt;
+  for (const clang::CXXBaseSpecifier& direct_base : cxxrecord->bases()) {
+    const clang::Type* direct_base_type =
+        direct_base.getType().getCanonicalType().getTypePtr();
+    std::optional<const Object*> base_object;
+    if (direct_base_type == base) {
+      if (!IsLifetimeLessRecordMember(direct_base.getType())) {
+        return std::nullopt;
+      }
+      base_object = ConstructObject(struct_object->GetLifetime(),
+                                    direct_base.getType(), std::nullopt);
+    } else if (direct_base.getType()->getAsCXXRecordDecl()->isDerivedFrom(
+                   base_record)) {
+      // An indirect base is the same object as the base of the direct base,
+      // as when objects are created in ObjectCreator.
+      std::optional<const Object*> direct_base_object =
+          GetBaseClassObjectInternal(struct_object, direct_base_type);
+      if (!direct_base_object.has_value()) return std::nullopt;
+      base_object = GetBaseClassObjectInternal(*direct_base_object, base);
+    }
+    if (base_object.has_value()) {
+      base_object_map_[std::make_pair(struct_object, base)] = *base_object;
+      return base_object;
+    }
+  }
+  return std::nullopt;
+}
+
+bool ObjectRepository::IsLifetimeLessRecordMember(clang::QualType type) const {
+  if (auto iter = lifetime_less_types_.find(type.getTypePtr());
+      iter != lifetime_less_types_.end()) {
+    return iter->second;
+  }
+  auto is_lifetime_less = [this, type]() {
+    // Template arguments and pointees may have lifetimes of their own.
+    if (type->getAs<clang::SubstTemplateTypeParmType>() ||
+        !PointeeType(type).isNull()) {
+      return false;
+    }
+    const auto* record_type = type->getAs<clang::RecordType>();
+    if (!record_type) return true;
+    if (type->isIncompleteType() || !GetLifetimeParameters(type).empty() ||
+        !GetTemplateArgs(type).empty()) {
+      return false;
+    }
+    for (const clang::FieldDecl* f : record_type->getDecl()->fields()) {
+      if (!IsLifetimeLessRecordMember(f->getType())) return false;
+    }
+    if (auto* cxxrecord =
+            clang::dyn_cast<clang::CXXRecordDecl>(record_type->getDecl())) {
+      for (const clang::CXXBaseSpecifier& base : cxxrecord->bases()) {
+        if (!IsLifetimeLessRecordMember(base.getType())) return false;
+      }
+    }
+    return true;
+  };
+  bool result = is_lifetime_less();
+  lifetime_less_types_[type.getTypePtr()] = result;
+  return result;
+}
+
 }  // namespace lifetimes
 }  // namespace tidy
 }  // namespace clang
@@ -63,6 +63,8 @@ class ObjectRepository {
   struct ReturnValue {};
 
   // Maps a given struct-Object to the Object for each of its fields.
+  // Objects for fields that have no lifetimes other than that of the struct
+  // are only added when first requested from GetFieldObject().
   // TODO(veluca): this approach does not produce correct results when
   // diamond-problem-style multiple inheritance happens.
   using FieldObjects =
@@ -70,6 +72,7 @@ class ObjectRepository {
                      const Object*>;
 
   // Maps a given struct-Object to the Object for each of its bases.
+  // As for fields, objects for bases without lifetimes are added lazily.
   using BaseObjects =
       llvm::DenseMap<std::pair<const Object*, const clang::Type*>,
                      const Object*>;
@@ -182,6 +185,8 @@ class ObjectRepository {
                            const clang::FieldDecl* field) const;
 
   // Returns FieldObjects; useful for producing debugging output.
+  // This only contains the field objects without lifetimes that have been
+  // requested so far.
   const FieldObjects& GetFieldObjects() const { return field_object_map_; }
 
   // Returns the object associated with a given base of the struct
@@ -205,6 +210,9 @@ class ObjectRepository {
   // Returns BaseObjects; useful for producing debugging output.
   const BaseObjects& GetBaseObjects() const { return base_object_map_; }
 
+  // Returns the number of objects created so far.
+  size_t NumObjects() const { return num_objects_; }
+
   // Returns the PointsToMap implied by variable declarations, i.e. assuming
   // that no code has been executed yet.
   const PointsToMap& InitialPointsToMap() const {
@@ -227,6 +235,14 @@ class ObjectRepository {
   const Object* CreateObject(const ObjectLifetimes& object_lifetimes,
                              PointsToMap& points_to_map);
 
+  // Like GetFunctionLifetimes(), but the lifetimes of builtins are only
+  // computed once per repository, as the transfer functions look them up again
+  // on every visit of a call.
+  FunctionLifetimesOrError GetCalleeLifetimes(
+      const clang::FunctionDecl* decl,
+      const llvm::DenseMap<const clang::FunctionDecl*,
+                           FunctionLifetimesOrError>& callee_lifetimes) const;
+
  private:
   ObjectRepository() = default;
 
@@ -240,15 +256,25 @@ class ObjectRepository {
                              LifetimeFactory lifetime_factory);
 
   template <typename... Args>
-  const Object* ConstructObject(Args&&... args);
+  const Object* ConstructObject(Args&&... args) const;
 
   const Object* CloneObject(const Object* object);
 
   std::optional<const Object*> GetFieldObjectInternal(
       const Object* struct_object, const clang::FieldDecl* field) const;
 
+  std::optional<const Object*> GetBaseClassObjectInternal(
+      const Object* struct_object, const clang::Type* base) const;
+
+  // Returns whether objects of `type`, and all of their fields and bases,
+  // have no lifetimes other than their own. Objects for such fields and bases
+  // don't need to be created until they are used.
+  bool IsLifetimeLessRecordMember(clang::QualType type) const;
+
   // Owns all the `const Object*` members of the object repository.
-  llvm::SpecificBumpPtrAllocator<Object> object_allocator_;
+  // Mutable because field and base objects are created lazily.
+  mutable llvm::SpecificBumpPtrAllocator<Object> object_allocator_;
+  mutable size_t num_objects_ = 0;
 
   // Map from each variable declaration to the object which it declares.
   MapType object_repository_;
@@ -278,8 +304,10 @@ class ObjectRepository {
   class VarDeclVisitor;
 
   PointsToMap initial_points_to_map_;
-  FieldObjects field_object_map_;
-  BaseObjects base_object_map_;
+  mutable FieldObjects field_object_map_;
+  mutable BaseObjects base_object_map_;
+  // Memoized results of IsLifetimeLessRecordMember().
+  mutable llvm::DenseMap<const clang::Type*, bool> lifetime_less_types_;
 
   llvm::DenseMap<std::pair<const clang::Expr*, size_t>, const Object*>
       call_expr_args_objects_;
@@ -297,6 +325,12 @@ class ObjectRepository {
 
   llvm::DenseMap<const Object*, ObjectLifetimes> initial_object_lifetimes_;
 
+  // Memoized results of GetBuiltinLifetimes(), keyed by the builtin's
+  // declaration: the lifetimes of e.g. `std::move` depend on its template
+  // arguments, not just on the builtin ID.
+  mutable llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
+      builtin_lifetimes_;
+
   class ObjectCreator;
 };
 
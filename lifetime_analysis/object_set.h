@@ -5,22 +5,30 @@
 #ifndef DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_OBJECT_SET_H_
 #define DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_OBJECT_SET_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include "lifetime_analysis/object.h"
-#include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace clang {
 namespace tidy {
 namespace lifetimes {
 
 // A set of `Object`s.
+//
+// The objects are kept in a vector sorted by address, so that the set
+// operations used by the points-to transfer functions are linear merges
+// without hashing or allocating tree nodes.
 class ObjectSet {
  public:
-  using const_iterator = llvm::SmallSet<const Object*, 2>::const_iterator;
+  using const_iterator = llvm::SmallVector<const Object*, 2>::const_iterator;
   using value_type = const Object*;
 
   ObjectSet() = default;
@@ -31,10 +39,11 @@ class ObjectSet {
   ObjectSet& operator=(ObjectSet&&) = default;
 
   // Initializes the object set with `objects`.
-  ObjectSet(std::initializer_list<const Object*> objects) {
-    for (const Object* object : objects) {
-      objects_.insert(object);
-    }
+  ObjectSet(std::initializer_list<const Object*> objects)
+      : objects_(objects) {
+    llvm::sort(objects_);
+    objects_.erase(std::unique(objects_.begin(), objects_.end()),
+                   objects_.end());
   }
 
   // Returns a human-readable string representation of the object set.
@@ -50,18 +59,14 @@ class ObjectSet {
 
   // Returns whether this set contains `object`.
   bool Contains(const Object* object) const {
-    return objects_.contains(object);
+    return std::binary_search(objects_.begin(), objects_.end(), object);
   }
 
   // Returns whether this set contains all objects in `other`, i.e. whether
   // this set is a superset of `other`.
   bool Contains(const ObjectSet& other) const {
-    for (const Object* object : other) {
-      if (!Contains(object)) {
-        return false;
-      }
-    }
-    return true;
+    return std::includes(objects_.begin(), objects_.end(),
+                         other.objects_.begin(), other.objects_.end());
   }
 
   // Returns a `ObjectSet` containing the union of the pointees from this
@@ -76,18 +81,32 @@ class ObjectSet {
   // `ObjectSet` and `other`.
   ObjectSet Intersection(const ObjectSet& other) const {
     ObjectSet result;
-    for (const Object* obj : *this) {
-      if (other.Contains(obj)) result.Add(obj);
-    }
+    std::set_intersection(objects_.begin(), objects_.end(),
+                          other.objects_.begin(), other.objects_.end(),
+                          std::back_inserter(result.objects_));
     return result;
   }
 
   // Adds `object` to this object set.
-  void Add(const Object* object) { objects_.insert(object); }
+  void Add(const Object* object) {
+    auto iter = llvm::lower_bound(objects_, object);
+    if (iter == objects_.end() || *iter != object) {
+      objects_.insert(iter, object);
+    }
+  }
 
   // Adds the `other` objects to this object set.
   void Add(const ObjectSet& other) {
-    objects_.insert(other.objects_.begin(), other.objects_.end());
+    if (objects_.empty()) {
+      objects_ = other.objects_;
+      return;
+    }
+    if (Contains(other)) return;
+    llvm::SmallVector<const Object*, 2> result;
+    result.reserve(objects_.size() + other.objects_.size());
+    std::set_union(objects_.begin(), objects_.end(), other.objects_.begin(),
+                   other.objects_.end(), std::back_inserter(result));
+    objects_ = std::move(result);
   }
 
   bool operator==(const ObjectSet& other) const {
@@ -101,7 +120,8 @@ class ObjectSet {
     return os << object_set.DebugString();
   }
 
-  llvm::SmallSet<const Object*, 2> objects_;
+  // Sorted and without duplicates.
+  llvm::SmallVector<const Object*, 2> objects_;
 };
 
 }  // namespace lifetimes
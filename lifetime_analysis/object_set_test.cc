@@ -111,6 +111,23 @@ TEST(ObjectSet, Add) {
       {});
 }
 
+TEST(ObjectSet, Intersection) {
+  runOnCodeWithLifetimeHandlers(
+      "",
+      [](const clang::ASTContext& ast_context,
+         const LifetimeAnnotationContext&) {
+        Object o1(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+        Object o2(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+        Object o3(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+
+        EXPECT_THAT(ObjectSet({&o1, &o2}).Intersection({&o2, &o3}),
+                    UnorderedElementsAre(&o2));
+        EXPECT_THAT(ObjectSet({&o1}).Intersection({&o2, &o3}),
+                    UnorderedElementsAre());
+      },
+      {});
+}
+
 TEST(ObjectSet, Equality) {
   runOnCodeWithLifetimeHandlers(
       "",
@@ -126,6 +143,7 @@ TEST(ObjectSet, Equality) {
 
         EXPECT_EQ(set_1, set_2);
         EXPECT_NE(set_1, set_3);
+        EXPECT_EQ(set_3, ObjectSet({&object_local, &object_static}));
       },
       {});
 }
@@ -5,6 +5,7 @@
 #include "lifetime_analysis/points_to_map.h"
 
 #include <cassert>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,18 +24,46 @@ namespace clang {
 namespace tidy {
 namespace lifetimes {
 
+template <typename Map>
+Map& PointsToMap::GetMutable(std::shared_ptr<Map>& map) {
+  if (!map) {
+    map = std::make_shared<Map>();
+  } else if (map.use_count() > 1) {
+    map = std::make_shared<Map>(*map);
+  }
+  return *map;
+}
+
+template <typename Map>
+void PointsToMap::UnionInto(std::shared_ptr<Map>& map,
+                            const std::shared_ptr<Map>& other) {
+  if (map == other || Get(other).empty()) return;
+  if (Get(map).empty()) {
+    map = other;
+    return;
+  }
+  for (const auto& [key, objects] : *other) {
+    auto iter = map->find(key);
+    if (iter != map->end() && iter->second.Contains(objects)) continue;
+    GetMutable(map)[key].Add(objects);
+  }
+}
+
 bool PointsToMap::operator==(const PointsToMap& other) const {
-  return pointer_points_tos_ == other.pointer_points_tos_ &&
-         expr_objects_ == other.expr_objects_;
+  auto same = [](const auto& map, const auto& other_map) {
+    return map == other_map || Get(map) == Get(other_map);
+  };
+  return same(pointer_points_tos_, other.pointer_points_tos_) &&
+         same(expr_objects_, other.expr_objects_);
 }
 
 std::string PointsToMap::DebugString() const {
   std::vector<std::string> parts;
-  for (const auto& [pointer, points_to] : pointer_points_tos_) {
+  for (const auto& [pointer, points_to] : Get(pointer_points_tos_)) {
     parts.push_back(absl::StrFormat("%s -> %s", pointer->DebugString(),
                                     points_to.DebugString()));
   }
-  for (const auto& [expr, objects] : expr_objects_) {
+  for (const auto& [expr, objects] : Get(expr_objects_)) {
     parts.push_back(absl::StrFormat("%s (%p) -> %s", expr->getStmtClassName(),
                                     expr, objects.DebugString()));
   }
@@ -42,25 +71,18 @@ std::string PointsToMap::DebugString() const {
 }
 
 PointsToMap PointsToMap::Union(const PointsToMap& other) const {
-  PointsToMap result;
-
-  result.pointer_points_tos_ = pointer_points_tos_;
-  for (const auto& [pointer, points_to] : other.pointer_points_tos_) {
-    result.pointer_points_tos_[pointer].Add(points_to);
-  }
+  PointsToMap result = *this;
+  UnionInto(result.pointer_points_tos_, other.pointer_points_tos_);
   // TODO(mboehme): Do we even need to perform a union on expression object
   // sets?
-  result.expr_objects_ = expr_objects_;
-  for (const auto& [expr, objects] : other.expr_objects_) {
-    result.expr_objects_[expr].Add(objects);
-  }
-
+  UnionInto(result.expr_objects_, other.expr_objects_);
   return result;
 }
 
 ObjectSet PointsToMap::GetPointerPointsToSet(const Object* pointer) const {
-  auto iter = pointer_points_tos_.find(pointer);
-  if (iter == pointer_points_tos_.end()) {
+  const PointerMap& pointer_points_tos = Get(pointer_points_tos_);
+  auto iter = pointer_points_tos.find(pointer);
+  if (iter == pointer_points_tos.end()) {
     return ObjectSet();
   }
   return iter->second;
@@ -68,7 +90,12 @@ ObjectSet PointsToMap::GetPointerPointsToSet(const Object* pointer) const {
 
 void PointsToMap::SetPointerPointsToSet(const Object* pointer,
                                         ObjectSet points_to) {
-  pointer_points_tos_[pointer] = std::move(points_to);
+  const PointerMap& pointer_points_tos = Get(pointer_points_tos_);
+  if (auto iter = pointer_points_tos.find(pointer);
+      iter != pointer_points_tos.end() && iter->second == points_to) {
+    return;
+  }
+  GetMutable(pointer_points_tos_)[pointer] = std::move(points_to);
 }
 
 void PointsToMap::SetPointerPointsToSet(const ObjectSet& pointers,
@@ -80,15 +107,21 @@ void PointsToMap::SetPointerPointsToSet(const ObjectSet& pointers,
 
 void PointsToMap::ExtendPointerPointsToSet(const Object* pointer,
                                            const ObjectSet& points_to) {
-  ObjectSet& set = pointer_points_tos_[pointer];
+  const PointerMap& pointer_points_tos = Get(pointer_points_tos_);
+  if (auto iter = pointer_points_tos.find(pointer);
+      iter != pointer_points_tos.end() && iter->second.Contains(points_to)) {
+    return;
+  }
+  ObjectSet& set = GetMutable(pointer_points_tos_)[pointer];
   set.Add(points_to);
 }
 
 ObjectSet PointsToMap::GetPointerPointsToSet(const ObjectSet& pointers) const {
+  const PointerMap& pointer_points_tos = Get(pointer_points_tos_);
   ObjectSet result;
   for (const Object* pointer : pointers) {
-    auto iter = pointer_points_tos_.find(pointer);
-    if (iter != pointer_points_tos_.end()) {
+    auto iter = pointer_points_tos.find(pointer);
+    if (iter != pointer_points_tos.end()) {
       result.Add(iter->second);
     }
   }
@@ -107,8 +140,9 @@ ObjectSet PointsToMap::GetExprObjectSet(const clang::Expr* expr) const {
          expr->getType()->isArrayType() || expr->getType()->isFunctionType() ||
          expr->getType()->isBuiltinType());
 
-  auto iter = expr_objects_.find(expr);
-  if (iter == expr_objects_.end()) {
+  const ExprMap& expr_objects = Get(expr_objects_);
+  auto iter = expr_objects.find(expr);
+  if (iter == expr_objects.end()) {
     llvm::errs() << "Didn't find object set for expression:\n";
     expr->dump();
     llvm::report_fatal_error("Didn't find object set for expression");
@@ -117,20 +151,26 @@ ObjectSet PointsToMap::GetExprObjectSet(const clang::Expr* expr) const {
 }
 
 bool PointsToMap::ExprHasObjectSet(const clang::Expr* expr) const {
-  auto iter = expr_objects_.find(expr->IgnoreParens());
-  return (iter != expr_objects_.end());
+  const ExprMap& expr_objects = Get(expr_objects_);
+  auto iter = expr_objects.find(expr->IgnoreParens());
+  return (iter != expr_objects.end());
 }
 
 void PointsToMap::SetExprObjectSet(const clang::Expr* expr, ObjectSet objects) {
   assert(expr->isGLValue() || expr->getType()->isPointerType() ||
          expr->getType()->isArrayType() || expr->getType()->isBuiltinType());
-  expr_objects_[expr] = std::move(objects);
+  const ExprMap& expr_objects = Get(expr_objects_);
+  if (auto iter = expr_objects.find(expr);
+      iter != expr_objects.end() && iter->second == objects) {
+    return;
+  }
+  GetMutable(expr_objects_)[expr] = std::move(objects);
 }
 
 std::vector<const Object*> PointsToMap::GetAllPointersWithLifetime(
     Lifetime lifetime) const {
   std::vector<const Object*> result;
-  for (const auto& [pointer, _] : pointer_points_tos_) {
+  for (const auto& [pointer, _] : Get(pointer_points_tos_)) {
     if (pointer->GetLifetime() == lifetime) {
       result.push_back(pointer);
     }
@@ -5,6 +5,7 @@
 #ifndef DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_POINTS_TO_MAP_H_
 #define DEVTOOLS_RUST_CC_INTEROP_LIFETIME_ANALYSIS_POINTS_TO_MAP_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,12 @@ namespace lifetimes {
 // The PointsToMap class does not enforce these type relationships because we
 // intend to allow type punning (at least within the implementations of
 // functions).
+//
+// The dataflow framework copies the lattice, and hence the `PointsToMap`, at
+// every join and transfer, but most of these change few entries, if any. The
+// maps are therefore shared between copies of a `PointsToMap` and only copied
+// when a shared map is modified ("copy on write"). This also allows copies
+// that have not diverged to be compared by pointer.
 class PointsToMap {
  public:
   PointsToMap() = default;
@@ -53,7 +60,7 @@ class PointsToMap {
   std::string DebugString() const;
 
   const llvm::DenseMap<const Object*, ObjectSet>& PointerPointsTos() const {
-    return pointer_points_tos_;
+    return Get(pointer_points_tos_);
   }
 
   // Returns a `PointsToMap` containing the union of mappings from this map and
@@ -101,8 +108,30 @@ class PointsToMap {
       Lifetime lifetime) const;
 
  private:
-  llvm::DenseMap<const Object*, ObjectSet> pointer_points_tos_;
-  llvm::DenseMap<const clang::Expr*, ObjectSet> expr_objects_;
+  using PointerMap = llvm::DenseMap<const Object*, ObjectSet>;
+  using ExprMap = llvm::DenseMap<const clang::Expr*, ObjectSet>;
+
+  // Returns the map, or an empty map if `map` is null.
+  template <typename Map>
+  static const Map& Get(const std::shared_ptr<Map>& map) {
+    static const Map& empty = *new Map();
+    return map ? *map : empty;
+  }
+
+  // Returns the map for modification, first copying it if it is shared.
+  template <typename Map>
+  static Map& GetMutable(std::shared_ptr<Map>& map);
+
+  // Adds the mappings from `other` to `map`, copying `map` only if `other`
+  // adds any objects to it.
+  template <typename Map>
+  static void UnionInto(std::shared_ptr<Map>& map,
+                        const std::shared_ptr<Map>& other);
+
+  // These may be shared with other `PointsToMap`s, and must not be modified
+  // unless they are unique; see `GetMutable()`. A null map is empty.
+  std::shared_ptr<PointerMap> pointer_points_tos_;
+  std::shared_ptr<ExprMap> expr_objects_;
 };
 
 }  // namespace lifetimes
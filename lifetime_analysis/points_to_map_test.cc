@@ -90,6 +90,38 @@ TEST(PointsToMapTest, Union) {
       {});
 }
 
+TEST(PointsToMapTest, CopiesAreIndependent) {
+  runOnCodeWithLifetimeHandlers(
+      "int *return_int_ptr();"
+      "int* p = return_int_ptr();",
+      [](const clang::ASTContext& ast_context,
+         const LifetimeAnnotationContext&) {
+        Object p1(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+        Object p2(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+        Object p3(Lifetime::CreateLocal(), ast_context.IntTy, std::nullopt);
+        const clang::CallExpr* expr = getFirstCallExpr(ast_context);
+
+        PointsToMap map1;
+        map1.SetPointerPointsToSet(&p1, {&p2});
+        map1.SetExprObjectSet(expr, {&p2});
+
+        PointsToMap map2 = map1;
+        map2.ExtendPointerPointsToSet(&p1, {&p3});
+        map2.SetExprObjectSet(expr, {&p3});
+        EXPECT_EQ(map1.GetPointerPointsToSet(&p1), ObjectSet({&p2}));
+        EXPECT_EQ(map1.GetExprObjectSet(expr), ObjectSet({&p2}));
+        EXPECT_EQ(map2.GetPointerPointsToSet(&p1), ObjectSet({&p2, &p3}));
+        EXPECT_EQ(map2.GetExprObjectSet(expr), ObjectSet({&p3}));
+
+        PointsToMap union_map = map2.Union(map1);
+        EXPECT_EQ(union_map.GetPointerPointsToSet(&p1), ObjectSet({&p2, &p3}));
+        EXPECT_EQ(union_map.GetExprObjectSet(expr), ObjectSet({&p2, &p3}));
+        EXPECT_EQ(map1.Union(PointsToMap()), map1);
+        EXPECT_EQ(PointsToMap().Union(map1), map1);
+      },
+      {});
+}
+
 TEST(PointsToMapTest, GetPointerPointsToSet) {
   runOnCodeWithLifetimeHandlers(
       "",
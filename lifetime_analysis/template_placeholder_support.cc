@@ -4,6 +4,7 @@
 
 #include "lifetime_analysis/template_placeholder_support.h"
 
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -19,6 +20,7 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/Analysis/CFG.h"
 #include "clang/Basic/SourceLocation.h"
+#include "clang/Index/USRGeneration.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/Tooling/Refactoring/AtomicChange.h"
 #include "clang/Tooling/Tooling.h"
@@ -30,10 +32,12 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 namespace clang {
 namespace tidy {
@@ -58,6 +62,25 @@ class TranslationUnitMatcherCallback : public MatchFinder::MatchCallback {
   std::function<void(clang::ASTContext&)> operation_;
 };
 
+// Returns a prefix for the names of the placeholder classes of `tmpl` that is
+// unique within the generated code, and the same in every translation unit
+// that instantiates `tmpl`. This keeps the USRs of the placeholder
+// instantiations stable, so that their lifetimes can be found in a
+// FunctionLifetimesCache.
+std::string PlaceholderPrefix(const clang::FunctionTemplateDecl* tmpl,
+                              const clang::FunctionDecl* func) {
+  llvm::SmallString</*inline size=*/128> usr;
+  uint64_t hash = 0;
+  if (!clang::index::generateUSRForDecl(tmpl, usr)) {
+    hash = llvm::xxh3_64bits(usr);
+  } else {
+    // Fall back to the address, which is at least unique.
+    hash = reinterpret_cast<uintptr_t>(tmpl);
+  }
+  return absl::StrCat(func->getNameAsString(), "_type_placeholder_",
+                      absl::Hex(hash, absl::kZeroPad16), "_");
+}
+
 }  // namespace
 
 llvm::Expected<GeneratedCode> GenerateTemplateInstantiationCode(
@@ -118,7 +141,6 @@ llvm::Expected<GeneratedCode> GenerateTemplateInstantiationCode(
   llvm::DenseSet<const clang::Decl*> toplevels(translation_unit->decls_begin(),
                                                translation_unit->decls_end());
 
-  int placeholder_suffix_idx = 0;
   std::vector<std::string> placeholder_classes;
   for (const auto& [tmpl, func] : templates) {
     toplevels.erase(tmpl);
@@ -126,12 +148,14 @@ llvm::Expected<GeneratedCode> GenerateTemplateInstantiationCode(
     std::vector<std::string> parameters;
     llvm::SmallVector<EditGenerator, 2> edits;
     std::string func_name = func->getNameAsString();
+    std::string placeholder_prefix = PlaceholderPrefix(tmpl, func);
+    int placeholder_suffix_idx = 0;
 
     for (auto param : *params) {
       // TODO(kinuko): check the template parameter types, this only assumes
       // type parameters for now.
-      std::string placeholder_class = absl::StrCat(
-          func_name, "_type_placeholder_", placeholder_suffix_idx++);
+      std::string placeholder_class =
+          absl::StrCat(placeholder_prefix, placeholder_suffix_idx++);
 
       placeholder_classes.push_back(placeholder_class);
       parameters.push_back(placeholder_class);
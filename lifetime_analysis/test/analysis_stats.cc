@@ -0,0 +1,81 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests for the statistics collected by the analysis.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "lifetime_analysis/test/lifetime_analysis_test.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+
+namespace clang {
+namespace tidy {
+namespace lifetimes {
+namespace {
+
+// Returns the stats object for `function` in `stats`, or nullptr.
+const llvm::json::Object* FindFunction(const llvm::json::Array& stats,
+                                       llvm::StringRef function) {
+  for (const llvm::json::Value& value : stats) {
+    const llvm::json::Object* object = value.getAsObject();
+    if (object && object->getString("function") == function) return object;
+  }
+  return nullptr;
+}
+
+TEST_F(LifetimeAnalysisTest, StatsForEachAnalyzedFunction) {
+  std::string stats_json;
+  GetLifetimesOptions options;
+  options.stats_json = &stats_json;
+  EXPECT_THAT(GetLifetimes(R"(
+    int* f(int* a, int* b) { return a; }
+    int* h(int n, int* a);
+    int* g(int n, int* a) {
+      if (n == 0) return f(a, a);
+      return h(n - 1, a);
+    }
+    int* h(int n, int* a) {
+      if (n == 0) return a;
+      return g(n - 1, a);
+    }
+  )",
+                           options),
+              LifetimesAre({{"f", "a, b -> a"},
+                            {"g", "(), a -> a"},
+                            {"h", "(), a -> a"}}));
+
+  llvm::Expected<llvm::json::Value> parsed = llvm::json::parse(stats_json);
+  ASSERT_TRUE(static_cast<bool>(parsed)) << llvm::toString(parsed.takeError());
+  const llvm::json::Array* stats = parsed->getAsArray();
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(stats->size(), 3u);
+
+  const llvm::json::Object* f = FindFunction(*stats, "f");
+  ASSERT_NE(f, nullptr);
+  EXPECT_EQ(f->getInteger("num_analyses"), std::optional<int64_t>(1));
+  EXPECT_EQ(f->getInteger("cycle_size"), std::optional<int64_t>(1));
+  EXPECT_GT(f->getInteger("num_objects").value_or(0), 0);
+  EXPECT_GT(f->getInteger("num_transfers").value_or(0), 0);
+  EXPECT_GT(f->getInteger("num_points_to_edges").value_or(0), 0);
+
+  for (llvm::StringRef name : {"g", "h"}) {
+    const llvm::json::Object* func = FindFunction(*stats, name);
+    ASSERT_NE(func, nullptr) << name.str();
+    EXPECT_EQ(func->getInteger("cycle_size"), std::optional<int64_t>(2));
+    EXPECT_GE(func->getInteger("num_analyses").value_or(0), 2);
+    // Both branches of the `if` flow into the exit block.
+    EXPECT_GT(func->getInteger("num_joins").value_or(0), 0);
+  }
+}
+
+}  // namespace
+}  // namespace lifetimes
+}  // namespace tidy
+}  // namespace clang
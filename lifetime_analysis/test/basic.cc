@@ -73,6 +73,20 @@ TEST_F(LifetimeAnalysisTest, NoLifetimesArithmetic) {
               LifetimesAre({{"target", "(), ()"}}));
 }
 
+TEST_F(LifetimeAnalysisTest, NoLifetimesCallsAndArrays) {
+  EXPECT_THAT(GetLifetimes(R"(
+    int twice(int a) {
+      return a * 2;
+    }
+    int target(int a) {
+      int (*f)(int) = &twice;
+      int values[2] = {a, f(a)};
+      return values[0] + twice(values[1]);
+    }
+  )"),
+              LifetimesAre({{"twice", "()"}, {"target", "()"}}));
+}
+
 TEST_F(LifetimeAnalysisTest, PointerToMemberDoesNotGetLifetime) {
   EXPECT_THAT(GetLifetimes(R"(
     struct S {};
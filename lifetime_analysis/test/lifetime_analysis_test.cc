@@ -143,17 +143,20 @@ NamedFuncLifetimes LifetimeAnalysisTest::GetLifetimes(
     };
 
     FunctionDebugInfoMap func_ptr_debug_info_map;
+    FunctionAnalysisStatsMap stats;
     llvm::DenseMap<const clang::FunctionDecl*, FunctionLifetimesOrError>
         analysis_result;
     if (options.with_template_placeholder) {
       AnalyzeTranslationUnitWithTemplatePlaceholder(
           ast_context.getTranslationUnitDecl(), lifetime_context,
           result_callback,
-          /*diag_reporter=*/{}, &func_ptr_debug_info_map);
+          /*diag_reporter=*/{}, &func_ptr_debug_info_map, options.cache,
+          &stats);
     } else {
       analysis_result = AnalyzeTranslationUnit(
           ast_context.getTranslationUnitDecl(), lifetime_context,
-          /*diag_reporter=*/{}, &func_ptr_debug_info_map);
+          /*diag_reporter=*/{}, &func_ptr_debug_info_map, options.cache,
+          &stats);
 
       for (const auto& [func, lifetimes_or_error] : analysis_result) {
         result_callback(func, lifetimes_or_error);
@@ -164,6 +167,9 @@ NamedFuncLifetimes LifetimeAnalysisTest::GetLifetimes(
       debug_info_map_.try_emplace(func->getDeclName().getAsString(),
                                   std::move(debug_info));
     }
+    if (options.stats_json) {
+      *options.stats_json = FunctionAnalysisStatsToJson(stats);
+    }
   };
 
   if (!runOnCodeWithLifetimeHandlers(source_code, test,
@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "lifetime_analysis/analyze.h"
+#include "lifetime_analysis/function_lifetimes_cache.h"
 #include "lifetime_annotations/test/named_func_lifetimes.h"
 
 namespace clang {
@@ -24,9 +25,15 @@ class LifetimeAnalysisTest : public testing::Test {
 
   struct GetLifetimesOptions {
     GetLifetimesOptions()
-        : with_template_placeholder(false), include_implicit_methods(false) {}
+        : with_template_placeholder(false),
+          include_implicit_methods(false),
+          cache(nullptr),
+          stats_json(nullptr) {}
     bool with_template_placeholder;
     bool include_implicit_methods;
+    FunctionLifetimesCache* cache;
+    // If set, receives the result of FunctionAnalysisStatsToJson().
+    std::string* stats_json;
   };
 
   NamedFuncLifetimes GetLifetimes(
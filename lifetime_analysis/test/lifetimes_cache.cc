@@ -0,0 +1,126 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests for reusing analyzed lifetimes through a FunctionLifetimesCache.
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "lifetime_analysis/function_lifetimes_cache.h"
+#include "lifetime_analysis/test/lifetime_analysis_test.h"
+#include "llvm/Support/Error.h"
+
+namespace clang {
+namespace tidy {
+namespace lifetimes {
+namespace {
+
+constexpr char kCode[] = R"(
+    int* f(int* a, int* b) { return a; }
+    int* g(int* a) { return f(a, a); }
+    int* h(int* a) {
+      static int i;
+      return &i;
+    }
+  )";
+
+TEST_F(LifetimeAnalysisTest, CacheReusesLifetimes) {
+  FunctionLifetimesCache cache;
+  GetLifetimesOptions options;
+  options.cache = &cache;
+  EXPECT_THAT(GetLifetimes(kCode, options),
+              LifetimesAre({{"f", "a, b -> a"},
+                            {"g", "a -> a"},
+                            {"h", "a -> static"}}));
+  EXPECT_EQ(cache.size(), 3u);
+  EXPECT_EQ(cache.hits(), 0u);
+
+  llvm::Expected<FunctionLifetimesCache> parsed =
+      FunctionLifetimesCache::Parse(cache.Serialize());
+  ASSERT_TRUE(static_cast<bool>(parsed)) << llvm::toString(parsed.takeError());
+  options.cache = &*parsed;
+  EXPECT_THAT(GetLifetimes(kCode, options),
+              LifetimesAre({{"f", "a, b -> a"},
+                            {"g", "a -> a"},
+                            {"h", "a -> static"}}));
+  EXPECT_EQ(parsed->hits(), 3u);
+}
+
+TEST_F(LifetimeAnalysisTest, CacheDependsOnDefinitionAndCallees) {
+  FunctionLifetimesCache cache;
+  GetLifetimesOptions options;
+  options.cache = &cache;
+  GetLifetimes(kCode, options);
+
+  // `f` changes, and so do its lifetimes, so `g` must be reanalyzed too.
+  EXPECT_THAT(GetLifetimes(R"(
+    int* f(int* a, int* b) { return b; }
+    int* g(int* a) { return f(a, a); }
+    int* h(int* a) {
+      static int i;
+      return &i;
+    }
+  )",
+                           options),
+              LifetimesAre({{"f", "a, b -> b"},
+                            {"g", "a -> a"},
+                            {"h", "a -> static"}}));
+  EXPECT_EQ(cache.hits(), 1u);
+}
+
+TEST_F(LifetimeAnalysisTest, CacheDependsOnExpandedMacros) {
+  FunctionLifetimesCache cache;
+  GetLifetimesOptions options;
+  options.cache = &cache;
+  EXPECT_THAT(GetLifetimes(R"(
+    #define PICK(a, b) a
+    int* f(int* a, int* b) { return PICK(a, b); }
+  )",
+                           options),
+              LifetimesAre({{"f", "a, b -> a"}}));
+
+  // The source text of `f` is the same, but the macro it expands isn't.
+  EXPECT_THAT(GetLifetimes(R"(
+    #define PICK(a, b) b
+    int* f(int* a, int* b) { return PICK(a, b); }
+  )",
+                           options),
+              LifetimesAre({{"f", "a, b -> b"}}));
+  EXPECT_EQ(cache.hits(), 0u);
+}
+
+TEST_F(LifetimeAnalysisTest, CacheReusesPlaceholderInstantiations) {
+  constexpr char kTemplateCode[] = R"(
+    int* f(int* a) { return a; }
+    template <typename T>
+    T* target(T* t, int* a) {
+      f(a);
+      return t;
+    }
+  )";
+  FunctionLifetimesCache cache;
+  GetLifetimesOptions options;
+  options.with_template_placeholder = true;
+  options.cache = &cache;
+  EXPECT_THAT(GetLifetimes(kTemplateCode, options),
+              LifetimesAre({{"f", "a -> a"}, {"target", "a, b -> a"}}));
+  size_t hits = cache.hits();
+
+  // The placeholder instantiation of `target` has the same name in every
+  // analysis, so its lifetimes are reused, as are those of `f`.
+  EXPECT_THAT(GetLifetimes(kTemplateCode, options),
+              LifetimesAre({{"f", "a -> a"}, {"target", "a, b -> a"}}));
+  EXPECT_GE(cache.hits(), hits + 2);
+}
+
+TEST_F(LifetimeAnalysisTest, CacheParseError) {
+  llvm::Expected<FunctionLifetimesCache> parsed =
+      FunctionLifetimesCache::Parse("not a cache entry");
+  ASSERT_FALSE(static_cast<bool>(parsed));
+  llvm::consumeError(parsed.takeError());
+}
+
+}  // namespace
+}  // namespace lifetimes
+}  // namespace tidy
+}  // namespace clang
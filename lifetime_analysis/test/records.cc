@@ -256,6 +256,29 @@ TEST_F(LifetimeAnalysisTest, StructMemberPtr) {
               LifetimesAre({{"target", "a -> a"}}));
 }
 
+TEST_F(LifetimeAnalysisTest, StructNestedLifetimeLessMemberPtr) {
+  EXPECT_THAT(GetLifetimes(R"(
+    struct Base {
+      int a;
+    };
+    struct Inner : Base {
+      int b;
+    };
+    struct [[clang::annotate("lifetime_params", "p")]] S {
+      Inner inner;
+      [[clang::annotate("member_lifetimes", "p")]]
+      int* p;
+    };
+    int* target(S* s, bool cond) {
+      if (cond) {
+        return &s->inner.a;
+      }
+      return s->p;
+    }
+  )"),
+              LifetimesAre({{"target", "(a, a), () -> a"}}));
+}
+
 TEST_F(LifetimeAnalysisTest, StructReferenceMember) {
   // This is a regression test for a bug where we were not treating accesses to
   // member variables of reference type correctly.
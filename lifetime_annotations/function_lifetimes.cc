@@ -23,6 +23,7 @@
 #include "clang/AST/Type.h"
 #include "clang/AST/TypeLoc.h"
 #include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Error.h"
@@ -216,6 +217,21 @@ llvm::DenseSet<Lifetime> FunctionLifetimes::AllFreeLifetimes() const {
   return all_lifetimes;
 }
 
+llvm::SmallVector<int> FunctionLifetimes::CanonicalForm() const {
+  llvm::SmallVector<int> form;
+  llvm::DenseMap<Lifetime, int> indices;
+  Traverse([&form, &indices](const Lifetime& l, Variance) {
+    if (l == Lifetime::Static()) {
+      form.push_back(-1);
+      return;
+    }
+    auto [iter, _] = indices.try_emplace(l, indices.size());
+    // Keep local lifetimes distinct from variable lifetimes.
+    form.push_back(l.IsLocal() ? -2 - iter->second : iter->second);
+  });
+  return form;
+}
+
 void FunctionLifetimes::SubstituteLifetimes(
     const LifetimeSubstitutions& subst) {
   // TODO(veluca): this is incorrect in the presence of HRTBs.
@@ -240,8 +256,13 @@ void FunctionLifetimes::Traverse(
 
 void FunctionLifetimes::Traverse(
     std::function<void(const Lifetime&, Variance)> visitor) const {
-  const_cast<FunctionLifetimes*>(this)->Traverse(
-      [visitor](Lifetime& l, Variance v) { visitor(l, v); });
+  for (const auto& param : param_lifetimes_) {
+    param.Traverse(visitor);
+  }
+  return_lifetimes_.Traverse(visitor);
+  if (this_lifetimes_.has_value()) {
+    this_lifetimes_->Traverse(visitor);
+  }
 }
 
 std::string FunctionLifetimes::DebugString(LifetimeFormatter formatter) const {
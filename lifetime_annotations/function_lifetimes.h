@@ -156,6 +156,13 @@ class FunctionLifetimes {
   // of the enclosing class.
   llvm::DenseSet<Lifetime> AllFreeLifetimes() const;
 
+  // Returns the lifetimes of this FunctionLifetimes in traversal order, with
+  // each lifetime other than `Lifetime::Static()` renumbered in order of first
+  // occurrence. Two FunctionLifetimes with the same structure have the same
+  // canonical form if and only if unique vs reoccurring lifetimes are found in
+  // the same positions, whatever the actual `Lifetime`s are.
+  llvm::SmallVector<int> CanonicalForm() const;
+
   // Applies `subst` to all lifetimes in this FunctionLifetimes.
   // Any lifetime parameter declarations will moved to the innermost location
   // that is valid for the new lifetimes. Note that this operation is
@@ -340,7 +340,49 @@ llvm::Expected<FunctionLifetimes> GetLifetimeAnnotations(
   if (!symbol_table) {
     symbol_table = &throw_away_symbol_table;
   }
-  return GetLifetimeAnnotationsInternal(func, *symbol_table, elision_enabled);
+
+  // The annotations can only be reused if they don't refer to lifetimes that
+  // the caller already declared.
+  const clang::ASTContext* ast_context = &func->getASTContext();
+  if (context.annotations_ast_context == nullptr) {
+    context.annotations_ast_context = ast_context;
+  }
+  if (context.annotations_ast_context != ast_context ||
+      !symbol_table->GetMapping().empty()) {
+    return GetLifetimeAnnotationsInternal(func, *symbol_table,
+                                          elision_enabled);
+  }
+  if (auto iter = context.annotations_cache.find(func);
+      iter != context.annotations_cache.end()) {
+    const LifetimeAnnotationContext::CachedAnnotations& cached = iter->second;
+    *symbol_table = cached.symbol_table;
+    if (cached.lifetimes.has_value()) {
+      return *cached.lifetimes;
+    }
+    return llvm::make_error<LifetimeError>(cached.error_type,
+                                           cached.error_message);
+  }
+
+  llvm::Expected<FunctionLifetimes> result =
+      GetLifetimeAnnotationsInternal(func, *symbol_table, elision_enabled);
+  if (!result) {
+    // Errors other than `LifetimeError`s are passed on without caching them.
+    return llvm::handleErrors(
+        result.takeError(),
+        [&](std::unique_ptr<LifetimeError> err) -> llvm::Error {
+          LifetimeAnnotationContext::CachedAnnotations& cached =
+              context.annotations_cache[func];
+          cached.error_type = err->type();
+          cached.error_message = err->message();
+          cached.symbol_table = *symbol_table;
+          return llvm::Error(std::move(err));
+        });
+  }
+  LifetimeAnnotationContext::CachedAnnotations& cached =
+      context.annotations_cache[func];
+  cached.lifetimes = *result;
+  cached.symbol_table = *symbol_table;
+  return result;
 }
 
 llvm::Expected<FunctionLifetimes> ParseLifetimeAnnotations(
@@ -6,13 +6,16 @@
 #define CRUBIT_LIFETIME_ANNOTATIONS_LIFETIME_ANNOTATIONS_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "lifetime_annotations/function_lifetimes.h"
+#include "lifetime_annotations/lifetime_error.h"
 #include "lifetime_annotations/lifetime_symbol_table.h"
 #include "clang/AST/Decl.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/Error.h"
 
@@ -24,6 +27,27 @@ namespace lifetimes {
 struct LifetimeAnnotationContext {
   // Files in which the `lifetime_elision` pragma was specified.
   llvm::DenseSet<clang::FileID> lifetime_elision_files;
+
+  // The result of `GetLifetimeAnnotations()` for a function.
+  struct CachedAnnotations {
+    // The annotated lifetimes, or nullopt if there was an error.
+    std::optional<FunctionLifetimes> lifetimes;
+    LifetimeError::Type error_type = LifetimeError::Type::Other;
+    std::string error_message;
+    // The names of the lifetimes in `lifetimes`.
+    LifetimeSymbolTable symbol_table;
+  };
+
+  // Results of `GetLifetimeAnnotations()`, so that the annotations of a
+  // function are only parsed once, even if they are requested by several
+  // clients (e.g. the bindings importer and the lifetime analysis). Only
+  // functions of `annotations_ast_context`, the ASTContext of the first
+  // function that was looked up, are cached; other ASTContexts (e.g. those
+  // that the lifetime analysis creates for template instantiations) may reuse
+  // the addresses of destroyed declarations.
+  mutable const clang::ASTContext* annotations_ast_context = nullptr;
+  mutable llvm::DenseMap<const clang::FunctionDecl*, CachedAnnotations>
+      annotations_cache;
 };
 
 // Returns the lifetimes annotated on `func`.
@@ -36,6 +60,8 @@ struct LifetimeAnnotationContext {
 // rules were not applicable.
 // The names of annotated function lifetimes as well as autogenerated names for
 // elided lifetimes are added to `symbol_table`.
+// Results are cached in `context`, unless `symbol_table` is non-empty, so
+// repeated calls for the same function return the same lifetimes.
 //
 // Returns structured error information as a `LifetimeError`.
 llvm::Expected<FunctionLifetimes> GetLifetimeAnnotations(
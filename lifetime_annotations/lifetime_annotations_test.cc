@@ -407,17 +407,17 @@ TEST_F(LifetimeAnnotationsTest, LifetimeElision_AliasTemplate) {
               // TODO(b/357835254): Should be "a" rather than "b".
               // The issue is that `ValueLifetimes::Create()` creates a lifetime
               // for the `int *` twice: Once for its occurrence as the template
-              // argument (adding it to `template_argument_lifetimes_`), and
+              // argument (adding it to `template_argument_lifetimes`), and
               // once for its occurrence as the type alias's canonical type
-              // (adding it to `pointee_lifetimes_`). This violates the
+              // (adding it to `pointee_lifetimes`). This violates the
               // `ValueLifetimes` invariant that only one of
-              // `template_argument_lifetimes_` or `pointee_lifetimes_` should
+              // `template_argument_lifetimes` or `pointee_lifetimes` should
               // be populated.
               // We still end up with only one lifetime in the result because
               // `ValueLifetimes::DebugString()` bails out after the
               // `!PointeeType(Type()).isNull()` case and therefore ignores the
-              // lifetimes in `template_argument_lifetimes_`. Because the
-              // lifetime in `pointee_lifetimes_` is the second one to be
+              // lifetimes in `template_argument_lifetimes`. Because the
+              // lifetime in `pointee_lifetimes` is the second one to be
               // produced, we end up with "b" rather than "a".
               IsOkAndHolds(LifetimesAre({{"f", "b"}})));
 }
@@ -923,6 +923,42 @@ TEST_F(LifetimeAnnotationsTest, LifetimeAnnotation_ReturnFunctionPtr) {
               IsOkAndHolds(LifetimesAre({{"f", "a -> (b -> b)"}})));
 }
 
+TEST_F(LifetimeAnnotationsTest, AnnotationsAreCached) {
+  bool success = runOnCodeWithLifetimeHandlers(
+      WithLifetimeMacros(R"(
+        int* $a f(int* $a, int* $b);
+      )"),
+      [](clang::ASTContext& ast_context,
+         const LifetimeAnnotationContext& lifetime_context) {
+        auto lookup = ast_context.getTranslationUnitDecl()->lookup(
+            &ast_context.Idents.get("f"));
+        ASSERT_TRUE(lookup.isSingleResult());
+        const auto* func = clang::cast<clang::FunctionDecl>(lookup.front());
+
+        LifetimeSymbolTable first_symbol_table;
+        llvm::Expected<FunctionLifetimes> first =
+            GetLifetimeAnnotations(func, lifetime_context, &first_symbol_table);
+        ASSERT_TRUE(bool(first)) << llvm::toString(first.takeError());
+        LifetimeSymbolTable second_symbol_table;
+        llvm::Expected<FunctionLifetimes> second = GetLifetimeAnnotations(
+            func, lifetime_context, &second_symbol_table);
+        ASSERT_TRUE(bool(second)) << llvm::toString(second.takeError());
+
+        EXPECT_EQ(lifetime_context.annotations_cache.size(), 1u);
+        Lifetime a = first->GetReturnLifetimes()
+                         .GetPointeeLifetimes()
+                         .GetLifetime();
+        EXPECT_EQ(second->GetReturnLifetimes()
+                      .GetPointeeLifetimes()
+                      .GetLifetime(),
+                  a);
+        EXPECT_EQ(second_symbol_table.LookupName("a"), a);
+        EXPECT_EQ(NameLifetimes(*second, second_symbol_table), "a, b -> a");
+      },
+      {});
+  EXPECT_TRUE(success);
+}
+
 }  // namespace
 }  // namespace lifetimes
 }  // namespace tidy
@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,6 +20,11 @@ namespace clang {
 namespace tidy {
 namespace lifetimes {
 
+// The number of entries that the array of substitutions may have beyond the
+// ratio of used entries that `Add()` maintains, so that small sets of
+// substitutions never need the map.
+constexpr size_t kMinDenseSize = 64;
+
 void LifetimeSubstitutions::Add(Lifetime variable, Lifetime substitution) {
   assert(variable.IsVariable());
 
@@ -31,22 +38,69 @@ void LifetimeSubstitutions::Add(Lifetime variable, Lifetime substitution) {
     return;
   }
 
-  substitutions_[variable] = substitution;
+  int id = variable.Id();
+  if (dense_.empty()) {
+    dense_base_id_ = id;
+  }
+  int begin = std::min(dense_base_id_, id);
+  int end = std::max(dense_base_id_ + static_cast<int>(dense_.size()), id + 1);
+  // Grow the array only as long as at least a quarter of it is used.
+  size_t size = end - begin;
+  if (size > dense_.size() && size > 4 * (num_dense_ + 1) + kMinDenseSize) {
+    sparse_[variable] = substitution;
+    return;
+  }
+  if (begin < dense_base_id_) {
+    dense_.insert(dense_.begin(), dense_base_id_ - begin, std::nullopt);
+    dense_base_id_ = begin;
+  }
+  dense_.resize(size);
+  std::optional<Lifetime>& entry = dense_[id - dense_base_id_];
+  if (!entry.has_value()) {
+    ++num_dense_;
+  }
+  entry = substitution;
 }
 
-Lifetime LifetimeSubstitutions::Substitute(Lifetime l) const {
-  while (true) {
-    auto iter = substitutions_.find(l);
-    if (iter == substitutions_.end()) {
-      return l;
+std::optional<Lifetime> LifetimeSubstitutions::Lookup(Lifetime l) const {
+  // `dense_` takes precedence, as variables in `sparse_` may be substituted
+  // again after `dense_` has grown to include them.
+  if (l.Id() >= dense_base_id_ &&
+      static_cast<size_t>(l.Id() - dense_base_id_) < dense_.size()) {
+    if (const std::optional<Lifetime>& entry =
+            dense_[l.Id() - dense_base_id_]) {
+      return entry;
     }
-    l = iter->second;
   }
+  if (sparse_.empty()) {
+    return std::nullopt;
+  }
+  auto iter = sparse_.find(l);
+  if (iter == sparse_.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+Lifetime LifetimeSubstitutions::Substitute(Lifetime l) const {
+  while (std::optional<Lifetime> substitution = Lookup(l)) {
+    l = *substitution;
+  }
+  return l;
 }
 
 void LifetimeSubstitutions::Dump() const {
   std::vector<std::string> parts;
-  for (auto [from, to] : substitutions_) {
+  for (size_t i = 0; i < dense_.size(); ++i) {
+    if (dense_[i].has_value()) {
+      // Only variables are substituted, which `Lifetime::DebugString()` prints
+      // as their ID.
+      parts.push_back(absl::StrCat("'", dense_base_id_ + i, " -> ",
+                                   Substitute(*dense_[i]).DebugString()));
+    }
+  }
+  for (auto [from, to] : sparse_) {
+    if (Lookup(from) != to) continue;
     parts.push_back(
         absl::StrCat(from.DebugString(), " -> ", Substitute(to).DebugString()));
   }
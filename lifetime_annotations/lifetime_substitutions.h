@@ -4,8 +4,12 @@
 #ifndef CRUBIT_LIFETIME_ANNOTATIONS_LIFETIME_SUBSTITUTIONS_H_
 #define CRUBIT_LIFETIME_ANNOTATIONS_LIFETIME_SUBSTITUTIONS_H_
 
+#include <cstddef>
+#include <optional>
+
 #include "lifetime_annotations/lifetime.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace clang {
 namespace tidy {
@@ -13,6 +17,12 @@ namespace lifetimes {
 
 // A set of substitutions of a lifetime variable with another lifetime (variable
 // or constant).
+//
+// Lifetime variables are numbered consecutively as they are created, and the
+// variables that are substituted together were usually created together, so
+// substitutions are stored in an array indexed by lifetime ID, which covers
+// the range of the substituted variables. Variables that are far outside of
+// that range are stored in a map instead, so that the array stays dense.
 class LifetimeSubstitutions {
  public:
   // Constructs an empty set of substitutions.
@@ -32,7 +42,18 @@ class LifetimeSubstitutions {
   void Dump() const;
 
  private:
-  llvm::DenseMap<Lifetime, Lifetime> substitutions_;
+  // Returns the substitution of `l`, if any.
+  std::optional<Lifetime> Lookup(Lifetime l) const;
+
+  // The substitution of the variable with ID `dense_base_id_ + i` is
+  // `dense_[i]`, if any.
+  int dense_base_id_ = 0;
+  llvm::SmallVector<std::optional<Lifetime>> dense_;
+  // Number of substitutions in `dense_`.
+  size_t num_dense_ = 0;
+
+  // Substitutions of variables that are outside the range of `dense_`.
+  llvm::DenseMap<Lifetime, Lifetime> sparse_;
 };
 
 }  // namespace lifetimes
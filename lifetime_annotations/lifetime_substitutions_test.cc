@@ -95,6 +95,27 @@ TEST(LifetimeSubstitutions, SubstituteIsTransitive) {
   EXPECT_EQ(s.Substitute(l1), l4);
 }
 
+TEST(LifetimeSubstitutions, DistantVariables) {
+  // Check substitutions of variables that are too far apart to be stored in
+  // the same array.
+  Lifetime first = Lifetime::CreateVariable();
+  Lifetime second = Lifetime::CreateVariable();
+  for (int i = 0; i < 1000; ++i) Lifetime::CreateVariable();
+  Lifetime third = Lifetime::CreateVariable();
+  Lifetime fourth = Lifetime::CreateVariable();
+
+  LifetimeSubstitutions s;
+  s.Add(third, fourth);
+  s.Add(first, second);
+  s.Add(fourth, Lifetime::Static());
+  s.Add(second, third);
+
+  EXPECT_EQ(s.Substitute(first), Lifetime::Static());
+  EXPECT_EQ(s.Substitute(second), Lifetime::Static());
+  EXPECT_EQ(s.Substitute(third), Lifetime::Static());
+  EXPECT_EQ(s.Substitute(fourth), Lifetime::Static());
+}
+
 }  // namespace
 }  // namespace lifetimes
 }  // namespace tidy
@@ -8,21 +8,78 @@
 #include <cstddef>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "absl/base/const_init.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "lifetime_annotations/lifetime.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ErrorHandling.h"
 
 namespace clang {
 namespace tidy {
 namespace lifetimes {
 
+namespace {
+
+ABSL_CONST_INIT absl::Mutex lifetime_names_mutex(absl::kConstInit);
+
+struct LifetimeNames {
+  llvm::StringMap<LifetimeNameId> ids;
+  // The keys of `ids`, indexed by handle. `StringMap` never moves its keys.
+  std::vector<llvm::StringRef> names;
+};
+
+LifetimeNames& GetLifetimeNames()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lifetime_names_mutex) {
+  static absl::NoDestructor<LifetimeNames> lifetime_names;
+  return *lifetime_names;
+}
+
+}  // namespace
+
+LifetimeNameId InternLifetimeName(llvm::StringRef name) {
+  absl::MutexLock lock(&lifetime_names_mutex);
+  LifetimeNames& lifetime_names = GetLifetimeNames();
+  auto [iter, inserted] =
+      lifetime_names.ids.try_emplace(name, lifetime_names.names.size());
+  if (inserted) {
+    lifetime_names.names.push_back(iter->first());
+  }
+  return iter->second;
+}
+
+std::optional<LifetimeNameId> FindLifetimeName(llvm::StringRef name) {
+  absl::MutexLock lock(&lifetime_names_mutex);
+  LifetimeNames& lifetime_names = GetLifetimeNames();
+  auto iter = lifetime_names.ids.find(name);
+  if (iter == lifetime_names.ids.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+llvm::StringRef GetLifetimeName(LifetimeNameId id) {
+  absl::MutexLock lock(&lifetime_names_mutex);
+  LifetimeNames& lifetime_names = GetLifetimeNames();
+  assert(id < lifetime_names.names.size());
+  return lifetime_names.names[id];
+}
+
 std::optional<Lifetime> LifetimeSymbolTable::LookupName(
     llvm::StringRef name) const {
   if (name == "static") {
     return Lifetime::Static();
   }
 
-  auto iter = name_to_lifetime_.find(name);
+  std::optional<LifetimeNameId> id = FindLifetimeName(name);
+  if (!id.has_value()) {
+    return std::nullopt;
+  }
+  auto iter = name_to_lifetime_.find(*id);
   if (iter == name_to_lifetime_.end()) {
     return std::nullopt;
   }
@@ -34,13 +91,13 @@ Lifetime LifetimeSymbolTable::LookupNameAndMaybeDeclare(llvm::StringRef name) {
     return Lifetime::Static();
   }
 
-  auto [iter, inserted] =
-      name_to_lifetime_.try_emplace(name, Lifetime::Static());
+  LifetimeNameId id = InternLifetimeName(name);
+  auto [iter, inserted] = name_to_lifetime_.try_emplace(id, Lifetime::Static());
   if (inserted) {
     Lifetime lifetime = Lifetime::CreateVariable();
     iter->second = lifetime;
     assert(!lifetime_to_name_.count(lifetime));
-    lifetime_to_name_[lifetime] = name;
+    lifetime_to_name_[lifetime] = id;
   }
   return iter->second;
 }
@@ -55,7 +112,7 @@ std::optional<llvm::StringRef> LifetimeSymbolTable::LookupLifetime(
   if (iter == lifetime_to_name_.end()) {
     return std::nullopt;
   }
-  return iter->second;
+  return GetLifetimeName(iter->second);
 }
 
 static std::string NameFromIndex(int index) {
@@ -84,35 +141,37 @@ llvm::StringRef LifetimeSymbolTable::LookupLifetimeAndMaybeDeclare(
 
   auto lifetime_to_name_iter = lifetime_to_name_.find(lifetime);
   if (lifetime_to_name_iter != lifetime_to_name_.end()) {
-    return lifetime_to_name_iter->second;
+    return GetLifetimeName(lifetime_to_name_iter->second);
   }
 
   while (true) {
-    std::string name = NameFromIndex(next_name_index_++);
-    auto [name_to_lifetime_iter, inserted] =
-        name_to_lifetime_.try_emplace(name, lifetime);
+    LifetimeNameId id = InternLifetimeName(NameFromIndex(next_name_index_++));
+    auto [_, inserted] = name_to_lifetime_.try_emplace(id, lifetime);
     if (inserted) {
-      lifetime_to_name_[lifetime] = name;
-      return name_to_lifetime_iter->first();
+      lifetime_to_name_[lifetime] = id;
+      return GetLifetimeName(id);
     }
   }
 }
 
 void LifetimeSymbolTable::Add(llvm::StringRef name, Lifetime lifetime) {
-  auto [_, inserted] = name_to_lifetime_.try_emplace(name, lifetime);
+  LifetimeNameId id = InternLifetimeName(name);
+  auto [_, inserted] = name_to_lifetime_.try_emplace(id, lifetime);
   if (!inserted) {
     llvm::report_fatal_error("duplicate lifetime parameter");
   }
-  lifetime_to_name_[lifetime] = name;
+  lifetime_to_name_[lifetime] = id;
 }
 
 void LifetimeSymbolTable::Rebind(llvm::StringRef name, Lifetime lifetime) {
-  auto iter = name_to_lifetime_.find(name);
+  std::optional<LifetimeNameId> id = FindLifetimeName(name);
+  auto iter = id.has_value() ? name_to_lifetime_.find(*id)
+                             : name_to_lifetime_.end();
   if (iter == name_to_lifetime_.end()) {
     llvm::report_fatal_error("invalid call to rebind");
   }
   lifetime_to_name_.erase(iter->second);
-  lifetime_to_name_[lifetime] = name;
+  lifetime_to_name_[lifetime] = *id;
   iter->second = lifetime;
 }
 
@@ -5,19 +5,40 @@
 #ifndef CRUBIT_LIFETIME_ANNOTATIONS_LIFETIME_SYMBOL_TABLE_H_
 #define CRUBIT_LIFETIME_ANNOTATIONS_LIFETIME_SYMBOL_TABLE_H_
 
+#include <cstdint>
 #include <optional>
-#include <string>
 
 #include "lifetime_annotations/lifetime.h"
 #include "llvm/ADT/DenseMap.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 
 namespace clang {
 namespace tidy {
 namespace lifetimes {
 
+// A small integer handle for an interned lifetime name.
+//
+// Lifetime names are interned in a single process-wide table, so that symbol
+// tables only store handles and never allocate strings of their own. Two
+// handles are equal if and only if the names are equal.
+using LifetimeNameId = uint32_t;
+
+// Returns the handle for `name`, interning it if necessary. This is
+// thread-safe.
+LifetimeNameId InternLifetimeName(llvm::StringRef name);
+
+// Returns the handle for `name`, or nullopt if `name` has never been interned.
+// This is thread-safe.
+std::optional<LifetimeNameId> FindLifetimeName(llvm::StringRef name);
+
+// Returns the name for a handle returned by `InternLifetimeName()`. The name
+// lives until the end of the program. This is thread-safe.
+llvm::StringRef GetLifetimeName(LifetimeNameId id);
+
 // One-to-one mapping between lifetime names and the corresponding lifetimes.
+//
+// The names returned by this class are interned and therefore remain valid
+// after the symbol table has been modified or destroyed.
 class LifetimeSymbolTable {
  public:
   // Looks up a lifetime name in the symbol table.
@@ -56,13 +77,13 @@ class LifetimeSymbolTable {
   void Rebind(llvm::StringRef name, Lifetime lifetime);
 
   // Accessor for hashing/debugging purposes.
-  const llvm::StringMap<Lifetime>& GetMapping() const {
-    return name_to_lifetime_;
-  }
+  // The keys are the handles of the names; see `GetLifetimeName()`.
+  using Mapping = llvm::SmallDenseMap<LifetimeNameId, Lifetime, 4>;
+  const Mapping& GetMapping() const { return name_to_lifetime_; }
 
  private:
-  llvm::StringMap<Lifetime> name_to_lifetime_;
-  llvm::DenseMap<Lifetime, std::string> lifetime_to_name_;
+  Mapping name_to_lifetime_;
+  llvm::SmallDenseMap<Lifetime, LifetimeNameId, 4> lifetime_to_name_;
   int next_name_index_ = 0;
 };
 
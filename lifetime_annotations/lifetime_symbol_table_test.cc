@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include "lifetime_annotations/lifetime.h"
+#include "llvm/ADT/StringRef.h"
 
 namespace clang {
 namespace tidy {
@@ -84,6 +85,37 @@ TEST(LifetimeSymbolTableTest, LookupLifetimeAndMaybeDeclare) {
   }
 }
 
+TEST(LifetimeSymbolTableTest, InternedNames) {
+  EXPECT_EQ(InternLifetimeName("interned"), InternLifetimeName("interned"));
+  EXPECT_NE(InternLifetimeName("interned"), InternLifetimeName("other"));
+  EXPECT_EQ(GetLifetimeName(InternLifetimeName("interned")), "interned");
+  EXPECT_EQ(FindLifetimeName("never_interned"), std::nullopt);
+}
+
+TEST(LifetimeSymbolTableTest, NamesOutliveTable) {
+  llvm::StringRef name;
+  {
+    LifetimeSymbolTable table;
+    name = table.LookupLifetimeAndMaybeDeclare(Lifetime::CreateVariable());
+  }
+  EXPECT_EQ(name, "a");
+}
+
+TEST(LifetimeSymbolTableTest, EqualTablesHaveEqualMappings) {
+  Lifetime a = Lifetime::CreateVariable();
+  Lifetime b = Lifetime::CreateVariable();
+
+  LifetimeSymbolTable table1;
+  table1.Add("a", a);
+  table1.Add("b", b);
+
+  LifetimeSymbolTable table2;
+  table2.Add("b", b);
+  table2.Add("a", a);
+
+  EXPECT_TRUE(table1.GetMapping() == table2.GetMapping());
+}
+
 }  // namespace
 }  // namespace lifetimes
 }  // namespace tidy
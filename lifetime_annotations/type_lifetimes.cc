@@ -5,6 +5,7 @@
 #include "lifetime_annotations/type_lifetimes.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <functional>
@@ -183,30 +184,62 @@ llvm::SmallVector<std::string> GetLifetimeParameters(clang::QualType type) {
   return ret;
 }
 
-ValueLifetimes::ValueLifetimes(const ValueLifetimes& other) { *this = other; }
-
-ValueLifetimes& ValueLifetimes::operator=(const ValueLifetimes& other) {
-  type_ = other.type_;
-  template_argument_lifetimes_ = other.template_argument_lifetimes_;
-  lifetime_parameters_by_name_ = other.lifetime_parameters_by_name_;
-  auto pointee_lifetimes =
-      other.pointee_lifetimes_
-          ? std::make_unique<ObjectLifetimes>(*other.pointee_lifetimes_)
-          : nullptr;
-  auto function_lifetimes =
-      other.function_lifetimes_
-          ? std::make_unique<FunctionLifetimes>(*other.function_lifetimes_)
-          : nullptr;
-  // Note: because ValueLifetimes is a recursive type (pointee_lifetimes_
-  // contains a ValueLifetimes), the following line can destroy `other`.
-  // (Thus the temporary local variables before we perform the assignment.)
-  pointee_lifetimes_ = std::move(pointee_lifetimes);
-  function_lifetimes_ = std::move(function_lifetimes);
-  return *this;
+struct ValueLifetimes::Data {
+  Data() = default;
+
+  // Copies the nested lifetimes, which are themselves shared with `other`
+  // until they are modified. The cached hash is not copied.
+  Data(const Data& other)
+      : pointee_lifetimes(other.pointee_lifetimes),
+        function_lifetimes(other.function_lifetimes),
+        template_argument_lifetimes(other.template_argument_lifetimes),
+        lifetime_parameters_by_name(other.lifetime_parameters_by_name) {}
+
+  // Note: only one of `pointee_lifetimes`, `function_lifetimes` or
+  // `template_argument_lifetimes` is non-empty.
+  std::optional<ObjectLifetimes> pointee_lifetimes;
+  std::optional<FunctionLifetimes> function_lifetimes;
+  std::vector<std::vector<std::optional<ValueLifetimes>>>
+      template_argument_lifetimes;
+
+  // Tracks the mapping from the names of the lifetimes on the struct/class
+  // definition to the associated `Lifetime`s. For example, in the following
+  // code
+  //
+  // class string_view LIFETIME_PARAM(d) { ... };
+  //
+  // string_view $a drop_last(string_view $a in) {
+  //   string_view result;
+  //   ...
+  //   return result;
+  // }
+  //
+  // the value stored in `result`/`in` has 1 lifetime argument. This lifetime
+  // has a local name "a" (it is not possible to retrieve this mapping from this
+  // ValueLifetimes object). This lifetime substitutes lifetime "d" from
+  // string_view (this mapping is tracked by lifetime_parameters_by_name).
+  LifetimeSymbolTable lifetime_parameters_by_name;
+
+  // Hash of the above, combined by `DenseMapInfo<ValueLifetimes>` with the
+  // hash of the type, or 0 if it hasn't been computed yet. Reset whenever the
+  // data is modified, which only happens while it isn't shared.
+  mutable std::atomic<unsigned> hash{0};
+};
+
+const ValueLifetimes::Data& ValueLifetimes::GetData() const {
+  static const Data* const empty = new Data();
+  return data_ ? *data_ : *empty;
 }
 
-// Defined here because FunctionLifetimes is an incomplete type in the header.
-ValueLifetimes::~ValueLifetimes() = default;
+ValueLifetimes::Data& ValueLifetimes::GetMutableData() {
+  if (!data_) {
+    data_ = std::make_shared<Data>();
+  } else if (data_.use_count() > 1) {
+    data_ = std::make_shared<Data>(*data_);
+  }
+  data_->hash = 0;
+  return *data_;
+}
 
 namespace {
 
@@ -301,7 +334,7 @@ ValueLifetimes ValueLifetimes::PointerTo(const clang::QualType pointer_type,
   ret.type_ = pointer_type;
   assert(pointer_type->getPointeeType().getCanonicalType() ==
          obj.Type().getCanonicalType());
-  ret.pointee_lifetimes_ = std::make_unique<ObjectLifetimes>(obj);
+  ret.GetMutableData().pointee_lifetimes = obj;
   return ret;
 }
 
@@ -337,8 +370,7 @@ llvm::Expected<ValueLifetimes> ValueLifetimes::Create(
                 .moveInto(fn_lftm)) {
       return std::move(err);
     }
-    ret.function_lifetimes_ =
-        std::make_unique<FunctionLifetimes>(std::move(fn_lftm));
+    ret.GetMutableData().function_lifetimes = std::move(fn_lftm);
     return ret;
   }
 
@@ -360,7 +392,8 @@ llvm::Expected<ValueLifetimes> ValueLifetimes::Create(
     if (llvm::Error err = lifetime_factory(lifetime_name).moveInto(l)) {
       return std::move(err);
     }
-    ret.lifetime_parameters_by_name_.Add(lifetime_params[i], l);
+    ret.GetMutableData().lifetime_parameters_by_name.Add(lifetime_params[i],
+                                                         l);
   }
 
   // Add implicit lifetime parameters for type template parameters.
@@ -379,11 +412,13 @@ llvm::Expected<ValueLifetimes> ValueLifetimes::Create(
                 return err;
               }
             }
-            if (ret.template_argument_lifetimes_.size() <= depth) {
-              ret.template_argument_lifetimes_.resize(depth + 1);
+            auto& template_argument_lifetimes =
+                ret.GetMutableData().template_argument_lifetimes;
+            if (template_argument_lifetimes.size() <= depth) {
+              template_argument_lifetimes.resize(depth + 1);
             }
-            ret.template_argument_lifetimes_[depth].push_back(
-                maybe_template_arg_lifetime);
+            template_argument_lifetimes[depth].push_back(
+                std::move(maybe_template_arg_lifetime));
             return llvm::Error::success();
           })) {
     return std::move(err);
@@ -438,8 +473,8 @@ llvm::Expected<ValueLifetimes> ValueLifetimes::Create(
       return std::move(err);
     }
   }
-  ret.pointee_lifetimes_ =
-      std::make_unique<ObjectLifetimes>(object_lifetime, value_lifetimes);
+  ret.GetMutableData().pointee_lifetimes.emplace(object_lifetime,
+                                                 std::move(value_lifetimes));
   return ret;
 }
 
@@ -452,8 +487,7 @@ ValueLifetimes ValueLifetimes::ForPointerLikeType(
     clang::QualType type, const ObjectLifetimes& object_lifetimes) {
   assert(!PointeeType(type).isNull());
   ValueLifetimes result(type);
-  result.pointee_lifetimes_ =
-      std::make_unique<ObjectLifetimes>(object_lifetimes);
+  result.GetMutableData().pointee_lifetimes = object_lifetimes;
   return result;
 }
 
@@ -469,36 +503,41 @@ ValueLifetimes ValueLifetimes::ForRecord(
            template_argument_lifetimes[depth].size());
   }
   ValueLifetimes result(type);
-  result.template_argument_lifetimes_ = std::move(template_argument_lifetimes);
-  result.lifetime_parameters_by_name_ = lifetime_parameters;
+  if (!template_argument_lifetimes.empty() ||
+      !lifetime_parameters.GetMapping().empty()) {
+    Data& data = result.GetMutableData();
+    data.template_argument_lifetimes = std::move(template_argument_lifetimes);
+    data.lifetime_parameters_by_name = std::move(lifetime_parameters);
+  }
   return result;
 }
 
 std::string ValueLifetimes::DebugString(
     const LifetimeFormatter& formatter) const {
+  const Data& data = GetData();
   if (Type()->isFunctionPointerType() || Type()->isFunctionReferenceType()) {
     // Function pointers and function references have an implied static
     // lifetime. This is never annotated, so don't print it either.
     // Note: If at some point we decide we want to distinguish between regular
     // pointers (to objects) and function pointers in more places, we could
-    // consider adding a `function_pointee_lifetimes_` in addition to
-    // `pointee_lifetimes_`.
-    assert(pointee_lifetimes_->GetLifetime() == Lifetime::Static());
-    return pointee_lifetimes_->GetValueLifetimes().DebugString(formatter);
+    // consider adding a `function_pointee_lifetimes` in addition to
+    // `pointee_lifetimes`.
+    assert(data.pointee_lifetimes->GetLifetime() == Lifetime::Static());
+    return data.pointee_lifetimes->GetValueLifetimes().DebugString(formatter);
   }
   if (!PointeeType(Type()).isNull()) {
-    assert(pointee_lifetimes_);
-    return pointee_lifetimes_->DebugString(formatter);
+    assert(data.pointee_lifetimes);
+    return data.pointee_lifetimes->DebugString(formatter);
   }
   if (Type()->getAs<clang::FunctionProtoType>()) {
-    assert(function_lifetimes_);
-    std::string fn_lifetimes = function_lifetimes_->DebugString(formatter);
+    assert(data.function_lifetimes);
+    std::string fn_lifetimes = data.function_lifetimes->DebugString(formatter);
     if (fn_lifetimes.empty()) return "";
     return absl::StrCat("(", fn_lifetimes, ")");
   }
 
   std::vector<std::vector<std::string>> tmpl_lifetimes;
-  for (auto& tmpl_arg_at_depth : template_argument_lifetimes_) {
+  for (auto& tmpl_arg_at_depth : data.template_argument_lifetimes) {
     tmpl_lifetimes.emplace_back();
     for (const std::optional<ValueLifetimes>& tmpl_arg : tmpl_arg_at_depth) {
       if (tmpl_arg) {
@@ -512,7 +551,7 @@ std::string ValueLifetimes::DebugString(
   std::vector<std::string> lifetime_parameters;
   for (const auto& lftm_arg : GetLifetimeParameters(type_)) {
     std::optional<Lifetime> lifetime =
-        lifetime_parameters_by_name_.LookupName(lftm_arg);
+        data.lifetime_parameters_by_name.LookupName(lftm_arg);
     assert(lifetime.has_value());
     lifetime_parameters.push_back(formatter(*lifetime));
   }
@@ -552,102 +591,155 @@ std::string ValueLifetimes::DebugString(
 
 const ObjectLifetimes& ValueLifetimes::GetPointeeLifetimes() const {
   assert(!PointeeType(type_).isNull());
-  assert(pointee_lifetimes_);
-  return *pointee_lifetimes_;
+  assert(GetData().pointee_lifetimes);
+  return *GetData().pointee_lifetimes;
 }
 
 const FunctionLifetimes& ValueLifetimes::GetFuncLifetimes() const {
   assert(type_->getAs<clang::FunctionProtoType>() != nullptr);
-  assert(function_lifetimes_);
-  return *function_lifetimes_;
+  assert(GetData().function_lifetimes);
+  return *GetData().function_lifetimes;
+}
+
+const std::optional<ValueLifetimes>&
+ValueLifetimes::GetTemplateArgumentLifetimes(size_t depth,
+                                             size_t index) const {
+  assert(type_->isRecordType());
+  return GetData().template_argument_lifetimes.at(depth).at(index);
+}
+
+size_t ValueLifetimes::GetNumTemplateNestingLevels() const {
+  assert(type_->isRecordType());
+  return GetData().template_argument_lifetimes.size();
+}
+
+size_t ValueLifetimes::GetNumTemplateArgumentsAtDepth(size_t depth) const {
+  assert(type_->isRecordType());
+  return GetData().template_argument_lifetimes.at(depth).size();
+}
+
+Lifetime ValueLifetimes::GetLifetimeParameter(llvm::StringRef param) const {
+  std::optional<Lifetime> ret =
+      GetData().lifetime_parameters_by_name.LookupName(param);
+  assert(ret.has_value());
+  return ret.value();
+}
+
+bool ValueLifetimes::HasLifetimes() const {
+  const Data& data = GetData();
+  return data.pointee_lifetimes.has_value() ||
+         data.function_lifetimes.has_value() ||
+         !data.lifetime_parameters_by_name.GetMapping().empty() ||
+         !data.template_argument_lifetimes.empty();
 }
 
 bool ValueLifetimes::HasAny(
     const std::function<bool(Lifetime)>& predicate) const {
-  for (const auto& tmpl_arg_at_depth : template_argument_lifetimes_) {
+  const Data& data = GetData();
+  for (const auto& tmpl_arg_at_depth : data.template_argument_lifetimes) {
     for (const std::optional<ValueLifetimes>& tmpl_arg : tmpl_arg_at_depth) {
       if (tmpl_arg && tmpl_arg->HasAny(predicate)) {
         return true;
       }
     }
   }
-  if (pointee_lifetimes_ && pointee_lifetimes_->HasAny(predicate)) {
+  if (data.pointee_lifetimes && data.pointee_lifetimes->HasAny(predicate)) {
     return true;
   }
   for (const auto& lftm_arg : GetLifetimeParameters(type_)) {
     std::optional<Lifetime> lifetime =
-        lifetime_parameters_by_name_.LookupName(lftm_arg);
+        data.lifetime_parameters_by_name.LookupName(lftm_arg);
     assert(lifetime.has_value());
     if (predicate(lifetime.value())) {
       return true;
     }
   }
-  if (function_lifetimes_ && function_lifetimes_->HasAny(predicate)) {
+  if (data.function_lifetimes && data.function_lifetimes->HasAny(predicate)) {
     return true;
   }
   return false;
 }
 
 void ValueLifetimes::SubstituteLifetimes(const LifetimeSubstitutions& subst) {
-  for (auto& tmpl_arg_at_depth : template_argument_lifetimes_) {
+  if (!data_) return;
+  Data& data = GetMutableData();
+  for (auto& tmpl_arg_at_depth : data.template_argument_lifetimes) {
     for (std::optional<ValueLifetimes>& tmpl_arg : tmpl_arg_at_depth) {
       if (tmpl_arg) {
         tmpl_arg->SubstituteLifetimes(subst);
       }
     }
   }
-  if (pointee_lifetimes_) {
-    pointee_lifetimes_->SubstituteLifetimes(subst);
+  if (data.pointee_lifetimes) {
+    data.pointee_lifetimes->SubstituteLifetimes(subst);
   }
   for (const auto& lftm_arg : GetLifetimeParameters(type_)) {
     std::optional<Lifetime> lifetime =
-        lifetime_parameters_by_name_.LookupName(lftm_arg);
+        data.lifetime_parameters_by_name.LookupName(lftm_arg);
     assert(lifetime.has_value());
-    lifetime_parameters_by_name_.Rebind(lftm_arg, subst.Substitute(*lifetime));
+    data.lifetime_parameters_by_name.Rebind(lftm_arg,
+                                            subst.Substitute(*lifetime));
   }
-  if (function_lifetimes_) {
-    function_lifetimes_->SubstituteLifetimes(subst);
+  if (data.function_lifetimes) {
+    data.function_lifetimes->SubstituteLifetimes(subst);
   }
 }
 
 void ValueLifetimes::Traverse(std::function<void(Lifetime&, Variance)> visitor,
                               Variance variance) {
-  for (auto& tmpl_arg_at_depth : template_argument_lifetimes_) {
+  if (!data_) return;
+  Data& data = GetMutableData();
+  for (auto& tmpl_arg_at_depth : data.template_argument_lifetimes) {
     for (std::optional<ValueLifetimes>& tmpl_arg : tmpl_arg_at_depth) {
       if (tmpl_arg) {
         tmpl_arg->Traverse(visitor, kInvariant);
       }
     }
   }
-  if (pointee_lifetimes_) {
-    pointee_lifetimes_->Traverse(visitor, variance, Type());
+  if (data.pointee_lifetimes) {
+    data.pointee_lifetimes->Traverse(visitor, variance, Type());
   }
   for (const auto& lftm_arg : GetLifetimeParameters(type_)) {
     std::optional<Lifetime> lifetime =
-        lifetime_parameters_by_name_.LookupName(lftm_arg);
+        data.lifetime_parameters_by_name.LookupName(lftm_arg);
     assert(lifetime.has_value());
     Lifetime new_lifetime = *lifetime;
     visitor(new_lifetime, variance);
-
-    // Note that this check is not an optimization, but a guard against UB:
-    // if one calls the const version of Traverse, with a callback that does not
-    // mutate the lifetime, on a const instance of the Value/ObjectLifetimes,
-    // then calling Rebind would be UB, even if Rebind would do nothing in
-    // practice.
     if (new_lifetime != lifetime) {
-      lifetime_parameters_by_name_.Rebind(lftm_arg, new_lifetime);
+      data.lifetime_parameters_by_name.Rebind(lftm_arg, new_lifetime);
     }
   }
-  if (function_lifetimes_) {
-    function_lifetimes_->Traverse(visitor);
+  if (data.function_lifetimes) {
+    data.function_lifetimes->Traverse(visitor);
   }
 }
 
+// The const version visits the lifetimes in the same order, but without
+// calling `GetMutableData()`, so that data shared with other ValueLifetimes
+// isn't copied.
 void ValueLifetimes::Traverse(
     std::function<void(const Lifetime&, Variance)> visitor,
     Variance variance) const {
-  const_cast<ValueLifetimes*>(this)->Traverse(
-      [&visitor](Lifetime& l, Variance v) { visitor(l, v); }, variance);
+  const Data& data = GetData();
+  for (const auto& tmpl_arg_at_depth : data.template_argument_lifetimes) {
+    for (const std::optional<ValueLifetimes>& tmpl_arg : tmpl_arg_at_depth) {
+      if (tmpl_arg) {
+        tmpl_arg->Traverse(visitor, kInvariant);
+      }
+    }
+  }
+  if (data.pointee_lifetimes) {
+    data.pointee_lifetimes->Traverse(visitor, variance, Type());
+  }
+  for (const auto& lftm_arg : GetLifetimeParameters(type_)) {
+    std::optional<Lifetime> lifetime =
+        data.lifetime_parameters_by_name.LookupName(lftm_arg);
+    assert(lifetime.has_value());
+    visitor(*lifetime, variance);
+  }
+  if (data.function_lifetimes) {
+    std::as_const(*data.function_lifetimes).Traverse(visitor);
+  }
 }
 
 ValueLifetimes::ValueLifetimes(clang::QualType type) : type_(type) {}
@@ -961,9 +1053,14 @@ void ObjectLifetimes::Traverse(std::function<void(Lifetime&, Variance)> visitor,
 void ObjectLifetimes::Traverse(
     std::function<void(const Lifetime&, Variance)> visitor, Variance variance,
     clang::QualType indirection_type) const {
-  const_cast<ObjectLifetimes*>(this)->Traverse(
-      [&visitor](Lifetime& l, Variance v) { visitor(l, v); }, variance,
-      indirection_type);
+  assert(indirection_type.isNull() ||
+         StripAttributes(indirection_type->getPointeeType().IgnoreParens()) ==
+             Type());
+  value_lifetimes_.Traverse(
+      visitor, indirection_type.isNull() || indirection_type.isConstQualified()
+                   ? kCovariant
+                   : kInvariant);
+  visitor(lifetime_, variance);
 }
 
 llvm::Expected<llvm::StringRef> EvaluateAsStringLiteral(
@@ -1006,27 +1103,32 @@ bool DenseMapInfo<clang::tidy::lifetimes::ValueLifetimes>::isEqual(
   if (lhs.type_ != rhs.type_) {
     return false;
   }
-  if ((lhs.pointee_lifetimes_ == nullptr) !=
-      (rhs.pointee_lifetimes_ == nullptr)) {
+  if (lhs.data_ == rhs.data_) {
+    return true;
+  }
+  const auto& lhs_data = lhs.GetData();
+  const auto& rhs_data = rhs.GetData();
+  if (lhs_data.pointee_lifetimes.has_value() !=
+      rhs_data.pointee_lifetimes.has_value()) {
     return false;
   }
-  if (lhs.pointee_lifetimes_ &&
+  if (lhs_data.pointee_lifetimes &&
       !DenseMapInfo<clang::tidy::lifetimes::ObjectLifetimes>::isEqual(
-          *lhs.pointee_lifetimes_, *rhs.pointee_lifetimes_)) {
+          *lhs_data.pointee_lifetimes, *rhs_data.pointee_lifetimes)) {
     return false;
   }
-  if (lhs.template_argument_lifetimes_.size() !=
-      rhs.template_argument_lifetimes_.size()) {
+  const auto& lhs_args = lhs_data.template_argument_lifetimes;
+  const auto& rhs_args = rhs_data.template_argument_lifetimes;
+  if (lhs_args.size() != rhs_args.size()) {
     return false;
   }
-  for (size_t i = 0; i < lhs.template_argument_lifetimes_.size(); i++) {
-    if (lhs.template_argument_lifetimes_[i].size() !=
-        rhs.template_argument_lifetimes_[i].size()) {
+  for (size_t i = 0; i < lhs_args.size(); i++) {
+    if (lhs_args[i].size() != rhs_args[i].size()) {
       return false;
     }
-    for (size_t j = 0; j < lhs.template_argument_lifetimes_[i].size(); j++) {
-      const auto& alhs = lhs.template_argument_lifetimes_[i][j];
-      const auto& arhs = rhs.template_argument_lifetimes_[i][j];
+    for (size_t j = 0; j < lhs_args[i].size(); j++) {
+      const auto& alhs = lhs_args[i][j];
+      const auto& arhs = rhs_args[i][j];
       if (alhs.has_value() != arhs.has_value()) {
         return false;
       }
@@ -1035,8 +1137,8 @@ bool DenseMapInfo<clang::tidy::lifetimes::ValueLifetimes>::isEqual(
       }
     }
   }
-  if (lhs.lifetime_parameters_by_name_.GetMapping() !=
-      rhs.lifetime_parameters_by_name_.GetMapping()) {
+  if (lhs_data.lifetime_parameters_by_name.GetMapping() !=
+      rhs_data.lifetime_parameters_by_name.GetMapping()) {
     return false;
   }
   return true;
@@ -1044,29 +1146,39 @@ bool DenseMapInfo<clang::tidy::lifetimes::ValueLifetimes>::isEqual(
 
 unsigned DenseMapInfo<clang::tidy::lifetimes::ValueLifetimes>::getHashValue(
     const clang::tidy::lifetimes::ValueLifetimes& value_lifetimes) {
-  llvm::hash_code hash = 0;
-  if (value_lifetimes.pointee_lifetimes_) {
-    hash = DenseMapInfo<clang::tidy::lifetimes::ObjectLifetimes>::getHashValue(
-        *value_lifetimes.pointee_lifetimes_);
-  }
-  for (const auto& lifetimes_at_depth :
-       value_lifetimes.template_argument_lifetimes_) {
-    for (const auto& tmpl_lifetime : lifetimes_at_depth) {
-      if (tmpl_lifetime) {
-        hash = hash_combine(hash, getHashValue(*tmpl_lifetime));
+  const auto& data = value_lifetimes.GetData();
+  unsigned data_hash = data.hash.load(std::memory_order_relaxed);
+  if (data_hash == 0) {
+    llvm::hash_code hash = 0;
+    if (data.pointee_lifetimes) {
+      hash =
+          DenseMapInfo<clang::tidy::lifetimes::ObjectLifetimes>::getHashValue(
+              *data.pointee_lifetimes);
+    }
+    for (const auto& lifetimes_at_depth : data.template_argument_lifetimes) {
+      for (const auto& tmpl_lifetime : lifetimes_at_depth) {
+        if (tmpl_lifetime) {
+          hash = hash_combine(hash, getHashValue(*tmpl_lifetime));
+        }
       }
     }
-  }
-  for (const auto& lifetime_arg :
-       value_lifetimes.lifetime_parameters_by_name_.GetMapping()) {
-    hash = hash_combine(hash, DenseMapInfo<llvm::StringRef>::getHashValue(
-                                  lifetime_arg.first()));
-    hash = hash_combine(
-        hash, DenseMapInfo<clang::tidy::lifetimes::Lifetime>::getHashValue(
-                  lifetime_arg.second));
+    // The iteration order of the mapping depends on its insertion history, so
+    // combine the entries in an order-independent way.
+    size_t lifetime_args_hash = 0;
+    for (const auto& lifetime_arg :
+         data.lifetime_parameters_by_name.GetMapping()) {
+      lifetime_args_hash += hash_combine(
+          lifetime_arg.first,
+          DenseMapInfo<clang::tidy::lifetimes::Lifetime>::getHashValue(
+              lifetime_arg.second));
+    }
+    hash = hash_combine(hash, lifetime_args_hash);
+    data_hash = hash;
+    data.hash.store(data_hash, std::memory_order_relaxed);
   }
   return hash_combine(
-      hash, DenseMapInfo<clang::QualType>::getHashValue(value_lifetimes.type_));
+      data_hash,
+      DenseMapInfo<clang::QualType>::getHashValue(value_lifetimes.type_));
 }
 
 }  // namespace llvm
@@ -71,18 +71,18 @@ class FunctionLifetimes;
 // Represents the lifetimes of a value; these may be 0 for non-reference-like
 // types, 1 for pointers/references, and an arbitrary number for structs with
 // template arguments/lifetime parameters.
+//
+// The nested lifetimes are shared between copies of a ValueLifetimes and only
+// copied when one of the copies is modified, so copying a ValueLifetimes, and
+// comparing or hashing copies of the same ValueLifetimes, takes constant time.
+// Copies of a ValueLifetimes may therefore not be used concurrently from
+// different threads, even if none of them is modified.
 class ValueLifetimes {
  public:
   // Creates an invalid ValueLifetimes, which should not be used. This is
   // provided only for usage with functions with output parameters.
   ValueLifetimes() : ValueLifetimes(clang::QualType()) {}
 
-  ValueLifetimes(const ValueLifetimes& other);
-
-  ValueLifetimes& operator=(const ValueLifetimes& other);
-
-  ~ValueLifetimes();
-
   // Creates a ValueLifetimes for a *value* of a given type.
   // Only fails if lifetime_factory fails.
   // Lifetimes will be created in post-order in the tree of lifetimes.
@@ -147,37 +147,19 @@ class ValueLifetimes {
   // For example, for a type `Outer<int*, double*>::Inner<long*>`, the
   // `double*` template argument has depth 0 and index 1.
   const std::optional<ValueLifetimes>& GetTemplateArgumentLifetimes(
-      size_t depth, size_t index) const {
-    assert(type_->isRecordType());
-    return template_argument_lifetimes_.at(depth).at(index);
-  }
+      size_t depth, size_t index) const;
 
   // Returns the number of template nesting levels.
-  size_t GetNumTemplateNestingLevels() const {
-    assert(type_->isRecordType());
-    return template_argument_lifetimes_.size();
-  }
+  size_t GetNumTemplateNestingLevels() const;
 
   // Returns the number of template arguments at a given nesting `depth` (see
   // `GetTemplateArgumentLifetimes` for details).
-  size_t GetNumTemplateArgumentsAtDepth(size_t depth) const {
-    assert(type_->isRecordType());
-    return template_argument_lifetimes_.at(depth).size();
-  }
+  size_t GetNumTemplateArgumentsAtDepth(size_t depth) const;
 
   // Returns the lifetime associated with the given named lifetime parameter.
-  Lifetime GetLifetimeParameter(llvm::StringRef param) const {
-    std::optional<Lifetime> ret =
-        lifetime_parameters_by_name_.LookupName(param);
-    assert(ret.has_value());
-    return ret.value();
-  }
+  Lifetime GetLifetimeParameter(llvm::StringRef param) const;
 
-  bool HasLifetimes() const {
-    return pointee_lifetimes_ != nullptr || function_lifetimes_ != nullptr ||
-           !lifetime_parameters_by_name_.GetMapping().empty() ||
-           !template_argument_lifetimes_.empty();
-  }
+  bool HasLifetimes() const;
 
   // Returns true if `predicate` returns true for any lifetime that appears in
   // the `ValueLifetimes`.
@@ -201,33 +183,23 @@ class ValueLifetimes {
                 Variance variance = kCovariant) const;
 
  private:
+  // The nested lifetimes of a ValueLifetimes, which are shared between its
+  // copies. Defined in the .cc file.
+  struct Data;
+
   explicit ValueLifetimes(clang::QualType type);
 
-  // Note: only one of `pointee_lifetimes_`, `function_lifetimes_` or
-  // `template_argument_lifetimes_` is non-empty.
-  std::unique_ptr<ObjectLifetimes> pointee_lifetimes_;
-  std::unique_ptr<FunctionLifetimes> function_lifetimes_;
-  std::vector<std::vector<std::optional<ValueLifetimes>>>
-      template_argument_lifetimes_;
+  // Returns the nested lifetimes, which are empty if `data_` is null.
+  const Data& GetData() const;
+
+  // Returns the nested lifetimes for modification, first copying them if they
+  // are shared with other ValueLifetimes.
+  Data& GetMutableData();
+
   clang::QualType type_;
 
-  // Tracks the mapping from the names of the lifetimes on the struct/class
-  // definition to the associated `Lifetime`s. For example, in the following
-  // code
-  //
-  // class string_view LIFETIME_PARAM(d) { ... };
-  //
-  // string_view $a drop_last(string_view $a in) {
-  //   string_view result;
-  //   ...
-  //   return result;
-  // }
-  //
-  // the value stored in `result`/`in` has 1 lifetime argument. This lifetime
-  // has a local name "a" (it is not possible to retrieve this mapping from this
-  // ValueLifetimes object). This lifetime substitutes lifetime "d" from
-  // string_view (this mapping is tracked by lifetime_parameters_by_name_).
-  LifetimeSymbolTable lifetime_parameters_by_name_;
+  // Null for lifetime-less types, so that these don't need an allocation.
+  std::shared_ptr<Data> data_;
 
   friend class llvm::DenseMapInfo<clang::tidy::lifetimes::ValueLifetimes>;
 };
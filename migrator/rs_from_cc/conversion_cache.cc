@@ -0,0 +1,184 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "migrator/rs_from_cc/conversion_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclBase.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/AST/TypeLoc.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/xxhash.h"
+
+namespace crubit_rs_from_cc {
+namespace {
+
+// Identifies the format of the serialized cache. Must be changed whenever the
+// generated code changes, so that stale entries are dropped.
+constexpr absl::string_view kFormatVersion = "rs_from_cc conversion cache v1";
+
+// Collects the type declarations referenced (directly) by a declaration.
+class TypeDeclCollector
+    : public clang::RecursiveASTVisitor<TypeDeclCollector> {
+ public:
+  bool VisitTagTypeLoc(clang::TagTypeLoc type_loc) {
+    decls_.push_back(type_loc.getDecl());
+    return true;
+  }
+
+  bool VisitTypedefTypeLoc(clang::TypedefTypeLoc type_loc) {
+    decls_.push_back(type_loc.getTypedefNameDecl());
+    return true;
+  }
+
+  std::vector<const clang::Decl*>& decls() { return decls_; }
+
+ private:
+  std::vector<const clang::Decl*> decls_;
+};
+
+// Appends the location and source text of `decl` to `fingerprint_input`. The
+// location is included because the generated code refers to it.
+void AppendDecl(const clang::Decl* decl, std::string& fingerprint_input) {
+  const clang::ASTContext& ast_context = decl->getASTContext();
+  const clang::SourceManager& source_manager = ast_context.getSourceManager();
+  for (clang::SourceLocation loc : {decl->getBeginLoc(), decl->getEndLoc()}) {
+    clang::PresumedLoc presumed = source_manager.getPresumedLoc(loc);
+    if (presumed.isValid()) {
+      absl::StrAppend(&fingerprint_input, presumed.getFilename(), ":",
+                      presumed.getLine(), ":", presumed.getColumn(), "\n");
+    }
+  }
+  llvm::StringRef text = clang::Lexer::getSourceText(
+      source_manager.getExpansionRange(decl->getSourceRange()),
+      source_manager, ast_context.getLangOpts());
+  absl::StrAppend(&fingerprint_input,
+                  absl::string_view(text.data(), text.size()), "\n");
+}
+
+}  // namespace
+
+absl::StatusOr<ConversionCache> ConversionCache::Parse(
+    absl::string_view text) {
+  absl::flat_hash_map<std::string, std::string> entries;
+  // The first line is the format version, followed by
+  // "<key>\t<size of the Rust code>\n<Rust code>" for each entry.
+  size_t newline = text.find('\n');
+  if (newline == absl::string_view::npos ||
+      text.substr(0, newline) != kFormatVersion) {
+    return ConversionCache();
+  }
+  text.remove_prefix(newline + 1);
+  while (!text.empty()) {
+    newline = text.find('\n');
+    absl::string_view header = text.substr(0, newline);
+    size_t tab = header.find('\t');
+    size_t size;
+    if (newline == absl::string_view::npos ||
+        tab == absl::string_view::npos ||
+        !absl::SimpleAtoi(header.substr(tab + 1), &size) ||
+        size > text.size() - newline - 1) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("malformed conversion cache entry: ", header));
+    }
+    entries[header.substr(0, tab)] = text.substr(newline + 1, size);
+    text.remove_prefix(newline + 1 + size);
+  }
+  ConversionCache result;
+  {
+    absl::MutexLock lock(&result.mutex_);
+    result.entries_ = std::move(entries);
+  }
+  return result;
+}
+
+std::string ConversionCache::Serialize() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<std::pair<absl::string_view, absl::string_view>> entries(
+      entries_.begin(), entries_.end());
+  std::sort(entries.begin(), entries.end());
+  std::string result = absl::StrCat(kFormatVersion, "\n");
+  for (const auto& [key, rs_code] : entries) {
+    absl::StrAppend(&result, key, "\t", rs_code.size(), "\n", rs_code);
+  }
+  return result;
+}
+
+std::string ConversionCache::GetKey(const clang::Decl* decl) {
+  std::string fingerprint_input;
+  AppendDecl(decl, fingerprint_input);
+
+  // The generated code also depends on the types that `decl` uses, e.g. the
+  // canonical types in the AST dump, so include the declarations of those
+  // types and, transitively, of the types that they use.
+  absl::flat_hash_set<const clang::Decl*> visited = {decl};
+  std::vector<const clang::Decl*> worklist = {decl};
+  std::vector<std::string> type_decls;
+  while (!worklist.empty()) {
+    const clang::Decl* current = worklist.back();
+    worklist.pop_back();
+    TypeDeclCollector collector;
+    collector.TraverseDecl(const_cast<clang::Decl*>(current));
+    for (const clang::Decl* type_decl : collector.decls()) {
+      if (!visited.insert(type_decl).second) continue;
+      std::string type_decl_input;
+      AppendDecl(type_decl, type_decl_input);
+      type_decls.push_back(std::move(type_decl_input));
+      worklist.push_back(type_decl);
+    }
+  }
+  std::sort(type_decls.begin(), type_decls.end());
+  for (const std::string& type_decl : type_decls) {
+    absl::StrAppend(&fingerprint_input, type_decl);
+  }
+
+  uint64_t fingerprint = llvm::xxh3_64bits(fingerprint_input);
+  return absl::StrCat(absl::Hex(fingerprint, absl::kZeroPad16));
+}
+
+std::optional<std::string> ConversionCache::Lookup(absl::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) return std::nullopt;
+  ++hits_;
+  return iter->second;
+}
+
+void ConversionCache::Insert(absl::string_view key,
+                             absl::string_view rs_code) {
+  absl::MutexLock lock(&mutex_);
+  entries_[key] = rs_code;
+}
+
+size_t ConversionCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+size_t ConversionCache::hits() const {
+  absl::MutexLock lock(&mutex_);
+  return hits_;
+}
+
+}  // namespace crubit_rs_from_cc
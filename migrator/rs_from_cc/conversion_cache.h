@@ -0,0 +1,70 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_MIGRATOR_RS_FROM_CC_CONVERSION_CACHE_H_
+#define CRUBIT_MIGRATOR_RS_FROM_CC_CONVERSION_CACHE_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "clang/AST/DeclBase.h"
+
+namespace crubit_rs_from_cc {
+
+// A cache of the Rust code generated for top-level declarations, so that
+// re-running the migrator after a small edit only converts the declarations
+// that changed.
+//
+// Entries are keyed by a fingerprint of everything the generated code depends
+// on: the source text and location of the declaration, and those of the type
+// declarations that it (transitively) uses. The cache may be shared between
+// the threads of `RsFromCcFiles()`.
+class ConversionCache {
+ public:
+  ConversionCache() = default;
+
+  ConversionCache(ConversionCache&& other) {
+    absl::MutexLock lock(&other.mutex_);
+    entries_ = std::move(other.entries_);
+    hits_ = other.hits_;
+  }
+
+  // Parses a cache that was returned by `Serialize()`. Returns an empty cache
+  // if `text` was serialized by a different version of the migrator.
+  static absl::StatusOr<ConversionCache> Parse(absl::string_view text);
+
+  // Returns a representation of the cache that can be passed to `Parse()`.
+  std::string Serialize() const;
+
+  // Returns the key for the Rust code of `decl`.
+  static std::string GetKey(const clang::Decl* decl);
+
+  // Returns the cached Rust code for `key`, if any.
+  std::optional<std::string> Lookup(absl::string_view key);
+
+  // Caches `rs_code` under `key`.
+  void Insert(absl::string_view key, absl::string_view rs_code);
+
+  size_t size() const;
+
+  // Returns the number of successful calls to `Lookup()`.
+  size_t hits() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::string> entries_
+      ABSL_GUARDED_BY(mutex_);
+  size_t hits_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace crubit_rs_from_cc
+
+#endif  // CRUBIT_MIGRATOR_RS_FROM_CC_CONVERSION_CACHE_H_
@@ -4,11 +4,14 @@
 
 #include "migrator/rs_from_cc/converter.h"
 
+#include <optional>
 #include <string>
 
 #include "absl/strings/str_split.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclBase.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
 #include "third_party/re2/re2.h"
 
@@ -21,7 +24,22 @@ void Converter::Convert(const clang::TranslationUnitDecl* translation_unit) {
       // generates.
       continue;
     }
-    Convert(decl);
+    if (cache_ == nullptr) {
+      Convert(decl);
+      continue;
+    }
+    std::string key = ConversionCache::GetKey(decl);
+    if (std::optional<std::string> rs_code = cache_->Lookup(key)) {
+      result_ << *rs_code;
+      continue;
+    }
+    std::string rs_code;
+    {
+      llvm::raw_string_ostream rs_out(rs_code);
+      Converter(rs_out, ctx_).Convert(decl);
+    }
+    result_ << rs_code;
+    cache_->Insert(key, rs_code);
   }
 }
 
@@ -41,8 +59,8 @@ void Converter::ConvertUnhandled(const clang::Decl* decl) {
   llvm::raw_string_ostream os(ast);
   decl->dump(os);
   os.flush();
-  result_ += "\n";
-  result_ += "// Unsupported decl:\n//\n";
+  result_ << "\n";
+  result_ << "// Unsupported decl:\n//\n";
   // Remove addresses since they're not useful and add non-determinism that
   // would break golden testing.
   // Also remove spaces at the end of each line, those are a pain in golden
@@ -52,9 +70,7 @@ void Converter::ConvertUnhandled(const clang::Decl* decl) {
     if (line.empty()) {
       continue;
     }
-    result_ += "// ";
-    result_ += line;
-    result_ += '\n';
+    result_ << "// " << llvm::StringRef(line.data(), line.size()) << '\n';
   }
 }
 
@@ -18,6 +18,7 @@
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "lifetime_annotations/lifetime_annotations.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/Mangle.h"
@@ -26,31 +27,48 @@
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/Specifiers.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace crubit_rs_from_cc {
 
-// Visits the C++ AST and generates the corresponding Rust code in the
-// Invocation object.
+// Visits the C++ AST and writes the corresponding Rust code to the
+// Invocation's output stream.
 class Converter {
  public:
-  // Top-level parameters as well as return value of a migrator invocation.
+  // Top-level parameters as well as output of a migrator invocation.
   class Invocation {
    public:
-    std::string rs_code_;
+    explicit Invocation(llvm::raw_ostream& rs_out) : rs_out_(rs_out) {}
+
+    // The stream that the Rust code is written to, one declaration at a
+    // time, so that the code for a large translation unit doesn't need to be
+    // kept in memory.
+    llvm::raw_ostream& rs_out_;
+
+    // If set, the Rust code for unchanged top-level declarations is taken
+    // from (and the code for the others is added to) this cache.
+    ConversionCache* cache_ = nullptr;
   };
 
   explicit Converter(Invocation& invocation, clang::ASTContext& ctx)
-      : result_(invocation.rs_code_), ctx_(ctx) {}
+      : result_(invocation.rs_out_), cache_(invocation.cache_), ctx_(ctx) {}
 
   void Convert(const clang::TranslationUnitDecl* translation_unit);
 
  private:
+  // Creates a converter that writes to `result` without caching, for the code
+  // of a single declaration.
+  Converter(llvm::raw_ostream& result, clang::ASTContext& ctx)
+      : result_(result), cache_(nullptr), ctx_(ctx) {}
+
   void Convert(const clang::Decl* decl);
 
   void ConvertUnhandled(const clang::Decl* decl);
 
   // The main output of the conversion process (Rust code).
-  std::string& result_;
+  llvm::raw_ostream& result_;
+
+  ConversionCache* cache_;
 
   clang::ASTContext& ctx_;
 };  // class Converter
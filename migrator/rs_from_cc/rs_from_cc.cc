@@ -3,8 +3,14 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 // Parses C++ code and generates an equivalent Rust source file.
+//
+// With --compilation_database, converts all the given source files (or all
+// files in the database, if none are given) in parallel, writing one Rust
+// file per source file to --rs_out_dir.
 
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,17 +21,90 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "common/file_io.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
 #include "migrator/rs_from_cc/rs_from_cc_lib.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/FileSystem.h"
 
 ABSL_FLAG(std::string, cc_in, "",
           "input path for the C++ source file (it may or may not be a header)");
 ABSL_FLAG(std::string, rs_out, "",
           "output path for the Rust source file; will be overwritten if it "
           "already exists");
+ABSL_FLAG(std::string, compilation_database, "",
+          "directory containing the compilation database (e.g. "
+          "compile_commands.json) for the files to convert");
+ABSL_FLAG(std::string, rs_out_dir, "",
+          "output directory for the Rust source files, when using "
+          "--compilation_database");
+ABSL_FLAG(int, jobs, 0,
+          "number of files to convert in parallel, when using "
+          "--compilation_database (0 means one per hardware thread)");
+ABSL_FLAG(std::string, cache, "",
+          "path to a cache of the generated Rust code; when set, only "
+          "declarations that changed since the previous run are converted, "
+          "and the cache is updated afterwards");
+
+namespace {
+
+// Loads the cache named by --cache, if any. A missing cache file is treated as
+// an empty cache.
+std::optional<crubit_rs_from_cc::ConversionCache> LoadCache() {
+  std::string path = absl::GetFlag(FLAGS_cache);
+  if (path.empty()) return std::nullopt;
+  if (!llvm::sys::fs::exists(path)) {
+    return crubit_rs_from_cc::ConversionCache();
+  }
+  absl::StatusOr<std::string> text = crubit::GetFileContents(path);
+  CHECK_OK(text);
+  absl::StatusOr<crubit_rs_from_cc::ConversionCache> cache =
+      crubit_rs_from_cc::ConversionCache::Parse(*text);
+  CHECK_OK(cache);
+  return *std::move(cache);
+}
+
+void SaveCache(const std::optional<crubit_rs_from_cc::ConversionCache>& cache) {
+  if (!cache.has_value()) return;
+  CHECK_OK(crubit::SetFileContents(absl::GetFlag(FLAGS_cache),
+                                   cache->Serialize()));
+}
+
+int ConvertCompilationDatabase(std::vector<std::string> cc_files) {
+  auto rs_out_dir = absl::GetFlag(FLAGS_rs_out_dir);
+  if (rs_out_dir.empty()) {
+    std::cerr << "please specify --rs_out_dir" << std::endl;
+    return 1;
+  }
+  std::string error;
+  std::unique_ptr<clang::tooling::CompilationDatabase> compilations =
+      clang::tooling::CompilationDatabase::loadFromDirectory(
+          absl::GetFlag(FLAGS_compilation_database), error);
+  if (compilations == nullptr) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  if (cc_files.empty()) {
+    cc_files = compilations->getAllFiles();
+  }
+  std::optional<crubit_rs_from_cc::ConversionCache> cache = LoadCache();
+  CHECK_OK(crubit_rs_from_cc::RsFromCcFiles(
+      *compilations, cc_files, rs_out_dir, absl::GetFlag(FLAGS_jobs),
+      cache.has_value() ? &*cache : nullptr));
+  SaveCache(cache);
+  return 0;
+}
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
   auto args = absl::ParseCommandLine(argc, argv);
 
+  if (!absl::GetFlag(FLAGS_compilation_database).empty()) {
+    // Skip $0.
+    return ConvertCompilationDatabase(
+        std::vector<std::string>(args.begin() + 1, args.end()));
+  }
+
   auto cc_in = absl::GetFlag(FLAGS_cc_in);
   if (cc_in.empty()) {
     std::cerr << "please specify --cc_in" << std::endl;
@@ -44,10 +123,13 @@ int main(int argc, char* argv[]) {
   // Skip $0.
   ++argv;
 
+  std::optional<crubit_rs_from_cc::ConversionCache> cache = LoadCache();
   absl::StatusOr<std::string> rs_code = crubit_rs_from_cc::RsFromCc(
       cc_file_content, cc_in,
-      std::vector<absl::string_view>(argv, argv + argc));
+      std::vector<absl::string_view>(argv, argv + argc),
+      cache.has_value() ? &*cache : nullptr);
   CHECK_OK(rs_code);
+  SaveCache(cache);
 
   CHECK_OK(crubit::SetFileContents(rs_out, *rs_code));
   return 0;
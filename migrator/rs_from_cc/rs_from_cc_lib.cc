@@ -4,45 +4,159 @@
 
 #include "migrator/rs_from_cc/rs_from_cc_lib.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
 #include "migrator/rs_from_cc/converter.h"
 #include "migrator/rs_from_cc/frontend_action.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/FileSystemOptions.h"
 #include "clang/Frontend/FrontendAction.h"
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CompilationDatabase.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace crubit_rs_from_cc {
 
 absl::StatusOr<std::string> RsFromCc(const absl::string_view cc_file_content,
                                      const absl::string_view cc_file_name,
-                                     absl::Span<const absl::string_view> args) {
+                                     absl::Span<const absl::string_view> args,
+                                     ConversionCache* cache) {
   std::vector<std::string> args_as_strings{
       // Parse non-doc comments that are used as documention
       "-fparse-all-comments"};
   args_as_strings.insert(args_as_strings.end(), args.begin(), args.end());
 
-  Converter::Invocation invocation;
+  std::string rs_code;
+  llvm::raw_string_ostream rs_out(rs_code);
+  Converter::Invocation invocation(rs_out);
+  invocation.cache_ = cache;
   if (clang::tooling::runToolOnCodeWithArgs(
           std::make_unique<FrontendAction>(invocation), cc_file_content,
           args_as_strings, cc_file_name, "rs_from_cc",
           std::make_shared<clang::PCHContainerOperations>(),
           clang::tooling::FileContentMappings())) {
-    return invocation.rs_code_;
+    rs_out.flush();
+    return rs_code;
   } else {
     return absl::Status(absl::StatusCode::kInvalidArgument,
                         "Could not compile source file contents");
   }
 }
 
+std::string RsOutputPath(absl::string_view cc_file,
+                         absl::string_view rs_out_dir) {
+  llvm::StringRef relative_path = llvm::sys::path::relative_path(
+      llvm::StringRef(cc_file.data(), cc_file.size()));
+  llvm::SmallString<256> result(
+      llvm::StringRef(rs_out_dir.data(), rs_out_dir.size()));
+  llvm::sys::path::append(result, relative_path);
+  llvm::sys::path::replace_extension(result, "rs");
+  return std::string(result);
+}
+
+namespace {
+
+// Creates `FrontendAction`s that write to the same invocation.
+class FrontendActionFactory : public clang::tooling::FrontendActionFactory {
+ public:
+  explicit FrontendActionFactory(Converter::Invocation& invocation)
+      : invocation_(invocation) {}
+
+  std::unique_ptr<clang::FrontendAction> create() override {
+    return std::make_unique<FrontendAction>(invocation_);
+  }
+
+ private:
+  Converter::Invocation& invocation_;
+};
+
+// Converts `cc_file` and streams the Rust code to its output file.
+absl::Status ConvertFile(
+    const clang::tooling::CompilationDatabase& compilations,
+    const std::string& cc_file, absl::string_view rs_out_dir,
+    ConversionCache* cache) {
+  std::string rs_path = RsOutputPath(cc_file, rs_out_dir);
+  if (std::error_code error = llvm::sys::fs::create_directories(
+          llvm::sys::path::parent_path(rs_path))) {
+    return absl::InternalError(
+        absl::StrCat("Could not create directory for ", rs_path, ": ",
+                     error.message()));
+  }
+  bool success;
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream rs_out(rs_path, error);
+    if (error) {
+      return absl::InternalError(
+          absl::StrCat("Could not open ", rs_path, ": ", error.message()));
+    }
+    Converter::Invocation invocation(rs_out);
+    invocation.cache_ = cache;
+    clang::tooling::ClangTool tool(compilations, {cc_file});
+    tool.appendArgumentsAdjuster(clang::tooling::getInsertArgumentAdjuster(
+        // Parse non-doc comments that are used as documention
+        "-fparse-all-comments", clang::tooling::ArgumentInsertPosition::BEGIN));
+    FrontendActionFactory factory(invocation);
+    success = tool.run(&factory) == 0;
+  }
+  if (!success) {
+    // Don't leave partial output behind.
+    llvm::sys::fs::remove(rs_path);
+    return absl::InvalidArgumentError(
+        absl::StrCat("Could not compile ", cc_file));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status RsFromCcFiles(
+    const clang::tooling::CompilationDatabase& compilations,
+    absl::Span<const std::string> cc_files, absl::string_view rs_out_dir,
+    unsigned num_threads, ConversionCache* cache) {
+  absl::Mutex mutex;
+  std::vector<std::string> errors;
+  {
+    llvm::DefaultThreadPool pool(llvm::hardware_concurrency(num_threads));
+    for (const std::string& cc_file : cc_files) {
+      pool.async([&, cc_file] {
+        absl::Status status =
+            ConvertFile(compilations, cc_file, rs_out_dir, cache);
+        if (!status.ok()) {
+          absl::MutexLock lock(&mutex);
+          errors.push_back(std::string(status.message()));
+        }
+      });
+    }
+    pool.wait();
+  }
+  if (!errors.empty()) {
+    std::sort(errors.begin(), errors.end());
+    return absl::InvalidArgumentError(absl::StrJoin(errors, "\n"));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace crubit_rs_from_cc
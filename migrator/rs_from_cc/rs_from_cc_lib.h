@@ -8,9 +8,12 @@
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
+#include "clang/Tooling/CompilationDatabase.h"
 
 namespace crubit_rs_from_cc {
 
@@ -21,11 +24,33 @@ namespace crubit_rs_from_cc {
 // * `cc_file_name`: name of the C++ file we're converting. Can be omitted for
 //   tests.
 // * `args`: additional command line arguments for Clang (if any)
+// * `cache`: if set, reuses (and records) the Rust code of top-level
+//   declarations that are unchanged since a previous conversion.
 //
 absl::StatusOr<std::string> RsFromCc(
     absl::string_view cc_file_content,
     absl::string_view cc_file_name = "testing/file_name.cc",
-    absl::Span<const absl::string_view> args = {});
+    absl::Span<const absl::string_view> args = {},
+    ConversionCache* cache = nullptr);
+
+// Converts each of the C++ source files `cc_files` into Rust, compiling them
+// with their commands from `compilations`.
+//
+// The Rust code for a file `dir/file.cc` is written to `rs_out_dir/dir/file.rs`
+// (for absolute paths, without the root directory). Files are converted
+// concurrently on up to `num_threads` threads, each with its own ASTContext.
+// Returns an error naming the files that could not be converted; the Rust
+// files for the other files are still written. If `cache` is set, it is shared
+// by all threads, as for `RsFromCc()`.
+absl::Status RsFromCcFiles(
+    const clang::tooling::CompilationDatabase& compilations,
+    absl::Span<const std::string> cc_files, absl::string_view rs_out_dir,
+    unsigned num_threads, ConversionCache* cache = nullptr);
+
+// Returns the path that `RsFromCcFiles()` writes the Rust code for `cc_file`
+// to.
+std::string RsOutputPath(absl::string_view cc_file,
+                         absl::string_view rs_out_dir);
 
 }  // namespace crubit_rs_from_cc
 
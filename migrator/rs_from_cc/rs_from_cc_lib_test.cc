@@ -4,18 +4,27 @@
 
 #include "migrator/rs_from_cc/rs_from_cc_lib.h"
 
+#include <memory>
+#include <string>
 #include <variant>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "common/file_io.h"
 #include "common/status_test_matchers.h"
+#include "migrator/rs_from_cc/conversion_cache.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 
 namespace crubit_rs_from_cc {
 namespace {
 
+using crubit::IsOkAndHolds;
 using crubit::StatusIs;
 using ::testing::Eq;
 using ::testing::IsEmpty;
@@ -50,5 +59,69 @@ TEST(RsFromCcTest, FunctionDeclaration) {
 )end_of_string"));
 }
 
+TEST(RsFromCcTest, OutputPath) {
+  EXPECT_EQ(RsOutputPath("dir/file.cc", "out"), "out/dir/file.rs");
+  EXPECT_EQ(RsOutputPath("/abs/dir/file.h", "out"), "out/abs/dir/file.rs");
+}
+
+TEST(RsFromCcTest, ConvertFiles) {
+  llvm::SmallString<256> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("rs_from_cc_test", dir));
+  std::string a = (dir + "/a.cc").str();
+  std::string b = (dir + "/b.cc").str();
+  std::string rs_out_dir = (dir + "/out").str();
+  ASSERT_OK(crubit::SetFileContents(a, "void a() {}"));
+  ASSERT_OK(crubit::SetFileContents(b, "void b() {}"));
+  clang::tooling::FixedCompilationDatabase compilations(
+      dir.str(), std::vector<std::string>{"-std=c++17"});
+
+  ASSERT_OK(RsFromCcFiles(compilations, {a, b}, rs_out_dir, 2));
+
+  ASSERT_OK_AND_ASSIGN(std::string a_rs,
+                       crubit::GetFileContents(RsOutputPath(a, rs_out_dir)));
+  EXPECT_THAT(a_rs, testing::HasSubstr("FunctionDecl"));
+  EXPECT_THAT(a_rs, testing::HasSubstr(" a 'void ()'"));
+  ASSERT_OK_AND_ASSIGN(std::string b_rs,
+                       crubit::GetFileContents(RsOutputPath(b, rs_out_dir)));
+  EXPECT_THAT(b_rs, testing::HasSubstr(" b 'void ()'"));
+
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(RsFromCcTest, Cache) {
+  constexpr absl::string_view kCode = "struct S {};\nvoid f(S) {}\nvoid g() {}";
+  ConversionCache cache;
+  ASSERT_OK_AND_ASSIGN(std::string rs_code,
+                       RsFromCc(kCode, "testing/file_name.cc", {}, &cache));
+  EXPECT_EQ(cache.hits(), 0);
+  EXPECT_EQ(cache.size(), 3);
+
+  ASSERT_OK_AND_ASSIGN(ConversionCache parsed,
+                       ConversionCache::Parse(cache.Serialize()));
+  EXPECT_THAT(RsFromCc(kCode, "testing/file_name.cc", {}, &parsed),
+              IsOkAndHolds(Eq(rs_code)));
+  EXPECT_EQ(parsed.hits(), 3);
+
+  // Changing `S` invalidates `S` and `f`, which uses it, but not `g`.
+  ASSERT_OK_AND_ASSIGN(
+      std::string changed_rs_code,
+      RsFromCc("struct S { int i; };\nvoid f(S) {}\nvoid g() {}",
+               "testing/file_name.cc", {}, &parsed));
+  EXPECT_EQ(parsed.hits(), 4);
+  EXPECT_THAT(changed_rs_code, testing::HasSubstr("FieldDecl"));
+  EXPECT_THAT(RsFromCc("struct S { int i; };\nvoid f(S) {}\nvoid g() {}"),
+              IsOkAndHolds(Eq(changed_rs_code)));
+}
+
+TEST(RsFromCcTest, CacheIgnoresOtherVersions) {
+  ASSERT_OK_AND_ASSIGN(ConversionCache cache,
+                       ConversionCache::Parse("some other format\nkey\t1\nx"));
+  EXPECT_EQ(cache.size(), 0);
+  // The entry claims to be longer than the rest of the text.
+  EXPECT_THAT(
+      ConversionCache::Parse(ConversionCache().Serialize() + "key\t9\n"),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace crubit_rs_from_cc
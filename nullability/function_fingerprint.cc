@@ -0,0 +1,139 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/function_fingerprint.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "nullability/type_nullability.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/ODRHash.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/MD5.h"
+
+namespace clang::tidy::nullability {
+namespace {
+
+// Collects the declarations that a function definition references or declares,
+// in traversal order and without duplicates.
+struct ReferencedDeclCollector
+    : public RecursiveASTVisitor<ReferencedDeclCollector> {
+  bool shouldVisitImplicitCode() const { return true; }
+
+  bool VisitDeclRefExpr(DeclRefExpr *E) {
+    add(E->getDecl());
+    return true;
+  }
+  bool VisitMemberExpr(MemberExpr *E) {
+    add(E->getMemberDecl());
+    return true;
+  }
+  bool VisitCallExpr(CallExpr *E) {
+    if (const FunctionDecl *Callee = E->getDirectCallee()) add(Callee);
+    return true;
+  }
+  bool VisitCXXConstructExpr(CXXConstructExpr *E) {
+    add(E->getConstructor());
+    return true;
+  }
+  bool VisitValueDecl(ValueDecl *D) {
+    add(D);
+    return true;
+  }
+  bool TraverseConstructorInitializer(CXXCtorInitializer *Init) {
+    if (const FieldDecl *Field = Init->getMember()) add(Field);
+    return RecursiveASTVisitor::TraverseConstructorInitializer(Init);
+  }
+
+  void add(absl::Nonnull<const NamedDecl *> D) {
+    if (Seen.insert(D).second) Decls.push_back(D);
+  }
+
+  llvm::DenseSet<const NamedDecl *> Seen;
+  std::vector<absl::Nonnull<const NamedDecl *>> Decls;
+};
+
+// Hashes the size before the contents, so that consecutive strings can't run
+// into each other.
+void hashString(llvm::MD5 &Hash, llvm::StringRef S) {
+  Hash.update(llvm::bit_cast<std::array<uint8_t, 8>>(uint64_t{S.size()}));
+  Hash.update(S);
+}
+
+void hashDecl(llvm::MD5 &Hash, const NamedDecl &D,
+              const TypeNullabilityDefaults &Defaults) {
+  hashString(Hash, D.getQualifiedNameAsString());
+  if (const auto *VD = dyn_cast<ValueDecl>(&D))
+    hashString(Hash,
+               printWithNullability(VD->getType(),
+                                    getTypeNullability(*VD, Defaults),
+                                    D.getASTContext()));
+}
+
+}  // namespace
+
+std::optional<FunctionFingerprint> fingerprintDefinition(
+    const FunctionDecl &Func, const TypeNullabilityDefaults &Defaults) {
+  if (!Func.doesThisDeclarationHaveABody() || Func.isTemplated() ||
+      Func.isTemplateInstantiation() || Func.isImplicit())
+    return std::nullopt;
+
+  ASTContext &Ctx = Func.getASTContext();
+  const SourceManager &SM = Ctx.getSourceManager();
+  SourceRange Range = Func.getSourceRange();
+  if (!Range.getBegin().isFileID() || !Range.getEnd().isFileID() ||
+      SM.getFileID(Range.getBegin()) != SM.getFileID(Range.getEnd()))
+    return std::nullopt;
+  bool Invalid = false;
+  llvm::StringRef Text =
+      Lexer::getSourceText(CharSourceRange::getTokenRange(Range), SM,
+                           Ctx.getLangOpts(), &Invalid);
+  if (Invalid) return std::nullopt;
+
+  // MD5 is an arbitrary choice of hash function.
+  llvm::MD5 Hash;
+  hashString(Hash, Text);
+
+  // The source text doesn't cover macro definitions, and types declared
+  // elsewhere. `ODRHash` does, as it hashes the AST.
+  ODRHash ODR;
+  ODR.AddFunctionDecl(&Func);
+  Hash.update(llvm::bit_cast<std::array<uint8_t, 4>>(ODR.CalculateHash()));
+
+  // Unannotated pointer types in the definition get the default nullability of
+  // the file.
+  Hash.update(std::array<uint8_t, 1>{
+      static_cast<uint8_t>(Defaults.get(SM.getFileID(Range.getBegin())))});
+
+  // Annotations that are inconsistent with the canonical declaration are
+  // diagnosed.
+  if (const auto *Canonical = Func.getCanonicalDecl(); Canonical != &Func)
+    hashDecl(Hash, *Canonical, Defaults);
+
+  ReferencedDeclCollector Collector;
+  // `RecursiveASTVisitor` requires a non-const input.
+  Collector.TraverseDecl(const_cast<FunctionDecl *>(&Func));
+  for (const NamedDecl *D : Collector.Decls) hashDecl(Hash, *D, Defaults);
+
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  return FunctionFingerprint{Result.low(), std::move(Collector.Decls)};
+}
+
+}  // namespace clang::tidy::nullability
@@ -0,0 +1,51 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Production of fingerprints identifying function definitions together with
+// everything that their nullability diagnostics depend on, so that diagnostics
+// can be reused across runs in which a function is unchanged.
+
+#ifndef CRUBIT_NULLABILITY_FUNCTION_FINGERPRINT_H_
+#define CRUBIT_NULLABILITY_FUNCTION_FINGERPRINT_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "nullability/type_nullability.h"
+#include "clang/AST/Decl.h"
+
+namespace clang::tidy::nullability {
+
+/// A lossy representation of a function definition, for the purposes of
+/// nullability diagnosis. Two definitions have the same fingerprint (barring
+/// collisions) if they have:
+/// - the same source text, and the same AST (which also covers macros used in
+///   the definition),
+/// - the same nullability in the types of the function, its parameters and
+///   local variables, and of the declarations that it references (e.g.
+///   callees, fields and globals), including nullability from pragmas.
+///
+/// Unlike `SlotFingerprint`, this does not depend on the location of the
+/// definition within its file, so that a function that is merely moved (e.g.
+/// because a function above it changed) keeps its fingerprint.
+struct FunctionFingerprint {
+  uint64_t Hash;
+  /// The declarations referenced in the definition, in traversal order. These
+  /// correspond to each other for definitions with the same `Hash`, which lets
+  /// data about one definition refer to the declarations used by the other.
+  std::vector<absl::Nonnull<const NamedDecl *>> ReferencedDecls;
+};
+
+/// Returns the fingerprint of the definition `Func`, or nothing if the
+/// definition cannot be fingerprinted, i.e. if it is not a plain function
+/// definition spelled out in a single file (e.g. it is templated, implicit, or
+/// expanded from a macro).
+std::optional<FunctionFingerprint> fingerprintDefinition(
+    const FunctionDecl &Func, const TypeNullabilityDefaults &Defaults);
+
+}  // namespace clang::tidy::nullability
+
+#endif  // CRUBIT_NULLABILITY_FUNCTION_FINGERPRINT_H_
@@ -0,0 +1,126 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/function_fingerprint.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "nullability/pragma.h"
+#include "nullability/type_nullability.h"
+#include "clang/AST/Decl.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Testing/TestAST.h"
+#include "llvm/ADT/StringRef.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googlemock/include/gmock/gmock.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
+
+namespace clang::tidy::nullability {
+namespace {
+using ::clang::ast_matchers::functionDecl;
+using ::clang::ast_matchers::hasName;
+using ::clang::ast_matchers::isDefinition;
+using ::clang::ast_matchers::match;
+using ::clang::ast_matchers::selectFirst;
+using ::testing::Contains;
+using ::testing::Pointee;
+using ::testing::Property;
+
+// Returns the fingerprint of the definition of `target` in `Code`, which may
+// include `header.h` with the contents `Header`.
+std::optional<FunctionFingerprint> fingerprintTarget(llvm::StringRef Code,
+                                                     llvm::StringRef Header) {
+  TestInputs Inputs(Code);
+  Inputs.ExtraFiles = {{"header.h", Header.str()}};
+  TestAST AST(Inputs);
+  const auto *Target = selectFirst<FunctionDecl>(
+      "f", match(functionDecl(hasName("target"), isDefinition()).bind("f"),
+                 AST.context()));
+  NullabilityPragmas NoPragmas;
+  return fingerprintDefinition(
+      *Target, TypeNullabilityDefaults(AST.context(), NoPragmas));
+}
+
+std::optional<uint64_t> hashTarget(llvm::StringRef Code,
+                                   llvm::StringRef Header = "") {
+  std::optional<FunctionFingerprint> FP = fingerprintTarget(Code, Header);
+  if (!FP) return std::nullopt;
+  return FP->Hash;
+}
+
+constexpr llvm::StringRef TargetCode = R"cc(
+  int target(int *_Nullable p) {
+    if (p == nullptr) return 0;
+    return *p;
+  }
+)cc";
+
+TEST(FunctionFingerprintTest, IgnoresLocation) {
+  EXPECT_EQ(hashTarget(TargetCode),
+            hashTarget(("void other();\n" + TargetCode).str()));
+}
+
+TEST(FunctionFingerprintTest, DependsOnBody) {
+  std::optional<uint64_t> Hash = hashTarget(TargetCode);
+  ASSERT_TRUE(Hash);
+  EXPECT_NE(Hash, hashTarget(R"cc(
+    int target(int *_Nullable p) {
+      if (p == nullptr) return 1;
+      return *p;
+    }
+  )cc"));
+  // Whitespace matters, as diagnostics are located relative to the function.
+  EXPECT_NE(Hash, hashTarget(R"cc(
+    int target(int *_Nullable p) {
+      if (p == nullptr)
+        return 0;
+      return *p;
+    }
+  )cc"));
+}
+
+TEST(FunctionFingerprintTest, DependsOnAnnotationsOfCallees) {
+  constexpr llvm::StringRef Code = R"cc(
+#include "header.h"
+    void target(int *p) { callee(p); }
+  )cc";
+  std::optional<uint64_t> Hash = hashTarget(Code, "void callee(int *);");
+  ASSERT_TRUE(Hash);
+  EXPECT_EQ(Hash, hashTarget(Code, "void callee(int *); "));
+  EXPECT_NE(Hash, hashTarget(Code, "void callee(int *_Nonnull);"));
+}
+
+TEST(FunctionFingerprintTest, DependsOnMacros) {
+  constexpr llvm::StringRef Code = R"cc(
+#include "header.h"
+    int *target() { return NULL_OR_ONE; }
+  )cc";
+  EXPECT_NE(hashTarget(Code, "#define NULL_OR_ONE nullptr"),
+            hashTarget(Code, "#define NULL_OR_ONE (int *)1"));
+}
+
+TEST(FunctionFingerprintTest, ReferencedDecls) {
+  std::optional<FunctionFingerprint> FP = fingerprintTarget(
+      R"cc(
+#include "header.h"
+        void target(int *p) { callee(p); }
+      )cc",
+      "void callee(int *);");
+  ASSERT_TRUE(FP);
+  EXPECT_THAT(FP->ReferencedDecls,
+              Contains(Pointee(Property(&NamedDecl::getName, "callee"))));
+}
+
+TEST(FunctionFingerprintTest, NotForTemplates) {
+  EXPECT_EQ(hashTarget(R"cc(
+              template <typename T>
+              void target(T *p) {}
+            )cc"),
+            std::nullopt);
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
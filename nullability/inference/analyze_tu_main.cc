@@ -0,0 +1,299 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// analyze_tu_main runs several analyses on each translation unit, parsing it
+// only once: the nullability diagnosis (as in the clang-tidy check), the
+// nullability inference (as in infer_tu_main), and lifetime analysis. Each
+// analysis only runs if its output is requested:
+//
+//   -diagnostics-out=FILE  nullability diagnostics, one per line
+//   -inference-out=FILE    the non-trivial Inference protos
+//   -lifetimes-out=FILE    the analyzed lifetimes of each function
+//
+// FILE may be "-" for stdout. The results for all TUs are written to the same
+// files, each preceded by a "TU: <main file>" line.
+//
+// If inference runs, the nullability macro replacements are applied to the TU
+// (see replace_macros.h), which the other analyses see as well.
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "lifetime_analysis/analyze.h"
+#include "lifetime_annotations/function_lifetimes.h"
+#include "lifetime_annotations/lifetime_annotations.h"
+#include "nullability/inference/ctn_replacement_macros.h"
+#include "nullability/inference/infer_tu.h"
+#include "nullability/inference/inference.proto.h"
+#include "nullability/inference/replace_macros.h"
+#include "nullability/pointer_nullability_diagnosis.h"
+#include "nullability/pragma.h"
+#include "nullability/type_nullability.h"
+#include "clang/AST/ASTConsumer.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CommonOptionsParser.h"
+#include "clang/Tooling/StandaloneExecution.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using ::clang::tidy::nullability::ReplacementMacrosHeaderFileName;
+
+llvm::cl::OptionCategory Opts("analyze_tu_main options");
+llvm::cl::opt<std::string> DiagnosticsOut{
+    "diagnostics-out",
+    llvm::cl::desc("Run the nullability diagnosis, and write its findings to "
+                   "this file"),
+    llvm::cl::cat(Opts),
+};
+llvm::cl::opt<std::string> InferenceOut{
+    "inference-out",
+    llvm::cl::desc("Run nullability inference, and write the non-trivial "
+                   "Inference protos to this file"),
+    llvm::cl::cat(Opts),
+};
+llvm::cl::opt<std::string> LifetimesOut{
+    "lifetimes-out",
+    llvm::cl::desc("Run lifetime analysis, and write the lifetimes of the "
+                   "analyzed functions to this file"),
+    llvm::cl::cat(Opts),
+};
+llvm::cl::opt<unsigned> Iterations{
+    "iterations",
+    llvm::cl::desc("Number of inference iterations"),
+    llvm::cl::init(1),
+    llvm::cl::cat(Opts),
+};
+llvm::cl::opt<bool> PrintTimes{
+    "times",
+    llvm::cl::desc("Print the time spent in each analysis"),
+    llvm::cl::init(false),
+    llvm::cl::cat(Opts),
+};
+
+namespace clang::tidy::nullability {
+namespace {
+
+// The output file of one analysis, which is shared by all TUs.
+class Sink {
+ public:
+  explicit Sink(llvm::StringRef Path) {
+    if (Path.empty()) return;
+    std::error_code EC;
+    OS.emplace(Path, EC, llvm::sys::fs::OF_Text);
+    QCHECK(!EC) << Path.str() << ": " << EC.message();
+  }
+
+  bool enabled() const { return OS.has_value(); }
+  llvm::raw_ostream &os() { return *OS; }
+
+ private:
+  std::optional<llvm::raw_fd_ostream> OS;
+};
+
+Sink *DiagnosticsSink = nullptr;
+Sink *InferenceSink = nullptr;
+Sink *LifetimesSink = nullptr;
+
+llvm::StringRef errorCodeName(PointerNullabilityDiagnostic::ErrorCode Code) {
+  switch (Code) {
+    case PointerNullabilityDiagnostic::ErrorCode::ExpectedNonnull:
+      return "ExpectedNonnull";
+    case PointerNullabilityDiagnostic::ErrorCode::InconsistentAnnotations:
+      return "InconsistentAnnotations";
+    case PointerNullabilityDiagnostic::ErrorCode::
+        AccessingMovedFromNonnullPointer:
+      return "AccessingMovedFromNonnullPointer";
+    case PointerNullabilityDiagnostic::ErrorCode::Untracked:
+      return "Untracked";
+    case PointerNullabilityDiagnostic::ErrorCode::AssertFailed:
+      return "AssertFailed";
+  }
+  return "Unknown";
+}
+
+void writeDiagnostics(ASTContext &Ctx, const NullabilityPragmas &Pragmas,
+                      llvm::raw_ostream &OS) {
+  const SourceManager &SM = Ctx.getSourceManager();
+  for (DeclDiagnostics &D : diagnosePointerNullabilityInTU(Ctx, Pragmas)) {
+    if (!D.Diagnostics) {
+      OS << D.Decl->getQualifiedNameAsString()
+         << ": error: " << llvm::toString(D.Diagnostics.takeError()) << "\n";
+      continue;
+    }
+    for (const PointerNullabilityDiagnostic &Diag : *D.Diagnostics)
+      OS << Diag.Range.getBegin().printToString(SM) << ": "
+         << errorCodeName(Diag.Code) << "\n";
+  }
+}
+
+void writeInferences(ASTContext &Ctx, const NullabilityPragmas &Pragmas,
+                     llvm::raw_ostream &OS) {
+  for (const auto &[USR, InferencesBySlot] :
+       inferTU(Ctx, Pragmas, Iterations)) {
+    for (const auto &[Slot, SlotInference] : InferencesBySlot) {
+      if (SlotInference.trivial()) continue;
+      OS << "USR: " << USR << "\n";
+      OS << "Slot: " << Slot << "\n";
+      OS << "Inference:\n" << absl::StrCat(SlotInference) << "\n";
+    }
+  }
+}
+
+void writeLifetimes(
+    ASTContext &Ctx,
+    const lifetimes::LifetimeAnnotationContext &LifetimeContext,
+    llvm::raw_ostream &OS) {
+  for (const auto &[Func, LifetimesOrError] : lifetimes::AnalyzeTranslationUnit(
+           Ctx.getTranslationUnitDecl(), LifetimeContext)) {
+    OS << Func->getQualifiedNameAsString() << ": ";
+    if (const auto *Error =
+            std::get_if<lifetimes::FunctionAnalysisError>(&LifetimesOrError))
+      OS << "ERROR: " << Error->message << "\n";
+    else
+      OS << std::get<lifetimes::FunctionLifetimes>(LifetimesOrError)
+                .DebugString()
+         << "\n";
+  }
+}
+
+// Runs `Analysis` and prints how long it took, with -times.
+template <typename Fn>
+void timed(llvm::StringRef Name, Fn Analysis) {
+  auto Start = std::chrono::steady_clock::now();
+  Analysis();
+  if (PrintTimes)
+    llvm::errs() << Name << ": "
+                 << llvm::format("%0.3f",
+                                 std::chrono::duration<double>(
+                                     std::chrono::steady_clock::now() - Start)
+                                     .count())
+                 << "s\n";
+}
+
+class Action : public SyntaxOnlyAction {
+  NullabilityPragmas Pragmas;
+  std::shared_ptr<lifetimes::LifetimeAnnotationContext> LifetimeContext =
+      std::make_shared<lifetimes::LifetimeAnnotationContext>();
+
+  absl::Nonnull<std::unique_ptr<ASTConsumer>> CreateASTConsumer(
+      CompilerInstance &, llvm::StringRef File) override {
+    class Consumer : public ASTConsumer {
+     public:
+      Consumer(Action &A, llvm::StringRef File) : A(A), File(File) {}
+
+     private:
+      void HandleTranslationUnit(ASTContext &Ctx) override {
+        if (Ctx.getDiagnostics().hasErrorOccurred()) {
+          llvm::errs() << File << ": an error has occurred; not analyzing.\n";
+          return;
+        }
+        if (DiagnosticsSink->enabled()) {
+          DiagnosticsSink->os() << "TU: " << File << "\n";
+          timed("Diagnosis", [&] {
+            writeDiagnostics(Ctx, A.Pragmas, DiagnosticsSink->os());
+          });
+        }
+        if (InferenceSink->enabled()) {
+          InferenceSink->os() << "TU: " << File << "\n";
+          timed("Inference", [&] {
+            writeInferences(Ctx, A.Pragmas, InferenceSink->os());
+          });
+        }
+        if (LifetimesSink->enabled()) {
+          LifetimesSink->os() << "TU: " << File << "\n";
+          timed("Lifetimes", [&] {
+            writeLifetimes(Ctx, *A.LifetimeContext, LifetimesSink->os());
+          });
+        }
+      }
+
+      Action &A;
+      std::string File;
+    };
+    return std::make_unique<Consumer>(*this, File);
+  }
+
+  bool BeginSourceFileAction(CompilerInstance &CI) override {
+    if (!SyntaxOnlyAction::BeginSourceFileAction(CI) ||
+        !CI.getLangOpts().CPlusPlus)
+      return false;
+
+    registerPragmaHandler(CI.getPreprocessor(), Pragmas);
+    if (InferenceSink->enabled())
+      CI.getPreprocessor().addPPCallbacks(
+          std::make_unique<ReplaceMacrosCallbacks>(CI.getPreprocessor()));
+    if (LifetimesSink->enabled())
+      lifetimes::AddLifetimeAnnotationHandlers(CI.getPreprocessor(),
+                                               LifetimeContext);
+    return true;
+  }
+};
+
+// The arguments that TUs are compiled with, in addition to their own.
+tooling::ArgumentsAdjuster extraArgs() {
+  // Disable warnings, which aren't what this tool is for.
+  std::vector<std::string> Args = {"-w"};
+  if (InferenceSink->enabled()) {
+    Args.push_back("-include");
+    Args.push_back(std::string(ReplacementMacrosHeaderFileName));
+  }
+  // TODO: b/357760487 -- use the flag until the issue is resolved or we find a
+  // workaround.
+  Args.insert(Args.end(), {"-Xclang",
+                           "-fretain-subst-template-type-parm-type-ast-nodes"});
+  return tooling::getInsertArgumentAdjuster(
+      Args, tooling::ArgumentInsertPosition::BEGIN);
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
+
+int main(int argc, absl::Nonnull<const char **> argv) {
+  using namespace clang::tooling;
+  namespace nullability = clang::tidy::nullability;
+  auto Options = CommonOptionsParser::create(argc, argv, Opts);
+  QCHECK(Options) << toString(Options.takeError());
+
+  nullability::Sink Diagnostics(DiagnosticsOut), Inference(InferenceOut),
+      Lifetimes(LifetimesOut);
+  QCHECK(Diagnostics.enabled() || Inference.enabled() || Lifetimes.enabled())
+      << "Nothing to do: pass at least one of -diagnostics-out, "
+         "-inference-out and -lifetimes-out";
+  nullability::DiagnosticsSink = &Diagnostics;
+  nullability::InferenceSink = &Inference;
+  nullability::LifetimesSink = &Lifetimes;
+
+  nullability::enableSmartPointers(true);
+
+  StandaloneToolExecutor Exec(Options->getCompilations(),
+                              Options->getSourcePathList());
+  if (Inference.enabled()) {
+    CHECK_EQ(ctn_replacement_macros_size(), 1);
+    Exec.mapVirtualFile(ReplacementMacrosHeaderFileName,
+                        ctn_replacement_macros_create()[0].data);
+  }
+  auto Err = Exec.execute(newFrontendActionFactory<nullability::Action>(),
+                          nullability::extraArgs());
+  QCHECK(!Err) << toString(std::move(Err));
+}
@@ -11,6 +11,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -24,8 +25,10 @@
 #include "nullability/inference/slot_fingerprint.h"
 #include "nullability/loc_filter.h"
 #include "nullability/macro_arg_capture.h"
+#include "nullability/memoizing_solver.h"
 #include "nullability/pointer_nullability.h"
 #include "nullability/pointer_nullability_analysis.h"
+#include "nullability/pointer_nullability_diagnosis.h"
 #include "nullability/pointer_nullability_lattice.h"
 #include "nullability/pragma.h"
 #include "nullability/type_nullability.h"
@@ -62,6 +65,7 @@
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/Specifiers.h"
 #include "clang/Index/USRGeneration.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/FunctionExtras.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
@@ -91,6 +95,14 @@ std::string_view getOrGenerateUSR(USRCache &Cache, const Decl &Decl) {
   return It->second;
 }
 
+SlotFingerprint getOrComputeFingerprint(USRCache &Cache, const Decl &D,
+                                        Slot S) {
+  auto [It, Inserted] = Cache.Fingerprints.try_emplace(
+      std::make_pair(&D, static_cast<unsigned>(S)));
+  if (Inserted) It->second = fingerprint(getOrGenerateUSR(Cache, D), S);
+  return It->second;
+}
+
 static llvm::DenseSet<absl::Nonnull<const CXXMethodDecl *>> getOverridden(
     absl::Nonnull<const CXXMethodDecl *> Derived) {
   llvm::DenseSet<absl::Nonnull<const CXXMethodDecl *>> Overridden;
@@ -229,13 +241,16 @@ llvm::unique_function<EvidenceEmitter> evidenceEmitter(
 
     void operator()(const Decl &Target, Slot S, Evidence::Kind Kind,
                     SourceLocation Loc) const {
-      CHECK(isInferenceTarget(Target))
+      CHECK(USRCache.Inferable.isInferenceTarget(Target))
           << "Evidence emitted for a Target which is not an inference target: "
           << (dyn_cast<NamedDecl>(&Target)
                   ? dyn_cast<NamedDecl>(&Target)->getQualifiedNameAsString()
                   : "not a named decl");
 
-      Evidence E;
+      // Reuse one Evidence for all events: clearing it keeps the buffers of
+      // its string fields, so emitting usually doesn't allocate.
+      Evidence &E = Scratch;
+      E.Clear();
       E.set_slot(S);
       E.set_kind(Kind);
 
@@ -273,6 +288,8 @@ llvm::unique_function<EvidenceEmitter> evidenceEmitter(
     // Must outlive the EvidenceEmitterImpl.
     nullability::USRCache &USRCache;
     const VirtualMethodOverridesMap OverridesMap;
+    // Only valid during a call to `Emit`, which must copy what it keeps.
+    mutable Evidence Scratch;
   };
   return EvidenceEmitterImpl(std::move(Emit), USRCache, Ctx,
                              std::move(OverridesMap));
@@ -334,13 +351,15 @@ static const Formula &getInferableSlotsAsInferredOrUnknownConstraint(
     const PreviousInferences &PreviousInferences, dataflow::Arena &A) {
   const Formula *Constraint = &A.makeLiteral(true);
   for (auto &IS : InferableSlots) {
-    std::string_view USR = getOrGenerateUSR(USRCache, IS.getInferenceTarget());
-    SlotFingerprint Fingerprint = fingerprint(USR, IS.getTargetSlot());
+    SlotFingerprint Fingerprint = getOrComputeFingerprint(
+        USRCache, IS.getInferenceTarget(), IS.getTargetSlot());
+    if (PreviousInferences.Reads != nullptr)
+      PreviousInferences.Reads->insert(Fingerprint);
     auto Nullability = IS.getSymbolicNullability();
-    const Formula &Nullable = PreviousInferences.Nullable.contains(Fingerprint)
+    const Formula &Nullable = PreviousInferences.isNullable(Fingerprint)
                                   ? Nullability.isNullable(A)
                                   : A.makeNot(Nullability.isNullable(A));
-    const Formula &Nonnull = PreviousInferences.Nonnull.contains(Fingerprint)
+    const Formula &Nonnull = PreviousInferences.isNonnull(Fingerprint)
                                  ? Nullability.isNonnull(A)
                                  : A.makeNot(Nullability.isNonnull(A));
     Constraint = &A.makeAnd(*Constraint, A.makeAnd(Nullable, Nonnull));
@@ -473,11 +492,12 @@ class DefinitionEvidenceCollector {
   static void collect(std::vector<InferableSlot> &InferableSlots,
                       const Formula &InferableSlotsConstraint,
                       llvm::function_ref<EvidenceEmitter> Emit,
-                      const CFGElement &CFGElem,
+                      InferableCache &Inferable, const CFGElement &CFGElem,
                       const PointerNullabilityLattice &Lattice,
                       const Environment &Env, const dataflow::Solver &Solver) {
-    DefinitionEvidenceCollector Collector(
-        InferableSlots, InferableSlotsConstraint, Emit, Lattice, Env, Solver);
+    DefinitionEvidenceCollector Collector(InferableSlots,
+                                          InferableSlotsConstraint, Emit,
+                                          Inferable, Lattice, Env, Solver);
     if (auto CFGStmt = CFGElem.getAs<clang::CFGStmt>()) {
       const Stmt *S = CFGStmt->getStmt();
       if (!S) return;
@@ -497,12 +517,14 @@ class DefinitionEvidenceCollector {
   DefinitionEvidenceCollector(std::vector<InferableSlot> &InferableSlots,
                               const Formula &InferableSlotsConstraint,
                               llvm::function_ref<EvidenceEmitter> Emit,
+                              InferableCache &Inferable,
                               const PointerNullabilityLattice &Lattice,
                               const Environment &Env,
                               const dataflow::Solver &Solver)
       : InferableSlots(InferableSlots),
         InferableSlotsConstraint(InferableSlotsConstraint),
         Emit(Emit),
+        Inferable(Inferable),
         Lattice(Lattice),
         Env(Env),
         Solver(Solver) {}
@@ -644,7 +666,7 @@ class DefinitionEvidenceCollector {
   template <typename CallOrConstructExpr>
   void fromArgsAndParams(const FunctionDecl &CalleeDecl,
                          const CallOrConstructExpr &Expr) {
-    bool CollectEvidenceForCallee = isInferenceTarget(CalleeDecl);
+    bool CollectEvidenceForCallee = Inferable.isInferenceTarget(CalleeDecl);
     bool CollectEvidenceForCaller = !InferableSlots.empty();
 
     for (ParamAndArgIterator<CallOrConstructExpr> Iter(CalleeDecl, Expr); Iter;
@@ -958,7 +980,7 @@ class DefinitionEvidenceCollector {
     // Skip gathering evidence about the current function's return type if
     // the current function is not an inference target or the return type
     // already includes an annotation.
-    if (isInferenceTarget(*CurrentFunc) &&
+    if (Inferable.isInferenceTarget(*CurrentFunc) &&
         !evidenceKindFromDeclaredReturnType(*CurrentFunc, Lattice.defaults())) {
       NullabilityKind ReturnNullability =
           getNullability(ReturnExpr, Env, &InferableSlotsConstraint);
@@ -1269,6 +1291,7 @@ class DefinitionEvidenceCollector {
   const std::vector<InferableSlot> &InferableSlots;
   const Formula &InferableSlotsConstraint;
   llvm::function_ref<EvidenceEmitter> Emit;
+  InferableCache &Inferable;
   const PointerNullabilityLattice &Lattice;
   const Environment &Env;
   const dataflow::Solver &Solver;
@@ -1304,10 +1327,12 @@ static auto getConcreteNullabilityOverrideFromPreviousInferences(
       }
       if (!FingerprintedDecl) return std::nullopt;
       auto Fingerprint =
-          fingerprint(getOrGenerateUSR(USRCache, **FingerprintedDecl), Slot);
-      if (PreviousInferences.Nullable.contains(Fingerprint)) {
+          getOrComputeFingerprint(USRCache, **FingerprintedDecl, Slot);
+      if (PreviousInferences.Reads != nullptr)
+        PreviousInferences.Reads->insert(Fingerprint);
+      if (PreviousInferences.isNullable(Fingerprint)) {
         It->second.emplace(NullabilityKind::Nullable);
-      } else if (PreviousInferences.Nonnull.contains(Fingerprint)) {
+      } else if (PreviousInferences.isNonnull(Fingerprint)) {
         It->second.emplace(NullabilityKind::NonNull);
       } else {
         It->second = std::nullopt;
@@ -1319,20 +1344,26 @@ static auto getConcreteNullabilityOverrideFromPreviousInferences(
 }
 
 template <typename ContainerT>
-static bool hasAnyInferenceTargets(const ContainerT &Decls) {
-  return std::any_of(Decls.begin(), Decls.end(),
-                     [](const Decl *D) { return D && isInferenceTarget(*D); });
+static bool hasAnyInferenceTargets(const ContainerT &Decls,
+                                   InferableCache &Inferable) {
+  return std::any_of(Decls.begin(), Decls.end(), [&](const Decl *D) {
+    return D && Inferable.isInferenceTarget(*D);
+  });
 }
 
-static bool hasAnyInferenceTargets(dataflow::ReferencedDecls &RD) {
-  return hasAnyInferenceTargets(RD.Fields) ||
-         hasAnyInferenceTargets(RD.Globals) ||
-         hasAnyInferenceTargets(RD.Functions);
+static bool hasAnyInferenceTargets(dataflow::ReferencedDecls &RD,
+                                   InferableCache &Inferable) {
+  return hasAnyInferenceTargets(RD.Fields, Inferable) ||
+         hasAnyInferenceTargets(RD.Globals, Inferable) ||
+         hasAnyInferenceTargets(RD.Functions, Inferable);
 }
 
 std::unique_ptr<dataflow::Solver> makeDefaultSolverForInference() {
   constexpr std::int64_t MaxSATIterations = 200'000;
-  return std::make_unique<dataflow::WatchedLiteralsSolver>(MaxSATIterations);
+  // Collecting evidence asks many similar questions about the same flow
+  // conditions, e.g. whether a pointer is null at each of its dereferences.
+  return std::make_unique<MemoizingSolver>(
+      std::make_unique<dataflow::WatchedLiteralsSolver>(MaxSATIterations));
 }
 
 // If D is a constructor definition, collect ASSIGNED_FROM_NULLABLE evidence for
@@ -1414,11 +1445,45 @@ static bool containsInitListExpr(const Expr &E) {
   return Visitor.Found;
 }
 
-llvm::Error collectEvidenceFromDefinition(
+namespace {
+// Forwards evidence to another emitter, but only the first few pieces of each
+// kind of evidence for each slot.
+//
+// A definition often produces the same evidence many times, e.g. by
+// dereferencing a parameter in many places. Inference only depends on which
+// kinds of evidence there are for a slot, and merging only keeps a few sample
+// locations of each, so repeating it is wasted effort downstream.
+class EvidenceSampler {
+ public:
+  explicit EvidenceSampler(llvm::function_ref<EvidenceEmitter> Emit)
+      : Emit(Emit) {}
+
+  void operator()(const Decl &Target, Slot S, Evidence::Kind Kind,
+                  SourceLocation Loc) {
+    if (++Counts[{&Target, static_cast<unsigned>(S),
+                  static_cast<unsigned>(Kind)}] <= MaxPerKind)
+      Emit(Target, S, Kind, Loc);
+  }
+
+ private:
+  static constexpr unsigned MaxPerKind = 3;
+
+  llvm::function_ref<EvidenceEmitter> Emit;
+  // The evidence seen for each target, slot and kind.
+  llvm::DenseMap<std::tuple<const Decl *, unsigned, unsigned>, unsigned>
+      Counts;
+};
+}  // namespace
+
+// Implementation of `collectEvidenceFromDefinition()` and
+// `collectEvidenceAndDiagnoseDefinition()`, which also diagnoses `Definition`
+// if `Diags` is set.
+static llvm::Error collectEvidenceFromDefinitionImpl(
     const Decl &Definition, llvm::function_ref<EvidenceEmitter> Emit,
     USRCache &USRCache, const NullabilityPragmas &Pragmas,
     const PreviousInferences PreviousInferences,
-    const SolverFactory &MakeSolver) {
+    const SolverFactory &MakeSolver,
+    absl::Nullable<llvm::SmallVector<PointerNullabilityDiagnostic> *> Diags) {
   ASTContext &Ctx = Definition.getASTContext();
   dataflow::ReferencedDecls ReferencedDecls;
   Stmt *TargetStmt = nullptr;
@@ -1453,7 +1518,8 @@ llvm::Error collectEvidenceFromDefinition(
         &DeclStmtForVarDecl.emplace(DeclGroupRef(const_cast<VarDecl *>(Var)),
                                     Var->getBeginLoc(), Var->getEndLoc());
     ReferencedDecls = dataflow::getReferencedDecls(*TargetStmt);
-    if (!isInferenceTarget(*Var) && !hasAnyInferenceTargets(ReferencedDecls)) {
+    if (!USRCache.Inferable.isInferenceTarget(*Var) &&
+        !hasAnyInferenceTargets(ReferencedDecls, USRCache.Inferable)) {
       // If this variable is not an inference target and the initializer does
       // not reference any inference targets, we won't be able to collect any
       // useful evidence from the initializer.
@@ -1481,11 +1547,12 @@ llvm::Error collectEvidenceFromDefinition(
 
   TypeNullabilityDefaults Defaults = TypeNullabilityDefaults(Ctx, Pragmas);
 
+  InferableCache &Inferable = USRCache.Inferable;
   std::vector<InferableSlot> InferableSlots;
-  if (TargetAsFunc && isInferenceTarget(*TargetAsFunc)) {
+  if (TargetAsFunc && Inferable.isInferenceTarget(*TargetAsFunc)) {
     auto Parameters = TargetAsFunc->parameters();
     for (auto I = 0; I < Parameters.size(); ++I) {
-      if (hasInferable(Parameters[I]->getType().getNonReferenceType()) &&
+      if (Inferable.hasInferableSlot(*TargetAsFunc, paramSlot(I)) &&
           !evidenceKindFromDeclaredTypeLoc(
               Parameters[I]->getTypeSourceInfo()->getTypeLoc(), Defaults)) {
         InferableSlots.emplace_back(Analysis.assignNullabilityVariable(
@@ -1496,7 +1563,7 @@ llvm::Error collectEvidenceFromDefinition(
   }
 
   for (const FieldDecl *Field : ReferencedDecls.Fields) {
-    if (isInferenceTarget(*Field) &&
+    if (Inferable.isInferenceTarget(*Field) &&
         !evidenceKindFromDeclaredTypeLoc(
             Field->getTypeSourceInfo()->getTypeLoc(), Defaults)) {
       InferableSlots.emplace_back(
@@ -1505,7 +1572,7 @@ llvm::Error collectEvidenceFromDefinition(
     }
   }
   for (const VarDecl *Global : ReferencedDecls.Globals) {
-    if (isInferenceTarget(*Global) &&
+    if (Inferable.isInferenceTarget(*Global) &&
         !evidenceKindFromDeclaredTypeLoc(
             Global->getTypeSourceInfo()->getTypeLoc(), Defaults)) {
       InferableSlots.emplace_back(
@@ -1514,7 +1581,7 @@ llvm::Error collectEvidenceFromDefinition(
     }
   }
   for (const VarDecl *Local : ReferencedDecls.Locals) {
-    if (isInferenceTarget(*Local) &&
+    if (Inferable.isInferenceTarget(*Local) &&
         !evidenceKindFromDeclaredTypeLoc(
             Local->getTypeSourceInfo()->getTypeLoc(), Defaults)) {
       InferableSlots.emplace_back(
@@ -1523,8 +1590,8 @@ llvm::Error collectEvidenceFromDefinition(
     }
   }
   for (const FunctionDecl *Function : ReferencedDecls.Functions) {
-    if (isInferenceTarget(*Function) &&
-        hasInferable(Function->getReturnType()) &&
+    if (Inferable.isInferenceTarget(*Function) &&
+        Inferable.hasInferableSlot(*Function, SLOT_RETURN_TYPE) &&
         !evidenceKindFromDeclaredReturnType(*Function, Defaults)) {
       InferableSlots.emplace_back(
           Analysis.assignNullabilityVariable(Function, AnalysisContext.arena()),
@@ -1542,6 +1609,18 @@ llvm::Error collectEvidenceFromDefinition(
       getConcreteNullabilityOverrideFromPreviousInferences(
           ConcreteNullabilityCache, USRCache, PreviousInferences));
 
+  dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> DiagnosisCallbacks;
+  if (Diags != nullptr) {
+    CHECK(TargetAsFunc);
+    // Without previous inferences, `InferableSlotsConstraint` says that the
+    // inferable slots are unannotated, which is what diagnosis assumes.
+    CHECK(PreviousInferences.empty());
+    DiagnosisCallbacks = beginDiagnosingDefinition(
+        *TargetAsFunc, Pragmas, *Diags,
+        InferableSlots.empty() ? nullptr : &InferableSlotsConstraint);
+  }
+
+  EvidenceSampler Sampled(Emit);
   std::vector<
       std::optional<dataflow::DataflowAnalysisState<PointerNullabilityLattice>>>
       Results;
@@ -1551,10 +1630,13 @@ llvm::Error collectEvidenceFromDefinition(
           const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
               &State) {
         if (Solver->reachedLimit()) return;
+        if (DiagnosisCallbacks.Before)
+          DiagnosisCallbacks.Before(Element, State);
         DefinitionEvidenceCollector::collect(
-            InferableSlots, InferableSlotsConstraint, Emit, Element,
-            State.Lattice, State.Env, *Solver);
+            InferableSlots, InferableSlotsConstraint, Sampled,
+            USRCache.Inferable, Element, State.Lattice, State.Env, *Solver);
       };
+  PostAnalysisCallbacks.After = DiagnosisCallbacks.After;
   if (llvm::Error Error = dataflow::runDataflowAnalysis(*ACFG, Analysis, Env,
                                                         PostAnalysisCallbacks)
                               .moveInto(Results))
@@ -1569,12 +1651,37 @@ llvm::Error collectEvidenceFromDefinition(
   if (std::optional<dataflow::DataflowAnalysisState<PointerNullabilityLattice>>
           &ExitBlockResult = Results[ACFG->getCFG().getExit().getBlockID()]) {
     collectEvidenceFromConstructorExitBlock(Definition, ExitBlockResult->Env,
-                                            Emit);
+                                            Sampled);
   }
 
   return llvm::Error::success();
 }
 
+llvm::Error collectEvidenceFromDefinition(
+    const Decl &Definition, llvm::function_ref<EvidenceEmitter> Emit,
+    USRCache &USRCache, const NullabilityPragmas &Pragmas,
+    const PreviousInferences PreviousInferences,
+    const SolverFactory &MakeSolver) {
+  return collectEvidenceFromDefinitionImpl(Definition, Emit, USRCache, Pragmas,
+                                           PreviousInferences, MakeSolver,
+                                           /*Diags=*/nullptr);
+}
+
+llvm::Expected<llvm::SmallVector<PointerNullabilityDiagnostic>>
+collectEvidenceAndDiagnoseDefinition(const FunctionDecl &Func,
+                                     llvm::function_ref<EvidenceEmitter> Emit,
+                                     USRCache &USRCache,
+                                     const NullabilityPragmas &Pragmas,
+                                     const SolverFactory &MakeSolver) {
+  llvm::SmallVector<PointerNullabilityDiagnostic> Diags;
+  // Like `diagnosePointerNullability()`, don't diagnose templated functions.
+  if (llvm::Error Err = collectEvidenceFromDefinitionImpl(
+          Func, Emit, USRCache, Pragmas, /*PreviousInferences=*/{}, MakeSolver,
+          Func.isTemplated() ? nullptr : &Diags))
+    return std::move(Err);
+  return Diags;
+}
+
 static void collectEvidenceFromDefaultArgument(
     const clang::FunctionDecl &Fn, const clang::ParmVarDecl &ParamDecl,
     Slot ParamSlot, llvm::function_ref<EvidenceEmitter> Emit) {
@@ -1685,7 +1792,7 @@ void collectEvidenceFromTargetDeclaration(
 }
 
 EvidenceSites EvidenceSites::discover(ASTContext &Ctx,
-                                      bool RestrictToMainFileOrHeader) {
+                                      std::unique_ptr<LocFilter> Filter) {
   struct Walker : public EvidenceLocationsWalker<Walker> {
     Walker(std::unique_ptr<LocFilter> LocFilter)
         : LocFilter(std::move(LocFilter)) {}
@@ -1741,9 +1848,15 @@ EvidenceSites EvidenceSites::discover(ASTContext &Ctx,
     }
   };
 
-  Walker W(getLocFilter(Ctx.getSourceManager(), RestrictToMainFileOrHeader));
+  Walker W(std::move(Filter));
   W.TraverseAST(Ctx);
   return std::move(W.Out);
 }
 
+EvidenceSites EvidenceSites::discover(ASTContext &Ctx,
+                                      bool RestrictToMainFileOrHeader) {
+  return discover(
+      Ctx, getLocFilter(Ctx.getSourceManager(), RestrictToMainFileOrHeader));
+}
+
 }  // namespace clang::tidy::nullability
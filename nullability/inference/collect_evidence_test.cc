@@ -12,6 +12,7 @@
 #include "nullability/inference/augmented_test_inputs.h"
 #include "nullability/inference/inference.proto.h"
 #include "nullability/inference/slot_fingerprint.h"
+#include "nullability/pointer_nullability_diagnosis.h"
 #include "nullability/pragma.h"
 #include "nullability/type_nullability.h"
 #include "clang/AST/ASTConsumer.h"
@@ -382,6 +383,26 @@ TEST(CollectEvidenceFromDefinitionTest, UnrelatedCondition) {
                   evidence(paramSlot(2), Evidence::UNCHECKED_DEREFERENCE)));
 }
 
+TEST(CollectEvidenceFromDefinitionTest, RepeatedEvidenceIsSampled) {
+  static constexpr llvm::StringRef Src = R"cc(
+    void target(int *P, int *Q) {
+      *P;
+      *P;
+      *P;
+      *P;
+      *P;
+      *Q;
+    }
+  )cc";
+  // Only a few of the dereferences of P are reported.
+  EXPECT_THAT(collectFromTargetFuncDefinition(Src),
+              UnorderedElementsAre(
+                  evidence(paramSlot(0), Evidence::UNCHECKED_DEREFERENCE),
+                  evidence(paramSlot(0), Evidence::UNCHECKED_DEREFERENCE),
+                  evidence(paramSlot(0), Evidence::UNCHECKED_DEREFERENCE),
+                  evidence(paramSlot(1), Evidence::UNCHECKED_DEREFERENCE)));
+}
+
 TEST(CollectEvidenceFromDefinitionTest, LaterDeref) {
   static constexpr llvm::StringRef Src = R"cc(
     void target(int *P) {
@@ -3630,6 +3651,40 @@ TEST(CollectEvidenceFromDefinitionTest, SolverLimitReached) {
   EXPECT_THAT(Results, SizeIs(1));
 }
 
+TEST(CollectEvidenceAndDiagnoseDefinitionTest, MatchesSeparateRuns) {
+  llvm::StringRef Src = R"cc(
+    Nullable<int *> getNullable();
+    void target(int *P, Nonnull<int *> Q) {
+      *P;
+      *getNullable();
+      Q = nullptr;
+    }
+  )cc";
+  NullabilityPragmas Pragmas;
+  clang::TestAST AST(getAugmentedTestInputs(Src, Pragmas));
+  const auto& Target = *cast<FunctionDecl>(
+      dataflow::test::findValueDecl(AST.context(), "target"));
+  std::vector<Evidence> Results;
+  USRCache UsrCache;
+
+  auto Diagnostics = collectEvidenceAndDiagnoseDefinition(
+      Target,
+      evidenceEmitter([&](const Evidence& E) { Results.push_back(E); },
+                      UsrCache, AST.context()),
+      UsrCache, Pragmas);
+  ASSERT_THAT_EXPECTED(Diagnostics, llvm::Succeeded());
+
+  // `P` is inferable, but not diagnosed, as it is unannotated.
+  EXPECT_THAT(Results, UnorderedElementsAre(evidence(
+                           paramSlot(0), Evidence::UNCHECKED_DEREFERENCE)));
+  EXPECT_THAT(Results,
+              SizeIs(collectFromDefinition(AST, Target, Pragmas).size()));
+  auto ExpectedDiagnostics = diagnosePointerNullability(&Target, Pragmas);
+  ASSERT_THAT_EXPECTED(ExpectedDiagnostics, llvm::Succeeded());
+  EXPECT_THAT(*Diagnostics, SizeIs(2));
+  EXPECT_THAT(*Diagnostics, SizeIs(ExpectedDiagnostics->size()));
+}
+
 TEST(CollectEvidenceFromDeclarationTest, GlobalVariable) {
   llvm::StringLiteral Src = R"cc(
     Nullable<int *> Target;
@@ -40,6 +40,7 @@
 #include "clang/Lex/Lexer.h"
 #include "clang/Lex/Token.h"
 #include "clang/Tooling/Transformer/SourceCode.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Path.h"
@@ -471,8 +472,53 @@ static std::optional<Nullability> getPragmaNullability(
   return std::nullopt;
 }
 
-static EligibleRanges getEligibleRanges(
-    const FunctionDecl &Fun, const TypeNullabilityDefaults &Defaults) {
+namespace {
+// The per-file properties of each range, which are the same for all
+// declarations in a file, and so are computed once per file.
+struct FileInfo {
+  std::string Path;
+  std::optional<Nullability> PragmaNullability;
+};
+
+class FileInfoCache {
+ public:
+  explicit FileInfoCache(const TypeNullabilityDefaults &Defaults)
+      : Defaults(Defaults) {}
+
+  // Returns nullptr if the file has no path.
+  absl::Nullable<const FileInfo *> get(FileID FID, const SourceManager &SM) {
+    auto [It, Inserted] = Infos.try_emplace(FID);
+    if (Inserted) {
+      if (std::optional<std::string> Path = getPath(FID, SM))
+        It->second = FileInfo{std::move(*Path),
+                              getPragmaNullability(FID, Defaults)};
+    }
+    return It->second ? &*It->second : nullptr;
+  }
+
+  const TypeNullabilityDefaults &defaults() const { return Defaults; }
+
+ private:
+  const TypeNullabilityDefaults &Defaults;
+  llvm::DenseMap<FileID, std::optional<FileInfo>> Infos;
+};
+}  // namespace
+
+// Returns the file that the ranges for `D` are in, if any.
+static FileID getDeclFileID(const Decl &D, const SourceManager &SM) {
+  return SM.getFileID(SM.getExpansionLoc(D.getLocation()));
+}
+
+static void setFileInfo(EligibleRanges &Ranges, const FileInfo &Info) {
+  for (EligibleRange &Range : Ranges) {
+    Range.Range.set_path(Info.Path);
+    if (Info.PragmaNullability)
+      Range.Range.set_pragma_nullability(*Info.PragmaNullability);
+  }
+}
+
+static EligibleRanges getEligibleRanges(const FunctionDecl &Fun,
+                                        FileInfoCache &Files) {
   // NullabilityWalker doesn't work on dependent types.
   if (Fun.getReturnType()->isDependentType()) return {};
   for (const auto &Param : Fun.parameters()) {
@@ -482,12 +528,13 @@ static EligibleRanges getEligibleRanges(
   if (TyLoc.isNull()) return {};
   const clang::ASTContext &Context = Fun.getParentASTContext();
   const SourceManager &SrcMgr = Context.getSourceManager();
-  FileID DeclFID = SrcMgr.getFileID(SrcMgr.getExpansionLoc(Fun.getLocation()));
+  FileID DeclFID = getDeclFileID(Fun, SrcMgr);
   if (!DeclFID.isValid()) return {};
 
-  std::optional<std::string> Path = getPath(DeclFID, SrcMgr);
-  if (!Path) return {};
+  const FileInfo *Info = Files.get(DeclFID, SrcMgr);
+  if (!Info) return {};
 
+  const TypeNullabilityDefaults &Defaults = Files.defaults();
   EligibleRanges Result;
   addRangesQualifierAware(nullptr, TyLoc.getReturnLoc(), SLOT_RETURN_TYPE,
                           Context, DeclFID, Defaults, Result);
@@ -498,61 +545,49 @@ static EligibleRanges getEligibleRanges(
                             SLOT_PARAM + I, Context, DeclFID, Defaults, Result);
   }
 
-  if (Result.empty()) return {};
-
-  std::optional<Nullability> PragmaNullability =
-      getPragmaNullability(DeclFID, Defaults);
-  for (EligibleRange &Range : Result) {
-    Range.Range.set_path(*Path);
-    if (PragmaNullability)
-      Range.Range.set_pragma_nullability(*PragmaNullability);
-  }
-
+  setFileInfo(Result, *Info);
   return Result;
 }
 
-static EligibleRanges getEligibleRanges(
-    const DeclaratorDecl &D, const TypeNullabilityDefaults &Defaults) {
+static EligibleRanges getEligibleRanges(const DeclaratorDecl &D,
+                                        FileInfoCache &Files) {
   // NullabilityWalker doesn't work on dependent types.
   if (D.getType()->isDependentType()) return {};
   TypeLoc TyLoc = D.getTypeSourceInfo()->getTypeLoc();
   if (TyLoc.isNull()) return {};
   const clang::ASTContext &Context = D.getASTContext();
   const SourceManager &SrcMgr = Context.getSourceManager();
-  FileID DeclFID = SrcMgr.getFileID(SrcMgr.getExpansionLoc(D.getLocation()));
+  FileID DeclFID = getDeclFileID(D, SrcMgr);
   if (!DeclFID.isValid()) return {};
 
-  std::optional<std::string> Path = getPath(DeclFID, SrcMgr);
-  if (!Path) return {};
+  const FileInfo *Info = Files.get(DeclFID, SrcMgr);
+  if (!Info) return {};
 
   EligibleRanges Result;
-  addRangesQualifierAware(&D, TyLoc, Slot(0), Context, DeclFID, Defaults,
-                          Result);
-  if (Result.empty()) return {};
-
-  std::optional<Nullability> PragmaNullability =
-      getPragmaNullability(DeclFID, Defaults);
-  for (EligibleRange &Range : Result) {
-    Range.Range.set_path(*Path);
-    if (PragmaNullability)
-      Range.Range.set_pragma_nullability(*PragmaNullability);
-  }
+  addRangesQualifierAware(&D, TyLoc, Slot(0), Context, DeclFID,
+                          Files.defaults(), Result);
+  setFileInfo(Result, *Info);
   return Result;
 }
 
-EligibleRanges getEligibleRanges(const Decl &D,
-                                 const TypeNullabilityDefaults &Defaults) {
+static EligibleRanges getEligibleRanges(const Decl &D, FileInfoCache &Files) {
   // We'll never be able to edit a written type for an implicit declaration.
   if (D.isImplicit()) return {};
   if (const auto *Fun = clang::dyn_cast<FunctionDecl>(&D))
-    return getEligibleRanges(*Fun, Defaults);
+    return getEligibleRanges(*Fun, Files);
   if (const auto *Field = clang::dyn_cast<FieldDecl>(&D))
-    return getEligibleRanges(*Field, Defaults);
+    return getEligibleRanges(*Field, Files);
   if (const auto *Var = clang::dyn_cast<VarDecl>(&D))
-    return getEligibleRanges(*Var, Defaults);
+    return getEligibleRanges(*Var, Files);
   return {};
 }
 
+EligibleRanges getEligibleRanges(const Decl &D,
+                                 const TypeNullabilityDefaults &Defaults) {
+  FileInfoCache Files(Defaults);
+  return getEligibleRanges(D, Files);
+}
+
 EligibleRanges getInferenceRanges(const Decl &D,
                                   const TypeNullabilityDefaults &Defaults) {
   if (!isInferenceTarget(D)) return {};
@@ -562,22 +597,53 @@ EligibleRanges getInferenceRanges(const Decl &D,
 namespace {
 struct Walker : public RecursiveASTVisitor<Walker> {
   Walker(const TypeNullabilityDefaults &Defaults,
-         std::unique_ptr<LocFilter> LocFilter)
-      : Defaults(Defaults), LocFilter(std::move(LocFilter)) {}
-
-  // Must outlive the walker.
-  const TypeNullabilityDefaults &Defaults;
+         std::unique_ptr<LocFilter> LocFilter, const SourceManager &SM,
+         FileID OnlyFile = FileID())
+      : Files(Defaults),
+        LocFilter(std::move(LocFilter)),
+        SM(SM),
+        OnlyFile(OnlyFile) {}
+
+  FileInfoCache Files;
   EligibleRanges Out;
   std::unique_ptr<LocFilter> LocFilter;
+  const SourceManager &SM;
+  // If valid, only collects ranges in this file.
+  FileID OnlyFile;
 
   // We can't walk the nullabilities in templates themselves, but walking the
   // instantiations will let us at least see the templates that get used.
   bool shouldVisitTemplateInstantiations() const { return true; }
 
+  bool TraverseDecl(Decl *D) {
+    if (D != nullptr && OnlyFile.isValid() && !mayContainOnlyFile(*D))
+      return true;
+    return RecursiveASTVisitor::TraverseDecl(D);
+  }
+
+  // Returns whether `D` or the declarations nested in it may be in `OnlyFile`.
+  // The declarations nested in `D` are within its range, so this is the case
+  // if the range starts or ends in `OnlyFile`, or if `OnlyFile` is included
+  // within the range (e.g. within a namespace).
+  bool mayContainOnlyFile(const Decl &D) {
+    if (isa<TranslationUnitDecl>(D)) return true;
+    SourceRange R = D.getSourceRange();
+    if (R.isInvalid()) return true;
+    SourceLocation Begin = SM.getExpansionRange(R.getBegin()).getBegin();
+    SourceLocation End = SM.getExpansionRange(R.getEnd()).getEnd();
+    if (SM.getFileID(Begin) == OnlyFile || SM.getFileID(End) == OnlyFile)
+      return true;
+    SourceLocation FileStart = SM.getLocForStartOfFile(OnlyFile);
+    return !SM.isBeforeInTranslationUnit(FileStart, Begin) &&
+           !SM.isBeforeInTranslationUnit(End, FileStart);
+  }
+
   template <typename DeclT>
   void insertPointerRanges(absl::Nonnull<const DeclT *> Decl) {
     if (!LocFilter->check(Decl->getBeginLoc())) return;
-    EligibleRanges Ranges = getEligibleRanges(*Decl, Defaults);
+    if (OnlyFile.isValid() && getDeclFileID(*Decl, SM) != OnlyFile) return;
+    EligibleRanges Ranges =
+        getEligibleRanges(static_cast<const clang::Decl &>(*Decl), Files);
     Out.reserve(Out.size() + Ranges.size());
     std::move(Ranges.begin(), Ranges.end(), std::back_inserter(Out));
   }
@@ -614,7 +680,18 @@ EligibleRanges getEligibleRanges(ASTContext &Ctx,
                                  const TypeNullabilityDefaults &Defaults,
                                  bool RestrictToMainFileOrHeader) {
   Walker W(Defaults,
-           getLocFilter(Ctx.getSourceManager(), RestrictToMainFileOrHeader));
+           getLocFilter(Ctx.getSourceManager(), RestrictToMainFileOrHeader),
+           Ctx.getSourceManager());
+  W.TraverseAST(Ctx);
+  return std::move(W.Out);
+}
+
+EligibleRanges getEligibleRanges(ASTContext &Ctx, FileID File,
+                                 const TypeNullabilityDefaults &Defaults) {
+  Walker W(Defaults,
+           getLocFilter(Ctx.getSourceManager(),
+                        /*RestrictToMainFileOrHeader=*/false),
+           Ctx.getSourceManager(), File);
   W.TraverseAST(Ctx);
   return std::move(W.Out);
 }
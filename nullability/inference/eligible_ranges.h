@@ -10,7 +10,9 @@
 
 #include "nullability/inference/inference.proto.h"
 #include "nullability/type_nullability.h"
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/DeclBase.h"
+#include "clang/Basic/SourceLocation.h"
 
 namespace clang::tidy::nullability {
 
@@ -40,6 +42,14 @@ EligibleRanges getEligibleRanges(ASTContext& Ctx,
                                  const TypeNullabilityDefaults& Defaults,
                                  bool RestrictToMainFileOrHeader = false);
 
+/// Collects the ranges of types written in the file `File` that are eligible
+/// for nullability annotations, e.g. for annotating a header. This is a single
+/// traversal of the AST that skips declarations outside of `File`, and shares
+/// per-file work between declarations, so is much cheaper than calling
+/// `getEligibleRanges` for each declaration in the file.
+EligibleRanges getEligibleRanges(ASTContext& Ctx, FileID File,
+                                 const TypeNullabilityDefaults& Defaults);
+
 }  // namespace clang::tidy::nullability
 
 #endif  // CRUBIT_NULLABILITY_INFERENCE_ELIGIBLE_RANGES_H_
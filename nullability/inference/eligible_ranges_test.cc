@@ -21,6 +21,8 @@
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Testing/TestAST.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
@@ -1748,5 +1750,52 @@ TEST(GetEligibleRangesFromASTTest, AutoFunctionTemplateSyntax) {
                                eligibleRange(0, 0, Input.range("local_one")),
                                eligibleRange(0, 0, Input.range("local_two")))));
 }
+
+TEST(GetEligibleRangesFromFileTest, SameAsWholeASTRestrictedToFile) {
+  std::string Input = R"cc(
+#include "header.h"
+    namespace ns {
+#include "nested.h"
+    }  // namespace ns
+    int* mainFunc(int* P);
+    template <typename T>
+    void usesTemplate() {
+      headerTemplate<int>(nullptr);
+    }
+    void instantiates() { usesTemplate<int>(); }
+  )cc";
+  NullabilityPragmas Pragmas;
+  TestInputs Inputs = getAugmentedTestInputs(Input, Pragmas);
+  Inputs.ExtraFiles["header.h"] = R"cc(
+    int* headerFunc(int** P);
+    struct S {
+      int* Field;
+    };
+    template <typename T>
+    void headerTemplate(T* P) {
+      int* Local = nullptr;
+    }
+  )cc";
+  Inputs.ExtraFiles["nested.h"] = "int* nestedFunc();";
+  TestAST TU(Inputs);
+  TypeNullabilityDefaults Defaults(TU.context(), Pragmas);
+  const SourceManager &SM = TU.context().getSourceManager();
+
+  for (llvm::StringRef File : {"header.h", "nested.h", MainFileName}) {
+    SCOPED_TRACE(File);
+    auto Entry = SM.getFileManager().getOptionalFileRef(File);
+    ASSERT_TRUE(Entry);
+    FileID FID = SM.translateFile(*Entry);
+    ASSERT_TRUE(FID.isValid());
+
+    std::vector<testing::Matcher<EligibleRange>> Expected;
+    for (const EligibleRange &ER : getEligibleRanges(TU.context(), Defaults))
+      if (ER.Range.path() == File) Expected.push_back(eligibleRange(ER));
+    EXPECT_THAT(Expected, Not(IsEmpty()));
+    EXPECT_THAT(getEligibleRanges(TU.context(), FID, Defaults),
+                UnorderedElementsAreArray(Expected));
+  }
+}
+
 }  // namespace
 }  // namespace clang::tidy::nullability
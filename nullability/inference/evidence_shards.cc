@@ -0,0 +1,154 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/evidence_shards.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "nullability/inference/inference.proto.h"
+#include "nullability/inference/merge.h"
+#include "nullability/inference/slot_fingerprint.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace clang::tidy::nullability {
+namespace {
+
+// Each record in a file is its serialized size, as a 32-bit little-endian
+// integer, followed by the serialized SlotPartialRecord.
+void writeRecord(llvm::raw_ostream &OS, const SlotPartialRecord &Record) {
+  std::string Bytes = Record.SerializeAsString();
+  char Size[4];
+  llvm::support::endian::write32le(Size, Bytes.size());
+  OS.write(Size, sizeof(Size));
+  OS << Bytes;
+}
+
+SlotFingerprint fingerprint(const SlotPartialRecord &Record) {
+  return fingerprint(Record.symbol().usr(), Record.slot());
+}
+
+bool isSameSlot(const SlotPartialRecord &L, const SlotPartialRecord &R) {
+  return L.slot() == R.slot() && L.symbol().usr() == R.symbol().usr();
+}
+
+}  // namespace
+
+unsigned shardOf(const SlotPartialRecord &Record, unsigned NumShards) {
+  return fingerprint(Record) % NumShards;
+}
+
+std::string shardPath(llvm::StringRef Prefix, unsigned Shard,
+                      unsigned NumShards) {
+  std::string Result;
+  llvm::raw_string_ostream OS(Result);
+  OS << Prefix << "-" << llvm::format("%05u", Shard) << "-of-"
+     << llvm::format("%05u", NumShards);
+  return Result;
+}
+
+llvm::Error writeShards(llvm::ArrayRef<SlotPartialRecord> Records,
+                        llvm::StringRef Prefix, unsigned NumShards) {
+  if (NumShards == 0)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "the number of shards must be positive");
+  std::vector<std::unique_ptr<llvm::raw_fd_ostream>> Shards;
+  for (unsigned Shard = 0; Shard < NumShards; ++Shard) {
+    std::string Path = shardPath(Prefix, Shard, NumShards);
+    std::error_code EC;
+    Shards.push_back(std::make_unique<llvm::raw_fd_ostream>(Path, EC));
+    if (EC) return llvm::createFileError(Path, EC);
+  }
+  for (const SlotPartialRecord &Record : Records)
+    writeRecord(*Shards[shardOf(Record, NumShards)], Record);
+  for (unsigned Shard = 0; Shard < NumShards; ++Shard) {
+    Shards[Shard]->close();
+    if (std::error_code EC = Shards[Shard]->error())
+      return llvm::createFileError(shardPath(Prefix, Shard, NumShards), EC);
+  }
+  return llvm::Error::success();
+}
+
+llvm::Error writeRecords(llvm::ArrayRef<SlotPartialRecord> Records,
+                         llvm::StringRef Path) {
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC);
+  if (EC) return llvm::createFileError(Path, EC);
+  for (const SlotPartialRecord &Record : Records) writeRecord(OS, Record);
+  OS.close();
+  if (OS.has_error()) return llvm::createFileError(Path, OS.error());
+  return llvm::Error::success();
+}
+
+llvm::Error readRecords(llvm::StringRef Path,
+                        llvm::function_ref<void(SlotPartialRecord)> Consume) {
+  auto Buffer = llvm::MemoryBuffer::getFile(Path);
+  if (!Buffer) return llvm::createFileError(Path, Buffer.getError());
+  llvm::StringRef Data = (*Buffer)->getBuffer();
+  while (!Data.empty()) {
+    if (Data.size() < 4)
+      return llvm::createFileError(Path, llvm::inconvertibleErrorCode(),
+                                   "truncated record size");
+    uint32_t Size = llvm::support::endian::read32le(Data.data());
+    Data = Data.drop_front(4);
+    if (Data.size() < Size)
+      return llvm::createFileError(Path, llvm::inconvertibleErrorCode(),
+                                   "truncated record");
+    SlotPartialRecord Record;
+    if (!Record.ParseFromArray(Data.data(), Size))
+      return llvm::createFileError(Path, llvm::inconvertibleErrorCode(),
+                                   "malformed record");
+    Data = Data.drop_front(Size);
+    Consume(std::move(Record));
+  }
+  return llvm::Error::success();
+}
+
+void SlotPartialReducer::add(SlotPartialRecord Record) {
+  auto [It, Inserted] = BySlot.try_emplace(fingerprint(Record));
+  if (Inserted) {
+    It->second = std::move(Record);
+    return;
+  }
+  if (isSameSlot(It->second, Record)) {
+    mergePartials(*It->second.mutable_partial(), Record.partial());
+    return;
+  }
+  for (SlotPartialRecord &C : Collided) {
+    if (isSameSlot(C, Record)) {
+      mergePartials(*C.mutable_partial(), Record.partial());
+      return;
+    }
+  }
+  Collided.push_back(std::move(Record));
+}
+
+std::vector<SlotPartialRecord> SlotPartialReducer::take() {
+  std::vector<SlotPartialRecord> Result = std::move(Collided);
+  Collided.clear();
+  Result.reserve(Result.size() + BySlot.size());
+  for (auto &[_, Record] : BySlot) Result.push_back(std::move(Record));
+  BySlot.clear();
+  llvm::sort(Result, [](const SlotPartialRecord &L,
+                         const SlotPartialRecord &R) {
+    return std::forward_as_tuple(L.symbol().usr(), L.slot()) <
+           std::forward_as_tuple(R.symbol().usr(), R.slot());
+  });
+  return Result;
+}
+
+}  // namespace clang::tidy::nullability
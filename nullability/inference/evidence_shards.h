@@ -0,0 +1,75 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Sharded storage of SlotPartialRecords, for map-reducing inference across the
+// codebase.
+//
+// The "map" phase writes the locally merged partials of each TU to
+// `NumShards` files, partitioned by slot fingerprint. All partials for a slot
+// thus end up in files with the same shard index, and each shard index can be
+// reduced independently, holding only the slots of that shard in memory.
+
+#ifndef CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_SHARDS_H_
+#define CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_SHARDS_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "nullability/inference/inference.proto.h"
+#include "nullability/inference/slot_fingerprint.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace clang::tidy::nullability {
+
+// Returns the shard, in [0, NumShards), that holds partials for the slot.
+unsigned shardOf(const SlotPartialRecord &, unsigned NumShards);
+
+// Returns the path of a shard file, e.g. "Prefix-00003-of-00016".
+std::string shardPath(llvm::StringRef Prefix, unsigned Shard,
+                      unsigned NumShards);
+
+// Writes `Records` to the `NumShards` files `shardPath(Prefix, ...)`.
+// Files are written even if they are empty, so that reducers of every shard
+// see an input from each TU.
+llvm::Error writeShards(llvm::ArrayRef<SlotPartialRecord> Records,
+                        llvm::StringRef Prefix, unsigned NumShards);
+
+// Writes `Records` to the single file `Path`.
+llvm::Error writeRecords(llvm::ArrayRef<SlotPartialRecord> Records,
+                         llvm::StringRef Path);
+
+// Calls `Consume` for each record in the file `Path`, in order.
+llvm::Error readRecords(llvm::StringRef Path,
+                        llvm::function_ref<void(SlotPartialRecord)> Consume);
+
+// Merges the partials of each slot, as they are added.
+class SlotPartialReducer {
+ public:
+  void add(SlotPartialRecord);
+
+  // The number of distinct slots added so far.
+  size_t size() const { return BySlot.size() + Collided.size(); }
+
+  // The number of distinct slots whose fingerprint is the same as that of an
+  // earlier slot. Their partials are still kept separate, but the inferences
+  // for them can't be told apart by fingerprint, e.g. in `PreviousInferences`.
+  size_t collisions() const { return Collided.size(); }
+
+  // Returns one record per slot, sorted by symbol and slot, and resets.
+  std::vector<SlotPartialRecord> take();
+
+ private:
+  absl::flat_hash_map<SlotFingerprint, SlotPartialRecord> BySlot;
+  // Slots whose fingerprints collide with those in `BySlot`. There should be
+  // ~none, so this is searched linearly.
+  std::vector<SlotPartialRecord> Collided;
+};
+
+}  // namespace clang::tidy::nullability
+
+#endif  // CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_SHARDS_H_
@@ -0,0 +1,142 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/evidence_shards.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "nullability/inference/inference.proto.h"
+#include "nullability/proto_matchers.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Testing/Support/Error.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googlemock/include/gmock/gmock.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
+#include "third_party/protobuf/text_format.h"
+
+namespace clang::tidy::nullability {
+namespace {
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+SlotPartialRecord record(llvm::StringRef Text) {
+  SlotPartialRecord Result;
+  CHECK(proto2::TextFormat::ParseFromString(Text, &Result));
+  return Result;
+}
+
+class EvidenceShardsTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        llvm::sys::fs::createUniqueDirectory("evidence_shards_test", Dir));
+  }
+  void TearDown() override { llvm::sys::fs::remove_directories(Dir); }
+
+  std::string path(llvm::StringRef Name) {
+    llvm::SmallString<256> Result = Dir;
+    llvm::sys::path::append(Result, Name);
+    return std::string(Result);
+  }
+
+  std::vector<SlotPartialRecord> read(llvm::StringRef Path) {
+    std::vector<SlotPartialRecord> Result;
+    EXPECT_THAT_ERROR(readRecords(Path,
+                                  [&](SlotPartialRecord R) {
+                                    Result.push_back(std::move(R));
+                                  }),
+                      llvm::Succeeded());
+    return Result;
+  }
+
+  llvm::SmallString<256> Dir;
+};
+
+TEST_F(EvidenceShardsTest, ShardPath) {
+  EXPECT_EQ(shardPath("out/tu", 3, 16), "out/tu-00003-of-00016");
+}
+
+TEST_F(EvidenceShardsTest, SlotsArePartitionedByFingerprint) {
+  std::vector<SlotPartialRecord> Records;
+  for (const char *USR : {"c:@F@a#", "c:@F@b#", "c:@F@c#", "c:@F@d#"}) {
+    for (unsigned Slot = 0; Slot < 3; ++Slot) {
+      SlotPartialRecord &R = Records.emplace_back();
+      R.mutable_symbol()->set_usr(USR);
+      R.set_slot(Slot);
+      (*R.mutable_partial()->mutable_kind_count())[Evidence::UNKNOWN_ARGUMENT] =
+          1;
+    }
+  }
+  constexpr unsigned NumShards = 4;
+  ASSERT_THAT_ERROR(writeShards(Records, path("tu"), NumShards),
+                    llvm::Succeeded());
+
+  size_t Total = 0;
+  for (unsigned Shard = 0; Shard < NumShards; ++Shard) {
+    std::vector<SlotPartialRecord> InShard =
+        read(shardPath(path("tu"), Shard, NumShards));
+    for (const SlotPartialRecord &R : InShard)
+      EXPECT_EQ(shardOf(R, NumShards), Shard);
+    Total += InShard.size();
+  }
+  EXPECT_EQ(Total, Records.size());
+}
+
+TEST_F(EvidenceShardsTest, EmptyShardsAreWritten) {
+  ASSERT_THAT_ERROR(writeShards({}, path("tu"), 2), llvm::Succeeded());
+  EXPECT_THAT(read(shardPath(path("tu"), 0, 2)), IsEmpty());
+  EXPECT_THAT(read(shardPath(path("tu"), 1, 2)), IsEmpty());
+}
+
+TEST_F(EvidenceShardsTest, ReadMissingFile) {
+  EXPECT_THAT_ERROR(readRecords(path("missing"), [](SlotPartialRecord) {}),
+                    llvm::Failed());
+}
+
+TEST_F(EvidenceShardsTest, ReduceMergesPartialsOfTheSameSlot) {
+  ASSERT_THAT_ERROR(writeRecords({record(R"pb(
+                                    symbol { usr: "c:@F@f#" }
+                                    slot: 1
+                                    partial { kind_count { key: 5 value: 1 } }
+                                  )pb"),
+                                  record(R"pb(
+                                    symbol { usr: "c:@F@f#" }
+                                    slot: 0
+                                    partial { kind_count { key: 3 value: 1 } }
+                                  )pb")},
+                                 path("first")),
+                    llvm::Succeeded());
+  ASSERT_THAT_ERROR(writeRecords({record(R"pb(
+                                   symbol { usr: "c:@F@f#" }
+                                   slot: 1
+                                   partial { kind_count { key: 5 value: 2 } }
+                                 )pb")},
+                                 path("second")),
+                    llvm::Succeeded());
+
+  SlotPartialReducer Reducer;
+  for (llvm::StringRef Input : {"first", "second"})
+    for (SlotPartialRecord &R : read(path(Input))) Reducer.add(std::move(R));
+  EXPECT_EQ(Reducer.size(), 2u);
+  EXPECT_THAT(Reducer.take(),
+              ElementsAre(EqualsProto(R"pb(
+                            symbol { usr: "c:@F@f#" }
+                            slot: 0
+                            partial { kind_count { key: 3 value: 1 } }
+                          )pb"),
+                          EqualsProto(R"pb(
+                            symbol { usr: "c:@F@f#" }
+                            slot: 1
+                            partial { kind_count { key: 5 value: 3 } }
+                          )pb")));
+  EXPECT_THAT(Reducer.take(), IsEmpty());
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
@@ -0,0 +1,54 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/evidence_table.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "nullability/inference/inference.proto.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/Support/Error.h"
+
+namespace clang::tidy::nullability {
+
+void EvidenceTableBuilder::add(const Evidence &E) {
+  auto [It, Inserted] =
+      SymbolIndex.try_emplace(E.symbol().usr(), Table.symbol_size());
+  if (Inserted) *Table.add_symbol() = E.symbol();
+
+  EvidenceTable::Entry &Entry = *Table.add_evidence();
+  Entry.set_symbol_index(It->second);
+  Entry.set_slot(E.slot());
+  Entry.set_kind(E.kind());
+  if (E.has_location()) Entry.set_location(E.location());
+}
+
+EvidenceTable EvidenceTableBuilder::take() {
+  SymbolIndex.clear();
+  return std::exchange(Table, {});
+}
+
+llvm::Error forEachEvidence(
+    const EvidenceTable &Table,
+    llvm::function_ref<void(const Evidence &)> Consume) {
+  Evidence E;
+  for (const EvidenceTable::Entry &Entry : Table.evidence()) {
+    if (Entry.symbol_index() >= static_cast<uint32_t>(Table.symbol_size()))
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "evidence refers to unknown symbol %u",
+                                     Entry.symbol_index());
+    *E.mutable_symbol() = Table.symbol(Entry.symbol_index());
+    E.set_slot(Entry.slot());
+    E.set_kind(Entry.kind());
+    if (Entry.has_location())
+      E.set_location(Entry.location());
+    else
+      E.clear_location();
+    Consume(E);
+  }
+  return llvm::Error::success();
+}
+
+}  // namespace clang::tidy::nullability
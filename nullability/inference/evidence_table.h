@@ -0,0 +1,42 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Conversion between Evidence and the more compact EvidenceTable, which stores
+// each symbol's USR once.
+
+#ifndef CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_TABLE_H_
+#define CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_TABLE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "nullability/inference/inference.proto.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/Support/Error.h"
+
+namespace clang::tidy::nullability {
+
+// Builds an EvidenceTable from evidence as it is emitted, numbering symbols in
+// the order in which they are first seen.
+class EvidenceTableBuilder {
+ public:
+  void add(const Evidence &);
+
+  // Returns the table of the evidence added so far, and resets.
+  EvidenceTable take();
+
+ private:
+  EvidenceTable Table;
+  absl::flat_hash_map<std::string, uint32_t> SymbolIndex;
+};
+
+// Calls `Consume` with each entry of the table, as Evidence.
+// Fails if an entry refers to a symbol that is not in the table.
+llvm::Error forEachEvidence(const EvidenceTable &,
+                            llvm::function_ref<void(const Evidence &)> Consume);
+
+}  // namespace clang::tidy::nullability
+
+#endif  // CRUBIT_NULLABILITY_INFERENCE_EVIDENCE_TABLE_H_
@@ -0,0 +1,96 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/evidence_table.h"
+
+#include <vector>
+
+#include "absl/log/check.h"
+#include "nullability/inference/inference.proto.h"
+#include "nullability/proto_matchers.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Testing/Support/Error.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googlemock/include/gmock/gmock.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
+#include "third_party/protobuf/text_format.h"
+
+namespace clang::tidy::nullability {
+namespace {
+using ::testing::ElementsAre;
+
+template <typename T>
+T proto(llvm::StringRef Text) {
+  T Result;
+  CHECK(proto2::TextFormat::ParseFromString(Text, &Result));
+  return Result;
+}
+
+constexpr llvm::StringRef FirstParam = R"pb(
+  symbol { usr: "c:@F@f#*I#" }
+  slot: 1
+  kind: UNCHECKED_DEREFERENCE
+  location: "input.cc:1:2"
+)pb";
+constexpr llvm::StringRef Return = R"pb(
+  symbol { usr: "c:@F@g#" }
+  slot: 0
+  kind: NULLABLE_RETURN
+)pb";
+constexpr llvm::StringRef SecondParam = R"pb(
+  symbol { usr: "c:@F@f#*I#" }
+  slot: 2
+  kind: NONNULL_ARGUMENT
+  location: "input.cc:3:4"
+)pb";
+
+TEST(EvidenceTableTest, SymbolsAreStoredOnce) {
+  EvidenceTableBuilder Builder;
+  for (llvm::StringRef E : {FirstParam, Return, SecondParam})
+    Builder.add(proto<Evidence>(E));
+  EXPECT_THAT(Builder.take(), EqualsProto(R"pb(
+                symbol { usr: "c:@F@f#*I#" }
+                symbol { usr: "c:@F@g#" }
+                evidence {
+                  symbol_index: 0
+                  slot: 1
+                  kind: UNCHECKED_DEREFERENCE
+                  location: "input.cc:1:2"
+                }
+                evidence { symbol_index: 1 slot: 0 kind: NULLABLE_RETURN }
+                evidence {
+                  symbol_index: 0
+                  slot: 2
+                  kind: NONNULL_ARGUMENT
+                  location: "input.cc:3:4"
+                }
+              )pb"));
+  EXPECT_THAT(Builder.take(), EqualsProto(EvidenceTable()));
+}
+
+TEST(EvidenceTableTest, RoundTrip) {
+  EvidenceTableBuilder Builder;
+  for (llvm::StringRef E : {FirstParam, Return, SecondParam})
+    Builder.add(proto<Evidence>(E));
+  std::vector<Evidence> Decoded;
+  ASSERT_THAT_ERROR(forEachEvidence(Builder.take(),
+                                    [&](const Evidence &E) {
+                                      Decoded.push_back(E);
+                                    }),
+                    llvm::Succeeded());
+  EXPECT_THAT(Decoded,
+              ElementsAre(EqualsProto(FirstParam), EqualsProto(Return),
+                          EqualsProto(SecondParam)));
+}
+
+TEST(EvidenceTableTest, UnknownSymbol) {
+  EXPECT_THAT_ERROR(
+      forEachEvidence(proto<EvidenceTable>(R"pb(
+                        evidence { symbol_index: 0 kind: NULLABLE_RETURN }
+                      )pb"),
+                      [](const Evidence &) {}),
+      llvm::Failed());
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
@@ -4,18 +4,21 @@
 
 #include "nullability/inference/infer_tu.h"
 
+#include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "nullability/inference/collect_evidence.h"
 #include "nullability/inference/inference.proto.h"
 #include "nullability/inference/merge.h"
 #include "nullability/inference/slot_fingerprint.h"
+#include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pragma.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/Basic/SourceManager.h"
-#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
@@ -25,55 +28,61 @@
 namespace clang::tidy::nullability {
 namespace {
 
+// The evidence for each slot, merged as it is emitted, so that we don't need to
+// hold on to (or sort) all evidence.
+struct SlotEvidence {
+  std::string USR;
+  uint32_t Slot;
+  SlotPartial Partial;
+};
+using EvidenceBySlot = absl::flat_hash_map<SlotFingerprint, SlotEvidence>;
+
+void addEvidence(EvidenceBySlot& Into, const Evidence& E) {
+  auto [It, Inserted] =
+      Into.try_emplace(fingerprint(E.symbol().usr(), E.slot()));
+  if (Inserted) {
+    It->second.USR = E.symbol().usr();
+    It->second.Slot = E.slot();
+  }
+  mergeEvidenceIntoPartial(It->second.Partial, E);
+}
+
+void addEvidence(EvidenceBySlot& Into, const EvidenceBySlot& From) {
+  for (const auto& [Fingerprint, ForSlot] : From) {
+    auto [It, Inserted] = Into.try_emplace(Fingerprint, ForSlot);
+    if (!Inserted) mergePartials(It->second.Partial, ForSlot.Partial);
+  }
+}
+
+// Returns the slots that are in exactly one of `A` and `B`.
+llvm::DenseSet<SlotFingerprint> symmetricDifference(
+    const llvm::DenseSet<SlotFingerprint>& A,
+    const llvm::DenseSet<SlotFingerprint>& B) {
+  llvm::DenseSet<SlotFingerprint> Result;
+  for (SlotFingerprint F : A)
+    if (!B.contains(F)) Result.insert(F);
+  for (SlotFingerprint F : B)
+    if (!A.contains(F)) Result.insert(F);
+  return Result;
+}
+
 class InferenceManager {
  public:
   InferenceManager(ASTContext& Ctx, unsigned Iterations,
                    llvm::function_ref<bool(const Decl&)> Filter,
-                   const NullabilityPragmas& Pragmas)
-      : Ctx(Ctx), Iterations(Iterations), Filter(Filter), Pragmas(Pragmas) {}
-
-  InferenceResults inferenceRound(
-      EvidenceSites Sites, USRCache USRCache,
-      PreviousInferences InferencesFromLastRound) const {
-    InferenceResults AllInference;
-    std::vector<Evidence> AllEvidence;
-
-    // Collect all evidence.
-    auto Emitter = evidenceEmitter([&](auto& E) { AllEvidence.push_back(E); },
-                                   USRCache, Ctx);
-    for (const auto* Decl : Sites.Declarations) {
-      if (Filter && !Filter(*Decl)) continue;
-      collectEvidenceFromTargetDeclaration(*Decl, Emitter, Pragmas);
-    }
-    for (const auto* Impl : Sites.Definitions) {
-      if (Filter && !Filter(*Impl)) continue;
-      if (auto Err = collectEvidenceFromDefinition(
-              *Impl, Emitter, USRCache, Pragmas, InferencesFromLastRound)) {
-        llvm::errs() << "Error in evidence collection: "
-                     << toString(std::move(Err)) << "\n";
-      }
-    }
-    // Group by symbol and then slot number.
-    llvm::sort(AllEvidence, [&](const Evidence& L, const Evidence& R) {
-      if (L.symbol().usr() != R.symbol().usr())
-        return L.symbol().usr() < R.symbol().usr();
-      return L.slot() < R.slot();
-    });
-    // For each symbol, for each slot, combine evidence into an inference.
-    llvm::ArrayRef<Evidence> RemainingEvidence = AllEvidence;
-
-    while (!RemainingEvidence.empty()) {
-      auto Batch = RemainingEvidence.take_while([&](const Evidence& E) {
-        return E.symbol().usr() == RemainingEvidence.front().symbol().usr() &&
-               E.slot() == RemainingEvidence.front().slot();
-      });
-      RemainingEvidence = RemainingEvidence.drop_front(Batch.size());
-      AllInference[Batch.front().symbol().usr()][Slot(Batch.front().slot())] =
-          mergeEvidence(Batch);
-    }
-    return AllInference;
-  }
-
+                   const NullabilityPragmas& Pragmas,
+                   const SolverFactory& MakeSolver)
+      : Ctx(Ctx),
+        Iterations(Iterations),
+        Filter(Filter),
+        Pragmas(Pragmas),
+        MakeSolver(MakeSolver) {}
+
+  // Runs up to `Iterations` rounds of inference, each of which uses the
+  // inferences of the previous round. Rather than analyzing all definitions
+  // again in each round, only reanalyzes the definitions which looked up
+  // previous inferences that have changed since the previous round. Stops
+  // early if there are no such definitions, as the results have converged.
   InferenceResults iterativelyInfer() const {
     if (!Ctx.getLangOpts().CPlusPlus) {
       llvm::errs() << "Skipping non-C++ input file: "
@@ -87,21 +96,71 @@ class InferenceManager {
     auto Sites = EvidenceSites::discover(Ctx);
     USRCache USRCache;
 
-    InferenceResults AllInference = inferenceRound(Sites, USRCache, {});
+    // Evidence is collected into `*Into`, which is switched for each site.
+    EvidenceBySlot* Into = nullptr;
+    auto Emitter = evidenceEmitter(
+        [&](const Evidence& E) { addEvidence(*Into, E); }, USRCache, Ctx);
+
+    // Evidence from declarations doesn't depend on previous inferences.
+    EvidenceBySlot DeclarationEvidence;
+    Into = &DeclarationEvidence;
+    for (const auto* Decl : Sites.Declarations) {
+      if (Filter && !Filter(*Decl)) continue;
+      collectEvidenceFromTargetDeclaration(*Decl, Emitter, Pragmas);
+    }
+
+    struct DefinitionEvidence {
+      const Decl* Definition;
+      EvidenceBySlot Evidence;
+      // The slots whose previous inferences the analysis looked up.
+      llvm::DenseSet<SlotFingerprint> Reads;
+    };
+    std::vector<DefinitionEvidence> Definitions;
+    for (const auto* Impl : Sites.Definitions) {
+      if (Filter && !Filter(*Impl)) continue;
+      Definitions.push_back({Impl, {}, {}});
+    }
+    std::vector<DefinitionEvidence*> Worklist;
+    for (DefinitionEvidence& D : Definitions) Worklist.push_back(&D);
 
-    for (unsigned Iteration = 1; Iteration < Iterations; ++Iteration) {
-      llvm::DenseSet<SlotFingerprint> NullableFromLastRound;
-      llvm::DenseSet<SlotFingerprint> NonnullFromLastRound;
+    llvm::DenseSet<SlotFingerprint> NullableFromLastRound;
+    llvm::DenseSet<SlotFingerprint> NonnullFromLastRound;
+    InferenceResults AllInference;
+    for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration) {
+      for (DefinitionEvidence* D : Worklist) {
+        D->Evidence.clear();
+        D->Reads.clear();
+        Into = &D->Evidence;
+        if (auto Err = collectEvidenceFromDefinition(
+                *D->Definition, Emitter, USRCache, Pragmas,
+                {NullableFromLastRound, NonnullFromLastRound, &D->Reads},
+                MakeSolver)) {
+          llvm::errs() << "Error in evidence collection: "
+                       << toString(std::move(Err)) << "\n";
+        }
+      }
 
+      // For each symbol, for each slot, combine evidence into an inference.
+      EvidenceBySlot AllEvidence = DeclarationEvidence;
+      for (const DefinitionEvidence& D : Definitions)
+        addEvidence(AllEvidence, D.Evidence);
+      AllInference.clear();
+      for (const auto& [Fingerprint, ForSlot] : AllEvidence)
+        AllInference[ForSlot.USR][Slot(ForSlot.Slot)] =
+            finalize(ForSlot.Partial);
+      if (Iteration + 1 == Iterations) break;
+
+      llvm::DenseSet<SlotFingerprint> Nullable;
+      llvm::DenseSet<SlotFingerprint> Nonnull;
       for (const auto& [USR, Inferences] : AllInference) {
         for (const auto& [Slot, SlotInference] : Inferences) {
           if (SlotInference.trivial() || SlotInference.conflict()) continue;
           switch (SlotInference.nullability()) {
             case Nullability::NULLABLE:
-              NullableFromLastRound.insert(fingerprint(USR, Slot));
+              Nullable.insert(fingerprint(USR, Slot));
               break;
             case Nullability::NONNULL:
-              NonnullFromLastRound.insert(fingerprint(USR, Slot));
+              Nonnull.insert(fingerprint(USR, Slot));
               break;
             default:
               break;
@@ -109,8 +168,21 @@ class InferenceManager {
         }
       }
 
-      AllInference = inferenceRound(
-          Sites, USRCache, {NullableFromLastRound, NonnullFromLastRound});
+      llvm::DenseSet<SlotFingerprint> Changed =
+          symmetricDifference(Nullable, NullableFromLastRound);
+      llvm::DenseSet<SlotFingerprint> ChangedNonnull =
+          symmetricDifference(Nonnull, NonnullFromLastRound);
+      Changed.insert(ChangedNonnull.begin(), ChangedNonnull.end());
+      Worklist.clear();
+      for (DefinitionEvidence& D : Definitions)
+        if (llvm::any_of(D.Reads, [&](SlotFingerprint F) {
+              return Changed.contains(F);
+            }))
+          Worklist.push_back(&D);
+      if (Worklist.empty()) break;
+
+      NullableFromLastRound = std::move(Nullable);
+      NonnullFromLastRound = std::move(Nonnull);
     }
     return AllInference;
   }
@@ -120,13 +192,61 @@ class InferenceManager {
   unsigned Iterations;
   llvm::function_ref<bool(const Decl&)> Filter;
   const NullabilityPragmas& Pragmas;
+  const SolverFactory& MakeSolver;
 };
 }  // namespace
 
 InferenceResults inferTU(ASTContext& Ctx, const NullabilityPragmas& Pragmas,
                          unsigned Iterations,
-                         llvm::function_ref<bool(const Decl&)> Filter) {
-  return InferenceManager(Ctx, Iterations, Filter, Pragmas).iterativelyInfer();
+                         llvm::function_ref<bool(const Decl&)> Filter,
+                         const SolverFactory& MakeSolver) {
+  return InferenceManager(Ctx, Iterations, Filter, Pragmas, MakeSolver)
+      .iterativelyInfer();
+}
+
+void collectTUEvidence(ASTContext& Ctx, const NullabilityPragmas& Pragmas,
+                       llvm::function_ref<void(const Evidence&)> Emit,
+                       llvm::function_ref<bool(const Decl&)> Filter,
+                       const SolverFactory& MakeSolver,
+                       PreviousInferences PreviousInferences) {
+  if (!Ctx.getLangOpts().CPlusPlus) return;
+  auto Sites = EvidenceSites::discover(Ctx);
+  USRCache USRCache;
+  auto Emitter = evidenceEmitter([&](const Evidence& E) { Emit(E); },
+                                 USRCache, Ctx);
+  for (const auto* Decl : Sites.Declarations) {
+    if (Filter && !Filter(*Decl)) continue;
+    collectEvidenceFromTargetDeclaration(*Decl, Emitter, Pragmas);
+  }
+  for (const auto* Impl : Sites.Definitions) {
+    if (Filter && !Filter(*Impl)) continue;
+    if (auto Err =
+            collectEvidenceFromDefinition(*Impl, Emitter, USRCache, Pragmas,
+                                          PreviousInferences, MakeSolver)) {
+      llvm::errs() << "Error in evidence collection: "
+                   << toString(std::move(Err)) << "\n";
+    }
+  }
+}
+
+std::vector<SlotPartialRecord> collectSlotPartials(
+    ASTContext& Ctx, const NullabilityPragmas& Pragmas,
+    llvm::function_ref<bool(const Decl&)> Filter,
+    const SolverFactory& MakeSolver, PreviousInferences PreviousInferences) {
+  EvidenceBySlot BySlot;
+  collectTUEvidence(
+      Ctx, Pragmas, [&](const Evidence& E) { addEvidence(BySlot, E); }, Filter,
+      MakeSolver, PreviousInferences);
+
+  std::vector<SlotPartialRecord> Result;
+  Result.reserve(BySlot.size());
+  for (auto& [_, ForSlot] : BySlot) {
+    SlotPartialRecord& Record = Result.emplace_back();
+    Record.mutable_symbol()->set_usr(std::move(ForSlot.USR));
+    Record.set_slot(ForSlot.Slot);
+    *Record.mutable_partial() = std::move(ForSlot.Partial);
+  }
+  return Result;
 }
 
 }  // namespace clang::tidy::nullability
@@ -6,9 +6,12 @@
 #define CRUBIT_NULLABILITY_INFERENCE_INFER_TU_H_
 
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "nullability/inference/collect_evidence.h"
 #include "nullability/inference/inference.proto.h"
+#include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pragma.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/DeclBase.h"
@@ -27,9 +30,33 @@ using InferenceResults =
 // It also lets us write tests for the whole inference system.
 //
 // If Filter is provided, only considers decls that return true.
+// MakeSolver creates the solver used to analyze each definition.
+// Definitions are analyzed serially, as the analysis mutates the ASTContext
+// (see `collectEvidenceFromDefinition`).
 InferenceResults inferTU(
     ASTContext &, const NullabilityPragmas &, unsigned Iterations = 1,
-    llvm::function_ref<bool(const Decl &)> Filter = nullptr);
+    llvm::function_ref<bool(const Decl &)> Filter = nullptr,
+    const SolverFactory &MakeSolver = makeDefaultSolverForInference);
+
+// Collects the evidence in a translation unit, passing each piece to `Emit`.
+// This is a single round of collection, using the inferences of a previous
+// round (e.g. of inference across the codebase) if provided.
+//
+// Filter and MakeSolver are as for `inferTU`.
+void collectTUEvidence(
+    ASTContext &, const NullabilityPragmas &,
+    llvm::function_ref<void(const Evidence &)> Emit,
+    llvm::function_ref<bool(const Decl &)> Filter = nullptr,
+    const SolverFactory &MakeSolver = makeDefaultSolverForInference,
+    PreviousInferences PreviousInferences = {});
+
+// Like `collectTUEvidence`, but merges the evidence per slot, for the "map"
+// phase of inference across the codebase.
+std::vector<SlotPartialRecord> collectSlotPartials(
+    ASTContext &, const NullabilityPragmas &,
+    llvm::function_ref<bool(const Decl &)> Filter = nullptr,
+    const SolverFactory &MakeSolver = makeDefaultSolverForInference,
+    PreviousInferences PreviousInferences = {});
 
 }  // namespace clang::tidy::nullability
 
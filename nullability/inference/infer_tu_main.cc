@@ -7,25 +7,53 @@
 // By default (-diagnostics=1) it shows findings as diagnostics.
 // It can optionally (-protos=1) print the Inference proto.
 //
+// With -partials-prefix, it instead writes the TU's evidence, merged per slot,
+// to sharded files for merge_partials_main to reduce. This is the "map" phase
+// of inference across a codebase; each TU must use a distinct prefix.
+// With -evidence-table, it instead writes all of the TU's evidence, as a binary
+// EvidenceTable proto.
+// With -previous-nullable and -previous-nonnull, evidence is collected using
+// the inferences of a previous round, as written by merge_partials_main.
+//
+// With -j, the TUs are analyzed in parallel and their evidence is merged
+// before inference, so that the inference for a symbol takes all of the given
+// TUs into account. Only -protos and -metrics output is supported then.
+//
 // This is not the intended way to fully analyze a real codebase.
 // e.g. it can't jointly inspect all callsites of a function (in different TUs).
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <system_error>
 #include <utility>
+#include <vector>
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/strings/str_cat.h"
+#include "nullability/inference/collect_evidence.h"
 #include "nullability/inference/ctn_replacement_macros.h"
+#include "nullability/inference/evidence_shards.h"
+#include "nullability/inference/evidence_table.h"
 #include "nullability/inference/infer_tu.h"
 #include "nullability/inference/inference.proto.h"
+#include "nullability/inference/merge.h"
 #include "nullability/inference/replace_macros.h"
+#include "nullability/inference/slot_fingerprint.h"
+#include "nullability/inference/slot_fingerprint_set.h"
+#include "nullability/loc_filter.h"
+#include "nullability/pointer_nullability_analysis.h"
+#include "nullability/pointer_nullability_diagnosis.h"
 #include "nullability/pragma.h"
 #include "nullability/type_nullability.h"
 #include "clang/AST/ASTConsumer.h"
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
+#include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclarationName.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Basic/LLVM.h"
@@ -35,9 +63,14 @@
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Index/USRGeneration.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
-#include "clang/Tooling/Execution.h"
+#include "clang/Tooling/CommonOptionsParser.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/StandaloneExecution.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
@@ -45,7 +78,10 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
 using ::clang::tidy::nullability::ReplacementMacrosHeaderFileName;
@@ -86,11 +122,55 @@ llvm::cl::opt<std::string> NameFilter{
     llvm::cl::desc("Regular expression decl names must match to be analyzed. "
                    "May be negated with - prefix."),
 };
+llvm::cl::opt<std::string> OwnershipManifest{
+    "ownership",
+    llvm::cl::desc("File with lines '<file> <main file of owning TU>'. Only "
+                   "analyze files that are owned by this TU, or not listed"),
+};
 llvm::cl::opt<unsigned> Iterations{
     "iterations",
     llvm::cl::desc("Number of inference iterations"),
     llvm::cl::init(1),
 };
+llvm::cl::opt<std::string> PartialsPrefix{
+    "partials-prefix",
+    llvm::cl::desc("Write the merged evidence of each slot to the files "
+                   "<prefix>-NNNNN-of-MMMMM instead of running inference"),
+};
+llvm::cl::opt<unsigned> NumShards{
+    "shards",
+    llvm::cl::desc("Number of files to write with -partials-prefix"),
+    llvm::cl::init(1),
+};
+llvm::cl::opt<std::string> EvidenceTablePath{
+    "evidence-table",
+    llvm::cl::desc("Write the evidence to this file, as an EvidenceTable, "
+                   "instead of running inference"),
+};
+llvm::cl::list<std::string> PreviousNullable{
+    "previous-nullable",
+    llvm::cl::desc("SlotFingerprintSet files of slots inferred Nullable in a "
+                   "previous round, e.g. one per shard"),
+    llvm::cl::CommaSeparated,
+};
+llvm::cl::list<std::string> PreviousNonnull{
+    "previous-nonnull",
+    llvm::cl::desc("SlotFingerprintSet files of slots inferred Nonnull in a "
+                   "previous round, e.g. one per shard"),
+    llvm::cl::CommaSeparated,
+};
+llvm::cl::opt<unsigned> Jobs{
+    "j",
+    llvm::cl::desc("Analyze this many TUs in parallel, and infer from the "
+                   "evidence of all of them together"),
+    llvm::cl::init(1),
+};
+llvm::cl::opt<unsigned> ProfileFunctions{
+    "profile",
+    llvm::cl::desc("Diagnose each function, and print the analysis profiles "
+                   "of this many of the slowest ones"),
+    llvm::cl::init(0),
+};
 
 namespace clang::tidy::nullability {
 namespace {
@@ -178,6 +258,10 @@ struct DeclFilter {
   }
 
   bool checkLocation(SourceLocation Loc, const SourceManager &SM) const {
+    if (Ownership != nullptr) {
+      if (!OwnedFilter) OwnedFilter = getLocFilter(SM, *Ownership);
+      if (!OwnedFilter->check(Loc)) return false;
+    }
     if (!FileFilter.getNumOccurrences()) return true;
     auto ID = SM.getFileID(SM.getFileLoc(Loc));
     auto [It, Inserted] = FileCache.try_emplace(ID);
@@ -195,7 +279,11 @@ struct DeclFilter {
     return Pattern(ND.getQualifiedNameAsString());
   }
 
+  // Parsed from -ownership, if set.
+  static const FileOwnership *Ownership;
+
   mutable llvm::DenseMap<FileID, bool> FileCache;
+  mutable std::unique_ptr<LocFilter> OwnedFilter;
   struct RegexFlagFilter {
     RegexFlagFilter(llvm::StringRef Regex)
         : Negative(Regex.consume_front("-")), Pattern(Regex) {
@@ -213,6 +301,97 @@ struct DeclFilter {
   };
 };
 
+const FileOwnership *DeclFilter::Ownership = nullptr;
+
+// Opened from -previous-nullable and -previous-nonnull.
+std::vector<SlotFingerprintSet> &PreviousNullableSets =
+    *new std::vector<SlotFingerprintSet>();
+std::vector<SlotFingerprintSet> &PreviousNonnullSets =
+    *new std::vector<SlotFingerprintSet>();
+
+PreviousInferences previousInferences() {
+  return {.MappedNullable = PreviousNullableSets,
+          .MappedNonnull = PreviousNonnullSets};
+}
+
+// The merged evidence of the TUs analyzed with -j, and the inferences of the
+// previous round that their evidence is collected with.
+struct SharedPartials {
+  std::mutex Mu;
+  SlotPartialReducer Reducer;  // Guarded by Mu.
+  // Not modified while TUs are analyzed.
+  llvm::DenseSet<SlotFingerprint> Nullable;
+  llvm::DenseSet<SlotFingerprint> Nonnull;
+};
+// Set while TUs are analyzed with -j.
+SharedPartials *Shared = nullptr;
+
+// Counts of inferences by nullability, for -metrics.
+struct Metrics {
+  unsigned Nonnull = 0;
+  unsigned Nullable = 0;
+  unsigned Unknown = 0;
+  unsigned Conflict = 0;
+
+  void add(const SlotInference &SlotInference) {
+    if (SlotInference.conflict()) {
+      ++Conflict;
+      return;
+    }
+    switch (SlotInference.nullability()) {
+      case Nullability::NULLABLE:
+        ++Nullable;
+        break;
+      case Nullability::NONNULL:
+        ++Nonnull;
+        break;
+      case Nullability::UNKNOWN:
+        ++Unknown;
+        break;
+    }
+  }
+
+  void print() const {
+    llvm::outs() << "Inferred " << Nonnull + Nullable + Unknown + Conflict
+                 << " symbols\n";
+    llvm::outs() << "Nonnull: " << Nonnull << "\n";
+    llvm::outs() << "Nullable: " << Nullable << "\n";
+    llvm::outs() << "Unknown: " << Unknown << "\n";
+    llvm::outs() << "Conflicts: " << Conflict << "\n";
+    llvm::outs() << "Percent not Unknown and not Conflict: "
+                 << llvm::format("%0.2f", 100.0 * (Nonnull + Nullable) /
+                                              (Nonnull + Nullable + Unknown +
+                                               Conflict))
+                 << "%\n";
+  }
+};
+
+// Diagnoses the function definitions that pass `DeclFilter`, and prints the
+// analysis profiles of the `ProfileFunctions` slowest ones.
+void printSlowestFunctions(ASTContext &Ctx, const NullabilityPragmas &Pragmas) {
+  std::vector<std::pair<const FunctionDecl *, AnalysisProfile>> Profiles;
+  DeclFilter Filter;
+  for (const Decl *D : EvidenceSites::discover(Ctx).Definitions) {
+    const auto *Func = dyn_cast<FunctionDecl>(D);
+    if (Func == nullptr || !Filter(*Func)) continue;
+    AnalysisProfile Profile;
+    if (auto Diags = diagnosePointerNullability(
+            Func, Pragmas, makeDefaultSolverForDiagnosis, &Profile);
+        !Diags)
+      llvm::consumeError(Diags.takeError());
+    Profiles.push_back({Func, Profile});
+  }
+
+  llvm::sort(Profiles, [](const auto &L, const auto &R) {
+    return L.second.Time > R.second.Time;
+  });
+  if (Profiles.size() > ProfileFunctions) Profiles.resize(ProfileFunctions);
+  llvm::outs() << "Slowest functions:\n";
+  for (const auto &[Func, Profile] : Profiles)
+    llvm::outs() << Func->getQualifiedNameAsString() << ": " << Profile
+                 << "\n";
+}
+
 class Action : public SyntaxOnlyAction {
   NullabilityPragmas Pragmas;
 
@@ -229,6 +408,44 @@ class Action : public SyntaxOnlyAction {
           llvm::errs() << "An error has occurred; not running inference.\n";
           return;
         }
+        if (Shared != nullptr) {
+          std::vector<SlotPartialRecord> Partials = collectSlotPartials(
+              Ctx, Pragmas, DeclFilter(), makeDefaultSolverForInference,
+              {.Nullable = Shared->Nullable,
+               .Nonnull = Shared->Nonnull,
+               .MappedNullable = PreviousNullableSets,
+               .MappedNonnull = PreviousNonnullSets});
+          std::lock_guard<std::mutex> Lock(Shared->Mu);
+          for (SlotPartialRecord &R : Partials)
+            Shared->Reducer.add(std::move(R));
+          return;
+        }
+        if (EvidenceTablePath.getNumOccurrences()) {
+          llvm::errs() << "Collecting evidence...\n";
+          EvidenceTableBuilder Table;
+          collectTUEvidence(
+              Ctx, Pragmas, [&](const Evidence &E) { Table.add(E); },
+              DeclFilter(), makeDefaultSolverForInference,
+              previousInferences());
+          std::error_code EC;
+          llvm::raw_fd_ostream OS(EvidenceTablePath, EC);
+          if (!EC) OS << Table.take().SerializeAsString();
+          if (EC || OS.has_error())
+            llvm::errs() << "Error writing evidence: "
+                         << (EC ? EC : OS.error()).message() << "\n";
+          return;
+        }
+        if (PartialsPrefix.getNumOccurrences()) {
+          llvm::errs() << "Collecting evidence...\n";
+          if (auto Err = writeShards(
+                  collectSlotPartials(Ctx, Pragmas, DeclFilter(),
+                                      makeDefaultSolverForInference,
+                                      previousInferences()),
+                  PartialsPrefix, NumShards))
+            llvm::errs() << "Error writing partials: "
+                         << toString(std::move(Err)) << "\n";
+          return;
+        }
         llvm::errs() << "Running inference...\n";
 
         InferenceResults Results =
@@ -244,41 +461,13 @@ class Action : public SyntaxOnlyAction {
           }
         }
         if (PrintMetrics) {
-          unsigned Nonnull = 0;
-          unsigned Nullable = 0;
-          unsigned Unknown = 0;
-          unsigned Conflict = 0;
-          for (const auto &[_, InferencesBySlot] : Results) {
-            for (const auto &[Slot, SlotInference] : InferencesBySlot) {
-              if (SlotInference.conflict()) {
-                ++Conflict;
-                continue;
-              }
-              switch (SlotInference.nullability()) {
-                case Nullability::NULLABLE:
-                  ++Nullable;
-                  break;
-                case Nullability::NONNULL:
-                  ++Nonnull;
-                  break;
-                case Nullability::UNKNOWN:
-                  ++Unknown;
-                  break;
-              }
-            }
-          }
-          llvm::outs() << "Inferred " << Nonnull + Nullable + Unknown + Conflict
-                       << " symbols\n";
-          llvm::outs() << "Nonnull: " << Nonnull << "\n";
-          llvm::outs() << "Nullable: " << Nullable << "\n";
-          llvm::outs() << "Unknown: " << Unknown << "\n";
-          llvm::outs() << "Conflicts: " << Conflict << "\n";
-          llvm::outs() << "Percent not Unknown and not Conflict: "
-                       << llvm::format("%0.2f", 100.0 * (Nonnull + Nullable) /
-                                                    (Nonnull + Nullable +
-                                                     Unknown + Conflict))
-                       << "%\n";
+          Metrics M;
+          for (const auto &[_, InferencesBySlot] : Results)
+            for (const auto &[Slot, SlotInference] : InferencesBySlot)
+              M.add(SlotInference);
+          M.print();
         }
+        if (ProfileFunctions > 0) printSlowestFunctions(Ctx, Pragmas);
         if (Diagnostics)
           DiagnosticPrinter(std::move(Results), Ctx.getDiagnostics())
               .TraverseAST(Ctx);
@@ -299,33 +488,132 @@ class Action : public SyntaxOnlyAction {
   }
 };
 
+// The arguments that TUs are compiled with, in addition to their own.
+tooling::ArgumentsAdjuster extraArgs() {
+  return tooling::getInsertArgumentAdjuster(
+      {// Disable warnings, test cases are full of unused expressions etc.
+       "-w",
+       // Include the file containing macro replacements that enable
+       // additional inference.
+       "-include", std::string(ReplacementMacrosHeaderFileName),
+       // TODO: b/357760487 -- use the flag until the issue is resolved or
+       // we find a workaround.
+       "-Xclang", "-fretain-subst-template-type-parm-type-ast-nodes"},
+      tooling::ArgumentInsertPosition::BEGIN);
+}
+
+// For -j: analyzes `Files` in `Jobs` threads, each with its own ClangTool and
+// so its own ASTContexts, and infers from the merged evidence of all of them.
+// Each iteration reanalyzes all files, with the inferences of the previous
+// one.
+void inferInParallel(const tooling::CompilationDatabase &Compilations,
+                     llvm::ArrayRef<std::string> Files,
+                     llvm::StringRef MacroReplacementText) {
+  auto Start = std::chrono::steady_clock::now();
+  SharedPartials Partials;
+  Shared = &Partials;
+  std::atomic<unsigned> Failures = 0;
+  llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(Jobs));
+  std::vector<SlotPartialRecord> Merged;
+  for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration) {
+    for (const std::string &File : Files) {
+      Pool.async([&, File] {
+        tooling::ClangTool Tool(Compilations, File);
+        Tool.mapVirtualFile(ReplacementMacrosHeaderFileName,
+                            MacroReplacementText);
+        Tool.appendArgumentsAdjuster(extraArgs());
+        if (Tool.run(tooling::newFrontendActionFactory<Action>().get()))
+          ++Failures;
+      });
+    }
+    Pool.wait();
+    Merged = Partials.Reducer.take();
+    if (Iteration + 1 == Iterations) break;
+
+    Partials.Nullable.clear();
+    Partials.Nonnull.clear();
+    for (const SlotPartialRecord &Record : Merged) {
+      SlotInference Inference = finalize(Record.partial());
+      if (Inference.trivial() || Inference.conflict()) continue;
+      SlotFingerprint F = fingerprint(Record.symbol().usr(), Record.slot());
+      if (Inference.nullability() == Nullability::NULLABLE)
+        Partials.Nullable.insert(F);
+      else if (Inference.nullability() == Nullability::NONNULL)
+        Partials.Nonnull.insert(F);
+    }
+  }
+  Shared = nullptr;
+
+  double Seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - Start)
+                       .count();
+  llvm::errs() << "Analyzed " << Files.size() << " files ("
+               << Failures.load() << " failed) in "
+               << llvm::format("%0.2f", Seconds) << "s, "
+               << llvm::format("%0.1f", Files.size() * Iterations / Seconds)
+               << " files/s, " << Merged.size() << " slots\n";
+
+  Metrics M;
+  for (const SlotPartialRecord &Record : Merged) {
+    SlotInference Inference = finalize(Record.partial());
+    M.add(Inference);
+    if (!PrintProtos || (!IncludeTrivial && Inference.trivial())) continue;
+    llvm::outs() << "USR: " << Record.symbol().usr() << "\n";
+    llvm::outs() << "Slot: " << Record.slot() << "\n";
+    llvm::outs() << "Inference:\n" << absl::StrCat(Inference) << "\n";
+  }
+  if (PrintMetrics) M.print();
+}
+
 }  // namespace
 }  // namespace clang::tidy::nullability
 
 int main(int argc, absl::Nonnull<const char **> argv) {
   using namespace clang::tooling;
-  auto Exec = createExecutorFromCommandLineArgs(argc, argv, Opts);
-  QCHECK(Exec) << toString(Exec.takeError());
+  auto Options = CommonOptionsParser::create(argc, argv, Opts);
+  QCHECK(Options) << toString(Options.takeError());
 
   CHECK_EQ(ctn_replacement_macros_size(), 1);
   llvm::StringRef MacroReplacementText =
       ctn_replacement_macros_create()[0].data;
-  (*Exec)->mapVirtualFile(ReplacementMacrosHeaderFileName,
-                          MacroReplacementText);
 
   clang::tidy::nullability::enableSmartPointers(true);
 
-  auto Err = (*Exec)->execute(
+  if (OwnershipManifest.getNumOccurrences()) {
+    namespace nullability = clang::tidy::nullability;
+    auto Manifest = llvm::MemoryBuffer::getFile(OwnershipManifest);
+    QCHECK(Manifest) << OwnershipManifest << ": "
+                     << Manifest.getError().message();
+    auto Ownership =
+        nullability::FileOwnership::parse((*Manifest)->getBuffer());
+    QCHECK(Ownership) << toString(Ownership.takeError());
+    nullability::DeclFilter::Ownership =
+        new nullability::FileOwnership(std::move(*Ownership));
+  }
+  for (auto [Paths, Sets] :
+       {std::pair(&PreviousNullable,
+                  &clang::tidy::nullability::PreviousNullableSets),
+        std::pair(&PreviousNonnull,
+                  &clang::tidy::nullability::PreviousNonnullSets)}) {
+    for (const std::string &Path : *Paths) {
+      auto Set = clang::tidy::nullability::SlotFingerprintSet::open(Path);
+      QCHECK(Set) << toString(Set.takeError());
+      Sets->push_back(std::move(*Set));
+    }
+  }
+
+  if (Jobs > 1) {
+    clang::tidy::nullability::inferInParallel(Options->getCompilations(),
+                                              Options->getSourcePathList(),
+                                              MacroReplacementText);
+    return 0;
+  }
+
+  StandaloneToolExecutor Exec(Options->getCompilations(),
+                              Options->getSourcePathList());
+  Exec.mapVirtualFile(ReplacementMacrosHeaderFileName, MacroReplacementText);
+  auto Err = Exec.execute(
       newFrontendActionFactory<clang::tidy::nullability::Action>(),
-      getInsertArgumentAdjuster(
-          {// Disable warnings, test cases are full of unused expressions etc.
-           "-w",
-           // Include the file containing macro replacements that enable
-           // additional inference.
-           "-include", std::string(ReplacementMacrosHeaderFileName),
-           // TODO: b/357760487 -- use the flag until the issue is resolved or
-           // we find a workaround.
-           "-Xclang", "-fretain-subst-template-type-parm-type-ast-nodes"},
-          ArgumentInsertPosition::BEGIN));
+      clang::tidy::nullability::extraArgs());
   QCHECK(!Err) << toString(std::move(Err));
 }
@@ -631,6 +631,36 @@ TEST_F(InferTUTest, IterationsPropagateInferences) {
                     {inferredSlot(1, Nullability::NONNULL)})));
 }
 
+TEST_F(InferTUTest, IterationsStopOnceConverged) {
+  build(R"cc(
+    void takesToBeNonnull(int* X) { *X; }
+    int* returnsToBeNonnull(int* A) { return A; }
+    int* target(int* P, int* Q, int* R) {
+      *P;
+      takesToBeNonnull(Q);
+      Q = R;
+      return returnsToBeNonnull(P);
+    }
+    void unrelated(int* U) { *U; }
+  )cc");
+  auto AfterFourIterations = UnorderedElementsAre(
+      inference(hasName("target"), {inferredSlot(0, Nullability::NONNULL),
+                                    inferredSlot(1, Nullability::NONNULL),
+                                    inferredSlot(2, Nullability::NONNULL),
+                                    inferredSlot(3, Nullability::NONNULL)}),
+      inference(hasName("returnsToBeNonnull"),
+                {inferredSlot(0, Nullability::NONNULL),
+                 inferredSlot(1, Nullability::NONNULL)}),
+      inference(hasName("takesToBeNonnull"),
+                {inferredSlot(1, Nullability::NONNULL)}),
+      inference(hasName("unrelated"), {inferredSlot(1, Nullability::NONNULL)}));
+  EXPECT_THAT(inferTU(AST->context(), Pragmas, /*Iterations=*/4),
+              AfterFourIterations);
+  // The inferences have converged, so further iterations change nothing.
+  EXPECT_THAT(inferTU(AST->context(), Pragmas, /*Iterations=*/10),
+              AfterFourIterations);
+}
+
 TEST_F(InferTUTest, Pragma) {
   build(R"cc(
 #pragma nullability file_default nonnull
@@ -9,6 +9,7 @@
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/LLVM.h"
+#include "llvm/ADT/SmallBitVector.h"
 
 namespace clang::tidy::nullability {
 
@@ -88,4 +89,23 @@ bool isInferenceTarget(const Decl& D) {
   return false;
 }
 
+const InferableCache::Entry &InferableCache::get(const Decl &D) {
+  auto [It, Inserted] = Entries.try_emplace(&D);
+  if (!Inserted) return It->second;
+  Entry &E = It->second;
+  E.IsInferenceTarget = nullability::isInferenceTarget(D);
+  if (const auto *Func = dyn_cast<FunctionDecl>(&D)) {
+    E.InferableSlots.resize(Func->getNumParams() + 1);
+    if (hasInferable(Func->getReturnType())) E.InferableSlots.set(0);
+    for (unsigned I = 0; I < Func->getNumParams(); ++I)
+      if (hasInferable(Func->getParamDecl(I)->getType()))
+        E.InferableSlots.set(I + 1);
+  } else if (const auto *Field = dyn_cast<FieldDecl>(&D)) {
+    E.InferableSlots.resize(1, hasInferable(Field->getType()));
+  } else if (const auto *Var = dyn_cast<VarDecl>(&D)) {
+    E.InferableSlots.resize(1, hasInferable(Var->getType()));
+  }
+  return E;
+}
+
 }  // namespace clang::tidy::nullability
@@ -7,6 +7,8 @@
 
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/Type.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallBitVector.h"
 
 namespace clang::tidy::nullability {
 
@@ -22,6 +24,41 @@ bool isInferenceTarget(const Decl &);
 /// inner nullability, we may support only inferring outer.
 int countInferableSlots(const clang::Decl &);
 
+/// Memoizes `isInferenceTarget` and the inferable slots of declarations, which
+/// otherwise walk the declaration's type on every call.
+///
+/// Slots are numbered as in `Slot`: for functions, 0 is the return type and
+/// I + 1 is the I-th parameter, other declarations only have slot 0.
+///
+/// Results are stored per `Decl`, so a cache must only be used for decls of a
+/// single ASTContext, and must not outlive it.
+class InferableCache {
+ public:
+  bool isInferenceTarget(const Decl &D) { return get(D).IsInferenceTarget; }
+
+  /// Same as `countInferableSlots(D)`.
+  int countInferableSlots(const Decl &D) {
+    return get(D).InferableSlots.count();
+  }
+
+  /// Is slot `S` of `D` of a type where `hasInferable` is true? (This does
+  /// not check `isInferenceTarget(D)`.)
+  bool hasInferableSlot(const Decl &D, unsigned S) {
+    const llvm::SmallBitVector &Slots = get(D).InferableSlots;
+    return S < Slots.size() && Slots.test(S);
+  }
+
+ private:
+  struct Entry {
+    bool IsInferenceTarget = false;
+    llvm::SmallBitVector InferableSlots;
+  };
+
+  const Entry &get(const Decl &D);
+
+  llvm::DenseMap<const Decl *, Entry> Entries;
+};
+
 }  // namespace clang::tidy::nullability
 
 #endif  // THIRD_PARTY_CRUBIT_NULLABILITY_INFERENCE_INFERRABLE_H_
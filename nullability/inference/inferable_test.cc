@@ -329,5 +329,40 @@ TEST(InferableTest, CountInferableSlots) {
   EXPECT_EQ(0, countInferableSlots(lookup("h3", Ctx)));
 }
 
+TEST(InferableCacheTest, MatchesUncachedFunctions) {
+  TestAST AST((SmartPointerHeader + R"cc(
+                int *f(int, int *, std::unique_ptr<int>);
+                void g(int);
+                int *Global;
+                int NotPointer;
+                struct S {
+                  int *Field;
+                };
+              )cc")
+                  .str());
+  auto &Ctx = AST.context();
+  InferableCache Cache;
+
+  for (llvm::StringRef Name :
+       {"f", "g", "Global", "NotPointer", "Field"}) {
+    const Decl &D = lookup(Name, Ctx);
+    // Twice, to also check the cached results.
+    for (int I = 0; I < 2; ++I) {
+      EXPECT_EQ(Cache.isInferenceTarget(D), isInferenceTarget(D)) << Name;
+      EXPECT_EQ(Cache.countInferableSlots(D), countInferableSlots(D)) << Name;
+    }
+  }
+
+  const Decl &F = lookup("f", Ctx);
+  EXPECT_TRUE(Cache.hasInferableSlot(F, 0));
+  EXPECT_FALSE(Cache.hasInferableSlot(F, 1));
+  EXPECT_TRUE(Cache.hasInferableSlot(F, 2));
+  EXPECT_TRUE(Cache.hasInferableSlot(F, 3));
+  EXPECT_FALSE(Cache.hasInferableSlot(F, 4));
+  EXPECT_TRUE(Cache.hasInferableSlot(lookup("Global", Ctx), 0));
+  EXPECT_FALSE(Cache.hasInferableSlot(lookup("Global", Ctx), 1));
+  EXPECT_FALSE(Cache.hasInferableSlot(lookup("NotPointer", Ctx), 0));
+}
+
 }  // namespace
 }  // namespace clang::tidy::nullability
@@ -5,26 +5,107 @@
 #include "nullability/inference/merge.h"
 
 #include <array>
+#include <cstdint>
 #include <optional>
+#include <string>
+#include <tuple>
 #include <utility>
 
 #include "absl/log/check.h"
 #include "nullability/inference/inference.proto.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/xxhash.h"
 
 namespace clang::tidy::nullability {
 namespace {
 
-static void mergeSampleLocations(SlotPartial::SampleLocations &LHS,
-                                 const SlotPartial::SampleLocations &RHS) {
-  static constexpr unsigned Limit = 3;
-  // We don't care which we pick, but they should be unique.
-  // Multiple instantiations of the same template are not interesting.
-  for (const auto &Loc : RHS.location()) {
-    if (LHS.location_size() >= Limit) break;
-    // Linear scan is fine because Limit is tiny.
-    if (!llvm::is_contained(LHS.location(), Loc)) LHS.add_location(Loc);
+// We don't care which samples we pick, but they should be unique (multiple
+// instantiations of the same template are not interesting), and for merging to
+// be commutative and associative, they must not depend on the merge order.
+// So we keep the `SampleLimit` locations with the smallest hashes, and store
+// the hashes alongside them to avoid comparing or rehashing the strings.
+constexpr unsigned SampleLimit = 3;
+
+uint64_t locationHash(llvm::StringRef Location) {
+  return llvm::xxh3_64bits(Location);
+}
+
+// Partials that were not produced by this file (e.g. in tests) may lack the
+// hashes.
+uint64_t sampleHash(const SlotPartial::SampleLocations &Samples, int I) {
+  return Samples.location_hash_size() == Samples.location_size()
+             ? Samples.location_hash(I)
+             : locationHash(Samples.location(I));
+}
+
+void mergeSampleLocations(SlotPartial::SampleLocations &LHS,
+                          const SlotPartial::SampleLocations &RHS) {
+  llvm::SmallVector<std::pair<uint64_t, const std::string *>, 2 * SampleLimit>
+      Candidates;
+  for (int I = 0; I < LHS.location_size(); ++I)
+    Candidates.push_back({sampleHash(LHS, I), &LHS.location(I)});
+  for (int I = 0; I < RHS.location_size(); ++I)
+    Candidates.push_back({sampleHash(RHS, I), &RHS.location(I)});
+  llvm::sort(Candidates, [](const auto &L, const auto &R) {
+    return std::tie(L.first, *L.second) < std::tie(R.first, *R.second);
+  });
+  Candidates.erase(llvm::unique(Candidates,
+                                [](const auto &L, const auto &R) {
+                                  return L.first == R.first &&
+                                         *L.second == *R.second;
+                                }),
+                   Candidates.end());
+  if (Candidates.size() > SampleLimit) Candidates.resize(SampleLimit);
+
+  // Usually, a full LHS already has the samples to keep.
+  if (Candidates.size() == static_cast<size_t>(LHS.location_hash_size()) &&
+      llvm::all_of(llvm::enumerate(Candidates), [&](const auto &C) {
+        return C.value().second == &LHS.location(C.index());
+      }))
+    return;
+
+  SlotPartial::SampleLocations Merged;
+  for (const auto &[Hash, Location] : Candidates) {
+    Merged.add_location(*Location);
+    Merged.add_location_hash(Hash);
+  }
+  LHS = std::move(Merged);
+}
+
+// Equivalent to merging samples of just `Location` into `Samples`, but inserts
+// in place rather than rebuilding the samples.
+void addSampleLocation(SlotPartial::SampleLocations &Samples,
+                       llvm::StringRef Location) {
+  uint64_t Hash = locationHash(Location);
+  if (Samples.location_hash_size() != Samples.location_size()) {
+    SlotPartial::SampleLocations Single;
+    Single.add_location(Location.str());
+    Single.add_location_hash(Hash);
+    mergeSampleLocations(Samples, Single);
+    return;
+  }
+
+  int I = 0;
+  for (; I < Samples.location_size(); ++I) {
+    auto Existing = std::make_pair(Samples.location_hash(I),
+                                   llvm::StringRef(Samples.location(I)));
+    if (Existing == std::make_pair(Hash, Location)) return;
+    if (std::make_pair(Hash, Location) < Existing) break;
+  }
+  if (I >= static_cast<int>(SampleLimit)) return;
+
+  Samples.add_location(Location.str());
+  Samples.add_location_hash(Hash);
+  for (int J = Samples.location_size() - 1; J > I; --J) {
+    Samples.mutable_location()->SwapElements(J, J - 1);
+    Samples.mutable_location_hash()->SwapElements(J, J - 1);
+  }
+  if (Samples.location_size() > static_cast<int>(SampleLimit)) {
+    Samples.mutable_location()->RemoveLast();
+    Samples.mutable_location_hash()->RemoveLast();
   }
 }
 
@@ -32,10 +113,14 @@ static void mergeSampleLocations(SlotPartial::SampleLocations &LHS,
 
 SlotPartial partialFromEvidence(const Evidence &E) {
   SlotPartial P;
+  mergeEvidenceIntoPartial(P, E);
+  return P;
+}
+
+void mergeEvidenceIntoPartial(SlotPartial &P, const Evidence &E) {
   ++(*P.mutable_kind_count())[E.kind()];
   if (E.has_location())
-    (*P.mutable_kind_samples())[E.kind()].add_location(E.location());
-  return P;
+    addSampleLocation((*P.mutable_kind_samples())[E.kind()], E.location());
 }
 
 void mergePartials(SlotPartial &LHS, const SlotPartial &RHS) {
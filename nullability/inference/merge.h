@@ -20,6 +20,9 @@ namespace clang::tidy::nullability {
 
 // Build a SlotPartial representing a single piece of evidence.
 SlotPartial partialFromEvidence(const Evidence &);
+// Update P to include the evidence E. Equivalent to, but cheaper than,
+// `mergePartials(P, partialFromEvidence(E))`.
+void mergeEvidenceIntoPartial(SlotPartial &P, const Evidence &E);
 // Update LHS to include the evidence from RHS.
 // The merging of partials is commutative and associative.
 void mergePartials(SlotPartial &LHS, const SlotPartial &RHS);
@@ -42,8 +45,7 @@ InferResult infer(llvm::ArrayRef<unsigned> EventCounts);
 // all the evidence for a slot at once.
 inline SlotInference mergeEvidence(llvm::ArrayRef<Evidence> Ev) {
   SlotPartial P = partialFromEvidence(Ev.front());
-  for (const auto &E : Ev.drop_front())
-    mergePartials(P, partialFromEvidence(E));
+  for (const auto &E : Ev.drop_front()) mergeEvidenceIntoPartial(P, E);
   return finalize(P);
 }
 
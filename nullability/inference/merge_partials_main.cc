@@ -0,0 +1,101 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// merge_partials_main is the "reduce" phase of inference across a codebase.
+//
+// It merges the files of SlotPartialRecords given as arguments, which are
+// written by `infer_tu_main -partials-prefix`. All inputs should have the same
+// shard index, so that they hold all partials for the slots of that shard; only
+// those slots are held in memory.
+//
+// By default, it prints the finalized inference for each slot. With -output, it
+// instead writes the merged partials to a file, which can be merged again. This
+// allows reducing a shard in several steps, as merging is associative.
+//
+// With -nullable-set and -nonnull-set, it also writes the slots inferred
+// Nullable and Nonnull as SlotFingerprintSets, for the next round of
+// `infer_tu_main -previous-nullable -previous-nonnull`.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "nullability/inference/evidence_shards.h"
+#include "nullability/inference/inference.proto.h"
+#include "nullability/inference/merge.h"
+#include "nullability/inference/slot_fingerprint.h"
+#include "nullability/inference/slot_fingerprint_set.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+llvm::cl::list<std::string> Inputs{
+    llvm::cl::Positional,
+    llvm::cl::desc("<partials files>"),
+    llvm::cl::OneOrMore,
+};
+llvm::cl::opt<std::string> Output{
+    "output",
+    llvm::cl::desc("Write the merged partials to this file, instead of "
+                   "printing the finalized inferences"),
+};
+
+llvm::cl::opt<std::string> NullableSet{
+    "nullable-set",
+    llvm::cl::desc("Write the fingerprints of slots inferred Nullable here"),
+};
+llvm::cl::opt<std::string> NonnullSet{
+    "nonnull-set",
+    llvm::cl::desc("Write the fingerprints of slots inferred Nonnull here"),
+};
+
+int main(int argc, char **argv) {
+  using namespace clang::tidy::nullability;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  SlotPartialReducer Reducer;
+  for (const std::string &Input : Inputs) {
+    llvm::Error Err = readRecords(Input, [&](SlotPartialRecord Record) {
+      Reducer.add(std::move(Record));
+    });
+    QCHECK(!Err) << toString(std::move(Err));
+  }
+  llvm::errs() << "Merged " << Reducer.size() << " slots\n";
+  if (Reducer.collisions() > 0)
+    llvm::errs() << "Warning: " << Reducer.collisions()
+                 << " slots have colliding fingerprints\n";
+
+  if (Output.getNumOccurrences()) {
+    llvm::Error Err = writeRecords(Reducer.take(), Output);
+    QCHECK(!Err) << toString(std::move(Err));
+    return 0;
+  }
+  std::vector<SlotFingerprint> Nullable;
+  std::vector<SlotFingerprint> Nonnull;
+  for (const SlotPartialRecord &Record : Reducer.take()) {
+    SlotInference Inference = finalize(Record.partial());
+    llvm::outs() << "USR: " << Record.symbol().usr() << "\n";
+    llvm::outs() << "Slot: " << Record.slot() << "\n";
+    llvm::outs() << "Inference:\n" << absl::StrCat(Inference) << "\n";
+    // As in `inferTU`, only non-trivial inferences are propagated.
+    if (Inference.trivial() || Inference.conflict()) continue;
+    SlotFingerprint F = fingerprint(Record.symbol().usr(), Record.slot());
+    if (Inference.nullability() == Nullability::NULLABLE)
+      Nullable.push_back(F);
+    else if (Inference.nullability() == Nullability::NONNULL)
+      Nonnull.push_back(F);
+  }
+  if (NullableSet.getNumOccurrences()) {
+    llvm::Error Err =
+        SlotFingerprintSet::write(std::move(Nullable), NullableSet);
+    QCHECK(!Err) << toString(std::move(Err));
+  }
+  if (NonnullSet.getNumOccurrences()) {
+    llvm::Error Err = SlotFingerprintSet::write(std::move(Nonnull), NonnullSet);
+    QCHECK(!Err) << toString(std::move(Err));
+  }
+  return 0;
+}
@@ -5,11 +5,15 @@
 #include "nullability/inference/merge.h"
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "nullability/inference/inference.proto.h"
 #include "nullability/proto_matchers.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/xxhash.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googlemock/include/gmock/gmock.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
 #include "third_party/protobuf/text_format.h"
@@ -24,20 +28,29 @@ T proto(llvm::StringRef Text) {
   return Result;
 }
 
+// Returns the samples of the given locations, as stored in a SlotPartial.
+SlotPartial::SampleLocations samples(std::vector<std::string> Locations) {
+  llvm::sort(Locations, [](const std::string &L, const std::string &R) {
+    return llvm::xxh3_64bits(L) < llvm::xxh3_64bits(R);
+  });
+  SlotPartial::SampleLocations Result;
+  for (const std::string &Location : Locations) {
+    Result.add_location(Location);
+    Result.add_location_hash(llvm::xxh3_64bits(Location));
+  }
+  return Result;
+}
+
 TEST(PartialFromEvidenceTest, ContainsEvidenceInfo) {
+  auto Expected = proto<SlotPartial>(R"pb(kind_count { key: 3 value: 1 })pb");
+  (*Expected.mutable_kind_samples())[3] = samples({"foo.cc:42"});
   EXPECT_THAT(partialFromEvidence(proto<Evidence>(R"pb(
                 symbol { usr: "func" }
                 slot: 1
                 kind: UNCHECKED_DEREFERENCE
                 location: "foo.cc:42"
               )pb")),
-              EqualsProto(R"pb(
-                kind_count { key: 3 value: 1 }
-                kind_samples {
-                  key: 3
-                  value { location: "foo.cc:42" }
-                }
-              )pb"));
+              EqualsProto(Expected));
 }
 
 TEST(MergePartialsTest, BothContainEvidence) {
@@ -54,19 +67,56 @@ TEST(MergePartialsTest, BothContainEvidence) {
            kind_count { key: 0 value: 2 }
            kind_samples {
              key: 0
-             value { location: "c" location: "a" location: "d" }
+             value { location: "c" location: "a" }
            })pb");
 
   mergePartials(L, R);
-  EXPECT_THAT(L, EqualsProto(R"pb(
-                kind_count { key: 0 value: 4 }
-                kind_count { key: 2 value: 1 }
-                kind_count { key: 1 value: 1 }
-                kind_samples {
-                  key: 0
-                  value { location: "a" location: "b" location: "c" }
-                }
-              )pb"));
+  auto Expected = proto<SlotPartial>(R"pb(
+    kind_count { key: 0 value: 4 }
+    kind_count { key: 2 value: 1 }
+    kind_count { key: 1 value: 1 }
+  )pb");
+  (*Expected.mutable_kind_samples())[0] = samples({"a", "b", "c"});
+  EXPECT_THAT(L, EqualsProto(Expected));
+}
+
+TEST(MergePartialsTest, SamplesAreBoundedAndIndependentOfOrder) {
+  std::vector<SlotPartial> Partials;
+  for (const char *Location : {"a", "b", "c", "d", "e"}) {
+    Evidence E;
+    E.set_kind(Evidence::UNCHECKED_DEREFERENCE);
+    E.set_location(Location);
+    Partials.push_back(partialFromEvidence(E));
+  }
+
+  SlotPartial Forward;
+  for (const SlotPartial &P : Partials) mergePartials(Forward, P);
+  SlotPartial Backward;
+  for (const SlotPartial &P : llvm::reverse(Partials))
+    mergePartials(Backward, P);
+  EXPECT_THAT(Forward, EqualsProto(Backward));
+  EXPECT_EQ(Forward.kind_samples().at(Evidence::UNCHECKED_DEREFERENCE)
+                .location_size(),
+            3);
+  EXPECT_EQ(Forward.kind_count().at(Evidence::UNCHECKED_DEREFERENCE), 5u);
+}
+
+TEST(MergeEvidenceIntoPartialTest, MatchesMergingPartials) {
+  SlotPartial Merged;
+  SlotPartial Added;
+  for (const char *Location : {"a", "b", "a", "c", "d", "e", "c"}) {
+    Evidence E;
+    E.set_kind(Evidence::UNCHECKED_DEREFERENCE);
+    E.set_location(Location);
+    mergePartials(Merged, partialFromEvidence(E));
+    mergeEvidenceIntoPartial(Added, E);
+    EXPECT_THAT(Added, EqualsProto(Merged));
+  }
+  Evidence NoLocation;
+  NoLocation.set_kind(Evidence::ANNOTATED_NONNULL);
+  mergePartials(Merged, partialFromEvidence(NoLocation));
+  mergeEvidenceIntoPartial(Added, NoLocation);
+  EXPECT_THAT(Added, EqualsProto(Merged));
 }
 
 TEST(MergePartialsTest, RightEmpty) {
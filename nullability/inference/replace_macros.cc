@@ -9,11 +9,9 @@
 
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Basic/SourceLocation.h"
-#include "clang/Basic/SourceManager.h"
 #include "clang/Lex/MacroInfo.h"
 #include "clang/Lex/PPCallbacks.h"
 #include "llvm/ADT/StringRef.h"
-#include "llvm/Support/Path.h"
 
 namespace clang::tidy::nullability {
 namespace {
@@ -26,41 +24,23 @@ namespace {
 inline constexpr std::string_view CopyPrefix = "__clang_tidy_nullability_";
 }  // namespace
 
-void ReplaceMacrosCallbacks::FileChanged(SourceLocation Loc,
-                                         FileChangeReason Reason,
-                                         SrcMgr::CharacteristicKind FileType,
-                                         FileID PrevFID) {
-  if (State == State::FinishedReplacementFile) return;
-  if (State == State::InReplacementFile && Reason == PPCallbacks::ExitFile) {
-    State = State::FinishedReplacementFile;
-    return;
-  }
-
-  if (Reason != PPCallbacks::EnterFile) return;
-
-  auto FileName = PP.getSourceManager().getFilename(Loc);
-  if (llvm::sys::path::remove_leading_dotslash(FileName) ==
-      ReplacementMacrosHeaderFileName) {
-    State = State::InReplacementFile;
-  }
-}
-
 void ReplaceMacrosCallbacks::MacroDefined(const clang::Token &MacroNameTok,
                                           const clang::MacroDirective *MD) {
   auto *IIForCurrentMacro = MacroNameTok.getIdentifierInfo();
   assert(IIForCurrentMacro);
 
-  if (State == State::InReplacementFile) {
-    // The only macros in this file are the replacements, the copies of original
-    // definitions, and the header guard.
-    if (!IIForCurrentMacro->getName().starts_with(CopyPrefix)) {
-      // Replacements are seen before the original definitions, so cache the
-      // replacements for lookup later when we see the originals.
-
-      // Unnecessary for the header guard, but not a problem, so don't bother
-      // filtering.
-      Replacements.insert({IIForCurrentMacro, MD});
-    }
+  clang::IdentifierInfo *PrevII = LastDefinedII;
+  const clang::MacroDirective *PrevMD = LastDefinedMD;
+  LastDefinedII = IIForCurrentMacro;
+  LastDefinedMD = MD;
+
+  llvm::StringRef Name = IIForCurrentMacro->getName();
+  if (PrevII != nullptr && Name.starts_with(CopyPrefix) &&
+      Name.substr(CopyPrefix.size()) == PrevII->getName()) {
+    // `PrevII` is a replacement: it is directly followed by its (empty) copy.
+    // Replacements are seen before the original definitions, so cache the
+    // replacements for lookup later when we see the originals.
+    Replacements.insert({PrevII, PrevMD});
     return;
   }
 
@@ -27,6 +27,14 @@ namespace clang::tidy::nullability {
 inline constexpr llvm::StringRef ReplacementMacrosHeaderFileName =
     "clang_tidy_nullability_replacement_macros.h";
 
+// Replaces the definitions of macros with the definitions from the
+// replacement macros header (or from any other source that defines the
+// replacements in the same format: each replacement directly followed by an
+// empty definition of its copy).
+//
+// Replacements are recognized by the copy that follows them rather than by the
+// file they are in, so this doesn't need to track which file the preprocessor
+// is in. This does all the work in the single preprocessing pass of the TU.
 class ReplaceMacrosCallbacks : public clang::PPCallbacks {
  public:
   explicit ReplaceMacrosCallbacks(clang::Preprocessor &PP) : PP(PP) {}
@@ -36,19 +44,13 @@ class ReplaceMacrosCallbacks : public clang::PPCallbacks {
   llvm::DenseMap<clang::IdentifierInfo *, const clang::MacroDirective *>
       Replacements;
 
-  enum class State {
-    HaveNotSeenReplacementFile,
-    InReplacementFile,
-    FinishedReplacementFile,
-  };
-  State State = State::HaveNotSeenReplacementFile;
+  // The macro defined most recently, which is a replacement if the next macro
+  // defined is its copy.
+  clang::IdentifierInfo *LastDefinedII = nullptr;
+  const clang::MacroDirective *LastDefinedMD = nullptr;
 
   void MacroDefined(const clang::Token &MacroNameTok,
                     const clang::MacroDirective *MD) override;
-
-  void FileChanged(SourceLocation Loc, FileChangeReason Reason,
-                   SrcMgr::CharacteristicKind FileType,
-                   FileID PrevFID) override;
 };
 
 class ReplaceMacrosAction : public clang::ASTFrontendAction {
@@ -92,6 +92,36 @@ TEST(ReplaceMacrosAction, ReplacesCHECK_NE) {
       AST.context(), Expr::NPC_ValueDependentIsNotNull));
 }
 
+TEST(ReplaceMacrosAction, ReplacesFromAnyFileInReplacementFormat) {
+  static constexpr std::string_view Source = R"cc(
+#define CHECK(x) \
+      if (!x) __builtin_abort();
+
+    void foo() { CHECK(nullptr); }
+  )cc";
+  clang::TestInputs Inputs = Source;
+  Inputs.ExtraFiles["other_name.h"] = R"cc(
+    template <typename T>
+    T&& clang_tidy_nullability_internal_abortIfFalse(T&& Arg) {
+      return static_cast<T&&>(Arg);
+    }
+#define CHECK(x)                  \
+      __clang_tidy_nullability_CHECK( \
+          clang_tidy_nullability_internal_abortIfFalse(x))
+#define __clang_tidy_nullability_CHECK(x)
+  )cc";
+  Inputs.ExtraArgs = {"-include", "other_name.h", "-Wno-macro-redefined"};
+  Inputs.MakeAction = []() { return std::make_unique<ReplaceMacrosAction>(); };
+  clang::TestAST AST(Inputs);
+
+  EXPECT_THAT(selectFirst<CallExpr>(
+                  "call", match(callExpr(hasDeclaration(functionDecl(
+                                             hasName(ArgCaptureAbortIfFalse))))
+                                    .bind("call"),
+                                AST.context())),
+              NotNull());
+}
+
 TEST(ReplaceMacrosAction, DoesNotReplaceMacroNotInReplacementFile) {
   static constexpr std::string_view Source = R"cc(
 #define TOTALLY_MADE_UP_CHECK_THAT_IS_NOT_IN_REPLACEMENT_FILE(x) \
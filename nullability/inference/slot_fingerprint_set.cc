@@ -0,0 +1,78 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/slot_fingerprint_set.h"
+
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "nullability/inference/slot_fingerprint.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace clang::tidy::nullability {
+
+// The file is `Magic`, followed by the number of fingerprints and the sorted
+// fingerprints, each as a 64-bit little-endian integer.
+static constexpr llvm::StringLiteral Magic = "SLOTFPS1";
+static constexpr size_t HeaderSize = Magic.size() + sizeof(uint64_t);
+
+llvm::Error SlotFingerprintSet::write(std::vector<SlotFingerprint> Fingerprints,
+                                      llvm::StringRef Path) {
+  llvm::sort(Fingerprints);
+  Fingerprints.erase(llvm::unique(Fingerprints), Fingerprints.end());
+
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC);
+  if (EC) return llvm::createFileError(Path, EC);
+  llvm::support::endian::Writer Writer(OS, llvm::endianness::little);
+  OS << Magic;
+  Writer.write<uint64_t>(Fingerprints.size());
+  for (SlotFingerprint F : Fingerprints) Writer.write<uint64_t>(F);
+  OS.close();
+  if (OS.has_error()) return llvm::createFileError(Path, OS.error());
+  return llvm::Error::success();
+}
+
+llvm::Expected<SlotFingerprintSet> SlotFingerprintSet::open(
+    llvm::StringRef Path) {
+  auto Buffer = llvm::MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!Buffer) return llvm::createFileError(Path, Buffer.getError());
+  llvm::StringRef Data = (*Buffer)->getBuffer();
+  if (Data.size() < HeaderSize || !Data.starts_with(Magic))
+    return llvm::createFileError(Path, llvm::inconvertibleErrorCode(),
+                                 "not a slot fingerprint set");
+  uint64_t Size = llvm::support::endian::read64le(Data.data() + Magic.size());
+  if ((Data.size() - HeaderSize) / sizeof(uint64_t) != Size ||
+      (Data.size() - HeaderSize) % sizeof(uint64_t) != 0)
+    return llvm::createFileError(Path, llvm::inconvertibleErrorCode(),
+                                 "truncated slot fingerprint set");
+  return SlotFingerprintSet(std::move(*Buffer));
+}
+
+SlotFingerprintSet::SlotFingerprintSet(
+    std::unique_ptr<llvm::MemoryBuffer> Buffer)
+    : Buffer(std::move(Buffer)) {
+  llvm::StringRef Data = this->Buffer->getBuffer().drop_front(HeaderSize);
+  Sorted = llvm::ArrayRef(
+      reinterpret_cast<const llvm::support::ulittle64_t *>(Data.data()),
+      Data.size() / sizeof(uint64_t));
+}
+
+bool SlotFingerprintSet::contains(SlotFingerprint F) const {
+  auto It = llvm::partition_point(
+      Sorted, [F](llvm::support::ulittle64_t X) { return X < F; });
+  return It != Sorted.end() && *It == F;
+}
+
+}  // namespace clang::tidy::nullability
@@ -0,0 +1,51 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// A file format for sets of SlotFingerprints, e.g. the slots inferred Nullable
+// in a round of inference across the codebase, which workers of the next round
+// can memory-map instead of deserializing.
+
+#ifndef CRUBIT_NULLABILITY_INFERENCE_SLOT_FINGERPRINT_SET_H_
+#define CRUBIT_NULLABILITY_INFERENCE_SLOT_FINGERPRINT_SET_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "nullability/inference/slot_fingerprint.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace clang::tidy::nullability {
+
+// An immutable set of SlotFingerprints, backed by a file that holds them as a
+// sorted array. Opening the file maps it into memory, and lookups are binary
+// searches within the mapping.
+class SlotFingerprintSet {
+ public:
+  // Writes the set of `Fingerprints`, which may be in any order and contain
+  // duplicates, to the file `Path`.
+  static llvm::Error write(std::vector<SlotFingerprint> Fingerprints,
+                           llvm::StringRef Path);
+
+  static llvm::Expected<SlotFingerprintSet> open(llvm::StringRef Path);
+
+  bool contains(SlotFingerprint) const;
+  size_t size() const { return Sorted.size(); }
+  bool empty() const { return Sorted.empty(); }
+
+ private:
+  explicit SlotFingerprintSet(std::unique_ptr<llvm::MemoryBuffer> Buffer);
+
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  // The mapping need not be aligned for uint64_t.
+  llvm::ArrayRef<llvm::support::ulittle64_t> Sorted;
+};
+
+}  // namespace clang::tidy::nullability
+
+#endif  // CRUBIT_NULLABILITY_INFERENCE_SLOT_FINGERPRINT_SET_H_
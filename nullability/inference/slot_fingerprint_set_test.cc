@@ -0,0 +1,80 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/inference/slot_fingerprint_set.h"
+
+#include <string>
+#include <system_error>
+
+#include "nullability/inference/slot_fingerprint.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
+
+namespace clang::tidy::nullability {
+namespace {
+
+class SlotFingerprintSetTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(
+        "slot_fingerprint_set_test", Dir));
+  }
+  void TearDown() override { llvm::sys::fs::remove_directories(Dir); }
+
+  std::string path(llvm::StringRef Name) {
+    llvm::SmallString<256> Result = Dir;
+    llvm::sys::path::append(Result, Name);
+    return std::string(Result);
+  }
+
+  llvm::SmallString<256> Dir;
+};
+
+TEST_F(SlotFingerprintSetTest, Contains) {
+  SlotFingerprint A = fingerprint("c:@F@a#", 0);
+  SlotFingerprint B = fingerprint("c:@F@b#", 1);
+  SlotFingerprint C = fingerprint("c:@F@c#", 2);
+  ASSERT_THAT_ERROR(SlotFingerprintSet::write({C, A, C}, path("set")),
+                    llvm::Succeeded());
+
+  llvm::Expected<SlotFingerprintSet> Set =
+      SlotFingerprintSet::open(path("set"));
+  ASSERT_THAT_EXPECTED(Set, llvm::Succeeded());
+  EXPECT_EQ(Set->size(), 2u);
+  EXPECT_TRUE(Set->contains(A));
+  EXPECT_FALSE(Set->contains(B));
+  EXPECT_TRUE(Set->contains(C));
+}
+
+TEST_F(SlotFingerprintSetTest, Empty) {
+  ASSERT_THAT_ERROR(SlotFingerprintSet::write({}, path("set")),
+                    llvm::Succeeded());
+  llvm::Expected<SlotFingerprintSet> Set =
+      SlotFingerprintSet::open(path("set"));
+  ASSERT_THAT_EXPECTED(Set, llvm::Succeeded());
+  EXPECT_TRUE(Set->empty());
+  EXPECT_FALSE(Set->contains(fingerprint("c:@F@a#", 0)));
+}
+
+TEST_F(SlotFingerprintSetTest, OpenInvalidFile) {
+  EXPECT_THAT_EXPECTED(SlotFingerprintSet::open(path("missing")),
+                       llvm::Failed());
+
+  std::error_code EC;
+  {
+    llvm::raw_fd_ostream OS(path("bad"), EC);
+    ASSERT_FALSE(EC);
+    OS << "not a set";
+  }
+  EXPECT_THAT_EXPECTED(SlotFingerprintSet::open(path("bad")), llvm::Failed());
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
@@ -12,12 +12,23 @@
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/Path.h"
 
 namespace clang::tidy::nullability {
 namespace {
 
+// Normalizes paths from the manifest and from the SourceManager, which may
+// differ in e.g. a leading "./".
+std::string normalize(llvm::StringRef Path) {
+  llvm::SmallString<128> Result = Path;
+  llvm::sys::path::remove_dots(Result, /*remove_dot_dot=*/true);
+  return std::string(Result);
+}
+
 // A filter for SourceLocations that restricts to those in the main file or its
 // associated header.
 class InMainFileOrHeader : public LocFilter {
@@ -53,24 +64,75 @@ class InMainFileOrHeader : public LocFilter {
   bool check(SourceLocation Loc) override {
     if (Loc.isInvalid()) return false;
 
-    if (SM.isInMainFile(Loc)) {
-      return true;
-    }
-
     auto FileID = SM.getFileID(Loc);
     if (FileID.isInvalid()) return false;
 
-    // Insert true (arbitrarily chosen over false) to avoid pre-computing the
-    // result for cache hits. This does not overwrite the existing value for
-    // cache hits.
-    auto [It, Inserted] = IsMainFileOrHeaderCache.try_emplace(FileID, true);
+    if (auto It = IsMainFileOrHeaderCache.find(FileID);
+        It != IsMainFileOrHeaderCache.end())
+      return It->second;
+
+    // Compare the directory and the stem, but not the file extension, to
+    // allow matches for the main implementation file and the associated
+    // header.
+    bool Result = SM.isInMainFile(Loc) || isMainFileOrHeader(FileID);
+
+    // `isInMainFile` looks at the expansion location, which is in the same
+    // file for all locations with the same FileID (also for macro
+    // expansions). Only line directives can make the result differ between
+    // locations in the same file, so those files are not memoized.
+    const SrcMgr::SLocEntry &ExpansionEntry =
+        SM.getSLocEntry(SM.getFileID(SM.getExpansionLoc(Loc)));
+    if (!ExpansionEntry.isFile() ||
+        !ExpansionEntry.getFile().hasLineDirectives())
+      IsMainFileOrHeaderCache.insert({FileID, Result});
+
+    return Result;
+  }
+};
+
+// A filter for SourceLocations that restricts to those in files owned by the
+// main file's TU.
+class InOwnedFile : public LocFilter {
+ private:
+  const SourceManager &SM;
+  const FileOwnership &Ownership;
+  std::string MainFileName;
+  llvm::DenseMap<FileID, bool> IsOwnedCache;
+
+ public:
+  InOwnedFile(const SourceManager &SM, const FileOwnership &Ownership)
+      : SM(SM), Ownership(Ownership) {
+    OptionalFileEntryRef MainFile =
+        SM.getFileEntryRefForID(SM.getMainFileID());
+    CHECK(MainFile) << "Unable to compute main file for filtering.";
+    MainFileName = normalize(MainFile->getName());
+  }
+
+  bool check(SourceLocation Loc) override {
+    if (Loc.isInvalid()) return false;
+    // The file location only depends on the FileID of `Loc` (which may be a
+    // macro expansion), so the result is memoized for that FileID as well as
+    // for the FileID of the file location.
+    FileID LocID = SM.getFileID(Loc);
+    if (LocID.isInvalid()) return false;
+    if (auto It = IsOwnedCache.find(LocID); It != IsOwnedCache.end())
+      return It->second;
+    bool Result = isOwned(SM.getFileID(SM.getFileLoc(Loc)));
+    IsOwnedCache.insert({LocID, Result});
+    return Result;
+  }
+
+ private:
+  bool isOwned(FileID ID) {
+    if (ID.isInvalid()) return false;
+    auto [It, Inserted] = IsOwnedCache.try_emplace(ID, true);
     if (Inserted) {
-      // Compare the directory and the stem, but not the file extension, to
-      // allow matches for the main implementation file and the associated
-      // header.
-      It->second = isMainFileOrHeader(FileID);
+      // Locations without a file (e.g. builtins) are owned by every TU, like
+      // files that are not in the manifest.
+      OptionalFileEntryRef File = SM.getFileEntryRefForID(ID);
+      It->second =
+          !File || Ownership.owns(MainFileName, normalize(File->getName()));
     }
-
     return It->second;
   }
 };
@@ -82,6 +144,39 @@ class NoOpFilter : public LocFilter {
 
 }  // namespace
 
+llvm::Expected<FileOwnership> FileOwnership::parse(llvm::StringRef Manifest) {
+  FileOwnership Result;
+  unsigned LineNumber = 0;
+  for (llvm::StringRef Line : llvm::split(Manifest, '\n')) {
+    ++LineNumber;
+    Line = Line.trim();
+    if (Line.empty() || Line.starts_with("#")) continue;
+    auto [File, Owner] = Line.split(' ');
+    Owner = Owner.trim();
+    if (File.empty() || Owner.empty() || Owner.contains(' '))
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "malformed ownership line %u: %s",
+                                     LineNumber, Line.str().c_str());
+    auto [It, Inserted] =
+        Result.OwnerByFile.try_emplace(normalize(File), normalize(Owner));
+    if (!Inserted && It->second != normalize(Owner))
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "%s has more than one owner",
+                                     File.str().c_str());
+  }
+  return Result;
+}
+
+bool FileOwnership::owns(llvm::StringRef MainFile, llvm::StringRef File) const {
+  auto It = OwnerByFile.find(File);
+  return It == OwnerByFile.end() || It->second == MainFile;
+}
+
+std::unique_ptr<LocFilter> getLocFilter(const SourceManager &SM,
+                                        const FileOwnership &Ownership) {
+  return std::make_unique<InOwnedFile>(SM, Ownership);
+}
+
 std::unique_ptr<LocFilter> getLocFilter(const SourceManager &SM,
                                         bool RestrictToMainFileOrHeader) {
   if (RestrictToMainFileOrHeader) {
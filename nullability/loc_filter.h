@@ -6,18 +6,36 @@
 #define CRUBIT_NULLABILITY_LOC_FILTER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "clang/AST/DeclBase.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
 
 namespace clang::tidy::nullability {
 
 // An interface for filtering SourceLocations.
+//
+// The filters returned by `getLocFilter` memoize their decisions per `FileID`
+// (including the FileIDs of macro expansions), so that checking a location
+// costs little more than looking up its FileID.
 class LocFilter {
  public:
   virtual ~LocFilter() = default;
   virtual bool check(SourceLocation Loc) = 0;
+
+  // Returns the result of `check` for each of `Locs`, in order.
+  std::vector<bool> checkAll(llvm::ArrayRef<SourceLocation> Locs) {
+    std::vector<bool> Results;
+    Results.reserve(Locs.size());
+    for (SourceLocation Loc : Locs) Results.push_back(check(Loc));
+    return Results;
+  }
 };
 
 // Returns a LocFilter that does or does not restrict to the main file or its
@@ -25,6 +43,28 @@ class LocFilter {
 std::unique_ptr<LocFilter> getLocFilter(const SourceManager &SM,
                                         bool RestrictToMainFileOrHeader);
 
+// Assigns files to the single TU that is responsible for analyzing them, so
+// that a header included by many TUs is analyzed once across the build.
+class FileOwnership {
+ public:
+  // Parses a manifest with a line "<file> <main file of owning TU>" for each
+  // owned file. Blank lines and lines starting with # are ignored.
+  static llvm::Expected<FileOwnership> parse(llvm::StringRef Manifest);
+
+  // Returns whether the TU with the main file `MainFile` owns `File`.
+  // Files that are not in the manifest are owned by every TU that includes
+  // them.
+  bool owns(llvm::StringRef MainFile, llvm::StringRef File) const;
+
+ private:
+  llvm::StringMap<std::string> OwnerByFile;
+};
+
+// Returns a LocFilter that restricts to locations in files that are owned by
+// the TU of `SM`, per `Ownership`, which must outlive the filter.
+std::unique_ptr<LocFilter> getLocFilter(const SourceManager &SM,
+                                        const FileOwnership &Ownership);
+
 }  // namespace clang::tidy::nullability
 
 #endif  // CRUBIT_NULLABILITY_LOC_FILTER_H_
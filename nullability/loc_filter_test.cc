@@ -6,12 +6,16 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Basic/SourceLocation.h"
 #include "clang/Testing/TestAST.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
 
 namespace clang::tidy::nullability {
@@ -87,5 +91,82 @@ TEST(MaybeRestrictToMainFileOrHeaderWalkerTest, Restrict) {
           ->getBeginLoc()));
 }
 
+TEST(getLocFilterTest, RestrictMacroExpansionsAndCheckAll) {
+  TestInputs Inputs;
+  Inputs.Code = R"cc(
+#include "input.h"
+#include "not_input.h"
+    DECLARE(func)
+    DECLARE(other_func)
+  )cc";
+  Inputs.ExtraFiles = {{"input.h", R"cc(
+                          void input_header_func();)cc"},
+                       {"not_input.h", R"cc(
+#define DECLARE(name) void name();
+                          DECLARE(not_input_header_func)
+                        )cc"}};
+  TestAST AST(Inputs);
+  auto Loc = [&](llvm::StringRef Name) {
+    return selectFirst<FunctionDecl>(
+               "f", match(functionDecl(hasName(Name)).bind("f"), AST.context()))
+        ->getBeginLoc();
+  };
+
+  std::unique_ptr<LocFilter> Filter =
+      getLocFilter(AST.context().getSourceManager(),
+                   /*RestrictToMainFileOrHeader=*/true);
+  // Macros are attributed to where they are expanded, also when the decision
+  // for the file of the expansion is already memoized.
+  EXPECT_TRUE(Filter->check(Loc("func")));
+  EXPECT_FALSE(Filter->check(Loc("not_input_header_func")));
+  EXPECT_TRUE(Filter->check(Loc("other_func")));
+  EXPECT_EQ(Filter->checkAll({Loc("func"), Loc("input_header_func"),
+                              Loc("not_input_header_func"), SourceLocation()}),
+            std::vector<bool>({true, true, false, false}));
+}
+
+TEST(getLocFilterTest, Ownership) {
+  TestInputs Inputs;
+  Inputs.Code = R"cc(
+#include "owned.h"
+#include "not_owned.h"
+#include "unlisted.h"
+    void func();
+  )cc";
+  Inputs.ExtraFiles = {{"owned.h", "void owned_func();"},
+                       {"not_owned.h", "void not_owned_func();"},
+                       {"unlisted.h", "void unlisted_func();"}};
+  TestAST AST(Inputs);
+  auto Loc = [&](llvm::StringRef Name) {
+    return selectFirst<FunctionDecl>(
+               "f", match(functionDecl(hasName(Name)).bind("f"), AST.context()))
+        ->getBeginLoc();
+  };
+
+  llvm::Expected<FileOwnership> Ownership = FileOwnership::parse(R"(
+    # Comments and blank lines are ignored.
+
+    owned.h input.cc
+    ./not_owned.h other.cc
+  )");
+  ASSERT_TRUE(static_cast<bool>(Ownership))
+      << llvm::toString(Ownership.takeError());
+  std::unique_ptr<LocFilter> Filter =
+      getLocFilter(AST.context().getSourceManager(), *Ownership);
+  EXPECT_TRUE(Filter->check(Loc("func")));
+  EXPECT_TRUE(Filter->check(Loc("owned_func")));
+  EXPECT_FALSE(Filter->check(Loc("not_owned_func")));
+  EXPECT_TRUE(Filter->check(Loc("unlisted_func")));
+}
+
+TEST(FileOwnershipTest, ParseErrors) {
+  for (llvm::StringRef Manifest :
+       {"owned.h", "owned.h a.cc b.cc", "owned.h a.cc\nowned.h b.cc"}) {
+    llvm::Expected<FileOwnership> Ownership = FileOwnership::parse(Manifest);
+    EXPECT_FALSE(static_cast<bool>(Ownership)) << Manifest.str();
+    llvm::consumeError(Ownership.takeError());
+  }
+}
+
 }  // namespace
 }  // namespace clang::tidy::nullability
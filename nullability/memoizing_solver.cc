@@ -0,0 +1,41 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/memoizing_solver.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "nullability/pointer_nullability_analysis.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
+#include "clang/Analysis/FlowSensitive/Solver.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+
+namespace clang::tidy::nullability {
+
+dataflow::Solver::Result MemoizingSolver::solve(
+    llvm::ArrayRef<const dataflow::Formula *> Vals) {
+  std::vector<const dataflow::Formula *> Key(Vals.begin(), Vals.end());
+  llvm::sort(Key);
+  Key.erase(llvm::unique(Key), Key.end());
+  if (auto It = Results.find(Key); It != Results.end()) return It->second;
+
+  ++Misses;
+  Result R = Inner->solve(Vals);
+  // Timeouts depend on the remaining budget of the underlying solver rather
+  // than on the query, so they aren't remembered.
+  if (R.getStatus() != Result::Status::TimedOut)
+    Results.emplace(std::move(Key), R);
+  return R;
+}
+
+SolverFactory memoizingSolverFactory(SolverFactory MakeSolver) {
+  return [MakeSolver = std::move(MakeSolver)] {
+    return std::make_unique<MemoizingSolver>(MakeSolver());
+  };
+}
+
+}  // namespace clang::tidy::nullability
@@ -0,0 +1,60 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// A dataflow::Solver that remembers its results, for analyses that ask the
+// same question many times.
+
+#ifndef CRUBIT_NULLABILITY_MEMOIZING_SOLVER_H_
+#define CRUBIT_NULLABILITY_MEMOIZING_SOLVER_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "nullability/pointer_nullability_analysis.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
+#include "clang/Analysis/FlowSensitive/Solver.h"
+#include "llvm/ADT/ArrayRef.h"
+
+namespace clang::tidy::nullability {
+
+/// Forwards to another solver, and reuses its results for repeated queries.
+///
+/// The framework's Arena hash-conses formulas, so the same constraints always
+/// result in the same `Formula` pointers. Queries are keyed on the set of
+/// these pointers, which makes e.g. the flow condition of a block, conjoined
+/// with the same "is this pointer null?" question asked at several
+/// dereferences, a single call to the underlying solver.
+///
+/// As the keys are pointers, a MemoizingSolver must only be used with formulas
+/// from a single Arena, i.e. a single DataflowAnalysisContext. This is the
+/// case for the solvers created by a `SolverFactory` for each analysis.
+class MemoizingSolver : public dataflow::Solver {
+ public:
+  explicit MemoizingSolver(std::unique_ptr<dataflow::Solver> Inner)
+      : Inner(std::move(Inner)) {}
+
+  Result solve(llvm::ArrayRef<const dataflow::Formula *> Vals) override;
+
+  bool reachedLimit() const override { return Inner->reachedLimit(); }
+
+  /// The number of queries that were answered by the underlying solver.
+  size_t misses() const { return Misses; }
+
+ private:
+  std::unique_ptr<dataflow::Solver> Inner;
+  // Keyed on the sorted and deduplicated constraints.
+  absl::flat_hash_map<std::vector<const dataflow::Formula *>, Result> Results;
+  size_t Misses = 0;
+};
+
+/// Returns a factory for MemoizingSolvers that forward to solvers created by
+/// `MakeSolver`.
+SolverFactory memoizingSolverFactory(SolverFactory MakeSolver);
+
+}  // namespace clang::tidy::nullability
+
+#endif  // CRUBIT_NULLABILITY_MEMOIZING_SOLVER_H_
@@ -0,0 +1,71 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "nullability/memoizing_solver.h"
+
+#include <memory>
+
+#include "clang/Analysis/FlowSensitive/Arena.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
+#include "clang/Analysis/FlowSensitive/Solver.h"
+#include "clang/Analysis/FlowSensitive/WatchedLiteralsSolver.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
+
+namespace clang::tidy::nullability {
+namespace {
+using dataflow::Arena;
+using dataflow::Formula;
+using dataflow::Solver;
+using dataflow::WatchedLiteralsSolver;
+
+TEST(MemoizingSolverTest, ReusesResultsForTheSameConstraints) {
+  Arena A;
+  const Formula &X = A.makeAtomRef(A.makeAtom());
+  const Formula &Y = A.makeAtomRef(A.makeAtom());
+  const Formula &NotX = A.makeNot(X);
+  MemoizingSolver S(std::make_unique<WatchedLiteralsSolver>());
+
+  EXPECT_EQ(S.solve({&X, &Y}).getStatus(), Solver::Result::Status::Satisfiable);
+  EXPECT_EQ(S.misses(), 1u);
+  // The same constraints, in a different order and with duplicates.
+  EXPECT_EQ(S.solve({&Y, &X, &Y}).getStatus(),
+            Solver::Result::Status::Satisfiable);
+  EXPECT_EQ(S.misses(), 1u);
+  // Hash-consing gives equal formulas the same identity.
+  EXPECT_EQ(S.solve({&A.makeAnd(X, Y)}).getStatus(),
+            Solver::Result::Status::Satisfiable);
+  EXPECT_EQ(S.solve({&A.makeAnd(X, Y)}).getStatus(),
+            Solver::Result::Status::Satisfiable);
+  EXPECT_EQ(S.misses(), 2u);
+
+  EXPECT_EQ(S.solve({&X, &NotX}).getStatus(),
+            Solver::Result::Status::Unsatisfiable);
+  EXPECT_EQ(S.solve({&NotX, &X}).getStatus(),
+            Solver::Result::Status::Unsatisfiable);
+  EXPECT_EQ(S.misses(), 3u);
+}
+
+// A solver that runs out of budget for every query.
+class TimingOutSolver : public Solver {
+ public:
+  Result solve(llvm::ArrayRef<const Formula *>) override {
+    return Result::TimedOut();
+  }
+  bool reachedLimit() const override { return true; }
+};
+
+TEST(MemoizingSolverTest, DoesNotRememberTimeouts) {
+  Arena A;
+  const Formula &X = A.makeAtomRef(A.makeAtom());
+  MemoizingSolver S(std::make_unique<TimingOutSolver>());
+
+  EXPECT_EQ(S.solve({&X}).getStatus(), Solver::Result::Status::TimedOut);
+  EXPECT_EQ(S.solve({&X}).getStatus(), Solver::Result::Status::TimedOut);
+  EXPECT_EQ(S.misses(), 2u);
+  EXPECT_TRUE(S.reachedLimit());
+}
+
+}  // namespace
+}  // namespace clang::tidy::nullability
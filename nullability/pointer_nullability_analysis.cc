@@ -4,9 +4,13 @@
 
 #include "nullability/pointer_nullability_analysis.h"
 
+#include <array>
+#include <bitset>
 #include <cassert>
+#include <chrono>
 #include <deque>
 #include <functional>
+#include <initializer_list>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -50,6 +54,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace clang::tidy::nullability {
@@ -58,6 +63,7 @@ using ast_matchers::anyOf;
 using ast_matchers::MatchFinder;
 using dataflow::Arena;
 using dataflow::BoolValue;
+using dataflow::CFGMatchSwitch;
 using dataflow::CFGMatchSwitchBuilder;
 using dataflow::ComparisonResult;
 using dataflow::DataflowAnalysisContext;
@@ -76,8 +82,10 @@ using dataflow::WidenResult;
 namespace {
 
 TypeNullability prepend(NullabilityKind Head, const TypeNullability &Tail) {
-  TypeNullability Result = {Head};
-  Result.insert(Result.end(), Tail.begin(), Tail.end());
+  TypeNullability Result;
+  Result.reserve(Tail.size() + 1);
+  Result.push_back(Head);
+  Result.append(Tail.begin(), Tail.end());
   return Result;
 }
 
@@ -223,7 +231,8 @@ struct Resugarer {
         PointerCount += countPointersInType(TA);
       }
       unsigned SliceSize = countPointersInType(TemplateArgs[ArgIndex]);
-      return SpecializationNullability.slice(PointerCount, SliceSize).vec();
+      return TypeNullability(
+          SpecializationNullability.slice(PointerCount, SliceSize));
     }
   };
   llvm::SmallVector<FromEnclosingClassNullability> Enclosing;
@@ -446,18 +455,6 @@ void transferValue_NotNullPointer(
   }
 }
 
-bool isStdWeakPtrType(QualType Ty) {
-  const CXXRecordDecl *RD = Ty.getCanonicalType()->getAsCXXRecordDecl();
-  if (RD == nullptr) return false;
-
-  if (!RD->getDeclContext()->isStdNamespace()) return false;
-
-  const IdentifierInfo *ID = RD->getIdentifier();
-  if (ID == nullptr) return false;
-
-  return ID->getName() == "weak_ptr";
-}
-
 bool isPointerTypeConvertible(QualType From, QualType To) {
   assert(isSupportedRawPointerType(From));
   assert(isSupportedRawPointerType(To));
@@ -498,7 +495,8 @@ void transferValue_SmartPointerConstructor(
 
   // Copy or move from an existing smart pointer.
   if (Ctor->getNumArgs() >= 1 &&
-      isSupportedSmartPointerType(Ctor->getArg(0)->getType())) {
+      State.Lattice.smartPointerTypes().isSupportedSmartPointerType(
+          Ctor->getArg(0)->getType())) {
     auto *SrcLoc = Ctor->getArg(0)->isGLValue()
                        ? State.Env.get<RecordStorageLocation>(*Ctor->getArg(0))
                        : &State.Env.getResultObjectLocation(*Ctor->getArg(0));
@@ -524,7 +522,9 @@ void transferValue_SmartPointerConstructor(
 
   // Construct from `weak_ptr`. This throws if the `weak_ptr` is empty, so we
   // can assume the `shared_ptr` is non-null if the constructor returns.
-  if (Ctor->getNumArgs() == 1 && isStdWeakPtrType(Ctor->getArg(0)->getType()))
+  if (Ctor->getNumArgs() == 1 &&
+      State.Lattice.smartPointerTypes().isStdWeakPtrType(
+          Ctor->getArg(0)->getType()))
     setToPointerWithNullability(Loc.getSyntheticField(PtrField),
                                 NullabilityKind::NonNull, State.Env);
 }
@@ -540,7 +540,8 @@ void transferValue_SmartPointerAssignment(
     return;
   }
 
-  if (!isSupportedSmartPointerType(OpCall->getArg(1)->getType())) {
+  if (!State.Lattice.smartPointerTypes().isSupportedSmartPointerType(
+          OpCall->getArg(1)->getType())) {
     // We don't know anything about the RHS, so set the LHS to an unspecified
     // nullability state.
     // TODO(b/376231871): We could handle more RHS cases, for example if RHS
@@ -575,7 +576,8 @@ void transferValue_SmartPointerReleaseCall(
   // underlying pointer type (where `T` is the first template argument) is
   // incorrect.
   if (MCE->getType()->getCanonicalTypeUnqualified() !=
-      underlyingRawPointerType(MCE->getObjectType())
+      State.Lattice.smartPointerTypes()
+          .underlyingRawPointerType(MCE->getObjectType())
           ->getCanonicalTypeUnqualified()) {
     return;
   }
@@ -640,7 +642,8 @@ void transferValue_SmartPointerGetCall(
   // If the return type isn't what we expect, bail out.
   // See `transferValue_SmartPointerReleaseCall()` for more details.
   if (MCE->getType()->getCanonicalTypeUnqualified() !=
-      underlyingRawPointerType(MCE->getObjectType())
+      State.Lattice.smartPointerTypes()
+          .underlyingRawPointerType(MCE->getObjectType())
           ->getCanonicalTypeUnqualified()) {
     return;
   }
@@ -681,7 +684,8 @@ void transferValue_SmartPointerOperatorStar(
   QualType ReturnType = OpCall->getType();
   if (ReturnType->isReferenceType()) ReturnType = ReturnType->getPointeeType();
   if (ReturnType->getCanonicalTypeUnqualified() !=
-      underlyingRawPointerType(getReceiverIgnoringImpCastsType(OpCall))
+      State.Lattice.smartPointerTypes()
+          .underlyingRawPointerType(getReceiverIgnoringImpCastsType(OpCall))
           ->getPointeeType()
           ->getCanonicalTypeUnqualified()) {
     return;
@@ -697,7 +701,8 @@ void transferValue_SmartPointerOperatorArrow(
   // If the return type isn't what we expect, bail out.
   // See `transferValue_SmartPointerReleaseCall()` for more details.
   if (OpCall->getType()->getCanonicalTypeUnqualified() !=
-      underlyingRawPointerType(getReceiverIgnoringImpCastsType(OpCall))
+      State.Lattice.smartPointerTypes()
+          .underlyingRawPointerType(getReceiverIgnoringImpCastsType(OpCall))
           ->getCanonicalTypeUnqualified()) {
     return;
   }
@@ -1254,14 +1259,17 @@ void handleConstMemberCall(
   // Smart pointers are represented as RecordStorangeLocations, so their
   // treatment is different from booleans or raw pointers, which are
   // represented as Values.
-  if (RecordLoc != nullptr && isSupportedSmartPointerType(CE->getType())) {
+  SmartPointerTypeCache &SmartPointerTypes = State.Lattice.smartPointerTypes();
+  if (RecordLoc != nullptr &&
+      SmartPointerTypes.isSupportedSmartPointerType(CE->getType())) {
     StorageLocation *Loc =
         State.Lattice.getOrCreateConstMethodReturnStorageLocation(
             *RecordLoc, CE, State.Env, [&](StorageLocation &Loc) {
               setSmartPointerValue(
                   cast<RecordStorageLocation>(Loc),
                   cast<PointerValue>(State.Env.createValue(
-                      underlyingRawPointerType(CE->getType()))),
+                      SmartPointerTypes.underlyingRawPointerType(
+                          CE->getType()))),
                   State.Env);
             });
     if (Loc == nullptr) return;
@@ -1625,7 +1633,7 @@ void transferType_CallExpr(absl::Nonnull<const CallExpr *> CE,
     // Return value nullability is at the front of the function type.
     ResultNullability =
         ResultNullability.take_front(countPointersInType(CE->getType()));
-    return ResultNullability.vec();
+    return TypeNullability(ResultNullability);
   });
 }
 
@@ -1638,9 +1646,9 @@ void transferType_UnaryOperator(
         return prepend(NullabilityKind::NonNull,
                        getNullabilityForChild(UO->getSubExpr(), State));
       case UO_Deref:
-        return ArrayRef(getNullabilityForChild(UO->getSubExpr(), State))
-            .drop_front()
-            .vec();
+        return TypeNullability(
+            ArrayRef(getNullabilityForChild(UO->getSubExpr(), State))
+                .drop_front());
 
       case UO_PreInc:
       case UO_PreDec: {
@@ -1738,7 +1746,7 @@ void transferType_ArraySubscriptExpr(
     QualType BaseType = ASE->getBase()->getType();
     CHECK(isSupportedRawPointerType(BaseType) || BaseType->isVectorType());
     return isSupportedRawPointerType(BaseType)
-               ? ArrayRef(BaseNullability).slice(1).vec()
+               ? TypeNullability(ArrayRef(BaseNullability).slice(1))
                : BaseNullability;
   });
 }
@@ -1755,30 +1763,169 @@ void transferType_ThisExpr(absl::Nonnull<const CXXThisExpr *> TE,
   });
 }
 
+// The classes of statements that the transfer functions dispatch on. Each one
+// gets its own `CFGMatchSwitch`, which only contains the cases that can match
+// statements of that class, so that a statement isn't tried against the
+// matchers of all the other cases.
+enum StmtBucket : unsigned {
+  SB_DeclRefExpr,
+  SB_MemberExpr,
+  SB_ImplicitCastExpr,
+  // All `CastExpr`s other than `ImplicitCastExpr`s.
+  SB_OtherCastExpr,
+  SB_MaterializeTemporaryExpr,
+  SB_CXXBindTemporaryExpr,
+  SB_CXXMemberCallExpr,
+  SB_CXXOperatorCallExpr,
+  // All `CallExpr`s other than `CXXMemberCallExpr`s and `CXXOperatorCallExpr`s.
+  SB_OtherCallExpr,
+  // `UnaryOperator` and `BinaryOperator` include their subclasses.
+  SB_UnaryOperator,
+  SB_BinaryOperator,
+  SB_CXXNewExpr,
+  SB_ArraySubscriptExpr,
+  SB_CXXThisExpr,
+  SB_CXXScalarValueInitExpr,
+  SB_CXXConstructExpr,
+  // All other expressions of a supported raw pointer type. Other expressions
+  // (and statements that aren't expressions) aren't dispatched at all: none
+  // of the cases below can match them.
+  SB_OtherPointerExpr,
+  NumStmtBuckets,
+};
+
+using StmtBuckets = std::bitset<NumStmtBuckets>;
+
+StmtBuckets buckets(std::initializer_list<StmtBucket> List) {
+  StmtBuckets Result;
+  for (StmtBucket B : List) Result.set(B);
+  return Result;
+}
+
+StmtBuckets anyCall() {
+  return buckets(
+      {SB_CXXMemberCallExpr, SB_CXXOperatorCallExpr, SB_OtherCallExpr});
+}
+
+StmtBuckets anyExpr() { return StmtBuckets().set(); }
+
+std::optional<StmtBucket> getStmtBucket(const Stmt &S) {
+  switch (S.getStmtClass()) {
+    case Stmt::DeclRefExprClass:
+      return SB_DeclRefExpr;
+    case Stmt::MemberExprClass:
+      return SB_MemberExpr;
+    case Stmt::ImplicitCastExprClass:
+      return SB_ImplicitCastExpr;
+    case Stmt::MaterializeTemporaryExprClass:
+      return SB_MaterializeTemporaryExpr;
+    case Stmt::CXXBindTemporaryExprClass:
+      return SB_CXXBindTemporaryExpr;
+    case Stmt::CXXMemberCallExprClass:
+      return SB_CXXMemberCallExpr;
+    case Stmt::CXXOperatorCallExprClass:
+      return SB_CXXOperatorCallExpr;
+    case Stmt::CXXNewExprClass:
+      return SB_CXXNewExpr;
+    case Stmt::ArraySubscriptExprClass:
+      return SB_ArraySubscriptExpr;
+    case Stmt::CXXThisExprClass:
+      return SB_CXXThisExpr;
+    case Stmt::CXXScalarValueInitExprClass:
+      return SB_CXXScalarValueInitExpr;
+    default:
+      break;
+  }
+  if (isa<CastExpr>(S)) return SB_OtherCastExpr;
+  if (isa<CallExpr>(S)) return SB_OtherCallExpr;
+  if (isa<UnaryOperator>(S)) return SB_UnaryOperator;
+  if (isa<BinaryOperator>(S)) return SB_BinaryOperator;
+  if (isa<CXXConstructExpr>(S)) return SB_CXXConstructExpr;
+  if (const auto *E = dyn_cast<Expr>(&S);
+      E != nullptr && isSupportedRawPointerType(E->getType()))
+    return SB_OtherPointerExpr;
+  return std::nullopt;
+}
+
+// Like `CFGMatchSwitchBuilder`, but each case is only added to the switches of
+// the given `StmtBuckets`, and the built switch only tries the cases of the
+// bucket of the statement.
+//
+// This is equivalent to a `CFGMatchSwitch` with all the cases (in the same
+// order), as long as each case is added to all buckets of the statements that
+// its matcher can match.
+class BucketedCFGMatchSwitchBuilder {
+ public:
+  using State = TransferState<PointerNullabilityLattice>;
+
+  template <typename NodeT>
+  BucketedCFGMatchSwitchBuilder &&CaseOfCFGStmt(
+      const StmtBuckets &Buckets, dataflow::MatchSwitchMatcher<Stmt> M,
+      dataflow::MatchSwitchAction<NodeT, State> A) && {
+    for (unsigned B = 0; B < NumStmtBuckets; ++B) {
+      if (!Buckets.test(B)) continue;
+      if (!Builders[B]) Builders[B].emplace();
+      std::move(*Builders[B]).template CaseOfCFGStmt<NodeT>(M, A);
+    }
+    return std::move(*this);
+  }
+
+  CFGMatchSwitch<State> Build() && {
+    std::array<CFGMatchSwitch<State>, NumStmtBuckets> Switches;
+    for (unsigned B = 0; B < NumStmtBuckets; ++B)
+      if (Builders[B]) Switches[B] = std::move(*Builders[B]).Build();
+    return [Switches = std::move(Switches)](const CFGElement &Elt,
+                                            ASTContext &Context, State &S) {
+      auto CS = Elt.getAs<CFGStmt>();
+      if (!CS) return;
+      std::optional<StmtBucket> B = getStmtBucket(*CS->getStmt());
+      if (!B || !Switches[*B]) return;
+      Switches[*B](Elt, Context, S);
+    };
+  }
+
+ private:
+  std::array<std::optional<CFGMatchSwitchBuilder<State>>, NumStmtBuckets>
+      Builders;
+};
+
 auto buildTypeTransferer() {
-  return CFGMatchSwitchBuilder<TransferState<PointerNullabilityLattice>>()
-      .CaseOfCFGStmt<DeclRefExpr>(ast_matchers::declRefExpr(),
+  return BucketedCFGMatchSwitchBuilder()
+      .CaseOfCFGStmt<DeclRefExpr>(buckets({SB_DeclRefExpr}),
+                                  ast_matchers::declRefExpr(),
                                   transferType_DeclRefExpr)
-      .CaseOfCFGStmt<MemberExpr>(ast_matchers::memberExpr(),
+      .CaseOfCFGStmt<MemberExpr>(buckets({SB_MemberExpr}),
+                                 ast_matchers::memberExpr(),
                                  transferType_MemberExpr)
-      .CaseOfCFGStmt<CastExpr>(ast_matchers::castExpr(), transferType_CastExpr)
+      .CaseOfCFGStmt<CastExpr>(
+          buckets({SB_ImplicitCastExpr, SB_OtherCastExpr}),
+          ast_matchers::castExpr(), transferType_CastExpr)
       .CaseOfCFGStmt<MaterializeTemporaryExpr>(
+          buckets({SB_MaterializeTemporaryExpr}),
           ast_matchers::materializeTemporaryExpr(),
           transferType_MaterializeTemporaryExpr)
-      .CaseOfCFGStmt<CXXBindTemporaryExpr>(ast_matchers::cxxBindTemporaryExpr(),
+      .CaseOfCFGStmt<CXXBindTemporaryExpr>(buckets({SB_CXXBindTemporaryExpr}),
+                                           ast_matchers::cxxBindTemporaryExpr(),
                                            transferType_CXXBindTemporaryExpr)
-      .CaseOfCFGStmt<CallExpr>(ast_matchers::callExpr(), transferType_CallExpr)
-      .CaseOfCFGStmt<UnaryOperator>(ast_matchers::unaryOperator(),
+      .CaseOfCFGStmt<CallExpr>(anyCall(), ast_matchers::callExpr(),
+                               transferType_CallExpr)
+      .CaseOfCFGStmt<UnaryOperator>(buckets({SB_UnaryOperator}),
+                                    ast_matchers::unaryOperator(),
                                     transferType_UnaryOperator)
-      .CaseOfCFGStmt<BinaryOperator>(ast_matchers::binaryOperator(),
+      .CaseOfCFGStmt<BinaryOperator>(buckets({SB_BinaryOperator}),
+                                     ast_matchers::binaryOperator(),
                                      transferType_BinaryOperator)
-      .CaseOfCFGStmt<CXXNewExpr>(ast_matchers::cxxNewExpr(),
+      .CaseOfCFGStmt<CXXNewExpr>(buckets({SB_CXXNewExpr}),
+                                 ast_matchers::cxxNewExpr(),
                                  transferType_NewExpr)
-      .CaseOfCFGStmt<ArraySubscriptExpr>(ast_matchers::arraySubscriptExpr(),
+      .CaseOfCFGStmt<ArraySubscriptExpr>(buckets({SB_ArraySubscriptExpr}),
+                                         ast_matchers::arraySubscriptExpr(),
                                          transferType_ArraySubscriptExpr)
-      .CaseOfCFGStmt<CXXThisExpr>(ast_matchers::cxxThisExpr(),
+      .CaseOfCFGStmt<CXXThisExpr>(buckets({SB_CXXThisExpr}),
+                                  ast_matchers::cxxThisExpr(),
                                   transferType_ThisExpr)
       .CaseOfCFGStmt<CXXConstructExpr>(
+          buckets({SB_CXXConstructExpr}),
           ast_matchers::cxxConstructExpr(
               ast_matchers::argumentCountIs(1),
               ast_matchers::hasDeclaration(ast_matchers::cxxConstructorDecl(
@@ -1794,74 +1941,93 @@ auto buildValueTransferer() {
   // - and the Expr has a supported pointer type
   // - and the Expr's value is modeled by the framework (or this analysis)
   // - then the PointerValue has nullability properties (is_null/from_nullable)
-  return CFGMatchSwitchBuilder<TransferState<PointerNullabilityLattice>>()
+  const StmtBuckets MemberCall = buckets({SB_CXXMemberCallExpr});
+  const StmtBuckets OperatorCall = buckets({SB_CXXOperatorCallExpr});
+  return BucketedCFGMatchSwitchBuilder()
       // Handles initialization of the null states of pointers.
-      .CaseOfCFGStmt<Expr>(isAddrOf(), transferValue_NotNullPointer)
+      .CaseOfCFGStmt<Expr>(buckets({SB_UnaryOperator}), isAddrOf(),
+                           transferValue_NotNullPointer)
       // TODO(mboehme): I believe we should be able to move handling of null
       // pointers to the non-flow-sensitive part of the analysis.
-      .CaseOfCFGStmt<Expr>(isNullPointerLiteral(), transferValue_NullPointer)
-      .CaseOfCFGStmt<CXXScalarValueInitExpr>(isRawPointerValueInit(),
-                                             transferValue_NullPointer)
-      .CaseOfCFGStmt<UnaryOperator>(isPointerIncOrDec(),
+      .CaseOfCFGStmt<Expr>(buckets({SB_ImplicitCastExpr}),
+                           isNullPointerLiteral(), transferValue_NullPointer)
+      .CaseOfCFGStmt<CXXScalarValueInitExpr>(
+          buckets({SB_CXXScalarValueInitExpr}), isRawPointerValueInit(),
+          transferValue_NullPointer)
+      .CaseOfCFGStmt<UnaryOperator>(buckets({SB_UnaryOperator}),
+                                    isPointerIncOrDec(),
                                     transferValue_PointerIncOrDec)
-      .CaseOfCFGStmt<BinaryOperator>(isPointerAddOrSubAssign(),
+      .CaseOfCFGStmt<BinaryOperator>(buckets({SB_BinaryOperator}),
+                                     isPointerAddOrSubAssign(),
                                      transferValue_PointerAddOrSubAssign)
-      .CaseOfCFGStmt<CXXConstructExpr>(isSmartPointerConstructor(),
+      .CaseOfCFGStmt<CXXConstructExpr>(buckets({SB_CXXConstructExpr}),
+                                       isSmartPointerConstructor(),
                                        transferValue_SmartPointerConstructor)
-      .CaseOfCFGStmt<CXXOperatorCallExpr>(isSmartPointerOperatorCall("=", 2),
+      .CaseOfCFGStmt<CXXOperatorCallExpr>(OperatorCall,
+                                          isSmartPointerOperatorCall("=", 2),
                                           transferValue_SmartPointerAssignment)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isSmartPointerMethodCall("release"),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall,
+                                        isSmartPointerMethodCall("release"),
                                         transferValue_SmartPointerReleaseCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isSmartPointerMethodCall("reset"),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall,
+                                        isSmartPointerMethodCall("reset"),
                                         transferValue_SmartPointerResetCall)
       .CaseOfCFGStmt<CXXMemberCallExpr>(
-          isSmartPointerMethodCall("swap"),
+          MemberCall, isSmartPointerMethodCall("swap"),
           transferValue_SmartPointerMemberSwapCall)
-      .CaseOfCFGStmt<CallExpr>(isSmartPointerFreeSwapCall(),
+      .CaseOfCFGStmt<CallExpr>(anyCall(), isSmartPointerFreeSwapCall(),
                                transferValue_SmartPointerFreeSwapCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isSmartPointerMethodCall("get"),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall,
+                                        isSmartPointerMethodCall("get"),
                                         transferValue_SmartPointerGetCall)
       .CaseOfCFGStmt<CXXMemberCallExpr>(
-          isSmartPointerBoolConversionCall(),
+          MemberCall, isSmartPointerBoolConversionCall(),
           transferValue_SmartPointerBoolConversionCall)
       .CaseOfCFGStmt<CXXOperatorCallExpr>(
-          isSmartPointerOperatorCall("*", 1),
+          OperatorCall, isSmartPointerOperatorCall("*", 1),
           transferValue_SmartPointerOperatorStar)
       .CaseOfCFGStmt<CXXOperatorCallExpr>(
-          isSmartPointerOperatorCall("->", 1),
+          OperatorCall, isSmartPointerOperatorCall("->", 1),
           transferValue_SmartPointerOperatorArrow)
-      .CaseOfCFGStmt<CallExpr>(isSmartPointerFactoryCall(),
+      .CaseOfCFGStmt<CallExpr>(anyCall(), isSmartPointerFactoryCall(),
                                transferValue_SmartPointerFactoryCall)
       .CaseOfCFGStmt<CXXOperatorCallExpr>(
-          isSmartPointerComparisonOpCall(),
+          OperatorCall, isSmartPointerComparisonOpCall(),
           transferValue_SmartPointerComparisonOpCall)
-      .CaseOfCFGStmt<CallExpr>(isSharedPtrCastCall(),
+      .CaseOfCFGStmt<CallExpr>(anyCall(), isSharedPtrCastCall(),
                                transferValue_SharedPtrCastCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isWeakPtrLockCall(),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall, isWeakPtrLockCall(),
                                         transferValue_WeakPtrLockCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isSupportedPointerAccessorCall(),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall,
+                                        isSupportedPointerAccessorCall(),
                                         transferValue_AccessorCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isZeroParamConstMemberCall(),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall,
+                                        isZeroParamConstMemberCall(),
                                         transferValue_ConstMemberCall)
-      .CaseOfCFGStmt<CXXOperatorCallExpr>(isZeroParamConstMemberOperatorCall(),
+      .CaseOfCFGStmt<CXXOperatorCallExpr>(OperatorCall,
+                                          isZeroParamConstMemberOperatorCall(),
                                           transferValue_ConstMemberOperatorCall)
       .CaseOfCFGStmt<CXXOperatorCallExpr>(
-          isOptionalOperatorArrowCall(),
+          OperatorCall, isOptionalOperatorArrowCall(),
           transferValue_OptionalOperatorArrowCall)
-      .CaseOfCFGStmt<CXXMemberCallExpr>(isNonConstMemberCall(),
+      .CaseOfCFGStmt<CXXMemberCallExpr>(MemberCall, isNonConstMemberCall(),
                                         transferValue_NonConstMemberCall)
       .CaseOfCFGStmt<CXXOperatorCallExpr>(
-          isNonConstMemberOperatorCall(),
+          OperatorCall, isNonConstMemberOperatorCall(),
           transferValue_NonConstMemberOperatorCall)
-      .CaseOfCFGStmt<CallExpr>(ast_matchers::callExpr(), transferValue_CallExpr)
-      .CaseOfCFGStmt<MemberExpr>(isSmartPointerArrowMemberExpr(),
+      .CaseOfCFGStmt<CallExpr>(anyCall(), ast_matchers::callExpr(),
+                               transferValue_CallExpr)
+      .CaseOfCFGStmt<MemberExpr>(buckets({SB_MemberExpr}),
+                                 isSmartPointerArrowMemberExpr(),
                                  transferValue_SmartPointerArrowMemberExpr)
-      .CaseOfCFGStmt<Expr>(isPointerExpr(), transferValue_Pointer)
+      .CaseOfCFGStmt<Expr>(anyExpr(), isPointerExpr(), transferValue_Pointer)
       // Handles comparison between 2 pointers.
-      .CaseOfCFGStmt<BinaryOperator>(isPointerCheckBinOp(),
+      .CaseOfCFGStmt<BinaryOperator>(buckets({SB_BinaryOperator}),
+                                     isPointerCheckBinOp(),
                                      transferValue_NullCheckComparison)
       // Handles checking of pointer as boolean.
-      .CaseOfCFGStmt<Expr>(isImplicitCastPointerToBool(),
+      .CaseOfCFGStmt<Expr>(buckets({SB_ImplicitCastExpr}),
+                           isImplicitCastPointerToBool(),
                            transferValue_NullCheckImplicitCastPtrToBool)
       .Build();
 }
@@ -1874,7 +2040,10 @@ void ensureSmartPointerInitialized(
   if (!S) return;
 
   auto *E = dyn_cast<Expr>(S->getStmt());
-  if (E == nullptr || !isSupportedSmartPointerType(E->getType())) return;
+  if (E == nullptr ||
+      !State.Lattice.smartPointerTypes().isSupportedSmartPointerType(
+          E->getType()))
+    return;
 
   initSmartPointerForExpr(E, State);
 
@@ -1894,8 +2063,10 @@ PointerNullabilityAnalysis::PointerNullabilityAnalysis(
       TypeTransferer(buildTypeTransferer()),
       ValueTransferer(buildValueTransferer()) {
   Env.getDataflowAnalysisContext().setSyntheticFieldCallback(
-      [](QualType Ty) -> llvm::StringMap<QualType> {
-        QualType RawPointerTy = underlyingRawPointerType(Ty, AS_private);
+      [SmartPointerTypes =
+           NFS.SmartPointerTypes](QualType Ty) -> llvm::StringMap<QualType> {
+        QualType RawPointerTy =
+            SmartPointerTypes->underlyingRawPointerType(Ty, AS_private);
         if (RawPointerTy.isNull()) return {};
         return {{PtrField, RawPointerTy}};
       });
@@ -1913,6 +2084,7 @@ PointerTypeNullability PointerNullabilityAnalysis::assignNullabilityVariable(
 void PointerNullabilityAnalysis::transfer(const CFGElement &Elt,
                                           PointerNullabilityLattice &Lattice,
                                           Environment &Env) {
+  if (Profile != nullptr) ++Profile->ElementTransfers;
   TransferState<PointerNullabilityLattice> State(Lattice, Env);
 
   TypeTransferer(Elt, getASTContext(), State);
@@ -2019,13 +2191,23 @@ ComparisonResult PointerNullabilityAnalysis::compare(QualType Type,
   return ComparisonResult::Unknown;
 }
 
+// Returns whether `Env` proves `F`. Doesn't call the solver if `F` is the
+// literal `true`.
+static bool provesCheaply(const Environment &Env, const Formula &F) {
+  if (F.kind() == Formula::Literal && F.literal()) return true;
+  return Env.proves(F);
+}
+
 // Returns the result of widening a nullability property.
 // `Prev` is the formula in the previous iteration, `Cur` is the formula in the
 // current iteration.
 // Returns `nullptr` (Top), if `Prev` is already Top or `Prev` and `Cur` cannot
 // be proven equivalent. Otherwise, (`Prev` and `Cur` are provably equivalent),
-// returns `Cur`. Returns `Cur`, if `Prev` is equivalent to `Cur`. Otherwise,
-// returns `Top`.
+// returns the literal that both are proven to be. Like `mergeFormulas()` does
+// for joins, this keeps the property from being a fresh formula on every
+// iteration, so that the next iteration finds it identical (without calling
+// the solver). Each property therefore changes at most twice (to a literal,
+// then to Top) before the loop converges.
 static std::pair<absl::Nullable<const Formula *>, LatticeEffect>
 widenNullabilityProperty(absl::Nullable<const Formula *> Prev,
                          const Environment &PrevEnv,
@@ -2042,9 +2224,11 @@ widenNullabilityProperty(absl::Nullable<const Formula *> Prev,
   // in their conclusions. We do not draw conclusions from them independently.
   // For example, if PrevEnv => Prev`, we do *not* conclude that
   // `PrevEnv => !Prev` is false, and use that to optimize the branches below.
-  if ((PrevEnv.proves(*Prev) && CurEnv.proves(*Cur)) ||
-      (PrevEnv.proves(A.makeNot(*Prev)) && CurEnv.proves(A.makeNot(*Cur))))
-    return {Cur, LatticeEffect::Unchanged};
+  if (provesCheaply(PrevEnv, *Prev) && provesCheaply(CurEnv, *Cur))
+    return {&A.makeLiteral(true), LatticeEffect::Unchanged};
+  if (provesCheaply(PrevEnv, A.makeNot(*Prev)) &&
+      provesCheaply(CurEnv, A.makeNot(*Cur)))
+    return {&A.makeLiteral(false), LatticeEffect::Unchanged};
 
   return {nullptr, LatticeEffect::Changed};
 }
@@ -2078,8 +2262,8 @@ std::optional<WidenResult> PointerNullabilityAnalysis::widen(
   auto [NullWidened, NWEffect] =
       widenNullabilityProperty(NullPrev, PrevEnv, NullCur, CurrentEnv);
 
-  if (LocUnchanged && FNWEffect == LatticeEffect::Unchanged &&
-      NWEffect == LatticeEffect::Unchanged)
+  if (LocUnchanged && FromNullableWidened == FromNullableCur &&
+      NullWidened == NullCur)
     return WidenResult{&CurPtr, LatticeEffect::Unchanged};
 
   // Widen the loc if needed.
@@ -2108,4 +2292,15 @@ StorageLocation &PointerNullabilityAnalysis::getTopStorageLocation(
   return *It->second;
 }
 
+llvm::raw_ostream &operator<<(llvm::raw_ostream &OS,
+                              const AnalysisProfile &Profile) {
+  using Millis = std::chrono::duration<double, std::milli>;
+  return OS << "blocks: " << Profile.CFGBlocks
+            << ", transfers: " << Profile.ElementTransfers
+            << ", solver calls: " << Profile.SolverCalls << ", solver time: "
+            << llvm::format("%0.2f", Millis(Profile.SolverTime).count())
+            << "ms, atoms: " << Profile.Atoms << ", time: "
+            << llvm::format("%0.2f", Millis(Profile.Time).count()) << "ms";
+}
+
 }  // namespace clang::tidy::nullability
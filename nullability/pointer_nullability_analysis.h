@@ -5,6 +5,9 @@
 #ifndef CRUBIT_NULLABILITY_POINTER_NULLABILITY_ANALYSIS_H_
 #define CRUBIT_NULLABILITY_POINTER_NULLABILITY_ANALYSIS_H_
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <utility>
 
@@ -22,6 +25,7 @@
 #include "clang/Analysis/FlowSensitive/DataflowEnvironment.h"
 #include "clang/Analysis/FlowSensitive/Value.h"
 #include "llvm/ADT/FunctionExtras.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace clang {
 namespace tidy {
@@ -30,6 +34,27 @@ namespace nullability {
 /// Factory function for creating a solver implementation.
 using SolverFactory = std::function<std::unique_ptr<dataflow::Solver>()>;
 
+/// Counters of the work done to analyze one function, to find the functions
+/// that make the analysis slow.
+struct AnalysisProfile {
+  /// Number of basic blocks in the CFG.
+  unsigned CFGBlocks = 0;
+  /// Number of CFG elements transferred. Blocks are transferred again until
+  /// the analysis converges, so this grows with the number of iterations.
+  int64_t ElementTransfers = 0;
+  /// Number of calls to the SAT solver, and the time spent in them.
+  int64_t SolverCalls = 0;
+  std::chrono::nanoseconds SolverTime{0};
+  /// Number of SAT atoms created. The environments create atoms for their
+  /// values (e.g. the null state of pointers) and flow conditions, so this
+  /// approximates the size of the largest environment.
+  unsigned Atoms = 0;
+  /// Total time spent analyzing the function.
+  std::chrono::nanoseconds Time{0};
+};
+
+llvm::raw_ostream &operator<<(llvm::raw_ostream &, const AnalysisProfile &);
+
 /// Analyzes constructs in the source code to collect nullability information
 /// about pointers at each program point. This analysis and the corresponding
 /// lattice were based on the gradual analysis in 'Estep, Sam, Jenna Wise,
@@ -87,6 +112,28 @@ class PointerNullabilityAnalysis
     NFS.ConcreteNullabilityOverride = std::move(Override);
   }
 
+  // Caches the nullability of declarations in `Cache`, which may be shared
+  // with the analyses of other functions in the same translation unit.
+  void setDeclNullabilityCache(absl::Nullable<DeclNullabilityCache *> Cache) {
+    NFS.Defaults.DeclCache = Cache;
+  }
+
+  // Bounds the memory used for the nullability of expressions, which otherwise
+  // grows with the size of the function, by keeping the nullability of at most
+  // about `2 * MaxEntries` expressions (see
+  // `NonFlowSensitiveState::MaxExprNullabilityEntries`). This is meant for
+  // machine-generated functions with a huge number of expressions: if an
+  // expression is used long after it was evaluated, its nullability may have
+  // been forgotten, and is then treated as unspecified. 0 means unbounded.
+  void setMaxExprNullabilityEntries(size_t MaxEntries) {
+    NFS.MaxExprNullabilityEntries = MaxEntries;
+  }
+
+  // Counts the CFG elements transferred in `Profile->ElementTransfers`.
+  void setProfile(absl::Nullable<AnalysisProfile *> Profile) {
+    this->Profile = Profile;
+  }
+
   void transfer(const CFGElement &Elt, PointerNullabilityLattice &Lattice,
                 dataflow::Environment &Env);
 
@@ -125,6 +172,8 @@ class PointerNullabilityAnalysis
 
   // Storage locations that represent "top" for each given type.
   llvm::DenseMap<QualType, dataflow::StorageLocation *> TopStorageLocations;
+
+  absl::Nullable<AnalysisProfile *> Profile = nullptr;
 };
 }  // namespace nullability
 }  // namespace tidy
@@ -2,26 +2,94 @@
 // Exceptions. See /LICENSE for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
 
 #include "absl/base/nullability.h"
 #include "absl/log/check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "third_party/benchmark/include/benchmark/benchmark.h"
+#include "nullability/inference/collect_evidence.h"
+#include "nullability/inference/infer_tu.h"
 #include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pointer_nullability_diagnosis.h"
 #include "nullability/pragma.h"
+#include "nullability/type_nullability.h"
+#include "clang/AST/ASTConsumer.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/Analysis/FlowSensitive/DataflowAnalysis.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
+#include "clang/Analysis/FlowSensitive/Solver.h"
 #include "clang/Basic/LLVM.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
 #include "clang/Testing/TestAST.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Process.h"
 
 namespace clang::tidy::nullability {
 namespace {
 
+// Static initializer turns on support for smart pointers.
+test::EnableSmartPointers Enable;
+
+// Statistics about one run of the analysis, which are reported as counters
+// alongside the timings.
+struct AnalysisStats {
+  int64_t SolverCalls = 0;
+  // Heap usage is sampled at every solver call (and at the end of the run), so
+  // `PeakHeap` is a lower bound of the actual peak.
+  size_t BaselineHeap = llvm::sys::Process::GetMallocUsage();
+  size_t PeakHeap = BaselineHeap;
+
+  void sampleHeap() {
+    PeakHeap = std::max(PeakHeap, llvm::sys::Process::GetMallocUsage());
+  }
+
+  void report(benchmark::State &State) {
+    sampleHeap();
+    State.counters["solver_calls"] = SolverCalls;
+    State.counters["peak_heap_bytes"] =
+        benchmark::Counter(PeakHeap - BaselineHeap,
+                           benchmark::Counter::kDefaults,
+                           benchmark::Counter::kIs1024);
+  }
+};
+
+// Forwards to another solver, recording calls in `AnalysisStats`.
+class CountingSolver : public dataflow::Solver {
+ public:
+  CountingSolver(std::unique_ptr<dataflow::Solver> Inner, AnalysisStats &Stats)
+      : Inner(std::move(Inner)), Stats(Stats) {}
+
+  Result solve(llvm::ArrayRef<const dataflow::Formula *> Vals) override {
+    ++Stats.SolverCalls;
+    Stats.sampleHeap();
+    return Inner->solve(Vals);
+  }
+
+  bool reachedLimit() const override { return Inner->reachedLimit(); }
+
+ private:
+  std::unique_ptr<dataflow::Solver> Inner;
+  AnalysisStats &Stats;
+};
+
+SolverFactory countingSolverFactory(SolverFactory MakeSolver,
+                                    AnalysisStats &Stats) {
+  return [MakeSolver = std::move(MakeSolver), &Stats] {
+    return std::make_unique<CountingSolver>(MakeSolver(), Stats);
+  };
+}
+
 absl::Nonnull<NamedDecl *> lookup(absl::string_view Name,
                                   const DeclContext &DC) {
   auto Result = DC.lookup(&DC.getParentASTContext().Idents.get(Name));
@@ -35,6 +103,13 @@ void benchmarkAnalysisOnCode(benchmark::State &State, llvm::StringRef Code) {
       lookup("Target", *AST.context().getTranslationUnitDecl()));
   NullabilityPragmas NoPragmas;
 
+  // Collect the statistics in a separate, untimed run.
+  AnalysisStats Stats;
+  (void)diagnosePointerNullability(
+      Target, NoPragmas,
+      countingSolverFactory(makeDefaultSolverForDiagnosis, Stats));
+  Stats.report(State);
+
   for (auto _ : State) (void)diagnosePointerNullability(Target, NoPragmas);
 }
 
@@ -217,6 +292,212 @@ void BM_PointerAnalysisCallInLoop(benchmark::State &State) {
 }
 BENCHMARK(BM_PointerAnalysisCallInLoop);
 
+// The benchmarks below are generated, to approximate the sizes of real-world
+// code, which the hand-written benchmarks above are far from.
+
+// A function with `State.range(0)` pointer variables, which are dereferenced
+// and merged at each other's null checks.
+void BM_PointerAnalysisManyPointers(benchmark::State &State) {
+  std::string Code = R"cpp(
+    int *_Nullable maybe();
+    int Target(bool b) {
+      int sum = 0;
+      int *p0 = maybe();
+  )cpp";
+  for (int64_t I = 1; I < State.range(0); ++I) {
+    absl::StrAppend(&Code, "int *p", I, " = maybe();\n",  //
+                    "if (b) p", I, " = p", I - 1, ";\n",  //
+                    "if (p", I, " != nullptr) sum += *p", I, ";\n");
+  }
+  absl::StrAppend(&Code, "return sum; }\n");
+  benchmarkAnalysisOnCode(State, Code);
+}
+BENCHMARK(BM_PointerAnalysisManyPointers)->Arg(100)->Arg(400);
+
+constexpr inline char smart_pointer_preamble[] = R"cpp(
+  namespace std {
+  template <typename T>
+  class unique_ptr {
+   public:
+    using pointer = T*;
+    unique_ptr();
+    unique_ptr(T*);
+    T* get() const;
+    T& operator*() const;
+    T* operator->() const;
+    explicit operator bool() const;
+    void reset(T* = nullptr);
+  };
+  }  // namespace std
+
+  struct Node {
+    std::unique_ptr<Node> next;
+    std::unique_ptr<std::unique_ptr<int>> value;
+  };
+)cpp";
+
+// Walks a linked list of `std::unique_ptr`s to depth `State.range(0)`, checking
+// each link (and a doubly wrapped value) before using it.
+void BM_PointerAnalysisNestedSmartPointers(benchmark::State &State) {
+  std::string Code = absl::StrCat(smart_pointer_preamble, R"cpp(
+    int Target(std::unique_ptr<Node> &n) {
+      int sum = 0;
+  )cpp");
+  std::string Path = "n";
+  for (int64_t I = 0; I < State.range(0); ++I) {
+    absl::StrAppend(&Code, "if (!", Path, ") return sum;\n",  //
+                    "if (", Path, "->value && *", Path, "->value) sum += **",
+                    Path, "->value;\n");
+    absl::StrAppend(&Path, "->next");
+  }
+  absl::StrAppend(&Code, "return sum; }\n");
+  benchmarkAnalysisOnCode(State, Code);
+}
+BENCHMARK(BM_PointerAnalysisNestedSmartPointers)->Arg(8)->Arg(32);
+
+// Uses `State.range(0)` instantiations of a class template, each of which has
+// its own nullability-annotated members.
+void BM_PointerAnalysisTemplateInstantiations(benchmark::State &State) {
+  std::string Code = R"cpp(
+    template <typename T>
+    struct Box {
+      T *_Nullable get();
+      T *_Nonnull getOr(T *_Nonnull fallback);
+    };
+  )cpp";
+  for (int64_t I = 0; I < State.range(0); ++I)
+    absl::StrAppend(&Code, "struct S", I, " { int v; };\n");
+  absl::StrAppend(&Code, "int Target() {\n int sum = 0;\n");
+  for (int64_t I = 0; I < State.range(0); ++I) {
+    absl::StrAppend(&Code, "Box<S", I, "> b", I, ";\n",  //
+                    "if (S", I, " *p = b", I, ".get()) sum += p->v;\n",
+                    "sum += b", I, ".getOr(b", I, ".get())->v;\n");
+  }
+  absl::StrAppend(&Code, "return sum; }\n");
+  benchmarkAnalysisOnCode(State, Code);
+}
+BENCHMARK(BM_PointerAnalysisTemplateInstantiations)->Arg(50)->Arg(200);
+
+// A switch statement with `State.range(0)` cases, each of which may change the
+// nullability of the same pointer.
+void BM_PointerAnalysisLongSwitch(benchmark::State &State) {
+  std::string Code = R"cpp(
+    int *_Nullable get(int);
+    int Target(int k, int *p) {
+      switch (k) {
+  )cpp";
+  for (int64_t I = 0; I < State.range(0); ++I) {
+    absl::StrAppend(&Code, "case ", I, ":\n",  //
+                    I % 2 ? "p = get(k);\n" : "if (p == nullptr) return 0;\n",
+                    "break;\n");
+  }
+  absl::StrAppend(&Code, "} return *p; }\n");
+  benchmarkAnalysisOnCode(State, Code);
+}
+BENCHMARK(BM_PointerAnalysisLongSwitch)->Arg(50)->Arg(200);
+
+// A TU with `NumFunctions` functions that pass pointers to each other.
+std::string manyFunctionsCode(int64_t NumFunctions) {
+  std::string Code = R"cpp(
+    int *_Nullable maybe();
+    void f0(int *p, int *q) { *p = 0; }
+  )cpp";
+  for (int64_t I = 1; I < NumFunctions; ++I) {
+    absl::StrAppend(&Code, "void f", I, "(int *p, int *q) {\n",  //
+                    "if (q != nullptr) *q = ", I, ";\n",         //
+                    "f", I - 1, "(p, ", I % 3 ? "q" : "maybe()", ");\n}\n");
+  }
+  return Code;
+}
+
+void BM_PointerDiagnosisTU(benchmark::State &State) {
+  TestAST AST(manyFunctionsCode(State.range(0)));
+  NullabilityPragmas NoPragmas;
+
+  AnalysisStats Stats;
+  (void)diagnosePointerNullabilityInTU(
+      AST.context(), NoPragmas,
+      countingSolverFactory(makeDefaultSolverForDiagnosis, Stats));
+  Stats.report(State);
+
+  for (auto _ : State)
+    (void)diagnosePointerNullabilityInTU(AST.context(), NoPragmas);
+}
+BENCHMARK(BM_PointerDiagnosisTU)->Arg(100)->Arg(500);
+
+// Like `manyFunctionsCode`, but the pointers are unannotated and the functions
+// alternate between headers with different `file_default` pragmas, so that
+// the defaults are looked up for most types.
+TestInputs manyFunctionsWithPragmasInputs(int64_t NumFunctions,
+                                          NullabilityPragmas &Pragmas) {
+  TestInputs Inputs;
+  Inputs.ExtraFiles["nonnull.h"] = R"cpp(
+    #pragma nullability file_default nonnull
+    void takesNonnull(int *p, int **pp);
+  )cpp";
+  Inputs.ExtraFiles["nullable.h"] = R"cpp(
+    #pragma nullability file_default nullable
+    int *returnsNullable(int *p);
+  )cpp";
+  Inputs.Code = R"cpp(
+    #pragma nullability file_default nonnull
+    #include "nonnull.h"
+    #include "nullable.h"
+    void f0(int *p, int *q) { *p = 0; }
+  )cpp";
+  for (int64_t I = 1; I < NumFunctions; ++I) {
+    absl::StrAppend(&Inputs.Code, "void f", I, "(int *p, int *q) {\n",  //
+                    "int *r = returnsNullable(q);\n",                   //
+                    "if (r != nullptr) takesNonnull(r, &p);\n",         //
+                    "f", I - 1, "(p, ", I % 3 ? "q" : "r", ");\n}\n");
+  }
+  Inputs.MakeAction = [&Pragmas] {
+    struct Action : public SyntaxOnlyAction {
+      NullabilityPragmas &Pragmas;
+      Action(NullabilityPragmas &Pragmas) : Pragmas(Pragmas) {}
+      std::unique_ptr<ASTConsumer> CreateASTConsumer(
+          CompilerInstance &CI, llvm::StringRef File) override {
+        registerPragmaHandler(CI.getPreprocessor(), Pragmas);
+        return SyntaxOnlyAction::CreateASTConsumer(CI, File);
+      }
+    };
+    return std::make_unique<Action>(Pragmas);
+  };
+  return Inputs;
+}
+
+void BM_PointerDiagnosisTUWithPragmas(benchmark::State &State) {
+  NullabilityPragmas Pragmas;
+  TestAST AST(manyFunctionsWithPragmasInputs(State.range(0), Pragmas));
+  CHECK_EQ(Pragmas.size(), 3u);
+
+  AnalysisStats Stats;
+  (void)diagnosePointerNullabilityInTU(
+      AST.context(), Pragmas,
+      countingSolverFactory(makeDefaultSolverForDiagnosis, Stats));
+  Stats.report(State);
+
+  for (auto _ : State)
+    (void)diagnosePointerNullabilityInTU(AST.context(), Pragmas);
+}
+BENCHMARK(BM_PointerDiagnosisTUWithPragmas)->Arg(100)->Arg(500);
+
+void BM_InferTU(benchmark::State &State) {
+  TestAST AST(manyFunctionsCode(State.range(0)));
+  NullabilityPragmas NoPragmas;
+  // A second iteration propagates the inferences from the first one through
+  // the call chain.
+  constexpr unsigned Iterations = 2;
+
+  AnalysisStats Stats;
+  (void)inferTU(AST.context(), NoPragmas, Iterations, /*Filter=*/nullptr,
+                countingSolverFactory(makeDefaultSolverForInference, Stats));
+  Stats.report(State);
+
+  for (auto _ : State) (void)inferTU(AST.context(), NoPragmas, Iterations);
+}
+BENCHMARK(BM_InferTU)->Arg(100)->Arg(500);
+
 }  // namespace
 }  // namespace clang::tidy::nullability
 
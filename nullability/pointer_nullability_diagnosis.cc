@@ -4,15 +4,20 @@
 
 #include "nullability/pointer_nullability_diagnosis.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/nullability.h"
 #include "absl/log/check.h"
+#include "nullability/function_fingerprint.h"
 #include "nullability/pointer_nullability.h"
 #include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pointer_nullability_lattice.h"
@@ -24,6 +29,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/Type.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
@@ -35,6 +41,7 @@
 #include "clang/Analysis/FlowSensitive/DataflowAnalysis.h"
 #include "clang/Analysis/FlowSensitive/DataflowAnalysisContext.h"
 #include "clang/Analysis/FlowSensitive/DataflowEnvironment.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
 #include "clang/Analysis/FlowSensitive/MatchSwitch.h"
 #include "clang/Analysis/FlowSensitive/Solver.h"
 #include "clang/Analysis/FlowSensitive/StorageLocation.h"
@@ -42,9 +49,12 @@
 #include "clang/Analysis/FlowSensitive/WatchedLiteralsSolver.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Basic/Specifiers.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
@@ -52,6 +62,15 @@
 
 #define DEBUG_TYPE "nullability-diagnostic"
 
+STATISTIC(NumDeclsDiagnosedFlowInsensitively,
+          "Number of declarations diagnosed flow-insensitively because the "
+          "solver budget ran out");
+STATISTIC(NumDeclNullabilityCacheHits,
+          "Number of declaration nullability queries answered by the cache");
+STATISTIC(NumDeclNullabilityCacheMisses,
+          "Number of declaration nullability queries not answered by the "
+          "cache");
+
 namespace clang::tidy::nullability {
 
 using ast_matchers::anyOf;
@@ -753,10 +772,109 @@ std::unique_ptr<dataflow::Solver> makeDefaultSolverForDiagnosis() {
   return std::make_unique<dataflow::WatchedLiteralsSolver>(MaxSATIterations);
 }
 
+namespace {
+
+// Runs the checks that only look at the declaration `VD`, not at a function
+// body. Returns `VD` if it is a function definition whose body should be
+// analyzed, and null otherwise.
+absl::Nullable<const FunctionDecl *> checkDeclaration(
+    const ValueDecl &VD, llvm::SmallVector<PointerNullabilityDiagnostic> &Diags,
+    const TypeNullabilityDefaults &Defaults) {
+  checkAnnotationsConsistent(&VD, Diags, Defaults);
+
+  const auto *Func = dyn_cast<FunctionDecl>(&VD);
+  if (Func == nullptr) return nullptr;
+
+  for (const ParmVarDecl *Parm : Func->parameters())
+    checkParmVarDeclWithPointerDefaultArg(VD.getASTContext(), *Parm, Diags,
+                                          Defaults, Func);
+
+  // Use `doesThisDeclarationHaveABody()` rather than `hasBody()` to ensure we
+  // analyze forward-declared functions only once.
+  if (!Func->doesThisDeclarationHaveABody()) return nullptr;
+  return Func;
+}
+
+// Returns the callbacks for `runDataflowAnalysis()` that diagnose the body of
+// `Func`, appending the diagnostics to `Diags`. `DiagnoserBefore` is the result
+// of `pointerNullabilityDiagnoserBefore()`. See `beginDiagnosingDefinition()`
+// for `Assumption`.
+dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> makeDiagnosisCallbacks(
+    const FunctionDecl &Func, DiagTransferFunc DiagnoserBefore,
+    SmallVector<PointerNullabilityDiagnostic> &Diags,
+    absl::Nullable<const dataflow::Formula *> Assumption) {
+  ASTContext &Ctx = Func.getASTContext();
+  auto Diagnose =
+      [&Ctx, &Diags, Assumption](
+          const DiagTransferFunc &Diagnoser, const CFGElement &Elt,
+          const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
+              &State) {
+        if (Assumption == nullptr) {
+          llvm::move(Diagnoser(Elt, Ctx, {State.Lattice, State.Env}),
+                     std::back_inserter(Diags));
+          return;
+        }
+        // Don't constrain `State.Env`, which the analysis continues from.
+        Environment Env = State.Env.fork();
+        Env.assume(*Assumption);
+        llvm::move(Diagnoser(Elt, Ctx, {State.Lattice, Env}),
+                   std::back_inserter(Diags));
+      };
+
+  // Shared by the copies of the `After` callback.
+  auto AllowedMovedFromNonnull =
+      std::make_shared<const AllowedMovedFromNonnullSmartPointerExprs>(&Func);
+
+  dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> Callbacks;
+  Callbacks.Before =
+      [Diagnose, Diagnoser = std::move(DiagnoserBefore)](
+          const CFGElement &Elt,
+          const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
+              &State) { Diagnose(Diagnoser, Elt, State); };
+  Callbacks.After =
+      [Diagnose, AllowedMovedFromNonnull,
+       Diagnoser = pointerNullabilityDiagnoserAfter(*AllowedMovedFromNonnull)](
+          const CFGElement &Elt,
+          const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
+              &State) { Diagnose(Diagnoser, Elt, State); };
+  return Callbacks;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Forwards to another solver, recording the calls in `Profile`.
+class ProfilingSolver : public dataflow::Solver {
+ public:
+  ProfilingSolver(std::unique_ptr<dataflow::Solver> Inner,
+                  AnalysisProfile &Profile)
+      : Inner(std::move(Inner)), Profile(Profile) {}
+
+  Result solve(llvm::ArrayRef<const dataflow::Formula *> Vals) override {
+    ++Profile.SolverCalls;
+    Clock::time_point Start = Clock::now();
+    Result R = Inner->solve(Vals);
+    Profile.SolverTime += Clock::now() - Start;
+    return R;
+  }
+
+  bool reachedLimit() const override { return Inner->reachedLimit(); }
+
+ private:
+  std::unique_ptr<dataflow::Solver> Inner;
+  AnalysisProfile &Profile;
+};
+
+// Implementation of `diagnosePointerNullability()` which reuses
+// `DiagnoserBefore` (the result of `pointerNullabilityDiagnoserBefore()`), as
+// its matchers are costly to build compared to the analysis of small functions,
+// and `DeclCache`, if set.
 llvm::Expected<llvm::SmallVector<PointerNullabilityDiagnostic>>
-diagnosePointerNullability(const ValueDecl *VD,
-                           const NullabilityPragmas &Pragmas,
-                           const SolverFactory &MakeSolver) {
+diagnoseValueDecl(const ValueDecl *VD, const NullabilityPragmas &Pragmas,
+                  const SolverFactory &MakeSolver,
+                  const DiagTransferFunc &DiagnoserBefore,
+                  absl::Nullable<DeclNullabilityCache *> DeclCache,
+                  absl::Nullable<AnalysisProfile *> Profile,
+                  size_t MaxExprNullabilityEntries = 0) {
   // This limit is set based on empirical observations. Mostly, it is a rough
   // proxy for a line between "finite" and "effectively infinite", rather than a
   // strict limit on resource use.
@@ -767,52 +885,42 @@ diagnosePointerNullability(const ValueDecl *VD,
 
   ASTContext &Ctx = VD->getASTContext();
   TypeNullabilityDefaults Defaults{Ctx, Pragmas};
+  Defaults.DeclCache = DeclCache;
 
-  checkAnnotationsConsistent(VD, Diags, Defaults);
-
-  const auto *Func = dyn_cast<FunctionDecl>(VD);
+  const FunctionDecl *Func = checkDeclaration(*VD, Diags, Defaults);
   if (Func == nullptr) return Diags;
 
-  for (const ParmVarDecl *Parm : Func->parameters())
-    checkParmVarDeclWithPointerDefaultArg(Ctx, *Parm, Diags, Defaults, Func);
-
-  // Use `doesThisDeclarationHaveABody()` rather than `hasBody()` to ensure we
-  // analyze forward-declared functions only once.
-  if (!Func->doesThisDeclarationHaveABody()) return Diags;
-
-  AllowedMovedFromNonnullSmartPointerExprs AllowedMovedFromNonnull(Func);
-
   // TODO(b/332565018): it would be nice to have some common pieces (limits,
   // adorning, error-handling) reused. diagnoseFunction() is too restrictive.
+  Clock::time_point Start = Clock::now();
   auto CFG = dataflow::AdornedCFG::build(*Func);
   if (!CFG) return CFG.takeError();
 
   std::unique_ptr<dataflow::Solver> Solver = MakeSolver();
+  if (Profile != nullptr) {
+    *Profile = AnalysisProfile();
+    Profile->CFGBlocks = CFG->getCFG().size();
+    Solver = std::make_unique<ProfilingSolver>(std::move(Solver), *Profile);
+  }
   dataflow::DataflowAnalysisContext AnalysisContext(*Solver);
   Environment Env(AnalysisContext, *Func);
 
   PointerNullabilityAnalysis Analysis(Ctx, Env, Pragmas);
+  Analysis.setDeclNullabilityCache(DeclCache);
+  Analysis.setProfile(Profile);
+  Analysis.setMaxExprNullabilityEntries(MaxExprNullabilityEntries);
 
-  dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> PostAnalysisCallbacks;
-  PostAnalysisCallbacks.Before =
-      [&, Diagnoser = pointerNullabilityDiagnoserBefore()](
-          const CFGElement &Elt,
-          const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
-              &State) mutable {
-        auto EltDiagnostics = Diagnoser(Elt, Ctx, {State.Lattice, State.Env});
-        llvm::move(EltDiagnostics, std::back_inserter(Diags));
-      };
-  PostAnalysisCallbacks.After =
-      [&,
-       Diagnoser = pointerNullabilityDiagnoserAfter(AllowedMovedFromNonnull)](
-          const CFGElement &Elt,
-          const dataflow::DataflowAnalysisState<PointerNullabilityLattice>
-              &State) mutable {
-        auto EltDiagnostics = Diagnoser(Elt, Ctx, {State.Lattice, State.Env});
-        llvm::move(EltDiagnostics, std::back_inserter(Diags));
-      };
+  auto PostAnalysisCallbacks = makeDiagnosisCallbacks(
+      *Func, DiagnoserBefore, Diags, /*Assumption=*/nullptr);
   auto Result = dataflow::runDataflowAnalysis(
       *CFG, Analysis, Env, PostAnalysisCallbacks, MaxBlockVisits);
+  if (Profile != nullptr) {
+    // Atoms are numbered consecutively, so the next atom is the number of
+    // atoms created so far.
+    Profile->Atoms =
+        static_cast<unsigned>(AnalysisContext.arena().makeAtom());
+    Profile->Time = Clock::now() - Start;
+  }
   if (!Result) return Result.takeError();
   if (Solver->reachedLimit())
     return llvm::createStringError(llvm::errc::interrupted,
@@ -821,4 +929,352 @@ diagnosePointerNullability(const ValueDecl *VD,
   return Diags;
 }
 
+bool isNonnull(const TypeNullability &Nullability) {
+  return !Nullability.empty() &&
+         Nullability.front().concrete() == NullabilityKind::NonNull;
+}
+
+bool isNullPointerConstant(const Expr &E, ASTContext &Ctx) {
+  return E.isNullPointerConstant(Ctx, Expr::NPC_ValueDependentIsNotNull) !=
+         Expr::NPCK_NotNull;
+}
+
+// Diagnoses null pointer constants that are used where a nonnull pointer is
+// expected (returned, passed as an argument, or used to initialize a
+// variable), based only on the annotations of the destination.
+//
+// This is a cheap, flow-insensitive approximation of the dataflow analysis: it
+// finds only a small subset of the issues, but never reports issues that the
+// analysis wouldn't report.
+SmallVector<PointerNullabilityDiagnostic> diagnoseNullPointerConstants(
+    const FunctionDecl &Func, const TypeNullabilityDefaults &Defaults) {
+  struct Walker : public RecursiveASTVisitor<Walker> {
+    Walker(const FunctionDecl &Func, const TypeNullabilityDefaults &Defaults)
+        : Func(Func), Defaults(Defaults), Ctx(Func.getASTContext()) {}
+
+    const FunctionDecl &Func;
+    const TypeNullabilityDefaults &Defaults;
+    ASTContext &Ctx;
+    SmallVector<PointerNullabilityDiagnostic> Diags;
+
+    // Returns in lambdas return from the lambda, not from `Func`.
+    bool shouldVisitLambdaBody() const { return false; }
+
+    void diagnose(const Expr &E, PointerNullabilityDiagnostic::Context DiagCtx,
+                  const NamedDecl *Callee = nullptr,
+                  const IdentifierInfo *ParamName = nullptr) {
+      Diags.push_back({PointerNullabilityDiagnostic::ErrorCode::ExpectedNonnull,
+                       DiagCtx,
+                       CharSourceRange::getTokenRange(E.getSourceRange()),
+                       Callee, ParamName});
+    }
+
+    bool VisitReturnStmt(absl::Nonnull<const ReturnStmt *> RS) {
+      const Expr *RetValue = RS->getRetValue();
+      if (RetValue != nullptr && isSupportedPointerType(Func.getReturnType()) &&
+          isNullPointerConstant(*RetValue, Ctx) &&
+          isNonnull(getTypeNullability(Func, Defaults)))
+        diagnose(*RetValue, PointerNullabilityDiagnostic::Context::ReturnValue);
+      return true;
+    }
+
+    bool VisitCallExpr(absl::Nonnull<const CallExpr *> CE) {
+      const FunctionDecl *Callee = CE->getDirectCallee();
+      if (Callee == nullptr) return true;
+      // The object argument of member operator calls has no parameter.
+      unsigned ArgOffset =
+          isa<CXXOperatorCallExpr>(CE) && isa<CXXMethodDecl>(Callee) ? 1 : 0;
+      for (unsigned I = 0; I < Callee->getNumParams() &&
+                           I + ArgOffset < CE->getNumArgs();
+           ++I) {
+        const ParmVarDecl &Param = *Callee->getParamDecl(I);
+        const Expr &Arg = *CE->getArg(I + ArgOffset);
+        if (isSupportedPointerType(Param.getType()) &&
+            isNullPointerConstant(Arg, Ctx) &&
+            isNonnull(getTypeNullability(Param, Defaults)))
+          diagnose(Arg, PointerNullabilityDiagnostic::Context::FunctionArgument,
+                   Callee, Param.getIdentifier());
+      }
+      return true;
+    }
+
+    bool VisitVarDecl(absl::Nonnull<const VarDecl *> VD) {
+      if (isa<ParmVarDecl>(VD)) return true;
+      const Expr *Init = VD->getInit();
+      if (Init != nullptr && isSupportedPointerType(VD->getType()) &&
+          isNullPointerConstant(*Init, Ctx) &&
+          isNonnull(getTypeNullability(*VD, Defaults)))
+        diagnose(*Init, PointerNullabilityDiagnostic::Context::Initializer);
+      return true;
+    }
+  };
+
+  Walker W(Func, Defaults);
+  // `RecursiveASTVisitor` requires a non-const input.
+  W.TraverseStmt(const_cast<Stmt *>(Func.getBody()));
+  return std::move(W.Diags);
+}
+
+// Like `diagnoseValueDecl()`, but uses `diagnoseNullPointerConstants()`
+// instead of the dataflow analysis.
+SmallVector<PointerNullabilityDiagnostic> diagnoseValueDeclFlowInsensitively(
+    const ValueDecl &VD, const NullabilityPragmas &Pragmas,
+    absl::Nullable<DeclNullabilityCache *> DeclCache) {
+  SmallVector<PointerNullabilityDiagnostic> Diags;
+  if (VD.isTemplated()) return Diags;
+
+  TypeNullabilityDefaults Defaults{VD.getASTContext(), Pragmas};
+  Defaults.DeclCache = DeclCache;
+  if (const FunctionDecl *Func = checkDeclaration(VD, Diags, Defaults))
+    llvm::append_range(Diags, diagnoseNullPointerConstants(*Func, Defaults));
+  return Diags;
+}
+
+// The budget left for analyzing one function, and the record of how much of it
+// was used.
+struct FunctionBudget {
+  std::optional<int64_t> MaxSolverCalls;
+  std::optional<Clock::time_point> Deadline;
+
+  int64_t SolverCalls = 0;
+  // Whether the solver gave up, either because the budget ran out or because
+  // of its own limits.
+  bool ReachedLimit = false;
+};
+
+// A solver which gives up (like a solver that reached its iteration limit)
+// once `Budget` is exhausted.
+class BudgetedSolver : public dataflow::Solver {
+ public:
+  BudgetedSolver(std::unique_ptr<dataflow::Solver> Inner,
+                 FunctionBudget &Budget)
+      : Inner(std::move(Inner)), Budget(Budget) {}
+
+  Result solve(llvm::ArrayRef<const dataflow::Formula *> Vals) override {
+    if ((Budget.MaxSolverCalls &&
+         Budget.SolverCalls >= *Budget.MaxSolverCalls) ||
+        (Budget.Deadline && Clock::now() >= *Budget.Deadline)) {
+      Budget.ReachedLimit = true;
+      return Result::TimedOut();
+    }
+    ++Budget.SolverCalls;
+    Result R = Inner->solve(Vals);
+    if (Inner->reachedLimit()) Budget.ReachedLimit = true;
+    return R;
+  }
+
+  bool reachedLimit() const override { return Budget.ReachedLimit; }
+
+ private:
+  std::unique_ptr<dataflow::Solver> Inner;
+  FunctionBudget &Budget;
+};
+
+template <typename T>
+std::optional<T> minOptional(std::optional<T> A, std::optional<T> B) {
+  if (!A) return B;
+  if (!B) return A;
+  return std::min(*A, *B);
+}
+
+}  // namespace
+
+std::optional<llvm::SmallVector<PointerNullabilityDiagnostic>>
+DiagnosisCache::lookup(const FunctionDecl &Func,
+                       const FunctionFingerprint &FP) {
+  auto It = Entries.find(FP.Hash);
+  if (It == Entries.end()) {
+    ++Misses;
+    return std::nullopt;
+  }
+
+  ASTContext &Ctx = Func.getASTContext();
+  SourceLocation Start = Func.getBeginLoc();
+  auto Absolute = [&](const RelativeRange &R) {
+    return CharSourceRange(SourceRange(Start.getLocWithOffset(R.Begin),
+                                       Start.getLocWithOffset(R.End)),
+                           R.IsTokenRange);
+  };
+  llvm::SmallVector<PointerNullabilityDiagnostic> Diags;
+  for (const CachedDiagnostic &Cached : It->second) {
+    PointerNullabilityDiagnostic &Diag = Diags.emplace_back();
+    Diag.Code = Cached.Code;
+    Diag.Ctx = Cached.Ctx;
+    Diag.Range = Absolute(Cached.Range);
+    if (Cached.CalleeIndex) {
+      // Fingerprints with equal hashes should reference the same decls, but a
+      // hash collision must not index past the end of `ReferencedDecls`.
+      if (*Cached.CalleeIndex >= FP.ReferencedDecls.size()) {
+        ++Misses;
+        return std::nullopt;
+      }
+      Diag.Callee = FP.ReferencedDecls[*Cached.CalleeIndex];
+    }
+    if (Cached.ParamName) Diag.ParamName = &Ctx.Idents.get(*Cached.ParamName);
+    if (Cached.NoteRange) Diag.NoteRange = Absolute(*Cached.NoteRange);
+  }
+  ++Hits;
+  return Diags;
+}
+
+void DiagnosisCache::insert(
+    const FunctionDecl &Func, const FunctionFingerprint &FP,
+    llvm::ArrayRef<PointerNullabilityDiagnostic> Diags) {
+  const SourceManager &SM = Func.getASTContext().getSourceManager();
+  SourceLocation Start = Func.getBeginLoc();
+  FileID File = SM.getFileID(Start);
+  unsigned StartOffset = SM.getFileOffset(Start);
+  unsigned EndOffset = SM.getFileOffset(Func.getEndLoc());
+  // Returns `Loc` relative to `Start`, or nothing if it is not in the source
+  // text of `Func`.
+  auto Relative = [&](SourceLocation Loc) -> std::optional<unsigned> {
+    if (!Loc.isFileID() || SM.getFileID(Loc) != File) return std::nullopt;
+    unsigned Offset = SM.getFileOffset(Loc);
+    if (Offset < StartOffset || Offset > EndOffset) return std::nullopt;
+    return Offset - StartOffset;
+  };
+  auto RelativeRangeOf =
+      [&](const CharSourceRange &R) -> std::optional<RelativeRange> {
+    std::optional<unsigned> Begin = Relative(R.getBegin());
+    std::optional<unsigned> End = Relative(R.getEnd());
+    if (!Begin || !End) return std::nullopt;
+    return RelativeRange{*Begin, *End, R.isTokenRange()};
+  };
+
+  std::vector<CachedDiagnostic> Cached;
+  for (const PointerNullabilityDiagnostic &Diag : Diags) {
+    CachedDiagnostic &C = Cached.emplace_back();
+    C.Code = Diag.Code;
+    C.Ctx = Diag.Ctx;
+    std::optional<RelativeRange> Range = RelativeRangeOf(Diag.Range);
+    if (!Range) return;
+    C.Range = *Range;
+    if (Diag.Callee != nullptr) {
+      auto It = llvm::find(FP.ReferencedDecls, Diag.Callee);
+      if (It == FP.ReferencedDecls.end()) return;
+      C.CalleeIndex = It - FP.ReferencedDecls.begin();
+    }
+    if (Diag.ParamName != nullptr) C.ParamName = Diag.ParamName->getName();
+    if (Diag.NoteRange.isValid()) {
+      C.NoteRange = RelativeRangeOf(Diag.NoteRange);
+      if (!C.NoteRange) return;
+    }
+  }
+  Entries.insert_or_assign(FP.Hash, std::move(Cached));
+}
+
+llvm::Expected<llvm::SmallVector<PointerNullabilityDiagnostic>>
+diagnosePointerNullability(const ValueDecl *VD,
+                           const NullabilityPragmas &Pragmas,
+                           const SolverFactory &MakeSolver,
+                           absl::Nullable<AnalysisProfile *> Profile,
+                           absl::Nullable<DiagnosisCache *> Cache) {
+  auto Diagnose = [&] {
+    return diagnoseValueDecl(VD, Pragmas, MakeSolver,
+                             pointerNullabilityDiagnoserBefore(),
+                             /*DeclCache=*/nullptr, Profile);
+  };
+  const auto *Func = dyn_cast<FunctionDecl>(VD);
+  if (Cache == nullptr || Func == nullptr) return Diagnose();
+  std::optional<FunctionFingerprint> FP = fingerprintDefinition(
+      *Func, TypeNullabilityDefaults(VD->getASTContext(), Pragmas));
+  if (!FP) return Diagnose();
+
+  if (std::optional<SmallVector<PointerNullabilityDiagnostic>> Cached =
+          Cache->lookup(*Func, *FP)) {
+    if (Profile != nullptr) *Profile = AnalysisProfile();
+    return std::move(*Cached);
+  }
+  auto Diags = Diagnose();
+  if (Diags) Cache->insert(*Func, *FP, *Diags);
+  return Diags;
+}
+
+dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> beginDiagnosingDefinition(
+    const FunctionDecl &Func, const NullabilityPragmas &Pragmas,
+    llvm::SmallVector<PointerNullabilityDiagnostic> &Diags,
+    absl::Nullable<const dataflow::Formula *> Assumption) {
+  CHECK(!Func.isTemplated());
+  CHECK(Func.doesThisDeclarationHaveABody());
+  TypeNullabilityDefaults Defaults{Func.getASTContext(), Pragmas};
+  (void)checkDeclaration(Func, Diags, Defaults);
+  return makeDiagnosisCallbacks(Func, pointerNullabilityDiagnoserBefore(),
+                                Diags, Assumption);
+}
+
+std::vector<DeclDiagnostics> diagnosePointerNullabilityInTU(
+    ASTContext &Ctx, const NullabilityPragmas &Pragmas,
+    const SolverFactory &MakeSolver, const DiagnosisBudget &Budget) {
+  // Visits declarations in the order in which they appear in the source, so the
+  // results are too. Template instantiations and implicit code aren't visited
+  // (and `diagnosePointerNullability()` ignores templated declarations).
+  struct Walker : public RecursiveASTVisitor<Walker> {
+    std::vector<absl::Nonnull<const ValueDecl *>> Decls;
+
+    bool VisitValueDecl(absl::Nonnull<const ValueDecl *> VD) {
+      // Parameters are checked as part of their function.
+      if (!isa<ParmVarDecl>(VD)) Decls.push_back(VD);
+      return true;
+    }
+  };
+  Walker W;
+  W.TraverseAST(Ctx);
+
+  // The declarations are analyzed one after the other rather than
+  // concurrently: the analysis lazily creates types and caches in the
+  // `ASTContext`, which isn't thread-safe.
+  DiagTransferFunc DiagnoserBefore = pointerNullabilityDiagnoserBefore();
+  DeclNullabilityCache DeclCache;
+  std::optional<Clock::time_point> TUDeadline;
+  if (Budget.MaxTimePerTU) TUDeadline = Clock::now() + *Budget.MaxTimePerTU;
+  int64_t TUSolverCalls = 0;
+  std::vector<DeclDiagnostics> Results;
+  Results.reserve(W.Decls.size());
+  for (const ValueDecl *VD : W.Decls) {
+    FunctionBudget FuncBudget;
+    FuncBudget.MaxSolverCalls = Budget.MaxSolverCallsPerFunction;
+    if (Budget.MaxSolverCallsPerTU)
+      FuncBudget.MaxSolverCalls =
+          minOptional<int64_t>(FuncBudget.MaxSolverCalls,
+                               *Budget.MaxSolverCallsPerTU - TUSolverCalls);
+    FuncBudget.Deadline = TUDeadline;
+    if (Budget.MaxTimePerFunction)
+      FuncBudget.Deadline = minOptional<Clock::time_point>(
+          FuncBudget.Deadline, Clock::now() + *Budget.MaxTimePerFunction);
+
+    // Once the budget for the TU is exhausted, don't even start the analysis
+    // of function bodies.
+    const auto *Func = dyn_cast<FunctionDecl>(VD);
+    bool NeedsAnalysis = Func != nullptr &&
+                         Func->doesThisDeclarationHaveABody() &&
+                         !Func->isTemplated();
+    bool TUBudgetExhausted =
+        (FuncBudget.MaxSolverCalls && *FuncBudget.MaxSolverCalls <= 0) ||
+        (TUDeadline && Clock::now() >= *TUDeadline);
+    if (!NeedsAnalysis || !TUBudgetExhausted) {
+      auto Diags = diagnoseValueDecl(
+          VD, Pragmas,
+          [&] {
+            return std::make_unique<BudgetedSolver>(MakeSolver(), FuncBudget);
+          },
+          DiagnoserBefore, &DeclCache, /*Profile=*/nullptr,
+          Budget.MaxExprNullabilityEntriesPerFunction.value_or(0));
+      TUSolverCalls += FuncBudget.SolverCalls;
+      if (!FuncBudget.ReachedLimit) {
+        Results.push_back({VD, std::move(Diags)});
+        continue;
+      }
+      llvm::consumeError(Diags.takeError());
+    }
+
+    ++NumDeclsDiagnosedFlowInsensitively;
+    Results.push_back(
+        {VD, diagnoseValueDeclFlowInsensitively(*VD, Pragmas, &DeclCache),
+         /*DiagnosedFlowInsensitively=*/true});
+  }
+  NumDeclNullabilityCacheHits += DeclCache.hits();
+  NumDeclNullabilityCacheMisses += DeclCache.misses();
+  return Results;
+}
+
 }  // namespace clang::tidy::nullability
@@ -5,18 +5,29 @@
 #ifndef CRUBIT_NULLABILITY_POINTER_NULLABILITY_DIAGNOSIS_H_
 #define CRUBIT_NULLABILITY_POINTER_NULLABILITY_DIAGNOSIS_H_
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "nullability/function_fingerprint.h"
 #include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pragma.h"
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
+#include "clang/Analysis/FlowSensitive/DataflowAnalysis.h"
+#include "clang/Analysis/FlowSensitive/Formula.h"
 #include "clang/Analysis/FlowSensitive/Solver.h"
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Basic/SourceLocation.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Error.h"
 
 namespace clang {
 namespace tidy {
@@ -69,6 +80,53 @@ struct PointerNullabilityDiagnostic {
 /// `diagnosePointerNullability()`.
 std::unique_ptr<dataflow::Solver> makeDefaultSolverForDiagnosis();
 
+/// Caches the results of `diagnosePointerNullability()` for function
+/// definitions by their `FunctionFingerprint`, so that functions that are
+/// unchanged since an earlier run (e.g. on a previous version of the same TU)
+/// don't need to be analyzed again.
+///
+/// The cached diagnostics don't refer to the AST that they were produced from:
+/// source ranges are stored as offsets from the start of the function, and
+/// callees as indices into `FunctionFingerprint::ReferencedDecls`. Diagnostics
+/// that can't be stored this way (e.g. those in macro expansions, or pointing
+/// outside of the function) prevent caching the results of the function.
+/// Failed analyses are not cached either.
+class DiagnosisCache {
+ public:
+  /// Returns the cached diagnostics for `Func`, whose fingerprint is `FP`, if
+  /// there are any.
+  std::optional<llvm::SmallVector<PointerNullabilityDiagnostic>> lookup(
+      const FunctionDecl &Func, const FunctionFingerprint &FP);
+  /// Caches `Diags`, the diagnostics for `Func`, if possible.
+  void insert(const FunctionDecl &Func, const FunctionFingerprint &FP,
+              llvm::ArrayRef<PointerNullabilityDiagnostic> Diags);
+
+  size_t size() const { return Entries.size(); }
+  unsigned hits() const { return Hits; }
+  unsigned misses() const { return Misses; }
+
+ private:
+  // A character range in the file of the function, relative to the start of
+  // the function.
+  struct RelativeRange {
+    unsigned Begin;
+    unsigned End;
+    bool IsTokenRange;
+  };
+  struct CachedDiagnostic {
+    PointerNullabilityDiagnostic::ErrorCode Code;
+    PointerNullabilityDiagnostic::Context Ctx;
+    RelativeRange Range;
+    std::optional<unsigned> CalleeIndex;
+    std::optional<std::string> ParamName;
+    std::optional<RelativeRange> NoteRange;
+  };
+
+  absl::flat_hash_map<uint64_t, std::vector<CachedDiagnostic>> Entries;
+  unsigned Hits = 0;
+  unsigned Misses = 0;
+};
+
 /// Checks that nullable pointers are used safely, using nullability information
 /// that is collected by `PointerNullabilityAnalysis`.
 ///
@@ -80,10 +138,75 @@ std::unique_ptr<dataflow::Solver> makeDefaultSolverForDiagnosis();
 /// are consistent with the annotations on its canonical declaration.
 ///
 /// Returns an empty vector when no issues are found in the code.
+///
+/// If `Profile` is set and `VD` is a function definition that is analyzed, the
+/// work done by the analysis is recorded in `Profile`.
+///
+/// If `Cache` is set, the diagnostics for function definitions are looked up
+/// in and added to `Cache`. For cached definitions, `Profile` is zeroed.
 llvm::Expected<llvm::SmallVector<PointerNullabilityDiagnostic>>
 diagnosePointerNullability(
     const ValueDecl *VD, const NullabilityPragmas &Pragmas,
-    const SolverFactory &MakeSolver = makeDefaultSolverForDiagnosis);
+    const SolverFactory &MakeSolver = makeDefaultSolverForDiagnosis,
+    absl::Nullable<AnalysisProfile *> Profile = nullptr,
+    absl::Nullable<DiagnosisCache *> Cache = nullptr);
+
+/// Diagnoses the function definition `Func` like `diagnosePointerNullability()`
+/// does, but leaves running the `PointerNullabilityAnalysis` of its body to the
+/// caller, so that the analysis can be used for other purposes too (see e.g.
+/// `collectEvidenceAndDiagnoseDefinition()`).
+///
+/// Checks the declaration of `Func` right away, and returns the callbacks to
+/// pass to `runDataflowAnalysis()` to check its body. All diagnostics are
+/// appended to `Diags`, which must outlive the callbacks. `Func` must not be
+/// templated.
+///
+/// If `Assumption` is set, the body is diagnosed as if its flow conditions
+/// implied `Assumption`, without constraining the analysis itself.
+dataflow::CFGEltCallbacks<PointerNullabilityAnalysis> beginDiagnosingDefinition(
+    const FunctionDecl &Func, const NullabilityPragmas &Pragmas,
+    llvm::SmallVector<PointerNullabilityDiagnostic> &Diags,
+    absl::Nullable<const dataflow::Formula *> Assumption = nullptr);
+
+/// The result of `diagnosePointerNullability()` for one declaration.
+struct DeclDiagnostics {
+  absl::Nonnull<const ValueDecl *> Decl;
+  llvm::Expected<llvm::SmallVector<PointerNullabilityDiagnostic>> Diagnostics;
+  /// Whether the solver budget ran out, so that `Diagnostics` come from a
+  /// cheap flow-insensitive approximation of the analysis, which only finds
+  /// null pointer constants used where a nonnull pointer is expected.
+  bool DiagnosedFlowInsensitively = false;
+};
+
+/// Limits on the work done by the SAT solver in
+/// `diagnosePointerNullabilityInTU()`. These come on top of the limits of the
+/// solvers created by the `SolverFactory`. Unset limits are unlimited.
+struct DiagnosisBudget {
+  std::optional<int64_t> MaxSolverCallsPerFunction;
+  std::optional<int64_t> MaxSolverCallsPerTU;
+  std::optional<std::chrono::milliseconds> MaxTimePerFunction;
+  std::optional<std::chrono::milliseconds> MaxTimePerTU;
+  /// Bounds the memory used by the analysis of each function for the
+  /// nullability of expressions. Rather than failing, the analysis then forgets
+  /// the nullability of expressions evaluated long before they are used (see
+  /// `PointerNullabilityAnalysis::setMaxExprNullabilityEntries()`).
+  std::optional<size_t> MaxExprNullabilityEntriesPerFunction;
+};
+
+/// Runs `diagnosePointerNullability()` on each declaration in the translation
+/// unit, in source order.
+///
+/// This is equivalent to calling `diagnosePointerNullability()` for each
+/// declaration, but shares work between the declarations, which matters for
+/// TUs with many small functions. Also, instead of failing, functions for which
+/// the solver gives up (because it reached its own limits or exhausted
+/// `Budget`) are diagnosed flow-insensitively (see
+/// `DeclDiagnostics::DiagnosedFlowInsensitively`). Once the budget of the TU
+/// is exhausted, all remaining functions are diagnosed flow-insensitively.
+std::vector<DeclDiagnostics> diagnosePointerNullabilityInTU(
+    ASTContext &Ctx, const NullabilityPragmas &Pragmas,
+    const SolverFactory &MakeSolver = makeDefaultSolverForDiagnosis,
+    const DiagnosisBudget &Budget = {});
 
 }  // namespace nullability
 }  // namespace tidy
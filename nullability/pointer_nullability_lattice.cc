@@ -7,6 +7,7 @@
 #include <cassert>
 #include <functional>
 #include <optional>
+#include <utility>
 
 #include "absl/base/nullability.h"
 #include "absl/log/check.h"
@@ -45,14 +46,18 @@ const TypeNullability &
 PointerNullabilityLatticeBase::insertExprNullabilityIfAbsent(
     absl::Nonnull<const Expr *> E,
     const std::function<TypeNullability()> &GetNullability) {
+  if (const TypeNullability *Existing = getTypeNullability(E))
+    return *Existing;
   E = &dataflow::ignoreCFGOmittedNodes(*E);
-  if (auto It = NFS.ExprToNullability.find(E);
-      It != NFS.ExprToNullability.end())
-    return It->second;
   // Deliberately perform a separate lookup after calling GetNullability.
   // It may invalidate iterators, e.g. inserting missing vectors for children.
-  auto [Iterator, Inserted] =
-      NFS.ExprToNullability.insert({E, GetNullability()});
+  TypeNullability N = GetNullability();
+  if (NFS.MaxExprNullabilityEntries != 0 &&
+      NFS.ExprToNullability.size() >= NFS.MaxExprNullabilityEntries) {
+    NFS.EvictedExprToNullability = std::move(NFS.ExprToNullability);
+    NFS.ExprToNullability.clear();
+  }
+  auto [Iterator, Inserted] = NFS.ExprToNullability.insert({E, std::move(N)});
   CHECK(Inserted) << "GetNullability inserted same " << E->getStmtClassName();
   return Iterator->second;
 }
@@ -5,7 +5,9 @@
 #ifndef CRUBIT_NULLABILITY_POINTER_NULLABILITY_LATTICE_H_
 #define CRUBIT_NULLABILITY_POINTER_NULLABILITY_LATTICE_H_
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <ostream>
 
@@ -26,6 +28,14 @@ class PointerNullabilityLatticeBase {
     TypeNullabilityDefaults Defaults;
 
     absl::flat_hash_map<const Expr *, TypeNullability> ExprToNullability;
+    // If nonzero, bounds the size of `ExprToNullability`: once it is full, its
+    // entries move to `EvictedExprToNullability`, replacing the entries
+    // evicted before. So at most twice this many entries are held, and the
+    // nullability of an expression is available for at least this many
+    // insertions after it was computed, which covers the uses of expressions
+    // by their parents even in very large functions.
+    size_t MaxExprNullabilityEntries = 0;
+    absl::flat_hash_map<const Expr *, TypeNullability> EvictedExprToNullability;
     // Overridden symbolic nullability for pointer-typed decls.
     // These are set by PointerNullabilityAnalysis::assignNullabilityVariable,
     // and take precedence over the declared type and over any result from
@@ -39,14 +49,24 @@ class PointerNullabilityLatticeBase {
     llvm::unique_function<std::optional<const PointerTypeNullability *>(
         const Decl &) const>
         ConcreteNullabilityOverride = [](const Decl &) { return std::nullopt; };
+    // Smart pointer classification of the record types in the function. This
+    // is shared with the synthetic field callback of the analysis context,
+    // which may outlive the analysis.
+    std::shared_ptr<SmartPointerTypeCache> SmartPointerTypes =
+        std::make_shared<SmartPointerTypeCache>();
   };
 
   PointerNullabilityLatticeBase(NonFlowSensitiveState &NFS) : NFS(NFS) {}
 
   absl::Nullable<const TypeNullability *> getTypeNullability(
       absl::Nonnull<const Expr *> E) const {
-    auto I = NFS.ExprToNullability.find(&dataflow::ignoreCFGOmittedNodes(*E));
-    return I == NFS.ExprToNullability.end() ? nullptr : &I->second;
+    E = &dataflow::ignoreCFGOmittedNodes(*E);
+    if (auto I = NFS.ExprToNullability.find(E);
+        I != NFS.ExprToNullability.end())
+      return &I->second;
+    if (NFS.EvictedExprToNullability.empty()) return nullptr;
+    auto I = NFS.EvictedExprToNullability.find(E);
+    return I == NFS.EvictedExprToNullability.end() ? nullptr : &I->second;
   }
 
   // If the `ExprToNullability` map already contains an entry for `E`, does
@@ -70,6 +90,10 @@ class PointerNullabilityLatticeBase {
 
   const TypeNullabilityDefaults &defaults() const { return NFS.Defaults; }
 
+  SmartPointerTypeCache &smartPointerTypes() const {
+    return *NFS.SmartPointerTypes;
+  }
+
  private:
   // Owned by the PointerNullabilityAnalysis object, shared by all lattice
   // elements within one analysis run.
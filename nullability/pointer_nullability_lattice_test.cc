@@ -4,10 +4,12 @@
 
 #include "nullability/pointer_nullability_lattice.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 #include "absl/base/nullability.h"
+#include "nullability/type_nullability.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclCXX.h"
@@ -21,7 +23,9 @@
 #include "clang/Analysis/FlowSensitive/Value.h"
 #include "clang/Analysis/FlowSensitive/WatchedLiteralsSolver.h"
 #include "clang/Basic/LLVM.h"
+#include "clang/Basic/Specifiers.h"
 #include "clang/Testing/TestAST.h"
+#include "llvm/ADT/StringRef.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
 
 namespace clang::tidy::nullability {
@@ -29,10 +33,13 @@ namespace {
 
 using ast_matchers::callee;
 using ast_matchers::cxxMemberCallExpr;
+using ast_matchers::declRefExpr;
 using ast_matchers::functionDecl;
 using ast_matchers::hasName;
 using ast_matchers::match;
+using ast_matchers::parmVarDecl;
 using ast_matchers::selectFirst;
+using ast_matchers::to;
 
 using dataflow::DataflowAnalysisContext;
 using dataflow::Environment;
@@ -91,5 +98,43 @@ TEST_F(PointerNullabilityLatticeTest, ConstMethodProducesNewValueAfterJoin) {
   EXPECT_NE(ValAfterJoin, Val2);
 }
 
+TEST_F(PointerNullabilityLatticeTest, BoundedExprNullability) {
+  TestAST AST(R"cpp(
+    void target(int *p0, int *p1, int *p2, int *p3, int *p4) {
+      p0; p1; p2; p3; p4;
+    }
+  )cpp");
+  auto Ref = [&](llvm::StringRef Name) {
+    auto *E = selectFirst<Expr>(
+        "ref", match(declRefExpr(to(parmVarDecl(hasName(Name)))).bind("ref"),
+                     AST.context()));
+    assert(E != nullptr);
+    return E;
+  };
+  const Expr *Refs[] = {Ref("p0"), Ref("p1"), Ref("p2"), Ref("p3"), Ref("p4")};
+
+  NFS.MaxExprNullabilityEntries = 2;
+  PointerNullabilityLattice Lattice(NFS);
+  auto Insert = [&](const Expr *E) {
+    (void)Lattice.insertExprNullabilityIfAbsent(
+        E, [] { return TypeNullability{NullabilityKind::NonNull}; });
+  };
+
+  // Each entry is still available after `MaxExprNullabilityEntries` more
+  // insertions, ...
+  for (int I = 0; I < 4; ++I) {
+    Insert(Refs[I]);
+    for (int J = std::max(0, I - 2); J <= I; ++J)
+      EXPECT_NE(Lattice.getTypeNullability(Refs[J]), nullptr) << I << J;
+  }
+  // ... but at most twice that many are kept.
+  Insert(Refs[4]);
+  EXPECT_EQ(Lattice.getTypeNullability(Refs[0]), nullptr);
+  EXPECT_EQ(Lattice.getTypeNullability(Refs[1]), nullptr);
+  EXPECT_NE(Lattice.getTypeNullability(Refs[4]), nullptr);
+  EXPECT_LE(NFS.ExprToNullability.size() + NFS.EvictedExprToNullability.size(),
+            4u);
+}
+
 }  // namespace
 }  // namespace clang::tidy::nullability
@@ -5,7 +5,10 @@
 // Tests for basic functionality (simple dereferences without control flow).
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "nullability/pointer_nullability_analysis.h"
 #include "nullability/pointer_nullability_diagnosis.h"
 #include "nullability/pragma.h"
 #include "nullability/test/check_diagnostics.h"
@@ -14,7 +17,10 @@
 #include "clang/AST/DeclBase.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Frontend/ASTUnit.h"
+#include "clang/Lex/Lexer.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Testing/Support/Error.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googlemock/include/gmock/gmock.h"
 #include "third_party/llvm/llvm-project/third-party/unittest/googletest/include/gtest/gtest.h"
@@ -22,6 +28,7 @@
 namespace clang::tidy::nullability {
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::SizeIs;
 
@@ -325,6 +332,155 @@ TEST(PointerNullabilityTest, AnalyzeFunctionWithForwardDeclarationOnlyOnce) {
                        llvm::HasValue(IsEmpty()));
 }
 
+TEST(PointerNullabilityTest, Profile) {
+  std::unique_ptr<ASTUnit> Unit = tooling::buildASTFromCode(R"cc(
+    void target(int *_Nullable p, bool b) {
+      if (b) *p;
+    }
+  )cc");
+  NullabilityPragmas NoPragmas;
+
+  ASTContext &Context = Unit->getASTContext();
+  DeclContextLookupResult Result =
+      Context.getTranslationUnitDecl()->lookup(&Context.Idents.get("target"));
+  ASSERT_TRUE(Result.isSingleResult());
+  auto *Target = cast<FunctionDecl>(Result.front());
+
+  AnalysisProfile Profile;
+  EXPECT_THAT_EXPECTED(
+      diagnosePointerNullability(Target, NoPragmas,
+                                 makeDefaultSolverForDiagnosis, &Profile),
+      llvm::HasValue(SizeIs(1)));
+  EXPECT_GT(Profile.CFGBlocks, 0);
+  EXPECT_GT(Profile.ElementTransfers, 0);
+  EXPECT_GT(Profile.SolverCalls, 0);
+  EXPECT_GT(Profile.Atoms, 0);
+}
+
+TEST(PointerNullabilityTest, DiagnosisCache) {
+  constexpr llvm::StringRef Target = R"cc(
+    void target(int *_Nullable p) { *p; }
+  )cc";
+  NullabilityPragmas NoPragmas;
+  DiagnosisCache Cache;
+
+  // Diagnoses `target` in `Code` and returns the source text of the
+  // diagnostics.
+  auto DiagnoseTarget = [&](llvm::StringRef Code) {
+    std::unique_ptr<ASTUnit> Unit = tooling::buildASTFromCode(Code);
+    ASTContext &Context = Unit->getASTContext();
+    DeclContextLookupResult Result = Context.getTranslationUnitDecl()->lookup(
+        &Context.Idents.get("target"));
+    EXPECT_TRUE(Result.isSingleResult());
+    auto Diags = diagnosePointerNullability(
+        cast<FunctionDecl>(Result.front()), NoPragmas,
+        makeDefaultSolverForDiagnosis, /*Profile=*/nullptr, &Cache);
+    std::vector<std::string> Texts;
+    if (!Diags) {
+      ADD_FAILURE() << llvm::toString(Diags.takeError());
+      return Texts;
+    }
+    for (const PointerNullabilityDiagnostic &Diag : *Diags)
+      Texts.push_back(Lexer::getSourceText(Diag.Range,
+                                           Context.getSourceManager(),
+                                           Context.getLangOpts())
+                          .str());
+    return Texts;
+  };
+
+  EXPECT_THAT(DiagnoseTarget(Target), ElementsAre("p"));
+  EXPECT_EQ(Cache.size(), 1);
+  EXPECT_EQ(Cache.hits(), 0);
+
+  // The cached diagnostics are moved along with the function.
+  EXPECT_THAT(DiagnoseTarget(("void other();\n" + Target).str()),
+              ElementsAre("p"));
+  EXPECT_EQ(Cache.hits(), 1);
+
+  EXPECT_THAT(DiagnoseTarget(R"cc(
+    void target(int *_Nullable p) { *p, *p; }
+  )cc"),
+              ElementsAre("p", "p"));
+  EXPECT_EQ(Cache.hits(), 1);
+  EXPECT_EQ(Cache.size(), 2);
+}
+
+TEST(PointerNullabilityTest, DiagnoseTranslationUnit) {
+  std::unique_ptr<ASTUnit> Unit = tooling::buildASTFromCode(R"cc(
+    void first() {
+      int *p = nullptr;
+      *p;
+    }
+    int *_Nullable global;
+    void second() {
+      int *p = nullptr;
+      *p;
+      *p;
+    }
+    template <typename T>
+    void templated(T *p) {
+      *p;
+    }
+  )cc");
+  NullabilityPragmas NoPragmas;
+
+  std::vector<DeclDiagnostics> Results =
+      diagnosePointerNullabilityInTU(Unit->getASTContext(), NoPragmas);
+  std::vector<std::string> Names;
+  for (DeclDiagnostics &Result : Results) {
+    ASSERT_THAT_EXPECTED(Result.Diagnostics, llvm::Succeeded());
+    const auto *Func = dyn_cast<FunctionDecl>(Result.Decl);
+    if (Func == nullptr) {
+      EXPECT_THAT(*Result.Diagnostics, IsEmpty());
+      continue;
+    }
+    Names.push_back(Func->getNameAsString());
+    if (Func->getName() == "first") EXPECT_THAT(*Result.Diagnostics, SizeIs(1));
+    if (Func->getName() == "second")
+      EXPECT_THAT(*Result.Diagnostics, SizeIs(2));
+    if (Func->getName() == "templated")
+      EXPECT_THAT(*Result.Diagnostics, IsEmpty());
+  }
+  EXPECT_THAT(Names, ElementsAre("first", "second", "templated"));
+}
+
+TEST(PointerNullabilityTest, DiagnoseTranslationUnitFlowInsensitively) {
+  std::unique_ptr<ASTUnit> Unit = tooling::buildASTFromCode(R"cc(
+    void takesNonnull(int *_Nonnull);
+    int *_Nonnull target(int *_Nullable p) {
+      *p;  // Only diagnosed by the dataflow analysis.
+      takesNonnull(nullptr);
+      int *_Nonnull q = nullptr;
+      return nullptr;
+    }
+  )cc");
+  NullabilityPragmas NoPragmas;
+
+  auto DiagnoseTarget = [&](const DiagnosisBudget &Budget) {
+    std::vector<DeclDiagnostics> Results = diagnosePointerNullabilityInTU(
+        Unit->getASTContext(), NoPragmas, makeDefaultSolverForDiagnosis,
+        Budget);
+    for (DeclDiagnostics &Result : Results) {
+      const auto *Func = dyn_cast<FunctionDecl>(Result.Decl);
+      if (Func != nullptr && Func->getName() == "target" &&
+          Func->doesThisDeclarationHaveABody())
+        return std::move(Result);
+    }
+    ADD_FAILURE() << "didn't find target function";
+    return std::move(Results.front());
+  };
+
+  DeclDiagnostics Unlimited = DiagnoseTarget({});
+  EXPECT_FALSE(Unlimited.DiagnosedFlowInsensitively);
+  EXPECT_THAT_EXPECTED(Unlimited.Diagnostics, llvm::HasValue(SizeIs(4)));
+
+  DiagnosisBudget NoSolverCalls;
+  NoSolverCalls.MaxSolverCallsPerTU = 0;
+  DeclDiagnostics FlowInsensitive = DiagnoseTarget(NoSolverCalls);
+  EXPECT_TRUE(FlowInsensitive.DiagnosedFlowInsensitively);
+  EXPECT_THAT_EXPECTED(FlowInsensitive.Diagnostics, llvm::HasValue(SizeIs(3)));
+}
+
 TEST(PointerNullabilityTest, CheckMacro) {
   EXPECT_TRUE(checkDiagnostics(R"cc(
 #define CHECK(x) \
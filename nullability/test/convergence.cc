@@ -168,6 +168,43 @@ TEST(PointerNullabilityTest, PointerLoop_Counted) {
   )cc"));
 }
 
+// The pointer is provably nonnull at the loop head on every iteration, but its
+// null state is a different formula each time. Widening should recognize this
+// instead of giving up on it.
+TEST(PointerNullabilityTest, PointerLoop_CheckedEveryIteration) {
+  EXPECT_TRUE(checkDiagnostics(R"cc(
+    Nonnull<int*> GetFirst();
+    int* GetNext();
+    bool cond();
+    void target() {
+      int* p = GetFirst();
+      while (cond()) {
+        *p;
+        p = GetNext();
+        if (p == nullptr) p = GetFirst();
+      }
+    }
+  )cc"));
+}
+
+// Pointers that change places on each iteration, with null states that are
+// proven to be the same.
+TEST(PointerNullabilityTest, PointerLoop_Rotating) {
+  EXPECT_TRUE(checkDiagnostics(R"cc(
+    bool cond();
+    void target(Nonnull<int*> a, Nonnull<int*> b, Nullable<int*> c) {
+      while (cond()) {
+        int* t = a;
+        a = b;
+        b = t;
+        *a;
+        *b;
+        *c;  // [[unsafe]]
+      }
+    }
+  )cc"));
+}
+
 // Various tests for convergence of range-based for loops.
 
 TEST(PointerNullabilityTest, RangeFor_Array_ByValue) {
@@ -199,6 +199,42 @@ QualType underlyingRawPointerType(QualType T, AccessSpecifier BaseAccess) {
   return QualType();
 }
 
+bool isStdWeakPtrType(QualType T) {
+  const CXXRecordDecl *RD = T.getCanonicalType()->getAsCXXRecordDecl();
+  if (RD == nullptr) return false;
+
+  if (!RD->getDeclContext()->isStdNamespace()) return false;
+
+  const IdentifierInfo *ID = RD->getIdentifier();
+  if (ID == nullptr) return false;
+
+  return ID->getName() == "weak_ptr";
+}
+
+absl::Nullable<SmartPointerTypeCache::Entry *> SmartPointerTypeCache::entry(
+    QualType T) {
+  const CXXRecordDecl *RD = T.getCanonicalType()->getAsCXXRecordDecl();
+  if (RD == nullptr || !RD->hasDefinition()) return nullptr;
+  auto [It, Inserted] = Entries.try_emplace(RD);
+  if (Inserted) It->second.IsStdWeakPtr = nullability::isStdWeakPtrType(T);
+  return &It->second;
+}
+
+QualType SmartPointerTypeCache::underlyingRawPointerType(
+    QualType T, AccessSpecifier BaseAccess) {
+  if (!SmartPointersEnabled) return QualType();
+  Entry *E = entry(T);
+  if (E == nullptr) return nullability::underlyingRawPointerType(T, BaseAccess);
+  std::optional<QualType> &Result = E->RawPointerType[BaseAccess];
+  if (!Result) Result = nullability::underlyingRawPointerType(T, BaseAccess);
+  return *Result;
+}
+
+bool SmartPointerTypeCache::isStdWeakPtrType(QualType T) {
+  if (Entry *E = entry(T)) return E->IsStdWeakPtr;
+  return nullability::isStdWeakPtrType(T);
+}
+
 PointerTypeNullability PointerTypeNullability::createSymbolic(
     dataflow::Arena &A) {
   PointerTypeNullability Symbolic;
@@ -981,23 +1017,37 @@ unsigned countPointersInType(absl::Nonnull<const Expr *> E) {
   return countPointersInType(exprType(E));
 }
 
-NullabilityKind TypeNullabilityDefaults::get(FileID File) const {
-  if (FileNullability && File.isValid()) {
-    if (auto It = FileNullability->find(File); It != FileNullability->end())
-      return It->second;
-  }
-  return DefaultNullability;
+std::optional<NullabilityKind> TypeNullabilityDefaults::getPragma(
+    FileID File) const {
+  if (!FileNullability || FileNullability->empty() || File.isInvalid())
+    return std::nullopt;
+  // Pragmas are recorded while parsing, but files are only looked up once
+  // their pragmas have been parsed, so the cached result stays valid even if
+  // the map grows.
+  if (File == LastFile && FileNullability == LastFileNullability)
+    return LastPragma;
+  LastFile = File;
+  LastFileNullability = FileNullability;
+  LastPragma = std::nullopt;
+  if (auto It = FileNullability->find(File); It != FileNullability->end())
+    LastPragma = It->second;
+  return LastPragma;
 }
 
-TypeNullability getTypeNullability(
+// Implementation of `getTypeNullability(QualType, ...)`, which also reports
+// whether `T` involves substituted template parameters (i.e. whether the result
+// may depend on `SubstituteTypeParam`).
+static TypeNullability getTypeNullabilityImpl(
     QualType T, FileID File, const TypeNullabilityDefaults &Defaults,
-    llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam) {
+    llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam,
+    bool &HasSubstitutedTypeParams) {
   CHECK(!T->isDependentType()) << T.getAsString();
 
   struct Walker : NullabilityWalker<Walker> {
-    std::vector<PointerTypeNullability> Annotations;
+    TypeNullability Annotations;
     llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam;
     const TypeNullabilityDefaults &Defaults;
+    bool HasSubstitutedTypeParams = false;
 
     Walker(FileID File, const TypeNullabilityDefaults &Defaults)
         : NullabilityWalker(File), Defaults(Defaults) {}
@@ -1011,6 +1061,7 @@ TypeNullability getTypeNullability(
     void visitSubstTemplateTypeParmType(
         absl::Nonnull<const SubstTemplateTypeParmType *> ST,
         std::optional<SubstTemplateTypeParmTypeLoc> L) {
+      HasSubstitutedTypeParams = true;
       if (SubstituteTypeParam) {
         if (auto Subst = SubstituteTypeParam(ST)) {
           DCHECK_EQ(Subst->size(),
@@ -1040,9 +1091,18 @@ TypeNullability getTypeNullability(
 
   AnnotationVisitor.SubstituteTypeParam = SubstituteTypeParam;
   AnnotationVisitor.visit(T, std::nullopt);
+  HasSubstitutedTypeParams = AnnotationVisitor.HasSubstitutedTypeParams;
   return std::move(AnnotationVisitor.Annotations);
 }
 
+TypeNullability getTypeNullability(
+    QualType T, FileID File, const TypeNullabilityDefaults &Defaults,
+    llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam) {
+  bool HasSubstitutedTypeParams;
+  return getTypeNullabilityImpl(T, File, Defaults, SubstituteTypeParam,
+                                HasSubstitutedTypeParams);
+}
+
 TypeNullability getTypeNullability(
     TypeLoc TL, const TypeNullabilityDefaults &Defaults,
     llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam) {
@@ -1057,8 +1117,53 @@ TypeNullability getTypeNullability(
 TypeNullability getTypeNullability(
     const ValueDecl &D, const TypeNullabilityDefaults &Defaults,
     llvm::function_ref<GetTypeParamNullability> SubstituteTypeParam) {
-  return getTypeNullability(D.getType(), getGoverningFile(&D), Defaults,
-                            SubstituteTypeParam);
+  DeclNullabilityCache *Cache = Defaults.DeclCache;
+  if (Cache == nullptr)
+    return getTypeNullability(D.getType(), getGoverningFile(&D), Defaults,
+                              SubstituteTypeParam);
+
+  if (const DeclNullabilityCache::Entry *E = Cache->lookup(D, Defaults);
+      E != nullptr && (!SubstituteTypeParam || !E->HasSubstitutedTypeParams)) {
+    Cache->recordHit();
+    return E->Nullability;
+  }
+  Cache->recordMiss();
+  bool HasSubstitutedTypeParams;
+  TypeNullability Result =
+      getTypeNullabilityImpl(D.getType(), getGoverningFile(&D), Defaults,
+                             SubstituteTypeParam, HasSubstitutedTypeParams);
+  // With substituted template parameters, `SubstituteTypeParam` may have
+  // changed the result.
+  if (!SubstituteTypeParam || !HasSubstitutedTypeParams)
+    Cache->insert(D, Defaults, {Result, HasSubstitutedTypeParams});
+  return Result;
+}
+
+void DeclNullabilityCache::checkDefaults(
+    const TypeNullabilityDefaults &Defaults) {
+  if (Defaults.Ctx == Ctx &&
+      Defaults.DefaultNullability == DefaultNullability &&
+      Defaults.FileNullability == FileNullability)
+    return;
+  Entries.clear();
+  Ctx = Defaults.Ctx;
+  DefaultNullability = Defaults.DefaultNullability;
+  FileNullability = Defaults.FileNullability;
+}
+
+absl::Nullable<const DeclNullabilityCache::Entry *>
+DeclNullabilityCache::lookup(const ValueDecl &D,
+                             const TypeNullabilityDefaults &Defaults) {
+  checkDefaults(Defaults);
+  auto It = Entries.find(&D);
+  return It == Entries.end() ? nullptr : &It->second;
+}
+
+void DeclNullabilityCache::insert(const ValueDecl &D,
+                                  const TypeNullabilityDefaults &Defaults,
+                                  Entry E) {
+  checkDefaults(Defaults);
+  Entries.insert_or_assign(&D, std::move(E));
 }
 
 TypeNullability getTypeNullability(
@@ -1207,11 +1312,7 @@ std::vector<TypeNullabilityLoc> getTypeNullabilityLocs(
         // existing annotation. Don't use Defaults.get(File) in order to avoid
         // treating a lack of pragma as an annotation of
         // Defaults.DefaultNullability.
-        if (Defaults.FileNullability && File.isValid()) {
-          if (auto It = Defaults.FileNullability->find(File);
-              It != Defaults.FileNullability->end())
-            NK = It->second;
-        }
+        NK = Defaults.getPragma(File);
       }
       TypeNullabilityLocs.push_back({Slot, T, Loc, NK});
       ++Slot;
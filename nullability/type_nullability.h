@@ -44,7 +44,9 @@
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/Specifiers.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace clang::tidy::nullability {
 
@@ -108,6 +110,41 @@ bool isUnknownValidOn(QualType);
 QualType underlyingRawPointerType(QualType,
                                   AccessSpecifier BaseAccess = AS_public);
 
+/// Is this exactly `std::weak_ptr`?
+/// This unwraps sugar, i.e. it looks at the canonical type.
+bool isStdWeakPtrType(QualType);
+
+/// Caches `underlyingRawPointerType()` and `isStdWeakPtrType()` per canonical
+/// record declaration. These look at the names, bases and member type aliases
+/// of the record, and the transfer functions query them for the same few
+/// smart pointer types over and over.
+///
+/// The cache is only valid for one AST, and for as long as smart pointer
+/// support isn't turned on or off. Records without a definition are not
+/// cached, as they may still be instantiated.
+class SmartPointerTypeCache {
+ public:
+  QualType underlyingRawPointerType(QualType,
+                                    AccessSpecifier BaseAccess = AS_public);
+  bool isSupportedSmartPointerType(QualType T) {
+    return !underlyingRawPointerType(T).isNull();
+  }
+  bool isStdWeakPtrType(QualType);
+
+ private:
+  struct Entry {
+    // Indexed by `AccessSpecifier`.
+    std::optional<QualType> RawPointerType[AS_none + 1];
+    bool IsStdWeakPtr;
+  };
+
+  // Returns the entry for the canonical record declaration of `T`, or null if
+  // `T` isn't a record type whose classification we cache.
+  absl::Nullable<Entry *> entry(QualType T);
+
+  llvm::DenseMap<const CXXRecordDecl *, Entry> Entries;
+};
+
 /// Describes the nullability contract of a pointer "slot" within a type.
 ///
 /// This may be concrete: nullable/non-null/unknown nullability.
@@ -182,7 +219,11 @@ class PointerTypeNullability {
 ///
 /// The concrete representation is currently the nullability of each nested
 /// PointerType encountered in a preorder traversal of the canonical type.
-using TypeNullability = std::vector<PointerTypeNullability>;
+///
+/// A TypeNullability is computed and copied for every expression the analysis
+/// visits, and most types contain only a few pointers, so up to three entries
+/// are stored inline.
+using TypeNullability = llvm::SmallVector<PointerTypeNullability, 3>;
 
 /// Returns a human-readable debug representation of a nullability vector.
 std::string nullabilityToString(const TypeNullability &Nullability);
@@ -192,6 +233,8 @@ std::string nullabilityToString(const TypeNullability &Nullability);
 using GetTypeParamNullability =
     std::optional<TypeNullability>(const SubstTemplateTypeParmType *ST);
 
+class DeclNullabilityCache;
+
 /// Describes how we should interpret unannotated pointer types (like `int*`).
 /// Typically these are treated as Unknown, and this behavior can be overridden
 /// by per-file pragmas.
@@ -202,7 +245,12 @@ struct TypeNullabilityDefaults {
       : Ctx(&Ctx), FileNullability(&Pragmas) {}
 
   // Get the effective default nullability for a particular file.
-  NullabilityKind get(FileID) const;
+  NullabilityKind get(FileID File) const {
+    return getPragma(File).value_or(DefaultNullability);
+  }
+
+  // Get the default nullability set by a pragma in a particular file, if any.
+  std::optional<NullabilityKind> getPragma(FileID) const;
 
   // The AST context is needed to resolve the associated file in some cases.
   // TODO(sammccall): this should always be provided, clean up callers.
@@ -213,6 +261,63 @@ struct TypeNullabilityDefaults {
   // Files where per-file pragmas have changed the default nullability.
   // TODO(sammccall)): this should always be provided, clean up callers.
   absl::Nullable<const NullabilityPragmas *> FileNullability;
+  // If set, `getTypeNullability()` of declarations is cached here. This lets
+  // the cache outlive the analysis of one function.
+  absl::Nullable<DeclNullabilityCache *> DeclCache = nullptr;
+
+ private:
+  // The result of the last `getPragma` lookup. Queries come in long runs for
+  // the same file (e.g. for all the types in a declaration), which this
+  // answers without a hash lookup.
+  mutable FileID LastFile;
+  mutable absl::Nullable<const NullabilityPragmas *> LastFileNullability =
+      nullptr;
+  mutable std::optional<NullabilityKind> LastPragma;
+};
+
+/// Caches `getTypeNullability(const ValueDecl &, ...)` across the analyses of
+/// the functions in a translation unit, which query the types of the same
+/// (e.g. popular API) declarations over and over.
+///
+/// The cache is only valid for one set of defaults: it is cleared when it is
+/// used with a `TypeNullabilityDefaults` that interprets unannotated pointers
+/// differently. Results that depend on a `GetTypeParamNullability` callback
+/// (i.e. for types involving substituted template parameters) are only cached
+/// for queries without a callback.
+class DeclNullabilityCache {
+ public:
+  struct Entry {
+    TypeNullability Nullability;
+    // Whether the type of the declaration involves substituted template
+    // parameters, for which a `GetTypeParamNullability` may provide a
+    // different result.
+    bool HasSubstitutedTypeParams;
+  };
+
+  /// Returns the entry for `D`, if there is one and it is valid for
+  /// `Defaults`.
+  absl::Nullable<const Entry *> lookup(const ValueDecl &D,
+                                       const TypeNullabilityDefaults &Defaults);
+  void insert(const ValueDecl &D, const TypeNullabilityDefaults &Defaults,
+              Entry E);
+
+  void recordHit() { ++Hits; }
+  void recordMiss() { ++Misses; }
+  unsigned hits() const { return Hits; }
+  unsigned misses() const { return Misses; }
+
+ private:
+  // Clears the cache if it was filled using different defaults.
+  void checkDefaults(const TypeNullabilityDefaults &Defaults);
+
+  // The defaults which the entries were computed with.
+  absl::Nullable<ASTContext *> Ctx = nullptr;
+  NullabilityKind DefaultNullability = NullabilityKind::Unspecified;
+  absl::Nullable<const NullabilityPragmas *> FileNullability = nullptr;
+
+  llvm::DenseMap<const ValueDecl *, Entry> Entries;
+  unsigned Hits = 0;
+  unsigned Misses = 0;
 };
 
 /// Traverse over a type to get its nullability. For example, if T is the type
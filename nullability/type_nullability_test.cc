@@ -42,6 +42,7 @@ using ::clang::ast_matchers::hasName;
 using ::clang::ast_matchers::match;
 using ::clang::ast_matchers::selectFirst;
 using ::clang::ast_matchers::typeAliasDecl;
+using ::clang::ast_matchers::varDecl;
 using ::llvm::Annotations;
 using ::testing::ElementsAre;
 using ::testing::FieldsAre;
@@ -378,6 +379,57 @@ TEST_F(UnderlyingRawPointerTest, InscrutableDerivedSmartPointer) {
   EXPECT_EQ(underlyingRawPointerType(Target->getUnderlyingType()), QualType());
 }
 
+TEST_F(UnderlyingRawPointerTest, SmartPointerTypeCache) {
+  TestAST AST(R"cpp(
+    namespace std {
+    template <typename T>
+    class unique_ptr {
+      using pointer = T *;
+    };
+    template <typename T>
+    class weak_ptr {};
+    }  // namespace std
+
+    template <typename T>
+    struct PrivateDerived : private std::unique_ptr<T> {};
+
+    using UniquePointer = std::unique_ptr<int>;
+    using SugaredPointer = UniquePointer;
+    using WeakPointer = std::weak_ptr<int>;
+    using PrivateDerivedPointer = PrivateDerived<int>;
+    using NotPointer = int;
+
+    UniquePointer U;
+    WeakPointer W;
+    PrivateDerivedPointer P;
+  )cpp");
+
+  SmartPointerTypeCache Cache;
+  // Ask for each type twice, so that the second query hits the cache.
+  for (int I = 0; I < 2; ++I) {
+    for (llvm::StringRef Name :
+         {"UniquePointer", "SugaredPointer", "WeakPointer",
+          "PrivateDerivedPointer", "NotPointer"}) {
+      QualType T = underlying(Name, AST);
+      EXPECT_EQ(Cache.underlyingRawPointerType(T), underlyingRawPointerType(T))
+          << Name;
+      EXPECT_EQ(Cache.underlyingRawPointerType(T, AS_private),
+                underlyingRawPointerType(T, AS_private))
+          << Name;
+      EXPECT_EQ(Cache.isSupportedSmartPointerType(T),
+                isSupportedSmartPointerType(T))
+          << Name;
+      EXPECT_EQ(Cache.isStdWeakPtrType(T), isStdWeakPtrType(T)) << Name;
+    }
+  }
+
+  QualType PrivateDerived = underlying("PrivateDerivedPointer", AST);
+  EXPECT_EQ(Cache.underlyingRawPointerType(PrivateDerived), QualType());
+  EXPECT_EQ(Cache.underlyingRawPointerType(PrivateDerived, AS_private),
+            AST.context().getPointerType(AST.context().IntTy));
+  EXPECT_TRUE(Cache.isStdWeakPtrType(underlying("WeakPointer", AST)));
+}
+
 std::function<std::unique_ptr<FrontendAction>()> makeRegisterPragmasAction(
     NullabilityPragmas &Pragmas) {
   return [&Pragmas]() {
@@ -627,6 +679,38 @@ TEST_F(GetTypeNullabilityTest, PragmaSmartPointers) {
               ElementsAre(NullabilityKind::Nullable));
 }
 
+TEST(DeclNullabilityCacheTest, CachesPerDefaults) {
+  TestAST AST("int *_Nullable X; int *Y;");
+  auto GetDecl = [&](llvm::StringRef Name) -> const VarDecl & {
+    return *selectFirst<VarDecl>(
+        "d", match(varDecl(hasName(Name)).bind("d"), AST.context()));
+  };
+  NullabilityPragmas Pragmas;
+  DeclNullabilityCache Cache;
+  TypeNullabilityDefaults Defaults(AST.context(), Pragmas);
+  Defaults.DeclCache = &Cache;
+
+  EXPECT_THAT(getTypeNullability(GetDecl("X"), Defaults),
+              ElementsAre(NullabilityKind::Nullable));
+  EXPECT_THAT(getTypeNullability(GetDecl("X"), Defaults),
+              ElementsAre(NullabilityKind::Nullable));
+  EXPECT_THAT(getTypeNullability(GetDecl("Y"), Defaults),
+              ElementsAre(NullabilityKind::Unspecified));
+  EXPECT_EQ(Cache.hits(), 1);
+  EXPECT_EQ(Cache.misses(), 2);
+
+  // Different defaults invalidate the cache.
+  TypeNullabilityDefaults NonnullDefaults(AST.context(), Pragmas);
+  NonnullDefaults.DefaultNullability = NullabilityKind::NonNull;
+  NonnullDefaults.DeclCache = &Cache;
+  EXPECT_THAT(getTypeNullability(GetDecl("Y"), NonnullDefaults),
+              ElementsAre(NullabilityKind::NonNull));
+  EXPECT_THAT(getTypeNullability(GetDecl("X"), NonnullDefaults),
+              ElementsAre(NullabilityKind::Nullable));
+  EXPECT_EQ(Cache.hits(), 1);
+  EXPECT_EQ(Cache.misses(), 4);
+}
+
 TEST(IsUnknownValidOnTest, All) {
   std::string Preamble = R"cpp(
     namespace std {
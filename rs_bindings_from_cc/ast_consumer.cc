@@ -6,6 +6,7 @@
 
 #include "absl/log/check.h"
 #include "rs_bindings_from_cc/importer.h"
+#include "rs_bindings_from_cc/timing_report.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/Frontend/CompilerInstance.h"
 
@@ -20,6 +21,7 @@ void AstConsumer::HandleTranslationUnit(clang::ASTContext& ast_context) {
     return;
   }
   CHECK(instance_.hasSema());
+  TimingReport::ScopedPhase phase(invocation_.timing_report_, "import");
   Importer importer(invocation_, ast_context, instance_.getSema());
   importer.Import(ast_context.getTranslationUnitDecl());
 }
@@ -13,7 +13,9 @@ def compile_cc(
         src,
         cc_infos,
         extra_cc_compilation_action_inputs,
-        extra_hdrs = []):
+        extra_hdrs = [],
+        extra_copts = [],
+        extra_srcs = []):
     """Compiles a C++ source file.
 
     Args:
@@ -25,6 +27,10 @@ def compile_cc(
       cc_infos: List[CcInfo]: A list of CcInfo dependencies.
       extra_cc_compilation_action_inputs: A list of input files for the C++ compilation action.
       extra_hdrs: A list of headers to be passed to the C++ compilation action.
+      extra_copts: A list of flags to be passed to the C++ compilation action, after the `copts`
+        of the current rule.
+      extra_srcs: A list of additional C++ source files to be compiled (in separate actions)
+        together with `src`.
 
     Returns:
       A CcInfo provider.
@@ -35,13 +41,14 @@ def compile_cc(
     for copt in getattr(attr, "copts", []):
         # ctx.expand_make_variables is deprecated, but its replacement ctx.var does not suffice.
         user_copts.append(ctx.expand_make_variables("copts", copt, {}))
+    user_copts.extend(extra_copts)
 
     (compilation_context, compilation_outputs) = cc_common.compile(
         name = src.basename,
         actions = ctx.actions,
         feature_configuration = feature_configuration,
         cc_toolchain = cc_toolchain,
-        srcs = [src],
+        srcs = [src] + extra_srcs,
         public_hdrs = extra_hdrs,
         additional_inputs = extra_cc_compilation_action_inputs,
         user_compile_flags = user_copts,
@@ -33,7 +33,7 @@ def _get_cc_info(providers):
             return provider
     fail("Couldn't find a CcInfo in the list of providers")
 
-def compile_rust(ctx, attr, src, extra_srcs, deps, crate_name, include_coverage, force_all_deps_direct):
+def compile_rust(ctx, attr, src, extra_srcs, deps, crate_name, include_coverage, force_all_deps_direct, extra_rust_flags = []):
     """Compiles a Rust source file.
 
     Args:
@@ -45,6 +45,7 @@ def compile_rust(ctx, attr, src, extra_srcs, deps, crate_name, include_coverage,
       crate_name: (string) crate name for naming the output files (.rlib, .rmeta...))
       include_coverage: (bool) Whether or not coverage information should be generated.
       force_all_deps_direct: (bool) Whether or not to force all deps to be direct.
+      extra_rust_flags: List[string]: Additional flags to pass to rustc.
 
     Returns:
       A DepVariantInfo provider.
@@ -96,7 +97,7 @@ def compile_rust(ctx, attr, src, extra_srcs, deps, crate_name, include_coverage,
             owner = ctx.label,
         ),
         # LINT.IfChange
-        rust_flags = ["-Zallow-features=custom_inner_attributes,impl_trait_in_assoc_type,register_tool,negative_impls,vec_into_raw_parts,extern_types,arbitrary_self_types,allocator_api"],
+        rust_flags = ["-Zallow-features=custom_inner_attributes,impl_trait_in_assoc_type,register_tool,negative_impls,vec_into_raw_parts,extern_types,arbitrary_self_types,allocator_api"] + extra_rust_flags,
         # LINT.ThenChange(//docs/overview/unstable_features.md)
         output_hash = output_hash,
         force_all_deps_direct = force_all_deps_direct,
@@ -44,9 +44,169 @@ def _get_extra_rs_srcs_command_line(extra_rs_srcs):
             extra_rs_src_info.append(file.path)
     return ["--extra_rs_srcs=" + ",".join(extra_rs_src_info)]
 
+def _get_precompiled_modules_command_line(precompiled_modules):
+    if not precompiled_modules:
+        return []
+    flags = [
+        "-fmodules",
+        "-fno-implicit-modules",
+        "-fno-implicit-module-maps",
+        "-Xclang",
+        "-fmodule-map-file-home-is-cwd",
+    ]
+    for precompiled_module in precompiled_modules:
+        flags.append("-fmodule-map-file=" + precompiled_module.module_map.path)
+        flags.append("-fmodule-file=" + precompiled_module.pcm.path)
+    return flags
+
 def _get_include_paths_for_builtin_headers_and_compiler_rt_headers(ctx, cc_toolchain):
     return [cc_toolchain.built_in_include_directories[1]]
 
+def _create_compile_variables(common, rs_bindings_from_cc_flags):
+    """Returns the compile variables of an `rs_bindings_from_cc` action.
+
+    Args:
+      common: A struct with the arguments of `generate_bindings` that are shared by all of its
+              actions, like `ctx`, `cc_toolchain` and `compilation_context`.
+      rs_bindings_from_cc_flags: The flags of this action.
+    """
+    cc_toolchain = common.cc_toolchain
+    return cc_common.create_compile_variables(
+        feature_configuration = common.feature_configuration,
+        cc_toolchain = cc_toolchain,
+        system_include_directories = depset(
+            direct = [
+               # libcxx headers.
+               cc_toolchain.built_in_include_directories[0],
+            ] + _get_include_paths_for_builtin_headers_and_compiler_rt_headers(common.ctx, cc_toolchain) + [
+               cc_toolchain.built_in_include_directories[2],
+            ],
+            transitive = [common.compilation_context.system_includes],
+        ),
+        include_directories = common.compilation_context.includes,
+        quote_include_directories = common.compilation_context.quote_includes,
+        user_compile_flags = common.ctx.fragments.cpp.copts +
+                             common.ctx.fragments.cpp.cxxopts +
+                             common.header_includes + (
+            common.attr.copts if hasattr(common.attr, "copts") else []
+        ) + _get_precompiled_modules_command_line(common.dep_precompiled_modules),
+        preprocessor_defines = common.compilation_context.defines,
+        variables_extension = {
+            "rs_bindings_from_cc_tool": common.rs_bindings_from_cc_tool.path,
+            "rs_bindings_from_cc_flags": rs_bindings_from_cc_flags + _get_hdrs_command_line(common.public_hdrs),
+            "target_args": common.target_args,
+        },
+    )
+
+def _run_persistent_worker(
+        ctx,
+        cc_toolchain,
+        feature_configuration,
+        compilation_context,
+        variables,
+        rs_bindings_from_cc_tool,
+        inputs,
+        outputs,
+        mnemonic = "RustBindingsFromCc",
+        progress_message = "Generating Rust bindings for %{label}"):
+    """Runs the same command line as the `rs_bindings_from_cc` compile action in a persistent worker.
+
+    Bazel only sends the arguments in the params file to the worker, so all of them are put there.
+
+    Args:
+      ctx: The rule context.
+      cc_toolchain: The cc_toolchain.
+      feature_configuration: The feature configuration.
+      compilation_context: The compilation context for this action.
+      variables: The compile variables of the action.
+      rs_bindings_from_cc_tool: The `rs_bindings_from_cc` binary.
+      inputs: A depset of inputs of the action, in addition to the headers and the toolchain.
+      outputs: The outputs of the action.
+      mnemonic: The mnemonic of the action.
+      progress_message: The progress message of the action.
+    """
+    command_line = cc_common.get_memory_inefficient_command_line(
+        feature_configuration = feature_configuration,
+        action_name = ACTION_NAMES.rs_bindings_from_cc,
+        variables = variables,
+    )
+
+    # The command line of the compile action may start with the path of the tool it wraps.
+    if command_line and command_line[0] == rs_bindings_from_cc_tool.path:
+        command_line = command_line[1:]
+
+    args = ctx.actions.args()
+    args.add_all(command_line)
+    args.use_param_file("@%s", use_always = True)
+    args.set_param_file_format("multiline")
+
+    ctx.actions.run(
+        executable = rs_bindings_from_cc_tool,
+        arguments = [args],
+        inputs = depset(transitive = [inputs, compilation_context.headers, cc_toolchain.all_files]),
+        outputs = outputs,
+        env = cc_common.get_environment_variables(
+            feature_configuration = feature_configuration,
+            action_name = ACTION_NAMES.rs_bindings_from_cc,
+            variables = variables,
+        ),
+        execution_requirements = {
+            "requires-worker-protocol": "json",
+            "supports-workers": "1",
+        },
+        mnemonic = mnemonic,
+        progress_message = progress_message,
+    )
+
+def _build_precompiled_module(ctx, common, common_flags, precompiled_module, inputs):
+    """Builds the precompiled Clang module of the public headers in an action of its own.
+
+    Bindings generation for the dependent targets only needs the module, not the bindings. Building
+    it separately means that they don't wait for the bindings of this target to be generated, so
+    that the bindings of a chain of targets are generated in parallel, after their (shorter)
+    module actions.
+
+    Args:
+      ctx: The rule context.
+      common: The struct with the arguments that are shared by all `rs_bindings_from_cc` actions.
+      common_flags: The flags that are shared by all `rs_bindings_from_cc` actions.
+      precompiled_module: The struct(module_map, pcm) to build.
+      inputs: A depset of inputs of the action, in addition to the headers and the toolchain.
+    """
+    variables = _create_compile_variables(common, common_flags + [
+        "--precompiled_module_only",
+        "--module_map_out",
+        precompiled_module.module_map.path,
+        "--pcm_out",
+        precompiled_module.pcm.path,
+    ])
+    if ctx.attr._use_persistent_worker[BuildSettingInfo].value:
+        _run_persistent_worker(
+            ctx,
+            common.cc_toolchain,
+            common.feature_configuration,
+            common.compilation_context,
+            variables,
+            common.rs_bindings_from_cc_tool,
+            inputs,
+            [precompiled_module.module_map, precompiled_module.pcm],
+            mnemonic = "RustBindingsFromCcModule",
+            progress_message = "Precompiling the Clang module of %{label}",
+        )
+        return
+    cc_common.create_compile_action(
+        compilation_context = common.compilation_context,
+        actions = ctx.actions,
+        action_name = ACTION_NAMES.rs_bindings_from_cc,
+        feature_configuration = common.feature_configuration,
+        cc_toolchain = common.cc_toolchain,
+        source_file = common.public_hdrs[0],
+        output_file = precompiled_module.pcm,
+        additional_inputs = inputs,
+        additional_outputs = [precompiled_module.module_map],
+        variables = variables,
+    )
+
 def generate_bindings(
         ctx,
         attr,
@@ -58,7 +218,8 @@ def generate_bindings(
         action_inputs,
         target_args,
         extra_rs_srcs,
-        extra_rs_bindings_from_cc_cli_flags):
+        extra_rs_bindings_from_cc_cli_flags,
+        precompiled_modules = depset()):
     """Runs the bindings generator.
 
     Args:
@@ -74,25 +235,31 @@ def generate_bindings(
                         its per-target arguments (headers, features) in json format.
       extra_rs_srcs: A list of extra source files to add.
       extra_rs_bindings_from_cc_cli_flags: CLI flags to be passed to `rs_bindings_from_cc`.
+      precompiled_modules: A depset of structs(module_map, pcm) with the precompiled Clang modules
+                           of the dependencies. Their headers are loaded from the modules instead of
+                           being parsed again.
 
     Returns:
-      tuple(cc_output, rs_output, namespaces_output, error_report_output): The generated source files.
+      tuple(cc_output, rs_output, namespaces_output, error_report_output, precompiled_module,
+            rs_modules_output, cc_output_shards, api_hash_output):
+        The generated source files, the struct(module_map, pcm) with the precompiled Clang
+        module of the public headers (or None if precompiled modules are disabled), the
+        directory with the modules that were split out of `rs_output` (or None if splitting the
+        Rust source code by namespace is disabled), the list of additional shards of
+        `cc_output`, and the file with the hash of the API of `rs_output`, which only changes
+        when the API does.
     """
     crate_name = escape_cpp_target_name(ctx.label.package, ctx.label.name)
     cc_output = ctx.actions.declare_file(crate_name + "_rust_api_impl.cc")
     rs_output = ctx.actions.declare_file(crate_name + "_rust_api.rs")
     namespaces_output = ctx.actions.declare_file(crate_name + "_namespaces.json")
+    api_hash_output = ctx.actions.declare_file(crate_name + "_rust_api_hash.txt")
     error_report_output = None
 
-    rs_bindings_from_cc_flags = [
+    # The flags that both the bindings action and the precompiled module action need.
+    common_flags = [
         "--stderrthreshold=2",
         "--target=" + str(ctx.label),
-        "--rs_out",
-        rs_output.path,
-        "--cc_out",
-        cc_output.path,
-        "--namespaces_out",
-        namespaces_output.path,
         "--crubit_support_path_format",
         "\"support/{header}\"",
         "--clang_format_exe_path",
@@ -102,12 +269,49 @@ def generate_bindings(
         "--rustfmt_config_path",
         ctx.file._rustfmt_cfg.path,
     ] + extra_rs_bindings_from_cc_cli_flags
-    if ctx.attr._generate_error_report[BuildSettingInfo].value:
+    rs_bindings_from_cc_flags = common_flags + [
+        "--rs_out",
+        rs_output.path,
+        "--cc_out",
+        cc_output.path,
+        "--namespaces_out",
+        namespaces_output.path,
+        "--api_hash_out",
+        api_hash_output.path,
+    ]
+    generate_unsupported_item_comments = ctx.attr._generate_unsupported_item_comments[BuildSettingInfo].value
+    if ctx.attr._generate_error_report[BuildSettingInfo].value or not generate_unsupported_item_comments:
         error_report_output = ctx.actions.declare_file(crate_name + "_rust_api_error_report.json")
         rs_bindings_from_cc_flags += [
             "--error_report_out",
             error_report_output.path,
         ]
+    if not generate_unsupported_item_comments:
+        rs_bindings_from_cc_flags.append("--nogenerate_unsupported_item_comments")
+    if ctx.attr._aggregate_layout_assertions[BuildSettingInfo].value:
+        rs_bindings_from_cc_flags.append("--aggregate_layout_assertions")
+    cc_output_shards = [
+        ctx.actions.declare_file(crate_name + "_rust_api_impl_%d.cc" % i)
+        for i in range(1, ctx.attr._rs_api_impl_shards[BuildSettingInfo].value)
+    ]
+    if cc_output_shards:
+        rs_bindings_from_cc_flags.append(
+            "--cc_out_shards=" + ",".join([f.path for f in cc_output_shards]),
+        )
+    rs_modules_output = None
+    if ctx.attr._split_rs_api_by_namespace[BuildSettingInfo].value:
+        rs_modules_output = ctx.actions.declare_directory(crate_name + "_rust_api_modules")
+        rs_bindings_from_cc_flags += [
+            "--rs_out_modules_dir",
+            rs_modules_output.path,
+        ]
+    precompiled_module = None
+    if ctx.attr._use_precompiled_modules[BuildSettingInfo].value:
+        precompiled_module = struct(
+            module_map = ctx.actions.declare_file(crate_name + "_rust_api.cppmap"),
+            pcm = ctx.actions.declare_file(crate_name + "_rust_api.pcm"),
+        )
+    dep_precompiled_modules = precompiled_modules.to_list()
 
     # TODO(b/324159705): Remove this workaround and fix
     # built_in_include_directories logic once we switch to libc++ runtimes on
@@ -118,32 +322,58 @@ def generate_bindings(
     toolchain = ctx.toolchains["@@//rs_bindings_from_cc/bazel_support:toolchain_type"]
     rs_bindings_from_cc_tool = toolchain.rs_bindings_from_cc_toolchain_info.binary
 
-    variables = cc_common.create_compile_variables(
-        feature_configuration = feature_configuration,
+    common_args = struct(
+        ctx = ctx,
+        attr = attr,
         cc_toolchain = cc_toolchain,
-        system_include_directories = depset(
-            direct = [
-               # libcxx headers.
-               cc_toolchain.built_in_include_directories[0],
-            ] + _get_include_paths_for_builtin_headers_and_compiler_rt_headers(ctx, cc_toolchain) + [
-               cc_toolchain.built_in_include_directories[2],
-            ],
-            transitive = [compilation_context.system_includes],
-        ),
-        include_directories = compilation_context.includes,
-        quote_include_directories = compilation_context.quote_includes,
-        user_compile_flags = ctx.fragments.cpp.copts +
-                             ctx.fragments.cpp.cxxopts +
-                             header_includes + (
-            attr.copts if hasattr(attr, "copts") else []
-        ),
-        preprocessor_defines = compilation_context.defines,
-        variables_extension = {
-            "rs_bindings_from_cc_tool": rs_bindings_from_cc_tool.path,
-            "rs_bindings_from_cc_flags": rs_bindings_from_cc_flags + _get_hdrs_command_line(public_hdrs) + _get_extra_rs_srcs_command_line(extra_rs_srcs),
-            "target_args": target_args,
-        },
+        feature_configuration = feature_configuration,
+        compilation_context = compilation_context,
+        public_hdrs = public_hdrs,
+        header_includes = header_includes,
+        target_args = target_args,
+        dep_precompiled_modules = dep_precompiled_modules,
+        rs_bindings_from_cc_tool = rs_bindings_from_cc_tool,
+    )
+    variables = _create_compile_variables(
+        common_args,
+        rs_bindings_from_cc_flags + _get_extra_rs_srcs_command_line(extra_rs_srcs),
+    )
+
+    additional_inputs = depset(
+        direct = [
+            ctx.executable._clang_format,
+            ctx.executable._rustfmt,
+            rs_bindings_from_cc_tool,
+        ] + ctx.files._rustfmt_cfg + [f for f, _ in extra_rs_srcs] + [
+            f
+            for m in dep_precompiled_modules
+            for f in [m.module_map, m.pcm]
+        ],
+        transitive = [action_inputs],
     )
+    additional_outputs = [x for x in [rs_output, namespaces_output, api_hash_output, error_report_output, rs_modules_output] if x != None] + cc_output_shards
+
+    if precompiled_module:
+        _build_precompiled_module(
+            ctx,
+            common_args,
+            common_flags,
+            precompiled_module,
+            additional_inputs,
+        )
+
+    if ctx.attr._use_persistent_worker[BuildSettingInfo].value:
+        _run_persistent_worker(
+            ctx,
+            cc_toolchain,
+            feature_configuration,
+            compilation_context,
+            variables,
+            rs_bindings_from_cc_tool,
+            additional_inputs,
+            [cc_output] + additional_outputs,
+        )
+        return (cc_output, rs_output, namespaces_output, error_report_output, precompiled_module, rs_modules_output, cc_output_shards, api_hash_output)
 
     # Run the `rs_bindings_from_cc` to generate the _rust_api_impl.cc and _rust_api.rs files.
     cc_common.create_compile_action(
@@ -154,15 +384,8 @@ def generate_bindings(
         cc_toolchain = cc_toolchain,
         source_file = public_hdrs[0],
         output_file = cc_output,
-        additional_inputs = depset(
-            direct = [
-                ctx.executable._clang_format,
-                ctx.executable._rustfmt,
-                rs_bindings_from_cc_tool,
-            ] + ctx.files._rustfmt_cfg + [f for f, _ in extra_rs_srcs],
-            transitive = [action_inputs],
-        ),
-        additional_outputs = [x for x in [rs_output, namespaces_output, error_report_output] if x != None],
+        additional_inputs = additional_inputs,
+        additional_outputs = additional_outputs,
         variables = variables,
     )
-    return (cc_output, rs_output, namespaces_output, error_report_output)
+    return (cc_output, rs_output, namespaces_output, error_report_output, precompiled_module, rs_modules_output, cc_output_shards, api_hash_output)
@@ -0,0 +1,149 @@
+# Part of the Crubit project, under the Apache License v2.0 with LLVM
+# Exceptions. See /LICENSE for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""The `prebuilt_crubit_bindings` aspect hint, when attached to a `cc_library`, provides prebuilt
+Rust bindings for it, which are used instead of running `rs_bindings_from_cc`.
+
+This is meant for widely-used, version-pinned third-party libraries (e.g. Abseil or the protobuf
+runtime), whose bindings would otherwise be regenerated in every build configuration of every
+build. The prebuilt bindings are the generated source files, which are still compiled as part of
+the build, because the compiled objects depend on the build configuration.
+
+The bindings are only valid for the exact headers that they were generated from. `header_hash`
+pins them: it is the SHA-256 of the concatenation of the public headers of the `cc_library`, in
+the order of its `hdrs`, as computed by e.g.
+
+```
+cat <hdrs...> | sha256sum
+```
+
+If the headers change (e.g. when the library is updated), the validation action fails the build
+until the prebuilt bindings are regenerated and `header_hash` is updated.
+"""
+
+visibility(["//..."])
+
+PrebuiltCrubitBindingsInfo = provider(
+    doc = """
+The provider that specifies the prebuilt bindings of a C++ target, and the hash of the headers
+that they were generated from.
+""",
+    fields = {
+        "rs_api": "The generated Rust source file.",
+        "rs_api_impl": "The generated C++ source file.",
+        "namespaces": "The generated namespace hierarchy in JSON format, or None.",
+        "api_hash": "The hash of the API of `rs_api`, or None.",
+        "header_hash": "The SHA-256 of the public headers that the bindings were generated from.",
+    },
+)
+
+def _prebuilt_crubit_bindings_impl(ctx):
+    return [PrebuiltCrubitBindingsInfo(
+        rs_api = ctx.file.rs_api,
+        rs_api_impl = ctx.file.rs_api_impl,
+        namespaces = ctx.file.namespaces,
+        api_hash = ctx.file.api_hash,
+        header_hash = ctx.attr.header_hash,
+    )]
+
+prebuilt_crubit_bindings = rule(
+    attrs = {
+        "rs_api": attr.label(
+            doc = "The `_rust_api.rs` file generated by `rs_bindings_from_cc`.",
+            allow_single_file = [".rs"],
+            mandatory = True,
+        ),
+        "rs_api_impl": attr.label(
+            doc = "The `_rust_api_impl.cc` file generated by `rs_bindings_from_cc`.",
+            allow_single_file = [".cc"],
+            mandatory = True,
+        ),
+        "namespaces": attr.label(
+            doc = "The `_namespaces.json` file generated by `rs_bindings_from_cc`.",
+            allow_single_file = [".json"],
+        ),
+        "api_hash": attr.label(
+            doc = "The `_rust_api_hash.txt` file generated by `rs_bindings_from_cc`.",
+            allow_single_file = [".txt"],
+        ),
+        "header_hash": attr.string(
+            doc = "The SHA-256 of the public headers that the bindings were generated from.",
+            mandatory = True,
+        ),
+    },
+    implementation = _prebuilt_crubit_bindings_impl,
+    doc = """
+Defines an aspect hint that provides the prebuilt Rust bindings of a `cc_library`, which are used
+instead of generating them.
+""",
+)
+
+def get_prebuilt_bindings(aspect_ctx):
+    """Returns the `PrebuiltCrubitBindingsInfo` attached to the `_target`, or None.
+
+    Args:
+        aspect_ctx: The ctx from an aspect_hint.
+
+    Returns:
+        The `PrebuiltCrubitBindingsInfo` of the `prebuilt_crubit_bindings` aspect hint, or None if
+        the target doesn't have one.
+    """
+    for hint in aspect_ctx.rule.attr.aspect_hints:
+        if PrebuiltCrubitBindingsInfo in hint:
+            return hint[PrebuiltCrubitBindingsInfo]
+    return None
+
+def use_prebuilt_bindings(ctx, prebuilt_bindings, crate_name, public_hdrs):
+    """Makes the prebuilt bindings available in place of generated ones.
+
+    The prebuilt files are symlinked to the paths of the files that `generate_bindings` would
+    generate, so that the rest of the build doesn't need to distinguish between them.
+
+    Args:
+        ctx: The rule context.
+        prebuilt_bindings: The `PrebuiltCrubitBindingsInfo` of the target.
+        crate_name: The name of the crate of the bindings.
+        public_hdrs: The public headers of the target.
+
+    Returns:
+      tuple(cc_output, rs_output, namespaces_output, api_hash_output, validation_output):
+        The source files of the bindings (`namespaces_output` and `api_hash_output` are None if
+        they aren't prebuilt), and the output of the action that verifies that the bindings were
+        generated from `public_hdrs`.
+    """
+
+    def symlink(prebuilt_file, name):
+        if prebuilt_file == None:
+            return None
+        output = ctx.actions.declare_file(name)
+        ctx.actions.symlink(output = output, target_file = prebuilt_file)
+        return output
+
+    cc_output = symlink(prebuilt_bindings.rs_api_impl, crate_name + "_rust_api_impl.cc")
+    rs_output = symlink(prebuilt_bindings.rs_api, crate_name + "_rust_api.rs")
+    namespaces_output = symlink(prebuilt_bindings.namespaces, crate_name + "_namespaces.json")
+    api_hash_output = symlink(prebuilt_bindings.api_hash, crate_name + "_rust_api_hash.txt")
+
+    validation_output = ctx.actions.declare_file(crate_name + "_prebuilt_bindings_validation")
+    ctx.actions.run_shell(
+        inputs = public_hdrs,
+        outputs = [validation_output],
+        command = """
+actual=$(cat "${@:4}" | sha256sum | cut -d' ' -f1)
+if [[ "$actual" != "$2" ]]; then
+  echo "The prebuilt Rust bindings of $3 are out of date: the headers hash to $actual, but" \\
+       "the header_hash of the bindings is $2. Regenerate the bindings and update their" \\
+       "header_hash." >&2
+  exit 1
+fi
+touch "$1"
+""",
+        arguments = [validation_output.path, prebuilt_bindings.header_hash, str(ctx.label)] + [
+            h.path
+            for h in public_hdrs
+        ],
+        mnemonic = "CrubitPrebuiltBindingsValidation",
+        progress_message = "Validating the prebuilt Rust bindings of %{label}",
+    )
+    return (cc_output, rs_output, namespaces_output, api_hash_output, validation_output)
@@ -17,12 +17,20 @@ RustBindingsFromCcInfo = provider(
                         "{'t': <target>, 'h': [<header>], 'f': [<feature>]}"),
         "namespaces": ("A json file containing the namespace hierarchy for the target we " +
                        "are generating bindings for, or None."),
+        "precompiled_modules": ("A depset of structs(module_map, pcm) with the precompiled Clang " +
+                                "modules of the public headers of the target and its transitive " +
+                                "dependencies. Not set for real Rust targets."),
     },
 )
 
 RustToolchainHeadersInfo = provider(
     doc = "A provider that contains all toolchain C++ headers",
-    fields = {"headers": "depset"},
+    fields = {
+        "headers": "depset",
+        "target_args_file": ("A JSON file with the target_args of the toolchain headers, which " +
+                             "is passed to bindings generation for every target via " +
+                             "`--target_args_file`."),
+    },
 )
 
 GeneratedBindingsInfo = provider(
@@ -31,6 +39,10 @@ GeneratedBindingsInfo = provider(
         "cc_file": "The generated C++ source file.",
         "rust_file": "The generated Rust source file.",
         "namespaces_file": "The generated namespace hierarchy in JSON format.",
+        "api_hash_file": ("A file with a hash of the API of `rust_file`, which ignores comments " +
+                          "and formatting. Unlike `rust_file`, it doesn't change when only " +
+                          "implementation details of the C++ headers do, so dependents can key " +
+                          "on it instead."),
     },
 )
 
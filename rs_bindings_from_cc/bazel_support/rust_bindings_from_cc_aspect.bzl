@@ -15,6 +15,10 @@ load(
     "@@//rs_bindings_from_cc/bazel_support:additional_rust_srcs_for_crubit_bindings_aspect_hint.bzl",
     "get_additional_rust_srcs",
 )
+load(
+    "@@//rs_bindings_from_cc/bazel_support:prebuilt_crubit_bindings_aspect_hint.bzl",
+    "get_prebuilt_bindings",
+)
 load(
     "@@//rs_bindings_from_cc/bazel_support:providers.bzl",
     "DepsForBindingsInfo",
@@ -154,10 +158,9 @@ def _rust_bindings_from_cc_aspect_impl(target, ctx):
         extra_cc_compilation_action_inputs = public_hdrs
 
     all_deps = getattr(ctx.rule.attr, "deps", []) + extra_rule_specific_deps + [
-        # TODO(b/217667751): This contains a huge list of headers_and_targets; pass them as a file
-        # instead.
         ctx.attr._std,
     ]
+    toolchain_target_args_file = ctx.attr._std[RustToolchainHeadersInfo].target_args_file
 
     # At execution time we convert this depset to a json array that gets passed to our tool through
     # the --target_args flag.
@@ -179,10 +182,12 @@ def _rust_bindings_from_cc_aspect_impl(target, ctx):
 
     target_args = depset(
         direct = direct,
+        # The target_args of the toolchain headers contain a huge list of headers, so they are
+        # passed via `--target_args_file` instead.
         transitive = [
             t[RustBindingsFromCcInfo].target_args
             for t in all_deps
-            if RustBindingsFromCcInfo in t
+            if RustBindingsFromCcInfo in t and t.label != ctx.attr._std.label
         ],
     )
 
@@ -200,7 +205,7 @@ def _rust_bindings_from_cc_aspect_impl(target, ctx):
         public_hdrs = public_hdrs,
         header_includes = header_includes,
         action_inputs = depset(
-            direct = public_hdrs + toolchain.builtin_headers,
+            direct = public_hdrs + toolchain.builtin_headers + [toolchain_target_args_file],
             transitive = [
                 ctx.attr._std[RustToolchainHeadersInfo].headers,
             ],
@@ -219,8 +224,17 @@ def _rust_bindings_from_cc_aspect_impl(target, ctx):
             if RustBindingsFromCcInfo in dep
         ] + ctx.attr._deps_for_bindings[DepsForBindingsInfo].deps_for_rs_file,
         extra_cc_compilation_action_inputs = extra_cc_compilation_action_inputs,
-        extra_rs_bindings_from_cc_cli_flags = collect_rust_bindings_from_cc_cli_flags(target, ctx),
+        extra_rs_bindings_from_cc_cli_flags = collect_rust_bindings_from_cc_cli_flags(target, ctx) + [
+            "--target_args_file=" + toolchain_target_args_file.path,
+        ],
         has_public_headers = has_public_headers,
+        prebuilt_bindings = get_prebuilt_bindings(ctx) if has_public_headers else None,
+        precompiled_modules = depset(transitive = [
+            t[RustBindingsFromCcInfo].precompiled_modules
+            for t in all_deps
+            if RustBindingsFromCcInfo in t and
+               getattr(t[RustBindingsFromCcInfo], "precompiled_modules", None)
+        ]),
     )
 
 rust_bindings_from_cc_aspect = aspect(
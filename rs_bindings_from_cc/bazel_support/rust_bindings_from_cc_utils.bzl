@@ -18,11 +18,16 @@ load(
     "escape_cpp_target_name",
     "generate_bindings",
 )
+load(
+    "@@//rs_bindings_from_cc/bazel_support:prebuilt_crubit_bindings_aspect_hint.bzl",
+    "use_prebuilt_bindings",
+)
 load(
     "@@//rs_bindings_from_cc/bazel_support:providers.bzl",
     "GeneratedBindingsInfo",
     "RustBindingsFromCcInfo",
 )
+load("@bazel_skylib//rules:common_settings.bzl", "BuildSettingInfo")
 load("@bazel_tools//tools/cpp:toolchain_utils.bzl", "find_cpp_toolchain")
 
 def generate_and_compile_bindings(
@@ -38,7 +43,9 @@ def generate_and_compile_bindings(
         deps_for_rs_file,
         extra_cc_compilation_action_inputs = [],
         extra_rs_bindings_from_cc_cli_flags = [],
-        has_public_headers = True):
+        has_public_headers = True,
+        prebuilt_bindings = None,
+        precompiled_modules = depset()):
     """Runs the bindings generator.
 
     Args:
@@ -57,6 +64,10 @@ def generate_and_compile_bindings(
       extra_rs_bindings_from_cc_cli_flags: CLI flags to pass to `rs_bindings_from_cc`, in addition
                                            to the flags that are passed by the build rule.
       has_public_headers: Whether the target has public headers.
+      prebuilt_bindings: The PrebuiltCrubitBindingsInfo of the target, or None. If set, the
+                         prebuilt bindings are compiled instead of generating bindings.
+      precompiled_modules: A depset of structs(module_map, pcm) with the precompiled Clang modules
+                           of the transitive dependencies.
     Returns:
       A RustBindingsFromCcInfo containing the result of the compilation of the generated source
       files, as well a GeneratedBindingsInfo provider containing the generated source files.
@@ -70,19 +81,37 @@ def generate_and_compile_bindings(
         unsupported_features = ctx.disabled_features + ["module_maps"],
     )
 
-    cc_output, rs_output, namespaces_output, error_report_output = generate_bindings(
-        ctx = ctx,
-        attr = attr,
-        cc_toolchain = cc_toolchain,
-        feature_configuration = feature_configuration_for_bindings,
-        compilation_context = compilation_context,
-        public_hdrs = public_hdrs,
-        header_includes = header_includes,
-        action_inputs = action_inputs,
-        target_args = target_args,
-        extra_rs_srcs = extra_rs_srcs,
-        extra_rs_bindings_from_cc_cli_flags = extra_rs_bindings_from_cc_cli_flags,
-    )
+    # TODO(b/216587072): Remove this hacky escaping and use the import! macro once available
+    crate_name = escape_cpp_target_name(ctx.label.package, ctx.label.name)
+
+    validation_outputs = []
+    if prebuilt_bindings:
+        cc_output, rs_output, namespaces_output, api_hash_output, validation_output = use_prebuilt_bindings(
+            ctx,
+            prebuilt_bindings,
+            crate_name,
+            public_hdrs,
+        )
+        error_report_output = None
+        precompiled_module = None
+        rs_modules_output = None
+        cc_output_shards = []
+        validation_outputs.append(validation_output)
+    else:
+        cc_output, rs_output, namespaces_output, error_report_output, precompiled_module, rs_modules_output, cc_output_shards, api_hash_output = generate_bindings(
+            ctx = ctx,
+            attr = attr,
+            cc_toolchain = cc_toolchain,
+            feature_configuration = feature_configuration_for_bindings,
+            compilation_context = compilation_context,
+            public_hdrs = public_hdrs,
+            header_includes = header_includes,
+            action_inputs = action_inputs,
+            target_args = target_args,
+            extra_rs_srcs = extra_rs_srcs,
+            extra_rs_bindings_from_cc_cli_flags = extra_rs_bindings_from_cc_cli_flags,
+            precompiled_modules = precompiled_modules,
+        )
 
     # Relocate the rs files so that they can be read by rustc using relative paths.
     extra_rs_srcs_relocated = []
@@ -93,6 +122,9 @@ def generate_and_compile_bindings(
         new_file = ctx.actions.declare_file(file_path, sibling = rs_output)
         ctx.actions.symlink(output = new_file, target_file = file)
         extra_rs_srcs_relocated.append(new_file)
+    if rs_modules_output:
+        # A sibling of `rs_output`, which refers to the modules by relative `#[path]`s.
+        extra_rs_srcs_relocated.append(rs_modules_output)
 
     # We use a separate feature_configuration for the clang compile action as the feature
     # configuration for bindings generation needs to use a param file. The clang wrapper script
@@ -104,8 +136,13 @@ def generate_and_compile_bindings(
         unsupported_features = ctx.disabled_features + ["module_maps"],
     )
 
-    # TODO(b/216587072): Remove this hacky escaping and use the import! macro once available
-    crate_name = escape_cpp_target_name(ctx.label.package, ctx.label.name)
+    # Both halves of a thunk call need to be bitcode for the linker to inline the thunk into its
+    # Rust caller.
+    extra_thunk_copts = []
+    extra_rust_flags = []
+    if ctx.attr._use_lto_for_thunks[BuildSettingInfo].value:
+        extra_thunk_copts = ["-flto=thin"]
+        extra_rust_flags = ["-Clinker-plugin-lto"]
 
     # Compile the "_rust_api.rs" file together with extra_rs_srcs.
     dep_variant_info = compile_rust(
@@ -121,6 +158,7 @@ def generate_and_compile_bindings(
         # for aspects, we can remove this option.
         include_coverage = False,
         force_all_deps_direct = True,
+        extra_rust_flags = extra_rust_flags,
     )
 
     # If the target has no public headers, then we should skip the thunks and the generated
@@ -136,7 +174,7 @@ def generate_and_compile_bindings(
             build_info = None,
         )
     else:
-        # Compile the "_rust_api_impl.cc" file
+        # Compile the "_rust_api_impl.cc" file, and its shards (if any) in parallel to it.
         cc_info = compile_cc(
             ctx,
             attr,
@@ -146,6 +184,8 @@ def generate_and_compile_bindings(
             deps_for_cc_file,
             extra_cc_compilation_action_inputs,
             extra_hdrs = public_hdrs,
+            extra_copts = extra_thunk_copts,
+            extra_srcs = cc_output_shards,
         )
 
     return [
@@ -154,13 +194,21 @@ def generate_and_compile_bindings(
             dep_variant_info = dep_variant_info,
             target_args = target_args,
             namespaces = namespaces_output,
+            precompiled_modules = depset(
+                direct = [precompiled_module] if precompiled_module else [],
+                transitive = [precompiled_modules],
+            ),
         ),
         GeneratedBindingsInfo(
             cc_file = cc_output,
             rust_file = rs_output,
             namespaces_file = namespaces_output,
+            api_hash_file = api_hash_output,
+        ),
+        OutputGroupInfo(
+            out = depset([x for x in [cc_output, rs_output, namespaces_output, api_hash_output, error_report_output] if x != None] + cc_output_shards),
+            _validation = depset(validation_outputs),
         ),
-        OutputGroupInfo(out = depset([x for x in [cc_output, rs_output, namespaces_output, error_report_output] if x != None])),
         # The C++ bindings of the generated Rust bindings are the original C++ file.
         CcBindingsFromRustInfo(
             cc_info = cc_info,
@@ -215,6 +263,27 @@ bindings_attrs = {
     "_generate_error_report": attr.label(
         default = "@@//rs_bindings_from_cc/bazel_support:generate_error_report",
     ),
+    "_generate_unsupported_item_comments": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:generate_unsupported_item_comments",
+    ),
+    "_aggregate_layout_assertions": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:aggregate_layout_assertions",
+    ),
+    "_use_precompiled_modules": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:use_precompiled_modules",
+    ),
+    "_use_persistent_worker": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:use_persistent_worker",
+    ),
+    "_rs_api_impl_shards": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:rs_api_impl_shards",
+    ),
+    "_split_rs_api_by_namespace": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:split_rs_api_by_namespace",
+    ),
+    "_use_lto_for_thunks": attr.label(
+        default = "@@//rs_bindings_from_cc/bazel_support:use_lto_for_thunks",
+    ),
     "_globally_enabled_features": attr.label(
         default = "//common/bazel_support:globally_enabled_features",
     ),
@@ -80,7 +80,20 @@ def _bindings_for_toolchain_headers_impl(ctx):
                 extra_rs_srcs.extend([(f, target[AdditionalRustSrcsProviderInfo].namespace_path) for f in src.files.to_list()])
         else:
             extra_rs_srcs.extend([(f, "") for f in target.files.to_list()])
-    return [RustToolchainHeadersInfo(headers = std_and_builtin_files)] + generate_and_compile_bindings(
+
+    # The target_args of the toolchain headers are the same for every target, and contain a huge
+    # list of headers. They are written to a file once, instead of being repeated on the command
+    # line of every bindings generation action that depends on the toolchain headers.
+    target_args_file = ctx.actions.declare_file(ctx.label.name + "_target_args.json")
+    ctx.actions.write(
+        output = target_args_file,
+        content = "[" + ",".join(target_args.to_list()) + "]",
+    )
+
+    return [RustToolchainHeadersInfo(
+        headers = std_and_builtin_files,
+        target_args_file = target_args_file,
+    )] + generate_and_compile_bindings(
         ctx,
         ctx.attr,
         compilation_context = ctx.attr._stl[CcInfo].compilation_context,
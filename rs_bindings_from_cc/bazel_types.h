@@ -12,7 +12,9 @@
 namespace crubit {
 
 // Representation of a Bazel label (for example //foo/bar:baz).
-CRUBIT_DEFINE_STRING_TYPE(BazelLabel);
+//
+// Labels are interned, since every item of the IR refers to its owning target.
+CRUBIT_DEFINE_INTERNED_STRING_TYPE(BazelLabel);
 
 }  // namespace crubit
 
@@ -0,0 +1,222 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks of the bindings generator over synthetic headers.
+//
+// Every benchmark takes the same five arguments, which control the size of the
+// synthetic header (see `SyntheticHeaderOptions`), so that the numbers of the
+// `IrFromCc`, `GenerateBindings` and end-to-end benchmarks can be compared
+// with each other.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "common/ffi_types.h"
+#include "common/test_utils.h"
+#include "rs_bindings_from_cc/bazel_types.h"
+#include "rs_bindings_from_cc/cmdline.h"
+#include "rs_bindings_from_cc/generate_bindings_and_metadata.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/ir_from_cc.h"
+#include "rs_bindings_from_cc/src_code_gen.h"
+#include "third_party/benchmark/include/benchmark/benchmark.h"
+
+namespace crubit {
+namespace {
+
+constexpr absl::string_view kTarget = "//test:testing_target";
+constexpr absl::string_view kHeader = "test/synthetic_header.h";
+
+struct SyntheticHeaderOptions {
+  // Number of structs, each with a constructor, a field and a method.
+  int64_t num_records;
+  // Number of overloads of a single free function.
+  int64_t num_overloads;
+  // Depth of the namespace nest that contains all of the above.
+  int64_t namespace_depth;
+  // Number of aliases of distinct class template specializations.
+  int64_t num_instantiations;
+  // Number of functions that bindings can't be generated for, to measure the
+  // cost of the error path.
+  int64_t num_unsupported;
+};
+
+SyntheticHeaderOptions OptionsFromState(const benchmark::State& state) {
+  return {.num_records = state.range(0),
+          .num_overloads = state.range(1),
+          .namespace_depth = state.range(2),
+          .num_instantiations = state.range(3),
+          .num_unsupported = state.range(4)};
+}
+
+std::string MakeSyntheticHeader(const SyntheticHeaderOptions& options) {
+  CHECK_GT(options.num_records, 0);
+  std::string header = "#pragma once\n";
+  for (int64_t i = 0; i < options.namespace_depth; ++i) {
+    absl::StrAppend(&header, "namespace ns", i, " {\n");
+  }
+
+  absl::StrAppend(&header,
+                  "template <typename T, int N>\n"
+                  "struct Box {\n"
+                  "  T value;\n"
+                  "  T get() const { return value; }\n"
+                  "  void set(T new_value) { value = new_value; }\n"
+                  "};\n");
+
+  for (int64_t i = 0; i < options.num_records; ++i) {
+    absl::StrAppend(&header, "struct Record", i, " {\n",  //
+                    "  Record", i, "();\n",                 //
+                    "  int Method(int x) const;\n",         //
+                    "  int field;\n");
+    if (i > 0) absl::StrAppend(&header, "  Record", i - 1, "* previous;\n");
+    absl::StrAppend(&header, "};\n");
+  }
+
+  // Overloads differ in the pointee type and the number of their parameters,
+  // so that every one of them has a distinct signature.
+  for (int64_t i = 0; i < options.num_overloads; ++i) {
+    std::string param =
+        absl::StrCat("const Record", i % options.num_records, "*");
+    std::vector<std::string> params(i / options.num_records + 1, param);
+    absl::StrAppend(&header, "void Overloaded(", absl::StrJoin(params, ", "),
+                    ");\n");
+  }
+
+  for (int64_t i = 0; i < options.num_instantiations; ++i) {
+    absl::StrAppend(&header, "using Alias", i, " = Box<Record",
+                    i % options.num_records, ", ", i, ">;\n");
+  }
+
+  // `_Complex` types are not supported, so each of these functions becomes an
+  // unsupported item.
+  for (int64_t i = 0; i < options.num_unsupported; ++i) {
+    absl::StrAppend(&header, "void Unsupported", i,
+                    "(_Complex float value);\n");
+  }
+
+  for (int64_t i = options.namespace_depth - 1; i >= 0; --i) {
+    absl::StrAppend(&header, "}  // namespace ns", i, "\n");
+  }
+  return header;
+}
+
+absl::flat_hash_map<BazelLabel, absl::flat_hash_set<std::string>>
+TargetFeatures() {
+  return {{BazelLabel(kTarget), {"supported", "experimental"}}};
+}
+
+absl::StatusOr<IR> SyntheticIr(absl::string_view header) {
+  return IrFromCc({.extra_source_code_for_testing = header,
+                   .current_target = BazelLabel(kTarget),
+                   .crubit_features = TargetFeatures()});
+}
+
+// Sets the throughput counters of `state` for a header of `header_size` bytes.
+void SetThroughput(benchmark::State& state, size_t header_size) {
+  state.SetBytesProcessed(state.iterations() * header_size);
+  state.SetItemsProcessed(state.iterations() *
+                          (state.range(0) + state.range(1) + state.range(3) +
+                           state.range(4)));
+}
+
+void BM_IrFromCc(benchmark::State& state) {
+  std::string header = MakeSyntheticHeader(OptionsFromState(state));
+  for (auto _ : state) {
+    absl::StatusOr<IR> ir = SyntheticIr(header);
+    CHECK_OK(ir);
+    benchmark::DoNotOptimize(ir);
+  }
+  SetThroughput(state, header.size());
+}
+
+// Formats the generated code with the built-in pretty printer, so that the
+// benchmark neither depends on nor measures `rustfmt` and `clang-format`.
+void BM_GenerateBindings(benchmark::State& state) {
+  std::string header = MakeSyntheticHeader(OptionsFromState(state));
+  absl::StatusOr<IR> ir = SyntheticIr(header);
+  CHECK_OK(ir);
+  for (auto _ : state) {
+    absl::StatusOr<Bindings> bindings = GenerateBindings(
+        *ir, "<crubit/support/{header}>", /*clang_format_exe_path=*/"",
+        /*rustfmt_exe_path=*/"", /*rustfmt_config_path=*/"",
+        /*generate_error_report=*/false, SourceLocationDocComment::Enabled,
+        /*bindings_cache_dir=*/"",
+        GeneratedCodeFormatting::BuiltinPrettyPrinter);
+    CHECK_OK(bindings);
+    benchmark::DoNotOptimize(bindings);
+  }
+  SetThroughput(state, header.size());
+}
+
+void BM_EndToEnd(benchmark::State& state) {
+  std::string header = MakeSyntheticHeader(OptionsFromState(state));
+  CmdlineArgs args{
+      .current_target = BazelLabel(kTarget),
+      .cc_out = "cc_out",
+      .rs_out = "rs_out",
+      .ir_out = "ir_out",
+      .namespaces_out = "namespaces_out",
+      .crubit_support_path_format = "<crubit/support/{header}>",
+      .generated_code_formatting =
+          GeneratedCodeFormatting::BuiltinPrettyPrinter,
+      .public_headers = {HeaderName(std::string(kHeader))},
+      .target_to_features = TargetFeatures(),
+  };
+  args.headers_to_targets[args.public_headers[0]] = args.current_target;
+  absl::StatusOr<Cmdline> cmdline = Cmdline::Create(args);
+  CHECK_OK(cmdline);
+
+  for (auto _ : state) {
+    absl::StatusOr<BindingsAndMetadata> result = GenerateBindingsAndMetadata(
+        *cmdline, DefaultClangArgs(),
+        {{HeaderName(std::string(kHeader)), header}});
+    CHECK_OK(result);
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, header.size());
+}
+
+// Arguments: records, overloads, namespace depth, instantiations, unsupported
+// functions.
+void SyntheticHeaderSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames(
+      {"records", "overloads", "depth", "instantiations", "unsupported"});
+  benchmark->Args({10, 10, 1, 10, 0});
+  benchmark->Args({100, 10, 1, 10, 0});
+  benchmark->Args({1000, 10, 1, 10, 0});
+  benchmark->Args({10, 1000, 1, 10, 0});
+  benchmark->Args({10, 10, 64, 10, 0});
+  benchmark->Args({10, 10, 1, 1000, 0});
+  benchmark->Args({10, 10, 1, 10, 1000});
+  benchmark->Args({1000, 1000, 16, 1000, 0});
+  benchmark->Args({1000, 1000, 16, 1000, 1000});
+}
+
+BENCHMARK(BM_IrFromCc)
+    ->Apply(SyntheticHeaderSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GenerateBindings)
+    ->Apply(SyntheticHeaderSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EndToEnd)
+    ->Apply(SyntheticHeaderSizes)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace crubit
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
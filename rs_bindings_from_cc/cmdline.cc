@@ -16,6 +16,7 @@
 #include "absl/flags/flag.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -33,8 +34,19 @@ ABSL_FLAG(bool, do_nothing, false,
           "(useful for testing Bazel integration)");
 ABSL_FLAG(std::string, rs_out, "",
           "output path for the Rust source file with bindings");
+ABSL_FLAG(std::string, rs_out_modules_dir, "",
+          "(optional) output directory for the modules of the Rust bindings. "
+          "If specified, each top-level module (e.g. for a top-level C++ "
+          "namespace) is written to a separate file in this directory, which "
+          "--rs_out includes with `#[path]`. Must be below the directory of "
+          "--rs_out.");
 ABSL_FLAG(std::string, cc_out, "",
           "output path for the C++ source file with bindings implementation");
+ABSL_FLAG(std::vector<std::string>, cc_out_shards, std::vector<std::string>(),
+          "(optional) output paths for additional shards of the C++ source "
+          "file with bindings implementation. If specified, the thunks are "
+          "split between --cc_out and these files, so that they can be "
+          "compiled in parallel.");
 ABSL_FLAG(std::string, ir_out, "",
           "(optional) output path for the JSON IR. If not present, the JSON IR "
           "will not be dumped.");
@@ -77,6 +89,13 @@ ABSL_FLAG(std::string, target_args, "",
           "  },\n"
           "...\n"
           "]");
+ABSL_FLAG(std::string, target_args_file, "",
+          "(optional) path to a file with additional per-target Crubit "
+          "arguments, in the same format as --target_args. This is used for "
+          "the arguments of the toolchain headers, which are the same for "
+          "every target, so that they are written once instead of being "
+          "repeated on the command line of every bindings generation "
+          "action.");
 ABSL_FLAG(std::vector<std::string>, extra_rs_srcs, std::vector<std::string>(),
           "Additional Rust source files to include into the crate.");
 ABSL_FLAG(std::vector<std::string>, srcs_to_scan_for_instantiations,
@@ -92,9 +111,75 @@ ABSL_FLAG(std::string, namespaces_out, "",
           "namespace hierarchy.");
 ABSL_FLAG(std::string, error_report_out, "",
           "(optional) output path for the JSON error report");
+ABSL_FLAG(std::string, api_hash_out, "",
+          "(optional) output path for a hash of the API of the generated Rust "
+          "source code, which ignores comments and formatting. It only "
+          "changes when the API does, so that dependents can key on it "
+          "instead of the contents of --rs_out.");
+ABSL_FLAG(std::string, cost_report_out, "",
+          "(optional) output path for a JSON report of the cost of each item: "
+          "the time spent generating its bindings, the size of its generated "
+          "Rust and C++ source code, and its number of thunks. Disables "
+          "--bindings_cache_dir.");
+ABSL_FLAG(std::string, module_map_out, "",
+          "(optional) output path for a Clang module map declaring the "
+          "target's public headers as a module. Must be specified together "
+          "with --pcm_out.");
+ABSL_FLAG(std::string, pcm_out, "",
+          "(optional) output path for the precompiled Clang module (.pcm) "
+          "built from --module_map_out. Bindings generation for dependent "
+          "targets can load it instead of re-parsing the target's headers.");
+ABSL_FLAG(bool, precompiled_module_only, false,
+          "if set to true, only --module_map_out and --pcm_out are written, "
+          "and --rs_out and --cc_out are not required. This lets the "
+          "precompiled module, which is all that bindings generation for "
+          "dependent targets needs, be built by a separate, shorter action.");
+ABSL_FLAG(std::string, bindings_cache_dir, "",
+          "(optional) directory in which generated bindings are cached, keyed "
+          "on the IR of the target. Bindings are reused as-is when a header "
+          "change does not affect the IR (e.g. an edit in an inline function "
+          "body). The `cc_template!` instantiations found in each of "
+          "--srcs_to_scan_for_instantiations are cached there, too.");
+ABSL_FLAG(std::string, timing_report_out, "",
+          "(optional) output path for a JSON report of the wall time, CPU "
+          "time and peak RSS of each phase of bindings generation, and of the "
+          "number of items of each kind and the time spent generating them.");
+ABSL_FLAG(std::string, timing_trace_out, "",
+          "(optional) output path for the phases of bindings generation in "
+          "the Chrome trace event format (see chrome://tracing).");
+ABSL_FLAG(std::string, demand_list, "",
+          "(optional) path to a file with the qualified C++ names (e.g. "
+          "`ns::Foo`) of the items of the target that are used from Rust, one "
+          "per line, e.g. as found by scanning the Rust sources of the "
+          "dependents. If specified, bindings are only generated for these "
+          "items, the items that they enclose, and the items that they depend "
+          "on. Cannot be used in template instantiation mode.");
 ABSL_FLAG(bool, generate_source_location_in_doc_comment, true,
           "add the source code location from which the binding originates in"
           "the doc comment of the binding");
+ABSL_FLAG(std::string, generated_code_formatting, "external",
+          "how the generated bindings are formatted: `external` runs rustfmt "
+          "and clang-format on the whole files, `external_in_chunks` runs "
+          "rustfmt concurrently on chunks of top-level items, and `builtin` "
+          "uses Crubit's built-in pretty-printer instead of external tools.");
+ABSL_FLAG(bool, generate_unsupported_item_comments, true,
+          "add a comment with the errors of each item that failed to import, "
+          "or that bindings can't be generated for, to the generated Rust "
+          "file. If false, the errors are only recorded in "
+          "--error_report_out, which must then be specified.");
+ABSL_FLAG(bool, aggregate_layout_assertions, false,
+          "verify the size, alignment and field offsets of all records of the "
+          "target with a single table-driven assertion in each of the "
+          "generated Rust and C++ files, instead of with separate assertions "
+          "for every record and field.");
+ABSL_FLAG(bool, import_dependencies_lazily, false,
+          "only import declarations from other targets when they are "
+          "referenced by the declarations of the current target");
+ABSL_FLAG(bool, lean_bindings, false,
+          "don't import the comments and source locations of declarations, "
+          "and don't generate doc comments from them. This saves time for "
+          "bindings that nobody reads, e.g. in CI builds. Implies "
+          "--nogenerate_source_location_in_doc_comment.");
 
 namespace crubit {
 
@@ -114,6 +199,19 @@ bool fromJSON(const llvm::json::Value& json, TargetArgs& out,
          mapper.mapOptional("f", out.features);
 }
 
+absl::StatusOr<GeneratedCodeFormatting> GeneratedCodeFormattingFromFlag() {
+  const std::string flag = absl::GetFlag(FLAGS_generated_code_formatting);
+  if (flag == "external") return GeneratedCodeFormatting::ExternalFormatters;
+  if (flag == "external_in_chunks") {
+    return GeneratedCodeFormatting::ExternalFormattersInChunks;
+  }
+  if (flag == "builtin") return GeneratedCodeFormatting::BuiltinPrettyPrinter;
+  return absl::InvalidArgumentError(absl::Substitute(
+      "Expected `--generated_code_formatting` to be one of `external`, "
+      "`external_in_chunks` or `builtin`, got `$0`",
+      flag));
+}
+
 std::vector<HeaderName> PublicHeaders() {
   std::vector<HeaderName> public_headers;
   const std::vector<std::string>& public_headers_string =
@@ -137,52 +235,77 @@ absl::Status ParseTargetArgs(absl::string_view target_args_str,
     return absl::InvalidArgumentError(absl::StrCat(
         "Malformed `--target_args` argument: ", toString(std::move(err))));
   }
-  for (const TargetArgs& it : *target_args) {
+  size_t num_headers = 0;
+  for (const TargetArgs& it : *target_args) num_headers += it.headers.size();
+  args.headers_to_targets.reserve(args.headers_to_targets.size() + num_headers);
+
+  for (TargetArgs& it : *target_args) {
     const std::string& target = it.target;
     if (target.empty()) {
       return absl::InvalidArgumentError(
           "Expected `t` fields of `--target_args` to be a non-empty "
           "string");
     }
-    for (const std::string& header : it.headers) {
+    // Labels are interned, so they are only created once per target rather
+    // than once per header.
+    const BazelLabel target_label(target);
+    for (std::string& header : it.headers) {
       if (header.empty()) {
         return absl::InvalidArgumentError(
             "Expected `h` (header) fields of `--target_args` to be an "
             "array of non-empty strings");
       }
-      BazelLabel target_label(target);
       auto [it, inserted] = args.headers_to_targets.try_emplace(
-          HeaderName(header), std::move(target_label));
+          HeaderName(std::move(header)), target_label);
       if (!inserted) {
         LOG(WARNING) << "The `--target_args` cmdline argument assigns `"
-                     << header << "` header to two conflicting targets: `"
-                     << target << "` vs `" << it->second.value() << "`";
+                     << it->first.IncludePath()
+                     << "` header to two conflicting targets: `" << target
+                     << "` vs `" << it->second.value() << "`";
         // Assign the one that comes first alphabetically, to get a consistent
         // result.
         if (target_label.value() < it->second.value()) {
-          it->second = std::move(target_label);
+          it->second = target_label;
         }
       }
     }
-    for (const std::string& feature : it.features) {
+    if (it.features.empty()) continue;
+    absl::flat_hash_set<std::string>& features =
+        args.target_to_features[target_label];
+    for (std::string& feature : it.features) {
       if (feature.empty()) {
         return absl::InvalidArgumentError(
             "Expected `f` (feature) fields of `--target_args` to be an "
             "array of non-empty strings");
       }
-      args.target_to_features[BazelLabel(target)].insert(feature);
+      features.insert(std::move(feature));
     }
   }
   return absl::OkStatus();
 }
 
+absl::Status ParseTargetArgsFile(absl::string_view path, CmdlineArgs& args) {
+  std::ifstream in{std::string(path)};
+  if (!in.good()) {
+    return absl::NotFoundError(
+        absl::StrCat("Couldn't read --target_args_file `", path, "`"));
+  }
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ParseTargetArgs(ss.str(), args);
+}
+
 }  // namespace internal
 
 absl::StatusOr<Cmdline> Cmdline::FromFlags() {
+  CRUBIT_ASSIGN_OR_RETURN(GeneratedCodeFormatting generated_code_formatting,
+                          GeneratedCodeFormattingFromFlag());
   auto args = CmdlineArgs{
       .current_target = BazelLabel(absl::GetFlag(FLAGS_target)),
       .cc_out = absl::GetFlag(FLAGS_cc_out),
+      .cc_out_shards = absl::GetFlag(FLAGS_cc_out_shards),
       .rs_out = absl::GetFlag(FLAGS_rs_out),
+      .rs_out_modules_dir = absl::GetFlag(FLAGS_rs_out_modules_dir),
       .ir_out = absl::GetFlag(FLAGS_ir_out),
       .namespaces_out = absl::GetFlag(FLAGS_namespaces_out),
       .crubit_support_path_format =
@@ -191,18 +314,46 @@ absl::StatusOr<Cmdline> Cmdline::FromFlags() {
       .rustfmt_exe_path = absl::GetFlag(FLAGS_rustfmt_exe_path),
       .rustfmt_config_path = absl::GetFlag(FLAGS_rustfmt_config_path),
       .error_report_out = absl::GetFlag(FLAGS_error_report_out),
+      .api_hash_out = absl::GetFlag(FLAGS_api_hash_out),
+      .cost_report_out = absl::GetFlag(FLAGS_cost_report_out),
+      .module_map_out = absl::GetFlag(FLAGS_module_map_out),
+      .pcm_out = absl::GetFlag(FLAGS_pcm_out),
+      .precompiled_module_only = absl::GetFlag(FLAGS_precompiled_module_only),
+      .bindings_cache_dir = absl::GetFlag(FLAGS_bindings_cache_dir),
+      .timing_report_out = absl::GetFlag(FLAGS_timing_report_out),
+      .timing_trace_out = absl::GetFlag(FLAGS_timing_trace_out),
+      .demand_list = absl::GetFlag(FLAGS_demand_list),
       .do_nothing = absl::GetFlag(FLAGS_do_nothing),
+      .import_dependencies_lazily =
+          absl::GetFlag(FLAGS_import_dependencies_lazily),
+      .lean_bindings = absl::GetFlag(FLAGS_lean_bindings),
+      .generate_unsupported_item_comments =
+          absl::GetFlag(FLAGS_generate_unsupported_item_comments),
+      .aggregate_layout_assertions =
+          absl::GetFlag(FLAGS_aggregate_layout_assertions),
       .generate_source_location_in_doc_comment =
           absl::GetFlag(FLAGS_generate_source_location_in_doc_comment)
               ? SourceLocationDocComment::Enabled
               : SourceLocationDocComment::Disabled,
+      .generated_code_formatting = generated_code_formatting,
       .public_headers = PublicHeaders(),
       .extra_rs_srcs = absl::GetFlag(FLAGS_extra_rs_srcs),
       .srcs_to_scan_for_instantiations =
           absl::GetFlag(FLAGS_srcs_to_scan_for_instantiations),
       .instantiations_out = absl::GetFlag(FLAGS_instantiations_out)};
-  absl::Status parse_target_args_status =
-      internal::ParseTargetArgs(absl::GetFlag(FLAGS_target_args), args);
+  absl::Status parse_target_args_status = absl::OkStatus();
+  const std::string target_args_file = absl::GetFlag(FLAGS_target_args_file);
+  const std::string target_args = absl::GetFlag(FLAGS_target_args);
+  if (!target_args_file.empty()) {
+    parse_target_args_status =
+        internal::ParseTargetArgsFile(target_args_file, args);
+  }
+  // The arguments in --target_args_file may be all there is (e.g. for a target
+  // without headers or features of its own).
+  if (parse_target_args_status.ok() &&
+      (target_args_file.empty() || !target_args.empty())) {
+    parse_target_args_status = internal::ParseTargetArgs(target_args, args);
+  }
   absl::StatusOr<Cmdline> cmdline = Cmdline::Create(std::move(args));
   if (!parse_target_args_status.ok() || !cmdline.ok()) {
     return absl::InvalidArgumentError(
@@ -217,11 +368,19 @@ absl::StatusOr<Cmdline> Cmdline::Create(CmdlineArgs args) {
   if (args.current_target.empty()) {
     absl::StrAppend(&error, "please specify --target\n");
   }
-  if (args.rs_out.empty()) {
-    absl::StrAppend(&error, "please specify --rs_out\n");
-  }
-  if (args.cc_out.empty()) {
-    absl::StrAppend(&error, "please specify --cc_out\n");
+  if (args.precompiled_module_only) {
+    if (args.pcm_out.empty()) {
+      absl::StrAppend(&error,
+                      "please specify --pcm_out with "
+                      "--precompiled_module_only\n");
+    }
+  } else {
+    if (args.rs_out.empty()) {
+      absl::StrAppend(&error, "please specify --rs_out\n");
+    }
+    if (args.cc_out.empty()) {
+      absl::StrAppend(&error, "please specify --cc_out\n");
+    }
   }
   if (args.public_headers.empty()) {
     absl::StrAppend(&error, "please specify --public_headers\n");
@@ -247,6 +406,22 @@ absl::StatusOr<Cmdline> Cmdline::Create(CmdlineArgs args) {
         "please specify both --rust_sources and --instantiations_out when "
         "requesting a template instantiation mode\n");
   }
+  if (!args.demand_list.empty() && !args.instantiations_out.empty()) {
+    absl::StrAppend(&error,
+                    "--demand_list cannot be used in template instantiation "
+                    "mode\n");
+  }
+  if (args.module_map_out.empty() != args.pcm_out.empty()) {
+    absl::StrAppend(&error,
+                    "please specify both --module_map_out and --pcm_out when "
+                    "requesting a precompiled module\n");
+  }
+  if (!args.generate_unsupported_item_comments &&
+      args.error_report_out.empty()) {
+    absl::StrAppend(&error,
+                    "please specify --error_report_out when disabling "
+                    "--generate_unsupported_item_comments\n");
+  }
   for (const HeaderName& header : args.public_headers) {
     if (auto it = args.headers_to_targets.find(header);
         it == args.headers_to_targets.end()) {
@@ -265,45 +440,62 @@ absl::StatusOr<Cmdline> Cmdline::Create(CmdlineArgs args) {
   return Cmdline(std::move(args));
 }
 
+namespace {
+
+// Returns the arguments in the paramfile at `path` (see `ExpandParamfiles`).
+std::vector<std::string> ReadParamfile(const char* path) {
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  std::string s = ss.str();
+  std::vector<std::string> args;
+  std::string next_arg;
+  // Unfortunately, we can't just use something like StrReplaceAll, because an
+  // escaped newline should be part of the value, while an unescaped newline
+  // should not be. Paramfiles can be megabytes large (mostly due to the
+  // `--target_to_arg` values that `PreprocessTargetArgs` later concatenates
+  // into `--target_args`), so the characters between escapes and newlines are
+  // appended in bulk.
+  absl::string_view rest = s;
+  while (!rest.empty()) {
+    size_t special = rest.find_first_of("\\\n");
+    absl::StrAppend(&next_arg, rest.substr(0, special));
+    if (special == absl::string_view::npos) break;
+    char c = rest[special];
+    rest.remove_prefix(special + 1);
+    if (c == '\\') {
+      if (rest.empty()) {
+        absl::StrAppend(&next_arg, "\\");
+        break;
+      }
+      absl::StrAppend(&next_arg, rest.substr(0, 1));
+      rest.remove_prefix(1);
+    } else {
+      args.push_back(std::move(next_arg));
+      next_arg.clear();
+    }
+  }
+  if (!next_arg.empty()) {
+    args.push_back(std::move(next_arg));
+  }
+  return args;
+}
+
+bool IsParamfile(absl::string_view arg) { return absl::StartsWith(arg, "@"); }
+
+}  // namespace
+
 void ExpandParamfiles(int& argc, char**& argv) {
   std::vector<char*> new_argv;  // Will be leaked if we find a paramfile.
   char** begin = argv;
   char** end = begin + argc;
   for (;;) {
-    char** next_paramfile =
-        std::find_if(begin, end, [](char* c) { return c[0] == '@'; });
+    char** next_paramfile = std::find_if(begin, end, IsParamfile);
     if (next_paramfile == end) break;
     new_argv.insert(new_argv.end(), begin, next_paramfile);
     begin = next_paramfile + 1;
-    const char* paramfile = *next_paramfile + 1;
-    std::ifstream in(paramfile);
-    std::stringstream ss;
-    ss << in.rdbuf();
-    std::string s = ss.str();
-    std::string next_arg;
-    // Unfortunately, we can't just use something like StrReplaceAll, because an
-    // escaped newline should be part of the value, while an unescaped newline
-    // should not be.
-    for (auto it = s.begin(); it != s.end(); ++it) {
-      if (*it == '\\') {
-        ++it;
-        if (it == s.end()) {
-          absl::StrAppend(&next_arg, "\\");
-          break;
-        } else {
-          absl::StrAppend(&next_arg, absl::string_view(&*it, 1));
-        }
-      } else if (*it == '\n') {
-        new_argv.push_back(
-            absl::IgnoreLeak(new auto(std::move(next_arg)))->data());
-        next_arg.clear();
-      } else {
-        absl::StrAppend(&next_arg, absl::string_view(&*it, 1));
-      }
-    }
-    if (!next_arg.empty()) {
-      new_argv.push_back(
-          absl::IgnoreLeak(new auto(std::move(next_arg)))->data());
+    for (std::string& arg : ReadParamfile(*next_paramfile + 1)) {
+      new_argv.push_back(absl::IgnoreLeak(new auto(std::move(arg)))->data());
     }
   }
   if (begin == argv) return;
@@ -313,7 +505,24 @@ void ExpandParamfiles(int& argc, char**& argv) {
   absl::IgnoreLeak(new auto(std::move(new_argv)));  // nowhere else to put it.
 }
 
-void PreprocessTargetArgs(int& argc, char** argv) {
+std::vector<std::string> ExpandParamfiles(
+    const std::vector<std::string>& args) {
+  std::vector<std::string> expanded;
+  for (const std::string& arg : args) {
+    if (!IsParamfile(arg)) {
+      expanded.push_back(arg);
+      continue;
+    }
+    std::vector<std::string> paramfile_args = ReadParamfile(arg.c_str() + 1);
+    expanded.insert(expanded.end(),
+                    std::make_move_iterator(paramfile_args.begin()),
+                    std::make_move_iterator(paramfile_args.end()));
+  }
+  return expanded;
+}
+
+void PreprocessTargetArgs(int& argc, char** argv,
+                          std::string* target_args_storage) {
   // TODO(jeanpierreda): Now that flag parsing logic is no longer in a bash script,
   // this should probably skip target_args entirely. (For now, the target_args
   // flag is left in place for compatibility and to avoid test churn.) We put it
@@ -325,8 +534,11 @@ void PreprocessTargetArgs(int& argc, char** argv) {
   if (first_target_to_arg == end) {
     return;
   }
-  std::string& target_args =
-      *absl::IgnoreLeak(new std::string("--target_args=["));
+  if (target_args_storage == nullptr) {
+    target_args_storage = absl::IgnoreLeak(new std::string());
+  }
+  std::string& target_args = *target_args_storage;
+  target_args = "--target_args=[";
   bool is_target_arg = true;
   bool is_done = false;
   auto new_end = std::remove_if(first_target_to_arg + 1, end, [&](char* arg) {
@@ -24,7 +24,10 @@ namespace crubit {
 struct CmdlineArgs {
   BazelLabel current_target;
   std::string cc_out;
+  // Additional shards of `cc_out`, which split the thunks between them.
+  std::vector<std::string> cc_out_shards;
   std::string rs_out;
+  std::string rs_out_modules_dir;
   std::string ir_out;
   std::string namespaces_out;
   std::string crubit_support_path_format;
@@ -32,9 +35,31 @@ struct CmdlineArgs {
   std::string rustfmt_exe_path;
   std::string rustfmt_config_path;
   std::string error_report_out;
+  std::string api_hash_out;
+  std::string cost_report_out;
+  std::string module_map_out;
+  std::string pcm_out;
+  // If true, only `module_map_out` and `pcm_out` are written.
+  bool precompiled_module_only = false;
+  std::string bindings_cache_dir;
+  std::string timing_report_out;
+  std::string timing_trace_out;
+  // If not empty, the file with the names of the items that are used from
+  // Rust. Bindings are only generated for them and their dependencies.
+  std::string demand_list;
   bool do_nothing = true;
+  bool import_dependencies_lazily = false;
+  // If true, no comments and source locations are imported or generated.
+  bool lean_bindings = false;
+  // If false, unsupported items are only recorded in `error_report_out`.
+  bool generate_unsupported_item_comments = true;
+  // If true, the layout of all records is verified by a single assertion per
+  // generated file.
+  bool aggregate_layout_assertions = false;
   SourceLocationDocComment generate_source_location_in_doc_comment =
       SourceLocationDocComment::Enabled;
+  GeneratedCodeFormatting generated_code_formatting =
+      GeneratedCodeFormatting::ExternalFormatters;
 
   std::vector<HeaderName> public_headers;
   absl::flat_hash_map<HeaderName, BazelLabel> headers_to_targets;
@@ -72,6 +97,10 @@ namespace internal {
 // Parses --target_args into CmdlineArgs. Only exposed so it can be unit tested.
 absl::Status ParseTargetArgs(absl::string_view target_args_str,
                              CmdlineArgs& args);
+
+// Parses the contents of --target_args_file into CmdlineArgs, in addition to
+// the arguments that are already there. Only exposed so it can be unit tested.
+absl::Status ParseTargetArgsFile(absl::string_view path, CmdlineArgs& args);
 }  // namespace internal
 
 // Expands paramfiles (@path/to/file) in-place in argv.
@@ -88,13 +117,22 @@ absl::Status ParseTargetArgs(absl::string_view target_args_str,
 // Paramfiles cannot include other paramfiles. (Can they?)
 void ExpandParamfiles(int& argc, char**& argv);
 
+// Like the above, but returns the expanded copy of `args`, which owns all of
+// its strings. Suited to the arguments of persistent worker requests, which
+// would otherwise leak the contents of their paramfiles.
+std::vector<std::string> ExpandParamfiles(const std::vector<std::string>& args);
+
 // Moves `--target_to_arg` arguments into `--target_args`.
 //
 // This must be called before flag parsing.
 //
 // Abseil does not allow for repeated flags, so we need to concatenate the
-// --target_to_args values before moving them to the --target_args flag.
-void PreprocessTargetArgs(int& argc, char** argv);
+// --target_to_arg values before moving them to the --target_args flag.
+//
+// The new `--target_args` argument points into `target_args_storage`, which
+// must outlive `argv`. If it is null, the argument is leaked instead.
+void PreprocessTargetArgs(int& argc, char** argv,
+                          std::string* target_args_storage = nullptr);
 
 }  // namespace crubit
 
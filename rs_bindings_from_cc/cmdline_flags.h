@@ -11,7 +11,9 @@
 
 ABSL_DECLARE_FLAG(bool, do_nothing);
 ABSL_DECLARE_FLAG(std::string, rs_out);
+ABSL_DECLARE_FLAG(std::string, rs_out_modules_dir);
 ABSL_DECLARE_FLAG(std::string, cc_out);
+ABSL_DECLARE_FLAG(std::vector<std::string>, cc_out_shards);
 ABSL_DECLARE_FLAG(std::string, ir_out);
 ABSL_DECLARE_FLAG(std::string, crubit_support_path_format);
 ABSL_DECLARE_FLAG(std::string, clang_format_exe_path);
@@ -25,6 +27,17 @@ ABSL_DECLARE_FLAG(std::vector<std::string>, srcs_to_scan_for_instantiations);
 ABSL_DECLARE_FLAG(std::string, instantiations_out);
 ABSL_DECLARE_FLAG(std::string, namespaces_out);
 ABSL_DECLARE_FLAG(std::string, error_report_out);
+ABSL_DECLARE_FLAG(std::string, module_map_out);
+ABSL_DECLARE_FLAG(std::string, pcm_out);
+ABSL_DECLARE_FLAG(std::string, bindings_cache_dir);
+ABSL_DECLARE_FLAG(std::string, timing_report_out);
+ABSL_DECLARE_FLAG(std::string, timing_trace_out);
+ABSL_DECLARE_FLAG(std::string, demand_list);
 ABSL_DECLARE_FLAG(bool, generate_source_location_in_doc_comment);
+ABSL_DECLARE_FLAG(std::string, generated_code_formatting);
+ABSL_DECLARE_FLAG(bool, generate_unsupported_item_comments);
+ABSL_DECLARE_FLAG(bool, aggregate_layout_assertions);
+ABSL_DECLARE_FLAG(bool, import_dependencies_lazily);
+ABSL_DECLARE_FLAG(bool, lean_bindings);
 
 #endif  // THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_CMDLINE_FLAGS_H_
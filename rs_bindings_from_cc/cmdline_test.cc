@@ -217,6 +217,34 @@ TEST(CmdlineTest, TargetArgsDuplicateHeader) {
                            Pair(HeaderName("h2"), BazelLabel("//:t2"))));
 }
 
+TEST(CmdlineTest, TargetArgsFile) {
+  std::string path = absl::StrCat(testing::TempDir(), "/TargetArgsFile.json");
+  std::ofstream f(path);
+  f << R"([{"t": "//:toolchain", "h": ["h1"], "f": ["supported"]}])";
+  f.close();
+
+  CmdlineArgs args;
+  ASSERT_OK(internal::ParseTargetArgsFile(path, args));
+  ASSERT_OK(internal::ParseTargetArgs(R"([{"t": "//:t1", "h": ["h2"]}])",
+                                      args));
+  EXPECT_THAT(
+      args.headers_to_targets,
+      UnorderedElementsAre(Pair(HeaderName("h1"), BazelLabel("//:toolchain")),
+                           Pair(HeaderName("h2"), BazelLabel("//:t1"))));
+  EXPECT_THAT(args.target_to_features,
+              UnorderedElementsAre(Pair(BazelLabel("//:toolchain"),
+                                        ElementsAre("supported"))));
+}
+
+TEST(CmdlineTest, TargetArgsFileMissing) {
+  CmdlineArgs args;
+  EXPECT_THAT(
+      internal::ParseTargetArgsFile(
+          absl::StrCat(testing::TempDir(), "/does_not_exist.json"), args),
+      StatusIs(absl::StatusCode::kNotFound,
+               HasSubstr("Couldn't read --target_args_file")));
+}
+
 TEST(CmdlineTest, PublicHeadersEmpty) {
   constexpr absl::string_view kTargetsAndHeaders = R"([
     {"t": "//:target1", "h": ["a.h", "b.h"]}
@@ -312,6 +340,69 @@ TEST(CmdlineTest, RustSourcesEmpty) {
               "when requesting a template instantiation mode")));
 }
 
+TEST(CmdlineTest, DemandListInTemplateInstantiationMode) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.srcs_to_scan_for_instantiations = {"lib.rs"};
+  args.instantiations_out = "instantiations_out";
+  args.demand_list = "demand_list.txt";
+  EXPECT_THAT(Cmdline::Create(std::move(args)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("--demand_list cannot be used in template "
+                                 "instantiation mode")));
+}
+
+TEST(CmdlineTest, PcmOutEmpty) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.module_map_out = "module_map_out";
+  args.pcm_out = "";
+  EXPECT_THAT(
+      Cmdline::Create(std::move(args)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("please specify both --module_map_out and --pcm_out "
+                         "when requesting a precompiled module")));
+}
+
+TEST(CmdlineTest, ModuleMapOutEmpty) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.module_map_out = "";
+  args.pcm_out = "pcm_out";
+  EXPECT_THAT(
+      Cmdline::Create(std::move(args)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("please specify both --module_map_out and --pcm_out "
+                         "when requesting a precompiled module")));
+}
+
+TEST(CmdlineTest, PrecompiledModuleOnlyDoesNotRequireRsOutAndCcOut) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.precompiled_module_only = true;
+  args.module_map_out = "module_map_out";
+  args.pcm_out = "pcm_out";
+  args.rs_out = "";
+  args.cc_out = "";
+  ASSERT_OK(Cmdline::Create(std::move(args)).status());
+}
+
+TEST(CmdlineTest, PrecompiledModuleOnlyWithoutPcmOut) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.precompiled_module_only = true;
+  EXPECT_THAT(Cmdline::Create(std::move(args)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("please specify --pcm_out with "
+                                 "--precompiled_module_only")));
+}
+
+TEST(CmdlineTest, UnsupportedItemCommentsDisabledWithoutErrorReport) {
+  ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
+  args.generate_unsupported_item_comments = false;
+  args.error_report_out = "";
+  EXPECT_THAT(
+      Cmdline::Create(std::move(args)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("please specify --error_report_out when disabling "
+                         "--generate_unsupported_item_comments")));
+}
+
 TEST(CmdlineTest, CcOutEmpty) {
   ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
   args.cc_out = "";
@@ -331,7 +422,7 @@ TEST(CmdlineTest, RsOutEmpty) {
 TEST(CmdlineTest, IrOutEmpty) {
   ASSERT_OK_AND_ASSIGN(CmdlineArgs args, TestCmdlineArgs());
   args.ir_out = "";
-  EXPECT_OK(Cmdline::Create(std::move(args)));
+  ASSERT_OK(Cmdline::Create(std::move(args)).status());
 }
 
 TEST(CmdlineTest, ClangFormatExePathEmpty) {
@@ -419,6 +510,15 @@ TEST(PreprocessTargetArgsTest, TargetToArg) {
                   "other_args"));
 }
 
+TEST(PreprocessTargetArgsTest, TargetToArgWithStorage) {
+  Args args({"binary", "--target_to_arg", R"({"k": "v"})", "other_args"});
+  std::string target_args_storage;
+  PreprocessTargetArgs(args.argc(), args.argv(), &target_args_storage);
+  EXPECT_EQ(target_args_storage, R"(--target_args=[{"k": "v"}])");
+  EXPECT_THAT(args.argv_vector(),
+              ElementsAre("binary", target_args_storage, "other_args"));
+}
+
 std::string Paramfile(absl::string_view contents) {
   std::string path = absl::StrCat(
       testing::TempDir(), "/",
@@ -470,5 +570,17 @@ TEST(ExpandParamfilesTest, BackslashEscape) {
   EXPECT_THAT(args.argv_vector(), ElementsAre("binary", R"(\')"));
 }
 
+TEST(ExpandParamfilesTest, ExpandStrings) {
+  std::vector<std::string> args = {"foo", Paramfile("arg1\\\narg2\narg3"),
+                                   "bar"};
+  EXPECT_THAT(ExpandParamfiles(args),
+              ElementsAre("foo", "arg1\narg2", "arg3", "bar"));
+}
+
+TEST(ExpandParamfilesTest, ExpandStringsNoop) {
+  std::vector<std::string> args = {"foo", "bar"};
+  EXPECT_THAT(ExpandParamfiles(args), ElementsAre("foo", "bar"));
+}
+
 }  // namespace
 }  // namespace crubit
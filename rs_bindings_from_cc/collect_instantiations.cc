@@ -10,6 +10,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "common/ffi_types.h"
 #include "llvm/Support/Error.h"
@@ -18,24 +19,23 @@
 
 // This function is implemented in Rust.
 extern "C" crubit::FfiU8SliceBox CollectInstantiationsImpl(
-    crubit::FfiU8Slice json);
+    crubit::FfiU8Slice json, crubit::FfiU8Slice cache_dir);
 
 namespace crubit {
 
 absl::StatusOr<std::vector<std::string>> CollectInstantiations(
-    absl::Span<const std::string> rust_sources) {
+    absl::Span<const std::string> rust_sources, absl::string_view cache_dir) {
   llvm::json::Value rust_sources_json = llvm::json::Array(rust_sources);
   std::string json = llvm::formatv("{0}", rust_sources_json);
-  FfiU8SliceBox result = CollectInstantiationsImpl(MakeFfiU8Slice(json));
-  std::string result_string = std::string(result.ptr, result.size);
+  UniqueFfiU8SliceBox result(CollectInstantiationsImpl(
+      MakeFfiU8Slice(json), MakeFfiU8Slice(cache_dir)));
   llvm::Expected<llvm::json::Value> expected_instantiations =
-      llvm::json::parse(result_string);
+      llvm::json::parse(result.view());
   if (auto error = expected_instantiations.takeError()) {
     return absl::InternalError(llvm::toString(std::move(error)));
   }
 
   llvm::json::Value instantiations = *expected_instantiations;
-  FreeFfiU8SliceBox(result);
   std::vector<std::string> instantiations_vector;
   llvm::json::Path::Root root;
   if (llvm::json::fromJSON(instantiations, instantiations_vector, root)) {
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 
 namespace crubit {
@@ -16,8 +17,13 @@ namespace crubit {
 // Parses Rust source files given their filenames and returns a vector with all
 // C++ class template instantiations requested by calls to the `cc_template!`
 // macro.
+//
+// The files are scanned in parallel, and files that don't mention
+// `cc_template` are not parsed at all. If `cache_dir` is not empty, the
+// instantiations found in each file are cached there, keyed on its contents.
 absl::StatusOr<std::vector<std::string>> CollectInstantiations(
-    absl::Span<const std::string> rust_sources);
+    absl::Span<const std::string> rust_sources,
+    absl::string_view cache_dir = "");
 
 }  // namespace crubit
 
@@ -3,34 +3,48 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 use arc_anyhow::{Context, Result};
+use bindings_cache::CacheKeyBuilder;
 use ffi_types::FfiU8Slice;
 use ffi_types::FfiU8SliceBox;
 use proc_macro2::TokenStream;
 use proc_macro2::TokenTree;
 use std::collections::HashSet;
 use std::fs;
+use std::num::NonZeroUsize;
 use std::panic::catch_unwind;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 use std::process;
 
+/// Mixed into the key of every cache entry. Bump this whenever the format of
+/// the entries (or the way instantiations are collected) changes, so that
+/// entries written by older versions of the tool are never read back.
+const CACHE_FORMAT_VERSION: &[u8] = b"collect_instantiations/v1";
+
 /// Parses given files and returns a Json list with all  C++ class
 /// template instantiations requested by calls to the `cc_template!` macro.
 ///
+/// If `cache_dir` is not empty, the instantiations found in each file are
+/// cached in it, keyed on the contents of the file.
+///
 /// This function panics on error.
 ///
 /// # Safety
 ///
 /// Expectations:
-///    * function expects that param `json` is a FfiU8Slice for a valid array of
-///      bytes with the given size.
-///    * function expects that param `json` doesn't change during the call.
+///    * function expects that params `json` and `cache_dir` are FfiU8Slices for
+///      valid arrays of bytes with the given size.
+///    * function expects that params `json` and `cache_dir` don't change during
+///      the call.
 ///
 /// Ownership:
 ///    * function doesn't take ownership of (in other words it borrows) the
-///      param `json`
+///      params `json` and `cache_dir`
 ///    * function passes ownership of the returned value to the caller
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn CollectInstantiationsImpl(json: FfiU8Slice) -> FfiU8SliceBox {
+pub unsafe extern "C" fn CollectInstantiationsImpl(
+    json: FfiU8Slice,
+    cache_dir: FfiU8Slice,
+) -> FfiU8SliceBox {
     catch_unwind(|| {
         let filenames: Vec<PathBuf> = serde_json::from_reader(json.as_slice())
             .with_context(|| {
@@ -38,27 +52,95 @@ pub unsafe extern "C" fn CollectInstantiationsImpl(json: FfiU8Slice) -> FfiU8Sli
                 format!("Couldn't deserialize json '{}'", json_str)
             })
             .unwrap();
-        let instantiations = collect_instantiations_impl(filenames).unwrap();
+        let cache_dir = std::str::from_utf8(cache_dir.as_slice()).unwrap();
+        let cache_dir = (!cache_dir.is_empty()).then(|| Path::new(cache_dir));
+        let instantiations = collect_instantiations_impl(filenames, cache_dir).unwrap();
         let result_json = serde_json::to_string(&instantiations).unwrap();
         FfiU8SliceBox::from_boxed_slice(result_json.into_bytes().into_boxed_slice())
     })
     .unwrap_or_else(|_| process::abort())
 }
 
-fn collect_instantiations_impl(filenames: Vec<PathBuf>) -> Result<Vec<String>> {
+/// Scans `filenames` in parallel, and returns the sorted instantiations found
+/// in them. If several files can't be scanned, the error of the first one is
+/// returned.
+fn collect_instantiations_impl(
+    filenames: Vec<PathBuf>,
+    cache_dir: Option<&Path>,
+) -> Result<Vec<String>> {
+    if filenames.is_empty() {
+        return Ok(vec![]);
+    }
+    let num_threads = std::thread::available_parallelism().map_or(1, NonZeroUsize::get);
+    let chunk_len = filenames.len().div_ceil(num_threads);
+    let results_per_file = std::thread::scope(|scope| {
+        let threads = filenames
+            .chunks(chunk_len)
+            .map(|chunk| {
+                scope.spawn(move || {
+                    chunk
+                        .iter()
+                        .map(|filename| collect_instantiations_in_file(filename, cache_dir))
+                        .collect::<Vec<_>>()
+                })
+            })
+            .collect::<Vec<_>>();
+        threads.into_iter().flat_map(|thread| thread.join().unwrap()).collect::<Vec<_>>()
+    });
     let mut result = HashSet::<String>::new();
-    for filename in filenames {
-        let content = fs::read_to_string(&filename)
-            .with_context(|| format!("Couldn't read '{}'", filename.display()))?;
-        let token_stream = syn::parse_str(&content)
-            .with_context(|| format!("Couldn't parse the file '{}'", filename.display()))?;
-        find_cc_template_calls(token_stream, &mut result);
+    for instantiations in results_per_file {
+        result.extend(instantiations?);
     }
     let mut result_vec = result.into_iter().collect::<Vec<_>>();
     result_vec.sort();
     Ok(result_vec)
 }
 
+fn collect_instantiations_in_file(
+    filename: &Path,
+    cache_dir: Option<&Path>,
+) -> Result<Vec<String>> {
+    let content = fs::read_to_string(filename)
+        .with_context(|| format!("Couldn't read '{}'", filename.display()))?;
+    // Most files don't request any instantiations, and there is no need to parse them.
+    if !content.contains("cc_template") {
+        return Ok(vec![]);
+    }
+    let cache_path = cache_dir.map(|cache_dir| {
+        let key = CacheKeyBuilder::new().add(CACHE_FORMAT_VERSION).add(content.as_bytes()).build();
+        cache_dir.join("instantiations").join(format!("{}.json", key.to_hex()))
+    });
+    if let Some(cached) = cache_path
+        .as_ref()
+        .and_then(|cache_path| fs::read(cache_path).ok())
+        .and_then(|cached| serde_json::from_slice::<Vec<String>>(&cached).ok())
+    {
+        return Ok(cached);
+    }
+
+    let token_stream = syn::parse_str(&content)
+        .with_context(|| format!("Couldn't parse the file '{}'", filename.display()))?;
+    let mut result = HashSet::<String>::new();
+    find_cc_template_calls(token_stream, &mut result);
+    let result = result.into_iter().collect::<Vec<_>>();
+    if let Some(cache_path) = cache_path {
+        // The cache is only an optimization, so failing to write it is not an error.
+        let _ = store_in_cache(&cache_path, &result);
+    }
+    Ok(result)
+}
+
+/// Writes `instantiations` to `cache_path`, through a temporary file, so that
+/// concurrent readers never observe a partially written entry.
+fn store_in_cache(cache_path: &Path, instantiations: &[String]) -> Result<()> {
+    fs::create_dir_all(cache_path.parent().unwrap())?;
+    let mut tmp_path = cache_path.as_os_str().to_owned();
+    tmp_path.push(format!(".{}.tmp", process::id()));
+    fs::write(&tmp_path, serde_json::to_string(instantiations)?)?;
+    fs::rename(&tmp_path, cache_path)?;
+    Ok(())
+}
+
 fn find_cc_template_calls(input: TokenStream, results: &mut HashSet<String>) {
     let mut iter = input.into_iter();
     while let Some(next) = iter.next() {
@@ -100,12 +182,12 @@ mod tests {
 
     #[gtest]
     fn test_noop() {
-        assert!(collect_instantiations_impl(vec![]).unwrap().is_empty());
+        assert!(collect_instantiations_impl(vec![], None).unwrap().is_empty());
     }
 
     #[gtest]
     fn test_file_does_not_exist() {
-        let err = collect_instantiations_impl(vec!["does/not/exist".into()]).unwrap_err();
+        let err = collect_instantiations_impl(vec!["does/not/exist".into()], None).unwrap_err();
         assert_eq!(
             format!("{:#}", err),
             "Couldn't read 'does/not/exist': No such file or directory (os error 2)"
@@ -121,19 +203,78 @@ mod tests {
 
     fn write_file_and_collect_instantiations(input: TokenStream) -> Result<Vec<String>> {
         let file = make_tmp_input_file("file", &input.to_string());
-        collect_instantiations_impl(vec![file])
+        collect_instantiations_impl(vec![file], None)
     }
 
     #[gtest]
     fn test_file_doesnt_parse() {
-        let input = make_tmp_input_file("does_not_parse", "This is not (Rust>!");
-        let err = collect_instantiations_impl(vec![input.clone()]).unwrap_err();
+        let input = make_tmp_input_file("does_not_parse", "cc_template!(This is not (Rust>!");
+        let err = collect_instantiations_impl(vec![input.clone()], None).unwrap_err();
         assert_eq!(
             format!("{:#}", err),
             format!("Couldn't parse the file '{}': lex error", input.display())
         );
     }
 
+    #[gtest]
+    fn test_files_without_cc_template_are_not_parsed() {
+        let input = make_tmp_input_file("no_cc_template", "This is not (Rust>!");
+        assert!(collect_instantiations_impl(vec![input], None).unwrap().is_empty());
+    }
+
+    #[gtest]
+    fn test_first_error_is_returned() {
+        let err = collect_instantiations_impl(
+            vec!["does/not/exist/1".into(), "does/not/exist/2".into()],
+            None,
+        )
+        .unwrap_err();
+        assert_eq!(
+            format!("{:#}", err),
+            "Couldn't read 'does/not/exist/1': No such file or directory (os error 2)"
+        );
+    }
+
+    #[gtest]
+    fn test_many_files() {
+        let files = (0..100)
+            .map(|i| {
+                make_tmp_input_file(
+                    &format!("many_{i}"),
+                    &format!("cc_template!(MyTemplate<{i}>);"),
+                )
+            })
+            .collect::<Vec<_>>();
+        let result = collect_instantiations_impl(files, None).unwrap();
+        let mut expected = (0..100).map(|i| format!("MyTemplate<{i}>")).collect::<Vec<_>>();
+        expected.sort();
+        assert_eq!(result, expected);
+    }
+
+    #[gtest]
+    fn test_cache() {
+        let tmp: PathBuf = std::env::var("TEST_TMPDIR").unwrap().into();
+        let cache_dir = tmp.join("cache");
+        let file = make_tmp_input_file("cached", "cc_template!(MyTemplate<int>);");
+        let result = collect_instantiations_impl(vec![file.clone()], Some(&cache_dir)).unwrap();
+        assert_eq!(result, vec!["MyTemplate<int>".to_string()]);
+
+        // Overwrite the cache entry, to check that the file is not parsed again.
+        let cache_entries = fs::read_dir(cache_dir.join("instantiations"))
+            .unwrap()
+            .map(|entry| entry.unwrap().path())
+            .collect::<Vec<_>>();
+        assert_eq!(cache_entries.len(), 1);
+        fs::write(&cache_entries[0], r#"["FromCache<int>"]"#).unwrap();
+        let result = collect_instantiations_impl(vec![file.clone()], Some(&cache_dir)).unwrap();
+        assert_eq!(result, vec!["FromCache<int>".to_string()]);
+
+        // A changed file is parsed again.
+        fs::write(&file, "cc_template!(MyTemplate<long>);").unwrap();
+        let result = collect_instantiations_impl(vec![file], Some(&cache_dir)).unwrap();
+        assert_eq!(result, vec!["MyTemplate<long>".to_string()]);
+    }
+
     #[gtest]
     fn test_single_template_parens() {
         let result =
@@ -209,7 +350,11 @@ mod tests {
 
     fn collect_instantiations_from_json(json: &str) -> String {
         let u8_slice = unsafe {
-            CollectInstantiationsImpl(FfiU8Slice::from_slice(json.as_bytes())).into_boxed_slice()
+            CollectInstantiationsImpl(
+                FfiU8Slice::from_slice(json.as_bytes()),
+                FfiU8Slice::from_slice(b""),
+            )
+            .into_boxed_slice()
         };
         std::str::from_utf8(&u8_slice).unwrap().to_string()
     }
@@ -60,30 +60,40 @@ class NamespaceTrie {
   // children namespace items.
   absl::flat_hash_map<ItemId, const Namespace*>& id_to_namespace_;
 
-  // Creates a node from a Namespace and inserts it into the trie.
-  void InsertNode(int parent_idx, const Namespace* ns) {
-    auto name = ns->name.Ident();
-    auto parent = &trie_nodes_[parent_idx];
-    int child_idx;
-    if (parent->child_name_to_idx.find(name) ==
-        parent->child_name_to_idx.end()) {
-      child_idx = trie_nodes_.size();
-      parent->child_name_to_idx.insert({name, child_idx});
-      // The following line potentially invalidates the "parent" pointer.
+  // Returns the index of the child node of `children` named `name`, creating
+  // the node if it doesn't exist yet.
+  int FindOrInsertNode(absl::btree_map<absl::string_view, int>& children,
+                       absl::string_view name) {
+    auto [it, inserted] =
+        children.try_emplace(name, static_cast<int>(trie_nodes_.size()));
+    int idx = it->second;
+    if (inserted) {
+      // This potentially invalidates `children` (if it belongs to a node), and
+      // therefore `it`.
       trie_nodes_.push_back({name, {}});
-    } else {
-      child_idx = parent->child_name_to_idx[name];
     }
+    return idx;
+  }
 
+  // Inserts the child namespaces of `ns` into the trie, under the node at
+  // `node_idx`.
+  void InsertChildren(int node_idx, const Namespace* ns) {
     for (auto ns_child_id : ns->child_item_ids) {
-      if (id_to_namespace_.find(ns_child_id) == id_to_namespace_.end()) {
+      auto it = id_to_namespace_.find(ns_child_id);
+      if (it == id_to_namespace_.end()) {
         continue;
       }
-      auto ns_child = id_to_namespace_[ns_child_id];
-      InsertNode(child_idx, ns_child);
+      InsertNode(node_idx, it->second);
     }
   }
 
+  // Creates a node from a Namespace and inserts it into the trie.
+  void InsertNode(int parent_idx, const Namespace* ns) {
+    int child_idx = FindOrInsertNode(trie_nodes_[parent_idx].child_name_to_idx,
+                                     ns->name.Ident());
+    InsertChildren(child_idx, ns);
+  }
+
   // Converts a trie node into the JSON serializable NamespaceNode.
   NamespaceNode NodeToNamespaceNode(const Node* node) const {
     std::vector<NamespaceNode> namespaces;
@@ -105,23 +115,8 @@ class NamespaceTrie {
   // Creates a trie node from the top level namespace and inserts it into the
   // trie.
   void InsertTopLevel(const Namespace* ns) {
-    auto name = ns->name.Ident();
-    int node_idx;
-    if (top_level_name_to_idx_.find(name) == top_level_name_to_idx_.end()) {
-      node_idx = trie_nodes_.size();
-      top_level_name_to_idx_.insert({name, node_idx});
-      trie_nodes_.push_back({name, {}});
-    } else {
-      node_idx = top_level_name_to_idx_[name];
-    }
-
-    for (auto ns_child_id : ns->child_item_ids) {
-      if (id_to_namespace_.find(ns_child_id) == id_to_namespace_.end()) {
-        continue;
-      }
-      auto ns_child = id_to_namespace_[ns_child_id];
-      InsertNode(node_idx, ns_child);
-    }
+    int node_idx = FindOrInsertNode(top_level_name_to_idx_, ns->name.Ident());
+    InsertChildren(node_idx, ns);
   }
 
   // Converts the trie into the JSON serializable NamespacesHierarchy.
@@ -151,11 +146,11 @@ NamespacesHierarchy CollectNamespaces(const IR& ir) {
 
   NamespaceTrie trie(ir.current_target, id_to_namespace);
   for (auto namespace_id : ir.top_level_item_ids) {
-    if (id_to_namespace.count(namespace_id) == 0) {
+    auto it = id_to_namespace.find(namespace_id);
+    if (it == id_to_namespace.end()) {
       continue;
     }
-    auto ns = id_to_namespace[namespace_id];
-    trie.InsertTopLevel(ns);
+    trie.InsertTopLevel(it->second);
   }
 
   return trie.ToNamespacesHierarchy();
@@ -48,8 +48,10 @@ inline std::ostream& operator<<(std::ostream& o,
 // Returns the current target's namespace hierarchy in JSON serializable format.
 NamespacesHierarchy CollectNamespaces(const IR& ir);
 
+// Returns the namespace hierarchy as compact (non-indented) JSON: the output is
+// read by `cc_import!` in every dependent crate, not by humans.
 inline std::string NamespacesAsJson(const NamespacesHierarchy& topLevel) {
-  return llvm::formatv("{0:2}", topLevel.ToJson());
+  return llvm::formatv("{0}", topLevel.ToJson());
 }
 }  // namespace crubit
 
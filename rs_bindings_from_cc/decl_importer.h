@@ -15,10 +15,12 @@
 #include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "common/annotation_reader.h"
 #include "lifetime_annotations/lifetime_annotations.h"
 #include "lifetime_annotations/type_lifetimes.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/timing_report.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/RawCommentList.h"
 #include "clang/AST/Type.h"
@@ -31,9 +33,14 @@ namespace crubit {
 class Invocation {
  public:
   Invocation(BazelLabel target, absl::Span<const HeaderName> public_headers,
-             const absl::flat_hash_map<HeaderName, BazelLabel>& header_targets)
+             const absl::flat_hash_map<HeaderName, BazelLabel>& header_targets,
+             bool import_dependencies_lazily = false,
+             TimingReport* timing_report = nullptr, bool lean_bindings = false)
       : target_(target),
         public_headers_(public_headers),
+        import_dependencies_lazily_(import_dependencies_lazily),
+        lean_bindings_(lean_bindings),
+        timing_report_(timing_report),
         lifetime_context_(std::make_shared<
                           clang::tidy::lifetimes::LifetimeAnnotationContext>()),
         header_targets_(header_targets) {
@@ -60,6 +67,19 @@ class Invocation {
   // `IR::public_headers` and `HeaderName` for more details.
   const absl::Span<const HeaderName> public_headers_;
 
+  // If true, decls from other targets are only imported when they are
+  // referenced by the decls of the current target (e.g. as a type of a
+  // function parameter), instead of importing every decl that is visible in
+  // the translation unit. Namespaces are still imported eagerly.
+  const bool import_dependencies_lazily_;
+
+  // If true, no comments (neither doc comments nor free comments) and no
+  // source locations are imported, for bindings that nobody reads.
+  const bool lean_bindings_;
+
+  // If not null, the import is recorded as a phase of this report.
+  TimingReport* const timing_report_;
+
   const std::shared_ptr<clang::tidy::lifetimes::LifetimeAnnotationContext>
       lifetime_context_;
 
@@ -134,6 +154,11 @@ class ImportContext {
   // other redeclarations of the decl.
   virtual bool IsFromCurrentTarget(const clang::Decl* decl) const = 0;
 
+  // Checks if the given source location is in a header of the current target
+  // (or in a textual header included from one).
+  virtual bool IsLocationFromCurrentTarget(
+      clang::SourceLocation source_location) const = 0;
+
   // Gets an IR UnqualifiedIdentifier for the named decl.
   //
   // If the decl's name is an identifier, this returns that identifier as-is.
@@ -192,6 +217,17 @@ class ImportContext {
   // MarkAsSuccessfullyImported.
   virtual bool EnsureSuccessfullyImported(clang::NamedDecl* decl) = 0;
 
+  // Returns whether the `decl` has been already successfully imported, like
+  // HasBeenAlreadySuccessfullyImported. When importing dependencies lazily
+  // (see `Invocation::import_dependencies_lazily_`), a `decl` from another
+  // target that would have been imported upfront is imported now instead.
+  virtual bool EnsureImportedIfLazy(clang::NamedDecl* decl) = 0;
+
+  // Returns the `crubit_*` (and other) annotations of `decl`. The index is
+  // built on first use and shared by all importers that look at `decl`.
+  virtual const AnnotateAttrIndex& GetAnnotateAttrs(
+      const clang::Decl* decl) const = 0;
+
   Invocation& invocation_;
   clang::ASTContext& ctx_;
   clang::Sema& sema_;
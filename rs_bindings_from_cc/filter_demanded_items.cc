@@ -0,0 +1,329 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/filter_demanded_items.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "common/file_io.h"
+#include "common/status_macros.h"
+#include "rs_bindings_from_cc/bazel_types.h"
+#include "rs_bindings_from_cc/ir.h"
+
+namespace crubit {
+namespace {
+
+ItemId GetId(const IR::Item& item) {
+  return std::visit([](const auto& item) { return item.id; }, item);
+}
+
+std::optional<ItemId> GetEnclosingItemId(const IR::Item& item) {
+  if (const auto* func = std::get_if<Func>(&item)) {
+    return func->enclosing_item_id;
+  } else if (const auto* record = std::get_if<Record>(&item)) {
+    return record->enclosing_item_id;
+  } else if (const auto* record = std::get_if<IncompleteRecord>(&item)) {
+    return record->enclosing_item_id;
+  } else if (const auto* enum_ = std::get_if<Enum>(&item)) {
+    return enum_->enclosing_item_id;
+  } else if (const auto* type_alias = std::get_if<TypeAlias>(&item)) {
+    return type_alias->enclosing_item_id;
+  } else if (const auto* constant = std::get_if<Constant>(&item)) {
+    return constant->enclosing_item_id;
+  } else if (const auto* ns = std::get_if<Namespace>(&item)) {
+    return ns->enclosing_item_id;
+  }
+  return std::nullopt;
+}
+
+// Returns the target that owns `item`, or nullptr for the items that don't
+// belong to a target (e.g. comments).
+const BazelLabel* GetOwningTarget(const IR::Item& item) {
+  if (const auto* func = std::get_if<Func>(&item)) {
+    return &func->owning_target;
+  } else if (const auto* record = std::get_if<Record>(&item)) {
+    return &record->owning_target;
+  } else if (const auto* record = std::get_if<IncompleteRecord>(&item)) {
+    return &record->owning_target;
+  } else if (const auto* enum_ = std::get_if<Enum>(&item)) {
+    return &enum_->owning_target;
+  } else if (const auto* type_alias = std::get_if<TypeAlias>(&item)) {
+    return &type_alias->owning_target;
+  } else if (const auto* constant = std::get_if<Constant>(&item)) {
+    return &constant->owning_target;
+  } else if (const auto* ns = std::get_if<Namespace>(&item)) {
+    return &ns->owning_target;
+  } else if (const auto* type_map_override =
+                 std::get_if<TypeMapOverride>(&item)) {
+    return &type_map_override->owning_target;
+  }
+  return nullptr;
+}
+
+// Returns the unqualified name of `item`, or nullopt if it doesn't have one
+// of its own (e.g. a constructor, which is named after its record).
+std::optional<std::string> GetUnqualifiedName(const IR::Item& item) {
+  if (const auto* func = std::get_if<Func>(&item)) {
+    if (const auto* identifier = std::get_if<Identifier>(&func->name)) {
+      return std::string(identifier->Ident());
+    } else if (const auto* op = std::get_if<Operator>(&func->name)) {
+      return absl::StrCat("operator", op->Name());
+    }
+  } else if (const auto* record = std::get_if<Record>(&item)) {
+    return record->cc_name;
+  } else if (const auto* record = std::get_if<IncompleteRecord>(&item)) {
+    return record->cc_name;
+  } else if (const auto* enum_ = std::get_if<Enum>(&item)) {
+    return std::string(enum_->identifier.Ident());
+  } else if (const auto* type_alias = std::get_if<TypeAlias>(&item)) {
+    return std::string(type_alias->identifier.Ident());
+  } else if (const auto* constant = std::get_if<Constant>(&item)) {
+    return std::string(constant->identifier.Ident());
+  } else if (const auto* ns = std::get_if<Namespace>(&item)) {
+    return std::string(ns->name.Ident());
+  } else if (const auto* unsupported = std::get_if<UnsupportedItem>(&item)) {
+    // Already qualified.
+    return unsupported->name;
+  }
+  return std::nullopt;
+}
+
+// Computes the items that are kept by `FilterDemandedItems`.
+class DemandedItemsCollector {
+ public:
+  DemandedItemsCollector(const IR& ir,
+                         const absl::flat_hash_set<std::string>& demanded_names)
+      : ir_(ir), demanded_names_(demanded_names) {
+    for (const IR::Item& item : ir.items) {
+      items_by_id_.insert({GetId(item), &item});
+    }
+  }
+
+  absl::flat_hash_set<ItemId> Collect() && {
+    for (const IR::Item& item : ir_.items) {
+      const BazelLabel* owning_target = GetOwningTarget(item);
+      if (std::holds_alternative<UseMod>(item) ||
+          (owning_target != nullptr && *owning_target != ir_.current_target)) {
+        kept_.insert(GetId(item));
+      } else if (!std::holds_alternative<Comment>(item) && IsDemanded(item)) {
+        Keep(GetId(item));
+      }
+    }
+    KeepDependencies();
+
+    // Operators and friend functions are only found by ADL, so they are kept
+    // with the records that they take as a parameter. This may in turn keep
+    // more records, hence the fixpoint.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (const Func* func : ir_.get_items_if<Func>()) {
+        if (func->owning_target != ir_.current_target ||
+            func->member_func_metadata.has_value() ||
+            kept_.contains(func->id) || !IsFoundByAdlOfKeptRecord(*func)) {
+          continue;
+        }
+        Keep(func->id);
+        KeepDependencies();
+        changed = true;
+      }
+    }
+    return std::move(kept_);
+  }
+
+ private:
+  const std::string& QualifiedName(const IR::Item& item) {
+    ItemId id = GetId(item);
+    if (auto it = qualified_names_.find(id); it != qualified_names_.end()) {
+      return it->second;
+    }
+    std::string qualified_name;
+    if (std::holds_alternative<UnsupportedItem>(item)) {
+      qualified_name = *GetUnqualifiedName(item);
+    } else {
+      std::optional<ItemId> enclosing_id = GetEnclosingItemId(item);
+      std::optional<std::string> name = GetUnqualifiedName(item);
+      if (enclosing_id.has_value()) {
+        if (auto it = items_by_id_.find(*enclosing_id);
+            it != items_by_id_.end()) {
+          qualified_name = QualifiedName(*it->second);
+        }
+      }
+      if (name.has_value()) {
+        qualified_name = qualified_name.empty()
+                             ? *std::move(name)
+                             : absl::StrCat(qualified_name, "::", *name);
+      }
+    }
+    return qualified_names_.insert({id, std::move(qualified_name)})
+        .first->second;
+  }
+
+  // Returns true if the qualified name of `item`, or of an item that encloses
+  // it, is demanded.
+  bool IsDemanded(const IR::Item& item) {
+    absl::string_view name = QualifiedName(item);
+    if (name.empty()) return false;
+    if (demanded_names_.contains(name)) return true;
+    for (size_t pos = name.find("::"); pos != absl::string_view::npos;
+         pos = name.find("::", pos + 2)) {
+      if (demanded_names_.contains(name.substr(0, pos))) return true;
+    }
+    return false;
+  }
+
+  bool IsFoundByAdlOfKeptRecord(const Func& func) {
+    if (func.adl_enclosing_record.has_value() &&
+        kept_.contains(*func.adl_enclosing_record)) {
+      return true;
+    }
+    if (!std::holds_alternative<Operator>(func.name)) return false;
+    for (const FuncParam& param : func.params) {
+      std::vector<ItemId> decl_ids;
+      CollectDeclIds(param.type.cpp_type, decl_ids);
+      for (ItemId decl_id : decl_ids) {
+        if (kept_.contains(decl_id)) return true;
+      }
+    }
+    return false;
+  }
+
+  static void CollectDeclIds(const CcType& type, std::vector<ItemId>& out) {
+    if (type.decl_id.has_value()) out.push_back(*type.decl_id);
+    for (const CcType& type_arg : type.type_args) {
+      CollectDeclIds(type_arg, out);
+    }
+  }
+
+  void Keep(ItemId id) {
+    if (kept_.insert(id).second) worklist_.push_back(id);
+  }
+
+  void KeepType(const MappedType& type) {
+    std::vector<ItemId> decl_ids;
+    CollectDeclIds(type.cpp_type, decl_ids);
+    for (ItemId decl_id : decl_ids) Keep(decl_id);
+  }
+
+  void KeepDependencies() {
+    while (!worklist_.empty()) {
+      ItemId id = worklist_.back();
+      worklist_.pop_back();
+      auto it = items_by_id_.find(id);
+      if (it == items_by_id_.end()) continue;
+      const IR::Item& item = *it->second;
+      if (std::optional<ItemId> enclosing_id = GetEnclosingItemId(item)) {
+        Keep(*enclosing_id);
+      }
+      if (const auto* func = std::get_if<Func>(&item)) {
+        KeepType(func->return_type);
+        for (const FuncParam& param : func->params) KeepType(param.type);
+        if (func->member_func_metadata.has_value()) {
+          Keep(func->member_func_metadata->record_id);
+        }
+        if (func->adl_enclosing_record.has_value()) {
+          Keep(*func->adl_enclosing_record);
+        }
+      } else if (const auto* record = std::get_if<Record>(&item)) {
+        for (const Field& field : record->fields) {
+          if (field.type.ok()) KeepType(*field.type);
+        }
+        for (const BaseClass& base : record->unambiguous_public_bases) {
+          Keep(base.base_record_id);
+        }
+        if (record->template_specialization.has_value()) {
+          for (const TemplateArg& arg :
+               record->template_specialization->template_args) {
+            if (arg.type.ok()) KeepType(*arg.type);
+          }
+        }
+        // Nested types are only kept if they are needed, but the member
+        // functions, including the special member functions, and constants
+        // are part of the record.
+        for (ItemId child_id : record->child_item_ids) {
+          if (auto child = items_by_id_.find(child_id);
+              child != items_by_id_.end() &&
+              (std::holds_alternative<Func>(*child->second) ||
+               std::holds_alternative<Constant>(*child->second))) {
+            Keep(child_id);
+          }
+        }
+      } else if (const auto* enum_ = std::get_if<Enum>(&item)) {
+        KeepType(enum_->underlying_type);
+      } else if (const auto* type_alias = std::get_if<TypeAlias>(&item)) {
+        KeepType(type_alias->underlying_type);
+      } else if (const auto* constant = std::get_if<Constant>(&item)) {
+        KeepType(constant->type);
+      } else if (const auto* type_map_override =
+                     std::get_if<TypeMapOverride>(&item)) {
+        for (const MappedType& type : type_map_override->type_parameters) {
+          KeepType(type);
+        }
+      }
+    }
+  }
+
+  const IR& ir_;
+  const absl::flat_hash_set<std::string>& demanded_names_;
+  absl::flat_hash_map<ItemId, const IR::Item*> items_by_id_;
+  absl::flat_hash_map<ItemId, std::string> qualified_names_;
+  absl::flat_hash_set<ItemId> kept_;
+  std::vector<ItemId> worklist_;
+};
+
+void FilterItemIds(std::vector<ItemId>& ids,
+                   const absl::flat_hash_set<ItemId>& kept) {
+  std::erase_if(ids, [&](ItemId id) { return !kept.contains(id); });
+}
+
+}  // namespace
+
+absl::flat_hash_set<std::string> ParseDemandList(absl::string_view contents) {
+  absl::flat_hash_set<std::string> demanded_names;
+  for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || absl::StartsWith(line, "#")) continue;
+    // Leading `::` is allowed, but names are always fully qualified anyway.
+    absl::ConsumePrefix(&line, "::");
+    demanded_names.insert(std::string(line));
+  }
+  return demanded_names;
+}
+
+absl::StatusOr<absl::flat_hash_set<std::string>> ReadDemandList(
+    absl::string_view path) {
+  CRUBIT_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+  return ParseDemandList(contents);
+}
+
+void FilterDemandedItems(
+    IR& ir, const absl::flat_hash_set<std::string>& demanded_names) {
+  absl::flat_hash_set<ItemId> kept =
+      DemandedItemsCollector(ir, demanded_names).Collect();
+  std::erase_if(ir.items, [&](const IR::Item& item) {
+    return !kept.contains(GetId(item));
+  });
+  for (Namespace* ns : ir.get_items_if<Namespace>()) {
+    FilterItemIds(ns->child_item_ids, kept);
+  }
+  for (Record* record : ir.get_items_if<Record>()) {
+    FilterItemIds(record->child_item_ids, kept);
+  }
+  FilterItemIds(ir.top_level_item_ids, kept);
+}
+
+}  // namespace crubit
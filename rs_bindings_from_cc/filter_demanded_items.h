@@ -0,0 +1,43 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_FILTER_DEMANDED_ITEMS_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_FILTER_DEMANDED_ITEMS_H_
+
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "rs_bindings_from_cc/ir.h"
+
+namespace crubit {
+
+// Parses a demand list: the qualified C++ names (e.g. `ns::Foo`) of the items
+// that Rust code uses, one per line. Empty lines and lines starting with `#`
+// are ignored.
+absl::flat_hash_set<std::string> ParseDemandList(absl::string_view contents);
+
+// Reads and parses the demand list in the file at `path`.
+absl::StatusOr<absl::flat_hash_set<std::string>> ReadDemandList(
+    absl::string_view path);
+
+// Removes the items of the current target that are neither demanded nor
+// needed by a demanded item from `ir`, so that no bindings are generated for
+// them.
+//
+// An item is demanded if its qualified name, or the qualified name of an
+// enclosing namespace or record, is in `demanded_names`. The items that are
+// kept also include:
+// * everything that the kept items refer to (e.g. the types of the parameters
+//   of a function, or of the fields of a record), transitively,
+// * the member functions of kept records, and the operators and friend
+//   functions that take them as a parameter,
+// * all items of other targets, since no bindings are generated for them.
+void FilterDemandedItems(
+    IR& ir, const absl::flat_hash_set<std::string>& demanded_names);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_FILTER_DEMANDED_ITEMS_H_
@@ -0,0 +1,113 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/filter_demanded_items.h"
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/ir_from_cc.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+// Returns the names of the records and named functions (i.e. neither
+// operators nor special member functions) in `ir`.
+std::vector<std::string> FuncAndRecordNames(const IR& ir) {
+  std::vector<std::string> names;
+  for (const Func* func : ir.get_items_if<Func>()) {
+    if (const auto* identifier = std::get_if<Identifier>(&func->name)) {
+      names.push_back(std::string(identifier->Ident()));
+    }
+  }
+  for (const Record* record : ir.get_items_if<Record>()) {
+    names.push_back(record->cc_name);
+  }
+  return names;
+}
+
+TEST(FilterDemandedItemsTest, ParseDemandList) {
+  EXPECT_THAT(ParseDemandList("# A comment.\n"
+                              "ns::Foo\n"
+                              "\n"
+                              "  ::Bar  \n"),
+              UnorderedElementsAre("ns::Foo", "Bar"));
+}
+
+TEST(FilterDemandedItemsTest, KeepsDependencies) {
+  absl::string_view file = R"(
+    struct Param {};
+    struct Returned {};
+    struct Unused {};
+    Returned Demanded(const Param& param);
+    void NotDemanded(Unused unused);
+  )";
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({file}));
+
+  FilterDemandedItems(ir, {"Demanded"});
+
+  EXPECT_THAT(FuncAndRecordNames(ir),
+              UnorderedElementsAre("Demanded", "Param", "Returned"));
+}
+
+TEST(FilterDemandedItemsTest, KeepsMembersAndOperatorsOfRecords) {
+  absl::string_view file = R"(
+    namespace ns {
+      struct S {
+        void Method();
+        struct Nested {};
+      };
+      bool operator==(const S& lhs, const S& rhs);
+      void Unrelated();
+    }
+  )";
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({file}));
+
+  FilterDemandedItems(ir, {"ns::S"});
+
+  EXPECT_THAT(FuncAndRecordNames(ir),
+              UnorderedElementsAre("S", "Method", "Nested"));
+  bool has_equality_operator = false;
+  for (const Func* func : ir.get_items_if<Func>()) {
+    if (const auto* op = std::get_if<Operator>(&func->name);
+        op != nullptr && op->Name() == "==") {
+      has_equality_operator = true;
+    }
+  }
+  EXPECT_TRUE(has_equality_operator);
+}
+
+TEST(FilterDemandedItemsTest, KeepsContentsOfDemandedNamespaces) {
+  absl::string_view file = R"(
+    namespace demanded {
+      void F();
+      namespace inner { void G(); }
+    }
+    namespace not_demanded {
+      void H();
+    }
+  )";
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({file}));
+
+  FilterDemandedItems(ir, {"demanded"});
+
+  EXPECT_THAT(FuncAndRecordNames(ir), UnorderedElementsAre("F", "G"));
+  std::vector<std::string> namespace_names;
+  for (const Namespace* ns : ir.get_items_if<Namespace>()) {
+    namespace_names.push_back(std::string(ns->name.Ident()));
+  }
+  EXPECT_THAT(namespace_names, UnorderedElementsAre("demanded", "inner"));
+  ASSERT_EQ(ir.top_level_item_ids.size(), 1);
+}
+
+}  // namespace
+}  // namespace crubit
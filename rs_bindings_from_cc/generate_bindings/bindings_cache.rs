@@ -0,0 +1,241 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! An on-disk cache of the formatted bindings of a target.
+//!
+//! Most edits of a C++ header (e.g. changing the body of an inline function)
+//! don't change the IR of the target at all. For those, regenerating and
+//! reformatting `rs_api.rs` and `rs_api_impl.cc` produces exactly the same
+//! output as the previous run, so the cache returns the previous output
+//! instead.
+//!
+//! The cache key covers the whole IR (with `ItemId`s canonicalized, because
+//! they are addresses of Clang decls and differ from run to run), the
+//! generator binary, and everything that affects formatting.
+//!
+//! The cache directory is meant to be shared by all targets of a build. Its
+//! entries are content-addressed by their key, and sharded into subdirectories
+//! by the first byte of the key, so that no single directory grows to hold the
+//! entries of every target.
+//!
+//! Entries are whole-target outputs: the cache does not share the bindings of
+//! class template specializations (e.g. `std::vector<int>`) between the targets
+//! that use them. Each target still imports and generates its own bindings for
+//! them.
+
+use arc_anyhow::Result;
+use ir::IR;
+use std::fs;
+use std::io::Write as _;
+use std::path::{Path, PathBuf};
+
+/// A 128-bit FNV-1a hash. It is not cryptographic, but stable across runs and
+/// platforms, and good enough to tell apart different inputs of one target.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct CacheKey(u128);
+
+impl CacheKey {
+    /// Returns the key as 32 hex digits, e.g. for the name of a cache file.
+    pub fn to_hex(&self) -> String {
+        format!("{:032x}", self.0)
+    }
+
+    /// Returns the name of the shard directory and the file stem of the entry.
+    fn shard_and_file_stem(&self) -> (String, String) {
+        let hex = self.to_hex();
+        let (shard, file_stem) = hex.split_at(2);
+        (shard.to_string(), file_stem.to_string())
+    }
+}
+
+#[derive(Clone)]
+pub struct CacheKeyBuilder(u128);
+
+impl CacheKeyBuilder {
+    const OFFSET_BASIS: u128 = 0x6c62272e07bb014262b821756295c58d;
+    const PRIME: u128 = 0x0000000001000000000000000000013B;
+
+    pub fn new() -> Self {
+        Self(Self::OFFSET_BASIS)
+    }
+
+    /// Adds `bytes` to the key. Every call is length-prefixed, so that
+    /// `add(b"ab"); add(b"c")` and `add(b"a"); add(b"bc")` produce different
+    /// keys.
+    pub fn add(&mut self, bytes: &[u8]) -> &mut Self {
+        for byte in (bytes.len() as u64).to_le_bytes().iter().chain(bytes) {
+            self.0 ^= u128::from(*byte);
+            self.0 = self.0.wrapping_mul(Self::PRIME);
+        }
+        self
+    }
+
+    /// Adds the contents of the IR to the key.
+    pub fn add_ir(&mut self, ir: &IR) -> &mut Self {
+        self.add(canonicalize_item_ids(&ir.flat_ir_stable_debug_print()).as_bytes())
+    }
+
+    /// Adds the identity of the file at `path` to the key: its path, size and
+    /// modification time. Missing files only contribute their path.
+    pub fn add_file_identity(&mut self, path: &Path) -> &mut Self {
+        self.add(path.as_os_str().as_encoded_bytes());
+        if let Ok(metadata) = fs::metadata(path) {
+            self.add(&metadata.len().to_le_bytes());
+            if let Ok(modified) = metadata.modified() {
+                self.add(format!("{modified:?}").as_bytes());
+            }
+        }
+        self
+    }
+
+    pub fn build(&self) -> CacheKey {
+        CacheKey(self.0)
+    }
+}
+
+/// Replaces the values of `ItemId(...)` in a Debug print with their index in
+/// the order of first occurrence.
+fn canonicalize_item_ids(debug_print: &str) -> String {
+    const PREFIX: &str = "ItemId(";
+    let mut ids = std::collections::HashMap::<&str, usize>::new();
+    let mut result = String::with_capacity(debug_print.len());
+    let mut rest = debug_print;
+    while let Some(start) = rest.find(PREFIX) {
+        let (before, after) = rest.split_at(start + PREFIX.len());
+        result.push_str(before);
+        let digits = after.bytes().take_while(u8::is_ascii_digit).count();
+        let (id, after) = after.split_at(digits);
+        if !id.is_empty() {
+            let next_index = ids.len();
+            let index = *ids.entry(id).or_insert(next_index);
+            result.push_str(&index.to_string());
+        }
+        rest = after;
+    }
+    result.push_str(rest);
+    result
+}
+
+/// The cached outputs of the bindings generator.
+#[derive(Debug, PartialEq, Eq)]
+pub struct CachedBindings {
+    pub rs_api: String,
+    pub rs_api_impl: String,
+    pub api_hash: String,
+}
+
+pub struct BindingsCache {
+    dir: PathBuf,
+}
+
+impl BindingsCache {
+    pub fn new(dir: &Path) -> Self {
+        Self { dir: dir.to_path_buf() }
+    }
+
+    fn path(&self, key: &CacheKey, extension: &str) -> PathBuf {
+        let (shard, file_stem) = key.shard_and_file_stem();
+        self.dir.join(shard).join(format!("{file_stem}.{extension}"))
+    }
+
+    /// Returns the bindings stored for `key`, if any. Unreadable entries are
+    /// treated as missing.
+    pub fn lookup(&self, key: &CacheKey) -> Option<CachedBindings> {
+        Some(CachedBindings {
+            rs_api: fs::read_to_string(self.path(key, "rs")).ok()?,
+            rs_api_impl: fs::read_to_string(self.path(key, "cc")).ok()?,
+            api_hash: fs::read_to_string(self.path(key, "api_hash")).ok()?,
+        })
+    }
+
+    /// Stores the bindings `rs_api` and `rs_api_impl`, and the hash of their
+    /// API, for `key`.
+    ///
+    /// Each file is written to a temporary file first and then renamed, so that
+    /// concurrent lookups never observe a partially written entry. The `.rs`
+    /// file is renamed last, since `lookup` can only succeed once it exists.
+    pub fn store(
+        &self,
+        key: &CacheKey,
+        rs_api: &str,
+        rs_api_impl: &str,
+        api_hash: &str,
+    ) -> Result<()> {
+        let rs_path = self.path(key, "rs");
+        if let Some(shard_dir) = rs_path.parent() {
+            fs::create_dir_all(shard_dir)?;
+        }
+        self.write_atomically(&self.path(key, "cc"), rs_api_impl)?;
+        self.write_atomically(&self.path(key, "api_hash"), api_hash)?;
+        self.write_atomically(&rs_path, rs_api)?;
+        Ok(())
+    }
+
+    fn write_atomically(&self, path: &Path, contents: &str) -> Result<()> {
+        let mut tmp_path = path.as_os_str().to_owned();
+        tmp_path.push(format!(".{}.tmp", std::process::id()));
+        let tmp_path = PathBuf::from(tmp_path);
+        fs::File::create(&tmp_path)?.write_all(contents.as_bytes())?;
+        fs::rename(&tmp_path, path)?;
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use arc_anyhow::Result;
+    use googletest::prelude::*;
+
+    #[gtest]
+    fn test_canonicalize_item_ids() {
+        assert_eq!(
+            canonicalize_item_ids("Func { id: ItemId(1234), parent: ItemId(99), x: ItemId(1234) }"),
+            "Func { id: ItemId(0), parent: ItemId(1), x: ItemId(0) }"
+        );
+        assert_eq!(canonicalize_item_ids("ItemId(ItemId(7)"), "ItemId(ItemId(0)");
+        assert_eq!(canonicalize_item_ids("no ids"), "no ids");
+    }
+
+    #[gtest]
+    fn test_cache_key_is_length_prefixed() {
+        let ab_c = CacheKeyBuilder::new().add(b"ab").add(b"c").build();
+        let a_bc = CacheKeyBuilder::new().add(b"a").add(b"bc").build();
+        assert_ne!(ab_c, a_bc);
+        assert_eq!(ab_c, CacheKeyBuilder::new().add(b"ab").add(b"c").build());
+    }
+
+    #[gtest]
+    fn test_lookup_after_store() -> Result<()> {
+        let dir = tempfile::tempdir()?;
+        let cache = BindingsCache::new(&dir.path().join("cache"));
+        let key = CacheKeyBuilder::new().add(b"key").build();
+        assert_eq!(cache.lookup(&key), None);
+
+        let bindings = CachedBindings {
+            rs_api: "rs".to_string(),
+            rs_api_impl: "cc".to_string(),
+            api_hash: "hash".to_string(),
+        };
+        cache.store(&key, &bindings.rs_api, &bindings.rs_api_impl, &bindings.api_hash)?;
+        assert_eq!(cache.lookup(&key), Some(bindings));
+
+        let other_key = CacheKeyBuilder::new().add(b"other key").build();
+        assert_eq!(cache.lookup(&other_key), None);
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_entries_are_sharded() -> Result<()> {
+        let dir = tempfile::tempdir()?;
+        let cache = BindingsCache::new(dir.path());
+        let key = CacheKey(0xab << 120 | 0xcd);
+        cache.store(&key, "rs", "cc", "hash")?;
+        let shard_dir = dir.path().join("ab");
+        let file_stem = format!("{:030x}", 0xcd);
+        assert_eq!(fs::read_to_string(shard_dir.join(format!("{file_stem}.rs")))?, "rs");
+        assert_eq!(fs::read_to_string(shard_dir.join(format!("{file_stem}.cc")))?, "cc");
+        Ok(())
+    }
+}
@@ -39,13 +39,17 @@ fn can_skip_cc_thunk(db: &dyn BindingsGenerator, func: &Func) -> bool {
     // correct. ThinLTO builds will be able to see through the thunk and inline
     // code across the language boundary. For non-ThinLTO builds we plan to
     // implement <internal link> which removes the runtime performance overhead.
-    if func.is_inline {
+    //
+    // `CRUBIT_INTERNAL_NO_THUNK` asserts that the library emits the definition
+    // anyway (e.g. because of `[[gnu::used]]`), so the thunk isn't needed.
+    if func.is_inline && !func.has_no_thunk_attribute {
         return false;
     }
     // ## Member functions (or descendants) of class templates
     //
-    // A thunk is required to force/guarantee template instantiation.
-    if func.is_member_or_descendant_of_class_template {
+    // A thunk is required to force/guarantee template instantiation, unless
+    // `CRUBIT_INTERNAL_NO_THUNK` asserts that the library instantiates it.
+    if func.is_member_or_descendant_of_class_template && !func.has_no_thunk_attribute {
         return false;
     }
     // ## Virtual functions
@@ -62,9 +66,12 @@ fn can_skip_cc_thunk(db: &dyn BindingsGenerator, func: &Func) -> bool {
     // In terms of runtime performance, since this only occurs for virtual function
     // calls, which are already slow, it may not be such a big deal. We can
     // benchmark it later. :)
+    //
+    // If the method (or its class) is `final`, though, there is no override to
+    // dispatch to, so the concrete `A::Method` impl can be called directly.
     if let Some(meta) = &func.member_func_metadata {
         if let Some(inst_meta) = &meta.instance_method_metadata {
-            if inst_meta.is_virtual {
+            if inst_meta.is_virtual && !inst_meta.is_final {
                 return false;
             }
         }
@@ -82,15 +89,17 @@ fn can_skip_cc_thunk(db: &dyn BindingsGenerator, func: &Func) -> bool {
 
     // ## Returning structs by value.
     //
-    // Returning a struct by value requires an explicit thunk, because
-    // `rs_bindings_from_cc` may not preserve the ABI of structs (e.g. when
-    // replacing field types with an opaque blob of bytes - see b/270454629).
+    // Returning a struct by value requires an explicit thunk, unless the Rust
+    // struct replicates all of the C++ fields (see
+    // `is_record_c_abi_compatible_by_value`). Otherwise `rs_bindings_from_cc`
+    // may not preserve the ABI of structs (e.g. when replacing field types with
+    // an opaque blob of bytes - see b/270454629).
     //
     // Note: if the RsTypeKind cannot be parsed / rs_type_kind returns Err, then
     // bindings generation will fail for this function, so it doesn't really matter
     // what we do here.
     if let Ok(return_type) = db.rs_type_kind(func.return_type.rs_type.clone()) {
-        if !return_type.is_c_abi_compatible_by_value() {
+        if !return_type.is_c_abi_compatible_by_value(db) {
             return false;
         }
     }
@@ -108,9 +117,13 @@ fn can_skip_cc_thunk(db: &dyn BindingsGenerator, func: &Func) -> bool {
     //
     // (As a side effect, this, like return values, means that support is
     // ABI-agnostic.)
+    //
+    // Borrowed bridge types are passed by reference, but the thunk still has to
+    // convert them to the C++ type.
     for param in &func.params {
-        if let Ok(param_type) = db.rs_type_kind(param.type_.rs_type.clone()) {
-            if !param_type.is_c_abi_compatible_by_value() {
+        if let Ok(param_type) = crate::param_rs_type_kind(db, &param.type_.rs_type) {
+            if !param_type.is_c_abi_compatible_by_value(db) || param_type.is_borrowed_bridge_type()
+            {
                 return false;
             }
         }
@@ -139,7 +152,8 @@ pub enum TraitName {
     /// For example, `CtorNew(vec![])` is the default constructor.
     CtorNew(Rc<[RsTypeKind]>),
     /// An Unpin constructor trait, e.g. From or Clone, with a list of parameter
-    /// types.
+    /// types. Like `CtorNew`, more than one parameter is grouped into a tuple,
+    /// e.g. `From<(i32, i32)>`.
     UnpinConstructor {
         name: Rc<str>,
         // /// Clonable, comparable token stream, which can be copied into a new TokenStream.
@@ -202,6 +216,12 @@ impl TraitName {
     /// generated.
     fn to_token_stream_removing_trait_record(&self, trait_record: Option<&Record>) -> TokenStream {
         match self {
+            Self::UnpinConstructor { name, params } if params.len() > 1 => {
+                let name_as_token_stream = name.parse::<TokenStream>().unwrap();
+                let formatted_params =
+                    format_tuple_except_singleton_replacing_by_self(params, trait_record);
+                quote! {#name_as_token_stream < #formatted_params >}
+            }
             Self::UnpinConstructor { name, params } | Self::Other { name, params, .. } => {
                 let name_as_token_stream = name.parse::<TokenStream>().unwrap();
                 let formatted_params =
@@ -499,6 +519,18 @@ fn api_func_shape(
         false
     };
 
+    if func.rust_name.is_some() && !matches!(func.name, UnqualifiedIdentifier::Identifier(_)) {
+        bail!("`CRUBIT_INTERNAL_RUST_NAME` is only supported on named functions");
+    }
+    if let Some(rust_name) = &func.rust_name {
+        // `make_rs_ident` panics on strings that can't be spelled as a (raw) Rust identifier,
+        // such as `""`, `"1x"` or `"a::b"`.
+        ensure!(
+            syn::parse_str::<syn::Ident>(&format!("r#{rust_name}")).is_ok(),
+            "`CRUBIT_INTERNAL_RUST_NAME` must be a valid Rust identifier, got `{rust_name}`"
+        );
+    }
+
     match &func.name {
         UnqualifiedIdentifier::Operator(_) | UnqualifiedIdentifier::Identifier(_)
             if adl_check_required_and_failed =>
@@ -759,7 +791,7 @@ fn api_func_shape(
             }
         },
         UnqualifiedIdentifier::Identifier(id) => {
-            func_name = make_rs_ident(&id.identifier);
+            func_name = make_rs_ident(func.rust_name.as_deref().unwrap_or(&id.identifier));
             match maybe_record {
                 None => {
                     impl_kind = ImplKind::None { is_unsafe };
@@ -897,8 +929,20 @@ fn api_func_shape(
                         }
                     }
                     _ => {
-                        // TODO(b/216648347): Support bindings for other constructors.
-                        bail!("More than 1 constructor parameter is not supported yet",);
+                        // Constructors with several parameters implement
+                        // `From<(A, B, ...)>`, mirroring `CtorNew` for !Unpin
+                        // types, but constructing the value directly.
+                        impl_kind = ImplKind::new_trait(
+                            TraitName::UnpinConstructor {
+                                name: Rc::from("From"),
+                                params: Rc::from(&param_types[1..]),
+                            },
+                            record.clone(),
+                            /* format_first_param_as_self= */ false,
+                            /* force_const_reference_params= */
+                            false,
+                        )?;
+                        func_name = make_rs_ident("from");
                     }
                 }
             }
@@ -1020,8 +1064,8 @@ pub fn generate_func(
         .iter()
         .enumerate()
         .map(|(i, p)| {
-            db.rs_type_kind(p.type_.rs_type.clone())
-                .with_context(|| format!("Failed to format type of parameter {i}"))
+            crate::param_rs_type_kind(db, &p.type_.rs_type)
+                .with_lazy_context(move |f| write!(f, "Failed to format type of parameter {i}"))
         })
         .collect::<Result<Vec<_>>>()?;
 
@@ -1039,14 +1083,25 @@ pub fn generate_func(
     return_type.check_by_value()?;
     let param_idents =
         func.params.iter().map(|p| make_rs_ident(&p.identifier.identifier)).collect_vec();
-    let thunk = generate_func_thunk(
-        db,
-        &func,
-        &param_idents,
-        &param_types,
-        &return_type,
-        derived_record.clone(),
-    )?;
+    let structural_eq_body = generate_structural_eq_body(db, &func, &impl_kind, &param_idents);
+    let needs_thunk = structural_eq_body.is_none();
+    let mut thunk = if !needs_thunk {
+        quote! {}
+    } else {
+        generate_func_thunk(
+            db,
+            &func,
+            &param_idents,
+            &param_types,
+            &return_type,
+            derived_record.clone(),
+        )?
+    };
+    let batch_func = if func.has_batch_attribute {
+        Some(generate_batch_func(db, &func, &func_name, &impl_kind, &param_types, &return_type)?)
+    } else {
+        None
+    };
 
     // If the Rust trait require a function to take the params by const reference
     // and the thunk takes some of its params by value then we should add a const
@@ -1072,7 +1127,12 @@ pub fn generate_func(
                                 func,
                             );
                         }
-                        clone_prefixes.push(quote!{&mut});
+                        // C-ABI-compatible records are passed to the thunk by value.
+                        if param_type.is_c_abi_compatible_by_value(db) {
+                            clone_prefixes.push(quote!{});
+                        } else {
+                            clone_prefixes.push(quote!{&mut});
+                        }
                         clone_suffixes.push(quote!{.clone()});
                         Ok(RsTypeKind::Reference {
                             referent: Rc::new(param_type.clone()),
@@ -1100,6 +1160,7 @@ pub fn generate_func(
         thunk_prepare,
         thunk_args,
     } = function_signature(
+        db,
         &mut features,
         &func,
         &impl_kind,
@@ -1116,8 +1177,9 @@ pub fn generate_func(
             thunk_ident(&func)
         };
 
-        let func_body = match &impl_kind {
-            ImplKind::Trait { trait_name: TraitName::UnpinConstructor { .. }, .. } => {
+        let func_body = match (&impl_kind, structural_eq_body) {
+            (_, Some(structural_eq_body)) => structural_eq_body,
+            (ImplKind::Trait { trait_name: TraitName::UnpinConstructor { .. }, .. }, None) => {
                 // SAFETY: A user-defined constructor is not guaranteed to
                 // initialize all the fields. To make the `assume_init()` call
                 // below safe, the memory is zero-initialized first. This is a
@@ -1127,6 +1189,7 @@ pub fn generate_func(
                 // reference fields). TODO(b/213243309): Double-check if
                 // zero-initialization is desirable here.
                 quote! {
+                    #thunk_prepare
                     let mut tmp = ::core::mem::MaybeUninit::<Self>::zeroed();
                     unsafe {
                         #crate_root_path::detail::#thunk_ident( &mut tmp #( , #thunk_args )* );
@@ -1140,7 +1203,7 @@ pub fn generate_func(
                 // not generate the thunk at all, but this would be a bit of extra work.
                 //
                 // TODO(jeanpierreda): separately handle non-Unpin and non-trivial types.
-                let mut body = if return_type.is_c_abi_compatible_by_value() {
+                let mut body = if return_type.is_c_abi_compatible_by_value(db) {
                     quote! {
                         #crate_root_path::detail::#thunk_ident(
                             #( #clone_prefixes #thunk_args #clone_suffixes ),*
@@ -1414,11 +1477,18 @@ pub fn generate_func(
 
     // If we are generating bindings for a derived record, we reuse the base
     // record's thunks, so we don't need to generate thunks.
-    let thunk_impls = if derived_record.is_some() {
+    let mut thunk_impls = if derived_record.is_some() || !needs_thunk {
         quote! {}
     } else {
         generate_func_thunk_impl(db, &func)?
     };
+    let mut api_func = api_func;
+    if let Some(BatchFunc { api_func: batch_api_func, thunk: batch_thunk, thunk_impl }) = batch_func
+    {
+        api_func.extend(batch_api_func);
+        thunk.extend(batch_thunk);
+        thunk_impls.extend(thunk_impl);
+    }
 
     let generated_item = GeneratedItem {
         item: api_func,
@@ -1430,6 +1500,175 @@ pub fn generate_func(
     Ok(Some((Rc::new(generated_item), Rc::new(function_id))))
 }
 
+/// Returns the body of `PartialEq::eq` for a defaulted `operator==` that can be
+/// implemented in Rust, by comparing the fields directly instead of calling into
+/// C++: the record must have no base classes, and all its fields must be public,
+/// named primitives or pointers, for which Rust's `==` is the same as C++'s.
+///
+/// Returns `None` if the function should call its C++ thunk as usual.
+fn generate_structural_eq_body(
+    db: &dyn BindingsGenerator,
+    func: &Func,
+    impl_kind: &ImplKind,
+    param_idents: &[Ident],
+) -> Option<TokenStream> {
+    let ImplKind::Trait { trait_name: TraitName::PartialEq { params }, record, .. } = impl_kind
+    else {
+        return None;
+    };
+    let [RsTypeKind::Record { record: rhs_record, .. }] = &**params else {
+        return None;
+    };
+    if !func.is_defaulted || rhs_record.id != record.id || record.is_derived_class {
+        return None;
+    }
+    let fields = record
+        .fields
+        .iter()
+        .map(|field| {
+            if field.access != AccessSpecifier::Public || field.is_bitfield {
+                return None;
+            }
+            let identifier = field.identifier.as_ref()?;
+            // Fields whose type can't be used for the layout are opaque blobs in
+            // the Rust struct.
+            let mut type_kind =
+                crate::generate_record::get_field_rs_type_kind_for_layout(db, record, field)
+                    .ok()?;
+            while let RsTypeKind::TypeAlias { underlying_type, .. } = type_kind {
+                type_kind = (*underlying_type).clone();
+            }
+            match type_kind {
+                RsTypeKind::Primitive(PrimitiveType::Unit) => None,
+                RsTypeKind::Primitive(_) | RsTypeKind::Pointer { .. } => {
+                    Some(make_rs_ident(&identifier.identifier))
+                }
+                _ => None,
+            }
+        })
+        .collect::<Option<Vec<_>>>()?;
+    let rhs = param_idents.get(1)?;
+    if fields.is_empty() {
+        return Some(quote! { true });
+    }
+    Some(quote! { #( self.#fields == #rhs.#fields )&&* })
+}
+
+/// The bindings of the `<name>_batch` entry point of a function annotated with
+/// `CRUBIT_INTERNAL_BATCH`.
+struct BatchFunc {
+    api_func: TokenStream,
+    thunk: TokenStream,
+    thunk_impl: TokenStream,
+}
+
+/// Generates `<name>_batch(inputs: &[T], outputs: &mut [R])`, which calls
+/// `<name>` on every element of `inputs` from a single C++ thunk.
+fn generate_batch_func(
+    db: &dyn BindingsGenerator,
+    func: &Func,
+    func_name: &Ident,
+    impl_kind: &ImplKind,
+    param_types: &[RsTypeKind],
+    return_type: &RsTypeKind,
+) -> Result<BatchFunc> {
+    let ir = db.ir();
+    let UnqualifiedIdentifier::Identifier(id) = &func.name else {
+        bail!("`CRUBIT_INTERNAL_BATCH` is only supported on named functions");
+    };
+    if !matches!(impl_kind, ImplKind::None { .. }) || func.member_func_metadata.is_some() {
+        bail!("`CRUBIT_INTERNAL_BATCH` is only supported on free functions");
+    }
+    let ([param_type], [param]) = (param_types, &func.params[..]) else {
+        bail!("`CRUBIT_INTERNAL_BATCH` requires a function with a single parameter");
+    };
+    // The C++ thunk reads `inputs[i]` through a pointer to const, so the element
+    // is the referent of a const reference, or a primitive or pointer passed by
+    // value.
+    let (element_type, mut cc_element_type) = match param_type {
+        RsTypeKind::Primitive(_) | RsTypeKind::Pointer { .. } => {
+            (param_type, param.type_.cpp_type.clone())
+        }
+        RsTypeKind::Reference { referent, mutability: Mutability::Const, .. }
+            if referent.lifetimes().next().is_none() =>
+        {
+            let [pointee] = &param.type_.cpp_type.type_args[..] else {
+                bail!("Invalid reference type: {:?}", param.type_.cpp_type);
+            };
+            (&**referent, pointee.clone())
+        }
+        _ => bail!(
+            "`CRUBIT_INTERNAL_BATCH` requires a parameter of primitive or pointer type, or a \
+             const reference without lifetime parameters"
+        ),
+    };
+    let returns_unit = matches!(return_type, RsTypeKind::Primitive(PrimitiveType::Unit));
+    if !return_type.is_primitive() || returns_unit {
+        bail!("`CRUBIT_INTERNAL_BATCH` requires a function that returns a primitive type");
+    }
+    cc_element_type.is_const = true;
+    let cc_element_type = crate::format_cpp_type(&cc_element_type, &ir)?;
+    let mut cc_return_type = func.return_type.cpp_type.clone();
+    cc_return_type.is_const = false;
+    let cc_return_type = crate::format_cpp_type(&cc_return_type, &ir)?;
+
+    let crate_root_path = crate::crate_root_path_tokens(&ir);
+    let batch_name = format_ident!("{func_name}_batch");
+    let batch_thunk_ident = format_ident!("{}__batch", thunk_ident(func));
+    let mut doc_comment = format!(
+        " Calls `{func_name}` on every element of `inputs`, and stores the results in \
+         `outputs`.\n\n Panics if `inputs` and `outputs` have different lengths."
+    );
+    // `<name>_batch` calls `<name>`, so it is exactly as unsafe.
+    let (unsafe_, body) = if impl_kind.is_unsafe() {
+        doc_comment.push_str(&format!(
+            "\n\n # Safety\n\n Every element of `inputs` must meet the safety requirements \
+             of the parameter of `{func_name}`."
+        ));
+        (
+            quote! { unsafe },
+            quote! {
+                #crate_root_path::detail::#batch_thunk_ident(
+                    inputs.as_ptr(), outputs.as_mut_ptr(), inputs.len())
+            },
+        )
+    } else {
+        (
+            quote! {},
+            quote! {
+                unsafe {
+                    #crate_root_path::detail::#batch_thunk_ident(
+                        inputs.as_ptr(), outputs.as_mut_ptr(), inputs.len())
+                }
+            },
+        )
+    };
+    let fn_ident = crate::format_cc_ident(&id.identifier);
+    let namespace_qualifier = ir.namespace_qualifier(func)?.format_for_cc()?;
+    Ok(BatchFunc {
+        api_func: quote! {
+            #[doc = #doc_comment]
+            #[inline(always)]
+            pub #unsafe_ fn #batch_name(inputs: &[#element_type], outputs: &mut [#return_type]) {
+                assert_eq!(inputs.len(), outputs.len());
+                #body
+            }
+        },
+        thunk: quote! {
+            pub(crate) unsafe fn #batch_thunk_ident(
+                inputs: *const #element_type, outputs: *mut #return_type, len: usize);
+        },
+        thunk_impl: quote! {
+            extern "C" void #batch_thunk_ident(
+                    #cc_element_type * inputs, #cc_return_type * outputs, std::size_t len) {
+                for (std::size_t i = 0; i < len; ++i) {
+                    outputs[i] = #namespace_qualifier #fn_ident(inputs[i]);
+                }
+            }
+        },
+    })
+}
+
 /// The function signature for a function's bindings.
 struct BindingsSignature {
     /// The lifetime parameters for the Rust function.
@@ -1467,6 +1706,7 @@ struct BindingsSignature {
 ///   return value), retaining it on the C++ side / thunk args.
 /// * serialize a `()` as the empty string.
 fn function_signature(
+    db: &dyn BindingsGenerator,
     features: &mut BTreeSet<Ident>,
     func: &Func,
     impl_kind: &ImplKind,
@@ -1527,7 +1767,7 @@ fn function_signature(
             } else {
                 quote! {#type_}
             };
-            if type_.is_c_abi_compatible_by_value() {
+            if type_.is_c_abi_compatible_by_value(db) {
                 api_params.push(quote! {#ident: #quoted_type_or_self});
                 thunk_args.push(quote! {#ident});
             } else {
@@ -1583,8 +1823,14 @@ fn function_signature(
             );
         }
 
-        // CtorNew groups parameters into a tuple.
-        if let TraitName::CtorNew(args_type) = trait_name {
+        // CtorNew (and multi-parameter Unpin constructors) group parameters into
+        // a tuple.
+        let tupled_args_type = match trait_name {
+            TraitName::CtorNew(args_type) => Some(args_type),
+            TraitName::UnpinConstructor { params, .. } if params.len() > 1 => Some(params),
+            _ => None,
+        };
+        if let Some(args_type) = tupled_args_type {
             let args_type = if let Some(impl_record) = impl_kind_record {
                 format_tuple_except_singleton_replacing_by_self(args_type, Some(impl_record))
             } else {
@@ -1633,7 +1879,7 @@ fn function_signature(
                 // impl block is for `T`. The `self` parameter has a type determined by the
                 // first parameter (typically a reference of some kind) and can be passed to a
                 // thunk via the expression `self`.
-                if first_api_param.is_c_abi_compatible_by_value() {
+                if first_api_param.is_c_abi_compatible_by_value(db) {
                     let rs_snippet = first_api_param.format_as_self_param()?;
                     api_params[0] = rs_snippet.tokens;
                     features.extend(rs_snippet.features.into_iter());
@@ -1714,7 +1960,7 @@ fn generate_func_thunk(
             )
         })?);
         out_param_ident = Some(param_idents.next().unwrap().clone());
-    } else if !return_type.is_c_abi_compatible_by_value() {
+    } else if !return_type.is_c_abi_compatible_by_value(db) {
         // For return types that can't be passed by value, create a new out parameter.
         // The lifetime doesn't matter, so we can insert a new anonymous lifetime here.
         // TODO(yongheng): Switch to `void*`.
@@ -1734,7 +1980,7 @@ fn generate_func_thunk(
     let generic_params = format_generic_params(&lifetimes, std::iter::empty::<syn::Ident>());
     let param_idents = out_param_ident.as_ref().into_iter().chain(param_idents);
     let param_types = out_param.into_iter().chain(param_types.map(|t| {
-        if !t.is_c_abi_compatible_by_value() {
+        if !t.is_c_abi_compatible_by_value(db) {
             quote! {&mut #t}
         } else {
             quote! {#t}
@@ -1794,6 +2040,10 @@ fn format_tuple_except_singleton_replacing_by_self(
 
 /// Identifies all functions having overloads that we can't import (yet).
 ///
+/// Overloads that are given distinct names with `CRUBIT_INTERNAL_RUST_NAME`
+/// have distinct `FunctionId`s, so they are not in this set, and are imported
+/// as plain functions rather than behind a dispatch trait.
+///
 /// TODO(b/213280424): Implement support for overloaded functions.
 pub fn overloaded_funcs(db: &dyn BindingsGenerator) -> Rc<HashSet<Rc<FunctionId>>> {
     let mut seen_funcs = HashSet::new();
@@ -1897,8 +2147,24 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
         .params
         .iter()
         .map(|p| {
-            let cpp_type = crate::format_cpp_type(&p.type_.cpp_type, &ir)?;
-            let arg_type = db.rs_type_kind(p.type_.rs_type.clone())?;
+            let mut cpp_type = crate::format_cpp_type(&p.type_.cpp_type, &ir)?;
+            let mut arg_type = crate::param_rs_type_kind(db, &p.type_.rs_type)?;
+            if let Some(referent) =
+                arg_type.referent().filter(|_| arg_type.is_borrowed_bridge_type())
+            {
+                // The Rust value is converted into a temporary, which the C++ function gets
+                // a `const` reference to.
+                let mut referent_cpp_type = p
+                    .type_
+                    .cpp_type
+                    .type_args
+                    .first()
+                    .ok_or_else(|| anyhow!("Missing referent type: {:?}", p.type_.cpp_type))?
+                    .clone();
+                referent_cpp_type.is_const = false;
+                cpp_type = crate::format_cpp_type(&referent_cpp_type, &ir)?;
+                arg_type = referent.clone();
+            }
             if arg_type.is_bridge_type() {
                 match &arg_type {
                     RsTypeKind::BridgeType { rust_to_cpp_converter, .. } => {
@@ -1920,7 +2186,7 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
                         bail!("Invalid bridge type: {:?}", arg_type);
                     }
                 }
-            } else if !arg_type.is_c_abi_compatible_by_value() {
+            } else if !arg_type.is_c_abi_compatible_by_value(db) {
                 // non-Unpin types are wrapped by a pointer in the thunk.
                 Ok(quote! {#cpp_type *})
             } else {
@@ -1934,7 +2200,8 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
         .iter()
         .map(|p| {
             let mut ident = crate::format_cc_ident(&p.identifier.identifier);
-            if db.rs_type_kind(p.type_.rs_type.clone())?.is_bridge_type() {
+            let param_type = crate::param_rs_type_kind(db, &p.type_.rs_type)?;
+            if param_type.is_bridge_type() || param_type.is_borrowed_bridge_type() {
                 let formatted_ident = convert_ident(&ident);
                 ident = quote! { &(#formatted_ident.val) };
             }
@@ -1944,7 +2211,7 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
                 _ => {
                     let rs_type_kind = db.rs_type_kind(p.type_.rs_type.clone())?;
                     // non-Unpin types are wrapped by a pointer in the thunk.
-                    if !rs_type_kind.is_c_abi_compatible_by_value() {
+                    if !rs_type_kind.is_c_abi_compatible_by_value(db) {
                         Ok(quote! { std::move(* #ident) })
                     } else if rs_type_kind.is_primitive() || rs_type_kind.referent().is_some() {
                         Ok(quote! { #ident })
@@ -1961,7 +2228,7 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
     // computation, so that it's only in the parameter list, not the argument
     // list.)
     let return_type_kind = db.rs_type_kind(func.return_type.rs_type.clone())?;
-    let is_return_value_c_abi_compatible = return_type_kind.is_c_abi_compatible_by_value();
+    let is_return_value_c_abi_compatible = return_type_kind.is_c_abi_compatible_by_value(db);
 
     let return_type_name = if !is_return_value_c_abi_compatible {
         param_idents.insert(0, crate::format_cc_ident("__return"));
@@ -2016,7 +2283,15 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
         };
 
     let return_expr = quote! {#implementation_function( #( #arg_expressions ),* )};
-    let return_stmt = if !is_return_value_c_abi_compatible {
+    let special_member_thunk = special_member_thunk(func).filter(|_| conversion_stmts.is_empty());
+    let return_stmt = if let Some(special_member_thunk) = special_member_thunk {
+        let call = quote! { crubit::#special_member_thunk( #( #param_idents ),* ) };
+        if func.return_type.cpp_type.name.as_deref() == Some("void") {
+            call
+        } else {
+            quote! { return #call }
+        }
+    } else if !is_return_value_c_abi_compatible {
         let out_param = &param_idents[0];
         match &return_type_kind {
             RsTypeKind::BridgeType { cpp_to_rust_converter, .. } => {
@@ -2065,6 +2340,53 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
     })
 }
 
+/// Returns the function template in `support/internal/special_member_thunks.h`
+/// that implements the thunk of `func`, if `func` is a special member function
+/// (other than a rvalue-qualified assignment operator) of its record.
+fn special_member_thunk(func: &Func) -> Option<Ident> {
+    let meta = func.member_func_metadata.as_ref()?;
+    // Whether `ty` is a (`const` or non-`const`) `&` or `&&` reference to the
+    // record.
+    let is_record_ref = |ty: &CcType, reference: &str, is_const: bool| {
+        ty.name.as_deref() == Some(reference)
+            && matches!(&ty.type_args[..], [referent]
+                if referent.decl_id == Some(meta.record_id) && referent.is_const == is_const)
+    };
+    let other_param_ty = func.params.get(1).map(|param| &param.type_.cpp_type);
+    let name = match (&func.name, func.params.len()) {
+        (UnqualifiedIdentifier::Constructor, 1) => "DefaultCtorThunk",
+        (UnqualifiedIdentifier::Constructor, 2) => {
+            let other_param_ty = other_param_ty?;
+            if is_record_ref(other_param_ty, "&", true) {
+                "CopyCtorThunk"
+            } else if is_record_ref(other_param_ty, "&&", false) {
+                "MoveCtorThunk"
+            } else {
+                return None;
+            }
+        }
+        (UnqualifiedIdentifier::Destructor, 1) => "DtorThunk",
+        (UnqualifiedIdentifier::Operator(op), 2) if &*op.name == "=" => {
+            let instance_method = meta.instance_method_metadata.as_ref()?;
+            if instance_method.reference == ir::ReferenceQualification::RValue
+                || !is_record_ref(&func.return_type.cpp_type, "&", false)
+            {
+                return None;
+            }
+            let other_param_ty = other_param_ty?;
+            if is_record_ref(other_param_ty, "&", true) {
+                "CopyAssignThunk"
+            } else if is_record_ref(other_param_ty, "&&", false) {
+                "MoveAssignThunk"
+            } else {
+                return None;
+            }
+        }
+        _ => return None,
+    };
+    Some(format_ident!("{name}"))
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -2147,6 +2469,192 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_inline_function_with_no_thunk_attribute() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"[[clang::annotate("crubit_internal_no_thunk")]]
+               inline int Add(int a, int b);"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                unsafe extern "C" {
+                    #[link_name = "_Z3Addii"]
+                    pub(crate) unsafe fn __rust_thunk___Z3Addii(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int;
+                }
+            }
+        );
+        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___Z3Addii});
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_batch_function() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"struct Foo { int i; };
+               [[clang::annotate("crubit_internal_batch")]] int Hash(const Foo& foo);"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn Hash_batch(inputs: &[crate::Foo], outputs: &mut [::core::ffi::c_int]) {
+                    assert_eq!(inputs.len(), outputs.len());
+                    unsafe {
+                        crate::detail::__rust_thunk___Z4HashRK3Foo__batch(
+                            inputs.as_ptr(), outputs.as_mut_ptr(), inputs.len())
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub(crate) unsafe fn __rust_thunk___Z4HashRK3Foo__batch(
+                    inputs: *const crate::Foo, outputs: *mut ::core::ffi::c_int, len: usize);
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___Z4HashRK3Foo__batch(
+                        const struct Foo* inputs, int* outputs, std::size_t len) {
+                    for (std::size_t i = 0; i < len; ++i) {
+                        outputs[i] = Hash(inputs[i]);
+                    }
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_batch_function_with_pointer_param_is_unsafe() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"struct Foo { int i; };
+               [[clang::annotate("crubit_internal_batch")]] int Hash(const Foo* foo);"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[doc = " Calls `Hash` on every element of `inputs`, and stores the results in \
+                         `outputs`.\n\n Panics if `inputs` and `outputs` have different lengths.\
+                         \n\n # Safety\n\n Every element of `inputs` must meet the safety \
+                         requirements of the parameter of `Hash`."]
+                #[inline(always)]
+                pub unsafe fn Hash_batch(
+                    inputs: &[*const crate::Foo], outputs: &mut [::core::ffi::c_int]
+                ) {
+                    assert_eq!(inputs.len(), outputs.len());
+                    crate::detail::__rust_thunk___Z4HashPK3Foo__batch(
+                        inputs.as_ptr(), outputs.as_mut_ptr(), inputs.len())
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub(crate) unsafe fn __rust_thunk___Z4HashPK3Foo__batch(
+                    inputs: *const *const crate::Foo, outputs: *mut ::core::ffi::c_int, len: usize);
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___Z4HashPK3Foo__batch(
+                        const struct Foo* const* inputs, int* outputs, std::size_t len) {
+                    for (std::size_t i = 0; i < len; ++i) {
+                        outputs[i] = Hash(inputs[i]);
+                    }
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_batch_function_requires_single_param() -> Result<()> {
+        let ir =
+            ir_from_cc(r#"[[clang::annotate("crubit_internal_batch")]] int Add(int a, int b);"#)?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_not_matches!(rs_api, quote! { pub fn Add });
+        assert_rs_not_matches!(rs_api, quote! { pub fn Add_batch });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_rust_name_disambiguates_overloads() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"[[clang::annotate("crubit_internal_rust_name", "StrCat2")]]
+               int StrCat(int a, int b);
+               [[clang::annotate("crubit_internal_rust_name", "StrCat3")]]
+               int StrCat(int a, int b, int c);
+               struct S final {
+                 [[clang::annotate("crubit_internal_rust_name", "set_int")]]
+                 void set(int i) {}
+                 [[clang::annotate("crubit_internal_rust_name", "set_double")]]
+                 void set(double d) {}
+               };"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn StrCat2(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int
+            }
+        );
+        assert_rs_matches!(rs_api, quote! { pub fn StrCat3(... c: ::core::ffi::c_int ...) });
+        assert_rs_matches!(
+            rs_api,
+            quote! { pub fn set_int<'a>(&'a mut self, i: ::core::ffi::c_int) }
+        );
+        assert_rs_matches!(rs_api, quote! { pub fn set_double<'a>(&'a mut self, d: f64) });
+        assert_rs_not_matches!(rs_api, quote! { pub fn StrCat(...) });
+        // The C++ side still calls the functions by their C++ name.
+        assert_cc_matches!(rs_api_impl, quote! { __this->set(i) });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_rust_name_requires_named_function() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"struct S final {
+                 [[clang::annotate("crubit_internal_rust_name", "new")]] S(int i);
+               };"#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_not_matches!(rs_api, quote! { pub fn new });
+        assert_rs_not_matches!(rs_api, quote! { impl From<::core::ffi::c_int> for S });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_rust_name_must_be_valid_identifier() -> Result<()> {
+        for rust_name in ["", "1x", "a::b", "self"] {
+            let ir = ir_from_cc(&format!(
+                r#"[[clang::annotate("crubit_internal_rust_name", "{rust_name}")]] void f();"#
+            ))?;
+            let rs_api = generate_bindings_tokens(ir)?.rs_api;
+            assert_rs_not_matches!(rs_api, quote! { pub fn });
+            assert_cc_matches!(rs_api, {
+                let txt = format!(
+                    "Generated from: google3/ir_from_cc_virtual_header.h;l=3\n\
+                     Error while generating bindings for item 'f':\n\
+                     `CRUBIT_INTERNAL_RUST_NAME` must be a valid Rust identifier, got `{rust_name}`"
+                );
+                quote! { __COMMENT__ #txt }
+            });
+        }
+        // Keywords are spelled as raw identifiers.
+        let ir = ir_from_cc(r#"[[clang::annotate("crubit_internal_rust_name", "fn")]] void f();"#)?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(rs_api, quote! { pub fn r#fn() });
+        Ok(())
+    }
+
     #[gtest]
     fn test_simple_function_with_types_from_other_target() -> Result<()> {
         let ir = ir_from_cc_dependency(
@@ -2421,7 +2929,7 @@ mod tests {
         assert_rs_not_matches!(rs_api, quote! {impl Drop});
         assert_rs_not_matches!(rs_api, quote! {impl ::ctor::PinnedDrop});
         assert_rs_matches!(rs_api, quote! {pub x: ::core::ffi::c_int});
-        assert_cc_not_matches!(rs_api_impl, quote! { std::destroy_at });
+        assert_cc_not_matches!(rs_api_impl, quote! { DtorThunk });
         Ok(())
     }
 
@@ -2454,7 +2962,89 @@ mod tests {
             quote! {
                 extern "C" void __rust_thunk___ZN20DefaultedConstructorC1Ev(
                         struct DefaultedConstructor* __this) {
-                    crubit::construct_at(__this);
+                    crubit::DefaultCtorThunk(__this);
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_special_member_thunks() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct Nontrivial final {
+                Nontrivial(const Nontrivial&);
+                Nontrivial(Nontrivial&&);
+                Nontrivial(int);
+                Nontrivial& operator=(const Nontrivial&);
+                Nontrivial& operator=(Nontrivial&&);
+                Nontrivial& operator=(int);
+                ~Nontrivial();
+            };"#,
+        )?;
+        let rs_api_impl = generate_bindings_tokens(ir)?.rs_api_impl;
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___ZN10NontrivialC1ERKS_(
+                        struct Nontrivial* __this, const struct Nontrivial* __param_0) {
+                    crubit::CopyCtorThunk(__this, __param_0);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___ZN10NontrivialC1EOS_(
+                        struct Nontrivial* __this, struct Nontrivial* __param_0) {
+                    crubit::MoveCtorThunk(__this, __param_0);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" struct Nontrivial* __rust_thunk___ZN10NontrivialaSERKS_(
+                        struct Nontrivial* __this, const struct Nontrivial* __param_0) {
+                    return crubit::CopyAssignThunk(__this, __param_0);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" struct Nontrivial* __rust_thunk___ZN10NontrivialaSEOS_(
+                        struct Nontrivial* __this, struct Nontrivial* __param_0) {
+                    return crubit::MoveAssignThunk(__this, __param_0);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___ZN10NontrivialD1Ev(struct Nontrivial* __this) {
+                    crubit::DtorThunk(__this);
+                }
+            }
+        );
+        // Other constructors and assignment operators call the C++ function
+        // directly.
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___ZN10NontrivialC1Ei(
+                        struct Nontrivial* __this, int __param_0) {
+                    crubit::construct_at(__this, __param_0);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" struct Nontrivial* __rust_thunk___ZN10NontrivialaSEi(
+                        struct Nontrivial* __this, int __param_0) {
+                    return &__this->operator=(__param_0);
                 }
             }
         );
@@ -2559,6 +3149,35 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_impl_from_tuple_for_2_arg_constructor() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct SomeStruct final {
+                SomeStruct(int i, float f);
+            };"#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl From<(::core::ffi::c_int, f32)> for SomeStruct {
+                    #[inline(always)]
+                    fn from(args: (::core::ffi::c_int, f32)) -> Self {
+                        let (i, f) = args;
+                        let mut tmp = ::core::mem::MaybeUninit::<Self>::zeroed();
+                        unsafe {
+                            crate::detail::__rust_thunk___ZN10SomeStructC1Eif(&mut tmp, i, f);
+                            tmp.assume_init()
+                        }
+                    }
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! {::ctor::CtorNew});
+        Ok(())
+    }
+
     #[gtest]
     fn test_impl_from_for_implicit_conversion_from_reference() -> Result<()> {
         let ir = ir_from_cc(
@@ -2643,6 +3262,57 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_impl_eq_for_defaulted_operator_compares_fields() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct SomeStruct final {
+                bool operator==(const SomeStruct& other) const = default;
+                int i;
+                float f;
+                const int* p;
+            };"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl PartialEq for SomeStruct {
+                    #[inline(always)]
+                    fn eq<'a, 'b>(&'a self, other: &'b Self) -> bool {
+                        self.i == other.i && self.f == other.f && self.p == other.p
+                    }
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { __rust_thunk___ZNK10SomeStructeqERKS_ });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZNK10SomeStructeqERKS_ });
+        Ok(())
+    }
+
+    /// Fields that Rust can't compare the same way as C++ (or can't access) keep
+    /// the call to the C++ `operator==`.
+    #[gtest]
+    fn test_impl_eq_for_defaulted_operator_with_private_field() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            class SomeClass final {
+              public:
+                bool operator==(const SomeClass& other) const = default;
+              private:
+                int i;
+            };"#,
+        )?;
+        let BindingsTokens { rs_api, .. } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                unsafe { crate::detail::__rust_thunk___ZNK9SomeClasseqERKS_(self, other) }
+            }
+        );
+        Ok(())
+    }
+
     #[gtest]
     fn test_impl_eq_for_free_function() -> Result<()> {
         let ir = ir_from_cc(
@@ -2712,7 +3382,7 @@ mod tests {
                     #[inline(always)]
                     fn eq(&self, rhs: &Self) -> bool {
                         unsafe {
-                            crate::detail::__rust_thunk___Zeq10SomeStructS_(&mut self.clone(), &mut rhs.clone())
+                            crate::detail::__rust_thunk___Zeq10SomeStructS_(self.clone(), rhs.clone())
                         }
                     }
                 }
@@ -2847,7 +3517,7 @@ mod tests {
                     #[inline(always)]
                     fn lt(& self, rhs: &Self) -> bool {
                         unsafe { crate::detail::__rust_thunk___Zlt10SomeStructS_(
-                                &mut self.clone(), &mut rhs.clone()) }
+                                self.clone(), rhs.clone()) }
                     }
                 }
             }
@@ -3570,14 +4240,62 @@ mod tests {
             quote! {
                 #[inline(always)]
                 pub fn foo() -> crate::Trivial {
-                    unsafe {
-                        let mut __return = ::core::mem::MaybeUninit::<crate::Trivial>::uninit();
-                        crate::detail::__rust_thunk___Z3foov(&mut __return);
-                        __return.assume_init()
-                    }
+                    unsafe { crate::detail::__rust_thunk___Z3foov() }
                 }
             }
         );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[link_name = "_Z3foov"]
+                pub(crate) unsafe fn __rust_thunk___Z3foov() -> crate::Trivial;
+            }
+        );
+        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___Z3foov});
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_unpin_by_value_param_and_return_through_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct Trivial final {
+              int trivial_field;
+            };
+
+            inline Trivial foo(Trivial t) { return t; }
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub(crate) unsafe fn __rust_thunk___Z3foo7Trivial(t: crate::Trivial) -> crate::Trivial;
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" struct Trivial __rust_thunk___Z3foo7Trivial(struct Trivial t) {
+                    return foo(std::move(t));
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_unpin_by_value_return_with_unreplicated_fields() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct Trivial final {
+              int bitfield : 3;
+            };
+
+            Trivial foo();
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
         assert_rs_matches!(
             rs_api,
             quote! {
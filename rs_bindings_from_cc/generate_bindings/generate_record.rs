@@ -5,7 +5,9 @@
 
 use crate::{BindingsGenerator, Database, GeneratedItem};
 
-use crate::rs_snippet::{should_derive_clone, should_derive_copy, RsTypeKind, TypeLocation};
+use crate::rs_snippet::{
+    should_derive_clone, should_derive_copy, PrimitiveType, RsTypeKind, TypeLocation,
+};
 use arc_anyhow::{Context, Result};
 use code_gen_utils::make_rs_ident;
 use error_report::{bail, ensure};
@@ -101,8 +103,8 @@ fn make_rs_field_ident(field: &Field, field_index: usize) -> Ident {
 /// of memory, of a size that can fill up space to the next field.
 ///
 /// See docs/struct_layout
-fn get_field_rs_type_kind_for_layout(
-    db: &Database,
+pub(crate) fn get_field_rs_type_kind_for_layout(
+    db: &dyn BindingsGenerator,
     record: &Record,
     field: &Field,
 ) -> Result<RsTypeKind> {
@@ -154,6 +156,35 @@ fn get_field_rs_type_kind_for_layout(
     Ok(type_kind)
 }
 
+/// Returns true if `record` has the same ABI in Rust as in C++ when passed by
+/// value, so that thunks can pass and return it by value (e.g. in registers, if
+/// its size and ABI class permit) rather than through pointers to temporaries.
+///
+/// This is the case for records that C++ passes like C structs (i.e. that are
+/// trivial for the purposes of calls, such as `[[clang::trivial_abi]]` types),
+/// if the Rust struct has exactly the same fields. A field that is replaced by
+/// a blob of bytes, or data before the first field (e.g. base classes), could
+/// change the ABI class of the struct.
+pub fn is_record_c_abi_compatible_by_value(db: &dyn BindingsGenerator, record: Rc<Record>) -> bool {
+    if !record.is_unpin()
+        || record.is_union()
+        || record.is_derived_class
+        || record.override_alignment
+        || record.bridge_type_info.is_some()
+    {
+        return false;
+    }
+    if record.fields.first().map_or(true, |field| field.offset != 0) {
+        return false;
+    }
+    record.fields.iter().all(|field| {
+        field.size != 0
+            && !field.is_bitfield
+            && get_field_rs_type_kind_for_layout(db, &record, field)
+                .is_ok_and(|type_kind| type_kind.is_c_abi_compatible_by_value(db))
+    })
+}
+
 /// Returns the type of a type-less, unaligned block of memory that can hold a
 /// specified number of bits, rounded up to the next multiple of 8.
 fn bit_padding(padding_size_in_bits: usize) -> TokenStream {
@@ -437,27 +468,22 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
         })
         .collect::<Result<Vec<_>>>()?;
 
-    let field_offset_assertions = fields_with_bounds
+    let field_offset_checks = fields_with_bounds
         .enumerate()
-        .map(|(field_index, (field, _, _, _))| {
-            if let Some(field) = field {
-                let field_ident = make_rs_field_ident(field, field_index);
-
-                // The assertion below reinforces that the division by 8 on the next line is
-                // justified (because the bitfields have been coallesced / filtered out
-                // earlier).
-                assert_eq!(field.offset % 8, 0);
-                let expected_offset = Literal::usize_unsuffixed(field.offset / 8);
-
-                let actual_offset_expr = quote! {
-                    ::core::mem::offset_of!(#qualified_ident, #field_ident)
-                };
-                quote! {
-                    assert!(#actual_offset_expr == #expected_offset);
-                }
-            } else {
-                quote! {}
-            }
+        .filter_map(|(field_index, (field, _, _, _))| {
+            let field = field?;
+            let field_ident = make_rs_field_ident(field, field_index);
+
+            // The assertion below reinforces that the division by 8 on the next line is
+            // justified (because the bitfields have been coallesced / filtered out
+            // earlier).
+            assert_eq!(field.offset % 8, 0);
+            let expected_offset = Literal::usize_unsuffixed(field.offset / 8);
+
+            let actual_offset_expr = quote! {
+                ::core::mem::offset_of!(#qualified_ident, #field_ident)
+            };
+            Some((actual_offset_expr, expected_offset))
         })
         .collect_vec();
     let mut features = BTreeSet::new();
@@ -576,6 +602,13 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
         } else {
             quote! {}
         };
+    let bitfield_accessors =
+        if crubit_features.contains(crubit_feature::CrubitFeature::Experimental) {
+            cc_struct_bitfield_accessors(db, record)?
+        } else {
+            quote! {}
+        };
+    let column_views = cc_struct_column_views(db, record)?;
     let incomplete_definition = if crubit_features
         .contains(crubit_feature::CrubitFeature::Experimental)
     {
@@ -588,8 +621,16 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
 
     let mut items = vec![];
     let mut thunks_from_record_items = vec![];
-    let mut thunk_impls_from_record_items = vec![cc_struct_layout_assertion(db, record)?];
+    let mut thunk_impls_from_record_items = vec![];
     let mut assertions_from_record_items = vec![];
+    let cc_layout_checks = cc_struct_layout_checks(db, record)?;
+    let mut cc_layout_rows = vec![];
+    if db.aggregate_layout_assertions() {
+        cc_layout_rows.push(cc_layout_table_rows(&cc_layout_checks));
+    } else {
+        thunk_impls_from_record_items.push(cc_layout_assertions(&cc_layout_checks));
+    }
+    let mut rs_layout_rows = vec![];
 
     for generated in record_generated_items {
         items.push(generated.item);
@@ -602,6 +643,8 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
         if !generated.thunk_impls.is_empty() {
             thunk_impls_from_record_items.push(generated.thunk_impls);
         }
+        rs_layout_rows.push(generated.rs_layout_checks);
+        cc_layout_rows.push(generated.cc_layout_checks);
         features.extend(generated.features.clone());
     }
 
@@ -623,6 +666,10 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
 
         #no_unique_address_accessors
 
+        #bitfield_accessors
+
+        #column_views
+
         __NEWLINE__ __NEWLINE__
         #( #items __NEWLINE__ __NEWLINE__)*
     };
@@ -656,11 +703,18 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
         add_conditional_assertion(should_implement_drop(record), quote! { Drop });
         assertions
     };
-    let size_align_assertions = rs_size_align_assertions(qualified_ident, &record.size_align);
+    let size_align_checks = rs_size_align_checks(&qualified_ident, &record.size_align);
+    let (size_align_assertions, field_offset_assertions) = if db.aggregate_layout_assertions() {
+        rs_layout_rows.insert(0, rs_layout_table_rows(&qualified_ident, &size_align_checks));
+        rs_layout_rows.insert(1, rs_layout_table_rows(&qualified_ident, &field_offset_checks));
+        (quote! {}, quote! {})
+    } else {
+        (rs_layout_assertions(&size_align_checks), rs_layout_assertions(&field_offset_checks))
+    };
     let assertion_tokens = quote! {
         #size_align_assertions
         #( #record_trait_assertions )*
-        #( #field_offset_assertions )*
+        #field_offset_assertions
         #( #field_copy_trait_assertions )*
         #( #assertions_from_record_items )*
     };
@@ -675,23 +729,70 @@ pub fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedIt
         assertions: assertion_tokens,
         thunks: thunk_tokens,
         thunk_impls: quote! {#(#thunk_impls_from_record_items __NEWLINE__ __NEWLINE__)*},
+        rs_layout_checks: quote! { #( #rs_layout_rows )* },
+        cc_layout_checks: quote! { #( #cc_layout_rows )* },
         ..Default::default()
     })
 }
 
+/// Pairs of an expression that computes a property of the layout of a type
+/// (its size, alignment or the offset of one of its fields), and the value
+/// which that property had when the bindings were generated.
+type LayoutChecks = Vec<(TokenStream, Literal)>;
+
+fn rs_size_align_checks(type_name: impl ToTokens, size_align: &ir::SizeAlign) -> LayoutChecks {
+    let type_name = type_name.into_token_stream();
+    let size = Literal::usize_unsuffixed(size_align.size);
+    let alignment = Literal::usize_unsuffixed(size_align.alignment);
+    vec![
+        (quote! { ::core::mem::size_of::<#type_name>() }, size),
+        (quote! { ::core::mem::align_of::<#type_name>() }, alignment),
+    ]
+}
+
+/// Returns the assertions that `type_name` has the size and alignment in
+/// `size_align`, or, if `db.aggregate_layout_assertions()`, the rows for
+/// `GeneratedItem::rs_layout_checks` that verify the same.
 pub fn rs_size_align_assertions(
+    db: &Database,
     type_name: impl ToTokens,
     size_align: &ir::SizeAlign,
-) -> TokenStream {
+) -> GeneratedItem {
     let type_name = type_name.into_token_stream();
-    let size = Literal::usize_unsuffixed(size_align.size);
-    let alignment = Literal::usize_unsuffixed(size_align.alignment);
-    quote! {
-        assert!(::core::mem::size_of::<#type_name>() == #size);
-        assert!(::core::mem::align_of::<#type_name>() == #alignment);
+    let checks = rs_size_align_checks(&type_name, size_align);
+    if db.aggregate_layout_assertions() {
+        GeneratedItem {
+            rs_layout_checks: rs_layout_table_rows(&type_name, &checks),
+            ..Default::default()
+        }
+    } else {
+        GeneratedItem { assertions: rs_layout_assertions(&checks), ..Default::default() }
     }
 }
 
+fn rs_layout_assertions(checks: &LayoutChecks) -> TokenStream {
+    let (actual, expected): (Vec<_>, Vec<_>) = checks.iter().cloned().unzip();
+    quote! { #( assert!(#actual == #expected); )* }
+}
+
+/// Returns the rows of the Rust layout table for `checks`. The last element of
+/// each row is the name of `type_name`, for the message of the assertion.
+fn rs_layout_table_rows(type_name: &TokenStream, checks: &LayoutChecks) -> TokenStream {
+    let type_name = Literal::string(&type_name.to_string().replace(' ', ""));
+    let (actual, expected): (Vec<_>, Vec<_>) = checks.iter().cloned().unzip();
+    quote! { #( (#actual, #expected, #type_name), )* }
+}
+
+fn cc_layout_assertions(checks: &LayoutChecks) -> TokenStream {
+    let (actual, expected): (Vec<_>, Vec<_>) = checks.iter().cloned().unzip();
+    quote! { #( static_assert(#actual == #expected); )* }
+}
+
+fn cc_layout_table_rows(checks: &LayoutChecks) -> TokenStream {
+    let (actual, expected): (Vec<_>, Vec<_>) = checks.iter().cloned().unzip();
+    quote! { #( { #actual, #expected }, )* }
+}
+
 fn generate_derives(record: &Record) -> Vec<Ident> {
     let mut derives = vec![];
     if should_derive_clone(record) {
@@ -703,11 +804,11 @@ fn generate_derives(record: &Record) -> Vec<Ident> {
     derives
 }
 
-fn cc_struct_layout_assertion(db: &Database, record: &Record) -> Result<TokenStream> {
+fn cc_struct_layout_checks(db: &Database, record: &Record) -> Result<LayoutChecks> {
     let record_ident = crate::format_cc_ident(record.cc_name.as_ref());
     let namespace_qualifier = db.ir().namespace_qualifier(record)?.format_for_cc()?;
     let tag_kind = crate::cc_tag_kind(record);
-    let field_assertions = record
+    let field_checks = record
         .fields
         .iter()
         .filter(|f| f.access == AccessSpecifier::Public && f.identifier.is_some())
@@ -729,7 +830,7 @@ fn cc_struct_layout_assertion(db: &Database, record: &Record) -> Result<TokenStr
                 CRUBIT_OFFSET_OF(#field_ident, #tag_kind #namespace_qualifier #record_ident)
             };
 
-            quote! { static_assert( #actual_offset == #expected_offset); }
+            (actual_offset, expected_offset)
         });
     // only use CRUBIT_SIZEOF for alignment > 1, so as to simplify the generated
     // code.
@@ -740,19 +841,25 @@ fn cc_struct_layout_assertion(db: &Database, record: &Record) -> Result<TokenStr
     } else {
         quote! {CRUBIT_SIZEOF}
     };
-    Ok(quote! {
-        static_assert(#sizeof(#tag_kind #namespace_qualifier #record_ident) == #size);
-        static_assert(alignof(#tag_kind #namespace_qualifier #record_ident) == #alignment);
-        #( #field_assertions )*
-    })
+    let mut checks = vec![
+        (quote! { #sizeof(#tag_kind #namespace_qualifier #record_ident) }, size),
+        (quote! { alignof(#tag_kind #namespace_qualifier #record_ident) }, alignment),
+    ];
+    checks.extend(field_checks);
+    Ok(checks)
 }
 
 /// Returns the accessor functions for no_unique_address member variables.
+///
+/// Fields of (non-const) primitive types also get a setter, so that they can be
+/// assigned from Rust without calling into C++.
 fn cc_struct_no_unique_address_impl(db: &Database, record: &Record) -> Result<TokenStream> {
+    let ir = db.ir();
     let mut fields = vec![];
     let mut types = vec![];
     let mut field_offsets = vec![];
     let mut doc_comments = vec![];
+    let mut setters = vec![];
     for field in &record.fields {
         if field.access != AccessSpecifier::Public || !field.is_no_unique_address {
             continue;
@@ -765,19 +872,53 @@ fn cc_struct_no_unique_address_impl(db: &Database, record: &Record) -> Result<To
         // Can't use `get_field_rs_type_kind_for_layout` here, because we want to dig
         // into no_unique_address fields, despite laying them out as opaque
         // blobs of bytes.
-        if let Ok(rs_type) = field.type_.as_ref().map(|t| t.rs_type.clone()) {
-            fields.push(make_rs_ident(
-                &field
-                    .identifier
-                    .as_ref()
-                    .expect("Unnamed fields can't be annotated with [[no_unique_address]]")
-                    .identifier,
-            ));
+        if let Ok(mapped_type) = field.type_.as_ref() {
+            let rs_type = mapped_type.rs_type.clone();
+            let field_name = &field
+                .identifier
+                .as_ref()
+                .expect("Unnamed fields can't be annotated with [[no_unique_address]]")
+                .identifier;
+            fields.push(make_rs_ident(field_name));
             let type_ident = db.rs_type_kind(rs_type).with_context(|| {
                 format!("Failed to format type for field {:?} on record {:?}", field, record)
             })?;
+            let field_offset = Literal::usize_unsuffixed(field.offset / 8);
+            // Primitive types have no padding and no destructor, so storing one can't
+            // clobber the other fields that a potentially-overlapping subobject
+            // overlaps with (which could happen for its tail padding), and doesn't
+            // need to destroy the old value. Const fields must not be modified, so
+            // they get no setter.
+            let setter_name = format!("set_{field_name}");
+            let has_method_named_like_setter = ir.functions().any(|func| {
+                func.member_func_metadata.as_ref().map(|meta| meta.record_id) == Some(record.id)
+                    && matches!(&func.name, UnqualifiedIdentifier::Identifier(id)
+                        if id.identifier.as_ref() == setter_name)
+            });
+            if type_ident.is_primitive()
+                && !mapped_type.cpp_type.is_const
+                && !has_method_named_like_setter
+            {
+                let setter_ident = make_rs_ident(&setter_name);
+                let (self_param, self_ptr) = if record.is_unpin() {
+                    (quote! { &mut self }, quote! { self as *mut Self })
+                } else {
+                    (
+                        quote! { self: ::core::pin::Pin<&mut Self> },
+                        quote! { self.get_unchecked_mut() as *mut Self },
+                    )
+                };
+                setters.push(quote! {
+                    pub fn #setter_ident(#self_param, value: #type_ident) {
+                        unsafe {
+                            let ptr = (#self_ptr as *mut u8).offset(#field_offset);
+                            *(ptr as *mut #type_ident) = value;
+                        }
+                    }
+                });
+            }
             types.push(type_ident);
-            field_offsets.push(Literal::usize_unsuffixed(field.offset / 8));
+            field_offsets.push(field_offset);
             if field.size == 0 {
                 // These fields are not generated at all, so they need to be documented here.
                 doc_comments.push(crate::generate_doc_comment(
@@ -824,6 +965,250 @@ fn cc_struct_no_unique_address_impl(db: &Database, record: &Record) -> Result<To
                     }
                 }
             )*
+            #( #setters )*
+        }
+    })
+}
+
+/// Returns getters and setters for the named bitfields of primitive types.
+///
+/// The accessors load and store the bytes that a bitfield spans, and extract
+/// or insert its bits with constant shifts and masks, so that reading a packed
+/// field doesn't call into C++ or copy the whole object. They assume the
+/// Itanium bitfield layout on little-endian targets, where bitfields are
+/// allocated from the least significant bit of their storage, and so they are
+/// only defined on little-endian targets.
+///
+/// Whole bytes are read, so a bitfield only gets accessors if every bit of the
+/// bytes that it spans belongs to a named bitfield: padding and unnamed
+/// bitfields may be uninitialized.
+fn cc_struct_bitfield_accessors(db: &Database, record: &Record) -> Result<TokenStream> {
+    let ir = db.ir();
+    let bitfields = record
+        .fields
+        .iter()
+        .filter(|field| field.is_bitfield && field.size != 0 && field.identifier.is_some())
+        .collect::<Vec<_>>();
+    if bitfields.is_empty() {
+        return Ok(quote! {});
+    }
+    let mut is_named_bitfield_bit = vec![false; record.size_align.size * 8];
+    for field in &bitfields {
+        is_named_bitfield_bit[field.offset..field.offset + field.size].fill(true);
+    }
+    let has_method_named = |name: &str| {
+        ir.functions().any(|func| {
+            func.member_func_metadata.as_ref().map(|meta| meta.record_id) == Some(record.id)
+                && matches!(&func.name, UnqualifiedIdentifier::Identifier(id)
+                    if id.identifier.as_ref() == name)
+        })
+    };
+    let (self_param, self_ptr) = if record.is_unpin() {
+        (quote! { &mut self }, quote! { self as *mut Self })
+    } else {
+        (
+            quote! { self: ::core::pin::Pin<&mut Self> },
+            quote! { self.get_unchecked_mut() as *mut Self },
+        )
+    };
+
+    let mut accessors = vec![];
+    for field in bitfields {
+        if field.access != AccessSpecifier::Public {
+            continue;
+        }
+        let Ok(mapped_type) = &field.type_ else { continue };
+        let type_kind = db.rs_type_kind(mapped_type.rs_type.clone())?;
+        let mut underlying_type_kind = &type_kind;
+        while let RsTypeKind::TypeAlias { underlying_type, .. } = underlying_type_kind {
+            underlying_type_kind = underlying_type;
+        }
+        let is_bool = match underlying_type_kind {
+            RsTypeKind::Primitive(PrimitiveType::bool) => true,
+            RsTypeKind::Primitive(
+                PrimitiveType::Unit | PrimitiveType::f32 | PrimitiveType::f64,
+            ) => continue,
+            RsTypeKind::Primitive(_) => false,
+            _ => continue,
+        };
+        let first_byte = field.offset / 8;
+        let shift = field.offset % 8;
+        let num_bytes = (shift + field.size + 7) / 8;
+        if !is_named_bitfield_bit[first_byte * 8..(first_byte + num_bytes) * 8]
+            .iter()
+            .all(|is_named| *is_named)
+        {
+            continue;
+        }
+        let field_name = &field.identifier.as_ref().unwrap().identifier;
+        let setter_name = format!("set_{field_name}");
+        if has_method_named(field_name) || has_method_named(&setter_name) {
+            continue;
+        }
+
+        // The bytes are loaded into the low bytes of a `u64` (or `u128`, for a
+        // 64-bit field that doesn't start on a byte boundary).
+        let (storage_bits, storage, signed_storage) = if num_bytes <= 8 {
+            (64, quote! { u64 }, quote! { i64 })
+        } else {
+            (128, quote! { u128 }, quote! { i128 })
+        };
+        let getter_ident = make_rs_ident(field_name);
+        let setter_ident = make_rs_ident(&setter_name);
+        let type_tokens = type_kind.to_token_stream();
+        let offset = Literal::usize_unsuffixed(first_byte);
+        let len = Literal::usize_unsuffixed(num_bytes);
+        let storage_len = Literal::usize_unsuffixed(storage_bits / 8);
+        // Shifting the field to the top of the storage, and then back down
+        // (arithmetically, for signed types), extracts and sign-extends it.
+        let shl = Literal::usize_unsuffixed(storage_bits - shift - field.size);
+        let shr = Literal::usize_unsuffixed(storage_bits - field.size);
+        let mask = (u128::MAX >> (128 - field.size)) << shift;
+        let shifted_value = if shift == 0 {
+            quote! { (value as #storage) }
+        } else {
+            let shift = Literal::usize_unsuffixed(shift);
+            quote! { ((value as #storage) << #shift) }
+        };
+        let mask = if storage_bits == 64 {
+            Literal::u64_suffixed(mask as u64)
+        } else {
+            Literal::u128_suffixed(mask)
+        };
+        let value = if is_bool {
+            quote! { (bits >> #shr) != 0 }
+        } else {
+            quote! {
+                if <#type_tokens>::MIN == 0 {
+                    (bits >> #shr) as #type_tokens
+                } else {
+                    ((bits as #signed_storage) >> #shr) as #type_tokens
+                }
+            }
+        };
+        let doc_comment = crate::generate_doc_comment(
+            field.doc_comment.as_deref(),
+            None,
+            db.generate_source_loc_doc_comment(),
+        );
+        accessors.push(quote! {
+            #doc_comment
+            #[inline(always)]
+            pub fn #getter_ident(&self) -> #type_tokens {
+                unsafe {
+                    let ptr = (self as *const Self as *const u8).offset(#offset);
+                    let mut bytes = [0u8; #storage_len];
+                    ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), #len);
+                    let bits = #storage::from_le_bytes(bytes) << #shl;
+                    #value
+                }
+            }
+            #[inline(always)]
+            pub fn #setter_ident(#self_param, value: #type_tokens) {
+                unsafe {
+                    let ptr = (#self_ptr as *mut u8).offset(#offset);
+                    let mut bytes = [0u8; #storage_len];
+                    ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), #len);
+                    let bits = (#storage::from_le_bytes(bytes) & !#mask)
+                        | (#shifted_value & #mask);
+                    ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, #len);
+                }
+            }
+        });
+    }
+    if accessors.is_empty() {
+        return Ok(quote! {});
+    }
+    let ident = make_rs_ident(record.rs_name.as_ref());
+    Ok(quote! {
+        #[cfg(target_endian = "little")]
+        impl #ident {
+            #( #accessors )*
+        }
+    })
+}
+
+/// Returns column views of the public fields of primitive types, for records
+/// annotated with `CRUBIT_INTERNAL_COLUMN_VIEW`.
+///
+/// `<field>_column` iterates over the field across a slice of records, by
+/// value, and `<field>_column_mut` (for `Unpin` records) by mutable reference.
+/// These are plain field accesses with a constant stride, so scans over a
+/// `cc_std::Vector` of records can be vectorized by the Rust compiler.
+fn cc_struct_column_views(db: &Database, record: &Record) -> Result<TokenStream> {
+    if !record.has_column_view_attribute || record.is_union() {
+        return Ok(quote! {});
+    }
+    let ir = db.ir();
+    let has_method_named = |name: &str| {
+        ir.functions().any(|func| {
+            func.member_func_metadata.as_ref().map(|meta| meta.record_id) == Some(record.id)
+                && matches!(&func.name, UnqualifiedIdentifier::Identifier(id)
+                    if id.identifier.as_ref() == name)
+        })
+    };
+
+    let mut views = vec![];
+    for (field_index, field) in record.fields.iter().enumerate() {
+        if field.access != AccessSpecifier::Public || field.is_bitfield {
+            continue;
+        }
+        let Some(Identifier { identifier: field_name }) = &field.identifier else { continue };
+        let Ok(type_kind) = get_field_rs_type_kind_for_layout(db, record, field) else {
+            continue;
+        };
+        let mut underlying_type_kind = &type_kind;
+        while let RsTypeKind::TypeAlias { underlying_type, .. } = underlying_type_kind {
+            underlying_type_kind = underlying_type;
+        }
+        if !matches!(underlying_type_kind, RsTypeKind::Primitive(primitive)
+            if *primitive != PrimitiveType::Unit)
+        {
+            continue;
+        }
+        let column_name = format!("{field_name}_column");
+        let column_mut_name = format!("{field_name}_column_mut");
+        if has_method_named(&column_name) || has_method_named(&column_mut_name) {
+            continue;
+        }
+
+        let field_ident = make_rs_field_ident(field, field_index);
+        let column_ident = make_rs_ident(&column_name);
+        let type_tokens = type_kind.to_token_stream();
+        let doc_comment = format!(" Returns the `{field_name}` field of each of `records`.");
+        views.push(quote! {
+            #[doc = #doc_comment]
+            #[inline(always)]
+            pub fn #column_ident(
+                records: &[Self],
+            ) -> impl ::core::iter::DoubleEndedIterator<Item = #type_tokens>
+                   + ::core::iter::ExactSizeIterator
+                   + '_ {
+                records.iter().map(|record| record.#field_ident)
+            }
+        });
+        if record.is_unpin() {
+            let column_mut_ident = make_rs_ident(&column_mut_name);
+            views.push(quote! {
+                #[doc = #doc_comment]
+                #[inline(always)]
+                pub fn #column_mut_ident(
+                    records: &mut [Self],
+                ) -> impl ::core::iter::DoubleEndedIterator<Item = &mut #type_tokens>
+                       + ::core::iter::ExactSizeIterator
+                       + '_ {
+                    records.iter_mut().map(|record| &mut record.#field_ident)
+                }
+            });
+        }
+    }
+    if views.is_empty() {
+        return Ok(quote! {});
+    }
+    let ident = make_rs_ident(record.rs_name.as_ref());
+    Ok(quote! {
+        impl #ident {
+            #( #views )*
         }
     })
 }
@@ -841,9 +1226,20 @@ fn cc_struct_upcast_impl(db: &Database, record: &Rc<Record>, ir: &IR) -> Result<
         let base_name = RsTypeKind::new_record(db, base_record.clone(), ir)?.into_token_stream();
         let derived_name = RsTypeKind::new_record(db, record.clone(), ir)?.into_token_stream();
         let body;
+        let mut inline_attr = quote! {};
+        let mut offset_impl = quote! {};
         if let Some(offset) = base.offset {
             let offset = Literal::i64_unsuffixed(offset);
             body = quote! {(derived as *const _ as *const u8).offset(#offset) as *const #base_name};
+            // The offset is a constant, so inlining reduces the upcast to pointer
+            // arithmetic at the call site (which is usually in another crate).
+            inline_attr = quote! { #[inline(always)] };
+            // The same constant makes static downcasts pointer arithmetic, too.
+            offset_impl = quote! {
+                unsafe impl oops::InheritsNonVirtually<#base_name> for #derived_name {
+                    const BASE_OFFSET: isize = #offset;
+                }
+            };
         } else {
             let cast_fn_name = make_rs_ident(&format!(
                 "__crubit_dynamic_upcast__{derived}__to__{base}_{odr_suffix}",
@@ -868,10 +1264,12 @@ fn cc_struct_upcast_impl(db: &Database, record: &Rc<Record>, ir: &IR) -> Result<
         }
         impls.push(quote! {
             unsafe impl oops::Inherits<#base_name> for #derived_name {
+                #inline_attr
                 unsafe fn upcast_ptr(derived: *const Self) -> *const #base_name {
                     #body
                 }
             }
+            #offset_impl
         });
     }
 
@@ -891,7 +1289,9 @@ mod tests {
     use arc_anyhow::Result;
     use googletest::prelude::*;
     use ir_testing::with_lifetime_macros;
-    use token_stream_matchers::{assert_cc_matches, assert_rs_matches, assert_rs_not_matches};
+    use token_stream_matchers::{
+        assert_cc_matches, assert_cc_not_matches, assert_rs_matches, assert_rs_not_matches,
+    };
 
     #[gtest]
     fn test_template_in_dependency_and_alias_in_current_target() -> Result<()> {
@@ -1075,7 +1475,7 @@ mod tests {
             rs_api_impl,
             quote! {
                 extern "C" void __rust_thunk___ZN10SomeStructD1Ev(struct SomeStruct * __this) {
-                    std::destroy_at(__this);
+                    crubit::DtorThunk(__this);
                 }
             }
         );
@@ -1264,6 +1664,152 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_bitfield_accessors() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                struct Header final {
+                  unsigned version : 4;
+                  int delta : 9;
+                  unsigned flags : 3;
+                  bool urgent : 1;
+                  unsigned char length : 7;
+                };
+            "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[cfg(target_endian = "little")]
+                impl Header {
+                    #[inline(always)]
+                    pub fn version(&self) -> ::core::ffi::c_uint { ... }
+                    ...
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn delta(&self) -> ::core::ffi::c_int {
+                    unsafe {
+                        let ptr = (self as *const Self as *const u8).offset(0);
+                        let mut bytes = [0u8; 8];
+                        ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 2);
+                        let bits = u64::from_le_bytes(bytes) << 51;
+                        if <::core::ffi::c_int>::MIN == 0 {
+                            (bits >> 55) as ::core::ffi::c_int
+                        } else {
+                            ((bits as i64) >> 55) as ::core::ffi::c_int
+                        }
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn set_delta(&mut self, value: ::core::ffi::c_int) {
+                    unsafe {
+                        let ptr = (self as *mut Self as *mut u8).offset(0);
+                        let mut bytes = [0u8; 8];
+                        ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 2);
+                        let bits = (u64::from_le_bytes(bytes) & !8176u64)
+                            | (((value as u64) << 4) & 8176u64);
+                        ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 2);
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! { pub fn urgent(&self) -> bool { ... (bits >> 63) != 0 ... } }
+        );
+        assert_rs_matches!(rs_api, quote! { pub fn set_length(&mut self, value: u8) });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_bitfield_accessors_require_initialized_bytes() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                struct S final {
+                  int full_byte : 8;
+                  int partial_byte : 4;
+                  int : 4;
+                  int padded : 4;
+                  float f;
+                };
+            "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(rs_api, quote! { pub fn full_byte(&self) });
+        // These share their bytes with an unnamed bitfield or with padding, which
+        // may be uninitialized.
+        assert_rs_not_matches!(rs_api, quote! { pub fn partial_byte(&self) });
+        assert_rs_not_matches!(rs_api, quote! { pub fn padded(&self) });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_column_views() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                struct Empty final {};
+                struct [[clang::annotate("crubit_internal_column_view")]] Particle final {
+                  float x;
+                  double mass;
+                  Empty tag;
+                  int charge : 8;
+                 private:
+                  int id;
+                };
+            "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Particle {
+                    #[doc = " Returns the `x` field of each of `records`."]
+                    #[inline(always)]
+                    pub fn x_column(
+                        records: &[Self],
+                    ) -> impl ::core::iter::DoubleEndedIterator<Item = f32>
+                           + ::core::iter::ExactSizeIterator
+                           + '_ {
+                        records.iter().map(|record| record.x)
+                    }
+                    #[doc = " Returns the `x` field of each of `records`."]
+                    #[inline(always)]
+                    pub fn x_column_mut(
+                        records: &mut [Self],
+                    ) -> impl ::core::iter::DoubleEndedIterator<Item = &mut f32>
+                           + ::core::iter::ExactSizeIterator
+                           + '_ {
+                        records.iter_mut().map(|record| &mut record.x)
+                    }
+                    ...
+                }
+            }
+        );
+        assert_rs_matches!(rs_api, quote! { pub fn mass_column(records: &[Self]) });
+        // Only primitive, public, non-bitfield fields have column views.
+        assert_rs_not_matches!(rs_api, quote! { pub fn tag_column });
+        assert_rs_not_matches!(rs_api, quote! { pub fn charge_column });
+        assert_rs_not_matches!(rs_api, quote! { pub fn id_column });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_column_views_require_attribute() -> Result<()> {
+        let ir = ir_from_cc("struct Point final { float x; float y; };")?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_not_matches!(rs_api, quote! { pub fn x_column });
+        Ok(())
+    }
+
     #[gtest]
     fn test_struct_with_unnamed_bitfield_member() -> Result<()> {
         // This test input causes `field_decl->getName()` to return an empty string.
@@ -1821,6 +2367,74 @@ mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_no_unique_address_primitive_field_setter() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+            struct Struct final {
+                [[no_unique_address]] int x;
+            };
+            struct Nontrivial final {
+                ~Nontrivial();
+                [[no_unique_address]] int x;
+                char y;
+            };
+        "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Struct {
+                    pub fn x(&self) -> &::core::ffi::c_int { ... }
+                    pub fn set_x(&mut self, value: ::core::ffi::c_int) {
+                        unsafe {
+                            let ptr = (self as *mut Self as *mut u8).offset(0);
+                            *(ptr as *mut ::core::ffi::c_int) = value;
+                        }
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Nontrivial {
+                    pub fn x(&self) -> &::core::ffi::c_int { ... }
+                    pub fn set_x(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+                        unsafe {
+                            let ptr = (self.get_unchecked_mut() as *mut Self as *mut u8).offset(0);
+                            *(ptr as *mut ::core::ffi::c_int) = value;
+                        }
+                    }
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_no_unique_address_const_primitive_field_has_no_setter() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+            struct Struct final {
+                [[no_unique_address]] const int x;
+            };
+        "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Struct {
+                    pub fn x(&self) -> &::core::ffi::c_int { ... }
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { fn set_x });
+        Ok(())
+    }
+
     #[gtest]
     fn test_base_class_subobject_empty_last_field() -> Result<()> {
         let ir = ir_from_cc(
@@ -2272,6 +2886,29 @@ mod tests {
             rs_api,
             quote! { unsafe impl oops::Inherits<crate::UnambiguousPublicBase> for crate::Derived }
         );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                unsafe impl oops::Inherits<crate::AmbiguousPublicBase> for crate::MultipleInheritance {
+                    #[inline(always)]
+                    unsafe fn upcast_ptr(derived: *const Self) -> *const crate::AmbiguousPublicBase {
+                        (derived as *const _ as *const u8).offset(0) as *const crate::AmbiguousPublicBase
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                unsafe impl oops::InheritsNonVirtually<crate::AmbiguousPublicBase> for crate::MultipleInheritance {
+                    const BASE_OFFSET: isize = 0;
+                }
+            }
+        );
+        assert_rs_not_matches!(
+            rs_api,
+            quote! { unsafe impl oops::InheritsNonVirtually<crate::VirtualBase> for crate::Derived }
+        );
         assert_rs_matches!(
             rs_api,
             quote! { unsafe impl oops::Inherits<crate::MultipleInheritance> for crate::Derived }
@@ -2334,6 +2971,24 @@ mod tests {
         Ok(())
     }
 
+    /// Virtual methods of `final` classes (and `final` virtual methods) have no
+    /// override to dispatch to, so the generated bindings call them directly.
+    #[gtest]
+    fn test_final_virtual_no_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"struct FinalClass final { virtual void Foo(); };
+               struct Base { virtual void Bar(); };
+               struct FinalMethod : Base { void Bar() final; };"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(rs_api, quote! { #[link_name = "_ZN10FinalClass3FooEv"] });
+        assert_rs_matches!(rs_api, quote! { #[link_name = "_ZN11FinalMethod3BarEv"] });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZN10FinalClass3FooEv });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZN11FinalMethod3BarEv });
+        assert_cc_matches!(rs_api_impl, quote! { __rust_thunk___ZN4Base3BarEv });
+        Ok(())
+    }
+
     /// A trivially relocatable final struct is safe to use in Rust as normal,
     /// and is Unpin.
     #[gtest]
@@ -0,0 +1,368 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! A profile of the Rust side of bindings generation: the wall time of each
+//! phase, the number of items of each kind and the time spent generating
+//! them, and the number of computations of some memoized queries and the time
+//! spent in them. The C++ side merges it into the report written to
+//! `--timing_report_out` (see `timing_report.h`).
+//!
+//! Optionally, the profile also records the cost of each item: the time spent
+//! generating it and the size of its bindings, which are written to
+//! `--cost_report_out`.
+
+use ir::{GenericItem, Item, IR};
+use std::cell::{Cell, RefCell};
+use std::collections::BTreeMap;
+use std::time::{Duration, Instant, SystemTime};
+
+#[derive(Debug)]
+pub struct GenerationProfile {
+    enabled: bool,
+    phases: RefCell<Vec<Phase>>,
+    item_kinds: RefCell<BTreeMap<&'static str, ItemKindProfile>>,
+    /// The time spent in nested `time_item` calls of the innermost running
+    /// `time_item`, which is subtracted from its own time.
+    nested_item_time: Cell<Duration>,
+    queries: RefCell<BTreeMap<&'static str, QueryProfile>>,
+    /// Like `nested_item_time`, for `time_query`.
+    nested_query_time: Cell<Duration>,
+    record_item_costs: bool,
+    item_costs: RefCell<Vec<ItemCost>>,
+    /// Like `nested_item_time`, for the output of nested `time_item` calls.
+    nested_item_output: Cell<ItemOutputSize>,
+}
+
+#[derive(Debug)]
+struct Phase {
+    name: &'static str,
+    start: SystemTime,
+    wall_time: Duration,
+}
+
+#[derive(Debug, Default)]
+struct ItemKindProfile {
+    count: u64,
+    generation_time: Duration,
+}
+
+/// The size of the bindings generated for an item.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct ItemOutputSize {
+    /// The length of the generated Rust tokens, before formatting.
+    pub rs_bytes: u64,
+    /// The length of the generated C++ tokens, before formatting.
+    pub cc_bytes: u64,
+    pub thunks: u64,
+}
+
+impl ItemOutputSize {
+    fn saturating_sub(self, other: Self) -> Self {
+        Self {
+            rs_bytes: self.rs_bytes.saturating_sub(other.rs_bytes),
+            cc_bytes: self.cc_bytes.saturating_sub(other.cc_bytes),
+            thunks: self.thunks.saturating_sub(other.thunks),
+        }
+    }
+
+    fn add(self, other: Self) -> Self {
+        Self {
+            rs_bytes: self.rs_bytes + other.rs_bytes,
+            cc_bytes: self.cc_bytes + other.cc_bytes,
+            thunks: self.thunks + other.thunks,
+        }
+    }
+}
+
+#[derive(Debug)]
+struct ItemCost {
+    kind: &'static str,
+    name: String,
+    source_loc: Option<String>,
+    generation_time: Duration,
+    output: ItemOutputSize,
+}
+
+#[derive(Debug, Default)]
+struct QueryProfile {
+    /// The number of times the query was computed, i.e. cache misses.
+    count: u64,
+    computation_time: Duration,
+}
+
+impl GenerationProfile {
+    /// Creates a profile. If `enabled` is false, nothing is measured.
+    pub fn new(enabled: bool) -> Self {
+        Self {
+            enabled,
+            phases: RefCell::default(),
+            item_kinds: RefCell::default(),
+            nested_item_time: Cell::default(),
+            queries: RefCell::default(),
+            nested_query_time: Cell::default(),
+            record_item_costs: false,
+            item_costs: RefCell::default(),
+            nested_item_output: Cell::default(),
+        }
+    }
+
+    /// Makes `time_item` also record the cost of each item, even if the rest
+    /// of the profile is disabled.
+    pub fn with_item_costs(self) -> Self {
+        Self { record_item_costs: true, ..self }
+    }
+
+    /// Runs `f` as the phase `name`.
+    pub fn time_phase<T>(&self, name: &'static str, f: impl FnOnce() -> T) -> T {
+        if !self.enabled {
+            return f();
+        }
+        let start = SystemTime::now();
+        let start_instant = Instant::now();
+        let result = f();
+        self.phases.borrow_mut().push(Phase { name, start, wall_time: start_instant.elapsed() });
+        result
+    }
+
+    /// Runs `f`, which generates bindings for `item`. Items generated by
+    /// nested calls (e.g. the members of a namespace) are only accounted to
+    /// their own kind. If item costs are recorded, `output_size` measures the
+    /// result of `f`, which includes the output of the nested calls.
+    pub fn time_item<T>(
+        &self,
+        ir: &IR,
+        item: &Item,
+        f: impl FnOnce() -> T,
+        output_size: impl FnOnce(&T) -> ItemOutputSize,
+    ) -> T {
+        if !self.enabled && !self.record_item_costs {
+            return f();
+        }
+        let outer_nested_item_time = self.nested_item_time.replace(Duration::ZERO);
+        let outer_nested_item_output = self.nested_item_output.take();
+        let start = Instant::now();
+        let result = f();
+        let elapsed = start.elapsed();
+        let own_time = elapsed.saturating_sub(self.nested_item_time.get());
+        self.nested_item_time.set(outer_nested_item_time + elapsed);
+
+        if self.enabled {
+            let mut item_kinds = self.item_kinds.borrow_mut();
+            let item_kind = item_kinds.entry(item_kind_name(item)).or_default();
+            item_kind.count += 1;
+            item_kind.generation_time += own_time;
+        }
+        if self.record_item_costs {
+            let output = output_size(&result);
+            let own_output = output.saturating_sub(self.nested_item_output.get());
+            self.nested_item_output.set(outer_nested_item_output.add(output));
+            self.item_costs.borrow_mut().push(ItemCost {
+                kind: item_kind_name(item),
+                name: item.debug_name(ir).to_string(),
+                source_loc: item.source_loc().map(|loc| loc.to_string()),
+                generation_time: own_time,
+                output: own_output,
+            });
+        }
+        result
+    }
+
+    /// Runs `f`, which computes the memoized query `name` (i.e. it is only
+    /// called on cache misses). The time spent in nested queries (e.g. for the
+    /// dependencies of an item) is only accounted to those.
+    pub fn time_query<T>(&self, name: &'static str, f: impl FnOnce() -> T) -> T {
+        if !self.enabled {
+            return f();
+        }
+        let outer_nested_query_time = self.nested_query_time.replace(Duration::ZERO);
+        let start = Instant::now();
+        let result = f();
+        let elapsed = start.elapsed();
+        let own_time = elapsed.saturating_sub(self.nested_query_time.get());
+        self.nested_query_time.set(outer_nested_query_time + elapsed);
+
+        let mut queries = self.queries.borrow_mut();
+        let query = queries.entry(name).or_default();
+        query.count += 1;
+        query.computation_time += own_time;
+        result
+    }
+
+    /// Returns the profile as JSON, with times in microseconds.
+    pub fn to_json(&self) -> String {
+        let phases = self
+            .phases
+            .borrow()
+            .iter()
+            .map(|phase| {
+                let start_unix_us = phase
+                    .start
+                    .duration_since(SystemTime::UNIX_EPOCH)
+                    .unwrap_or_default()
+                    .as_micros() as u64;
+                serde_json::json!({
+                    "name": phase.name,
+                    "start_unix_us": start_unix_us,
+                    "wall_us": phase.wall_time.as_micros() as u64,
+                })
+            })
+            .collect::<Vec<_>>();
+        let item_kinds = self
+            .item_kinds
+            .borrow()
+            .iter()
+            .map(|(kind, profile)| {
+                let profile = serde_json::json!({
+                    "count": profile.count,
+                    "generation_us": profile.generation_time.as_micros() as u64,
+                });
+                (kind.to_string(), profile)
+            })
+            .collect::<serde_json::Map<_, _>>();
+        let queries = self
+            .queries
+            .borrow()
+            .iter()
+            .map(|(name, profile)| {
+                let profile = serde_json::json!({
+                    "count": profile.count,
+                    "computation_us": profile.computation_time.as_micros() as u64,
+                });
+                (name.to_string(), profile)
+            })
+            .collect::<serde_json::Map<_, _>>();
+        serde_json::json!({ "phases": phases, "item_kinds": item_kinds, "queries": queries })
+            .to_string()
+    }
+
+    /// Returns the cost of each item as JSON, in the order in which the items
+    /// were generated, with times in microseconds.
+    pub fn item_costs_to_json(&self) -> String {
+        let items = self
+            .item_costs
+            .borrow()
+            .iter()
+            .map(|cost| {
+                let mut json = serde_json::json!({
+                    "kind": cost.kind,
+                    "name": cost.name,
+                    "generation_us": cost.generation_time.as_micros() as u64,
+                    "rs_bytes": cost.output.rs_bytes,
+                    "cc_bytes": cost.output.cc_bytes,
+                    "thunks": cost.output.thunks,
+                });
+                if let Some(source_loc) = &cost.source_loc {
+                    json["source_loc"] = source_loc.as_str().into();
+                }
+                json
+            })
+            .collect::<Vec<_>>();
+        serde_json::json!({ "items": items }).to_string()
+    }
+}
+
+fn item_kind_name(item: &Item) -> &'static str {
+    match item {
+        Item::Func(_) => "Func",
+        Item::IncompleteRecord(_) => "IncompleteRecord",
+        Item::Record(_) => "Record",
+        Item::Enum(_) => "Enum",
+        Item::TypeAlias(_) => "TypeAlias",
+        Item::UnsupportedItem(_) => "UnsupportedItem",
+        Item::Comment(_) => "Comment",
+        Item::Namespace(_) => "Namespace",
+        Item::UseMod(_) => "UseMod",
+        Item::TypeMapOverride(_) => "TypeMapOverride",
+        Item::Constant(_) => "Constant",
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use googletest::prelude::*;
+    use ir::{Comment, ItemId};
+    use ir_testing::make_ir_from_items;
+    use std::rc::Rc;
+
+    fn comment() -> Item {
+        Item::Comment(Rc::new(Comment { text: "comment".into(), id: ItemId::new_for_testing(1) }))
+    }
+
+    #[gtest]
+    fn test_disabled_profile_is_empty() {
+        let ir = make_ir_from_items([]);
+        let profile = GenerationProfile::new(false);
+        assert_eq!(profile.time_phase("phase", || 42), 42);
+        profile.time_item(&ir, &comment(), || {}, |_| ItemOutputSize::default());
+        profile.time_query("query", || {});
+        let json: serde_json::Value = serde_json::from_str(&profile.to_json()).unwrap();
+        assert_eq!(json, serde_json::json!({"phases": [], "item_kinds": {}, "queries": {}}));
+        let json: serde_json::Value = serde_json::from_str(&profile.item_costs_to_json()).unwrap();
+        assert_eq!(json, serde_json::json!({"items": []}));
+    }
+
+    #[gtest]
+    fn test_profile() {
+        let ir = make_ir_from_items([]);
+        let profile = GenerationProfile::new(true);
+        let no_output = |_: &()| ItemOutputSize::default();
+        profile.time_phase("phase", || {
+            profile.time_item(
+                &ir,
+                &comment(),
+                || profile.time_item(&ir, &comment(), || {}, no_output),
+                no_output,
+            );
+        });
+        let json: serde_json::Value = serde_json::from_str(&profile.to_json()).unwrap();
+        assert_eq!(json["phases"][0]["name"], "phase");
+        assert!(json["phases"][0]["start_unix_us"].as_u64().unwrap() > 0);
+        assert_eq!(json["item_kinds"]["Comment"]["count"], 2);
+    }
+
+    #[gtest]
+    fn test_query_profile() {
+        let profile = GenerationProfile::new(true);
+        profile.time_query("outer", || {
+            profile.time_query("inner", || {});
+            profile.time_query("inner", || {});
+        });
+        let json: serde_json::Value = serde_json::from_str(&profile.to_json()).unwrap();
+        assert_eq!(json["queries"]["outer"]["count"], 1);
+        assert_eq!(json["queries"]["inner"]["count"], 2);
+        assert!(json["queries"]["inner"]["computation_us"].is_u64());
+    }
+
+    #[gtest]
+    fn test_item_costs() {
+        let ir = make_ir_from_items([]);
+        let profile = GenerationProfile::new(false).with_item_costs();
+        let outer_output = ItemOutputSize { rs_bytes: 10, cc_bytes: 5, thunks: 2 };
+        let inner_output = ItemOutputSize { rs_bytes: 4, cc_bytes: 5, thunks: 1 };
+        profile.time_item(
+            &ir,
+            &comment(),
+            || profile.time_item(&ir, &comment(), || {}, |_| inner_output),
+            |_| outer_output,
+        );
+        let json: serde_json::Value = serde_json::from_str(&profile.item_costs_to_json()).unwrap();
+        let items = json["items"].as_array().unwrap();
+        assert_eq!(items.len(), 2);
+        // The nested item is recorded first, and is subtracted from the outer one.
+        assert_eq!(items[0]["kind"], "Comment");
+        assert_eq!(items[0]["name"], "comment");
+        assert_eq!(items[0]["rs_bytes"], 4);
+        assert_eq!(items[0]["cc_bytes"], 5);
+        assert_eq!(items[0]["thunks"], 1);
+        assert_eq!(items[1]["rs_bytes"], 6);
+        assert_eq!(items[1]["cc_bytes"], 0);
+        assert_eq!(items[1]["thunks"], 1);
+        assert!(items[1]["generation_us"].is_u64());
+        assert!(items[1].get("source_loc").is_none());
+        // Only the item costs are recorded.
+        let json: serde_json::Value = serde_json::from_str(&profile.to_json()).unwrap();
+        assert_eq!(json["item_kinds"], serde_json::json!({}));
+    }
+}
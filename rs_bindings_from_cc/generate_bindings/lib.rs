@@ -5,14 +5,18 @@
 
 mod generate_func;
 mod generate_record;
+mod generation_profile;
 mod rs_snippet;
 
+use bindings_cache::{BindingsCache, CacheKeyBuilder, CachedBindings};
 use generate_func::{
     generate_func, get_binding, is_record_clonable, overloaded_funcs, FunctionId, ImplKind,
 };
 use generate_record::{
     collect_unqualified_member_functions, generate_incomplete_record, generate_record,
+    is_record_c_abi_compatible_by_value,
 };
+use generation_profile::{GenerationProfile, ItemOutputSize};
 
 use crate::rs_snippet::{CratePath, Lifetime, Mutability, PrimitiveType, RsTypeKind, TypeLocation};
 use arc_anyhow::{Context, Error, Result};
@@ -21,7 +25,7 @@ use error_report::{anyhow, bail, ensure, ErrorReport, ErrorReporting, IgnoreErro
 use ffi_types::*;
 use ir::*;
 use itertools::Itertools;
-use proc_macro2::{Ident, Literal, TokenStream};
+use proc_macro2::{Delimiter, Ident, Literal, TokenStream, TokenTree};
 use quote::{quote, ToTokens};
 use std::collections::{BTreeSet, HashSet};
 use std::ffi::{OsStr, OsString};
@@ -31,7 +35,9 @@ use std::path::Path;
 use std::process;
 use std::rc::Rc;
 use token_stream_printer::{
-    cc_tokens_to_formatted_string, rs_tokens_to_formatted_string, RustfmtConfig,
+    cc_tokens_to_formatted_string, rs_and_cc_tokens_to_formatted_strings,
+    rs_tokens_to_formatted_string_in_chunks, tokens_to_api_hash, tokens_to_pretty_string,
+    RustfmtConfig,
 };
 
 /// FFI equivalent of `Bindings`.
@@ -40,42 +46,98 @@ pub struct FfiBindings {
     rs_api: FfiU8SliceBox,
     rs_api_impl: FfiU8SliceBox,
     error_report: FfiU8SliceBox,
+    timing_report: FfiU8SliceBox,
+    api_hash: FfiU8SliceBox,
+    cost_report: FfiU8SliceBox,
+    error: FfiU8SliceBox,
 }
 
-/// Deserializes IR from `json` and generates bindings source code.
+/// Deserializes IR from `ir` and generates bindings source code.
 ///
-/// This function panics on error.
+/// This function panics on error, except for failures to write the generated
+/// source code to `rs_out`, `cc_out` etc., which can be caused by the
+/// environment (e.g. a full disk) and are returned in the `error` of the
+/// returned value instead. `error` is empty on success.
 ///
 /// # Safety
 ///
 /// Expectations:
-///    * `json` should be a FfiU8Slice for a valid array of bytes with the given
-///      size.
+///    * `ir` should be a FfiU8Slice for a valid array of bytes with the given
+///      size, holding either the binary IR encoding or JSON.
 ///    * `crubit_support_path_format` should be a FfiU8Slice for a valid array
 ///      of bytes representing an UTF8-encoded string
 ///    * `rustfmt_exe_path` and `rustfmt_config_path` should both be a
 ///      FfiU8Slice for a valid array of bytes representing an UTF8-encoded
 ///      string (without the UTF-8 requirement, it seems that Rust doesn't offer
 ///      a way to convert to OsString on Windows)
-///    * `json`, `crubit_support_path_format`, `rustfmt_exe_path`, and
-///      `rustfmt_config_path` shouldn't change during the call.
+///    * `bindings_cache_dir` should be a FfiU8Slice for a valid array of bytes
+///      representing an UTF8-encoded string. If it is empty, the on-disk cache
+///      of generated bindings is disabled.
+///    * `rs_out` and `cc_out` should both be a FfiU8Slice for a valid array of
+///      bytes representing an UTF8-encoded string. If they are not empty, the
+///      generated Rust and C++ source code is written directly to the files at
+///      these paths, and `rs_api` and `rs_api_impl` of the returned value are
+///      empty. This avoids copying the (potentially very large) source code
+///      across the FFI boundary.
+///    * `rs_out_modules_dir` should be a FfiU8Slice for a valid array of bytes
+///      representing an UTF8-encoded string. If it is not empty (which
+///      requires `rs_out` and `cc_out` not to be empty either), it should be a
+///      directory below the directory of `rs_out`. The top-level modules of
+///      the generated Rust source code (e.g. for top-level C++ namespaces) are
+///      then written to separate files in this directory, which `rs_out`
+///      includes with `#[path]` attributes. The on-disk cache of generated
+///      bindings is disabled in this case.
+///    * `cc_out_shards` should be a FfiU8Slice for a valid array of bytes
+///      representing an UTF8-encoded, newline-separated list of paths. If it
+///      is not empty (which requires `rs_out` and `cc_out` not to be empty
+///      either), the thunks of the generated C++ source code are split
+///      between `cc_out` and the files at these paths. The on-disk cache of
+///      generated bindings is disabled in this case.
+///    * if `generate_timing_report` is true, the `timing_report` of the
+///      returned value is a JSON profile of bindings generation (see
+///      `GenerationProfile::to_json`). Otherwise it is empty.
+///    * if `generate_api_hash` is true, the `api_hash` of the returned value
+///      is a hash of the API of the generated Rust source code (see
+///      `tokens_to_api_hash`), which only changes when the API does.
+///      Otherwise it is empty.
+///    * if `generate_cost_report` is true, the `cost_report` of the returned
+///      value is a JSON report of the cost of each item (see
+///      `GenerationProfile::item_costs_to_json`): the time spent generating
+///      its bindings and their size. Otherwise it is empty. The on-disk cache
+///      of generated bindings is disabled in this case.
+///    * `ir`, `crubit_support_path_format`, `rustfmt_exe_path`,
+///      `rustfmt_config_path`, `bindings_cache_dir`, `rs_out`, `cc_out`,
+///      `rs_out_modules_dir`, and `cc_out_shards` shouldn't change during the
+///      call.
 ///
 /// Ownership:
 ///    * function doesn't take ownership of (in other words it borrows) the
-///      input params: `json`, `crubit_support_path_format`, `rustfmt_exe_path`,
-///      and `rustfmt_config_path`
+///      input params: `ir`, `crubit_support_path_format`, `rustfmt_exe_path`,
+///      `rustfmt_config_path`, `bindings_cache_dir`, `rs_out`, `cc_out`,
+///      `rs_out_modules_dir`, and `cc_out_shards`
 ///    * function passes ownership of the returned value to the caller
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn GenerateBindingsImpl(
-    json: FfiU8Slice,
+    ir: FfiU8Slice,
     crubit_support_path_format: FfiU8Slice,
     clang_format_exe_path: FfiU8Slice,
     rustfmt_exe_path: FfiU8Slice,
     rustfmt_config_path: FfiU8Slice,
     generate_error_report: bool,
     generate_source_loc_doc_comment: SourceLocationDocComment,
+    bindings_cache_dir: FfiU8Slice,
+    generated_code_formatting: GeneratedCodeFormatting,
+    rs_out: FfiU8Slice,
+    cc_out: FfiU8Slice,
+    generate_timing_report: bool,
+    generate_unsupported_item_comments: bool,
+    rs_out_modules_dir: FfiU8Slice,
+    cc_out_shards: FfiU8Slice,
+    aggregate_layout_assertions: bool,
+    generate_api_hash: bool,
+    generate_cost_report: bool,
 ) -> FfiBindings {
-    let json: &[u8] = json.as_slice();
+    let ir: &[u8] = ir.as_slice();
     let crubit_support_path_format: &str =
         std::str::from_utf8(crubit_support_path_format.as_slice()).unwrap();
     let clang_format_exe_path: OsString =
@@ -84,20 +146,102 @@ pub unsafe extern "C" fn GenerateBindingsImpl(
         std::str::from_utf8(rustfmt_exe_path.as_slice()).unwrap().into();
     let rustfmt_config_path: OsString =
         std::str::from_utf8(rustfmt_config_path.as_slice()).unwrap().into();
+    let bindings_cache_dir: OsString =
+        std::str::from_utf8(bindings_cache_dir.as_slice()).unwrap().into();
+    let rs_out: OsString = std::str::from_utf8(rs_out.as_slice()).unwrap().into();
+    let cc_out: OsString = std::str::from_utf8(cc_out.as_slice()).unwrap().into();
+    let rs_out_modules_dir: OsString =
+        std::str::from_utf8(rs_out_modules_dir.as_slice()).unwrap().into();
+    let write_outputs = !rs_out.is_empty() && !cc_out.is_empty();
+    let split_rs_api = write_outputs && !rs_out_modules_dir.is_empty();
+    let cc_out_shards: Vec<&str> = if write_outputs {
+        std::str::from_utf8(cc_out_shards.as_slice()).unwrap().lines().collect()
+    } else {
+        vec![]
+    };
+    // Neither the error report, the cost report nor the split source code is
+    // cached, so the cache is bypassed when they are requested.
+    let bindings_cache_dir = if bindings_cache_dir.is_empty()
+        || generate_error_report
+        || generate_cost_report
+        || split_rs_api
+        || !cc_out_shards.is_empty()
+    {
+        None
+    } else {
+        Some(Path::new(&bindings_cache_dir))
+    };
     catch_unwind(|| {
         // It is ok to abort here.
         let errors: Rc<dyn ErrorReporting> =
             if generate_error_report { Rc::new(ErrorReport::new()) } else { Rc::new(IgnoreErrors) };
-        let Bindings { rs_api, rs_api_impl } = generate_bindings(
-            json,
-            crubit_support_path_format,
-            &clang_format_exe_path,
-            &rustfmt_exe_path,
-            &rustfmt_config_path,
-            errors.clone(),
-            generate_source_loc_doc_comment,
-        )
-        .unwrap();
+        let mut profile = GenerationProfile::new(generate_timing_report);
+        if generate_cost_report {
+            profile = profile.with_item_costs();
+        }
+        let profile = Rc::new(profile);
+        // `#[path]` attributes of modules declared in the crate root are relative to
+        // the directory of the crate root.
+        let rs_api_modules_path = if split_rs_api {
+            let rs_out_dir = Path::new(&rs_out).parent().unwrap_or(Path::new(""));
+            let path =
+                Path::new(&rs_out_modules_dir).strip_prefix(rs_out_dir).unwrap_or_else(|_| {
+                    panic!("{rs_out_modules_dir:?} is not below the directory of {rs_out:?}")
+                });
+            Some(path.to_str().unwrap().to_string())
+        } else {
+            None
+        };
+        let Bindings { mut rs_api, mut rs_api_impl, rs_api_modules, rs_api_impl_shards, api_hash } =
+            generate_bindings(
+                ir,
+                crubit_support_path_format,
+                &clang_format_exe_path,
+                &rustfmt_exe_path,
+                &rustfmt_config_path,
+                errors.clone(),
+                generate_source_loc_doc_comment,
+                generate_unsupported_item_comments,
+                aggregate_layout_assertions,
+                bindings_cache_dir,
+                generated_code_formatting,
+                rs_api_modules_path.as_deref(),
+                1 + cc_out_shards.len(),
+                generate_api_hash,
+                profile.clone(),
+            )
+            .unwrap();
+        let mut error = String::new();
+        if write_outputs {
+            let written = profile.time_phase("write_outputs", || -> Result<()> {
+                if split_rs_api {
+                    std::fs::create_dir_all(&rs_out_modules_dir)
+                        .with_context(|| format!("Failed to create {rs_out_modules_dir:?}"))?;
+                }
+                for (name, module) in &rs_api_modules {
+                    let path = Path::new(&rs_out_modules_dir).join(format!("{name}.rs"));
+                    std::fs::write(&path, module)
+                        .with_context(|| format!("Failed to write {path:?}"))?;
+                }
+                std::fs::write(&rs_out, &rs_api)
+                    .with_context(|| format!("Failed to write {rs_out:?}"))?;
+                std::fs::write(&cc_out, &rs_api_impl)
+                    .with_context(|| format!("Failed to write {cc_out:?}"))?;
+                for (path, shard) in cc_out_shards.iter().zip(&rs_api_impl_shards) {
+                    std::fs::write(path, shard)
+                        .with_context(|| format!("Failed to write {path:?}"))?;
+                }
+                Ok(())
+            });
+            if let Err(err) = written {
+                error = format!("{err:#}");
+            }
+            rs_api = String::new();
+            rs_api_impl = String::new();
+        }
+        let timing_report = if generate_timing_report { profile.to_json() } else { String::new() };
+        let cost_report =
+            if generate_cost_report { profile.item_costs_to_json() } else { String::new() };
         FfiBindings {
             rs_api: FfiU8SliceBox::from_boxed_slice(rs_api.into_bytes().into_boxed_slice()),
             rs_api_impl: FfiU8SliceBox::from_boxed_slice(
@@ -106,6 +250,16 @@ pub unsafe extern "C" fn GenerateBindingsImpl(
             error_report: FfiU8SliceBox::from_boxed_slice(
                 errors.serialize_to_vec().unwrap().into_boxed_slice(),
             ),
+            timing_report: FfiU8SliceBox::from_boxed_slice(
+                timing_report.into_bytes().into_boxed_slice(),
+            ),
+            api_hash: FfiU8SliceBox::from_boxed_slice(
+                api_hash.unwrap_or_default().into_bytes().into_boxed_slice(),
+            ),
+            cost_report: FfiU8SliceBox::from_boxed_slice(
+                cost_report.into_bytes().into_boxed_slice(),
+            ),
+            error: FfiU8SliceBox::from_boxed_slice(error.into_bytes().into_boxed_slice()),
         }
     })
     .unwrap_or_else(|_| process::abort())
@@ -119,9 +273,21 @@ memoized::query_group! {
         fn errors(&self) -> Rc<dyn ErrorReporting>;
         #[input]
         fn generate_source_loc_doc_comment(&self) -> SourceLocationDocComment;
+        #[input]
+        fn generate_unsupported_item_comments(&self) -> bool;
+        #[input]
+        fn aggregate_layout_assertions(&self) -> bool;
+        #[input]
+        fn profile(&self) -> Rc<GenerationProfile>;
 
         fn rs_type_kind(&self, rs_type: RsType) -> Result<RsTypeKind>;
 
+        fn shared_rs_type_kind(&self, rs_type: RsType) -> Result<Rc<RsTypeKind>>;
+
+        fn has_bindings(&self, item_id: ItemId) -> HasBindings;
+
+        fn required_crubit_features(&self, item_id: ItemId) -> Result<Vec<RequiredCrubitFeature>>;
+
         fn generate_func(&self, func: Rc<Func>, record_overwrite: Option<Rc<Record>>) -> Result<Option<(Rc<GeneratedItem>, Rc<FunctionId>)>>;
 
         fn overloaded_funcs(&self) -> Rc<HashSet<Rc<FunctionId>>>;
@@ -138,6 +304,8 @@ memoized::query_group! {
             &self,
             record: Rc<Record>,
         ) -> Rc<[Rc<Func>]>;
+
+        fn is_record_c_abi_compatible_by_value(&self, record: Rc<Record>) -> bool;
     }
     struct Database;
 }
@@ -148,6 +316,13 @@ struct Bindings {
     rs_api: String,
     // C++ source code.
     rs_api_impl: String,
+    // Rust source code of the top-level modules that were split out of `rs_api`,
+    // keyed by the names of their files (without the `.rs` extension).
+    rs_api_modules: Vec<(String, String)>,
+    // C++ source code of the shards of `rs_api_impl` after the first one.
+    rs_api_impl_shards: Vec<String>,
+    // Hash of the API of `rs_api` (and `rs_api_modules`), if requested.
+    api_hash: Option<String>,
 }
 
 /// Source code for generated bindings, as tokens.
@@ -161,33 +336,131 @@ pub(crate) struct BindingsTokens {
 }
 
 fn generate_bindings(
-    json: &[u8],
+    ir: &[u8],
     crubit_support_path_format: &str,
     clang_format_exe_path: &OsStr,
     rustfmt_exe_path: &OsStr,
     rustfmt_config_path: &OsStr,
     errors: Rc<dyn ErrorReporting>,
     generate_source_loc_doc_comment: SourceLocationDocComment,
+    generate_unsupported_item_comments: bool,
+    aggregate_layout_assertions: bool,
+    bindings_cache_dir: Option<&Path>,
+    generated_code_formatting: GeneratedCodeFormatting,
+    rs_api_modules_path: Option<&str>,
+    cc_shards: usize,
+    generate_api_hash: bool,
+    profile: Rc<GenerationProfile>,
 ) -> Result<Bindings> {
-    let ir = Rc::new(deserialize_ir(json)?);
+    let ir = Rc::new(profile.time_phase("deserialize_ir", || deserialize_ir_from_bytes(ir))?);
+
+    let cache = bindings_cache_dir.map(|dir| {
+        let key = CacheKeyBuilder::new()
+            .add_ir(&ir)
+            .add(crubit_support_path_format.as_bytes())
+            .add(&[generate_source_loc_doc_comment as u8])
+            .add(&[generate_unsupported_item_comments as u8])
+            .add(&[aggregate_layout_assertions as u8])
+            .add(&[generated_code_formatting as u8])
+            .add_file_identity(&std::env::current_exe().unwrap_or_default())
+            .add_file_identity(Path::new(clang_format_exe_path))
+            .add_file_identity(Path::new(rustfmt_exe_path))
+            .add_file_identity(Path::new(rustfmt_config_path))
+            .build();
+        (BindingsCache::new(dir), key)
+    });
+    if let Some((cache, key)) = &cache {
+        if let Some(CachedBindings { rs_api, rs_api_impl, api_hash }) =
+            profile.time_phase("bindings_cache_lookup", || cache.lookup(key))
+        {
+            return Ok(Bindings {
+                rs_api,
+                rs_api_impl,
+                rs_api_modules: vec![],
+                rs_api_impl_shards: vec![],
+                api_hash: generate_api_hash.then_some(api_hash),
+            });
+        }
+    }
 
-    let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(
-        ir.clone(),
-        crubit_support_path_format,
-        errors,
-        generate_source_loc_doc_comment,
-    )?;
-    let rs_api = {
-        let rustfmt_exe_path = Path::new(rustfmt_exe_path);
-        let rustfmt_config_path = if rustfmt_config_path.is_empty() {
-            None
-        } else {
-            Some(Path::new(rustfmt_config_path))
-        };
-        let rustfmt_config = RustfmtConfig::new(rustfmt_exe_path, rustfmt_config_path);
-        rs_tokens_to_formatted_string(rs_api, &rustfmt_config)?
+    let (BindingsTokens { rs_api, rs_api_impl }, rs_api_impl_shards) =
+        profile.time_phase("generate_bindings_tokens", || {
+            generate_sharded_bindings_tokens(
+                ir.clone(),
+                crubit_support_path_format,
+                errors,
+                generate_source_loc_doc_comment,
+                generate_unsupported_item_comments,
+                aggregate_layout_assertions,
+                cc_shards,
+                profile.clone(),
+            )
+        })?;
+    // The hash is also stored in the cache, so it is computed whenever the
+    // cache is enabled.
+    let api_hash = (generate_api_hash || cache.is_some())
+        .then(|| profile.time_phase("api_hash", || tokens_to_api_hash(rs_api.clone())));
+    let (rs_api, modules) = match rs_api_modules_path {
+        Some(path) => split_top_level_modules(rs_api, path),
+        None => (rs_api, vec![]),
     };
-    let rs_api_impl = cc_tokens_to_formatted_string(rs_api_impl, Path::new(clang_format_exe_path))?;
+    let (mut rs_api, mut rs_api_impl, mut modules) =
+        profile.time_phase("format", || -> Result<_> {
+            Ok(if generated_code_formatting == GeneratedCodeFormatting::BuiltinPrettyPrinter {
+                let modules = modules
+                    .into_iter()
+                    .map(|(name, module)| Ok((name, tokens_to_pretty_string(module)?)))
+                    .collect::<Result<Vec<_>>>()?;
+                (tokens_to_pretty_string(rs_api)?, tokens_to_pretty_string(rs_api_impl)?, modules)
+            } else {
+                let rustfmt_exe_path = Path::new(rustfmt_exe_path);
+                let rustfmt_config_path = if rustfmt_config_path.is_empty() {
+                    None
+                } else {
+                    Some(Path::new(rustfmt_config_path))
+                };
+                let rustfmt_config = RustfmtConfig::new(rustfmt_exe_path, rustfmt_config_path);
+                // Chunks are only worth an extra `rustfmt` process when they are large.
+                let rs_min_chunk_len = if generated_code_formatting
+                    == GeneratedCodeFormatting::ExternalFormattersInChunks
+                {
+                    64 * 1024
+                } else {
+                    usize::MAX
+                };
+                let modules = modules
+                    .into_iter()
+                    .map(|(name, module)| {
+                        let module = rs_tokens_to_formatted_string_in_chunks(
+                            module,
+                            &rustfmt_config,
+                            rs_min_chunk_len,
+                        )?;
+                        Ok((name, module))
+                    })
+                    .collect::<Result<Vec<_>>>()?;
+                let (rs_api, rs_api_impl) = rs_and_cc_tokens_to_formatted_strings(
+                    rs_api,
+                    &rustfmt_config,
+                    rs_min_chunk_len,
+                    rs_api_impl,
+                    Path::new(clang_format_exe_path),
+                )?;
+                (rs_api, rs_api_impl, modules)
+            })
+        })?;
+    let mut rs_api_impl_shards = profile.time_phase("format_cc_shards", || {
+        rs_api_impl_shards
+            .into_iter()
+            .map(|shard| {
+                Ok(if generated_code_formatting == GeneratedCodeFormatting::BuiltinPrettyPrinter {
+                    tokens_to_pretty_string(shard)?
+                } else {
+                    cc_tokens_to_formatted_string(shard, Path::new(clang_format_exe_path))?
+                })
+            })
+            .collect::<Result<Vec<_>>>()
+    })?;
 
     // Add top-level comments that help identify where the generated bindings came
     // from.
@@ -228,17 +501,78 @@ fn generate_bindings(
     };
     // TODO(lukasza): Try to remove `#![rustfmt:skip]` - in theory it shouldn't
     // be needed when `@generated` comment/keyword is present...
-    let rs_api = format!(
-        "{top_level_comment}\n\
-        #![rustfmt::skip]\n\
-        {rs_api}"
-    );
-    let rs_api_impl = format!(
-        "{top_level_comment}\n\
-        {rs_api_impl}"
-    );
+    // `insert_str` reuses the allocation of the formatted code when it has
+    // enough capacity, instead of copying it into a new `String`.
+    rs_api.insert_str(0, &format!("{top_level_comment}\n#![rustfmt::skip]\n"));
+    rs_api_impl.insert_str(0, &format!("{top_level_comment}\n"));
+    for (_, module) in &mut modules {
+        module.insert_str(0, &format!("{top_level_comment}\n#![rustfmt::skip]\n"));
+    }
+    for shard in &mut rs_api_impl_shards {
+        shard.insert_str(0, &format!("{top_level_comment}\n"));
+    }
+
+    if let Some((cache, key)) = &cache {
+        // Failing to populate the cache only means that a later run has to
+        // generate the bindings again.
+        let _ = cache.store(
+            key,
+            &rs_api,
+            &rs_api_impl,
+            api_hash.as_deref().expect("the API hash is computed when the cache is enabled"),
+        );
+    }
+    Ok(Bindings {
+        rs_api,
+        rs_api_impl,
+        rs_api_modules: modules,
+        rs_api_impl_shards,
+        api_hash: api_hash.filter(|_| generate_api_hash),
+    })
+}
 
-    Ok(Bindings { rs_api, rs_api_impl })
+/// Moves the bodies of the top-level `pub mod <name> { ... }` items of `rs_api`
+/// (i.e. of the modules of top-level C++ namespaces) out of `rs_api`, so that
+/// they can be written to and formatted as separate files. The items are
+/// replaced with `#[path = "<modules_path>/<name>.rs"] pub mod <name>;`.
+///
+/// Returns the remaining crate root, and the names and bodies of the modules.
+fn split_top_level_modules(
+    rs_api: TokenStream,
+    modules_path: &str,
+) -> (TokenStream, Vec<(String, TokenStream)>) {
+    let mut crate_root = vec![];
+    let mut modules = vec![];
+    let mut tokens = rs_api.into_iter().peekable();
+    while let Some(tt) = tokens.next() {
+        let is_pub = matches!(&tt, TokenTree::Ident(ident) if ident == "pub");
+        crate_root.push(tt);
+        if !is_pub || !matches!(tokens.peek(), Some(TokenTree::Ident(ident)) if ident == "mod") {
+            continue;
+        }
+        crate_root.push(tokens.next().unwrap());
+        let Some(TokenTree::Ident(name)) = tokens.next_if(|tt| matches!(tt, TokenTree::Ident(_)))
+        else {
+            continue;
+        };
+        match tokens.next_if(
+            |tt| matches!(tt, TokenTree::Group(group) if group.delimiter() == Delimiter::Brace),
+        ) {
+            Some(TokenTree::Group(body)) => {
+                // Raw identifiers like `r#type` don't make good file names.
+                let file_name = name.to_string().trim_start_matches("r#").to_string();
+                let path = format!("{modules_path}/{file_name}.rs");
+                // Insert the `#[path]` attribute before `pub mod`.
+                let pub_mod = crate_root.split_off(crate_root.len() - 2);
+                crate_root.extend(quote! { #[path = #path] });
+                crate_root.extend(pub_mod);
+                crate_root.extend(quote! { #name; });
+                modules.push((file_name, body.stream()));
+            }
+            _ => crate_root.push(TokenTree::Ident(name)),
+        }
+    }
+    (crate_root.into_iter().collect(), modules)
 }
 
 fn generate_doc_comment(
@@ -278,6 +612,25 @@ fn generate_enum(db: &Database, enum_: &Enum) -> Result<GeneratedItem> {
             ),
         );
     };
+    let dense_enum = if enum_.has_dense_attribute {
+        generate_dense_enum(&name, &underlying_type, enumerators)?
+    } else {
+        quote! {}
+    };
+    // Used by the bindings of C++ constants of this type, which may be in other
+    // modules, and so can't name the private field.
+    let from_underlying = if is_enum_used_by_constants(db, enum_) {
+        quote! {
+            impl #name {
+                #[doc(hidden)]
+                pub const fn __crubit_from_underlying(value: #underlying_type) -> #name {
+                    #name(value)
+                }
+            }
+        }
+    } else {
+        quote! {}
+    };
     let enumerators = enumerators.iter().map(|enumerator| {
         if let Some(unknown_attr) = &enumerator.unknown_attr {
             let comment = format!(
@@ -323,6 +676,8 @@ fn generate_enum(db: &Database, enum_: &Enum) -> Result<GeneratedItem> {
                 value.0
             }
         }
+        #from_underlying
+        #dense_enum
     };
     Ok(GeneratedItem {
         item,
@@ -331,6 +686,90 @@ fn generate_enum(db: &Database, enum_: &Enum) -> Result<GeneratedItem> {
     })
 }
 
+/// Generates the `<Name>Enum` of an enum annotated with
+/// `CRUBIT_INTERNAL_DENSE_ENUM`: a Rust `enum` with a variant per enumerator,
+/// which converts from the newtype `name` with a single range check.
+///
+/// The variants have no `repr`, because the underlying type (e.g. `c_int`) may
+/// not be spelled in one, so their discriminants must fit in an `i64`.
+fn generate_dense_enum(
+    name: &Ident,
+    underlying_type: &RsTypeKind,
+    enumerators: &[Enumerator],
+) -> Result<TokenStream> {
+    ensure!(
+        !underlying_type.is_bool(),
+        "CRUBIT_INTERNAL_DENSE_ENUM is not supported for enums with a `bool` underlying type"
+    );
+    let mut variants = enumerators
+        .iter()
+        .map(|enumerator| {
+            let ident = &enumerator.identifier.identifier;
+            ensure!(
+                enumerator.unknown_attr.is_none(),
+                "CRUBIT_INTERNAL_DENSE_ENUM requires bindings for every enumerator, but \
+                 `{ident}` has unknown attribute(s)"
+            );
+            let value = if enumerator.value.is_negative {
+                enumerator.value.wrapped_value as i64
+            } else {
+                i64::try_from(enumerator.value.wrapped_value).map_err(|_| {
+                    anyhow!(
+                        "CRUBIT_INTERNAL_DENSE_ENUM requires values that fit in an `i64`, \
+                         but `{ident}` is {}",
+                        enumerator.value.wrapped_value
+                    )
+                })?
+            };
+            Ok((value, make_rs_ident(ident)))
+        })
+        .collect::<Result<Vec<_>>>()?;
+    variants.sort_by_key(|(value, _)| *value);
+    let (Some((min, _)), Some((max, _))) = (variants.first(), variants.last()) else {
+        bail!("CRUBIT_INTERNAL_DENSE_ENUM requires at least one enumerator");
+    };
+    for ((prev, prev_ident), (next, next_ident)) in variants.iter().tuple_windows() {
+        ensure!(
+            *next == prev + 1,
+            "CRUBIT_INTERNAL_DENSE_ENUM requires enumerators with distinct, consecutive \
+             values, but `{prev_ident}` is {prev} and `{next_ident}` is {next}"
+        );
+    }
+
+    let enum_name = make_rs_ident(&format!("{}Enum", name.to_string().trim_start_matches("r#")));
+    let len = Literal::usize_unsuffixed(variants.len());
+    let min = Literal::i64_unsuffixed(*min);
+    let max = Literal::i64_unsuffixed(*max);
+    let (values, idents): (Vec<_>, Vec<_>) =
+        variants.iter().map(|(value, ident)| (Literal::i64_unsuffixed(*value), ident)).unzip();
+    Ok(quote! {
+        #[derive(Debug, PartialEq, Eq, Copy, Clone, Hash, PartialOrd, Ord)]
+        pub enum #enum_name {
+            #( #idents = #values, )*
+        }
+        impl TryFrom<#name> for #enum_name {
+            type Error = #name;
+            #[inline(always)]
+            fn try_from(value: #name) -> Result<#enum_name, #name> {
+                const VARIANTS: [#enum_name; #len] = [ #( #enum_name::#idents ),* ];
+                if (#min..=#max).contains(&value.0) {
+                    // Widened so that the subtraction can't overflow, e.g. for
+                    // `i8` enumerators spanning -100..=100.
+                    Ok(VARIANTS[(value.0 as i128 - #min) as usize])
+                } else {
+                    Err(value)
+                }
+            }
+        }
+        impl From<#enum_name> for #name {
+            #[inline(always)]
+            fn from(value: #enum_name) -> #name {
+                #name(value as #underlying_type)
+            }
+        }
+    })
+}
+
 fn generate_type_alias(db: &Database, type_alias: &TypeAlias) -> Result<GeneratedItem> {
     let ident = make_rs_ident(&type_alias.identifier.identifier);
     let doc_comment = generate_doc_comment(
@@ -348,11 +787,100 @@ fn generate_type_alias(db: &Database, type_alias: &TypeAlias) -> Result<Generate
     .into())
 }
 
+/// Generates a Rust `const` for a C++ constant, which (unlike a thunk reading
+/// the C++ variable) can be used in Rust constant expressions.
+///
+/// Constants nested in a record become associated constants of the record.
+fn generate_constant(db: &Database, constant: &Constant) -> Result<GeneratedItem> {
+    let ir = db.ir();
+    let ident = make_rs_ident(&constant.identifier.identifier);
+    let doc_comment = generate_doc_comment(
+        constant.doc_comment.as_deref(),
+        Some(&constant.source_loc),
+        db.generate_source_loc_doc_comment(),
+    );
+    let type_ = db
+        .rs_type_kind(constant.type_.rs_type.clone())
+        .with_context(|| format!("Failed to format the type of {}", constant.identifier))?;
+    let IntegerConstant { is_negative, wrapped_value } = constant.value;
+    let literal = if is_negative {
+        Literal::i64_unsuffixed(wrapped_value as i64).into_token_stream()
+    } else {
+        Literal::u64_unsuffixed(wrapped_value).into_token_stream()
+    };
+    let mut underlying_type = &type_;
+    while let RsTypeKind::TypeAlias { underlying_type: aliased, .. } = underlying_type {
+        underlying_type = aliased;
+    }
+    let value = match underlying_type {
+        RsTypeKind::Primitive(PrimitiveType::bool) => {
+            if wrapped_value == 0 {
+                quote! {false}
+            } else {
+                quote! {true}
+            }
+        }
+        RsTypeKind::Primitive(_) => literal,
+        RsTypeKind::Enum { enum_, .. } => {
+            // The field of the enum's newtype is private, and the constant may be in another
+            // module, so this goes through a `const fn` of the enum. The `const fn` is only
+            // generated for enums that constants of their own target use (see
+            // `is_enum_used_by_constants`).
+            ensure!(
+                enum_.owning_target == constant.owning_target,
+                "Constants of enums from other targets are not supported yet"
+            );
+            let value = if db.rs_type_kind(enum_.underlying_type.rs_type.clone())?.is_bool() {
+                if wrapped_value == 0 {
+                    quote! {false}
+                } else {
+                    quote! {true}
+                }
+            } else {
+                literal
+            };
+            quote! { #underlying_type::__crubit_from_underlying(#value) }
+        }
+        other => bail!("Unsupported type of constant: {other}"),
+    };
+    let item = quote! {
+        #doc_comment
+        pub const #ident: #type_ = #value;
+    };
+    let item = match constant.enclosing_item_id.map(|id| ir.find_untyped_decl(id)) {
+        Some(Item::Record(record)) => {
+            let record_type = RsTypeKind::new_record(db, record.clone(), &ir)?;
+            quote! { impl #record_type { #item } }
+        }
+        _ => item,
+    };
+    Ok(item.into())
+}
+
+/// Returns true if a constant of the same target as `enum_` has the type
+/// `enum_` (possibly through type aliases).
+fn is_enum_used_by_constants(db: &Database, enum_: &Enum) -> bool {
+    db.ir().items().any(|item| {
+        let Item::Constant(constant) = item else { return false };
+        if constant.owning_target != enum_.owning_target {
+            return false;
+        }
+        let Ok(mut type_) = db.rs_type_kind(constant.type_.rs_type.clone()) else { return false };
+        while let RsTypeKind::TypeAlias { underlying_type, .. } = type_ {
+            type_ = underlying_type.as_ref().clone();
+        }
+        matches!(type_, RsTypeKind::Enum { enum_: constant_enum, .. } if constant_enum.id == enum_.id)
+    })
+}
+
 /// Generates Rust source code for a given `UnsupportedItem`.
 fn generate_unsupported(db: &Database, item: &UnsupportedItem) -> Result<GeneratedItem> {
     for error in item.errors() {
         db.errors().insert(error);
     }
+    if !db.generate_unsupported_item_comments() {
+        return Ok(GeneratedItem::default());
+    }
 
     let source_loc = item.source_loc();
     let source_loc = match &source_loc {
@@ -385,6 +913,8 @@ fn generate_namespace(db: &Database, namespace: &Namespace) -> Result<GeneratedI
     let mut thunks = vec![];
     let mut thunk_impls = vec![];
     let mut assertions = vec![];
+    let mut rs_layout_checks = vec![];
+    let mut cc_layout_checks = vec![];
     let mut features = BTreeSet::new();
 
     for item_id in namespace.child_item_ids.iter() {
@@ -402,6 +932,8 @@ fn generate_namespace(db: &Database, namespace: &Namespace) -> Result<GeneratedI
         if !generated.assertions.is_empty() {
             assertions.push(generated.assertions);
         }
+        rs_layout_checks.push(generated.rs_layout_checks);
+        cc_layout_checks.push(generated.cc_layout_checks);
         features.extend(generated.features);
     }
 
@@ -461,7 +993,8 @@ fn generate_namespace(db: &Database, namespace: &Namespace) -> Result<GeneratedI
         thunks: quote! { #( #thunks )* },
         thunk_impls: quote! { #( #thunk_impls )* },
         assertions: quote! { #( #assertions )* },
-        ..Default::default()
+        rs_layout_checks: quote! { #( #rs_layout_checks )* },
+        cc_layout_checks: quote! { #( #cc_layout_checks )* },
     })
 }
 
@@ -472,9 +1005,38 @@ struct GeneratedItem {
     // C++ source code for helper functions.
     thunk_impls: TokenStream,
     assertions: TokenStream,
+    // Rows of the layout tables of the target, which take the place of the
+    // layout assertions in `assertions` and `thunk_impls` when
+    // `db.aggregate_layout_assertions()` is true: `(actual, expected, "type"),`
+    // in Rust and `{actual, expected},` in C++.
+    rs_layout_checks: TokenStream,
+    cc_layout_checks: TokenStream,
     features: BTreeSet<Ident>,
 }
 
+impl GeneratedItem {
+    /// Returns the size of the (unformatted) generated code, for the cost
+    /// report.
+    fn output_size(&self) -> ItemOutputSize {
+        let len = |tokens: &TokenStream| tokens.to_string().len() as u64;
+        // Every thunk is declared with exactly one top-level `fn`.
+        let thunks = self
+            .thunks
+            .clone()
+            .into_iter()
+            .filter(|tt| matches!(tt, TokenTree::Ident(ident) if ident == "fn"))
+            .count() as u64;
+        ItemOutputSize {
+            rs_bytes: len(&self.item)
+                + len(&self.thunks)
+                + len(&self.assertions)
+                + len(&self.rs_layout_checks),
+            cc_bytes: len(&self.thunk_impls) + len(&self.cc_layout_checks),
+            thunks,
+        }
+    }
+}
+
 impl From<TokenStream> for GeneratedItem {
     fn from(item: TokenStream) -> Self {
         GeneratedItem { item, ..Default::default() }
@@ -484,18 +1046,26 @@ impl From<TokenStream> for GeneratedItem {
 /// Returns generated bindings for an item, or `Err` if bindings generation
 /// failed in such a way as to make the generated bindings as a whole invalid.
 fn generate_item(db: &Database, item: &Item) -> Result<GeneratedItem> {
-    match generate_item_impl(db, item) {
-        Ok(generated) => Ok(generated),
-        Err(err) => {
-            let ir = db.ir();
-            if has_bindings(db, item) != HasBindings::Yes {
-                // We didn't guarantee that bindings would exist, so it is not invalid to
-                // write down the error but continue.
-                return generate_unsupported(db, &UnsupportedItem::new_with_cause(&ir, item, err));
+    let ir = db.ir();
+    db.profile().time_item(
+        &ir,
+        item,
+        || match generate_item_impl(db, item) {
+            Ok(generated) => Ok(generated),
+            Err(err) => {
+                if db.has_bindings(item.id()) != HasBindings::Yes {
+                    // We didn't guarantee that bindings would exist, so it is not invalid to
+                    // write down the error but continue.
+                    return generate_unsupported(
+                        db,
+                        &UnsupportedItem::new_with_cause(&ir, item, err),
+                    );
+                }
+                Err(err)
             }
-            Err(err)
-        }
-    }
+        },
+        |generated| generated.as_ref().map(GeneratedItem::output_size).unwrap_or_default(),
+    )
 }
 
 /// The implementation of generate_item, without the error recovery logic.
@@ -526,6 +1096,7 @@ fn generate_item_impl(db: &Database, item: &Item) -> Result<GeneratedItem> {
         Item::Record(record) => generate_record(db, record)?,
         Item::Enum(enum_) => generate_enum(db, enum_)?,
         Item::TypeAlias(type_alias) => generate_type_alias(db, type_alias)?,
+        Item::Constant(constant) => generate_constant(db, constant)?,
         Item::UnsupportedItem(unsupported) => generate_unsupported(db, unsupported)?,
         Item::Comment(comment) => generate_comment(comment)?,
         Item::Namespace(namespace) => generate_namespace(db, namespace)?,
@@ -549,24 +1120,23 @@ fn generate_item_impl(db: &Database, item: &Item) -> Result<GeneratedItem> {
                     an existing Rust type ({rs_type})",
                 cpp_type = type_override.debug_name(&ir),
             );
-            let assertions = if let Some(size_align) = &type_override.size_align {
-                generate_record::rs_size_align_assertions(rs_type, size_align)
+            let layout_assertions = if let Some(size_align) = &type_override.size_align {
+                generate_record::rs_size_align_assertions(db, rs_type, size_align)
             } else {
-                quote! {}
+                GeneratedItem::default()
             };
 
             GeneratedItem {
                 item: quote! {
                     __COMMENT__ #disable_comment
                 },
-                assertions,
-                ..Default::default()
+                ..layout_assertions
             }
         }
     };
 
     // Suppress bindings at the last minute, to collect other errors first.
-    if let HasBindings::No(reason) = has_bindings(db, item) {
+    if let HasBindings::No(reason) = db.has_bindings(item.id()) {
         return Err(reason.into());
     }
 
@@ -641,11 +1211,20 @@ impl Display for RequiredCrubitFeature {
     }
 }
 
+/// Returns whether bindings are generated for the item `item_id`.
+///
+/// This is memoized, because it is checked for every use of a type (see
+/// `rs_type_kind`), and depends on the types that the item uses in turn.
 #[must_use]
-fn has_bindings(db: &dyn BindingsGenerator, item: &Item) -> HasBindings {
+fn has_bindings(db: &dyn BindingsGenerator, item_id: ItemId) -> HasBindings {
+    db.profile().time_query("has_bindings", || has_bindings_impl(db, item_id))
+}
+
+fn has_bindings_impl(db: &dyn BindingsGenerator, item_id: ItemId) -> HasBindings {
     let ir = db.ir();
+    let item = ir.find_untyped_decl(item_id);
 
-    match required_crubit_features(db, item) {
+    match db.required_crubit_features(item_id) {
         Ok(missing_features) if missing_features.is_empty() => {}
         Ok(missing_features) => {
             return HasBindings::No(NoBindingsReason::MissingRequiredFeatures {
@@ -664,7 +1243,7 @@ fn has_bindings(db: &dyn BindingsGenerator, item: &Item) -> HasBindings {
     if let Some(parent) = item.enclosing_item_id() {
         let parent = ir.find_untyped_decl(parent);
 
-        match has_bindings(db, parent) {
+        match db.has_bindings(parent.id()) {
             HasBindings::No(no_parent_bindings) => {
                 return HasBindings::No(NoBindingsReason::DependencyFailed {
                     context: item.debug_name(&ir),
@@ -743,11 +1322,20 @@ impl From<NoBindingsReason> for Error {
 /// features, then bindings are suppressed for this item.
 fn required_crubit_features(
     db: &dyn BindingsGenerator,
-    item: &Item,
+    item_id: ItemId,
+) -> Result<Vec<RequiredCrubitFeature>> {
+    db.profile()
+        .time_query("required_crubit_features", || required_crubit_features_impl(db, item_id))
+}
+
+fn required_crubit_features_impl(
+    db: &dyn BindingsGenerator,
+    item_id: ItemId,
 ) -> Result<Vec<RequiredCrubitFeature>> {
     let mut missing_features = vec![];
 
     let ir = &db.ir();
+    let item = ir.find_untyped_decl(item_id);
 
     let require_any_feature =
         |missing_features: &mut Vec<RequiredCrubitFeature>,
@@ -823,7 +1411,7 @@ fn required_crubit_features(
                     &|| "return type".into(),
                 );
                 for (i, param) in func.params.iter().enumerate() {
-                    let param_type = db.rs_type_kind(param.type_.rs_type.clone())?;
+                    let param_type = param_rs_type_kind(db, &param.type_.rs_type)?;
                     require_rs_type_kind(
                         &mut missing_features,
                         &param_type,
@@ -935,31 +1523,75 @@ fn required_crubit_features(
                 &|| "type map override".into(),
             );
         }
+        Item::Constant(constant) => {
+            require_rs_type_kind(
+                &mut missing_features,
+                &db.rs_type_kind(constant.type_.rs_type.clone())?,
+                TypeLocation::Other,
+                &|| "constant type".into(),
+            );
+        }
     }
     Ok(missing_features)
 }
 
 // Returns the Rust code implementing bindings, plus any auxiliary C++ code
 // needed to support it.
+#[cfg(test)]
 fn generate_bindings_tokens(
     ir: Rc<IR>,
     crubit_support_path_format: &str,
     errors: Rc<dyn ErrorReporting>,
     generate_source_loc_doc_comment: SourceLocationDocComment,
+    generate_unsupported_item_comments: bool,
+    profile: Rc<GenerationProfile>,
 ) -> Result<BindingsTokens> {
-    let db = Database::new(ir.clone(), errors, generate_source_loc_doc_comment);
+    let (bindings_tokens, _) = generate_sharded_bindings_tokens(
+        ir,
+        crubit_support_path_format,
+        errors,
+        generate_source_loc_doc_comment,
+        generate_unsupported_item_comments,
+        /* aggregate_layout_assertions= */ false,
+        1,
+        profile,
+    )?;
+    Ok(bindings_tokens)
+}
+
+// Like `generate_bindings_tokens`, but splits the C++ code into `cc_shards`
+// files of roughly equal size (see `shard_thunk_impls`). The first one is
+// returned in `BindingsTokens::rs_api_impl`, and the others separately.
+fn generate_sharded_bindings_tokens(
+    ir: Rc<IR>,
+    crubit_support_path_format: &str,
+    errors: Rc<dyn ErrorReporting>,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+    generate_unsupported_item_comments: bool,
+    aggregate_layout_assertions: bool,
+    cc_shards: usize,
+    profile: Rc<GenerationProfile>,
+) -> Result<(BindingsTokens, Vec<TokenStream>)> {
+    let db = Database::new(
+        ir.clone(),
+        errors,
+        generate_source_loc_doc_comment,
+        generate_unsupported_item_comments,
+        aggregate_layout_assertions,
+        profile,
+    );
     let mut items = vec![];
     let mut thunks = vec![];
-    let mut thunk_impls = vec![
-        generate_rs_api_impl_includes(&db, crubit_support_path_format)?,
-        quote! {
+    // The includes are prepended once all of the thunks are known.
+    let mut thunk_impls = vec![quote! {
             __HASH_TOKEN__ pragma clang diagnostic push __NEWLINE__
             // Disable Clang thread-safety-analysis warnings that would otherwise
             // complain about thunks that call mutex locking functions in an unpaired way.
             __HASH_TOKEN__ pragma clang diagnostic ignored "-Wthread-safety-analysis" __NEWLINE__
-        },
-    ];
+    }];
     let mut assertions = vec![];
+    let mut rs_layout_checks = vec![];
+    let mut cc_layout_checks = vec![];
 
     let mut features = BTreeSet::new();
 
@@ -982,9 +1614,41 @@ fn generate_bindings_tokens(
         if !generated.thunk_impls.is_empty() {
             thunk_impls.push(generated.thunk_impls);
         }
+        rs_layout_checks.push(generated.rs_layout_checks);
+        cc_layout_checks.push(generated.cc_layout_checks);
         features.extend(generated.features);
     }
 
+    // With `db.aggregate_layout_assertions()`, one table-driven assertion in
+    // each language verifies the layout of all of the types of the target.
+    let rs_layout_checks = quote! { #( #rs_layout_checks )* };
+    if !rs_layout_checks.is_empty() {
+        assertions.push(quote! {
+            let layout: &[(usize, usize, &str)] = &[ #rs_layout_checks ]; __NEWLINE__
+            let mut i = 0; __NEWLINE__
+            while i < layout.len() {
+                // Const panics can only print a single `&str`: the name of the
+                // type whose layout doesn't match its C++ type.
+                assert!(layout[i].0 == layout[i].1, "{}", layout[i].2);
+                i += 1;
+            }
+        });
+    }
+    let cc_layout_checks = quote! { #( #cc_layout_checks )* };
+    if !cc_layout_checks.is_empty() {
+        thunk_impls.push(quote! {
+            static_assert(
+                ::crubit::details::FindLayoutMismatch({ #cc_layout_checks }) == -1
+            );
+        });
+    }
+
+    let uses_special_member_thunks =
+        thunk_impls.iter().any(|tokens| uses_special_member_thunks(tokens.clone()));
+    thunk_impls.insert(
+        0,
+        generate_rs_api_impl_includes(&db, crubit_support_path_format, uses_special_member_thunks)?,
+    );
     thunk_impls.push(quote! {
         __NEWLINE__
         __HASH_TOKEN__ pragma clang diagnostic pop __NEWLINE__
@@ -1043,7 +1707,9 @@ fn generate_bindings_tokens(
         }
     };
 
-    Ok(BindingsTokens {
+    let mut rs_api_impl_shards = shard_thunk_impls(thunk_impls, cc_shards).into_iter();
+    let rs_api_impl = rs_api_impl_shards.next().unwrap();
+    let bindings_tokens = BindingsTokens {
         rs_api: quote! {
             #features __NEWLINE__
             #![no_std] __NEWLINE__
@@ -1069,8 +1735,90 @@ fn generate_bindings_tokens(
 
             #assertions
         },
-        rs_api_impl: quote! {#(#thunk_impls  __NEWLINE__ __NEWLINE__ )*},
-    })
+        rs_api_impl,
+    };
+    Ok((bindings_tokens, rs_api_impl_shards.collect()))
+}
+
+/// Joins the C++ source code `thunk_impls` into `num_shards` source files.
+///
+/// The first two elements of `thunk_impls` are the includes and `#pragma`s
+/// that every shard starts with, and the last one is the `#pragma` that every
+/// shard ends with. The top-level declarations of the elements in between
+/// (i.e. the thunks and assertions of the top-level items) are distributed
+/// over the shards in order, so that every shard gets roughly the same number
+/// of tokens.
+fn shard_thunk_impls(mut thunk_impls: Vec<TokenStream>, num_shards: usize) -> Vec<TokenStream> {
+    if num_shards <= 1 {
+        return vec![quote! {#(#thunk_impls  __NEWLINE__ __NEWLINE__ )*}];
+    }
+    let epilogue = thunk_impls.pop().unwrap();
+    let prologue: Vec<TokenStream> = thunk_impls.drain(..2).collect();
+    let decls: Vec<TokenStream> =
+        thunk_impls.into_iter().flat_map(split_cc_top_level_decls).collect();
+    let sizes: Vec<usize> = decls.iter().map(count_tokens).collect();
+    let shard_size = sizes.iter().sum::<usize>().div_ceil(num_shards);
+
+    let mut shards = vec![vec![]; num_shards];
+    let mut shard_index = 0;
+    let mut size_of_shard = 0;
+    for (decl, size) in decls.into_iter().zip(sizes) {
+        if size_of_shard >= shard_size && shard_index + 1 < num_shards {
+            shard_index += 1;
+            size_of_shard = 0;
+        }
+        shards[shard_index].push(decl);
+        size_of_shard += size;
+    }
+    shards
+        .into_iter()
+        .map(|decls| {
+            quote! {
+                #( #prologue __NEWLINE__ __NEWLINE__ )*
+                #( #decls __NEWLINE__ __NEWLINE__ )*
+                #epilogue
+            }
+        })
+        .collect()
+}
+
+/// Splits C++ source code into its top-level declarations. A declaration ends
+/// at a top-level `;`, or at a top-level `{ ... }` that is not followed by `;`
+/// (i.e. a function body, rather than the body of a class definition).
+fn split_cc_top_level_decls(tokens: TokenStream) -> Vec<TokenStream> {
+    let mut decls = vec![];
+    let mut current = vec![];
+    let mut tokens = tokens.into_iter().peekable();
+    while let Some(tt) = tokens.next() {
+        let ends_decl = match &tt {
+            TokenTree::Punct(punct) => punct.as_char() == ';',
+            TokenTree::Group(group) => {
+                group.delimiter() == Delimiter::Brace
+                    && !matches!(tokens.peek(), Some(TokenTree::Punct(punct)) if punct.as_char() == ';')
+            }
+            _ => false,
+        };
+        current.push(tt);
+        if ends_decl {
+            decls.push(current.drain(..).collect());
+        }
+    }
+    if !current.is_empty() {
+        decls.push(current.into_iter().collect());
+    }
+    decls
+}
+
+/// Returns the number of tokens in `tokens`, including the tokens in groups.
+fn count_tokens(tokens: &TokenStream) -> usize {
+    tokens
+        .clone()
+        .into_iter()
+        .map(|tt| match tt {
+            TokenTree::Group(group) => 1 + count_tokens(&group.stream()),
+            _ => 1,
+        })
+        .sum()
 }
 
 /// Formats a C++ identifier.  Panics if `ident` is a C++ reserved keyword.
@@ -1100,12 +1848,13 @@ fn rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<RsTypeKind
         if ty.type_args.len() != 1 {
             bail!("Missing pointee/referent type (need exactly 1 type argument): {:?}", ty);
         }
-        // TODO(b/351976044): Support bridge types by pointer/reference.
-        let pointee = get_type_args()?.pop().unwrap();
+        // TODO(b/351976044): Support bridge types by pointer/reference. (`const`
+        // references in function parameters are handled by `param_rs_type_kind`.)
+        let pointee = db.shared_rs_type_kind(ty.type_args[0].clone())?;
         if pointee.is_bridge_type() {
             bail!("Bridging types are not supported as pointee/referent types.");
         }
-        Ok(Rc::new(pointee))
+        Ok(pointee)
     };
     let get_lifetime = || -> Result<Lifetime> {
         if ty.lifetime_args.len() != 1 {
@@ -1131,7 +1880,7 @@ fn rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<RsTypeKind
                 ir::Item::TypeAlias(alias) => Some(&alias.underlying_type.rs_type),
                 _ => None,
             };
-            match (has_bindings(db, item), fallback_type) {
+            match (db.has_bindings(item.id()), fallback_type) {
                 (HasBindings::Yes, _) => {}
                 // Additionally, we should not "see through" type aliases that are specifically not
                 // on targets that intend to support Rust users of those type aliases.
@@ -1205,13 +1954,12 @@ fn rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<RsTypeKind
                 lifetime: get_lifetime()?,
             },
             "Option" => {
-                let mut type_args = get_type_args()?;
                 ensure!(
-                    type_args.len() == 1,
+                    ty.type_args.len() == 1,
                     "Option should have exactly 1 type argument (got {})",
-                    type_args.len()
+                    ty.type_args.len()
                 );
-                RsTypeKind::Option(Rc::new(type_args.remove(0)))
+                RsTypeKind::Option(db.shared_rs_type_kind(ty.type_args[0].clone())?)
             }
             name => {
                 let mut type_args = get_type_args()?;
@@ -1234,13 +1982,15 @@ fn rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<RsTypeKind
                         "In well-formed IR function pointers include at least the return type",
                     );
                     ensure!(
-                        type_args.iter().all(|t| t.is_c_abi_compatible_by_value()),
+                        type_args.iter().all(|t| t.is_c_abi_compatible_by_value_ignoring_fields()),
                         "Either the return type or some of the parameter types require \
                             an FFI thunk (and function pointers don't have a thunk)",
                     );
+                    type_args.pop();
+                    let return_type = ty.type_args.last().unwrap().clone();
                     RsTypeKind::FuncPtr {
                         abi: abi.into(),
-                        return_type: Rc::new(type_args.remove(type_args.len() - 1)),
+                        return_type: db.shared_rs_type_kind(return_type)?,
                         param_types: Rc::from(type_args),
                     }
                 } else {
@@ -1256,9 +2006,48 @@ fn rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<RsTypeKind
     Ok(result)
 }
 
+/// Returns `rs_type_kind(ty)` behind an `Rc`, which is shared by all the types
+/// that contain it: e.g. `*const T`, `&T` and `Option<&T>` all point to the same
+/// `T`. Equal nested types are thus stored once, and compare equal by pointer.
+fn shared_rs_type_kind(db: &dyn BindingsGenerator, ty: ir::RsType) -> Result<Rc<RsTypeKind>> {
+    db.rs_type_kind(ty).map(Rc::new)
+}
+
+/// Returns the `RsTypeKind` of a function parameter.
+///
+/// This is `rs_type_kind(ty)`, except that `const` references to bridge types
+/// are supported ("borrowed bridge types"): the Rust caller passes a `&` to the
+/// Rust value, and keeps ownership of it, instead of moving it into the call.
+/// Bridge types can't be referents anywhere else (e.g. in return types or
+/// fields), because that would require a Rust reference to the C++ value.
+fn param_rs_type_kind(db: &dyn BindingsGenerator, ty: &ir::RsType) -> Result<RsTypeKind> {
+    if ty.name.as_deref() == Some("&")
+        && ty.unknown_attr.is_none()
+        && ty.type_args.len() == 1
+        && ty.lifetime_args.len() == 1
+    {
+        if let Ok(referent) = db.shared_rs_type_kind(ty.type_args[0].clone()) {
+            if referent.is_bridge_type() {
+                let lifetime_id = ty.lifetime_args[0];
+                let lifetime = db
+                    .ir()
+                    .get_lifetime(lifetime_id)
+                    .ok_or_else(|| anyhow!("no known lifetime with id {lifetime_id:?}"))
+                    .map(Lifetime::from)?;
+                return Ok(RsTypeKind::Reference {
+                    referent,
+                    mutability: Mutability::Const,
+                    lifetime,
+                });
+            }
+        }
+    }
+    db.rs_type_kind(ty.clone())
+}
+
 fn new_type_alias(db: &dyn BindingsGenerator, type_alias: Rc<TypeAlias>) -> Result<RsTypeKind> {
     let ir = db.ir();
-    let underlying_type = Rc::new(db.rs_type_kind(type_alias.underlying_type.rs_type.clone())?);
+    let underlying_type = db.shared_rs_type_kind(type_alias.underlying_type.rs_type.clone())?;
     let crate_path = Rc::new(CratePath::new(
         &ir,
         ir.namespace_qualifier(&type_alias)?,
@@ -1431,21 +2220,48 @@ pub(crate) fn crate_root_path_tokens(ir: &IR) -> TokenStream {
     }
 }
 
+/// Returns true if `tokens` call one of the `crubit::*Thunk` function templates
+/// in `support/internal/special_member_thunks.h` (see `special_member_thunk`).
+fn uses_special_member_thunks(tokens: TokenStream) -> bool {
+    let tokens = tokens.into_iter().collect_vec();
+    tokens.iter().enumerate().any(|(i, tt)| match tt {
+        TokenTree::Group(group) => uses_special_member_thunks(group.stream()),
+        TokenTree::Ident(ident) if ident == "crubit" => matches!(
+            &tokens[i + 1..],
+            [TokenTree::Punct(colon1), TokenTree::Punct(colon2), TokenTree::Ident(name), ..]
+                if colon1.as_char() == ':' && colon2.as_char() == ':'
+                    && name.to_string().ends_with("Thunk")
+        ),
+        _ => false,
+    })
+}
+
 fn generate_rs_api_impl_includes(
     db: &Database,
     crubit_support_path_format: &str,
+    uses_special_member_thunks: bool,
 ) -> Result<TokenStream> {
     let ir = db.ir();
 
     let mut internal_includes = BTreeSet::new();
     internal_includes.insert(CcInclude::memory()); // ubiquitous.
-    if ir.records().next().is_some() {
+
+    // `std::size_t` is used by the thunks of `CRUBIT_INTERNAL_BATCH` functions.
+    if ir.records().next().is_some() || ir.functions().any(|func| func.has_batch_attribute) {
         internal_includes.insert(CcInclude::cstddef());
+    }
+    if ir.records().next().is_some() {
         internal_includes.insert(CcInclude::SupportLibHeader(
             crubit_support_path_format.into(),
             "internal/sizeof.h".into(),
         ));
     };
+    if uses_special_member_thunks {
+        internal_includes.insert(CcInclude::SupportLibHeader(
+            crubit_support_path_format.into(),
+            "internal/special_member_thunks.h".into(),
+        ));
+    }
 
     for record in ir.records() {
         if record.bridge_type_info.is_some() {
@@ -1455,6 +2271,12 @@ fn generate_rs_api_impl_includes(
             ));
         }
     }
+    if db.aggregate_layout_assertions() {
+        internal_includes.insert(CcInclude::SupportLibHeader(
+            crubit_support_path_format.into(),
+            "internal/check_layout.h".into(),
+        ));
+    }
     for crubit_header in ["internal/cxx20_backports.h", "internal/offsetof.h"] {
         internal_includes.insert(CcInclude::SupportLibHeader(
             crubit_support_path_format.into(),
@@ -1511,6 +2333,9 @@ pub(crate) mod tests {
             "crubit/rs_bindings_support",
             Rc::new(IgnoreErrors),
             SourceLocationDocComment::Enabled,
+            true,
+            false,
+            Rc::new(GenerationProfile::new(false)),
         )
     }
 
@@ -1519,6 +2344,9 @@ pub(crate) mod tests {
             Rc::new(ir_from_cc(cc_src)?),
             Rc::new(ErrorReport::new()),
             SourceLocationDocComment::Enabled,
+            true,
+            false,
+            Rc::new(GenerationProfile::new(false)),
         ))
     }
 
@@ -1965,6 +2793,85 @@ pub(crate) mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_generate_dense_enum() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"enum class [[clang::annotate("crubit_internal_dense_enum")]] Color {
+                 kGreen = 0, kRed = -1, kBlue = 1,
+               };"#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub struct Color(::core::ffi::c_int);
+                ...
+                #[derive(Debug, PartialEq, Eq, Copy, Clone, Hash, PartialOrd, Ord)]
+                pub enum ColorEnum {
+                    kRed = -1,
+                    kGreen = 0,
+                    kBlue = 1,
+                }
+                impl TryFrom<Color> for ColorEnum {
+                    type Error = Color;
+                    #[inline(always)]
+                    fn try_from(value: Color) -> Result<ColorEnum, Color> {
+                        const VARIANTS: [ColorEnum; 3] =
+                            [ColorEnum::kRed, ColorEnum::kGreen, ColorEnum::kBlue];
+                        if (-1..=1).contains(&value.0) {
+                            Ok(VARIANTS[(value.0 as i128 - -1) as usize])
+                        } else {
+                            Err(value)
+                        }
+                    }
+                }
+                impl From<ColorEnum> for Color {
+                    #[inline(always)]
+                    fn from(value: ColorEnum) -> Color {
+                        Color(value as ::core::ffi::c_int)
+                    }
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_generate_dense_enum_wider_than_half_of_underlying_type() -> Result<()> {
+        // `kMin` is -100, and each following enumerator is one more than the last.
+        let enumerators = (1..=200).map(|i| format!(", k{i}")).collect::<String>();
+        let ir = ir_from_cc(&format!(
+            r#"enum class [[clang::annotate("crubit_internal_dense_enum")]] Color : signed char {{
+                 kMin = -100 {enumerators}
+               }};"#
+        ))?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                if (-100..=100).contains(&value.0) {
+                    Ok(VARIANTS[(value.0 as i128 - -100) as usize])
+                } else {
+                    Err(value)
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_generate_dense_enum_with_gap() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"enum class [[clang::annotate("crubit_internal_dense_enum")]] Color {
+                 kRed = 0, kBlue = 2,
+               };"#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_not_matches!(rs_api, quote! { ColorEnum });
+        assert_rs_not_matches!(rs_api, quote! { pub struct Color });
+        Ok(())
+    }
+
     #[gtest]
     fn test_generate_opaque_enum() -> Result<()> {
         let ir = ir_from_cc("enum Color : int;")?;
@@ -2310,6 +3217,129 @@ pub(crate) mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_constants() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                enum Color { kRed, kGreen };
+                constexpr int kNegative = -42;
+                constexpr unsigned long long kLarge = 18446744073709551615ull;
+                constexpr bool kTrue = true;
+                constexpr Color kDefaultColor = kGreen;
+                struct S final {
+                  static const int kSize = 7;
+                };
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(rs_api, quote! { pub const kNegative: ::core::ffi::c_int = -42; });
+        assert_rs_matches!(
+            rs_api,
+            quote! { pub const kLarge: ::core::ffi::c_ulonglong = 18446744073709551615; }
+        );
+        assert_rs_matches!(rs_api, quote! { pub const kTrue: bool = true; });
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub const kDefaultColor: crate::Color = crate::Color::__crubit_from_underlying(1);
+            }
+        );
+        assert_rs_matches!(rs_api, quote! { pub const kSize: ::core::ffi::c_int = 7; });
+        // Constants don't need thunks.
+        assert_cc_not_matches!(rs_api_impl, quote! { kNegative });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_constants_in_other_namespaces() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                namespace colors {
+                  enum Color { kRed, kGreen };
+                }
+                namespace config {
+                  constexpr colors::Color kDefaultColor = colors::kGreen;
+                  struct S final {
+                    static const int kSize = 7;
+                  };
+                }
+            "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        // The enum's field is private to `colors`, so the constant uses its `const fn`.
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Color {
+                    #[doc(hidden)]
+                    pub const fn __crubit_from_underlying(value: ::core::ffi::c_uint) -> Color {
+                        Color(value)
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub const kDefaultColor: crate::colors::Color =
+                    crate::colors::Color::__crubit_from_underlying(1);
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl crate::config::S {
+                    pub const kSize: ::core::ffi::c_int = 7;
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_from_underlying_only_for_enums_used_by_constants() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                enum Color { kRed, kGreen };
+                enum Shape { kCircle, kSquare };
+                typedef Color ColorAlias;
+                constexpr ColorAlias kDefaultColor = kGreen;
+            "#,
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Color {
+                    #[doc(hidden)]
+                    pub const fn __crubit_from_underlying(value: ::core::ffi::c_uint) -> Color {
+                        Color(value)
+                    }
+                }
+            }
+        );
+        assert_rs_not_matches!(
+            rs_api,
+            quote! {
+                pub const fn __crubit_from_underlying(value: ::core::ffi::c_uint) -> Shape
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_constant_of_enum_from_other_target() -> Result<()> {
+        let ir = ir_from_cc_dependency(
+            "constexpr Color kDefaultColor = kGreen;",
+            "enum Color { kRed, kGreen };",
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        // The bindings of the dependency don't know about this constant, so they don't
+        // provide `__crubit_from_underlying` for it.
+        assert_rs_not_matches!(rs_api, quote! { pub const kDefaultColor });
+        Ok(())
+    }
+
     #[gtest]
     fn test_type_alias() -> Result<()> {
         let ir = ir_from_cc(
@@ -2538,6 +3568,33 @@ pub(crate) mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_rs_type_kind_shares_nested_types() -> Result<()> {
+        let db = db_from_cc(
+            "#pragma clang lifetime_elision
+            struct SomeStruct {};
+            void foo(const SomeStruct& a, const SomeStruct* b, SomeStruct* c);",
+        )?;
+        let ir = db.ir();
+        let func = retrieve_func(&ir, "foo");
+        let a = db.rs_type_kind(func.params[0].type_.rs_type.clone())?;
+        let b = db.rs_type_kind(func.params[1].type_.rs_type.clone())?;
+        let c = db.rs_type_kind(func.params[2].type_.rs_type.clone())?;
+
+        let RsTypeKind::Reference { referent: a_referent, .. } = &a else { panic!("{a:?}") };
+        let RsTypeKind::Option(b_inner) = &b else { panic!("{b:?}") };
+        let RsTypeKind::Reference { referent: b_referent, .. } = &**b_inner else {
+            panic!("{b:?}")
+        };
+        let RsTypeKind::Option(c_inner) = &c else { panic!("{c:?}") };
+        let RsTypeKind::Reference { referent: c_referent, .. } = &**c_inner else {
+            panic!("{c:?}")
+        };
+        assert!(Rc::ptr_eq(a_referent, b_referent));
+        assert!(Rc::ptr_eq(a_referent, c_referent));
+        Ok(())
+    }
+
     #[gtest]
     fn test_rs_type_kind_lifetimes() -> Result<()> {
         let db = db_from_cc(
@@ -2686,6 +3743,155 @@ pub(crate) mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_split_top_level_modules() -> Result<()> {
+        let rs_api = generate_bindings_tokens(ir_from_cc(
+            r#"
+            namespace test_namespace_bindings {
+                int func();
+                namespace inner {
+                    int inner_func();
+                }
+            }
+            int top_level_func();
+        "#,
+        )?)?
+        .rs_api;
+        let (crate_root, modules) = split_top_level_modules(rs_api, "modules");
+        assert_rs_matches!(
+            crate_root,
+            quote! {
+                #[path = "modules/test_namespace_bindings.rs"]
+                pub mod test_namespace_bindings;
+            }
+        );
+        assert_rs_matches!(
+            crate_root,
+            quote! { pub fn top_level_func() -> ::core::ffi::c_int { ... } }
+        );
+        assert_rs_not_matches!(crate_root, quote! { pub fn func });
+        assert_eq!(modules.len(), 1);
+        let (name, module) = modules.into_iter().next().unwrap();
+        assert_eq!(name, "test_namespace_bindings");
+        assert_rs_matches!(
+            module,
+            quote! {
+                pub fn func() -> ::core::ffi::c_int { ... }
+                ...
+                pub mod inner {
+                    ...
+                    pub fn inner_func() -> ::core::ffi::c_int { ... }
+                    ...
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_split_cc_top_level_decls() {
+        let decls = split_cc_top_level_decls(quote! {
+            static_assert(sizeof(S) == 4); __NEWLINE__
+            struct T { int x; }; __NEWLINE__
+            extern "C" void f() { g(); } __NEWLINE__
+        });
+        let decls = decls.iter().map(|decl| decl.to_string()).collect::<Vec<_>>();
+        assert_eq!(
+            decls,
+            vec![
+                quote! { static_assert(sizeof(S) == 4); }.to_string(),
+                quote! { __NEWLINE__ struct T { int x; }; }.to_string(),
+                quote! { __NEWLINE__ extern "C" void f() { g(); } }.to_string(),
+                quote! { __NEWLINE__ }.to_string(),
+            ]
+        );
+    }
+
+    #[gtest]
+    fn test_aggregated_layout_assertions() -> Result<()> {
+        let ir = ir_from_cc("struct S { int field; };")?;
+        let (BindingsTokens { rs_api, rs_api_impl }, _) = generate_sharded_bindings_tokens(
+            Rc::new(ir),
+            "crubit/rs_bindings_support",
+            Rc::new(IgnoreErrors),
+            SourceLocationDocComment::Enabled,
+            true,
+            true,
+            1,
+            Rc::new(GenerationProfile::new(false)),
+        )?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                const _: () = {
+                    ...
+                    let layout: &[(usize, usize, &str)] = &[
+                        (::core::mem::size_of::<crate::S>(), 4, "crate::S"),
+                        (::core::mem::align_of::<crate::S>(), 4, "crate::S"),
+                        (::core::mem::offset_of!(crate::S, field), 0, "crate::S"),
+                    ];
+                    ...
+                    assert!(layout[i].0 == layout[i].1, "{}", layout[i].2);
+                    ...
+                };
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { ::core::mem::size_of::<crate::S>() == 4 });
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                static_assert(
+                    ::crubit::details::FindLayoutMismatch({
+                        {CRUBIT_SIZEOF(struct S), 4},
+                        {alignof(struct S), 4},
+                        {CRUBIT_OFFSET_OF(field, struct S), 0},
+                    }) == -1
+                );
+            }
+        );
+        assert_cc_not_matches!(rs_api_impl, quote! { CRUBIT_SIZEOF(struct S) == 4 });
+        Ok(())
+    }
+
+    #[gtest]
+    fn test_sharded_bindings_tokens() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+            inline int f1() { return 1; }
+            inline int f2() { return 2; }
+            inline int f3() { return 3; }
+            inline int f4() { return 4; }
+        "#,
+        )?;
+        let (BindingsTokens { rs_api_impl, .. }, other_shards) = generate_sharded_bindings_tokens(
+            Rc::new(ir),
+            "crubit/rs_bindings_support",
+            Rc::new(IgnoreErrors),
+            SourceLocationDocComment::Enabled,
+            true,
+            false,
+            2,
+            Rc::new(GenerationProfile::new(false)),
+        )?;
+        assert_eq!(other_shards.len(), 1);
+        let shards = [rs_api_impl, other_shards.into_iter().next().unwrap()];
+        for shard in &shards {
+            assert_cc_matches!(
+                shard.clone(),
+                quote! {
+                    __HASH_TOKEN__ pragma clang diagnostic push
+                    ...
+                    __HASH_TOKEN__ pragma clang diagnostic pop
+                }
+            );
+        }
+        assert_cc_matches!(shards[0].clone(), quote! { __rust_thunk___Z2f1v });
+        assert_cc_not_matches!(shards[0].clone(), quote! { __rust_thunk___Z2f4v });
+        assert_cc_matches!(shards[1].clone(), quote! { __rust_thunk___Z2f4v });
+        assert_cc_not_matches!(shards[1].clone(), quote! { __rust_thunk___Z2f1v });
+        Ok(())
+    }
+
     #[gtest]
     fn test_detail_outside_of_namespace_module() -> Result<()> {
         let rs_api = generate_bindings_tokens(ir_from_cc(
@@ -2991,6 +4197,9 @@ pub(crate) mod tests {
             Rc::new(make_ir_from_items([])),
             Rc::new(ErrorReport::new()),
             SourceLocationDocComment::Enabled,
+            true,
+            false,
+            Rc::new(GenerationProfile::new(false)),
         );
         let actual = generate_unsupported(
             &db,
@@ -3014,6 +4223,9 @@ pub(crate) mod tests {
             Rc::new(make_ir_from_items([])),
             Rc::new(ErrorReport::new()),
             SourceLocationDocComment::Enabled,
+            true,
+            false,
+            Rc::new(GenerationProfile::new(false)),
         );
         let actual = generate_unsupported(
             &db,
@@ -3028,12 +4240,38 @@ pub(crate) mod tests {
         Ok(())
     }
 
+    #[gtest]
+    fn test_generate_unsupported_item_without_comments() -> Result<()> {
+        let db = Database::new(
+            Rc::new(make_ir_from_items([])),
+            Rc::new(ErrorReport::new()),
+            SourceLocationDocComment::Enabled,
+            false,
+            false,
+            Rc::new(GenerationProfile::new(false)),
+        );
+        let actual = generate_unsupported(
+            &db,
+            &UnsupportedItem::new_with_static_message(
+                &db.ir(),
+                &TestItem { source_loc: Some("Generated from: google3/some/header;l=1".into()) },
+                "unsupported_message",
+            ),
+        )?;
+        assert!(actual.item.is_empty());
+        assert_that!(db.errors().serialize_to_string()?, contains_substring("unsupported_message"));
+        Ok(())
+    }
+
     #[gtest]
     fn test_generate_unsupported_item_with_source_loc_disabled() -> Result<()> {
         let db = Database::new(
             Rc::new(make_ir_from_items([])),
             Rc::new(ErrorReport::new()),
             SourceLocationDocComment::Disabled,
+            true,
+            false,
+            Rc::new(GenerationProfile::new(false)),
         );
         let actual = generate_unsupported(
             &db,
@@ -468,6 +468,16 @@ impl RsTypeKind {
         matches!(self, RsTypeKind::BridgeType { .. })
     }
 
+    /// Returns true if this is a `const` reference to a bridge type, which is
+    /// only supported for function parameters.
+    pub fn is_borrowed_bridge_type(&self) -> bool {
+        matches!(
+            self,
+            RsTypeKind::Reference { referent, mutability: Mutability::Const, .. }
+                if referent.is_bridge_type()
+        )
+    }
+
     pub fn is_primitive(&self) -> bool {
         matches!(self, RsTypeKind::Primitive { .. })
     }
@@ -589,10 +599,23 @@ impl RsTypeKind {
 
     /// Returns true if the type can be passed by value through `extern "C"` ABI
     /// thunks.
-    pub fn is_c_abi_compatible_by_value(&self) -> bool {
+    pub fn is_c_abi_compatible_by_value(&self, db: &dyn BindingsGenerator) -> bool {
+        self.is_c_abi_compatible_by_value_impl(Some(db))
+    }
+
+    /// Like `is_c_abi_compatible_by_value`, but returns false for all records,
+    /// because whether they are compatible depends on the types of their fields.
+    ///
+    /// This is used while computing the `RsTypeKind` of function pointers, which
+    /// may be the type of a field of a record that they take by value.
+    pub fn is_c_abi_compatible_by_value_ignoring_fields(&self) -> bool {
+        self.is_c_abi_compatible_by_value_impl(None)
+    }
+
+    fn is_c_abi_compatible_by_value_impl(&self, db: Option<&dyn BindingsGenerator>) -> bool {
         match self {
             RsTypeKind::TypeAlias { underlying_type, .. } => {
-                underlying_type.is_c_abi_compatible_by_value()
+                underlying_type.is_c_abi_compatible_by_value_impl(db)
             }
             RsTypeKind::IncompleteRecord { .. } => {
                 // Incomplete record (forward declaration) as parameter type or return type is
@@ -605,10 +628,11 @@ impl RsTypeKind {
             // `rs_bindings_from_cc` can change the type of fields (e.g. using a blob of bytes for
             // unsupported field types, or for no_unique_address fields).  Changing the type
             // of fields may change the ABI, which means that we can no longer assume
-            // that `extern "C"` ABI thunks can pass such types by value.
-            //
-            // TODO(b/274177296): Return `true` for structs where bindings replicate the type of
-            // all the fields.
+            // that `extern "C"` ABI thunks can pass such types by value, unless the bindings
+            // replicate the type of all the fields.
+            RsTypeKind::Record { record, known_generic_monomorphization: None, .. } => {
+                db.is_some_and(|db| db.is_record_c_abi_compatible_by_value(record.clone()))
+            }
             RsTypeKind::Record { .. } => false,
             RsTypeKind::BridgeType { .. } => false,
             RsTypeKind::Other { is_same_abi, .. } => *is_same_abi,
@@ -7,16 +7,19 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/status_macros.h"
 #include "rs_bindings_from_cc/cmdline.h"
 #include "rs_bindings_from_cc/collect_instantiations.h"
 #include "rs_bindings_from_cc/collect_namespaces.h"
+#include "rs_bindings_from_cc/filter_demanded_items.h"
 #include "rs_bindings_from_cc/ir.h"
 #include "rs_bindings_from_cc/ir_from_cc.h"
 #include "rs_bindings_from_cc/src_code_gen.h"
@@ -35,22 +38,31 @@ std::optional<const Namespace*> FindNamespace(const IR& ir,
 
 std::vector<const Record*> FindInstantiationsInNamespace(const IR& ir,
                                                          ItemId namespace_id) {
-  absl::flat_hash_set<ItemId> record_ids;
-  for (const auto* type_alias : ir.get_items_if<TypeAlias>()) {
-    if (type_alias->enclosing_item_id == namespace_id) {
+  // A single pass over the items, which finds both the aliases in the
+  // namespace and the records they may refer to.
+  std::vector<ItemId> record_ids;
+  absl::flat_hash_map<ItemId, const Record*> records_by_id;
+  for (const auto& item : ir.items) {
+    if (const auto* record = std::get_if<Record>(&item)) {
+      records_by_id.insert({record->id, record});
+    } else if (const auto* type_alias = std::get_if<TypeAlias>(&item);
+               type_alias != nullptr &&
+               type_alias->enclosing_item_id == namespace_id) {
       const MappedType* mapped_type = &type_alias->underlying_type;
       CHECK(mapped_type->cpp_type.decl_id.has_value());
       CHECK(mapped_type->rs_type.decl_id.has_value());
       CHECK(mapped_type->cpp_type.decl_id.value() ==
             mapped_type->rs_type.decl_id.value());
-      record_ids.insert(mapped_type->rs_type.decl_id.value());
+      record_ids.push_back(mapped_type->rs_type.decl_id.value());
     }
   }
 
   std::vector<const Record*> result;
-  for (const auto* record : ir.get_items_if<Record>()) {
-    if (record_ids.find(record->id) != record_ids.end()) {
-      result.push_back(record);
+  absl::flat_hash_set<ItemId> seen_record_ids;
+  for (ItemId record_id : record_ids) {
+    auto it = records_by_id.find(record_id);
+    if (it != records_by_id.end() && seen_record_ids.insert(record_id).second) {
+      result.push_back(it->second);
     }
   }
   return result;
@@ -59,39 +71,83 @@ std::vector<const Record*> FindInstantiationsInNamespace(const IR& ir,
 absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
     Cmdline& cmdline, std::vector<std::string> clang_args,
     absl::flat_hash_map<HeaderName, std::string>
-        virtual_headers_contents_for_testing) {
+        virtual_headers_contents_for_testing,
+    bool write_rs_and_cc_out, TimingReport* timing_report) {
   std::vector<absl::string_view> clang_args_view;
   clang_args_view.insert(clang_args_view.end(), clang_args.begin(),
                          clang_args.end());
   const CmdlineArgs& args = cmdline.args();
 
-  CRUBIT_ASSIGN_OR_RETURN(
-      std::vector<std::string> requested_instantiations,
-      CollectInstantiations(args.srcs_to_scan_for_instantiations));
-
-  CRUBIT_ASSIGN_OR_RETURN(
-      IR ir, IrFromCc(IrFromCcOptions{
-                 .current_target = args.current_target,
-                 .public_headers = args.public_headers,
-                 .virtual_headers_contents_for_testing =
-                     std::move(virtual_headers_contents_for_testing),
-                 .headers_to_targets = args.headers_to_targets,
-                 .extra_rs_srcs = args.extra_rs_srcs,
-                 .clang_args = clang_args_view,
-                 .extra_instantiations = requested_instantiations,
-                 .crubit_features = args.target_to_features}));
+  std::vector<std::string> requested_instantiations;
+  {
+    TimingReport::ScopedPhase phase(timing_report, "collect_instantiations");
+    CRUBIT_ASSIGN_OR_RETURN(
+        requested_instantiations,
+        CollectInstantiations(args.srcs_to_scan_for_instantiations,
+                              args.bindings_cache_dir));
+  }
+
+  IR ir;
+  {
+    TimingReport::ScopedPhase phase(timing_report, "ir_from_cc");
+    CRUBIT_ASSIGN_OR_RETURN(
+        ir, IrFromCc(IrFromCcOptions{
+                .current_target = args.current_target,
+                .public_headers = args.public_headers,
+                .virtual_headers_contents_for_testing =
+                    std::move(virtual_headers_contents_for_testing),
+                .headers_to_targets = args.headers_to_targets,
+                .extra_rs_srcs = args.extra_rs_srcs,
+                .clang_args = clang_args_view,
+                .extra_instantiations = requested_instantiations,
+                .crubit_features = args.target_to_features,
+                .import_dependencies_lazily = args.import_dependencies_lazily,
+                .lean_bindings = args.lean_bindings,
+                .timing_report = timing_report}));
+  }
+
+  if (!args.demand_list.empty()) {
+    TimingReport::ScopedPhase phase(timing_report, "filter_demanded_items");
+    CRUBIT_ASSIGN_OR_RETURN(absl::flat_hash_set<std::string> demanded_names,
+                            ReadDemandList(args.demand_list));
+    FilterDemandedItems(ir, demanded_names);
+  }
 
   if (!args.instantiations_out.empty()) {
     ir.crate_root_path = "__cc_template_instantiations_rs_api";
   }
 
   bool generate_error_report = !args.error_report_out.empty();
-  CRUBIT_ASSIGN_OR_RETURN(
-      Bindings bindings,
-      GenerateBindings(ir, args.crubit_support_path_format,
-                       args.clang_format_exe_path, args.rustfmt_exe_path,
-                       args.rustfmt_config_path, generate_error_report,
-                       args.generate_source_location_in_doc_comment));
+  bool generate_cost_report = !args.cost_report_out.empty();
+  Bindings bindings;
+  {
+    TimingReport::ScopedPhase phase(timing_report, "generate_bindings");
+    CRUBIT_ASSIGN_OR_RETURN(
+        bindings,
+        GenerateBindings(ir, args.crubit_support_path_format,
+                         args.clang_format_exe_path, args.rustfmt_exe_path,
+                         args.rustfmt_config_path, generate_error_report,
+                         args.lean_bindings
+                             ? SourceLocationDocComment::Disabled
+                             : args.generate_source_location_in_doc_comment,
+                         args.bindings_cache_dir,
+                         args.generated_code_formatting,
+                         write_rs_and_cc_out ? args.rs_out : "",
+                         write_rs_and_cc_out ? args.cc_out : "",
+                         /*generate_timing_report=*/timing_report != nullptr,
+                         args.generate_unsupported_item_comments,
+                         write_rs_and_cc_out ? args.rs_out_modules_dir : "",
+                         write_rs_and_cc_out
+                             ? absl::Span<const std::string>(args.cc_out_shards)
+                             : absl::Span<const std::string>(),
+                         args.aggregate_layout_assertions,
+                         /*generate_api_hash=*/!args.api_hash_out.empty(),
+                         generate_cost_report));
+    if (timing_report != nullptr) {
+      CRUBIT_RETURN_IF_ERROR(
+          timing_report->AddGeneratorReport(bindings.timing_report.view()));
+    }
+  }
 
   absl::flat_hash_map<std::string, std::string> instantiations;
   std::optional<const Namespace*> ns =
@@ -107,12 +163,14 @@ absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
   auto top_level_namespaces = crubit::CollectNamespaces(ir);
 
   return BindingsAndMetadata{
-      .ir = ir,
-      .rs_api = bindings.rs_api,
-      .rs_api_impl = bindings.rs_api_impl,
+      .ir = std::move(ir),
+      .rs_api = std::move(bindings.rs_api),
+      .rs_api_impl = std::move(bindings.rs_api_impl),
       .namespaces = std::move(top_level_namespaces),
       .instantiations = std::move(instantiations),
-      .error_report = bindings.error_report,
+      .error_report = std::move(bindings.error_report),
+      .api_hash = std::move(bindings.api_hash),
+      .cost_report = std::move(bindings.cost_report),
   };
 }
 
@@ -10,9 +10,11 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "common/ffi_types.h"
 #include "rs_bindings_from_cc/cmdline.h"
 #include "rs_bindings_from_cc/collect_namespaces.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/timing_report.h"
 
 namespace crubit {
 // Contains generated bindings and all related metadata, such as the IR.
@@ -21,23 +23,36 @@ struct BindingsAndMetadata {
   // bindings.
   IR ir;
   // Generated Rust source code.
-  std::string rs_api;
+  UniqueFfiU8SliceBox rs_api;
   // Generated C++ source code.
-  std::string rs_api_impl;
+  UniqueFfiU8SliceBox rs_api_impl;
   // A hierarchy tree for all C++ namespaces used in the target.
   NamespacesHierarchy namespaces;
   // C++ class templates explicitly instantiated in this TU and their Rust
   // struct name.
   absl::flat_hash_map<std::string, std::string> instantiations;
   // A JSON error report, if requested.
-  std::string error_report;
+  UniqueFfiU8SliceBox error_report;
+  // A hash of the API of the generated Rust source code, if requested.
+  UniqueFfiU8SliceBox api_hash;
+  // A JSON report of the cost of each item, if requested.
+  UniqueFfiU8SliceBox cost_report;
 };
 
 // Returns `BindingsAndMetadata` as requested by the user on the command line.
+//
+// If `write_rs_and_cc_out` is true, the generated source code is written
+// directly to `--rs_out` (and `--rs_out_modules_dir`, if specified) and
+// `--cc_out` (and `--cc_out_shards`), and `BindingsAndMetadata::rs_api` and
+// `BindingsAndMetadata::rs_api_impl` are left empty.
+//
+// If `timing_report` is not null, the phases of bindings generation are
+// recorded in it.
 absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
     Cmdline& cmdline, std::vector<std::string> clang_args,
     absl::flat_hash_map<HeaderName, std::string>
-        virtual_headers_contents_for_testing = {});
+        virtual_headers_contents_for_testing = {},
+    bool write_rs_and_cc_out = false, TimingReport* timing_report = nullptr);
 
 }  // namespace crubit
 
@@ -68,7 +68,7 @@ TEST(GenerateBindingsAndMetadataTest, GeneratingIR) {
 
   ASSERT_EQ(result.ir.public_headers.size(), 1);
   ASSERT_EQ(result.ir.public_headers.front().IncludePath(), "a.h");
-  ASSERT_EQ(result.error_report, "");
+  ASSERT_EQ(result.error_report.view(), "");
 
   // Check that IR items have the proper owning target set.
   auto item = result.ir.get_items_if<Namespace>().front();
@@ -216,38 +216,14 @@ TEST(GenerateBindingsAndMetadataTest, NamespacesJsonGenerated) {
 
     namespace top_level_1 {}
   )";
-  constexpr absl::string_view kExpected = R"({
-  "label": "//:target",
-  "namespaces": [
-    {
-      "children": [
-        {
-          "children": [
-            {
-              "children": [],
-              "name": "inner_1"
-            },
-            {
-              "children": [],
-              "name": "inner_2"
-            }
-          ],
-          "name": "middle"
-        }
-      ],
-      "name": "top_level_1"
-    },
-    {
-      "children": [
-        {
-          "children": [],
-          "name": "inner_3"
-        }
-      ],
-      "name": "top_level_2"
-    }
-  ]
-})";
+  // `NamespacesAsJson` produces compact JSON.
+  constexpr absl::string_view kExpected =
+      R"({"label":"//:target","namespaces":[)"
+      R"({"children":[{"children":[{"children":[],"name":"inner_1"},)"
+      R"({"children":[],"name":"inner_2"}],"name":"middle"}],)"
+      R"("name":"top_level_1"},)"
+      R"({"children":[{"children":[],"name":"inner_3"}],)"
+      R"("name":"top_level_2"}]})";
 
   Cmdline cmdline = MakeCmdline("a.h");
   ASSERT_OK_AND_ASSIGN(BindingsAndMetadata result,
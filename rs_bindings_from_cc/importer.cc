@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 #include <map>
@@ -30,6 +31,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "common/annotation_reader.h"
 #include "common/status_macros.h"
 #include "lifetime_annotations/type_lifetimes.h"
 #include "rs_bindings_from_cc/ast_util.h"
@@ -54,6 +56,7 @@
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/Specifiers.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -222,46 +225,23 @@ static int GetDeclOrder(const clang::Decl* decl) {
 class Importer::SourceOrderKey {
  public:
   explicit SourceOrderKey(clang::SourceRange source_range, int decl_order = 0,
-                          std::string name = "")
-      : source_range_(source_range), decl_order_(decl_order), name_(name) {}
+                          const clang::Decl* decl = nullptr)
+      : source_range(source_range), decl_order(decl_order), decl(decl) {}
 
   SourceOrderKey(const SourceOrderKey&) = default;
   SourceOrderKey& operator=(const SourceOrderKey&) = default;
 
-  bool isBefore(const SourceOrderKey& other,
-                const clang::SourceManager& sm) const {
-    if (!source_range_.isValid() || !other.source_range_.isValid()) {
-      if (source_range_.isValid() != other.source_range_.isValid())
-        return !source_range_.isValid() && other.source_range_.isValid();
-    } else {
-      if (source_range_.getBegin() != other.source_range_.getBegin()) {
-        return sm.isBeforeInTranslationUnit(source_range_.getBegin(),
-                                            other.source_range_.getBegin());
-      }
-      if (source_range_.getEnd() != other.source_range_.getEnd()) {
-        return sm.isBeforeInTranslationUnit(source_range_.getEnd(),
-                                            other.source_range_.getEnd());
-      }
-    }
-
-    if (decl_order_ < other.decl_order_) {
-      return true;
-    } else if (decl_order_ > other.decl_order_) {
-      return false;
-    }
-    return name_ < other.name_;
-  }
-
- private:
-  clang::SourceRange source_range_;
-  int decl_order_;
-  std::string name_;
+  clang::SourceRange source_range;
+  int decl_order;
+  // The decl whose `GetNameForSourceOrder` breaks ties between items with the
+  // same source range and decl order, if any. The name is only computed for
+  // such ties (see `SortInSourceOrder`).
+  const clang::Decl* decl;
 };
 
 Importer::SourceOrderKey Importer::GetSourceOrderKey(
     const clang::Decl* decl) const {
-  return SourceOrderKey(decl->getSourceRange(), GetDeclOrder(decl),
-                        GetNameForSourceOrder(decl));
+  return SourceOrderKey(decl->getSourceRange(), GetDeclOrder(decl), decl);
 }
 
 Importer::SourceOrderKey Importer::GetSourceOrderKey(
@@ -269,6 +249,89 @@ Importer::SourceOrderKey Importer::GetSourceOrderKey(
   return SourceOrderKey(comment->getSourceRange());
 }
 
+template <typename T>
+void Importer::SortInSourceOrder(
+    std::vector<std::pair<SourceOrderKey, T>>& items) const {
+  const clang::SourceManager& sm = ctx_.getSourceManager();
+
+  // Rank the distinct source locations once, so that the items themselves are
+  // sorted on integers. Locations in the same file are ordered by their
+  // offset, only locations in different files need the (comparatively
+  // expensive) `isBeforeInTranslationUnit`.
+  std::vector<std::pair<clang::FileID, unsigned>> locations;
+  locations.reserve(2 * items.size());
+  for (const auto& [key, _] : items) {
+    if (!key.source_range.isValid()) continue;
+    locations.push_back(sm.getDecomposedLoc(key.source_range.getBegin()));
+    locations.push_back(sm.getDecomposedLoc(key.source_range.getEnd()));
+  }
+  llvm::sort(locations, [&sm](const std::pair<clang::FileID, unsigned>& a,
+                              const std::pair<clang::FileID, unsigned>& b) {
+    if (a.first == b.first) return a.second < b.second;
+    return sm.isBeforeInTranslationUnit(
+        sm.getComposedLoc(a.first, a.second),
+        sm.getComposedLoc(b.first, b.second));
+  });
+  locations.erase(std::unique(locations.begin(), locations.end()),
+                  locations.end());
+  llvm::DenseMap<clang::SourceLocation, int> location_ranks;
+  location_ranks.reserve(locations.size());
+  for (size_t rank = 0; rank < locations.size(); ++rank) {
+    location_ranks.try_emplace(
+        sm.getComposedLoc(locations[rank].first, locations[rank].second),
+        static_cast<int>(rank));
+  }
+
+  // Items with an invalid source range go first.
+  std::vector<std::tuple<int, int, int, size_t>> order;
+  order.reserve(items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    const SourceOrderKey& key = items[i].first;
+    int begin = -1;
+    int end = -1;
+    if (key.source_range.isValid()) {
+      begin = location_ranks.lookup(key.source_range.getBegin());
+      end = location_ranks.lookup(key.source_range.getEnd());
+    }
+    order.push_back({begin, end, key.decl_order, i});
+  }
+  llvm::sort(order);
+
+  // Break the remaining ties by name. These are rare, except for the members
+  // of implicit class template specializations, which all have the same source
+  // location.
+  for (auto run_begin = order.begin(); run_begin != order.end();) {
+    auto run_end = std::find_if(run_begin, order.end(), [&](const auto& o) {
+      return std::tie(std::get<0>(o), std::get<1>(o), std::get<2>(o)) !=
+             std::tie(std::get<0>(*run_begin), std::get<1>(*run_begin),
+                      std::get<2>(*run_begin));
+    });
+    if (run_end - run_begin > 1) {
+      std::vector<std::pair<std::string, size_t>> names;
+      names.reserve(run_end - run_begin);
+      for (auto it = run_begin; it != run_end; ++it) {
+        const SourceOrderKey& key = items[std::get<3>(*it)].first;
+        names.push_back({key.decl == nullptr
+                             ? std::string()
+                             : GetNameForSourceOrder(key.decl),
+                         std::get<3>(*it)});
+      }
+      llvm::sort(names);
+      for (size_t i = 0; i < names.size(); ++i) {
+        std::get<3>(run_begin[i]) = names[i].second;
+      }
+    }
+    run_begin = run_end;
+  }
+
+  std::vector<std::pair<SourceOrderKey, T>> sorted_items;
+  sorted_items.reserve(items.size());
+  for (const auto& o : order) {
+    sorted_items.push_back(std::move(items[std::get<3>(o)]));
+  }
+  items = std::move(sorted_items);
+}
+
 class Importer::SourceLocationComparator {
  public:
   bool operator()(const clang::SourceLocation& a,
@@ -288,15 +351,6 @@ class Importer::SourceLocationComparator {
     return this->operator()(a->getBeginLoc(), b->getBeginLoc());
   }
 
-  using OrderedItemId = std::pair<SourceOrderKey, ItemId>;
-  using OrderedItem = std::pair<SourceOrderKey, IR::Item>;
-
-  template <typename OrderedItemOrId>
-  bool operator()(const OrderedItemOrId& a, const OrderedItemOrId& b) const {
-    auto a_source_order = a.first;
-    auto b_source_order = b.first;
-    return a_source_order.isBefore(b_source_order, sm_);
-  }
   explicit SourceLocationComparator(const clang::SourceManager& sm) : sm_(sm) {}
 
  private:
@@ -343,6 +397,10 @@ const clang::Decl* Importer::CanonicalizeDecl(const clang::Decl* decl) const {
     if (cxx_record_decl->isInjectedClassName()) {
       return nullptr;
     }
+    if (auto it = canonical_record_decls_.find(decl);
+        it != canonical_record_decls_.end()) {
+      return it->second;
+    }
     auto owning_target = GetOwningTarget(decl);
     const auto& source_manager = sema_.getSourceManager();
     clang::Decl* canonical = nullptr;
@@ -371,6 +429,12 @@ const clang::Decl* Importer::CanonicalizeDecl(const clang::Decl* decl) const {
       }
     }
     CHECK(canonical != nullptr);
+    // Until the record is defined (e.g. before a class template specialization
+    // is instantiated), the choice of the canonical decl may still change.
+    if (llvm::cast<clang::CXXRecordDecl>(canonical)
+            ->isThisDeclarationADefinition()) {
+      canonical_record_decls_.try_emplace(decl, canonical);
+    }
     return canonical;
   }
   return decl->getCanonicalDecl();
@@ -429,7 +493,7 @@ absl::StatusOr<std::optional<ItemId>> Importer::GetEnclosingItemId(
 std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
     clang::Decl* parent_decl) {
   clang::SourceManager& sm = ctx_.getSourceManager();
-  std::vector<SourceLocationComparator::OrderedItemId> items;
+  std::vector<std::pair<SourceOrderKey, ItemId>> items;
   auto compare_locations = SourceLocationComparator(sm);
 
   // We are only interested in comments within this decl context.
@@ -451,7 +515,8 @@ std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
 
   auto* decl_context = clang::cast<clang::DeclContext>(parent_decl);
   for (auto decl : GetCanonicalChildren(decl_context)) {
-    auto item = GetDeclItem(decl);
+    auto item =
+        ShouldImportUpfront(decl) ? GetDeclItem(decl) : GetImportedItem(decl);
     // We generated IR for top level items coming from different targets,
     // however we shouldn't generate bindings for them, so we don't add them
     // to ir.top_level_item_ids.
@@ -481,7 +546,7 @@ std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
   for (auto& [_, comment] : ordered_comments) {
     items.push_back({GetSourceOrderKey(comment), GenerateItemId(comment)});
   }
-  llvm::sort(items, compare_locations);
+  SortInSourceOrder(items);
 
   std::vector<ItemId> ordered_item_ids;
   ordered_item_ids.reserve(items.size());
@@ -493,15 +558,13 @@ std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
 
 std::vector<ItemId> Importer::GetOrderedItemIdsOfTemplateInstantiations()
     const {
-  std::vector<SourceLocationComparator::OrderedItemId> items;
+  std::vector<std::pair<SourceOrderKey, ItemId>> items;
   items.reserve(class_template_instantiations_.size());
   for (const auto* decl : class_template_instantiations_) {
     items.push_back({GetSourceOrderKey(decl), GenerateItemId(decl)});
   }
 
-  clang::SourceManager& sm = ctx_.getSourceManager();
-  auto compare_locations = SourceLocationComparator(sm);
-  llvm::sort(items, compare_locations);
+  SortInSourceOrder(items);
 
   std::vector<ItemId> ordered_item_ids;
   ordered_item_ids.reserve(items.size());
@@ -512,6 +575,7 @@ std::vector<ItemId> Importer::GetOrderedItemIdsOfTemplateInstantiations()
 }
 
 void Importer::ImportFreeComments() {
+  if (invocation_.lean_bindings_) return;
   clang::SourceManager& sm = ctx_.getSourceManager();
   for (const auto& header : invocation_.public_headers_) {
     if (auto file = sm.getFileManager().getFileRef(header.IncludePath())) {
@@ -529,7 +593,7 @@ void Importer::ImportFreeComments() {
 void Importer::Import(clang::TranslationUnitDecl* translation_unit_decl) {
   ImportFreeComments();
   clang::SourceManager& sm = ctx_.getSourceManager();
-  std::vector<SourceLocationComparator::OrderedItem> ordered_items;
+  std::vector<std::pair<SourceOrderKey, IR::Item>> ordered_items;
 
   ordered_items.reserve(comments_.size());
   for (auto& comment : comments_) {
@@ -547,7 +611,7 @@ void Importer::Import(clang::TranslationUnitDecl* translation_unit_decl) {
     ordered_items.push_back({GetSourceOrderKey(decl), *item});
   }
 
-  llvm::sort(ordered_items, SourceLocationComparator(sm));
+  SortInSourceOrder(ordered_items);
 
   invocation_.ir_.items.reserve(ordered_items.size());
   for (auto& ordered_item : ordered_items) {
@@ -565,10 +629,28 @@ void Importer::Import(clang::TranslationUnitDecl* translation_unit_decl) {
 void Importer::ImportDeclsFromDeclContext(
     const clang::DeclContext* decl_context) {
   for (auto decl : GetCanonicalChildren(decl_context)) {
-    GetDeclItem(decl);
+    if (ShouldImportUpfront(decl)) {
+      GetDeclItem(decl);
+    }
   }
 }
 
+bool Importer::ShouldImportUpfront(const clang::Decl* decl) const {
+  return !invocation_.import_dependencies_lazily_ ||
+         clang::isa<clang::NamespaceDecl>(decl) || IsFromCurrentTarget(decl);
+}
+
+bool Importer::EnsureImportedIfLazy(clang::NamedDecl* decl) {
+  // Class template specializations are never imported upfront (see
+  // `GetCanonicalChildren`), so there is nothing to catch up on for them.
+  if (invocation_.import_dependencies_lazily_ &&
+      !clang::isa<clang::ClassTemplateSpecializationDecl>(decl) &&
+      !IsFromCurrentTarget(decl)) {
+    return EnsureSuccessfullyImported(decl);
+  }
+  return HasBeenAlreadySuccessfullyImported(decl);
+}
+
 std::optional<IR::Item> Importer::GetDeclItem(clang::Decl* decl) {
   // TODO(jeanpierreda): Move `decl->getCanonicalDecl()` from callers into here.
   if (auto it = import_cache_.find(decl); it != import_cache_.end()) {
@@ -705,41 +787,68 @@ BazelLabel Importer::GetOwningTarget(const clang::Decl* decl) const {
   if (IsFullClassTemplateSpecializationOrChild(decl)) {
     return invocation_.target_;
   }
+  return GetOwningTargetOfLocation(decl->getLocation());
+}
 
+BazelLabel Importer::GetOwningTargetOfLocation(
+    clang::SourceLocation source_location) const {
   clang::SourceManager& source_manager = ctx_.getSourceManager();
-  auto source_location = decl->getLocation();
 
   // If the header this decl comes from is not associated with a target we
   // consider it a textual header. In that case we go up the include stack
   // until we find a header that has an owning target.
-
+  //
+  // The answer only depends on the file, so it is memoized for every file on
+  // the include stack that we walk through.
+  std::vector<clang::FileID> visited_files;
+  std::optional<BazelLabel> owning_target;
   while (source_location.isValid()) {
     if (source_location.isMacroID()) {
       source_location = source_manager.getExpansionLoc(source_location);
     }
     auto id = source_manager.getFileID(source_location);
+    if (auto it = owning_target_of_file_.find(id);
+        it != owning_target_of_file_.end()) {
+      owning_target = it->second;
+      break;
+    }
+    visited_files.push_back(id);
     std::optional<llvm::StringRef> filename =
         source_manager.getNonBuiltinFilenameForID(id);
     if (!filename) {
-      return BazelLabel("//:_nothing_should_depend_on_private_builtin_hdrs");
+      owning_target =
+          BazelLabel("//:_nothing_should_depend_on_private_builtin_hdrs");
+      break;
     }
     if (filename->starts_with("./")) {
       filename = filename->substr(2);
     }
 
     if (auto target = invocation_.header_target(HeaderName(filename->str()))) {
-      return *target;
+      owning_target = *std::move(target);
+      break;
     }
     source_location = source_manager.getIncludeLoc(id);
   }
 
-  return BazelLabel("//:virtual_clang_resource_dir_target");
+  if (!owning_target.has_value()) {
+    owning_target = BazelLabel("//:virtual_clang_resource_dir_target");
+  }
+  for (clang::FileID id : visited_files) {
+    owning_target_of_file_.try_emplace(id, *owning_target);
+  }
+  return *std::move(owning_target);
 }
 
 bool Importer::IsFromCurrentTarget(const clang::Decl* decl) const {
   return invocation_.target_ == GetOwningTarget(decl);
 }
 
+bool Importer::IsLocationFromCurrentTarget(
+    clang::SourceLocation source_location) const {
+  return invocation_.target_ == GetOwningTargetOfLocation(source_location);
+}
+
 IR::Item Importer::ImportUnsupportedItem(const clang::Decl* decl,
                                          FormattedError error) {
   std::string name = "unnamed";
@@ -780,6 +889,7 @@ std::optional<std::string> Importer::GetComment(const clang::Decl* decl) const {
   // This does currently not distinguish between different types of comments.
   // In general it is not possible in C++ to reliably only extract doc comments.
   // This is going to be a heuristic that needs to be tuned over time.
+  if (invocation_.lean_bindings_) return std::nullopt;
 
   clang::SourceManager& sm = ctx_.getSourceManager();
   clang::RawComment* raw_comment = ctx_.getRawCommentForDeclNoCache(decl);
@@ -797,6 +907,7 @@ std::optional<std::string> Importer::GetComment(const clang::Decl* decl) const {
 }
 
 std::string Importer::ConvertSourceLocation(clang::SourceLocation loc) const {
+  if (invocation_.lean_bindings_) return "";
   auto& sm = ctx_.getSourceManager();
   // For macros: https://clang.llvm.org/doxygen/SourceManager_8h.html:
   // Spelling location: where the macro is originally defined.
@@ -875,11 +986,17 @@ absl::StatusOr<MappedType> Importer::ConvertTemplateSpecializationType(
   // erroring out, we temporarily use our own implementation of
   // DiagnosticConsumer here.
   crubit::RecordingDiagnosticConsumer diagnostic_recorder =
-      crubit::RecordDiagnostics(sema_.getDiagnostics(), [&] {
-        // Attempt to instantiate.
-        (void)sema_.isCompleteType(specialization_decl->getLocation(),
-                                   ctx_.getRecordType(specialization_decl));
-      });
+      crubit::RecordDiagnostics(
+          sema_.getDiagnostics(),
+          [&] {
+            // Attempt to instantiate.
+            (void)sema_.isCompleteType(
+                specialization_decl->getLocation(),
+                ctx_.getRecordType(specialization_decl));
+          },
+          [this](clang::SourceLocation loc) {
+            return IsLocationFromCurrentTarget(loc);
+          });
   if (diagnostic_recorder.getNumErrors() != 0) {
     return absl::InvalidArgumentError(absl::Substitute(
         "Failed to complete template specialization type $0: Diagnostics "
@@ -961,8 +1078,6 @@ absl::StatusOr<MappedType> Importer::ConvertUnattributedType(
     const clang::tidy::lifetimes::ValueLifetimes* lifetimes,
     std::optional<clang::RefQualifierKind> ref_qualifier_kind, bool nullable) {
   // Qualifiers are handled separately in ConvertQualType().
-  std::string type_string = clang::QualType(type, 0).getAsString();
-
   assert(!lifetimes || IsSameCanonicalUnqualifiedType(
                            lifetimes->Type(), clang::QualType(type, 0)));
 
@@ -1146,15 +1261,50 @@ static clang::QualType GetUnelaboratedType(clang::QualType qual_type,
   }
 }
 
+// Returns true if every record and enum that `qual_type` refers to, directly or
+// through pointers, references, arrays and function types, has a definition.
+static bool RefersOnlyToCompleteTypes(clang::QualType qual_type) {
+  const clang::Type* type = qual_type.getCanonicalType().getTypePtr();
+  if (const auto* tag_decl = type->getAsTagDecl()) {
+    return tag_decl->getDefinition() != nullptr;
+  }
+  if (type->isPointerType() || type->isReferenceType() ||
+      type->isMemberPointerType()) {
+    return RefersOnlyToCompleteTypes(type->getPointeeType());
+  }
+  if (type->isArrayType()) {
+    return RefersOnlyToCompleteTypes(
+        type->getAsArrayTypeUnsafe()->getElementType());
+  }
+  if (const auto* func_type = type->getAs<clang::FunctionProtoType>()) {
+    if (!RefersOnlyToCompleteTypes(func_type->getReturnType())) return false;
+    for (clang::QualType param_type : func_type->getParamTypes()) {
+      if (!RefersOnlyToCompleteTypes(param_type)) return false;
+    }
+  }
+  return true;
+}
+
 absl::StatusOr<MappedType> Importer::ConvertQualType(
     clang::QualType qual_type,
     const clang::tidy::lifetimes::ValueLifetimes* lifetimes,
     std::optional<clang::RefQualifierKind> ref_qualifier_kind, bool nullable) {
   qual_type = GetUnelaboratedType(std::move(qual_type), ctx_);
-  std::string type_string = qual_type.getAsString();
+  // Lifetimes are only borrowed for the duration of the call, so conversions
+  // that depend on them can't be cached.
+  std::optional<TypeConversionKey> cache_key;
+  if (lifetimes == nullptr) {
+    cache_key.emplace(qual_type.getAsOpaquePtr(), ref_qualifier_kind, nullable);
+    if (auto it = type_conversion_cache_.find(*cache_key);
+        it != type_conversion_cache_.end()) {
+      return it->second;
+    }
+  }
+
   absl::StatusOr<MappedType> type = ConvertType(
       qual_type.getTypePtr(), lifetimes, ref_qualifier_kind, nullable);
   if (!type.ok()) {
+    std::string type_string = qual_type.getAsString();
     absl::Status error = absl::UnimplementedError(absl::Substitute(
         "Unsupported type '$0': $1", type_string, type.status().message()));
     error.SetPayload(kTypeStatusPayloadUrl, absl::Cord(type_string));
@@ -1164,14 +1314,28 @@ absl::StatusOr<MappedType> Importer::ConvertQualType(
   // Handle cv-qualification.
   type->cpp_type.is_const = qual_type.isConstQualified();
   if (qual_type.isVolatileQualified()) {
-    return absl::UnimplementedError(
-        absl::StrCat("Unsupported `volatile` qualifier: ", type_string));
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported `volatile` qualifier: ", qual_type.getAsString()));
   }
 
+  // The conversion of a type that is not yet complete (e.g. a forward-declared
+  // record, or a template specialization that hasn't been instantiated yet)
+  // may differ once the definition is available, so it isn't cached.
+  if (cache_key.has_value() && RefersOnlyToCompleteTypes(qual_type)) {
+    type_conversion_cache_.try_emplace(*cache_key, *type);
+  }
   return type;
 }
 
 std::string Importer::GetMangledName(const clang::NamedDecl* named_decl) const {
+  auto [it, inserted] = mangled_names_.try_emplace(named_decl);
+  if (inserted) {
+    it->second = MangleName(named_decl);
+  }
+  return it->second;
+}
+
+std::string Importer::MangleName(const clang::NamedDecl* named_decl) const {
   if (auto record_decl = clang::dyn_cast<clang::RecordDecl>(named_decl)) {
     // Mangled record names are used to 1) provide valid Rust identifiers for
     // C++ template specializations, and 2) help build unique names for virtual
@@ -1285,7 +1449,7 @@ absl::StatusOr<UnqualifiedIdentifier> Importer::GetTranslatedName(
             absl::StrCat("Unescapable identifier: ", name));
       }
 
-      return {Identifier(std::move(name))};
+      return {Identifier(name)};
     }
     case clang::DeclarationName::CXXConstructorName:
       return {SpecialName::kConstructor};
@@ -1328,4 +1492,11 @@ bool Importer::HasBeenAlreadySuccessfullyImported(
       clang::cast<clang::NamedDecl>(CanonicalizeDecl(decl)));
 }
 
+const AnnotateAttrIndex& Importer::GetAnnotateAttrs(
+    const clang::Decl* decl) const {
+  std::unique_ptr<AnnotateAttrIndex>& attrs = annotate_attrs_[decl];
+  if (attrs == nullptr) attrs = std::make_unique<AnnotateAttrIndex>(*decl);
+  return *attrs;
+}
+
 }  // namespace crubit
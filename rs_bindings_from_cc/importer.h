@@ -9,6 +9,8 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -17,11 +19,13 @@
 #include "absl/log/check.h"
 #include "absl/log/die_if_null.h"
 #include "absl/status/statusor.h"
+#include "common/annotation_reader.h"
 #include "common/status_macros.h"
 #include "lifetime_annotations/type_lifetimes.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/decl_importer.h"
 #include "rs_bindings_from_cc/importers/class_template.h"
+#include "rs_bindings_from_cc/importers/constant.h"
 #include "rs_bindings_from_cc/importers/cxx_record.h"
 #include "rs_bindings_from_cc/importers/enum.h"
 #include "rs_bindings_from_cc/importers/friend.h"
@@ -38,6 +42,7 @@
 #include "clang/AST/Type.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace crubit {
 
@@ -53,6 +58,7 @@ class Importer final : public ImportContext {
     decl_importers_.push_back(std::make_unique<TypeMapOverrideImporter>(*this));
     decl_importers_.push_back(
         std::make_unique<ClassTemplateDeclImporter>(*this));
+    decl_importers_.push_back(std::make_unique<ConstantImporter>(*this));
     decl_importers_.push_back(std::make_unique<CXXRecordDeclImporter>(*this));
     decl_importers_.push_back(std::make_unique<EnumDeclImporter>(*this));
     decl_importers_.push_back(std::make_unique<FriendDeclImporter>(*this));
@@ -88,6 +94,8 @@ class Importer final : public ImportContext {
   std::string GetMangledName(const clang::NamedDecl* named_decl) const override;
   BazelLabel GetOwningTarget(const clang::Decl* decl) const override;
   bool IsFromCurrentTarget(const clang::Decl* decl) const override;
+  bool IsLocationFromCurrentTarget(
+      clang::SourceLocation source_location) const override;
   absl::StatusOr<UnqualifiedIdentifier> GetTranslatedName(
       const clang::NamedDecl* named_decl) const override;
   absl::StatusOr<Identifier> GetTranslatedIdentifier(
@@ -115,6 +123,9 @@ class Importer final : public ImportContext {
     (void)GetDeclItem(CanonicalizeDecl(decl));
     return HasBeenAlreadySuccessfullyImported(decl);
   }
+  bool EnsureImportedIfLazy(clang::NamedDecl* decl) override;
+  const AnnotateAttrIndex& GetAnnotateAttrs(
+      const clang::Decl* decl) const override;
 
  private:
   class SourceOrderKey;
@@ -126,6 +137,20 @@ class Importer final : public ImportContext {
   // Returns a SourceOrderKey for the given `comment` that should be used for
   // ordering Items.
   SourceOrderKey GetSourceOrderKey(const clang::RawComment* comment) const;
+  // Sorts `items` by their `SourceOrderKey`: by source range (in translation
+  // unit order), then by decl order, then by `GetNameForSourceOrder`.
+  template <typename T>
+  void SortInSourceOrder(
+      std::vector<std::pair<SourceOrderKey, T>>& items) const;
+
+  // Returns the label of the target that owns the file containing
+  // `source_location`, walking up the include stack for textual headers.
+  BazelLabel GetOwningTargetOfLocation(
+      clang::SourceLocation source_location) const;
+
+  // Mangles the name of `named_decl`, without memoization. See
+  // `GetMangledName`.
+  std::string MangleName(const clang::NamedDecl* named_decl) const;
 
   // Returns a name for `decl` that should be used for ordering declarations.
   std::string GetNameForSourceOrder(const clang::Decl* decl) const;
@@ -133,9 +158,18 @@ class Importer final : public ImportContext {
   // Returns the item ids of template instantiations that have been triggered
   // from the current target.  The returned items are in an arbitrary,
   // deterministic/reproducible order.
+  //
+  // The instantiations are collected in whatever order they happen to be
+  // imported, and are only sorted here, once all of them have been imported.
+  // Importing them has to stay serial: it instantiates their definitions with
+  // the (single-threaded) `clang::Sema` of the translation unit.
   std::vector<ItemId> GetOrderedItemIdsOfTemplateInstantiations() const;
 
   std::optional<IR::Item> GetDeclItem(clang::Decl* decl) override;
+  // Returns whether `decl` should be imported when importing the children of
+  // its decl context, as opposed to only when it is referenced. See
+  // `Invocation::import_dependencies_lazily_`.
+  bool ShouldImportUpfront(const clang::Decl* decl) const;
   // Stores the comments of this target in source order.
   void ImportFreeComments();
 
@@ -182,6 +216,45 @@ class Importer final : public ImportContext {
   //
   // Note that this includes non-TypeDecls in the form of using decls.
   absl::flat_hash_set<const clang::NamedDecl*> known_type_decls_;
+
+  // Memoized results of `GetOwningTargetOfLocation`, by file. Targets with
+  // many public headers query this for every redeclaration of every decl, and
+  // each query would otherwise walk the include stack and look up header names.
+  mutable llvm::DenseMap<clang::FileID, BazelLabel> owning_target_of_file_;
+
+  // Memoized results of `GetMangledName`. Mangled names are needed for the IR,
+  // for thunk names, and for ordering items with the same source location,
+  // which would otherwise mangle every function and template specialization
+  // several times.
+  mutable llvm::DenseMap<const clang::NamedDecl*, std::string> mangled_names_;
+
+  // Memoized results of `CanonicalizeDecl` for `CXXRecordDecl`s whose
+  // canonical decl is their definition. Finding it walks all redeclarations
+  // and looks up their owning targets, and is done for every `ItemId` of a
+  // record.
+  mutable llvm::DenseMap<const clang::Decl*, const clang::Decl*>
+      canonical_record_decls_;
+
+  // Memoized successful results of `ConvertQualType`, for conversions without
+  // lifetimes. The key is the opaque pointer of the (sugared) `QualType`, not
+  // of its canonical type: typedefs and aliases map to their own decls.
+  //
+  // Errors are not cached, because a conversion that fails while a cycle of
+  // decls is being imported may succeed once the import is done. Successful
+  // conversions stay valid, because decls are never removed from
+  // `known_type_decls_`. Conversions of types that refer to records or enums
+  // without a definition are not cached either, because the definition (e.g.
+  // of a template specialization that is instantiated later) can change how
+  // the decl is imported.
+  using TypeConversionKey =
+      std::tuple<const void*, std::optional<clang::RefQualifierKind>, bool>;
+  absl::flat_hash_map<TypeConversionKey, MappedType> type_conversion_cache_;
+
+  // Memoized results of `GetAnnotateAttrs`. Several importers look up several
+  // annotations of each decl, e.g. both `TypeMapOverrideImporter` and
+  // `CXXRecordDeclImporter` for records.
+  mutable llvm::DenseMap<const clang::Decl*, std::unique_ptr<AnnotateAttrIndex>>
+      annotate_attrs_;
 };  // class Importer
 
 }  // namespace crubit
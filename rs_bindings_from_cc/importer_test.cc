@@ -2,6 +2,7 @@
 // Exceptions. See /LICENSE for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <variant>
@@ -10,6 +11,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "common/status_test_matchers.h"
@@ -355,6 +357,73 @@ TEST(ImporterTest, TwoFuncsFromTwoHeaders) {
                                    VariantWith<Func>(IdentifierIs("Bar"))));
 }
 
+absl::StatusOr<IR> IrFromCcWithDependency(bool import_dependencies_lazily) {
+  return IrFromCc(
+      {.extra_source_code_for_testing = R"cc(
+#include "test/dependency_header.h"
+         Used* GetUsed();
+       )cc",
+       .virtual_headers_contents_for_testing =
+           {{HeaderName("test/dependency_header.h"),
+             "struct Used { int x; }; struct Unused { void Method(); };"}},
+       .headers_to_targets = {{HeaderName("test/dependency_header.h"),
+                               BazelLabel{"//test:dependency"}}},
+       .import_dependencies_lazily = import_dependencies_lazily});
+}
+
+TEST(ImporterTest, DependenciesImportedEagerly) {
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCcWithDependency(false));
+  EXPECT_TRUE(DeclIdForRecord(ir, "Used").has_value());
+  EXPECT_TRUE(DeclIdForRecord(ir, "Unused").has_value());
+}
+
+TEST(ImporterTest, DependenciesImportedLazily) {
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCcWithDependency(true));
+  EXPECT_TRUE(DeclIdForRecord(ir, "Used").has_value());
+  EXPECT_FALSE(DeclIdForRecord(ir, "Unused").has_value());
+  EXPECT_THAT(ir.get_items_if<Func>(),
+              UnorderedElementsAre(Pointee(IdentifierIs("GetUsed"))));
+}
+
+TEST(ImporterTest, LeanBindingsHaveNoCommentsOrSourceLocations) {
+  ASSERT_OK_AND_ASSIGN(
+      IR ir, IrFromCc({.extra_source_code_for_testing = R"cc(
+                         // A free comment.
+
+                         // A doc comment.
+                         void Foo();
+                       )cc",
+                       .lean_bindings = true}));
+  EXPECT_THAT(ir.get_items_if<Comment>(), IsEmpty());
+  std::vector<const Func*> funcs = ir.get_items_if<Func>();
+  ASSERT_THAT(funcs, SizeIs(1));
+  EXPECT_EQ(funcs[0]->doc_comment, std::nullopt);
+  EXPECT_EQ(funcs[0]->source_loc, "");
+}
+
+TEST(ImporterTest, Constants) {
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({R"cc(
+    constexpr int kConstexpr = -42;
+    int mutable_global = 42;
+    struct S {
+      static const int kMember = 42;
+    };
+  )cc"}));
+  std::vector<const Constant*> constants = ir.get_items_if<Constant>();
+  EXPECT_THAT(constants,
+              UnorderedElementsAre(Pointee(IdentifierIs("kConstexpr")),
+                                   Pointee(IdentifierIs("kMember"))));
+  for (const Constant* constant : constants) {
+    if (constant->identifier.Ident() == "kConstexpr") {
+      EXPECT_EQ(constant->value.ToJson(),
+                llvm::json::Value(llvm::json::Object{
+                    {"is_negative", true},
+                    {"wrapped_value", static_cast<uint64_t>(-42)},
+                }));
+    }
+  }
+}
+
 TEST(ImporterTest, NonInlineFunc) {
   ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({"void Foo() {}"}));
   EXPECT_THAT(ItemsWithoutBuiltins(ir),
@@ -400,6 +469,28 @@ TEST(ImporterTest, TestImportConstStructPointerFunc) {
                             ParamsAre(ParamType(is_ptr_to_const_s))))));
 }
 
+TEST(ImporterTest, TestImportPointerToForwardDeclaredStructDefinedLater) {
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({R"cc(
+    struct S;
+    void Before(S* s);
+    struct S { int i; };
+    void After(S* s);
+  )cc"}));
+
+  std::optional<ItemId> decl_id = DeclIdForRecord(ir, "S");
+  ASSERT_TRUE(decl_id.has_value());
+
+  auto is_ptr_to_s = AllOf(CcTypeIs(CcPointsTo(DeclIdIs(*decl_id))),
+                           RsTypeIs(RsPointsTo(DeclIdIs(*decl_id))));
+
+  EXPECT_THAT(ir.items, Contains(VariantWith<Func>(AllOf(
+                            IdentifierIs("Before"),
+                            ParamsAre(ParamType(is_ptr_to_s))))));
+  EXPECT_THAT(ir.items, Contains(VariantWith<Func>(AllOf(
+                            IdentifierIs("After"),
+                            ParamsAre(ParamType(is_ptr_to_s))))));
+}
+
 TEST(ImporterTest, TestImportReferenceFunc) {
   ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({"int& Foo(int& a);"}));
 
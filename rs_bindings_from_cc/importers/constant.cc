@@ -0,0 +1,97 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/importers/constant.h"
+
+#include <optional>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "lifetime_annotations/type_lifetimes.h"
+#include "rs_bindings_from_cc/ast_util.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "clang/AST/APValue.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/Type.h"
+#include "clang/Basic/LLVM.h"
+
+namespace crubit {
+
+std::optional<IR::Item> ConstantImporter::Import(clang::VarDecl* var_decl) {
+  // Parameters and local variables are never imported on their own, and
+  // variable templates (and their specializations) are not supported yet.
+  if (clang::isa<clang::ParmVarDecl>(var_decl) ||
+      clang::isa<clang::VarTemplateSpecializationDecl>(var_decl) ||
+      var_decl->isLocalVarDecl() || var_decl->isTemplated() ||
+      var_decl->getDescribedVarTemplate() != nullptr) {
+    return std::nullopt;
+  }
+
+  // The initializer may be on a later redeclaration (e.g. `extern const int
+  // x;` followed by `const int x = 42;`).
+  clang::VarDecl* initializing_decl = var_decl->getInitializingDeclaration();
+  clang::ASTContext& ast_context = var_decl->getASTContext();
+  if (initializing_decl == nullptr ||
+      !initializing_decl->isUsableInConstantExpressions(ast_context)) {
+    // Mutable globals would need thunks to be read or written, which isn't
+    // supported yet.
+    return std::nullopt;
+  }
+
+  clang::QualType cpp_type = var_decl->getType().getUnqualifiedType();
+  if (!cpp_type->isIntegralOrEnumerationType()) {
+    return ictx_.ImportUnsupportedItem(
+        var_decl, FormattedError::Static(
+                      "Only constants of integral, enum or `bool` type are "
+                      "supported"));
+  }
+  const clang::APValue* value = initializing_decl->evaluateValue();
+  if (value == nullptr || !value->isInt() ||
+      value->getInt().getSignificantBits() > 64) {
+    return ictx_.ImportUnsupportedItem(
+        var_decl, FormattedError::Static(
+                      "The value of the constant could not be evaluated"));
+  }
+
+  absl::StatusOr<Identifier> identifier =
+      ictx_.GetTranslatedIdentifier(var_decl);
+  if (!identifier.ok()) {
+    return ictx_.ImportUnsupportedItem(
+        var_decl,
+        FormattedError::PrefixedStrCat("Constant name is not supported",
+                                       identifier.status().message()));
+  }
+
+  const clang::tidy::lifetimes::ValueLifetimes* no_lifetimes = nullptr;
+  absl::StatusOr<MappedType> type =
+      ictx_.ConvertQualType(cpp_type, no_lifetimes, std::nullopt);
+  if (!type.ok()) {
+    return ictx_.ImportUnsupportedItem(
+        var_decl, FormattedError::FromStatus(std::move(type.status())));
+  }
+
+  auto enclosing_item_id = ictx_.GetEnclosingItemId(var_decl);
+  if (!enclosing_item_id.ok()) {
+    return ictx_.ImportUnsupportedItem(
+        var_decl,
+        FormattedError::FromStatus(std::move(enclosing_item_id.status())));
+  }
+
+  ictx_.MarkAsSuccessfullyImported(var_decl);
+  return Constant{
+      .identifier = *std::move(identifier),
+      .id = ictx_.GenerateItemId(var_decl),
+      .owning_target = ictx_.GetOwningTarget(var_decl),
+      .doc_comment = ictx_.GetComment(var_decl),
+      .unknown_attr = CollectUnknownAttrs(*var_decl),
+      .type = *std::move(type),
+      .value = IntegerConstant(value->getInt()),
+      .source_loc = ictx_.ConvertSourceLocation(var_decl->getBeginLoc()),
+      .enclosing_item_id = *std::move(enclosing_item_id),
+  };
+}
+
+}  // namespace crubit
@@ -0,0 +1,28 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_IMPORTERS_CONSTANT_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_IMPORTERS_CONSTANT_H_
+
+#include <optional>
+
+#include "rs_bindings_from_cc/decl_importer.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "clang/AST/Decl.h"
+
+namespace crubit {
+
+// A `DeclImporter` for `VarDecl`s that are usable in constant expressions
+// (e.g. `constexpr` variables, or `static const` data members of integral
+// type). Other variables are not imported.
+class ConstantImporter : public DeclImporterBase<clang::VarDecl> {
+ public:
+  explicit ConstantImporter(ImportContext& context)
+      : DeclImporterBase(context) {}
+  std::optional<IR::Item> Import(clang::VarDecl* var_decl) override;
+};
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_IMPORTERS_CONSTANT_H_
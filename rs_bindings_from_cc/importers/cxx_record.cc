@@ -18,6 +18,7 @@
 #include "absl/log/die_if_null.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "common/annotation_reader.h"
@@ -123,24 +124,30 @@ absl::StatusOr<RecordType> TranslateRecordType(
   llvm::report_fatal_error("Unrecognized clang::TagKind");
 }
 
+// Returns the bridge type that the record with `attrs` is converted to.
+//
+// A bridge type maps a record to a single Rust type, with a single pair of
+// (non-generic, `extern "C"`) converter functions. The annotations of a class
+// template are inherited by all of its specializations, so e.g. a bridged
+// `StatusOr<T>` would call the same converters for every `T`: bridging class
+// templates would need converters generated per specialization.
 std::optional<BridgeTypeInfo> GetBridgeTypeInfo(
-    const clang::RecordDecl* record_decl) {
+    const AnnotateAttrIndex& attrs) {
   constexpr absl::string_view kBridgeTypeTag = "crubit_bridge_type";
   constexpr absl::string_view kBridgeTypeRustToCppConverterTag =
       "crubit_bridge_type_rust_to_cpp_converter";
   constexpr absl::string_view kBridgeTypeCppToRustConverterTag =
       "crubit_bridge_type_cpp_to_rust_converter";
-  CHECK_OK(RequireSingleStringArgIfExists(record_decl, kBridgeTypeTag));
-  CHECK_OK(RequireSingleStringArgIfExists(record_decl,
-                                          kBridgeTypeRustToCppConverterTag));
-  CHECK_OK(RequireSingleStringArgIfExists(record_decl,
-                                          kBridgeTypeCppToRustConverterTag));
-  auto bridge_type =
-      GetAnnotateArgAsStringByAttribute(record_decl, kBridgeTypeTag);
-  auto bridge_type_rust_to_cpp_converter = GetAnnotateArgAsStringByAttribute(
-      record_decl, kBridgeTypeRustToCppConverterTag);
-  auto bridge_type_cpp_to_rust_converter = GetAnnotateArgAsStringByAttribute(
-      record_decl, kBridgeTypeCppToRustConverterTag);
+  CHECK_OK(attrs.RequireSingleStringArgIfExists(kBridgeTypeTag));
+  CHECK_OK(
+      attrs.RequireSingleStringArgIfExists(kBridgeTypeRustToCppConverterTag));
+  CHECK_OK(
+      attrs.RequireSingleStringArgIfExists(kBridgeTypeCppToRustConverterTag));
+  auto bridge_type = attrs.GetArgAsString(kBridgeTypeTag);
+  auto bridge_type_rust_to_cpp_converter =
+      attrs.GetArgAsString(kBridgeTypeRustToCppConverterTag);
+  auto bridge_type_cpp_to_rust_converter =
+      attrs.GetArgAsString(kBridgeTypeCppToRustConverterTag);
 
   if (bridge_type.has_value()) {
     CHECK(bridge_type_rust_to_cpp_converter.has_value())
@@ -181,6 +188,9 @@ std::optional<Identifier> CXXRecordDeclImporter::GetTranslatedFieldName(
 }
 
 bool IsKnownAttr(const clang::Attr& attr) {
+  if (const auto* annotate = clang::dyn_cast<clang::AnnotateAttr>(&attr)) {
+    return annotate->getAnnotation() == "crubit_internal_column_view";
+  }
   return clang::isa<clang::AlignedAttr>(attr) ||
          clang::isa<clang::FinalAttr>(attr) ||
          clang::isa<clang::TrivialABIAttr>(attr) ||
@@ -274,6 +284,14 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
   if (attr_error_item.has_value()) {
     return attr_error_item;
   }
+  absl::StatusOr<bool> has_column_view_attribute =
+      ictx_.GetAnnotateAttrs(record_decl).HasWithoutArgs(
+          "crubit_internal_column_view");
+  if (!has_column_view_attribute.ok()) {
+    return ictx_.ImportUnsupportedItem(
+        record_decl, FormattedError::FromStatus(
+                         std::move(has_column_view_attribute.status())));
+  }
 
   std::string rs_name, cc_name, preferred_cc_name;
   clang::SourceLocation source_loc;
@@ -403,7 +421,8 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
       .template_specialization = std::move(template_specialization),
       .unknown_attr = std::move(unknown_attr),
       .doc_comment = std::move(doc_comment),
-      .bridge_type_info = GetBridgeTypeInfo(record_decl),
+      .bridge_type_info =
+          GetBridgeTypeInfo(ictx_.GetAnnotateAttrs(record_decl)),
       .source_loc = ictx_.ConvertSourceLocation(source_loc),
       .unambiguous_public_bases = GetUnambiguousPublicBases(*record_decl),
       .fields = ImportFields(record_decl),
@@ -425,6 +444,7 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
       .is_anon_record_with_typedef = anon_typedef != nullptr,
       .is_explicit_class_template_instantiation_definition =
           is_explicit_class_template_instantiation_definition,
+      .has_column_view_attribute = *has_column_view_attribute,
       .child_item_ids = std::move(item_ids),
       .enclosing_item_id = *std::move(enclosing_item_id),
   };
@@ -503,7 +523,8 @@ std::vector<Field> CXXRecordDeclImporter::ImportFields(
     auto* field_record = field_decl->getType()->getAsCXXRecordDecl();
     if (field_record) {
       // If it is a record as a direct member, its item must be already
-      // imported.
+      // imported (or be importable on demand if importing lazily).
+      ictx_.EnsureImportedIfLazy(field_record);
       auto item = ictx_.GetImportedItem(field_record);
       if (item.has_value()) {
         if (const auto* record = std::get_if<Record>(&item.value())) {
@@ -588,7 +609,7 @@ std::vector<BaseClass> CXXRecordDeclImporter::GetUnambiguousPublicBases(
 
       clang::CXXRecordDecl* base_record_decl =
           ABSL_DIE_IF_NULL(base_specifier.getType()->getAsCXXRecordDecl());
-      if (!ictx_.HasBeenAlreadySuccessfullyImported(base_record_decl)) {
+      if (!ictx_.EnsureImportedIfLazy(base_record_decl)) {
         continue;
       }
 
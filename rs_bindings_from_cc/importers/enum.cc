@@ -10,9 +10,11 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/status/statusor.h"
+#include "common/annotation_reader.h"
 #include "lifetime_annotations/type_lifetimes.h"
 #include "rs_bindings_from_cc/ast_util.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/LLVM.h"
@@ -77,6 +79,15 @@ std::optional<IR::Item> EnumDeclImporter::Import(clang::EnumDecl* enum_decl) {
     });
   }
 
+  absl::StatusOr<bool> has_dense_attribute =
+      ictx_.GetAnnotateAttrs(enum_decl).HasWithoutArgs(
+          "crubit_internal_dense_enum");
+  if (!has_dense_attribute.ok()) {
+    return ictx_.ImportUnsupportedItem(
+        enum_decl,
+        FormattedError::FromStatus(std::move(has_dense_attribute.status())));
+  }
+
   auto enclosing_item_id = ictx_.GetEnclosingItemId(enum_decl);
   if (!enclosing_item_id.ok()) {
     return ictx_.ImportUnsupportedItem(
@@ -94,7 +105,14 @@ std::optional<IR::Item> EnumDeclImporter::Import(clang::EnumDecl* enum_decl) {
       .enumerators = enum_decl->isCompleteDefinition()
                          ? std::make_optional(std::move(enumerators))
                          : std::nullopt,
-      .unknown_attr = CollectUnknownAttrs(*enum_decl),
+      .unknown_attr = CollectUnknownAttrs(
+          *enum_decl,
+          [](const clang::Attr& attr) {
+            const auto* annotate = clang::dyn_cast<clang::AnnotateAttr>(&attr);
+            return annotate != nullptr &&
+                   annotate->getAnnotation() == "crubit_internal_dense_enum";
+          }),
+      .has_dense_attribute = *has_dense_attribute,
       .enclosing_item_id = *std::move(enclosing_item_id),
   };
 }
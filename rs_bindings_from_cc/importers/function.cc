@@ -13,8 +13,11 @@
 #include <vector>
 
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/annotation_reader.h"
 #include "lifetime_annotations/lifetime.h"
 #include "lifetime_annotations/lifetime_annotations.h"
 #include "lifetime_annotations/lifetime_error.h"
@@ -142,10 +145,15 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
         point_of_instantiation = function_decl->getLocation();
       }
       crubit::RecordingDiagnosticConsumer diagnostic_recorder =
-          crubit::RecordDiagnostics(ictx_.sema_.getDiagnostics(), [&] {
-            ictx_.sema_.InstantiateFunctionDefinition(point_of_instantiation,
-                                                      function_decl);
-          });
+          crubit::RecordDiagnostics(
+              ictx_.sema_.getDiagnostics(),
+              [&] {
+                ictx_.sema_.InstantiateFunctionDefinition(
+                    point_of_instantiation, function_decl);
+              },
+              [&](clang::SourceLocation loc) {
+                return ictx_.IsLocationFromCurrentTarget(loc);
+              });
       std::string diagnostics =
           diagnostic_recorder.ConcatenatedDiagnostics("Diagnostics emitted:\n");
       if (diagnostic_recorder.getNumErrors() != 0) {
@@ -221,7 +229,7 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
   };
   if (auto* method_decl =
           clang::dyn_cast<clang::CXXMethodDecl>(function_decl)) {
-    if (!ictx_.HasBeenAlreadySuccessfullyImported(method_decl->getParent())) {
+    if (!ictx_.EnsureImportedIfLazy(method_decl->getParent())) {
       return ictx_.ImportUnsupportedItem(
           function_decl, FormattedError::Static("Couldn't import the parent"));
     }
@@ -283,10 +291,15 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
     // is OK if this is a method of a class template, since Crubit
     // instantiates the members of the class templates eagerly.
     crubit::RecordingDiagnosticConsumer diagnostic_recorder =
-        crubit::RecordDiagnostics(ictx_.sema_.getDiagnostics(), [&] {
-          undeduced_return_type = ictx_.sema_.DeduceReturnType(
-              function_decl, function_decl->getLocation());
-        });
+        crubit::RecordDiagnostics(
+            ictx_.sema_.getDiagnostics(),
+            [&] {
+              undeduced_return_type = ictx_.sema_.DeduceReturnType(
+                  function_decl, function_decl->getLocation());
+            },
+            [&](clang::SourceLocation loc) {
+              return ictx_.IsLocationFromCurrentTarget(loc);
+            });
     if (undeduced_return_type) {
       add_error(FormattedError::PrefixedStrCat(
           "Couldn't deduce the return type",
@@ -347,6 +360,8 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
           .reference = reference,
           .is_const = method_decl->isConst(),
           .is_virtual = method_decl->isVirtual(),
+          .is_final = method_decl->hasAttr<clang::FinalAttr>() ||
+                      method_decl->getParent()->isEffectivelyFinal(),
       };
     }
 
@@ -355,6 +370,23 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
         .instance_method_metadata = instance_metadata};
   }
 
+  const AnnotateAttrIndex& attrs = ictx_.GetAnnotateAttrs(function_decl);
+  absl::StatusOr<bool> has_no_thunk_attribute =
+      attrs.HasWithoutArgs("crubit_internal_no_thunk");
+  if (!has_no_thunk_attribute.ok()) {
+    add_error(FormattedError::FromStatus(has_no_thunk_attribute.status()));
+  }
+  absl::StatusOr<bool> has_batch_attribute =
+      attrs.HasWithoutArgs("crubit_internal_batch");
+  if (!has_batch_attribute.ok()) {
+    add_error(FormattedError::FromStatus(has_batch_attribute.status()));
+  }
+  if (absl::Status status =
+          attrs.RequireSingleStringArgIfExists("crubit_internal_rust_name");
+      !status.ok()) {
+    add_error(FormattedError::FromStatus(std::move(status)));
+  }
+
   if (!errors.empty()) {
     return ictx_.ImportUnsupportedItem(
         function_decl, std::vector(errors.begin(), errors.end()));
@@ -428,6 +460,10 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
       .has_c_calling_convention = has_c_calling_convention,
       .is_member_or_descendant_of_class_template =
           is_member_or_descendant_of_class_template,
+      .has_no_thunk_attribute = *has_no_thunk_attribute,
+      .has_batch_attribute = *has_batch_attribute,
+      .is_defaulted = function_decl->isDefaulted(),
+      .rust_name = attrs.GetArgAsString("crubit_internal_rust_name"),
       .source_loc = ictx_.ConvertSourceLocation(function_decl->getBeginLoc()),
       .id = ictx_.GenerateItemId(function_decl),
       .enclosing_item_id = *std::move(enclosing_item_id),
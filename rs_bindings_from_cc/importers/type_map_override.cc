@@ -23,6 +23,7 @@
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclTemplate.h"
+#include "clang/AST/TemplateBase.h"
 #include "clang/AST/Type.h"
 #include "llvm/Support/Casting.h"
 
@@ -32,9 +33,9 @@ namespace {
 // Gets the crubit_internal_rust_type attribute for `decl`.
 // `decl` must not be null.
 absl::StatusOr<std::optional<absl::string_view>> GetRustTypeAttribute(
-    const clang::Decl* decl) {
+    const AnnotateAttrIndex& attrs, const clang::Decl* decl) {
   CRUBIT_ASSIGN_OR_RETURN(const clang::AnnotateAttr* attr,
-                          GetAnnotateAttr(*decl, "crubit_internal_rust_type"));
+                          attrs.Get("crubit_internal_rust_type"));
   if (attr == nullptr) return std::nullopt;
   if (attr->args_size() != 1)
     return absl::InvalidArgumentError(
@@ -44,14 +45,39 @@ absl::StatusOr<std::optional<absl::string_view>> GetRustTypeAttribute(
   return GetAnnotateArgAsStringLiteral(*attr, decl->getASTContext());
 }
 
+// Gets the Rust type of well-known C++ types that are defined in headers that
+// we can't annotate with `crubit_internal_rust_type`.
+//
+// `absl::Span<T>` and `std::span<T>` (with a dynamic extent) are a pointer and
+// a length, like `rs_std::SliceRef<T>`, and are mapped to (pointers to) Rust
+// slices in the same way. This lets Rust callers pass their buffers directly,
+// instead of building a C++ container.
+std::optional<absl::string_view> GetWellKnownRustType(
+    const clang::Decl* decl) {
+  const auto* specialization_decl =
+      llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(decl);
+  if (specialization_decl == nullptr) return std::nullopt;
+  const clang::TemplateArgumentList& args =
+      specialization_decl->getTemplateArgs();
+  std::string template_name = specialization_decl->getQualifiedNameAsString();
+  if (template_name == "absl::Span" && args.size() == 1) {
+    return "&[]";
+  }
+  if (template_name == "std::span" && args.size() == 2 &&
+      args[1].getKind() == clang::TemplateArgument::Integral &&
+      args[1].getAsIntegral().isMaxValue()) {
+    // `std::dynamic_extent` is the largest `size_t`.
+    return "&[]";
+  }
+  return std::nullopt;
+}
+
 // Gets the crubit_internal_same_abi attribute for `decl`.
 // If the attribute is specified, returns true. If it's unspecified, returns
 // false. If the attribute is malformed, returns a bad status.
-//
-// `decl` must not be null.
-absl::StatusOr<bool> GetIsSameAbiAttribute(const clang::Decl* decl) {
+absl::StatusOr<bool> GetIsSameAbiAttribute(const AnnotateAttrIndex& attrs) {
   CRUBIT_ASSIGN_OR_RETURN(const clang::AnnotateAttr* attr,
-                          GetAnnotateAttr(*decl, "crubit_internal_same_abi"));
+                          attrs.Get("crubit_internal_same_abi"));
   if (attr != nullptr && attr->args_size() != 0)
     return absl::InvalidArgumentError(
         "The `crubit_internal_same_abi` attribute takes no arguments.");
@@ -72,6 +98,9 @@ absl::StatusOr<std::optional<std::vector<MappedType>>> GetTemplateParameters(
 
   std::vector<MappedType> result;
   for (const auto& arg : specialization_decl->getTemplateArgs().asArray()) {
+    // Non-type arguments (e.g. the extent of `std::span`) aren't part of the
+    // Rust type.
+    if (arg.getKind() != clang::TemplateArgument::Type) continue;
     auto mapped_type =
         ictx.ConvertQualType(arg.getAsType(), /*lifetimes=*/nullptr,
                              /*ref_qualifier_kind=*/std::nullopt,
@@ -88,8 +117,9 @@ absl::StatusOr<std::optional<std::vector<MappedType>>> GetTemplateParameters(
 
 std::optional<IR::Item> TypeMapOverrideImporter::Import(
     clang::TypeDecl* type_decl) {
+  const AnnotateAttrIndex& attrs = ictx_.GetAnnotateAttrs(type_decl);
   absl::StatusOr<std::optional<absl::string_view>> rust_type =
-      GetRustTypeAttribute(type_decl);
+      GetRustTypeAttribute(attrs, type_decl);
   if (!rust_type.ok()) {
     return ictx_.ImportUnsupportedItem(
         type_decl, FormattedError::PrefixedStrCat(
@@ -97,9 +127,10 @@ std::optional<IR::Item> TypeMapOverrideImporter::Import(
                        rust_type.status().message()));
   }
   if (!rust_type->has_value()) {
-    return std::nullopt;
+    *rust_type = GetWellKnownRustType(type_decl);
+    if (!rust_type->has_value()) return std::nullopt;
   }
-  absl::StatusOr<bool> is_same_abi = GetIsSameAbiAttribute(type_decl);
+  absl::StatusOr<bool> is_same_abi = GetIsSameAbiAttribute(attrs);
   if (!is_same_abi.ok()) {
     return ictx_.ImportUnsupportedItem(
         type_decl, FormattedError::PrefixedStrCat(
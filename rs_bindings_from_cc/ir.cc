@@ -4,6 +4,8 @@
 
 #include "rs_bindings_from_cc/ir.h"
 
+#include <cstdint>
+#include <cstring>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -11,6 +13,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -20,6 +23,7 @@
 #include "common/string_type.h"
 #include "common/strong_int.h"
 #include "clang/AST/Type.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/JSON.h"
 
 namespace crubit {
@@ -39,6 +43,11 @@ llvm::json::Value toJSON(const crubit::StringType<TTag> string_type) {
   return llvm::json::Value(string_type.value());
 }
 
+template <typename TTag>
+llvm::json::Value toJSON(const crubit::InternedStringType<TTag> string_type) {
+  return llvm::json::Value(string_type.value());
+}
+
 template <class T>
 llvm::json::Value toJSON(const absl::StatusOr<T>& t) {
   if (t.ok()) {
@@ -215,7 +224,7 @@ llvm::json::Value MappedType::ToJson() const {
 
 llvm::json::Value Identifier::ToJson() const {
   return llvm::json::Object{
-      {"identifier", identifier_},
+      {"identifier", *identifier_},
   };
 }
 
@@ -288,6 +297,7 @@ llvm::json::Value MemberFuncMetadata::InstanceMethodMetadata::ToJson() const {
       {"reference", reference_str},
       {"is_const", is_const},
       {"is_virtual", is_virtual},
+      {"is_final", is_final},
   };
 }
 
@@ -346,6 +356,10 @@ llvm::json::Value Func::ToJson() const {
       {"has_c_calling_convention", has_c_calling_convention},
       {"is_member_or_descendant_of_class_template",
        is_member_or_descendant_of_class_template},
+      {"has_no_thunk_attribute", has_no_thunk_attribute},
+      {"has_batch_attribute", has_batch_attribute},
+      {"is_defaulted", is_defaulted},
+      {"rust_name", rust_name},
       {"source_loc", source_loc},
       {"id", id},
       {"enclosing_item_id", enclosing_item_id},
@@ -501,6 +515,7 @@ llvm::json::Value Record::ToJson() const {
       {"record_type", RecordTypeToString(record_type)},
       {"is_aggregate", is_aggregate},
       {"is_anon_record_with_typedef", is_anon_record_with_typedef},
+      {"has_column_view_attribute", has_column_view_attribute},
       {"child_item_ids", std::move(json_item_ids)},
       {"enclosing_item_id", enclosing_item_id},
   };
@@ -527,6 +542,7 @@ llvm::json::Value Enum::ToJson() const {
       {"underlying_type", underlying_type},
       {"enumerators", enumerators},
       {"unknown_attr", unknown_attr},
+      {"has_dense_attribute", has_dense_attribute},
       {"enclosing_item_id", enclosing_item_id},
   };
 
@@ -552,6 +568,24 @@ llvm::json::Value TypeAlias::ToJson() const {
   };
 }
 
+llvm::json::Value Constant::ToJson() const {
+  llvm::json::Object constant{
+      {"identifier", identifier},
+      {"id", id},
+      {"owning_target", owning_target},
+      {"doc_comment", doc_comment},
+      {"unknown_attr", unknown_attr},
+      {"type", type},
+      {"value", value},
+      {"source_loc", source_loc},
+      {"enclosing_item_id", enclosing_item_id},
+  };
+
+  return llvm::json::Object{
+      {"Constant", std::move(constant)},
+  };
+}
+
 FormattedError FormattedError::FromStatus(absl::Status status) {
   std::optional<absl::Cord> fmt_cord =
       status.GetPayload(FormattedError::kFmtPayloadTypeUrl);
@@ -625,22 +659,16 @@ llvm::json::Value Namespace::ToJson() const {
   };
 }
 
-llvm::json::Value IR::ToJson() const {
-  std::vector<llvm::json::Value> json_items;
-  json_items.reserve(items.size());
-  for (const auto& item : items) {
-    std::visit([&](auto&& item) { json_items.push_back(item.ToJson()); }, item);
-  }
-  CHECK_EQ(json_items.size(), items.size());
-
+// Returns the JSON representation of all fields of `ir` except for `items`.
+static llvm::json::Object IrFieldsWithoutItemsToJson(const IR& ir) {
   std::vector<llvm::json::Value> top_level_ids;
-  top_level_ids.reserve(top_level_item_ids.size());
-  for (const auto& id : top_level_item_ids) {
+  top_level_ids.reserve(ir.top_level_item_ids.size());
+  for (const auto& id : ir.top_level_item_ids) {
     top_level_ids.push_back(id.value());
   }
 
   llvm::json::Object features_json;
-  for (const auto& [target, features] : crubit_features) {
+  for (const auto& [target, features] : ir.crubit_features) {
     std::vector<llvm::json::Value> feature_array;
     for (const std::string& feature : features) {
       feature_array.push_back(feature);
@@ -649,18 +677,156 @@ llvm::json::Value IR::ToJson() const {
   }
 
   llvm::json::Object result{
-      {"public_headers", public_headers},
-      {"current_target", current_target},
-      {"items", std::move(json_items)},
+      {"public_headers", ir.public_headers},
+      {"current_target", ir.current_target},
       {"top_level_item_ids", std::move(top_level_ids)},
       {"crubit_features", std::move(features_json)},
   };
-  if (!crate_root_path.empty()) {
-    result["crate_root_path"] = crate_root_path;
+  if (!ir.crate_root_path.empty()) {
+    result["crate_root_path"] = ir.crate_root_path;
+  }
+  return result;
+}
+
+llvm::json::Value IR::ToJson() const {
+  std::vector<llvm::json::Value> json_items;
+  json_items.reserve(items.size());
+  for (const auto& item : items) {
+    std::visit([&](auto&& item) { json_items.push_back(item.ToJson()); }, item);
   }
+  CHECK_EQ(json_items.size(), items.size());
+
+  llvm::json::Object result = IrFieldsWithoutItemsToJson(*this);
+  result["items"] = std::move(json_items);
   return std::move(result);
 }
 
+namespace {
+
+// Value tags of the binary IR encoding. Need to be kept in sync with `tag` in
+// `ir_binary.rs`.
+enum class BinaryIrTag : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,
+  kUint = 4,
+  kDouble = 5,
+  kString = 6,
+  kStringRef = 7,
+  kArray = 8,
+  kObject = 9,
+};
+
+// Appends the binary encoding of JSON values to a string. See `ir_binary.rs`
+// for the description of the format.
+class BinaryIrWriter {
+ public:
+  explicit BinaryIrWriter(std::string& out) : out_(out) {}
+
+  void WriteTag(BinaryIrTag tag) { out_.push_back(static_cast<char>(tag)); }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  // Writes `str` inline on its first occurrence, and as a reference to the
+  // first occurrence afterwards.
+  void WriteString(llvm::StringRef str) {
+    absl::string_view key(str.data(), str.size());
+    if (auto it = string_ids_.find(key); it != string_ids_.end()) {
+      WriteTag(BinaryIrTag::kStringRef);
+      WriteVarint(it->second);
+      return;
+    }
+    uint64_t id = string_ids_.size();
+    string_ids_.emplace(key, id);
+    WriteTag(BinaryIrTag::kString);
+    WriteVarint(str.size());
+    out_.append(str.data(), str.size());
+  }
+
+  void WriteValue(const llvm::json::Value& value) {
+    switch (value.kind()) {
+      case llvm::json::Value::Null:
+        WriteTag(BinaryIrTag::kNull);
+        return;
+      case llvm::json::Value::Boolean:
+        WriteTag(*value.getAsBoolean() ? BinaryIrTag::kTrue
+                                       : BinaryIrTag::kFalse);
+        return;
+      case llvm::json::Value::Number:
+        if (auto i = value.getAsInteger()) {
+          WriteTag(BinaryIrTag::kInt);
+          // Zigzag encoding keeps small negative numbers small.
+          WriteVarint((static_cast<uint64_t>(*i) << 1) ^
+                      static_cast<uint64_t>(*i >> 63));
+        } else if (auto u = value.getAsUINT64()) {
+          WriteTag(BinaryIrTag::kUint);
+          WriteVarint(*u);
+        } else {
+          double d = *value.getAsNumber();
+          uint64_t bits;
+          std::memcpy(&bits, &d, sizeof(bits));
+          WriteTag(BinaryIrTag::kDouble);
+          for (int i = 0; i < 8; ++i) {
+            out_.push_back(static_cast<char>(bits >> (8 * i)));
+          }
+        }
+        return;
+      case llvm::json::Value::String:
+        WriteString(*value.getAsString());
+        return;
+      case llvm::json::Value::Array: {
+        const llvm::json::Array& array = *value.getAsArray();
+        WriteTag(BinaryIrTag::kArray);
+        WriteVarint(array.size());
+        for (const llvm::json::Value& element : array) {
+          WriteValue(element);
+        }
+        return;
+      }
+      case llvm::json::Value::Object:
+        WriteObject(*value.getAsObject());
+        return;
+    }
+  }
+
+  // Writes the entries of `object`, and `extra_entries` more entries which the
+  // caller is expected to write afterwards.
+  void WriteObject(const llvm::json::Object& object, size_t extra_entries = 0) {
+    WriteTag(BinaryIrTag::kObject);
+    WriteVarint(object.size() + extra_entries);
+    for (const auto& [key, field] : object) {
+      WriteString(key);
+      WriteValue(field);
+    }
+  }
+
+ private:
+  std::string& out_;
+  absl::flat_hash_map<std::string, uint64_t> string_ids_;
+};
+
+}  // namespace
+
+std::string IrToBinary(const IR& ir) {
+  std::string result(kBinaryIrMagic);
+  BinaryIrWriter writer(result);
+  writer.WriteObject(IrFieldsWithoutItemsToJson(ir), /*extra_entries=*/1);
+  writer.WriteString("items");
+  writer.WriteTag(BinaryIrTag::kArray);
+  writer.WriteVarint(ir.items.size());
+  for (const auto& item : ir.items) {
+    std::visit([&](auto&& item) { writer.WriteValue(item.ToJson()); }, item);
+  }
+  return result;
+}
+
 std::string ItemToString(const IR::Item& item) {
   return std::visit(
       [&](auto&& item) { return llvm::formatv("{0}", item.ToJson()); }, item);
@@ -30,6 +30,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "common/string_interner.h"
 #include "common/strong_int.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "clang/AST/DeclBase.h"
@@ -289,19 +290,23 @@ inline std::ostream& operator<<(std::ostream& o, const MappedType& type) {
 //
 // Invariants:
 //     `identifier` cannot be empty.
+//
+// Identifiers are interned, since the same names (of parameters, types,
+// namespaces, ...) recur throughout the IR: copies are cheap, and don't
+// allocate.
 class Identifier {
  public:
-  explicit Identifier(std::string identifier)
-      : identifier_(std::move(identifier)) {
-    CHECK(!identifier_.empty());
+  explicit Identifier(absl::string_view identifier)
+      : identifier_(&InternString(identifier)) {
+    CHECK(!identifier_->empty());
   }
 
-  absl::string_view Ident() const { return identifier_; }
+  absl::string_view Ident() const { return *identifier_; }
 
   llvm::json::Value ToJson() const;
 
  private:
-  std::string identifier_;
+  const std::string* identifier_;
 };
 
 inline std::ostream& operator<<(std::ostream& o, const Identifier& id) {
@@ -406,6 +411,9 @@ struct MemberFuncMetadata {
     ReferenceQualification reference = kUnqualified;
     bool is_const = false;
     bool is_virtual = false;
+    // Whether calls to the method never dispatch to an override (because the
+    // method or its class is `final`).
+    bool is_final = false;
   };
 
   llvm::json::Value ToJson() const;
@@ -440,6 +448,19 @@ struct Func {
   std::optional<std::string> unknown_attr;
   bool has_c_calling_convention = true;
   bool is_member_or_descendant_of_class_template = false;
+  // Whether the function is annotated with `CRUBIT_INTERNAL_NO_THUNK`, i.e.
+  // its definition is asserted to be emitted by the C++ library, even if it is
+  // inline or a member of a class template.
+  bool has_no_thunk_attribute = false;
+  // Whether the function is annotated with `CRUBIT_INTERNAL_BATCH`, i.e. its
+  // bindings should include an entry point that calls it over a slice.
+  bool has_batch_attribute = false;
+  // Whether the function is defaulted (`= default`), e.g. a defaulted
+  // comparison operator.
+  bool is_defaulted = false;
+  // The name given by `CRUBIT_INTERNAL_RUST_NAME`, if any, which replaces the
+  // C++ name of the function in its Rust bindings.
+  std::optional<std::string> rust_name;
   std::string source_loc;
   ItemId id;
   std::optional<ItemId> enclosing_item_id;
@@ -658,6 +679,10 @@ struct Record {
   // in).
   bool is_explicit_class_template_instantiation_definition = false;
 
+  // Whether the record is annotated with `CRUBIT_INTERNAL_COLUMN_VIEW`, i.e.
+  // its bindings should include column views of its fields.
+  bool has_column_view_attribute = false;
+
   std::vector<ItemId> child_item_ids;
   std::optional<ItemId> enclosing_item_id;
 };
@@ -692,6 +717,9 @@ struct Enum {
   MappedType underlying_type;
   std::optional<std::vector<Enumerator>> enumerators;
   std::optional<std::string> unknown_attr;
+  // Whether the enum is annotated with `CRUBIT_INTERNAL_DENSE_ENUM`, i.e. its
+  // bindings should include a Rust `enum` with a variant per enumerator.
+  bool has_dense_attribute = false;
   std::optional<ItemId> enclosing_item_id;
 };
 
@@ -717,6 +745,24 @@ inline std::ostream& operator<<(std::ostream& o, const TypeAlias& t) {
   return o << std::string(llvm::formatv("{0:2}", t.ToJson()));
 }
 
+// A variable of integral, enum or `bool` type whose value is known at compile
+// time (e.g. `constexpr int kSize = 42;` or `static const int kSize = 42;` in
+// a class). Its value is evaluated during import, so that the bindings can be
+// a Rust `const` rather than a thunk that reads the variable.
+struct Constant {
+  llvm::json::Value ToJson() const;
+
+  Identifier identifier;
+  ItemId id;
+  BazelLabel owning_target;
+  std::optional<std::string> doc_comment;
+  std::optional<std::string> unknown_attr;
+  MappedType type;
+  IntegerConstant value;
+  std::string source_loc;
+  std::optional<ItemId> enclosing_item_id;
+};
+
 // An error that stores its format string as well as the formatted message.
 class FormattedError final {
  public:
@@ -895,7 +941,7 @@ struct IR {
 
   using Item = std::variant<Func, Record, IncompleteRecord, Enum, TypeAlias,
                             UnsupportedItem, Comment, Namespace, UseMod,
-                            TypeMapOverride>;
+                            TypeMapOverride, Constant>;
   std::vector<Item> items;
   std::vector<ItemId> top_level_item_ids;
   // Empty string signals that the bindings should be generated in the crate
@@ -920,6 +966,19 @@ inline std::string IrToJson(const IR& ir) {
   return std::string(llvm::formatv("{0:2}", ir.ToJson()));
 }
 
+// Prefix of the binary IR encoding produced by `IrToBinary`. Needs to be kept
+// in sync with `MAGIC` in `ir_binary.rs`.
+inline constexpr absl::string_view kBinaryIrMagic = "CRUBITIR1";
+
+// Serializes `ir` into a compact binary encoding of the same data model as
+// `IR::ToJson`, with interned strings. This is how the IR is handed over to
+// the Rust code generator; `IrToJson` remains the human-readable format (e.g.
+// for `--ir_out`).
+//
+// Items are converted one at a time, so the JSON tree of the whole IR is never
+// materialized.
+std::string IrToBinary(const IR& ir);
+
 inline std::ostream& operator<<(std::ostream& o, const IR& ir) {
   return o << IrToJson(ir);
 }
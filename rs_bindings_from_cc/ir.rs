@@ -11,14 +11,18 @@ use code_gen_utils::{make_rs_ident, NamespaceQualifier};
 use crubit_feature::CrubitFeature;
 use proc_macro2::{Ident, TokenStream};
 use quote::{quote, ToTokens};
+use serde::de::{self, Deserializer, Visitor};
 use serde::Deserialize;
-use std::cell::OnceCell;
+use std::cell::{OnceCell, RefCell};
 use std::collections::hash_map::{Entry, HashMap};
+use std::collections::HashSet;
 use std::fmt::{self, Debug, Display, Formatter};
 use std::hash::{Hash, Hasher};
 use std::io::Read;
 use std::rc::Rc;
 
+mod ir_binary;
+
 /// Common data about all items.
 pub trait GenericItem {
     fn id(&self) -> ItemId;
@@ -55,10 +59,82 @@ where
 
 /// Deserialize `IR` from JSON given as a reader.
 pub fn deserialize_ir<R: Read>(reader: R) -> Result<IR> {
-    let flat_ir = serde_json::from_reader(reader)?;
+    let flat_ir = with_string_interner(|| serde_json::from_reader(reader))?;
+    Ok(make_ir(flat_ir))
+}
+
+/// Deserialize `IR` from `bytes`, which are either in the binary encoding
+/// produced by `IrToBinary` (see `ir.h`) or in JSON.
+pub fn deserialize_ir_from_bytes(bytes: &[u8]) -> Result<IR> {
+    if !ir_binary::is_binary_ir(bytes) {
+        return deserialize_ir(bytes);
+    }
+    let flat_ir = with_string_interner(|| ir_binary::from_slice(bytes))?;
     Ok(make_ir(flat_ir))
 }
 
+thread_local! {
+    /// The strings deserialized by `deserialize_interned` so far, while
+    /// `with_string_interner` is running.
+    static STRING_INTERNER: RefCell<Option<HashSet<Rc<str>>>> = const { RefCell::new(None) };
+}
+
+/// Runs `f`, which deserializes an IR, in such a way that the strings that
+/// recur all over the IR (identifiers, type names, target labels, ...) are
+/// allocated once and shared, rather than allocated for every occurrence.
+fn with_string_interner<T>(f: impl FnOnce() -> T) -> T {
+    let previous = STRING_INTERNER.replace(Some(HashSet::new()));
+    let result = f();
+    STRING_INTERNER.set(previous);
+    result
+}
+
+fn intern(s: &str) -> Rc<str> {
+    STRING_INTERNER.with_borrow_mut(|interner| {
+        let Some(interner) = interner else {
+            return s.into();
+        };
+        if let Some(interned) = interner.get(s) {
+            return interned.clone();
+        }
+        let interned: Rc<str> = s.into();
+        interner.insert(interned.clone());
+        interned
+    })
+}
+
+/// An `Rc<str>` that is deserialized through the `STRING_INTERNER`.
+struct Interned(Rc<str>);
+
+impl<'de> Deserialize<'de> for Interned {
+    fn deserialize<D: Deserializer<'de>>(deserializer: D) -> Result<Self, D::Error> {
+        struct InternedVisitor;
+        impl<'de> Visitor<'de> for InternedVisitor {
+            type Value = Interned;
+            fn expecting(&self, f: &mut Formatter<'_>) -> fmt::Result {
+                f.write_str("a string")
+            }
+            fn visit_str<E: de::Error>(self, s: &str) -> Result<Interned, E> {
+                Ok(Interned(intern(s)))
+            }
+        }
+        deserializer.deserialize_str(InternedVisitor)
+    }
+}
+
+/// `deserialize_with` function for `Rc<str>` fields whose values recur often in
+/// the IR. See `with_string_interner`.
+fn deserialize_interned<'de, D: Deserializer<'de>>(deserializer: D) -> Result<Rc<str>, D::Error> {
+    Interned::deserialize(deserializer).map(|interned| interned.0)
+}
+
+/// Like `deserialize_interned`, but for `Option<Rc<str>>` fields.
+fn deserialize_interned_opt<'de, D: Deserializer<'de>>(
+    deserializer: D,
+) -> Result<Option<Rc<str>>, D::Error> {
+    Option::<Interned>::deserialize(deserializer).map(|interned| interned.map(|i| i.0))
+}
+
 /// Create a testing `IR` instance from given parts. This function does not use
 /// any mock values.
 pub fn make_ir_from_parts<CrubitFeatures>(
@@ -137,10 +213,10 @@ fn make_ir(flat_ir: FlatIR) -> IR {
             _ => None,
         })
         .for_each(|(canonical_id, id)| {
-            let current_count =
-                *namespace_id_to_number_of_reopened_namespaces.entry(canonical_id).or_insert(0);
-            reopened_namespace_id_to_idx.insert(id, current_count);
-            namespace_id_to_number_of_reopened_namespaces.insert(canonical_id, current_count + 1);
+            let count =
+                namespace_id_to_number_of_reopened_namespaces.entry(canonical_id).or_insert(0);
+            reopened_namespace_id_to_idx.insert(id, *count);
+            *count += 1;
         });
 
     let mut function_name_to_functions = HashMap::<UnqualifiedIdentifier, Vec<Rc<Func>>>::new();
@@ -155,6 +231,18 @@ fn make_ir(flat_ir: FlatIR) -> IR {
             function_name_to_functions.entry(f.name.clone()).or_default().push(f.clone());
         });
 
+    let mut item_idxs_by_kind = ItemIdxsByKind::default();
+    for (idx, item) in flat_ir.items.iter().enumerate() {
+        match item {
+            Item::Func(_) => item_idxs_by_kind.funcs.push(idx),
+            Item::Record(_) => item_idxs_by_kind.records.push(idx),
+            Item::UnsupportedItem(_) => item_idxs_by_kind.unsupported_items.push(idx),
+            Item::Comment(_) => item_idxs_by_kind.comments.push(idx),
+            Item::Namespace(_) => item_idxs_by_kind.namespaces.push(idx),
+            _ => {}
+        }
+    }
+
     IR {
         flat_ir,
         item_id_to_item_idx,
@@ -162,12 +250,14 @@ fn make_ir(flat_ir: FlatIR) -> IR {
         namespace_id_to_number_of_reopened_namespaces,
         reopened_namespace_id_to_idx,
         function_name_to_functions,
+        item_idxs_by_kind,
     }
 }
 
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct HeaderName {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub name: Rc<str>,
 }
 
@@ -179,6 +269,7 @@ pub struct LifetimeId(pub i32);
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct LifetimeName {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub name: Rc<str>,
     pub id: LifetimeId,
 }
@@ -186,6 +277,7 @@ pub struct LifetimeName {
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct RsType {
+    #[serde(default, deserialize_with = "deserialize_interned_opt")]
     pub name: Option<Rc<str>>,
     pub lifetime_args: Rc<[LifetimeId]>,
     pub type_args: Rc<[RsType]>,
@@ -202,6 +294,7 @@ impl RsType {
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct CcType {
+    #[serde(default, deserialize_with = "deserialize_interned_opt")]
     pub name: Option<Rc<str>>,
     pub is_const: bool,
     pub type_args: Vec<CcType>,
@@ -234,6 +327,7 @@ pub struct MappedType {
 #[derive(PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct Identifier {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub identifier: Rc<str>,
 }
 
@@ -259,6 +353,7 @@ pub struct IntegerConstant {
 #[derive(PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct Operator {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub name: Rc<str>,
 }
 
@@ -297,7 +392,7 @@ impl ToTokens for ItemId {
 /// A Bazel label, e.g. `//foo:bar`.
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(transparent)]
-pub struct BazelLabel(pub Rc<str>);
+pub struct BazelLabel(#[serde(deserialize_with = "deserialize_interned")] pub Rc<str>);
 
 impl BazelLabel {
     /// Returns the target name. E.g. `bar` for `//foo:bar`.
@@ -421,6 +516,9 @@ pub struct InstanceMethodMetadata {
     pub reference: ReferenceQualification,
     pub is_const: bool,
     pub is_virtual: bool,
+    /// Whether calls to the method never dispatch to an override (because the
+    /// method or its class is `final`).
+    pub is_final: bool,
 }
 
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
@@ -480,6 +578,20 @@ pub struct Func {
     pub unknown_attr: Option<Rc<str>>,
     pub has_c_calling_convention: bool,
     pub is_member_or_descendant_of_class_template: bool,
+    /// Whether the function is annotated with `CRUBIT_INTERNAL_NO_THUNK`,
+    /// which asserts that the C++ library emits a definition of the
+    /// function, even if it is inline or a member of a class template.
+    pub has_no_thunk_attribute: bool,
+    /// Whether the function is annotated with `CRUBIT_INTERNAL_BATCH`, which
+    /// requests an additional `<name>_batch` function that calls it on every
+    /// element of a slice.
+    pub has_batch_attribute: bool,
+    /// Whether the function is defaulted (`= default`), e.g. a defaulted
+    /// comparison operator.
+    pub is_defaulted: bool,
+    /// The name given by `CRUBIT_INTERNAL_RUST_NAME`, if any, which replaces
+    /// the C++ name of the function in its Rust bindings.
+    pub rust_name: Option<Rc<str>>,
     pub source_loc: Rc<str>,
     pub id: ItemId,
     pub enclosing_item_id: Option<ItemId>,
@@ -575,7 +687,9 @@ pub struct BaseClass {
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct IncompleteRecord {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub cc_name: Rc<str>,
+    #[serde(deserialize_with = "deserialize_interned")]
     pub rs_name: Rc<str>,
     pub id: ItemId,
     pub owning_target: BazelLabel,
@@ -644,6 +758,7 @@ pub struct TemplateArg {
 
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 pub struct TemplateSpecialization {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub template_name: Rc<str>,
     pub template_args: Vec<TemplateArg>,
 }
@@ -651,8 +766,11 @@ pub struct TemplateSpecialization {
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct Record {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub rs_name: Rc<str>,
+    #[serde(deserialize_with = "deserialize_interned")]
     pub cc_name: Rc<str>,
+    #[serde(deserialize_with = "deserialize_interned")]
     pub cc_preferred_name: Rc<str>,
     pub mangled_cc_name: Rc<str>,
     pub id: ItemId,
@@ -685,6 +803,9 @@ pub struct Record {
     pub record_type: RecordType,
     pub is_aggregate: bool,
     pub is_anon_record_with_typedef: bool,
+    /// Whether the record is annotated with `CRUBIT_INTERNAL_COLUMN_VIEW`,
+    /// which requests column views of its fields.
+    pub has_column_view_attribute: bool,
     pub child_item_ids: Vec<ItemId>,
     pub enclosing_item_id: Option<ItemId>,
 }
@@ -744,6 +865,9 @@ pub struct Enum {
     pub enumerators: Option<Vec<Enumerator>>,
     /// A human-readable list of attributes that Crubit doesn't understand.
     pub unknown_attr: Option<Rc<str>>,
+    /// Whether the enum is annotated with `CRUBIT_INTERNAL_DENSE_ENUM`, which
+    /// requests an additional Rust `enum` with a variant per enumerator.
+    pub has_dense_attribute: bool,
     pub enclosing_item_id: Option<ItemId>,
 }
 
@@ -806,6 +930,39 @@ impl Display for TypeAlias {
     }
 }
 
+/// A variable of integral, enum or `bool` type whose value was evaluated by
+/// Clang, e.g. `constexpr int kSize = 42;`.
+#[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub struct Constant {
+    pub identifier: Identifier,
+    pub id: ItemId,
+    pub owning_target: BazelLabel,
+    pub doc_comment: Option<Rc<str>>,
+    /// A human-readable list of attributes that Crubit doesn't understand.
+    pub unknown_attr: Option<Rc<str>>,
+    #[serde(rename(deserialize = "type"))]
+    pub type_: MappedType,
+    pub value: IntegerConstant,
+    pub source_loc: Rc<str>,
+    pub enclosing_item_id: Option<ItemId>,
+}
+
+impl GenericItem for Constant {
+    fn id(&self) -> ItemId {
+        self.id
+    }
+    fn debug_name(&self, _: &IR) -> Rc<str> {
+        self.identifier.identifier.clone()
+    }
+    fn source_loc(&self) -> Option<Rc<str>> {
+        Some(self.source_loc.clone())
+    }
+    fn unknown_attr(&self) -> Option<Rc<str>> {
+        self.unknown_attr.clone()
+    }
+}
+
 /// A wrapper type that does not contribute to equality or hashing. All
 /// instances are equal.
 #[derive(Clone, Copy, Default)]
@@ -832,6 +989,7 @@ impl<T> Hash for IgnoredField<T> {
 #[derive(Debug, PartialEq, Eq, Hash, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct FormattedError {
+    #[serde(deserialize_with = "deserialize_interned")]
     pub fmt: Rc<str>,
     pub message: Rc<str>,
 }
@@ -1027,6 +1185,7 @@ pub enum Item {
     Namespace(Rc<Namespace>),
     UseMod(Rc<UseMod>),
     TypeMapOverride(Rc<TypeMapOverride>),
+    Constant(Rc<Constant>),
 }
 
 macro_rules! forward_item {
@@ -1042,6 +1201,7 @@ macro_rules! forward_item {
             Item::Namespace($item_name) => $expr,
             Item::UseMod($item_name) => $expr,
             Item::TypeMapOverride($item_name) => $expr,
+            Item::Constant($item_name) => $expr,
         }
     };
 }
@@ -1090,6 +1250,7 @@ impl Item {
             Item::UnsupportedItem(..) => None,
             Item::UseMod(..) => None,
             Item::TypeMapOverride(..) => None,
+            Item::Constant(constant) => constant.enclosing_item_id,
         }
     }
 
@@ -1115,6 +1276,7 @@ impl Item {
             Item::Namespace(ns) => Some(&ns.owning_target),
             Item::UseMod(..) => None,
             Item::TypeMapOverride(type_override) => Some(&type_override.owning_target),
+            Item::Constant(constant) => Some(&constant.owning_target),
         }
     }
 
@@ -1132,6 +1294,7 @@ impl Item {
             Item::Namespace(_) => false,
             Item::UseMod(_) => false,
             Item::TypeMapOverride(_) => false,
+            Item::Constant(_) => false,
         }
     }
 }
@@ -1269,6 +1432,17 @@ pub struct IR {
     namespace_id_to_number_of_reopened_namespaces: HashMap<ItemId, usize>,
     reopened_namespace_id_to_idx: HashMap<ItemId, usize>,
     function_name_to_functions: HashMap<UnqualifiedIdentifier, Vec<Rc<Func>>>,
+    item_idxs_by_kind: ItemIdxsByKind,
+}
+
+/// The indexes of the items of some kinds in `flat_ir.items`, in order.
+#[derive(PartialEq, Debug, Default)]
+struct ItemIdxsByKind {
+    funcs: Vec<usize>,
+    records: Vec<usize>,
+    unsupported_items: Vec<usize>,
+    comments: Vec<usize>,
+    namespaces: Vec<usize>,
 }
 
 impl IR {
@@ -1276,10 +1450,16 @@ impl IR {
         self.flat_ir.items.iter()
     }
 
+    fn items_at<'a>(&'a self, idxs: &'a [usize]) -> impl Iterator<Item = &'a Item> + 'a {
+        idxs.iter().map(|idx| &self.flat_ir.items[*idx])
+    }
+
     pub fn top_level_item_ids(&self) -> impl Iterator<Item = &ItemId> {
         self.flat_ir.top_level_item_ids.iter()
     }
 
+    /// Returns the items for modification. The indexes of the IR are not
+    /// updated, so the modification must not change the kind of items.
     pub fn items_mut(&mut self) -> impl Iterator<Item = &mut Item> {
         self.flat_ir.items.iter_mut()
     }
@@ -1289,35 +1469,35 @@ impl IR {
     }
 
     pub fn functions(&self) -> impl Iterator<Item = &Rc<Func>> {
-        self.items().filter_map(|item| match item {
+        self.items_at(&self.item_idxs_by_kind.funcs).filter_map(|item| match item {
             Item::Func(func) => Some(func),
             _ => None,
         })
     }
 
     pub fn records(&self) -> impl Iterator<Item = &Rc<Record>> {
-        self.items().filter_map(|item| match item {
+        self.items_at(&self.item_idxs_by_kind.records).filter_map(|item| match item {
             Item::Record(func) => Some(func),
             _ => None,
         })
     }
 
     pub fn unsupported_items(&self) -> impl Iterator<Item = &Rc<UnsupportedItem>> {
-        self.items().filter_map(|item| match item {
+        self.items_at(&self.item_idxs_by_kind.unsupported_items).filter_map(|item| match item {
             Item::UnsupportedItem(unsupported_item) => Some(unsupported_item),
             _ => None,
         })
     }
 
     pub fn comments(&self) -> impl Iterator<Item = &Rc<Comment>> {
-        self.items().filter_map(|item| match item {
+        self.items_at(&self.item_idxs_by_kind.comments).filter_map(|item| match item {
             Item::Comment(comment) => Some(comment),
             _ => None,
         })
     }
 
     pub fn namespaces(&self) -> impl Iterator<Item = &Rc<Namespace>> {
-        self.items().filter_map(|item| match item {
+        self.items_at(&self.item_idxs_by_kind.namespaces).filter_map(|item| match item {
             Item::Namespace(ns) => Some(ns),
             _ => None,
         })
@@ -1398,6 +1578,29 @@ impl IR {
         format!("{:?}", self.flat_ir)
     }
 
+    /// Returns a Debug print of the `flat_ir` that doesn't depend on the
+    /// iteration order of `HashMap`s, so that equal IRs print equally.
+    ///
+    /// Note that `ItemId`s are only unique within one IR (they are derived from
+    /// addresses of Clang decls), so callers that compare IRs from different
+    /// runs need to canonicalize them.
+    pub fn flat_ir_stable_debug_print(&self) -> String {
+        let FlatIR {
+            public_headers,
+            current_target,
+            items,
+            top_level_item_ids,
+            crate_root_path,
+            crubit_features,
+        } = &self.flat_ir;
+        let mut crubit_features: Vec<_> = crubit_features.iter().collect();
+        crubit_features.sort_by(|(a, _), (b, _)| a.0.cmp(&b.0));
+        format!(
+            "{public_headers:?} {current_target:?} {items:?} {top_level_item_ids:?} \
+            {crate_root_path:?} {crubit_features:?}"
+        )
+    }
+
     pub fn get_lifetime(&self, lifetime_id: LifetimeId) -> Option<&LifetimeName> {
         self.lifetimes.get(&lifetime_id)
     }
@@ -1529,6 +1732,22 @@ mod tests {
         assert_eq!(ir.flat_ir, expected);
     }
 
+    #[gtest]
+    fn test_deserialize_ir_shares_recurring_strings() {
+        let input = r#"
+        {
+            "public_headers": [{ "name": "foo/bar.h" }, { "name": "foo/bar.h" }],
+            "current_target": "//foo:bar",
+            "crubit_features": { "//foo:bar": [] }
+        }
+        "#;
+        let ir = deserialize_ir(input.as_bytes()).unwrap();
+        let headers = &ir.flat_ir.public_headers;
+        assert!(Rc::ptr_eq(&headers[0].name, &headers[1].name));
+        let feature_target = ir.flat_ir.crubit_features.keys().next().unwrap();
+        assert!(Rc::ptr_eq(&ir.flat_ir.current_target.0, &feature_target.0));
+    }
+
     #[gtest]
     fn test_empty_crate_root_path() {
         let input = "{ \"current_target\": \"//foo:bar\" }";
@@ -1548,6 +1767,66 @@ mod tests {
         assert_eq!(ir.crate_root_path().as_deref(), Some("__cc_template_instantiations_rs_api"));
     }
 
+    #[gtest]
+    fn test_deserialize_ir_from_bytes_accepts_json() {
+        let input = "{ \"current_target\": \"//foo:bar\" }";
+        let ir = deserialize_ir_from_bytes(input.as_bytes()).unwrap();
+        assert_eq!(ir.current_target(), &BazelLabel::from("//foo:bar"));
+    }
+
+    #[gtest]
+    fn test_deserialize_ir_from_bytes_accepts_binary() {
+        let mut input = ir_binary::MAGIC.to_vec();
+        input.extend([/* OBJECT */ 9, 1, /* STRING */ 6, 14]);
+        input.extend(b"current_target");
+        input.extend([/* STRING */ 6, 9]);
+        input.extend(b"//foo:bar");
+        let ir = deserialize_ir_from_bytes(&input).unwrap();
+        assert_eq!(ir.current_target(), &BazelLabel::from("//foo:bar"));
+    }
+
+    fn namespace(id: usize, enclosing_item_id: Option<usize>, owning_target: &str) -> Item {
+        Namespace {
+            name: Identifier { identifier: format!("ns{id}").into() },
+            id: ItemId::new_for_testing(id),
+            canonical_namespace_id: ItemId::new_for_testing(id),
+            unknown_attr: None,
+            owning_target: owning_target.into(),
+            child_item_ids: vec![],
+            enclosing_item_id: enclosing_item_id.map(ItemId::new_for_testing),
+            is_inline: false,
+        }
+        .into()
+    }
+
+    #[gtest]
+    fn test_item_indexes() {
+        let comment: Item =
+            Comment { text: "comment".into(), id: ItemId::new_for_testing(4) }.into();
+        let ir = make_ir_from_parts::<flagset::FlagSet<CrubitFeature>>(
+            vec![
+                namespace(1, None, "//foo:a"),
+                namespace(2, Some(1), "//foo:b"),
+                namespace(3, Some(1), "//foo:a"),
+                comment,
+            ],
+            vec![],
+            "//foo:a".into(),
+            vec![],
+            None,
+            HashMap::new(),
+        );
+        let ids_for_testing =
+            |ids: &[usize]| ids.iter().copied().map(ItemId::new_for_testing).collect::<Vec<_>>();
+
+        assert_eq!(
+            ir.namespaces().map(|ns| ns.id).collect::<Vec<_>>(),
+            ids_for_testing(&[1, 2, 3])
+        );
+        assert_eq!(ir.comments().count(), 1);
+        assert_eq!(ir.functions().count(), 0);
+    }
+
     #[gtest]
     fn test_bazel_label_target() {
         let label: BazelLabel = "//foo:bar".into();
@@ -0,0 +1,392 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! `serde` deserializer for the compact binary IR encoding produced by
+//! `IrToBinary` in `rs_bindings_from_cc/ir.cc`.
+//!
+//! The encoding mirrors the JSON data model, so that the same `Deserialize`
+//! impls work for both encodings:
+//!
+//! * The input starts with `MAGIC`.
+//! * Every value starts with a one byte tag (see `tag`).
+//! * Integers and lengths are LEB128 varints; signed integers are zigzag
+//!   encoded.
+//! * Strings (including object keys) are interned: the first occurrence is
+//!   written inline (`tag::STRING`) and implicitly assigned the next index,
+//!   later occurrences refer to that index (`tag::STRING_REF`).
+
+use serde::de::{
+    self, DeserializeSeed, EnumAccess, IntoDeserializer, MapAccess, SeqAccess, VariantAccess,
+    Visitor,
+};
+use serde::Deserialize;
+use std::fmt::{self, Display, Formatter};
+
+/// Prefix of the binary encoding. Needs to be kept in sync with
+/// `kBinaryIrMagic` in `ir.h`.
+pub const MAGIC: &[u8] = b"CRUBITIR1";
+
+/// Value tags. Need to be kept in sync with `BinaryIrTag` in `ir.cc`.
+mod tag {
+    pub const NULL: u8 = 0;
+    pub const FALSE: u8 = 1;
+    pub const TRUE: u8 = 2;
+    pub const INT: u8 = 3;
+    pub const UINT: u8 = 4;
+    pub const DOUBLE: u8 = 5;
+    pub const STRING: u8 = 6;
+    pub const STRING_REF: u8 = 7;
+    pub const ARRAY: u8 = 8;
+    pub const OBJECT: u8 = 9;
+}
+
+#[derive(Debug)]
+pub struct DecodeError(String);
+
+impl Display for DecodeError {
+    fn fmt(&self, f: &mut Formatter<'_>) -> fmt::Result {
+        write!(f, "Invalid binary IR: {}", self.0)
+    }
+}
+
+impl std::error::Error for DecodeError {}
+
+impl de::Error for DecodeError {
+    fn custom<T: Display>(msg: T) -> Self {
+        DecodeError(msg.to_string())
+    }
+}
+
+type DecodeResult<T> = std::result::Result<T, DecodeError>;
+
+/// Returns true if `bytes` start with the binary IR `MAGIC`.
+pub fn is_binary_ir(bytes: &[u8]) -> bool {
+    bytes.starts_with(MAGIC)
+}
+
+/// Deserializes a `T` from `bytes` in the binary IR encoding.
+pub fn from_slice<'de, T: Deserialize<'de>>(bytes: &'de [u8]) -> DecodeResult<T> {
+    let Some(input) = bytes.strip_prefix(MAGIC) else {
+        return Err(DecodeError("missing magic prefix".to_string()));
+    };
+    let mut deserializer = BinaryDeserializer { input, strings: vec![] };
+    let value = T::deserialize(&mut deserializer)?;
+    if !deserializer.input.is_empty() {
+        return Err(DecodeError(format!("{} trailing bytes", deserializer.input.len())));
+    }
+    Ok(value)
+}
+
+struct BinaryDeserializer<'de> {
+    input: &'de [u8],
+    /// Interned strings, indexed by the order of their first occurrence.
+    strings: Vec<&'de str>,
+}
+
+impl<'de> BinaryDeserializer<'de> {
+    fn peek_tag(&self) -> DecodeResult<u8> {
+        self.input.first().copied().ok_or_else(|| DecodeError("unexpected end".to_string()))
+    }
+
+    fn read_tag(&mut self) -> DecodeResult<u8> {
+        let tag = self.peek_tag()?;
+        self.input = &self.input[1..];
+        Ok(tag)
+    }
+
+    fn read_bytes(&mut self, len: usize) -> DecodeResult<&'de [u8]> {
+        if self.input.len() < len {
+            return Err(DecodeError("unexpected end".to_string()));
+        }
+        let (bytes, rest) = self.input.split_at(len);
+        self.input = rest;
+        Ok(bytes)
+    }
+
+    fn read_varint(&mut self) -> DecodeResult<u64> {
+        let mut result: u64 = 0;
+        let mut shift = 0;
+        loop {
+            let byte = self.read_tag()?;
+            if shift >= 64 {
+                return Err(DecodeError("varint overflow".to_string()));
+            }
+            result |= u64::from(byte & 0x7f) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(result);
+            }
+            shift += 7;
+        }
+    }
+
+    fn read_len(&mut self) -> DecodeResult<usize> {
+        usize::try_from(self.read_varint()?).map_err(|_| DecodeError("length overflow".to_string()))
+    }
+
+    /// Reads the payload of a string whose `tag` has already been consumed.
+    fn read_string(&mut self, tag: u8) -> DecodeResult<&'de str> {
+        match tag {
+            tag::STRING => {
+                let len = self.read_len()?;
+                let s = std::str::from_utf8(self.read_bytes(len)?)
+                    .map_err(|e| DecodeError(e.to_string()))?;
+                self.strings.push(s);
+                Ok(s)
+            }
+            tag::STRING_REF => {
+                let idx = self.read_len()?;
+                self.strings
+                    .get(idx)
+                    .copied()
+                    .ok_or_else(|| DecodeError(format!("dangling string reference {idx}")))
+            }
+            _ => Err(DecodeError(format!("expected a string, got tag {tag}"))),
+        }
+    }
+}
+
+impl<'de, 'a> de::Deserializer<'de> for &'a mut BinaryDeserializer<'de> {
+    type Error = DecodeError;
+
+    fn deserialize_any<V: Visitor<'de>>(self, visitor: V) -> DecodeResult<V::Value> {
+        match self.read_tag()? {
+            tag::NULL => visitor.visit_unit(),
+            tag::FALSE => visitor.visit_bool(false),
+            tag::TRUE => visitor.visit_bool(true),
+            tag::INT => {
+                let zigzag = self.read_varint()?;
+                visitor.visit_i64(((zigzag >> 1) as i64) ^ -((zigzag & 1) as i64))
+            }
+            tag::UINT => visitor.visit_u64(self.read_varint()?),
+            tag::DOUBLE => {
+                let bytes = self.read_bytes(8)?;
+                visitor.visit_f64(f64::from_le_bytes(bytes.try_into().unwrap()))
+            }
+            tag @ (tag::STRING | tag::STRING_REF) => {
+                visitor.visit_borrowed_str(self.read_string(tag)?)
+            }
+            tag::ARRAY => {
+                let remaining = self.read_len()?;
+                visitor.visit_seq(Elements { de: self, remaining })
+            }
+            tag::OBJECT => {
+                let remaining = self.read_len()?;
+                visitor.visit_map(Elements { de: self, remaining })
+            }
+            tag => Err(DecodeError(format!("unknown tag {tag}"))),
+        }
+    }
+
+    fn deserialize_option<V: Visitor<'de>>(self, visitor: V) -> DecodeResult<V::Value> {
+        if self.peek_tag()? == tag::NULL {
+            self.read_tag()?;
+            visitor.visit_none()
+        } else {
+            visitor.visit_some(self)
+        }
+    }
+
+    fn deserialize_newtype_struct<V: Visitor<'de>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> DecodeResult<V::Value> {
+        visitor.visit_newtype_struct(self)
+    }
+
+    /// Enums use the same externally tagged representation as `serde_json`:
+    /// either a bare string (unit variants) or a single-entry object.
+    fn deserialize_enum<V: Visitor<'de>>(
+        self,
+        _name: &'static str,
+        _variants: &'static [&'static str],
+        visitor: V,
+    ) -> DecodeResult<V::Value> {
+        match self.read_tag()? {
+            tag @ (tag::STRING | tag::STRING_REF) => {
+                visitor.visit_enum(self.read_string(tag)?.into_deserializer())
+            }
+            tag::OBJECT => {
+                let len = self.read_len()?;
+                if len != 1 {
+                    return Err(DecodeError(format!("enum object with {len} entries")));
+                }
+                visitor.visit_enum(self)
+            }
+            tag => Err(DecodeError(format!("expected an enum, got tag {tag}"))),
+        }
+    }
+
+    serde::forward_to_deserialize_any! {
+        bool i8 i16 i32 i64 i128 u8 u16 u32 u64 u128 f32 f64 char str string
+        bytes byte_buf unit unit_struct seq tuple tuple_struct map struct
+        identifier ignored_any
+    }
+}
+
+/// Remaining elements of an array or entries of an object.
+struct Elements<'a, 'de> {
+    de: &'a mut BinaryDeserializer<'de>,
+    remaining: usize,
+}
+
+impl<'de, 'a> SeqAccess<'de> for Elements<'a, 'de> {
+    type Error = DecodeError;
+
+    fn next_element_seed<T: DeserializeSeed<'de>>(
+        &mut self,
+        seed: T,
+    ) -> DecodeResult<Option<T::Value>> {
+        if self.remaining == 0 {
+            return Ok(None);
+        }
+        self.remaining -= 1;
+        seed.deserialize(&mut *self.de).map(Some)
+    }
+
+    fn size_hint(&self) -> Option<usize> {
+        Some(self.remaining)
+    }
+}
+
+impl<'de, 'a> MapAccess<'de> for Elements<'a, 'de> {
+    type Error = DecodeError;
+
+    fn next_key_seed<K: DeserializeSeed<'de>>(&mut self, seed: K) -> DecodeResult<Option<K::Value>> {
+        if self.remaining == 0 {
+            return Ok(None);
+        }
+        self.remaining -= 1;
+        seed.deserialize(&mut *self.de).map(Some)
+    }
+
+    fn next_value_seed<V: DeserializeSeed<'de>>(&mut self, seed: V) -> DecodeResult<V::Value> {
+        seed.deserialize(&mut *self.de)
+    }
+
+    fn size_hint(&self) -> Option<usize> {
+        Some(self.remaining)
+    }
+}
+
+impl<'de, 'a> EnumAccess<'de> for &'a mut BinaryDeserializer<'de> {
+    type Error = DecodeError;
+    type Variant = Self;
+
+    fn variant_seed<V: DeserializeSeed<'de>>(self, seed: V) -> DecodeResult<(V::Value, Self)> {
+        let variant = seed.deserialize(&mut *self)?;
+        Ok((variant, self))
+    }
+}
+
+impl<'de, 'a> VariantAccess<'de> for &'a mut BinaryDeserializer<'de> {
+    type Error = DecodeError;
+
+    fn unit_variant(self) -> DecodeResult<()> {
+        de::Deserialize::deserialize(self)
+    }
+
+    fn newtype_variant_seed<T: DeserializeSeed<'de>>(self, seed: T) -> DecodeResult<T::Value> {
+        seed.deserialize(self)
+    }
+
+    fn tuple_variant<V: Visitor<'de>>(self, _len: usize, visitor: V) -> DecodeResult<V::Value> {
+        de::Deserializer::deserialize_seq(self, visitor)
+    }
+
+    fn struct_variant<V: Visitor<'de>>(
+        self,
+        _fields: &'static [&'static str],
+        visitor: V,
+    ) -> DecodeResult<V::Value> {
+        de::Deserializer::deserialize_map(self, visitor)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use googletest::prelude::*;
+    use std::collections::HashMap;
+
+    #[derive(Debug, PartialEq, Deserialize)]
+    enum Shape {
+        Empty,
+        Square(u32),
+        Rect { w: i32, h: i32 },
+    }
+
+    #[derive(Debug, PartialEq, Deserialize)]
+    struct Scene {
+        name: String,
+        shapes: Vec<Shape>,
+        scale: Option<f64>,
+        tags: HashMap<String, bool>,
+    }
+
+    fn encode_string(out: &mut Vec<u8>, s: &str) {
+        out.push(tag::STRING);
+        out.push(s.len() as u8);
+        out.extend_from_slice(s.as_bytes());
+    }
+
+    #[gtest]
+    fn test_roundtrip_with_interned_strings() {
+        let mut bytes = MAGIC.to_vec();
+        bytes.extend([tag::OBJECT, 4]);
+        encode_string(&mut bytes, "name"); // string #0
+        encode_string(&mut bytes, "scene"); // string #1
+        encode_string(&mut bytes, "shapes"); // string #2
+        bytes.extend([tag::ARRAY, 3]);
+        encode_string(&mut bytes, "Empty"); // string #3
+        bytes.extend([tag::OBJECT, 1]);
+        encode_string(&mut bytes, "Square"); // string #4
+        bytes.extend([tag::UINT, 0x80, 0x01]);
+        bytes.extend([tag::OBJECT, 1]);
+        encode_string(&mut bytes, "Rect"); // string #5
+        bytes.extend([tag::OBJECT, 2]);
+        encode_string(&mut bytes, "w"); // string #6
+        bytes.extend([tag::INT, 3]); // zigzag(-2)
+        encode_string(&mut bytes, "h"); // string #7
+        bytes.extend([tag::INT, 4]); // zigzag(2)
+        encode_string(&mut bytes, "scale"); // string #8
+        bytes.push(tag::NULL);
+        encode_string(&mut bytes, "tags"); // string #9
+        bytes.extend([tag::OBJECT, 2, tag::STRING_REF, 1, tag::TRUE, tag::STRING_REF, 0, tag::FALSE]);
+
+        let scene: Scene = from_slice(&bytes).unwrap();
+        assert_eq!(
+            scene,
+            Scene {
+                name: "scene".to_string(),
+                shapes: vec![Shape::Empty, Shape::Square(128), Shape::Rect { w: -2, h: 2 }],
+                scale: None,
+                tags: HashMap::from([("scene".to_string(), true), ("name".to_string(), false)]),
+            }
+        );
+    }
+
+    #[gtest]
+    fn test_missing_magic() {
+        assert!(!is_binary_ir(b"{}"));
+        expect_that!(from_slice::<()>(b"{}"), err(anything()));
+    }
+
+    #[gtest]
+    fn test_dangling_string_ref() {
+        let mut bytes = MAGIC.to_vec();
+        bytes.extend([tag::STRING_REF, 0]);
+        expect_that!(
+            from_slice::<String>(&bytes),
+            err(displays_as(contains_substring("dangling string reference 0")))
+        );
+    }
+
+    #[gtest]
+    fn test_trailing_bytes() {
+        let mut bytes = MAGIC.to_vec();
+        bytes.extend([tag::TRUE, tag::TRUE]);
+        expect_that!(from_slice::<bool>(&bytes), err(displays_as(contains_substring("trailing"))));
+    }
+}
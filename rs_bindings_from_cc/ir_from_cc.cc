@@ -28,6 +28,7 @@
 #include "rs_bindings_from_cc/decl_importer.h"
 #include "rs_bindings_from_cc/frontend_action.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/timing_report.h"
 #include "clang/Serialization/PCHContainerOperations.h"
 #include "clang/Tooling/Tooling.h"
 
@@ -208,19 +209,28 @@ absl::StatusOr<IR> IrFromCc(IrFromCcOptions options) {
                               "}  // namespace $0\n",
                               kInstantiationsNamespaceName);
   }
-  std::vector<std::string> args_as_strings = {
-      // Parse non-doc comments that are used as documentation
-      "-fparse-all-comments"};
+  std::vector<std::string> args_as_strings;
+  if (!options.lean_bindings) {
+    // Parse non-doc comments that are used as documentation
+    args_as_strings.push_back("-fparse-all-comments");
+  }
   args_as_strings.insert(args_as_strings.end(), options.clang_args.begin(),
                          options.clang_args.end());
 
   Invocation invocation(options.current_target, augmented_public_headers,
-                        options.headers_to_targets);
-  if (!clang::tooling::runToolOnCodeWithArgs(
-          std::make_unique<FrontendAction>(invocation),
-          virtual_input_file_content, args_as_strings, kVirtualInputPath,
-          "rs_bindings_from_cc",
-          std::make_shared<clang::PCHContainerOperations>(), file_contents)) {
+                        options.headers_to_targets,
+                        options.import_dependencies_lazily,
+                        options.timing_report, options.lean_bindings);
+  bool compiled;
+  {
+    TimingReport::ScopedPhase phase(options.timing_report, "clang_tool");
+    compiled = clang::tooling::runToolOnCodeWithArgs(
+        std::make_unique<FrontendAction>(invocation),
+        virtual_input_file_content, args_as_strings, kVirtualInputPath,
+        "rs_bindings_from_cc",
+        std::make_shared<clang::PCHContainerOperations>(), file_contents);
+  }
+  if (!compiled) {
     return absl::Status(absl::StatusCode::kInvalidArgument,
                         "Could not compile header contents");
   }
@@ -15,6 +15,7 @@
 #include "absl/types/span.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/timing_report.h"
 
 namespace crubit {
 
@@ -40,6 +41,9 @@ struct IrFromCcOptions final {
   absl::Span<const std::string> extra_instantiations = {};
   absl::flat_hash_map<BazelLabel, absl::flat_hash_set<std::string>>
       crubit_features = {};
+  bool import_dependencies_lazily = false;
+  bool lean_bindings = false;
+  TimingReport* timing_report = nullptr;
 
   // Not an argument, just here to prevent the options struct from being
   // copied/moved with nontrivial lifetime implications.
@@ -72,6 +76,14 @@ static_assert(std::is_aggregate_v<IrFromCcOptions>);
 // * `extra_instantiations`: names of full C++ class template specializations
 //   to instantiate and generate bindings from.
 // * `crubit_features`: The set of Crubit features to enable for each target.
+// * `import_dependencies_lazily`: only import decls from other targets when
+//   they are referenced by decls of the current target (see
+//   `Invocation::import_dependencies_lazily_`).
+// * `lean_bindings`: don't import comments and source locations (see
+//   `Invocation::lean_bindings_`).
+// * `timing_report`: if not null, Clang's parsing and the import of the AST
+//   into IR are recorded as phases of this report. Parsing is the part of the
+//   `clang_tool` phase that is not nested in the `import` phase.
 //
 absl::StatusOr<IR> IrFromCc(IrFromCcOptions options);
 
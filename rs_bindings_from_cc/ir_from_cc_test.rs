@@ -98,6 +98,10 @@ fn test_function() {
                 unknown_attr: None,
                 has_c_calling_convention: true,
                 is_member_or_descendant_of_class_template: false,
+                has_no_thunk_attribute: false,
+                has_batch_attribute: false,
+                is_defaulted: false,
+                rust_name: None,
                 source_loc: "Generated from: google3/ir_from_cc_virtual_header.h;l=3",
                 id: ItemId(...),
                 enclosing_item_id: None,
@@ -121,6 +125,21 @@ fn test_function_with_asm_label() {
     );
 }
 
+#[gtest]
+fn test_function_with_rust_name() {
+    let ir =
+        ir_from_cc(r#"[[clang::annotate("crubit_internal_rust_name", "g")]] void f();"#).unwrap();
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Func {
+                name: "f", ...
+                rust_name: Some("g"), ...
+            }
+        }
+    );
+}
+
 #[gtest]
 fn test_function_with_unnamed_parameters() {
     let ir = ir_from_cc("int f(int, int);").unwrap();
@@ -581,6 +600,24 @@ fn test_struct_with_bridge_type_annotation() {
     );
 }
 
+#[gtest]
+fn test_struct_with_column_view_annotation() {
+    let ir = ir_from_cc(
+        r#"struct [[clang::annotate("crubit_internal_column_view")]] Point { float x; };"#,
+    )
+    .unwrap();
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Record {
+                rs_name: "Point", ...
+                unknown_attr: None, ...
+                has_column_view_attribute: true, ...
+            }
+        }
+    );
+}
+
 #[gtest]
 fn test_struct_with_unnamed_struct_and_union_members() {
     // This test input causes `field_decl->getName()` to return an empty string.
@@ -2851,6 +2888,7 @@ fn test_member_function() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2864,6 +2902,7 @@ fn test_member_function_const() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: true,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2877,6 +2916,37 @@ fn test_member_function_virtual() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: true,
+            is_final: false,
+        }),
+    );
+}
+
+#[gtest]
+fn test_member_function_virtual_final() {
+    assert_member_function_has_instance_method_metadata(
+        "Function",
+        "virtual void Function() final;",
+        &Some(ir::InstanceMethodMetadata {
+            reference: ir::ReferenceQualification::Unqualified,
+            is_const: false,
+            is_virtual: true,
+            is_final: true,
+        }),
+    );
+}
+
+#[gtest]
+fn test_member_function_virtual_in_final_class() {
+    let ir = ir_from_cc("struct Struct final { virtual void Function(); };").unwrap();
+    assert_member_function_with_predicate_has_instance_method_metadata(
+        &ir,
+        "Struct",
+        |f| f.name == UnqualifiedIdentifier::Identifier(ir_id("Function")),
+        &Some(ir::InstanceMethodMetadata {
+            reference: ir::ReferenceQualification::Unqualified,
+            is_const: false,
+            is_virtual: true,
+            is_final: true,
         }),
     );
 }
@@ -2890,6 +2960,7 @@ fn test_member_function_lvalue() {
             reference: ir::ReferenceQualification::LValue,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2903,6 +2974,7 @@ fn test_member_function_rvalue() {
             reference: ir::ReferenceQualification::RValue,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2958,6 +3030,7 @@ fn test_member_function_explicit_constructor() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2980,6 +3053,7 @@ fn test_member_function_constructor() {
                 reference: ir::ReferenceQualification::Unqualified,
                 is_const: false,
                 is_virtual: false,
+                is_final: false,
             }),
         );
     }
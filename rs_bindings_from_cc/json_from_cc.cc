@@ -3,9 +3,16 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <string>
+#include <tuple>
+#include <utility>
 
+#include "absl/base/const_init.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "common/ffi_types.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
@@ -22,10 +29,44 @@ static constexpr absl::string_view kDependencyHeaderName =
     "test/dependency_header.h";
 // LINT.ThenChange(//depot/rs_bindings_from_cc/ir_testing.rs)
 
+namespace {
+
+// The target triple, header source and dependency header source of a call to
+// `json_from_cc_dependency`.
+using JsonFromCcKey = std::tuple<std::string, std::string, std::string>;
+
+ABSL_CONST_INIT absl::Mutex json_cache_mutex(absl::kConstInit);
+
+// The JSON of the IR of each distinct input, for the lifetime of the process.
+// Tests build the IR of the same snippets many times (e.g. in `ir_record()`),
+// and each of them would otherwise be parsed again.
+absl::flat_hash_map<JsonFromCcKey, std::string>& JsonCache()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(json_cache_mutex) {
+  static absl::NoDestructor<absl::flat_hash_map<JsonFromCcKey, std::string>>
+      json_cache;
+  return *json_cache;
+}
+
+}  // namespace
+
 // This is intended to be called from Rust tests.
 extern "C" FfiU8SliceBox json_from_cc_dependency(
     FfiU8Slice target_triple, FfiU8Slice header_source,
     FfiU8Slice dependency_header_source) {
+  JsonFromCcKey key(StringViewFromFfiU8Slice(target_triple),
+                    StringViewFromFfiU8Slice(header_source),
+                    StringViewFromFfiU8Slice(dependency_header_source));
+  {
+    absl::MutexLock lock(&json_cache_mutex);
+    auto it = JsonCache().find(key);
+    if (it != JsonCache().end()) {
+      return AllocFfiU8SliceBox(MakeFfiU8Slice(it->second));
+    }
+  }
+
+  // The lock is not held while parsing, so that tests running in parallel
+  // don't wait for each other. Two threads may parse the same input, and the
+  // second result is dropped.
   absl::StatusOr<IR> ir = IrFromCc(
       {.extra_source_code_for_testing = StringViewFromFfiU8Slice(header_source),
        .current_target = BazelLabel{"//test:testing_target"},
@@ -51,7 +92,10 @@ extern "C" FfiU8SliceBox json_from_cc_dependency(
                                            ir.status().message()));
   }
   std::string json = llvm::formatv("{0}", ir->ToJson());
-  return AllocFfiU8SliceBox(MakeFfiU8Slice(json));
+  FfiU8SliceBox result = AllocFfiU8SliceBox(MakeFfiU8Slice(json));
+  absl::MutexLock lock(&json_cache_mutex);
+  JsonCache().try_emplace(std::move(key), std::move(json));
+  return result;
 }
 
 }  // namespace crubit
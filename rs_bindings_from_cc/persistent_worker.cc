@@ -0,0 +1,93 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/persistent_worker.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/status_macros.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace crubit {
+
+namespace {
+
+struct WorkRequest {
+  std::vector<std::string> arguments;
+  int64_t request_id = 0;
+  bool cancel = false;
+};
+
+absl::Status ParseWorkRequest(absl::string_view json, WorkRequest& request) {
+  llvm::Expected<llvm::json::Value> value =
+      llvm::json::parse(llvm::StringRef(json.data(), json.size()));
+  if (!value) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed work request: ", toString(value.takeError())));
+  }
+  const llvm::json::Object* object = value->getAsObject();
+  if (object == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected the work request to be an object: ", json));
+  }
+  if (const llvm::json::Array* arguments = object->getArray("arguments")) {
+    for (const llvm::json::Value& argument : *arguments) {
+      auto string = argument.getAsString();
+      if (!string) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Expected the arguments of the work request to be strings: ",
+            json));
+      }
+      request.arguments.push_back(string->str());
+    }
+  }
+  // Fields with default values are omitted from the JSON encoding of
+  // protobufs, so e.g. the first request has no `requestId`.
+  if (auto request_id = object->getInteger("requestId")) {
+    request.request_id = *request_id;
+  }
+  if (auto cancel = object->getBoolean("cancel")) {
+    request.cancel = *cancel;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status RunPersistentWorker(std::istream& requests,
+                                 llvm::raw_ostream& responses,
+                                 WorkRequestHandler handle_request) {
+  std::string line;
+  while (std::getline(requests, line)) {
+    if (line.empty()) continue;
+    WorkRequest request;
+    CRUBIT_RETURN_IF_ERROR(ParseWorkRequest(line, request));
+    // The worker doesn't declare `supports-worker-cancellation`, so requests
+    // always run to completion, and there is nothing to cancel.
+    if (request.cancel) continue;
+
+    std::string output;
+    int exit_code = handle_request(request.arguments, output);
+    responses << llvm::json::Value(llvm::json::Object{
+                     {"exitCode", exit_code},
+                     {"output", std::move(output)},
+                     {"requestId", request.request_id},
+                 })
+              << "\n";
+    responses.flush();
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace crubit
@@ -0,0 +1,41 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace crubit {
+
+// The flag Bazel adds to the startup arguments of a persistent worker.
+inline constexpr absl::string_view kPersistentWorkerFlag =
+    "--persistent_worker";
+
+// Handles a single work request with the given `arguments`. Returns the exit
+// code of the request, and appends messages for the user to `output`.
+using WorkRequestHandler = absl::FunctionRef<int(
+    const std::vector<std::string>& arguments, std::string& output)>;
+
+// Serves the JSON flavor of the Bazel persistent worker protocol
+// (https://bazel.build/remote/persistent): reads `WorkRequest`s from
+// `requests`, one per line, calls `handle_request` for each of them in order
+// and writes the corresponding `WorkResponse` to `responses`.
+//
+// Returns once `requests` reaches the end of the input, or an error if a
+// request is malformed.
+absl::Status RunPersistentWorker(std::istream& requests,
+                                 llvm::raw_ostream& responses,
+                                 WorkRequestHandler handle_request);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
@@ -0,0 +1,79 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/persistent_worker.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_join.h"
+#include "common/status_test_matchers.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(PersistentWorkerTest, HandlesRequestsInOrder) {
+  std::istringstream requests(
+      R"({"arguments": ["--a", "b"], "inputs": [{"path": "x.h"}]})"
+      "\n"
+      "\n"
+      R"({"arguments": ["--c"], "requestId": 7})"
+      "\n");
+  std::string responses;
+  llvm::raw_string_ostream responses_stream(responses);
+  std::vector<std::string> handled;
+  ASSERT_OK(RunPersistentWorker(
+      requests, responses_stream,
+      [&](const std::vector<std::string>& arguments, std::string& output) {
+        handled.push_back(absl::StrJoin(arguments, " "));
+        output = "output of " + handled.back();
+        return handled.size() == 1 ? 0 : 1;
+      }));
+
+  EXPECT_THAT(handled, ElementsAre("--a b", "--c"));
+  EXPECT_EQ(responses,
+            R"({"exitCode":0,"output":"output of --a b","requestId":0})"
+            "\n"
+            R"({"exitCode":1,"output":"output of --c","requestId":7})"
+            "\n");
+}
+
+TEST(PersistentWorkerTest, IgnoresCancelRequests) {
+  std::istringstream requests(R"({"requestId": 3, "cancel": true})"
+                              "\n");
+  std::string responses;
+  llvm::raw_string_ostream responses_stream(responses);
+  ASSERT_OK(RunPersistentWorker(
+      requests, responses_stream,
+      [](const std::vector<std::string>& arguments, std::string& output) {
+        ADD_FAILURE() << "Cancel requests should not be handled";
+        return 0;
+      }));
+  EXPECT_THAT(responses, IsEmpty());
+}
+
+TEST(PersistentWorkerTest, MalformedRequest) {
+  std::istringstream requests(R"({"arguments": [1]})"
+                              "\n");
+  std::string responses;
+  llvm::raw_string_ostream responses_stream(responses);
+  EXPECT_THAT(
+      RunPersistentWorker(
+          requests, responses_stream,
+          [](const std::vector<std::string>& arguments, std::string& output) {
+            return 0;
+          }),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace crubit
@@ -0,0 +1,115 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/precompiled_module.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "absl/types/span.h"
+#include "common/file_io.h"
+#include "common/status_macros.h"
+#include "rs_bindings_from_cc/bazel_types.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/FrontendOptions.h"
+#include "clang/Serialization/PCHContainerOperations.h"
+#include "clang/Tooling/Tooling.h"
+
+namespace crubit {
+
+namespace {
+
+// Compiles the module map passed as the (only) input into a precompiled module
+// written to `pcm_out`.
+//
+// `runToolOnCodeWithArgs` always creates C++ source inputs, so the input kind
+// is adjusted before the action runs.
+class GeneratePrecompiledModuleAction
+    : public clang::GenerateModuleFromModuleMapAction {
+ public:
+  explicit GeneratePrecompiledModuleAction(std::string pcm_out)
+      : pcm_out_(std::move(pcm_out)) {}
+
+ protected:
+  bool PrepareToExecuteAction(clang::CompilerInstance& instance) override {
+    clang::FrontendOptions& options = instance.getFrontendOpts();
+    options.OutputFile = pcm_out_;
+    for (clang::FrontendInputFile& input : options.Inputs) {
+      input = clang::FrontendInputFile(
+          input.getFile(),
+          input.getKind().withFormat(clang::InputKind::ModuleMap),
+          input.isSystem());
+    }
+    return clang::GenerateModuleFromModuleMapAction::PrepareToExecuteAction(
+        instance);
+  }
+
+ private:
+  std::string pcm_out_;
+};
+
+}  // namespace
+
+std::string ModuleMapForTarget(const BazelLabel& target,
+                               absl::Span<const HeaderName> public_headers) {
+  std::string module_map = absl::Substitute("module \"$0\" {\n", target.value());
+  for (const HeaderName& header : public_headers) {
+    absl::SubstituteAndAppend(&module_map, "  header \"$0\"\n",
+                              header.IncludePath());
+  }
+  absl::StrAppend(&module_map, "  export *\n}\n");
+  return module_map;
+}
+
+absl::Status WritePrecompiledModule(const BazelLabel& target,
+                                    absl::Span<const HeaderName> public_headers,
+                                    absl::string_view module_map_out,
+                                    absl::string_view pcm_out,
+                                    absl::Span<const std::string> clang_args) {
+  std::string module_map = ModuleMapForTarget(target, public_headers);
+  CRUBIT_RETURN_IF_ERROR(SetFileContents(module_map_out, module_map));
+
+  std::vector<std::string> args_as_strings = {
+      // Keep in sync with the arguments used by `IrFromCc`, so that the module
+      // can be loaded when generating bindings for dependent targets.
+      "-fparse-all-comments",
+      "-xc++",
+      "-fmodules",
+      "-fno-implicit-modules",
+      "-fno-implicit-module-maps",
+      "-Xclang",
+      "-fmodule-map-file-home-is-cwd",
+      absl::StrCat("-fmodule-name=", target.value()),
+  };
+  for (size_t i = 0; i < clang_args.size(); ++i) {
+    // The public headers are already part of the module, there is no need to
+    // also force-include them into it.
+    if (clang_args[i] == "-include") {
+      ++i;
+      continue;
+    }
+    args_as_strings.push_back(clang_args[i]);
+  }
+
+  if (!clang::tooling::runToolOnCodeWithArgs(
+          std::make_unique<GeneratePrecompiledModuleAction>(
+              std::string(pcm_out)),
+          module_map, args_as_strings, module_map_out, "rs_bindings_from_cc",
+          std::make_shared<clang::PCHContainerOperations>())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Could not precompile the module for ", target.value()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace crubit
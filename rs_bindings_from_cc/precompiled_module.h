@@ -0,0 +1,39 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_PRECOMPILED_MODULE_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_PRECOMPILED_MODULE_H_
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "rs_bindings_from_cc/bazel_types.h"
+#include "rs_bindings_from_cc/ir.h"
+
+namespace crubit {
+
+// Returns the contents of a module map that declares a single module named
+// after `target`, containing `public_headers` (paths relative to the current
+// working directory, i.e. the Bazel execroot).
+std::string ModuleMapForTarget(const BazelLabel& target,
+                               absl::Span<const HeaderName> public_headers);
+
+// Writes the module map for `target` (see `ModuleMapForTarget`) to
+// `module_map_out`, and precompiles the module into `pcm_out`.
+//
+// `clang_args` should be the same arguments that are used to parse the headers
+// for bindings generation, so that the resulting module can be loaded into
+// bindings generation for dependent targets (via `-fmodule-map-file=` and
+// `-fmodule-file=`) instead of re-parsing the headers of `target`.
+absl::Status WritePrecompiledModule(const BazelLabel& target,
+                                    absl::Span<const HeaderName> public_headers,
+                                    absl::string_view module_map_out,
+                                    absl::string_view pcm_out,
+                                    absl::Span<const std::string> clang_args);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_PRECOMPILED_MODULE_H_
@@ -61,6 +61,13 @@ void RecordingDiagnosticConsumer::HandleDiagnostic(
     const clang::Diagnostic& info) {
   clang::DiagnosticConsumer::HandleDiagnostic(diagnostic_level, info);
 
+  if (diagnostic_level != clang::DiagnosticsEngine::Note) {
+    dropping_notes_ = diagnostic_level < clang::DiagnosticsEngine::Error &&
+                      record_warning_at_ != nullptr &&
+                      !record_warning_at_(info.getLocation());
+  }
+  if (dropping_notes_) return;
+
   llvm::SmallString<64> diagnostic;
   info.FormatDiagnostic(diagnostic);
   auto source_loc = info.getLocation();
@@ -71,6 +78,7 @@ void RecordingDiagnosticConsumer::HandleDiagnostic(
 
 void RecordingDiagnosticConsumer::clear() {
   clang::DiagnosticConsumer::clear();
+  dropping_notes_ = false;
   diagnostics_.clear();
 }
 
@@ -90,8 +98,9 @@ std::string RecordingDiagnosticConsumer::ConcatenatedDiagnostics(
 
 RecordingDiagnosticConsumer RecordDiagnostics(
     clang::DiagnosticsEngine& diagnostic_engine,
-    std::function<void(void)> callback) {
-  RecordingDiagnosticConsumer diagnostic_recorder;
+    std::function<void(void)> callback,
+    RecordingDiagnosticConsumer::WarningFilter record_warning_at) {
+  RecordingDiagnosticConsumer diagnostic_recorder(std::move(record_warning_at));
   std::unique_ptr<clang::DiagnosticConsumer> original_consumer =
       diagnostic_engine.takeClient();
   diagnostic_engine.setClient(&diagnostic_recorder, /*ShouldOwnClient=*/false);
@@ -8,6 +8,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -20,6 +21,17 @@ namespace crubit {
 
 class RecordingDiagnosticConsumer final : public clang::DiagnosticConsumer {
  public:
+  // Returns whether warnings (and remarks) at the given location should be
+  // recorded.
+  using WarningFilter = std::function<bool(clang::SourceLocation)>;
+
+  RecordingDiagnosticConsumer() = default;
+  // Warnings and remarks for which `record_warning_at` returns false are
+  // dropped before they are formatted, along with their notes. They are still
+  // counted by `getNumWarnings`.
+  explicit RecordingDiagnosticConsumer(WarningFilter record_warning_at)
+      : record_warning_at_(std::move(record_warning_at)) {}
+
   void HandleDiagnostic(clang::DiagnosticsEngine::Level diagnostic_level,
                         const clang::Diagnostic& info) override;
   void clear() override;
@@ -40,6 +52,10 @@ class RecordingDiagnosticConsumer final : public clang::DiagnosticConsumer {
   std::string ConcatenatedDiagnostics(absl::string_view prefix = "") const;
 
  private:
+  WarningFilter record_warning_at_;
+  // Whether the last diagnostic (other than a note) was dropped, in which case
+  // its notes are dropped as well.
+  bool dropping_notes_ = false;
   std::vector<Diagnostic> diagnostics_;
 };
 
@@ -57,9 +73,14 @@ class RecordingDiagnosticConsumer final : public clang::DiagnosticConsumer {
 /// would be helpful to temporarily avoid sending the diagnostics for these
 /// fallable attempts to the original diagnostic consumer, and this is where
 /// this 'trap' becomes useful.
+///
+/// Only the errors matter to most callers, so `record_warning_at` can be used
+/// to drop warnings (e.g. warnings from headers of other targets) without
+/// formatting them. See `RecordingDiagnosticConsumer::WarningFilter`.
 RecordingDiagnosticConsumer RecordDiagnostics(
     clang::DiagnosticsEngine& diagnostic_engine,
-    std::function<void(void)> callback);
+    std::function<void(void)> callback,
+    RecordingDiagnosticConsumer::WarningFilter record_warning_at = nullptr);
 }  // namespace crubit
 
 #endif  // THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_RECORDING_DIAGNOSTIC_CONSUMER_H_
@@ -0,0 +1,65 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/recording_diagnostic_consumer.h"
+
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Tooling/Tooling.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::SizeIs;
+
+TEST(RecordingDiagnosticConsumerTest, WarningFilter) {
+  std::unique_ptr<clang::ASTUnit> ast =
+      clang::tooling::buildASTFromCode("int kept;\nint dropped;\n");
+  ASSERT_NE(ast, nullptr);
+  clang::SourceManager& source_manager = ast->getSourceManager();
+  clang::SourceLocation kept_loc =
+      source_manager.getLocForStartOfFile(source_manager.getMainFileID());
+  clang::SourceLocation dropped_loc = kept_loc.getLocWithOffset(10);
+
+  clang::DiagnosticsEngine& diagnostics = ast->getDiagnostics();
+  unsigned warning =
+      diagnostics.getCustomDiagID(clang::DiagnosticsEngine::Warning, "%0");
+  unsigned note =
+      diagnostics.getCustomDiagID(clang::DiagnosticsEngine::Note, "%0");
+  unsigned error =
+      diagnostics.getCustomDiagID(clang::DiagnosticsEngine::Error, "%0");
+  RecordingDiagnosticConsumer recorder = RecordDiagnostics(
+      diagnostics,
+      [&] {
+        diagnostics.Report(kept_loc, warning) << "kept warning";
+        diagnostics.Report(kept_loc, note) << "kept note";
+        diagnostics.Report(dropped_loc, warning) << "dropped warning";
+        diagnostics.Report(dropped_loc, note) << "dropped note";
+        diagnostics.Report(dropped_loc, error) << "error";
+      },
+      [&](clang::SourceLocation loc) { return loc != dropped_loc; });
+
+  EXPECT_THAT(recorder.ConcatenatedDiagnostics(),
+              AllOf(HasSubstr("input.cc:1:1: warning: kept warning"),
+                    HasSubstr("input.cc:1:1: note: kept note"),
+                    HasSubstr("input.cc:2:1: error: error"),
+                    Not(HasSubstr("dropped warning")),
+                    Not(HasSubstr("dropped note"))));
+  EXPECT_THAT(recorder.GetDiagnostics(), SizeIs(3));
+  // Dropped warnings are still counted.
+  EXPECT_EQ(recorder.getNumWarnings(), 2u);
+  EXPECT_EQ(recorder.getNumErrors(), 1u);
+}
+
+}  // namespace
+}  // namespace crubit
@@ -6,21 +6,35 @@
 // * a Rust source file with bindings for the C++ API
 // * a C++ source file with the implementation of the bindings
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include "absl/flags/parse.h"
+#include "absl/flags/reflection.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "common/file_io.h"
 #include "common/status_macros.h"
+#include "common/string_interner.h"
 #include "rs_bindings_from_cc/cmdline.h"
 #include "rs_bindings_from_cc/collect_namespaces.h"
 #include "rs_bindings_from_cc/generate_bindings_and_metadata.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/persistent_worker.h"
+#include "rs_bindings_from_cc/precompiled_module.h"
+#include "rs_bindings_from_cc/timing_report.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
@@ -33,7 +47,9 @@ std::string InstantiationsAsJson(
   for (const auto& entry : bindings_and_metadata.instantiations) {
     obj[entry.first] = entry.second;
   }
-  return std::string(llvm::formatv("{0:2}", llvm::json::Value(std::move(obj))));
+  // Compact (non-indented) JSON, since it is read by `cc_template!` in every
+  // dependent crate, not by humans.
+  return std::string(llvm::formatv("{0}", llvm::json::Value(std::move(obj))));
 }
 
 absl::Status Main(absl::Span<char* const> positional_args) {
@@ -41,39 +57,80 @@ absl::Status Main(absl::Span<char* const> positional_args) {
   const CmdlineArgs& args = cmdline.args();
 
   if (args.do_nothing) {
-    CRUBIT_RETURN_IF_ERROR(SetFileContents(
-        args.rs_out,
-        "// intentionally left empty because --do_nothing was passed."));
-    CRUBIT_RETURN_IF_ERROR(SetFileContents(
-        args.cc_out,
-        "// intentionally left empty because --do_nothing was passed."));
+    if (!args.precompiled_module_only) {
+      CRUBIT_RETURN_IF_ERROR(SetFileContents(
+          args.rs_out,
+          "// intentionally left empty because --do_nothing was passed."));
+      CRUBIT_RETURN_IF_ERROR(SetFileContents(
+          args.cc_out,
+          "// intentionally left empty because --do_nothing was passed."));
+    }
+    for (const std::string& cc_out_shard : args.cc_out_shards) {
+      CRUBIT_RETURN_IF_ERROR(SetFileContents(
+          cc_out_shard,
+          "// intentionally left empty because --do_nothing was passed."));
+    }
+    if (!args.rs_out_modules_dir.empty()) {
+      if (std::error_code error =
+              llvm::sys::fs::create_directories(args.rs_out_modules_dir)) {
+        return absl::InternalError(absl::StrCat("Failed to create ",
+                                                args.rs_out_modules_dir, ": ",
+                                                error.message()));
+      }
+    }
     if (!args.instantiations_out.empty()) {
       CRUBIT_RETURN_IF_ERROR(SetFileContents(args.instantiations_out, "[]"));
     }
     if (!args.namespaces_out.empty()) {
       CRUBIT_RETURN_IF_ERROR(SetFileContents(args.namespaces_out, "[]"));
     }
+    if (!args.pcm_out.empty()) {
+      // An empty module, so that dependent targets include the headers of this
+      // target textually.
+      std::vector<std::string> clang_args(positional_args.begin(),
+                                          positional_args.end());
+      CRUBIT_RETURN_IF_ERROR(WritePrecompiledModule(
+          args.current_target, /*public_headers=*/{}, args.module_map_out,
+          args.pcm_out, clang_args));
+    }
     return absl::OkStatus();
   }
 
+  std::optional<TimingReport> timing_report;
+  if (!args.timing_report_out.empty() || !args.timing_trace_out.empty()) {
+    timing_report.emplace();
+  }
+  TimingReport* timing_report_ptr =
+      timing_report.has_value() ? &*timing_report : nullptr;
+
   std::vector<std::string> clang_args;
   clang_args.insert(clang_args.end(), positional_args.begin(),
                     positional_args.end());
 
+  if (!args.pcm_out.empty()) {
+    TimingReport::ScopedPhase phase(timing_report_ptr,
+                                    "write_precompiled_module");
+    CRUBIT_RETURN_IF_ERROR(WritePrecompiledModule(
+        args.current_target, args.public_headers, args.module_map_out,
+        args.pcm_out, clang_args));
+  }
+  if (args.precompiled_module_only) {
+    return absl::OkStatus();
+  }
+
   CRUBIT_ASSIGN_OR_RETURN(
       BindingsAndMetadata bindings_and_metadata,
-      GenerateBindingsAndMetadata(cmdline, std::move(clang_args)));
+      GenerateBindingsAndMetadata(
+          cmdline, std::move(clang_args),
+          /*virtual_headers_contents_for_testing=*/{},
+          /*write_rs_and_cc_out=*/true, timing_report_ptr));
 
   if (!args.ir_out.empty()) {
+    TimingReport::ScopedPhase phase(timing_report_ptr, "ir_to_json");
     CRUBIT_RETURN_IF_ERROR(
         SetFileContents(args.ir_out, IrToJson(bindings_and_metadata.ir)));
   }
 
-  CRUBIT_RETURN_IF_ERROR(
-      SetFileContents(args.rs_out, bindings_and_metadata.rs_api));
-  CRUBIT_RETURN_IF_ERROR(
-      SetFileContents(args.cc_out, bindings_and_metadata.rs_api_impl));
-
   if (!args.instantiations_out.empty()) {
     CRUBIT_RETURN_IF_ERROR(SetFileContents(
         args.instantiations_out, InstantiationsAsJson(bindings_and_metadata)));
@@ -86,18 +143,113 @@ absl::Status Main(absl::Span<char* const> positional_args) {
   }
 
   if (!args.error_report_out.empty()) {
-    CRUBIT_RETURN_IF_ERROR(SetFileContents(args.error_report_out,
-                                           bindings_and_metadata.error_report));
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(
+        args.error_report_out, bindings_and_metadata.error_report.view()));
+  }
+
+  if (!args.api_hash_out.empty()) {
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(
+        args.api_hash_out, bindings_and_metadata.api_hash.view()));
+  }
+
+  if (!args.cost_report_out.empty()) {
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(
+        args.cost_report_out, bindings_and_metadata.cost_report.view()));
+  }
+
+  if (!args.timing_report_out.empty()) {
+    CRUBIT_RETURN_IF_ERROR(
+        SetFileContents(args.timing_report_out, timing_report->ToJson()));
+  }
+  if (!args.timing_trace_out.empty()) {
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(args.timing_trace_out,
+                                           timing_report->ToChromeTrace()));
   }
 
   return absl::OkStatus();
 }
 
+// Runs a single request of the persistent worker: `startup_args` are the
+// arguments the worker was started with (without `--persistent_worker`), and
+// `request_args` the arguments of the request.
+int RunWorkRequest(absl::Span<char* const> startup_args,
+                   const std::vector<std::string>& request_args,
+                   std::string& output) {
+  // Bazel passes the arguments of requests in paramfiles, as it does for
+  // non-worker invocations.
+  std::vector<std::string> expanded_request_args =
+      ExpandParamfiles(request_args);
+  std::vector<std::string> args(startup_args.begin(), startup_args.end());
+  args.insert(args.end(),
+              std::make_move_iterator(expanded_request_args.begin()),
+              std::make_move_iterator(expanded_request_args.end()));
+  std::vector<char*> argv;
+  argv.reserve(args.size());
+  for (std::string& arg : args) argv.push_back(arg.data());
+  int argc = argv.size();
+  std::string target_args;
+  PreprocessTargetArgs(argc, argv.data(), &target_args);
+
+  // The identifiers and labels of a request aren't needed by the next one.
+  // The scope outlives `flag_saver`, so that flag values parsed from the
+  // request (which may be interned) are reset before their strings are freed.
+  StringInternerScope string_interner_scope;
+  // Every request starts from the default values of the flags, rather than
+  // from the values of the previous request.
+  absl::FlagSaver flag_saver;
+  std::vector<char*> positional_args =
+      absl::ParseCommandLine(argc, argv.data());
+  absl::Status status = Main(positional_args);
+  if (!status.ok()) {
+    absl::StrAppend(&output, status.message(), "\n");
+    return -1;
+  }
+  return 0;
+}
+
+// Serves work requests from Bazel until stdin is closed.
+//
+// The process state that is independent of the request (e.g. LLVM's and the
+// allocator's) is kept warm across requests. The state of Clang (e.g. its file
+// manager) is not, because the contents of the files can change between
+// requests.
+int RunAsPersistentWorker(int argc, char* argv[]) {
+  std::vector<char*> startup_args;
+  for (char* arg : absl::MakeSpan(argv, argc)) {
+    if (arg != kPersistentWorkerFlag) startup_args.push_back(arg);
+  }
+
+  // Responses are written to stdout, so everything else that would be written
+  // there (e.g. by Clang) goes to stderr, which Bazel appends to the worker
+  // log.
+  int responses_fd = dup(STDOUT_FILENO);
+  if (responses_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+    llvm::errs() << "Failed to redirect stdout of the persistent worker\n";
+    return -1;
+  }
+  llvm::raw_fd_ostream responses(responses_fd, /*shouldClose=*/true);
+
+  absl::Status status = RunPersistentWorker(
+      std::cin, responses,
+      [&](const std::vector<std::string>& request_args, std::string& output) {
+        return RunWorkRequest(startup_args, request_args, output);
+      });
+  if (!status.ok()) {
+    llvm::errs() << status.message() << "\n";
+    return -1;
+  }
+  return 0;
+}
+
 }  // namespace crubit
 
 extern "C" int crubit_rs_bindings_from_cc_main(int argc, char* argv[]) {
   // TODO(jeanpierreda): move these functions into rs_bindings_from_cc.rs.
   crubit::ExpandParamfiles(argc, argv);
+  if (std::find(argv, argv + argc, crubit::kPersistentWorkerFlag) !=
+      argv + argc) {
+    return crubit::RunAsPersistentWorker(argc, argv);
+  }
   crubit::PreprocessTargetArgs(argc, argv);
   auto args = absl::ParseCommandLine(argc, argv);
   absl::Status status = crubit::Main(args);
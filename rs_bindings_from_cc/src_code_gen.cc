@@ -6,12 +6,13 @@
 
 #include <string>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/ffi_types.h"
-#include "common/status_macros.h"
 #include "rs_bindings_from_cc/ir.h"
-#include "llvm/Support/FormatVariadic.h"
 
 namespace crubit {
 
@@ -20,51 +21,69 @@ struct FfiBindings {
   FfiU8SliceBox rs_api;
   FfiU8SliceBox rs_api_impl;
   FfiU8SliceBox error_report;
+  FfiU8SliceBox timing_report;
+  FfiU8SliceBox api_hash;
+  FfiU8SliceBox cost_report;
+  FfiU8SliceBox error;
 };
 
 // This function is implemented in Rust.
 extern "C" FfiBindings GenerateBindingsImpl(
-    FfiU8Slice json, FfiU8Slice crubit_support_path_format,
+    FfiU8Slice ir, FfiU8Slice crubit_support_path_format,
     FfiU8Slice clang_format_exe_path, FfiU8Slice rustfmt_exe_path,
     FfiU8Slice rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment);
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    FfiU8Slice bindings_cache_dir,
+    GeneratedCodeFormatting generated_code_formatting, FfiU8Slice rs_out,
+    FfiU8Slice cc_out, bool generate_timing_report,
+    bool generate_unsupported_item_comments, FfiU8Slice rs_out_modules_dir,
+    FfiU8Slice cc_out_shards, bool aggregate_layout_assertions,
+    bool generate_api_hash, bool generate_cost_report);
 
-// Creates `Bindings` instance from copied data from `ffi_bindings`.
-static absl::StatusOr<Bindings> MakeBindingsFromFfiBindings(
-    const FfiBindings& ffi_bindings) {
+// Creates `Bindings` instance that takes ownership of the data in
+// `ffi_bindings`, which was allocated in Rust.
+static Bindings MakeBindingsFromFfiBindings(FfiBindings ffi_bindings) {
   Bindings bindings;
-
-  const FfiU8SliceBox& rs_api = ffi_bindings.rs_api;
-  const FfiU8SliceBox& rs_api_impl = ffi_bindings.rs_api_impl;
-  const FfiU8SliceBox& error_report = ffi_bindings.error_report;
-
-  bindings.rs_api = std::string(rs_api.ptr, rs_api.size);
-  bindings.rs_api_impl = std::string(rs_api_impl.ptr, rs_api_impl.size);
-  bindings.error_report = std::string(error_report.ptr, error_report.size);
+  bindings.rs_api = UniqueFfiU8SliceBox(ffi_bindings.rs_api);
+  bindings.rs_api_impl = UniqueFfiU8SliceBox(ffi_bindings.rs_api_impl);
+  bindings.error_report = UniqueFfiU8SliceBox(ffi_bindings.error_report);
+  bindings.timing_report = UniqueFfiU8SliceBox(ffi_bindings.timing_report);
+  bindings.api_hash = UniqueFfiU8SliceBox(ffi_bindings.api_hash);
+  bindings.cost_report = UniqueFfiU8SliceBox(ffi_bindings.cost_report);
   return bindings;
 }
 
-// Deallocates given `ffi_bindings` instance that was created in Rust.
-static void FreeFfiBindings(FfiBindings ffi_bindings) {
-  FreeFfiU8SliceBox(ffi_bindings.rs_api);
-  FreeFfiU8SliceBox(ffi_bindings.rs_api_impl);
-  FreeFfiU8SliceBox(ffi_bindings.error_report);
-}
-
 absl::StatusOr<Bindings> GenerateBindings(
     const IR& ir, absl::string_view crubit_support_path_format,
     absl::string_view clang_format_exe_path, absl::string_view rustfmt_exe_path,
     absl::string_view rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment) {
-  std::string json = llvm::formatv("{0}", ir.ToJson());
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    absl::string_view bindings_cache_dir,
+    GeneratedCodeFormatting generated_code_formatting, absl::string_view rs_out,
+    absl::string_view cc_out, bool generate_timing_report,
+    bool generate_unsupported_item_comments,
+    absl::string_view rs_out_modules_dir,
+    absl::Span<const std::string> cc_out_shards,
+    bool aggregate_layout_assertions, bool generate_api_hash,
+    bool generate_cost_report) {
+  std::string binary_ir = IrToBinary(ir);
+  // Paths don't contain newlines, so they can be passed as a single string.
+  std::string cc_out_shards_joined = absl::StrJoin(cc_out_shards, "\n");
   FfiBindings ffi_bindings = GenerateBindingsImpl(
-      MakeFfiU8Slice(json), MakeFfiU8Slice(crubit_support_path_format),
+      MakeFfiU8Slice(binary_ir), MakeFfiU8Slice(crubit_support_path_format),
       MakeFfiU8Slice(clang_format_exe_path), MakeFfiU8Slice(rustfmt_exe_path),
       MakeFfiU8Slice(rustfmt_config_path), generate_error_report,
-      generate_source_location_in_doc_comment);
-  CRUBIT_ASSIGN_OR_RETURN(Bindings bindings,
-                          MakeBindingsFromFfiBindings(ffi_bindings));
-  FreeFfiBindings(ffi_bindings);
+      generate_source_location_in_doc_comment,
+      MakeFfiU8Slice(bindings_cache_dir), generated_code_formatting,
+      MakeFfiU8Slice(rs_out), MakeFfiU8Slice(cc_out), generate_timing_report,
+      generate_unsupported_item_comments, MakeFfiU8Slice(rs_out_modules_dir),
+      MakeFfiU8Slice(cc_out_shards_joined), aggregate_layout_assertions,
+      generate_api_hash, generate_cost_report);
+  UniqueFfiU8SliceBox error(ffi_bindings.error);
+  Bindings bindings = MakeBindingsFromFfiBindings(ffi_bindings);
+  if (!error.view().empty()) {
+    return absl::InternalError(error.view());
+  }
   return bindings;
 }
 
@@ -9,27 +9,78 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/ffi_types.h"
 #include "rs_bindings_from_cc/ir.h"
 
 namespace crubit {
 
 // Source code for generated bindings.
+// The outputs are owned by the buffers that Rust allocated them in, so that
+// they don't have to be copied.
 struct Bindings {
   // Rust source code.
-  std::string rs_api;
+  UniqueFfiU8SliceBox rs_api;
   // C++ source code.
-  std::string rs_api_impl;
+  UniqueFfiU8SliceBox rs_api_impl;
   // Optional JSON error report.
-  std::string error_report;
+  UniqueFfiU8SliceBox error_report;
+  // Optional JSON profile of the Rust side of bindings generation (see
+  // `TimingReport::AddGeneratorReport`).
+  UniqueFfiU8SliceBox timing_report;
+  // Optional hash of the API of `rs_api`, which ignores comments and
+  // formatting.
+  UniqueFfiU8SliceBox api_hash;
+  // Optional JSON report of the cost of generating the bindings for each item.
+  UniqueFfiU8SliceBox cost_report;
 };
 
 // Generates bindings from the given `IR`.
+//
+// If `bindings_cache_dir` is not empty, the formatted bindings are cached in
+// that directory and reused when the same IR is passed again.
+//
+// If `rs_out` and `cc_out` are not empty, the Rust and C++ source code is
+// written directly to these files instead of being returned, and
+// `Bindings::rs_api` and `Bindings::rs_api_impl` are left empty.
+//
+// If `generate_timing_report` is true, `Bindings::timing_report` is populated.
+//
+// If `generate_unsupported_item_comments` is false, the errors of unsupported
+// items are only recorded in `Bindings::error_report`, instead of also being
+// written as comments into `Bindings::rs_api`.
+//
+// If `rs_out_modules_dir` is not empty, `rs_out` must not be empty either, and
+// the top-level modules of the Rust source code are written to separate files
+// in that directory, which `rs_out` includes with `#[path]` attributes.
+//
+// If `cc_out_shards` is not empty, `cc_out` must not be empty either, and the
+// thunks of the C++ source code are split between `cc_out` and the files in
+// `cc_out_shards`, each of which can be compiled separately.
+//
+// If `aggregate_layout_assertions` is true, the size, alignment and field
+// offsets of all records are verified by a single table-driven assertion in
+// each of `Bindings::rs_api` and `Bindings::rs_api_impl`, rather than by
+// separate assertions for every record and field.
+//
+// If `generate_cost_report` is true, `Bindings::cost_report` is populated with
+// the time spent generating the bindings for each item, and their size. The
+// cache in `bindings_cache_dir` is not used in that case.
 absl::StatusOr<Bindings> GenerateBindings(
     const IR& ir, absl::string_view crubit_support_path_format,
     absl::string_view clang_format_exe_path, absl::string_view rustfmt_exe_path,
     absl::string_view rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment);
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    absl::string_view bindings_cache_dir = "",
+    GeneratedCodeFormatting generated_code_formatting =
+        GeneratedCodeFormatting::ExternalFormatters,
+    absl::string_view rs_out = "", absl::string_view cc_out = "",
+    bool generate_timing_report = false,
+    bool generate_unsupported_item_comments = true,
+    absl::string_view rs_out_modules_dir = "",
+    absl::Span<const std::string> cc_out_shards = {},
+    bool aggregate_layout_assertions = false, bool generate_api_hash = false,
+    bool generate_cost_report = false);
 
 }  // namespace crubit
 
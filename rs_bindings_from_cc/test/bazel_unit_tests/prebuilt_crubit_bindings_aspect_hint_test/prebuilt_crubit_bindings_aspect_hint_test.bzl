@@ -0,0 +1,80 @@
+# Part of the Crubit project, under the Apache License v2.0 with LLVM
+# Exceptions. See /LICENSE for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""This module contains unit tests for the prebuilt_crubit_bindings aspect hint."""
+
+load("@bazel_skylib//lib:unittest.bzl", "analysistest", "asserts")
+load(
+    "//common:crubit_wrapper_macros_oss.bzl",
+    "crubit_make_analysis_test",
+)
+load(
+    "//rs_bindings_from_cc/bazel_support:prebuilt_crubit_bindings_aspect_hint.bzl",
+    "prebuilt_crubit_bindings",
+)
+load(
+    "//rs_bindings_from_cc/test/bazel_unit_tests:defs.bzl",
+    "ActionsInfo",
+    "attach_aspect",
+)
+
+# The SHA-256 of `stub_lib.h`.
+_STUB_LIB_HEADER_HASH = "c7f4ae8a59445a71fcd35666a8ea1218cc5487bead74783d17be3447d5fcc0e5"
+
+def _test_prebuilt_crubit_bindings_replace_generated_bindings():
+    prebuilt_crubit_bindings(
+        name = "stub_lib_prebuilt_bindings",
+        rs_api = "stub_lib_rust_api.rs",
+        rs_api_impl = "stub_lib_rust_api_impl.cc",
+        header_hash = _STUB_LIB_HEADER_HASH,
+        tags = ["manual"],
+    )
+    native.cc_library(
+        name = "cc_library_with_prebuilt_bindings",
+        hdrs = ["stub_lib.h"],
+        aspect_hints = [
+            ":stub_lib_prebuilt_bindings",
+            "//features:supported",
+        ],
+        tags = ["manual"],
+    )
+    attach_aspect(
+        name = "aspect_for_cc_library_with_prebuilt_bindings",
+        dep = ":cc_library_with_prebuilt_bindings",
+    )
+
+    prebuilt_crubit_bindings_replace_generated_bindings_test(
+        name = "prebuilt_crubit_bindings_replace_generated_bindings_test",
+        target_under_test = ":aspect_for_cc_library_with_prebuilt_bindings",
+    )
+
+def _test_prebuilt_crubit_bindings_replace_generated_bindings_impl(ctx):
+    env = analysistest.begin(ctx)
+    target_under_test = analysistest.target_under_test(env)
+    actions = target_under_test[ActionsInfo].actions
+    asserts.equals(
+        env,
+        [],
+        [a for a in actions if a.mnemonic == "CppHeaderAnalysis"],
+        "Bindings were generated despite the prebuilt bindings",
+    )
+    validation_actions = [a for a in actions if a.mnemonic == "CrubitPrebuiltBindingsValidation"]
+    asserts.equals(env, 1, len(validation_actions))
+    asserts.true(
+        env,
+        _STUB_LIB_HEADER_HASH in validation_actions[0].argv,
+        "The header hash isn't validated. Actual flags: %s" % validation_actions[0].argv,
+    )
+    return analysistest.end(env)
+
+prebuilt_crubit_bindings_replace_generated_bindings_test = crubit_make_analysis_test(_test_prebuilt_crubit_bindings_replace_generated_bindings_impl)
+
+def prebuilt_crubit_bindings_aspect_hint_test_suite(name):
+    _test_prebuilt_crubit_bindings_replace_generated_bindings()
+    native.test_suite(
+        name = name,
+        tests = [
+            ":prebuilt_crubit_bindings_replace_generated_bindings_test",
+        ],
+    )
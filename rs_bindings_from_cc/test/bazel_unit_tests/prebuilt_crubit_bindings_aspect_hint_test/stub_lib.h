@@ -0,0 +1,8 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_TEST_BAZEL_UNIT_TESTS_PREBUILT_CRUBIT_BINDINGS_ASPECT_HINT_TEST_STUB_LIB_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_TEST_BAZEL_UNIT_TESTS_PREBUILT_CRUBIT_BINDINGS_ASPECT_HINT_TEST_STUB_LIB_H_
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_TEST_BAZEL_UNIT_TESTS_PREBUILT_CRUBIT_BINDINGS_ASPECT_HINT_TEST_STUB_LIB_H_
@@ -46,20 +46,30 @@ def _lib_has_toolchain_targets_and_headers_test_impl(ctx):
         for args in target_under_test[RustBindingsFromCcInfo].target_args.to_list()
     ]
 
-    asserts.equals(env, 3, len(target_args))
-    asserts.true(
+    # The target_args of the toolchain headers are passed via `--target_args_file` instead.
+    asserts.equals(env, 1, len(target_args))
+    asserts.equals(
         env,
-        "crubit/support/cc_std:cc_std" in target_args[0]["t"],
+        "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:empty",
+        target_args[0]["t"],
     )
-    asserts.equals(
+
+    analysis_action = [a for a in target_under_test[ActionsInfo].actions if a.mnemonic == "CppHeaderAnalysis"][0]
+    target_args_files = [
+        arg[len("--target_args_file="):]
+        for arg in analysis_action.argv
+        if arg.startswith("--target_args_file=")
+    ]
+    asserts.equals(env, 1, len(target_args_files))
+    asserts.true(
         env,
-        "//:_nothing_should_depend_on_private_builtin_hdrs",
-        target_args[1]["t"],
+        target_args_files[0].endswith("support/cc_std/cc_std_target_args.json"),
+        "Unexpected --target_args_file: %s" % target_args_files[0],
     )
-    asserts.equals(
+    asserts.true(
         env,
-        "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:empty",
-        target_args[2]["t"],
+        target_args_files[0] in [i.path for i in analysis_action.inputs.to_list()],
+        "--target_args_file is not an input of the action",
     )
 
     return analysistest.end(env)
@@ -81,16 +91,16 @@ def _targets_and_headers_test_impl(ctx):
     target_under_test = analysistest.target_under_test(env)
     target_args = _get_target_args(target_under_test)
 
-    asserts.equals(env, 2, len(target_args))
+    asserts.equals(env, 1, len(target_args))
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:mylib",
-        target_args[1]["t"],
+        target_args[0]["t"],
     )
     asserts.equals(
         env,
         ["rs_bindings_from_cc/test/bazel_unit_tests/target_args/lib.h"],
-        target_args[1]["h"],
+        target_args[0]["h"],
     )
 
     return analysistest.end(env)
@@ -115,31 +125,26 @@ def _targets_and_headers_propagate_with_cc_info_test_impl(ctx):
     target_under_test = analysistest.target_under_test(env)
     target_args = _get_target_args(target_under_test)
 
-    asserts.equals(env, 4, len(target_args))
-    asserts.equals(
-        env,
-        "//:_nothing_should_depend_on_private_builtin_hdrs",
-        target_args[0]["t"],
-    )
+    asserts.equals(env, 3, len(target_args))
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:bottom",
-        target_args[1]["t"],
+        target_args[0]["t"],
     )
     asserts.equals(
         env,
         ["rs_bindings_from_cc/test/bazel_unit_tests/target_args/lib.h"],
-        target_args[1]["h"],
+        target_args[0]["h"],
     )
 
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:middle",
-        target_args[2]["t"],
+        target_args[1]["t"],
     )
     asserts.true(
         env,
-        target_args[2]["h"][0].endswith(
+        target_args[1]["h"][0].endswith(
             "rs_bindings_from_cc/test/bazel_unit_tests/target_args/middle.empty_source_no_public_headers.h",
         ),
     )
@@ -147,12 +152,12 @@ def _targets_and_headers_propagate_with_cc_info_test_impl(ctx):
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:top",
-        target_args[3]["t"],
+        target_args[2]["t"],
     )
     asserts.equals(
         env,
         ["rs_bindings_from_cc/test/bazel_unit_tests/target_args/top.h"],
-        target_args[3]["h"],
+        target_args[2]["h"],
     )
 
     return analysistest.end(env)
@@ -178,11 +183,11 @@ def _textual_hdrs_not_in_targets_and_hdrs_impl(ctx):
     target_args = _get_target_args(target_under_test)
 
     # Check that none of the textual headers made it into the target_args provider.
-    asserts.equals(env, 2, len(target_args))
+    asserts.equals(env, 1, len(target_args))
     asserts.equals(
         env,
         ["rs_bindings_from_cc/test/bazel_unit_tests/target_args/nontextual.h"],
-        target_args[1]["h"],
+        target_args[0]["h"],
     )
 
     return analysistest.end(env)
@@ -259,8 +264,8 @@ def _generated_headers_specified_with_full_path_impl(ctx):
     target_under_test = analysistest.target_under_test(env)
     target_args = _get_target_args(target_under_test)
 
-    asserts.equals(env, 2, len(target_args))
-    header_path = target_args[1]["h"][0]
+    asserts.equals(env, 1, len(target_args))
+    header_path = target_args[0]["h"][0]
     asserts.true(
         env,
         header_path
@@ -302,16 +307,16 @@ def _target_features_empty_test_impl(ctx):
     target_under_test = analysistest.target_under_test(env)
     target_args = _get_target_args(target_under_test)
 
-    asserts.equals(env, 2, len(target_args))
+    asserts.equals(env, 1, len(target_args))
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:mylib_empty_features",
-        target_args[1]["t"],
+        target_args[0]["t"],
     )
     asserts.equals(
         env,
         None,
-        target_args[1].get("f"),
+        target_args[0].get("f"),
     )
 
     return analysistest.end(env)
@@ -332,16 +337,16 @@ def _target_features_nonempty_test_impl(ctx):
     target_under_test = analysistest.target_under_test(env)
     target_args = _get_target_args(target_under_test)
 
-    asserts.equals(env, 2, len(target_args))
+    asserts.equals(env, 1, len(target_args))
     asserts.equals(
         env,
         "//rs_bindings_from_cc/test/bazel_unit_tests/target_args:mylib_nonempty_features",
-        target_args[1]["t"],
+        target_args[0]["t"],
     )
     asserts.equals(
         env,
         ["experimental", "supported"],
-        target_args[1]["f"],
+        target_args[0]["f"],
     )
 
     return analysistest.end(env)
@@ -19,6 +19,13 @@ struct [[clang::annotate("crubit_bridge_type", "MyRustStruct"),
 };
 
 inline size_t CalStructSize(CppStruct x) { return x.s.size(); }
+
+// `x` is passed as a borrowed bridge type: Rust callers pass a `&MyRustStruct`,
+// and keep ownership of it.
+inline size_t CalStructSizeByConstRef(
+    const CppStruct& [[clang::annotate_type("lifetime", "a")]] x) {
+  return x.s.size();
+}
 inline CppStruct ReturnHelloWorldStruct() { return CppStruct{"hello world"}; }
 
 inline CppStruct PadADot(CppStruct x) {
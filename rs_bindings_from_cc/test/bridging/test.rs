@@ -10,6 +10,14 @@ fn test_bridge_type_as_function_arg() {
     assert_eq!(bridging_lib::CalStructSize(x), 5);
 }
 
+#[gtest]
+fn test_bridge_type_as_const_ref_arg() {
+    let x = bridging_lib::MyRustStruct::new("hello");
+    assert_eq!(bridging_lib::CalStructSizeByConstRef(&x), 5);
+    // `x` is only borrowed by the call.
+    assert_eq!(x.s, "hello");
+}
+
 #[gtest]
 fn test_bridge_type_as_return_value() {
     assert_eq!(bridging_lib::ReturnHelloWorldStruct().s, String::from("hello world"));
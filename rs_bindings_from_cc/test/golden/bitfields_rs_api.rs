@@ -46,6 +46,39 @@ impl WithBitfields {
             &*(ptr as *const ::core::ffi::c_char)
         }
     }
+    pub fn set_f7(&mut self, value: ::core::ffi::c_char) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(27);
+            *(ptr as *mut ::core::ffi::c_char) = value;
+        }
+    }
+}
+#[cfg(target_endian = "little")]
+impl WithBitfields {
+    #[inline(always)]
+    pub fn f3(&self) -> ::core::ffi::c_int {
+        unsafe {
+            let ptr = (self as *const Self as *const u8).offset(8);
+            let mut bytes = [0u8; 8];
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 1);
+            let bits = u64::from_le_bytes(bytes) << 60;
+            if <::core::ffi::c_int>::MIN == 0 {
+                (bits >> 60) as ::core::ffi::c_int
+            } else {
+                ((bits as i64) >> 60) as ::core::ffi::c_int
+            }
+        }
+    }
+    #[inline(always)]
+    pub fn set_f3(&mut self, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(8);
+            let mut bytes = [0u8; 8];
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 1);
+            let bits = (u64::from_le_bytes(bytes) & !15u64) | ((value as u64) & 15u64);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 1);
+        }
+    }
 }
 
 impl Default for WithBitfields {
@@ -104,6 +137,34 @@ forward_declare::unsafe_define!(
     forward_declare::symbol!("AlignmentRegressionTest"),
     crate::AlignmentRegressionTest
 );
+#[cfg(target_endian = "little")]
+impl AlignmentRegressionTest {
+    #[inline(always)]
+    pub fn code_point(&self) -> u32 {
+        unsafe {
+            let ptr = (self as *const Self as *const u8).offset(0);
+            let mut bytes = [0u8; 8];
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 4);
+            let bits = u64::from_le_bytes(bytes) << 33;
+            if <u32>::MIN == 0 {
+                (bits >> 33) as u32
+            } else {
+                ((bits as i64) >> 33) as u32
+            }
+        }
+    }
+    #[inline(always)]
+    pub fn set_code_point(&mut self, value: u32) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(0);
+            let mut bytes = [0u8; 8];
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr(), 4);
+            let bits =
+                (u64::from_le_bytes(bytes) & !2147483647u64) | ((value as u64) & 2147483647u64);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 4);
+        }
+    }
+}
 
 impl Default for AlignmentRegressionTest {
     #[inline(always)]
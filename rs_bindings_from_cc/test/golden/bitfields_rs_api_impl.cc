@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -27,22 +28,22 @@ static_assert(CRUBIT_OFFSET_OF(f7, struct WithBitfields) == 27);
 
 extern "C" void __rust_thunk___ZN13WithBitfieldsC1Ev(
     struct WithBitfields* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN13WithBitfieldsC1EOS_(
     struct WithBitfields* __this, struct WithBitfields* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct WithBitfields* __rust_thunk___ZN13WithBitfieldsaSERKS_(
     struct WithBitfields* __this, const struct WithBitfields* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct WithBitfields* __rust_thunk___ZN13WithBitfieldsaSEOS_(
     struct WithBitfields* __this, struct WithBitfields* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct AlignmentRegressionTest) == 4);
@@ -50,27 +51,27 @@ static_assert(alignof(struct AlignmentRegressionTest) == 4);
 
 extern "C" void __rust_thunk___ZN23AlignmentRegressionTestC1Ev(
     struct AlignmentRegressionTest* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN23AlignmentRegressionTestC1EOS_(
     struct AlignmentRegressionTest* __this,
     struct AlignmentRegressionTest* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct AlignmentRegressionTest*
 __rust_thunk___ZN23AlignmentRegressionTestaSERKS_(
     struct AlignmentRegressionTest* __this,
     const struct AlignmentRegressionTest* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct AlignmentRegressionTest*
 __rust_thunk___ZN23AlignmentRegressionTestaSEOS_(
     struct AlignmentRegressionTest* __this,
     struct AlignmentRegressionTest* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -44,8 +44,8 @@ forward_declare::unsafe_define!(forward_declare::symbol!("X"), crate::X);
 // Parameter #0 is not supported: Unsupported type 'X &&': Unsupported type: && without lifetime
 
 #[inline(always)]
-pub fn ffi(a: i8, mut b: crate::X) -> i8 {
-    unsafe { crate::detail::__rust_thunk___Z3ffi4MyI81X(a, &mut b) }
+pub fn ffi(a: i8, b: crate::X) -> i8 {
+    unsafe { crate::detail::__rust_thunk___Z3ffi4MyI81X(a, b) }
 }
 
 pub type MyTypedefDecl = ::core::ffi::c_int;
@@ -59,7 +59,8 @@ mod detail {
     #[allow(unused_imports)]
     use super::*;
     unsafe extern "C" {
-        pub(crate) unsafe fn __rust_thunk___Z3ffi4MyI81X(a: i8, b: &mut crate::X) -> i8;
+        #[link_name = "_Z3ffi4MyI81X"]
+        pub(crate) unsafe fn __rust_thunk___Z3ffi4MyI81X(a: i8, b: crate::X) -> i8;
         pub(crate) unsafe fn __rust_thunk___Z1fiPvi(
             a: crate::MyTypedefDecl,
             b: *mut ::core::ffi::c_void,
@@ -23,10 +23,6 @@ static_assert(CRUBIT_SIZEOF(struct X) == 4);
 static_assert(alignof(struct X) == 4);
 static_assert(CRUBIT_OFFSET_OF(a, struct X) == 0);
 
-extern "C" struct MyI8 __rust_thunk___Z3ffi4MyI81X(struct MyI8 a, struct X* b) {
-  return ffi(std::move(a), std::move(*b));
-}
-
 extern "C" void __rust_thunk___Z1fiPvi(MyTypedefDecl a, void* b, int c) {
   f(std::move(a), b, c);
 }
@@ -188,10 +188,16 @@ impl<'b> ::ctor::UnpinAssign<::ctor::RvalueReference<'b, Self>>
 unsafe impl oops::Inherits<crate::HasCustomAlignment>
     for crate::InheritsFromBaseWithCustomAlignment
 {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::HasCustomAlignment {
         (derived as *const _ as *const u8).offset(0) as *const crate::HasCustomAlignment
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::HasCustomAlignment>
+    for crate::InheritsFromBaseWithCustomAlignment
+{
+    const BASE_OFFSET: isize = 0;
+}
 
 #[derive(Clone, Copy)]
 #[repr(C, align(64))]
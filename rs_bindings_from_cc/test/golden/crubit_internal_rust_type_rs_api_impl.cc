@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -33,27 +34,27 @@ static_assert(CRUBIT_OFFSET_OF(error, struct TypeMapOverrideFieldTypes) == 4);
 
 extern "C" void __rust_thunk___ZN25TypeMapOverrideFieldTypesC1Ev(
     struct TypeMapOverrideFieldTypes* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN25TypeMapOverrideFieldTypesC1EOS_(
     struct TypeMapOverrideFieldTypes* __this,
     struct TypeMapOverrideFieldTypes* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct TypeMapOverrideFieldTypes*
 __rust_thunk___ZN25TypeMapOverrideFieldTypesaSERKS_(
     struct TypeMapOverrideFieldTypes* __this,
     const struct TypeMapOverrideFieldTypes* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct TypeMapOverrideFieldTypes*
 __rust_thunk___ZN25TypeMapOverrideFieldTypesaSEOS_(
     struct TypeMapOverrideFieldTypes* __this,
     struct TypeMapOverrideFieldTypes* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -25,19 +26,19 @@ static_assert(CRUBIT_OFFSET_OF(i, struct DocCommentSlashes) == 0);
 
 extern "C" void __rust_thunk___ZN17DocCommentSlashesC1EOS_(
     struct DocCommentSlashes* __this, struct DocCommentSlashes* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct DocCommentSlashes*
 __rust_thunk___ZN17DocCommentSlashesaSERKS_(
     struct DocCommentSlashes* __this,
     const struct DocCommentSlashes* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct DocCommentSlashes* __rust_thunk___ZN17DocCommentSlashesaSEOS_(
     struct DocCommentSlashes* __this, struct DocCommentSlashes* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct DocCommentBang) == 4);
@@ -46,22 +47,22 @@ static_assert(CRUBIT_OFFSET_OF(i, struct DocCommentBang) == 0);
 
 extern "C" void __rust_thunk___ZN14DocCommentBangC1Ev(
     struct DocCommentBang* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN14DocCommentBangC1EOS_(
     struct DocCommentBang* __this, struct DocCommentBang* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct DocCommentBang* __rust_thunk___ZN14DocCommentBangaSERKS_(
     struct DocCommentBang* __this, const struct DocCommentBang* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct DocCommentBang* __rust_thunk___ZN14DocCommentBangaSEOS_(
     struct DocCommentBang* __this, struct DocCommentBang* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct MultilineCommentTwoStars) == 4);
@@ -70,27 +71,27 @@ static_assert(CRUBIT_OFFSET_OF(i, struct MultilineCommentTwoStars) == 0);
 
 extern "C" void __rust_thunk___ZN24MultilineCommentTwoStarsC1Ev(
     struct MultilineCommentTwoStars* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN24MultilineCommentTwoStarsC1EOS_(
     struct MultilineCommentTwoStars* __this,
     struct MultilineCommentTwoStars* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct MultilineCommentTwoStars*
 __rust_thunk___ZN24MultilineCommentTwoStarsaSERKS_(
     struct MultilineCommentTwoStars* __this,
     const struct MultilineCommentTwoStars* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct MultilineCommentTwoStars*
 __rust_thunk___ZN24MultilineCommentTwoStarsaSEOS_(
     struct MultilineCommentTwoStars* __this,
     struct MultilineCommentTwoStars* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct LineComment) == 4);
@@ -98,22 +99,22 @@ static_assert(alignof(struct LineComment) == 4);
 static_assert(CRUBIT_OFFSET_OF(i, struct LineComment) == 0);
 
 extern "C" void __rust_thunk___ZN11LineCommentC1Ev(struct LineComment* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN11LineCommentC1EOS_(
     struct LineComment* __this, struct LineComment* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct LineComment* __rust_thunk___ZN11LineCommentaSERKS_(
     struct LineComment* __this, const struct LineComment* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct LineComment* __rust_thunk___ZN11LineCommentaSEOS_(
     struct LineComment* __this, struct LineComment* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct MultilineOneStar) == 4);
@@ -122,22 +123,22 @@ static_assert(CRUBIT_OFFSET_OF(i, struct MultilineOneStar) == 0);
 
 extern "C" void __rust_thunk___ZN16MultilineOneStarC1Ev(
     struct MultilineOneStar* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN16MultilineOneStarC1EOS_(
     struct MultilineOneStar* __this, struct MultilineOneStar* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct MultilineOneStar* __rust_thunk___ZN16MultilineOneStaraSERKS_(
     struct MultilineOneStar* __this, const struct MultilineOneStar* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct MultilineOneStar* __rust_thunk___ZN16MultilineOneStaraSEOS_(
     struct MultilineOneStar* __this, struct MultilineOneStar* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" int __rust_thunk___Z3foov() { return foo(); }
@@ -149,25 +150,25 @@ static_assert(CRUBIT_OFFSET_OF(value, struct MyTemplate<int>) == 0);
 extern "C" void
 __rust_thunk___ZN10MyTemplateIiEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<int>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN10MyTemplateIiEC1EOS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<int>* __this, struct MyTemplate<int>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct MyTemplate<int>*
 __rust_thunk___ZN10MyTemplateIiEaSERKS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<int>* __this, const struct MyTemplate<int>* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct MyTemplate<int>*
 __rust_thunk___ZN10MyTemplateIiEaSEOS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<int>* __this, struct MyTemplate<int>* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" int const*
@@ -183,26 +184,26 @@ static_assert(CRUBIT_OFFSET_OF(value, struct MyTemplate<float>) == 0);
 extern "C" void
 __rust_thunk___ZN10MyTemplateIfEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<float>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN10MyTemplateIfEC1EOS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<float>* __this, struct MyTemplate<float>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct MyTemplate<float>*
 __rust_thunk___ZN10MyTemplateIfEaSERKS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<float>* __this,
     const struct MyTemplate<float>* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct MyTemplate<float>*
 __rust_thunk___ZN10MyTemplateIfEaSEOS0___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3adoc_5fcomment_5fcc(
     struct MyTemplate<float>* __this, struct MyTemplate<float>* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" float const*
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -24,22 +25,22 @@ static_assert(alignof(struct type) == 4);
 static_assert(CRUBIT_OFFSET_OF(dyn, struct type) == 0);
 
 extern "C" void __rust_thunk___ZN4typeC1Ev(struct type* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN4typeC1EOS_(struct type* __this,
                                              struct type* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct type* __rust_thunk___ZN4typeaSERKS_(
     struct type* __this, const struct type* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct type* __rust_thunk___ZN4typeaSEOS_(struct type* __this,
                                                      struct type* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -138,3 +138,44 @@ def golden_test(
         tags = ["ignore_srcs"],
         visibility = ["//visibility:private"],
     )
+
+def golden_metrics_test(
+        name,
+        basenames,
+        metrics,
+        tags = None):
+    """Generates a test that the generated bindings of golden tests don't grow too much.
+
+    The metrics (number of thunks, size of the generated files, and number of static assertions)
+    are recorded in `metrics`. See `common/golden_metrics_test.sh`.
+
+    Args:
+        name: The name of the test.
+        basenames: The basenames of the `golden_test`s whose generated code should be checked. All
+                   of them need to have both `golden_cc` and `golden_rs`.
+        metrics: The file with the recorded metrics.
+        tags: The test tags.
+    """
+    if not tags:
+        tags = []
+    tags.append("crubit_golden_test")
+
+    args = ["$(location %s)" % metrics]
+    data = [metrics]
+    for basename in basenames:
+        new_rs = ":" + basename + ".rs_file"
+        new_cc = ":" + basename + ".cc_file"
+        args += [
+            basename,
+            "$(location %s)" % new_rs,
+            "$(location %s)" % new_cc,
+        ]
+        data += [new_rs, new_cc]
+
+    native.sh_test(
+        name = name,
+        srcs = ["//common:golden_metrics_test.sh"],
+        args = args,
+        data = data,
+        tags = tags,
+    )
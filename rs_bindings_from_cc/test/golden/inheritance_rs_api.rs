@@ -236,20 +236,32 @@ impl<'b> ::ctor::UnpinAssign<::ctor::RvalueReference<'b, Self>> for Derived {
 }
 
 unsafe impl oops::Inherits<crate::Base0> for crate::Derived {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base0 {
         (derived as *const _ as *const u8).offset(0) as *const crate::Base0
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::Base0> for crate::Derived {
+    const BASE_OFFSET: isize = 0;
+}
 unsafe impl oops::Inherits<crate::Base1> for crate::Derived {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base1 {
         (derived as *const _ as *const u8).offset(0) as *const crate::Base1
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::Base1> for crate::Derived {
+    const BASE_OFFSET: isize = 0;
+}
 unsafe impl oops::Inherits<crate::Base2> for crate::Derived {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base2 {
         (derived as *const _ as *const u8).offset(10) as *const crate::Base2
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::Base2> for crate::Derived {
+    const BASE_OFFSET: isize = 10;
+}
 
 #[::ctor::recursively_pinned]
 #[repr(C, align(8))]
@@ -824,15 +836,23 @@ impl MethodDerived {
 }
 
 unsafe impl oops::Inherits<crate::MethodBase1> for crate::MethodDerived {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::MethodBase1 {
         (derived as *const _ as *const u8).offset(0) as *const crate::MethodBase1
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::MethodBase1> for crate::MethodDerived {
+    const BASE_OFFSET: isize = 0;
+}
 unsafe impl oops::Inherits<crate::MethodBase2> for crate::MethodDerived {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::MethodBase2 {
         (derived as *const _ as *const u8).offset(0) as *const crate::MethodBase2
     }
 }
+unsafe impl oops::InheritsNonVirtually<crate::MethodBase2> for crate::MethodDerived {
+    const BASE_OFFSET: isize = 0;
+}
 
 mod detail {
     #[allow(unused_imports)]
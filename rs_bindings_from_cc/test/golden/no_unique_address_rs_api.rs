@@ -57,6 +57,18 @@ impl Struct {
             &*(ptr as *const ::core::ffi::c_char)
         }
     }
+    pub fn set_field1(&mut self, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(0);
+            *(ptr as *mut ::core::ffi::c_int) = value;
+        }
+    }
+    pub fn set_field2(&mut self, value: ::core::ffi::c_char) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(4);
+            *(ptr as *mut ::core::ffi::c_char) = value;
+        }
+    }
 }
 
 impl Default for Struct {
@@ -141,6 +153,12 @@ impl PaddingBetweenFields {
             &*(ptr as *const ::core::ffi::c_int)
         }
     }
+    pub fn set_field2(&mut self, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (self as *mut Self as *mut u8).offset(4);
+            *(ptr as *mut ::core::ffi::c_int) = value;
+        }
+    }
 }
 
 impl Default for PaddingBetweenFields {
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -25,22 +26,22 @@ static_assert(CRUBIT_OFFSET_OF(field1, struct Struct) == 0);
 static_assert(CRUBIT_OFFSET_OF(field2, struct Struct) == 4);
 
 extern "C" void __rust_thunk___ZN6StructC1Ev(struct Struct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN6StructC1EOS_(struct Struct* __this,
                                                struct Struct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct Struct* __rust_thunk___ZN6StructaSERKS_(
     struct Struct* __this, const struct Struct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct Struct* __rust_thunk___ZN6StructaSEOS_(
     struct Struct* __this, struct Struct* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN6Struct4MakeEic(struct Struct* __return,
@@ -55,27 +56,27 @@ static_assert(CRUBIT_OFFSET_OF(field2, struct PaddingBetweenFields) == 4);
 
 extern "C" void __rust_thunk___ZN20PaddingBetweenFieldsC1Ev(
     struct PaddingBetweenFields* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN20PaddingBetweenFieldsC1EOS_(
     struct PaddingBetweenFields* __this,
     struct PaddingBetweenFields* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct PaddingBetweenFields*
 __rust_thunk___ZN20PaddingBetweenFieldsaSERKS_(
     struct PaddingBetweenFields* __this,
     const struct PaddingBetweenFields* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct PaddingBetweenFields*
 __rust_thunk___ZN20PaddingBetweenFieldsaSEOS_(
     struct PaddingBetweenFields* __this,
     struct PaddingBetweenFields* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN20PaddingBetweenFields4MakeEci(
@@ -92,25 +93,25 @@ static_assert(CRUBIT_OFFSET_OF(inner_char_field,
 
 extern "C" void __rust_thunk___ZN30FieldInTailPadding_InnerStructC1Ev(
     struct FieldInTailPadding_InnerStruct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN30FieldInTailPadding_InnerStructC1ERKS_(
     struct FieldInTailPadding_InnerStruct* __this,
     const struct FieldInTailPadding_InnerStruct* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" struct FieldInTailPadding_InnerStruct*
 __rust_thunk___ZN30FieldInTailPadding_InnerStructaSERKS_(
     struct FieldInTailPadding_InnerStruct* __this,
     const struct FieldInTailPadding_InnerStruct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN30FieldInTailPadding_InnerStructD1Ev(
     struct FieldInTailPadding_InnerStruct* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 static_assert(CRUBIT_SIZEOF(struct FieldInTailPadding) == 8);
@@ -122,30 +123,30 @@ static_assert(CRUBIT_OFFSET_OF(char_in_tail_padding_of_prev_field,
 extern "C" void __rust_thunk___ZN18FieldInTailPaddingC1ERKS_(
     struct FieldInTailPadding* __this,
     const struct FieldInTailPadding* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN18FieldInTailPaddingC1EOS_(
     struct FieldInTailPadding* __this, struct FieldInTailPadding* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN18FieldInTailPaddingD1Ev(
     struct FieldInTailPadding* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 extern "C" struct FieldInTailPadding*
 __rust_thunk___ZN18FieldInTailPaddingaSERKS_(
     struct FieldInTailPadding* __this,
     const struct FieldInTailPadding* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct FieldInTailPadding*
 __rust_thunk___ZN18FieldInTailPaddingaSEOS_(
     struct FieldInTailPadding* __this, struct FieldInTailPadding* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN18FieldInTailPaddingC1Eicc(
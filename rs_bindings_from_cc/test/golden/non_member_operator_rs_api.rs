@@ -48,7 +48,7 @@ pub mod ns {
 impl PartialEq for crate::ns::X {
     #[inline(always)]
     fn eq(&self, b: &Self) -> bool {
-        unsafe { crate::detail::__rust_thunk___ZeqN2ns1XES0_(&mut self.clone(), &mut b.clone()) }
+        unsafe { crate::detail::__rust_thunk___ZeqN2ns1XES0_(self.clone(), b.clone()) }
     }
 }
 
@@ -56,10 +56,8 @@ mod detail {
     #[allow(unused_imports)]
     use super::*;
     unsafe extern "C" {
-        pub(crate) unsafe fn __rust_thunk___ZeqN2ns1XES0_(
-            a: &mut crate::ns::X,
-            b: &mut crate::ns::X,
-        ) -> bool;
+        pub(crate) unsafe fn __rust_thunk___ZeqN2ns1XES0_(a: crate::ns::X, b: crate::ns::X)
+            -> bool;
     }
 }
 
@@ -23,8 +23,8 @@ static_assert(CRUBIT_SIZEOF(struct ns::X) == 4);
 static_assert(alignof(struct ns::X) == 4);
 static_assert(CRUBIT_OFFSET_OF(f, struct ns::X) == 0);
 
-extern "C" bool __rust_thunk___ZeqN2ns1XES0_(struct ns::X* a, struct ns::X* b) {
-  return operator==(std::move(*a), std::move(*b));
+extern "C" bool __rust_thunk___ZeqN2ns1XES0_(struct ns::X a, struct ns::X b) {
+  return operator==(std::move(a), std::move(b));
 }
 
 #pragma clang diagnostic pop
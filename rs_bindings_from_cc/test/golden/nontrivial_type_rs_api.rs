@@ -627,8 +627,17 @@ impl From<::core::ffi::c_int> for NontrivialUnpin {
     }
 }
 
-// Error while generating bindings for item 'NontrivialUnpin::NontrivialUnpin':
-// More than 1 constructor parameter is not supported yet
+impl From<(::core::ffi::c_int, ::core::ffi::c_int)> for NontrivialUnpin {
+    #[inline(always)]
+    fn from(args: (::core::ffi::c_int, ::core::ffi::c_int)) -> Self {
+        let (field, unused) = args;
+        let mut tmp = ::core::mem::MaybeUninit::<Self>::zeroed();
+        unsafe {
+            crate::detail::__rust_thunk___ZN15NontrivialUnpinC1Eii(&mut tmp, field, unused);
+            tmp.assume_init()
+        }
+    }
+}
 
 impl Clone for NontrivialUnpin {
     #[inline(always)]
@@ -739,15 +748,8 @@ pub fn TakesByValueInline(
 }
 
 #[inline(always)]
-pub fn TakesByValueUnpin(mut nontrivial: crate::NontrivialUnpin) -> crate::NontrivialUnpin {
-    unsafe {
-        let mut __return = ::core::mem::MaybeUninit::<crate::NontrivialUnpin>::uninit();
-        crate::detail::__rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-            &mut __return,
-            &mut nontrivial,
-        );
-        __return.assume_init()
-    }
+pub fn TakesByValueUnpin(nontrivial: crate::NontrivialUnpin) -> crate::NontrivialUnpin {
+    unsafe { crate::detail::__rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(nontrivial) }
 }
 
 #[inline(always)]
@@ -1095,6 +1097,12 @@ mod detail {
             __this: &'a mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
             field: ::core::ffi::c_int,
         );
+        #[link_name = "_ZN15NontrivialUnpinC1Eii"]
+        pub(crate) unsafe fn __rust_thunk___ZN15NontrivialUnpinC1Eii<'a>(
+            __this: &'a mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
+            field: ::core::ffi::c_int,
+            unused: ::core::ffi::c_int,
+        );
         #[link_name = "_ZN15NontrivialUnpinC1ERKS_"]
         pub(crate) unsafe fn __rust_thunk___ZN15NontrivialUnpinC1ERKS_<'a, 'b>(
             __this: &'a mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
@@ -1141,10 +1149,10 @@ mod detail {
             __return: &mut ::core::mem::MaybeUninit<crate::NontrivialInline>,
             nontrivial: &mut crate::NontrivialInline,
         );
+        #[link_name = "_Z17TakesByValueUnpin15NontrivialUnpin"]
         pub(crate) unsafe fn __rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-            __return: &mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
-            nontrivial: &mut crate::NontrivialUnpin,
-        );
+            nontrivial: crate::NontrivialUnpin,
+        ) -> crate::NontrivialUnpin;
         #[link_name = "_Z16TakesByReferenceR10Nontrivial"]
         pub(crate) unsafe fn __rust_thunk___Z16TakesByReferenceR10Nontrivial<'a>(
             nontrivial: ::core::pin::Pin<&'a mut crate::Nontrivial>,
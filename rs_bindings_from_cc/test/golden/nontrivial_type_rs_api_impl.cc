@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -41,7 +42,7 @@ static_assert(CRUBIT_OFFSET_OF(field, struct NontrivialInline) == 0);
 
 extern "C" void __rust_thunk___ZN16NontrivialInlineC1Ev(
     struct NontrivialInline* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN16NontrivialInlineC1Ei(
@@ -56,22 +57,22 @@ extern "C" void __rust_thunk___ZN16NontrivialInlineC1Eii(
 
 extern "C" void __rust_thunk___ZN16NontrivialInlineC1ERKS_(
     struct NontrivialInline* __this, const struct NontrivialInline* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN16NontrivialInlineC1EOS_(
     struct NontrivialInline* __this, struct NontrivialInline* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct NontrivialInline* __rust_thunk___ZN16NontrivialInlineaSERKS_(
     struct NontrivialInline* __this, const struct NontrivialInline* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct NontrivialInline* __rust_thunk___ZN16NontrivialInlineaSEOS_(
     struct NontrivialInline* __this, struct NontrivialInline* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" struct NontrivialInline* __rust_thunk___ZN16NontrivialInlineaSEi(
@@ -81,7 +82,7 @@ extern "C" struct NontrivialInline* __rust_thunk___ZN16NontrivialInlineaSEi(
 
 extern "C" void __rust_thunk___ZN16NontrivialInlineD1Ev(
     struct NontrivialInline* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN16NontrivialInline14MemberFunctionEv(
@@ -96,35 +97,35 @@ static_assert(CRUBIT_OFFSET_OF(nontrivial_member, struct NontrivialMembers) ==
 
 extern "C" void __rust_thunk___ZN17NontrivialMembersC1Ev(
     struct NontrivialMembers* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN17NontrivialMembersC1ERKS_(
     struct NontrivialMembers* __this,
     const struct NontrivialMembers* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN17NontrivialMembersC1EOS_(
     struct NontrivialMembers* __this, struct NontrivialMembers* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN17NontrivialMembersD1Ev(
     struct NontrivialMembers* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 extern "C" struct NontrivialMembers*
 __rust_thunk___ZN17NontrivialMembersaSERKS_(
     struct NontrivialMembers* __this,
     const struct NontrivialMembers* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct NontrivialMembers* __rust_thunk___ZN17NontrivialMembersaSEOS_(
     struct NontrivialMembers* __this, struct NontrivialMembers* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct NontrivialUnpin) == 4);
@@ -141,28 +142,23 @@ extern "C" void __rust_thunk___Z18TakesByValueInline16NontrivialInline(
   new (__return) auto(TakesByValueInline(std::move(*nontrivial)));
 }
 
-extern "C" void __rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-    struct NontrivialUnpin* __return, struct NontrivialUnpin* nontrivial) {
-  new (__return) auto(TakesByValueUnpin(std::move(*nontrivial)));
-}
-
 static_assert(sizeof(struct NontrivialByValue) == 1);
 static_assert(alignof(struct NontrivialByValue) == 1);
 
 extern "C" void __rust_thunk___ZN17NontrivialByValueC1EOS_(
     struct NontrivialByValue* __this, struct NontrivialByValue* other) {
-  crubit::construct_at(__this, std::move(*other));
+  crubit::MoveCtorThunk(__this, other);
 }
 
 extern "C" struct NontrivialByValue*
 __rust_thunk___ZN17NontrivialByValueaSERKS_(
     struct NontrivialByValue* __this, const struct NontrivialByValue* other) {
-  return &__this->operator=(*other);
+  return crubit::CopyAssignThunk(__this, other);
 }
 
 extern "C" struct NontrivialByValue* __rust_thunk___ZN17NontrivialByValueaSEOS_(
     struct NontrivialByValue* __this, struct NontrivialByValue* other) {
-  return &__this->operator=(std::move(*other));
+  return crubit::MoveAssignThunk(__this, other);
 }
 
 extern "C" void __rust_thunk___ZN17NontrivialByValueaSE10Nontrivial(
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -24,22 +25,22 @@ static_assert(alignof(class PolymorphicBase) == 8);
 
 extern "C" void __rust_thunk___ZN15PolymorphicBaseC1Ev(
     class PolymorphicBase* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN15PolymorphicBaseC1ERKS_(
     class PolymorphicBase* __this, const class PolymorphicBase* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" class PolymorphicBase* __rust_thunk___ZN15PolymorphicBaseaSERKS_(
     class PolymorphicBase* __this, const class PolymorphicBase* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN15PolymorphicBaseD1Ev(
     class PolymorphicBase* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 static_assert(CRUBIT_SIZEOF(class PolymorphicBase2) == 8);
@@ -47,17 +48,17 @@ static_assert(alignof(class PolymorphicBase2) == 8);
 
 extern "C" void __rust_thunk___ZN16PolymorphicBase2C1Ev(
     class PolymorphicBase2* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN16PolymorphicBase2C1ERKS_(
     class PolymorphicBase2* __this, const class PolymorphicBase2* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" class PolymorphicBase2* __rust_thunk___ZN16PolymorphicBase2aSERKS_(
     class PolymorphicBase2* __this, const class PolymorphicBase2* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN16PolymorphicBase23FooEv(
@@ -67,7 +68,7 @@ extern "C" void __rust_thunk___ZN16PolymorphicBase23FooEv(
 
 extern "C" void __rust_thunk___ZN16PolymorphicBase2D1Ev(
     class PolymorphicBase2* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 static_assert(CRUBIT_SIZEOF(class PolymorphicDerived) == 16);
@@ -75,36 +76,36 @@ static_assert(alignof(class PolymorphicDerived) == 8);
 
 extern "C" void __rust_thunk___ZN18PolymorphicDerivedC1Ev(
     class PolymorphicDerived* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN18PolymorphicDerivedC1ERKS_(
     class PolymorphicDerived* __this,
     const class PolymorphicDerived* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN18PolymorphicDerivedC1EOS_(
     class PolymorphicDerived* __this, class PolymorphicDerived* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN18PolymorphicDerivedD1Ev(
     class PolymorphicDerived* __this) {
-  std::destroy_at(__this);
+  crubit::DtorThunk(__this);
 }
 
 extern "C" class PolymorphicDerived*
 __rust_thunk___ZN18PolymorphicDerivedaSERKS_(
     class PolymorphicDerived* __this,
     const class PolymorphicDerived* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class PolymorphicDerived*
 __rust_thunk___ZN18PolymorphicDerivedaSEOS_(
     class PolymorphicDerived* __this, class PolymorphicDerived* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -26,27 +27,27 @@ static_assert(CRUBIT_OFFSET_OF(public_member_variable_,
 
 extern "C" void __rust_thunk___ZN23test_namespace_bindings9SomeClassC1Ev(
     class test_namespace_bindings::SomeClass* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN23test_namespace_bindings9SomeClassC1EOS0_(
     class test_namespace_bindings::SomeClass* __this,
     class test_namespace_bindings::SomeClass* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::SomeClass*
 __rust_thunk___ZN23test_namespace_bindings9SomeClassaSERKS0_(
     class test_namespace_bindings::SomeClass* __this,
     const class test_namespace_bindings::SomeClass* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::SomeClass*
 __rust_thunk___ZN23test_namespace_bindings9SomeClassaSEOS0_(
     class test_namespace_bindings::SomeClass* __this,
     class test_namespace_bindings::SomeClass* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -23,22 +24,22 @@ static_assert(CRUBIT_SIZEOF(class SomeClass) == 4);
 static_assert(alignof(class SomeClass) == 4);
 
 extern "C" void __rust_thunk___ZN9SomeClassC1Ev(class SomeClass* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN9SomeClassC1EOS_(class SomeClass* __this,
                                                   class SomeClass* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class SomeClass* __rust_thunk___ZN9SomeClassaSERKS_(
     class SomeClass* __this, const class SomeClass* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class SomeClass* __rust_thunk___ZN9SomeClassaSEOS_(
     class SomeClass* __this, class SomeClass* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN9SomeClass21static_factory_methodEi(
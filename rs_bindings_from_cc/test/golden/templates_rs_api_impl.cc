@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -24,22 +25,22 @@ static_assert(alignof(struct DifferentScope) == 1);
 
 extern "C" void __rust_thunk___ZN14DifferentScopeC1Ev(
     struct DifferentScope* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN14DifferentScopeC1EOS_(
     struct DifferentScope* __this, struct DifferentScope* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct DifferentScope* __rust_thunk___ZN14DifferentScopeaSERKS_(
     struct DifferentScope* __this, const struct DifferentScope* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct DifferentScope* __rust_thunk___ZN14DifferentScopeaSEOS_(
     struct DifferentScope* __this, struct DifferentScope* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(struct test_namespace_bindings::TemplateParam) == 1);
@@ -47,28 +48,28 @@ static_assert(alignof(struct test_namespace_bindings::TemplateParam) == 1);
 
 extern "C" void __rust_thunk___ZN23test_namespace_bindings13TemplateParamC1Ev(
     struct test_namespace_bindings::TemplateParam* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings13TemplateParamC1EOS0_(
     struct test_namespace_bindings::TemplateParam* __this,
     struct test_namespace_bindings::TemplateParam* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateParam*
 __rust_thunk___ZN23test_namespace_bindings13TemplateParamaSERKS0_(
     struct test_namespace_bindings::TemplateParam* __this,
     const struct test_namespace_bindings::TemplateParam* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateParam*
 __rust_thunk___ZN23test_namespace_bindings13TemplateParamaSEOS0_(
     struct test_namespace_bindings::TemplateParam* __this,
     struct test_namespace_bindings::TemplateParam* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(class private_classes::HasPrivateType) == 1);
@@ -77,21 +78,21 @@ static_assert(alignof(class private_classes::HasPrivateType) == 1);
 extern "C" void __rust_thunk___ZN15private_classes14HasPrivateTypeC1EOS0_(
     class private_classes::HasPrivateType* __this,
     class private_classes::HasPrivateType* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class private_classes::HasPrivateType*
 __rust_thunk___ZN15private_classes14HasPrivateTypeaSERKS0_(
     class private_classes::HasPrivateType* __this,
     const class private_classes::HasPrivateType* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class private_classes::HasPrivateType*
 __rust_thunk___ZN15private_classes14HasPrivateTypeaSEOS0_(
     class private_classes::HasPrivateType* __this,
     class private_classes::HasPrivateType* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(
@@ -102,14 +103,14 @@ static_assert(
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateI14DifferentScopeEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<DifferentScope>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateI14DifferentScopeEC1EOS2___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<DifferentScope>* __this,
     class test_namespace_bindings::MyTemplate<DifferentScope>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::MyTemplate<DifferentScope>*
@@ -117,14 +118,14 @@ __rust_thunk___ZN23test_namespace_bindings10MyTemplateI14DifferentScopeEaSERKS2_
     class test_namespace_bindings::MyTemplate<DifferentScope>* __this,
     const class test_namespace_bindings::MyTemplate<DifferentScope>*
         __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::MyTemplate<DifferentScope>*
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateI14DifferentScopeEaSEOS2___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<DifferentScope>* __this,
     class test_namespace_bindings::MyTemplate<DifferentScope>* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void
@@ -151,7 +152,7 @@ extern "C" void
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateINS_13TemplateParamEEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<
         test_namespace_bindings::TemplateParam>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -160,7 +161,7 @@ __rust_thunk___ZN23test_namespace_bindings10MyTemplateINS_13TemplateParamEEC1EOS
         test_namespace_bindings::TemplateParam>* __this,
     class test_namespace_bindings::MyTemplate<
         test_namespace_bindings::TemplateParam>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::MyTemplate<
@@ -207,28 +208,28 @@ static_assert(alignof(class test_namespace_bindings::MyTemplate<int>) == 4);
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateIiEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<int>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateIiEC1EOS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<int>* __this,
     class test_namespace_bindings::MyTemplate<int>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::MyTemplate<int>*
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateIiEaSERKS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<int>* __this,
     const class test_namespace_bindings::MyTemplate<int>* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class test_namespace_bindings::MyTemplate<int>*
 __rust_thunk___ZN23test_namespace_bindings10MyTemplateIiEaSEOS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class test_namespace_bindings::MyTemplate<int>* __this,
     class test_namespace_bindings::MyTemplate<int>* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" void
@@ -270,7 +271,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsINS0_IiiEEiEC1E
     struct test_namespace_bindings::TemplateWithTwoParams<
         test_namespace_bindings::TemplateWithTwoParams<int, int>, int>*
         __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -280,7 +281,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsINS0_IiiEEiEC1E
     struct test_namespace_bindings::TemplateWithTwoParams<
         test_namespace_bindings::TemplateWithTwoParams<int, int>, int>*
         __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateWithTwoParams<
@@ -327,7 +328,7 @@ static_assert(
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIifEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -335,7 +336,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIifEC1EOS1___2f
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>* __this,
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>*
         __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateWithTwoParams<int, float>*
@@ -343,7 +344,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIifEaSERKS1___2
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>* __this,
     const struct test_namespace_bindings::TemplateWithTwoParams<int, float>*
         __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateWithTwoParams<int, float>*
@@ -351,7 +352,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIifEaSEOS1___2f
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>* __this,
     struct test_namespace_bindings::TemplateWithTwoParams<int, float>*
         __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(
@@ -372,7 +373,7 @@ static_assert(
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIiiEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -380,7 +381,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIiiEC1EOS1___2f
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>* __this,
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>*
         __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateWithTwoParams<int, int>*
@@ -388,7 +389,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIiiEaSERKS1___2
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>* __this,
     const struct test_namespace_bindings::TemplateWithTwoParams<int, int>*
         __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::TemplateWithTwoParams<int, int>*
@@ -396,7 +397,7 @@ __rust_thunk___ZN23test_namespace_bindings21TemplateWithTwoParamsIiiEaSEOS1___2f
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>* __this,
     struct test_namespace_bindings::TemplateWithTwoParams<int, int>*
         __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(struct test_namespace_bindings::MyStruct<char>) == 1);
@@ -405,28 +406,28 @@ static_assert(alignof(struct test_namespace_bindings::MyStruct<char>) == 1);
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings8MyStructIcEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::MyStruct<char>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
 __rust_thunk___ZN23test_namespace_bindings8MyStructIcEC1EOS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::MyStruct<char>* __this,
     struct test_namespace_bindings::MyStruct<char>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::MyStruct<char>*
 __rust_thunk___ZN23test_namespace_bindings8MyStructIcEaSERKS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::MyStruct<char>* __this,
     const struct test_namespace_bindings::MyStruct<char>* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct test_namespace_bindings::MyStruct<char>*
 __rust_thunk___ZN23test_namespace_bindings8MyStructIcEaSEOS1___2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct test_namespace_bindings::MyStruct<char>* __this,
     struct test_namespace_bindings::MyStruct<char>* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(
@@ -445,7 +446,7 @@ static_assert(
 extern "C" void
 __rust_thunk___ZN18MyTopLevelTemplateIN23test_namespace_bindings13TemplateParamEEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -453,7 +454,7 @@ __rust_thunk___ZN18MyTopLevelTemplateIN23test_namespace_bindings13TemplateParamE
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>* __this,
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>*
         __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>*
@@ -461,7 +462,7 @@ __rust_thunk___ZN18MyTopLevelTemplateIN23test_namespace_bindings13TemplateParamE
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>* __this,
     const struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>*
         __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>*
@@ -469,7 +470,7 @@ __rust_thunk___ZN18MyTopLevelTemplateIN23test_namespace_bindings13TemplateParamE
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>* __this,
     struct MyTopLevelTemplate<test_namespace_bindings::TemplateParam>*
         __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(class template_template_params::MyTemplate<
@@ -481,7 +482,7 @@ extern "C" void
 __rust_thunk___ZN24template_template_params10MyTemplateINS_6PolicyEEC1Ev__2f_2fthird_5fparty_2fcrubit_2frs_5fbindings_5ffrom_5fcc_2ftest_2fgolden_3atemplates_5fcc(
     class template_template_params::MyTemplate<
         template_template_params::Policy>* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void
@@ -490,7 +491,7 @@ __rust_thunk___ZN24template_template_params10MyTemplateINS_6PolicyEEC1EOS2___2f_
         template_template_params::Policy>* __this,
     class template_template_params::MyTemplate<
         template_template_params::Policy>* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class template_template_params::MyTemplate<
@@ -177,28 +177,18 @@ pub mod ns {
     }
 
     #[inline(always)]
-    pub fn TakesByValue(mut trivial: crate::ns::Trivial) -> crate::ns::Trivial {
-        unsafe {
-            let mut __return = ::core::mem::MaybeUninit::<crate::ns::Trivial>::uninit();
-            crate::detail::__rust_thunk___ZN2ns12TakesByValueENS_7TrivialE(
-                &mut __return,
-                &mut trivial,
-            );
-            __return.assume_init()
-        }
+    pub fn TakesByValue(trivial: crate::ns::Trivial) -> crate::ns::Trivial {
+        unsafe { crate::detail::__rust_thunk___ZN2ns12TakesByValueENS_7TrivialE(trivial) }
     }
 
     #[inline(always)]
     pub fn TakesTrivialNonfinalByValue(
-        mut trivial: crate::ns::TrivialNonfinal,
+        trivial: crate::ns::TrivialNonfinal,
     ) -> crate::ns::TrivialNonfinal {
         unsafe {
-            let mut __return = ::core::mem::MaybeUninit::<crate::ns::TrivialNonfinal>::uninit();
             crate::detail::__rust_thunk___ZN2ns27TakesTrivialNonfinalByValueENS_15TrivialNonfinalE(
-                &mut __return,
-                &mut trivial,
-            );
-            __return.assume_init()
+                trivial,
+            )
         }
     }
 
@@ -329,14 +319,14 @@ mod detail {
             __this: &'a mut crate::ns::TrivialNonfinal,
             __param_0: ::ctor::RvalueReference<'b, crate::ns::TrivialNonfinal>,
         ) -> &'a mut crate::ns::TrivialNonfinal;
+        #[link_name = "_ZN2ns12TakesByValueENS_7TrivialE"]
         pub(crate) unsafe fn __rust_thunk___ZN2ns12TakesByValueENS_7TrivialE(
-            __return: &mut ::core::mem::MaybeUninit<crate::ns::Trivial>,
-            trivial: &mut crate::ns::Trivial,
-        );
+            trivial: crate::ns::Trivial,
+        ) -> crate::ns::Trivial;
+        #[link_name = "_ZN2ns27TakesTrivialNonfinalByValueENS_15TrivialNonfinalE"]
         pub(crate) unsafe fn __rust_thunk___ZN2ns27TakesTrivialNonfinalByValueENS_15TrivialNonfinalE(
-            __return: &mut ::core::mem::MaybeUninit<crate::ns::TrivialNonfinal>,
-            trivial: &mut crate::ns::TrivialNonfinal,
-        );
+            trivial: crate::ns::TrivialNonfinal,
+        ) -> crate::ns::TrivialNonfinal;
         #[link_name = "_ZN2ns16TakesByReferenceERNS_7TrivialE"]
         pub(crate) unsafe fn __rust_thunk___ZN2ns16TakesByReferenceERNS_7TrivialE<'a>(
             trivial: &'a mut crate::ns::Trivial,
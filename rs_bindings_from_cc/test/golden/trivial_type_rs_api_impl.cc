@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -24,22 +25,22 @@ static_assert(alignof(struct ns::Trivial) == 4);
 static_assert(CRUBIT_OFFSET_OF(trivial_field, struct ns::Trivial) == 0);
 
 extern "C" void __rust_thunk___ZN2ns7TrivialC1Ev(struct ns::Trivial* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN2ns7TrivialC1EOS0_(
     struct ns::Trivial* __this, struct ns::Trivial* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct ns::Trivial* __rust_thunk___ZN2ns7TrivialaSERKS0_(
     struct ns::Trivial* __this, const struct ns::Trivial* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct ns::Trivial* __rust_thunk___ZN2ns7TrivialaSEOS0_(
     struct ns::Trivial* __this, struct ns::Trivial* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct ns::TrivialNonfinal) == 4);
@@ -48,35 +49,25 @@ static_assert(CRUBIT_OFFSET_OF(trivial_field, struct ns::TrivialNonfinal) == 0);
 
 extern "C" void __rust_thunk___ZN2ns15TrivialNonfinalC1Ev(
     struct ns::TrivialNonfinal* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN2ns15TrivialNonfinalC1EOS0_(
     struct ns::TrivialNonfinal* __this, struct ns::TrivialNonfinal* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct ns::TrivialNonfinal*
 __rust_thunk___ZN2ns15TrivialNonfinalaSERKS0_(
     struct ns::TrivialNonfinal* __this,
     const struct ns::TrivialNonfinal* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct ns::TrivialNonfinal*
 __rust_thunk___ZN2ns15TrivialNonfinalaSEOS0_(
     struct ns::TrivialNonfinal* __this, struct ns::TrivialNonfinal* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
-}
-
-extern "C" void __rust_thunk___ZN2ns12TakesByValueENS_7TrivialE(
-    struct ns::Trivial* __return, struct ns::Trivial* trivial) {
-  new (__return) auto(ns::TakesByValue(std::move(*trivial)));
-}
-extern "C" void
-__rust_thunk___ZN2ns27TakesTrivialNonfinalByValueENS_15TrivialNonfinalE(
-    struct ns::TrivialNonfinal* __return, struct ns::TrivialNonfinal* trivial) {
-  new (__return) auto(ns::TakesTrivialNonfinalByValue(std::move(*trivial)));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -23,22 +24,22 @@ static_assert(sizeof(struct SomeStruct) == 1);
 static_assert(alignof(struct SomeStruct) == 1);
 
 extern "C" void __rust_thunk___ZN10SomeStructC1Ev(struct SomeStruct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN10SomeStructC1EOS_(
     struct SomeStruct* __this, struct SomeStruct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct SomeStruct* __rust_thunk___ZN10SomeStructaSERKS_(
     struct SomeStruct* __this, const struct SomeStruct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct SomeStruct* __rust_thunk___ZN10SomeStructaSEOS_(
     struct SomeStruct* __this, struct SomeStruct* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(SomeOtherStruct) == 1);
@@ -46,66 +47,66 @@ static_assert(alignof(SomeOtherStruct) == 1);
 
 extern "C" void __rust_thunk___ZN15SomeOtherStructC1Ev(
     SomeOtherStruct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN15SomeOtherStructC1EOS_(
     SomeOtherStruct* __this, SomeOtherStruct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" SomeOtherStruct* __rust_thunk___ZN15SomeOtherStructaSERKS_(
     SomeOtherStruct* __this, const SomeOtherStruct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" SomeOtherStruct* __rust_thunk___ZN15SomeOtherStructaSEOS_(
     SomeOtherStruct* __this, SomeOtherStruct* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(union SomeUnion) == 1);
 static_assert(alignof(union SomeUnion) == 1);
 
 extern "C" void __rust_thunk___ZN9SomeUnionC1Ev(union SomeUnion* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN9SomeUnionC1EOS_(union SomeUnion* __this,
                                                   union SomeUnion* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" union SomeUnion* __rust_thunk___ZN9SomeUnionaSERKS_(
     union SomeUnion* __this, const union SomeUnion* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" union SomeUnion* __rust_thunk___ZN9SomeUnionaSEOS_(
     union SomeUnion* __this, union SomeUnion* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(sizeof(SomeOtherUnion) == 1);
 static_assert(alignof(SomeOtherUnion) == 1);
 
 extern "C" void __rust_thunk___ZN14SomeOtherUnionC1Ev(SomeOtherUnion* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN14SomeOtherUnionC1EOS_(
     SomeOtherUnion* __this, SomeOtherUnion* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" SomeOtherUnion* __rust_thunk___ZN14SomeOtherUnionaSERKS_(
     SomeOtherUnion* __this, const SomeOtherUnion* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" SomeOtherUnion* __rust_thunk___ZN14SomeOtherUnionaSEOS_(
     SomeOtherUnion* __this, SomeOtherUnion* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
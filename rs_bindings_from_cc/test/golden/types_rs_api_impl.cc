@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -23,22 +24,22 @@ static_assert(sizeof(struct SomeStruct) == 1);
 static_assert(alignof(struct SomeStruct) == 1);
 
 extern "C" void __rust_thunk___ZN10SomeStructC1Ev(struct SomeStruct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN10SomeStructC1EOS_(
     struct SomeStruct* __this, struct SomeStruct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct SomeStruct* __rust_thunk___ZN10SomeStructaSERKS_(
     struct SomeStruct* __this, const struct SomeStruct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct SomeStruct* __rust_thunk___ZN10SomeStructaSEOS_(
     struct SomeStruct* __this, struct SomeStruct* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct FieldTypeTestStruct) == 208);
@@ -106,7 +107,7 @@ static_assert(CRUBIT_OFFSET_OF(cyclic_ptr_field, struct FieldTypeTestStruct) ==
 
 extern "C" void __rust_thunk___ZN19FieldTypeTestStructC1EOS_(
     struct FieldTypeTestStruct* __this, struct FieldTypeTestStruct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___Z21VoidReturningFunctionv() {
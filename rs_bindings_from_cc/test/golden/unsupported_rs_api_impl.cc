@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -25,24 +26,24 @@ static_assert(CRUBIT_OFFSET_OF(i, struct TrivialCustomType) == 0);
 
 extern "C" void __rust_thunk___ZN17TrivialCustomTypeC1Ev(
     struct TrivialCustomType* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN17TrivialCustomTypeC1EOS_(
     struct TrivialCustomType* __this, struct TrivialCustomType* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct TrivialCustomType*
 __rust_thunk___ZN17TrivialCustomTypeaSERKS_(
     struct TrivialCustomType* __this,
     const struct TrivialCustomType* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct TrivialCustomType* __rust_thunk___ZN17TrivialCustomTypeaSEOS_(
     struct TrivialCustomType* __this, struct TrivialCustomType* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 static_assert(CRUBIT_SIZEOF(struct NontrivialCustomType) == 4);
@@ -55,22 +56,22 @@ static_assert(CRUBIT_OFFSET_OF(nested_struct, struct ContainingStruct) == 0);
 
 extern "C" void __rust_thunk___ZN16ContainingStructC1Ev(
     struct ContainingStruct* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN16ContainingStructC1EOS_(
     struct ContainingStruct* __this, struct ContainingStruct* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct ContainingStruct* __rust_thunk___ZN16ContainingStructaSERKS_(
     struct ContainingStruct* __this, const struct ContainingStruct* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct ContainingStruct* __rust_thunk___ZN16ContainingStructaSEOS_(
     struct ContainingStruct* __this, struct ContainingStruct* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -134,15 +134,23 @@ unsafe impl oops::Inherits<inheritance_cc::Base0> for crate::Derived2 {
     }
 }
 unsafe impl oops::Inherits<inheritance_cc::Base1> for crate::Derived2 {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::Base1 {
         (derived as *const _ as *const u8).offset(8) as *const inheritance_cc::Base1
     }
 }
+unsafe impl oops::InheritsNonVirtually<inheritance_cc::Base1> for crate::Derived2 {
+    const BASE_OFFSET: isize = 8;
+}
 unsafe impl oops::Inherits<inheritance_cc::Base2> for crate::Derived2 {
+    #[inline(always)]
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::Base2 {
         (derived as *const _ as *const u8).offset(18) as *const inheritance_cc::Base2
     }
 }
+unsafe impl oops::InheritsNonVirtually<inheritance_cc::Base2> for crate::Derived2 {
+    const BASE_OFFSET: isize = 18;
+}
 
 #[::ctor::recursively_pinned]
 #[repr(C, align(8))]
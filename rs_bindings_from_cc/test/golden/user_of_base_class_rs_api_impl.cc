@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -24,27 +25,27 @@ static_assert(alignof(struct Derived2) == 8);
 static_assert(CRUBIT_OFFSET_OF(derived_1, struct Derived2) == 20);
 
 extern "C" void __rust_thunk___ZN8Derived2C1Ev(struct Derived2* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN8Derived2C1ERKS_(
     struct Derived2* __this, const struct Derived2* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN8Derived2C1EOS_(struct Derived2* __this,
                                                  struct Derived2* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct Derived2* __rust_thunk___ZN8Derived2aSERKS_(
     struct Derived2* __this, const struct Derived2* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct Derived2* __rust_thunk___ZN8Derived2aSEOS_(
     struct Derived2* __this, struct Derived2* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" const class Base0&
@@ -58,27 +59,27 @@ static_assert(alignof(class VirtualDerived2) == 8);
 
 extern "C" void __rust_thunk___ZN15VirtualDerived2C1Ev(
     class VirtualDerived2* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN15VirtualDerived2C1ERKS_(
     class VirtualDerived2* __this, const class VirtualDerived2* __param_0) {
-  crubit::construct_at(__this, *__param_0);
+  crubit::CopyCtorThunk(__this, __param_0);
 }
 
 extern "C" void __rust_thunk___ZN15VirtualDerived2C1EOS_(
     class VirtualDerived2* __this, class VirtualDerived2* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" class VirtualDerived2* __rust_thunk___ZN15VirtualDerived2aSERKS_(
     class VirtualDerived2* __this, const class VirtualDerived2* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" class VirtualDerived2* __rust_thunk___ZN15VirtualDerived2aSEOS_(
     class VirtualDerived2* __this, class VirtualDerived2* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 extern "C" const class VirtualBase1&
@@ -9,6 +9,7 @@
 #include "support/internal/cxx20_backports.h"
 #include "support/internal/offsetof.h"
 #include "support/internal/sizeof.h"
+#include "support/internal/special_member_thunks.h"
 
 #include <cstddef>
 #include <memory>
@@ -19,36 +20,31 @@
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wthread-safety-analysis"
 
-extern "C" void __rust_thunk___Z16UsesImportedTypeN2ns7TrivialE(
-    struct ns::Trivial* __return, struct ns::Trivial* t) {
-  new (__return) auto(UsesImportedType(std::move(*t)));
-}
-
 static_assert(CRUBIT_SIZEOF(struct UserOfImportedType) == 8);
 static_assert(alignof(struct UserOfImportedType) == 8);
 static_assert(CRUBIT_OFFSET_OF(trivial, struct UserOfImportedType) == 0);
 
 extern "C" void __rust_thunk___ZN18UserOfImportedTypeC1Ev(
     struct UserOfImportedType* __this) {
-  crubit::construct_at(__this);
+  crubit::DefaultCtorThunk(__this);
 }
 
 extern "C" void __rust_thunk___ZN18UserOfImportedTypeC1EOS_(
     struct UserOfImportedType* __this, struct UserOfImportedType* __param_0) {
-  crubit::construct_at(__this, std::move(*__param_0));
+  crubit::MoveCtorThunk(__this, __param_0);
 }
 
 extern "C" struct UserOfImportedType*
 __rust_thunk___ZN18UserOfImportedTypeaSERKS_(
     struct UserOfImportedType* __this,
     const struct UserOfImportedType* __param_0) {
-  return &__this->operator=(*__param_0);
+  return crubit::CopyAssignThunk(__this, __param_0);
 }
 
 extern "C" struct UserOfImportedType*
 __rust_thunk___ZN18UserOfImportedTypeaSEOS_(
     struct UserOfImportedType* __this, struct UserOfImportedType* __param_0) {
-  return &__this->operator=(std::move(*__param_0));
+  return crubit::MoveAssignThunk(__this, __param_0);
 }
 
 #pragma clang diagnostic pop
@@ -16,6 +16,15 @@ mod tests {
         assert_eq!(s.field2(), &2);
     }
 
+    #[gtest]
+    fn test_set() {
+        let mut s = Struct::Make(1, 2);
+        s.set_field1(3);
+        s.set_field2(4);
+        assert_eq!(s.field1(), &3);
+        assert_eq!(s.field2(), &4);
+    }
+
     #[gtest]
     fn test_padding_between_fields() {
         let s = PaddingBetweenFields::Make(1, 2);
@@ -49,9 +58,12 @@ mod tests {
 
     #[gtest]
     fn test_struct_with_bit_fields_and_no_unique_address_fields() {
-        let s = StructWithBitFieldsAndNoUniqueAddressField::default();
+        let mut s = StructWithBitFieldsAndNoUniqueAddressField::default();
         assert_eq!(s.field2, 54321);
         assert_eq!(*s.no_unique_address_int_field(), 67890);
+        s.set_no_unique_address_int_field(1);
+        assert_eq!(*s.no_unique_address_int_field(), 1);
+        assert_eq!(s.field2, 54321);
         assert_eq!(s.no_unique_address_empty_field1().method(), 12345);
         assert_eq!(s.no_unique_address_empty_field2().method(), 12345);
     }
@@ -12,6 +12,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "absl/types/span.h"
+
 // Not a template, so that it isn't visible to the bindings generator.
 // We're just here to save typing.
 #define TEST(Name, T)                            \
@@ -150,4 +152,9 @@ TEST(TypeMapOverrideSliceRefArbitraryStruct, SliceRef<ns::ExampleStruct>);
 TEST(TypeMapOverrideSliceRefArbitraryEnum, SliceRef<const ns::ExampleEnum>);
 TEST(TypeMapOverrideSliceRefArbitraryAliasEnum, SliceRef<AliasEnum>);
 
+// `absl::Span` is mapped like `SliceRef`, even though it isn't annotated.
+TEST(AbslSpanConstInt32, absl::Span<const int32_t>);
+TEST(AbslSpanInt32, absl::Span<int32_t>);
+TEST(AbslSpanArbitraryStruct, absl::Span<const ns::ExampleStruct>);
+
 #endif  // CRUBIT_RS_BINDINGS_FROM_CC_TEST_TYPES_TYPES_NONPTR_H_
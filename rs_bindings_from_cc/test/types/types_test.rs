@@ -151,6 +151,10 @@ type_is!(
     TypeMapOverrideSliceRefArbitraryStruct => *mut [types_nonptr::ns::ExampleStruct],
     TypeMapOverrideSliceRefArbitraryEnum => *const [types_nonptr::ns::ExampleEnum],
     TypeMapOverrideSliceRefArbitraryAliasEnum => *mut [types_nonptr::AliasEnum],
+
+    AbslSpanConstInt32 => *const [i32],
+    AbslSpanInt32 => *mut [i32],
+    AbslSpanArbitraryStruct => *const [types_nonptr::ns::ExampleStruct],
 );
 
 // TODO(b/228569417): These should all generate bindings and be & (mut) 'static.
@@ -0,0 +1,220 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/timing_report.h"
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+
+namespace crubit {
+
+namespace {
+
+struct ResourceUsage {
+  absl::Duration cpu_time;
+  int64_t peak_rss_kb;
+};
+
+ResourceUsage GetResourceUsage() {
+  struct rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return ResourceUsage{
+      .cpu_time = absl::DurationFromTimeval(usage.ru_utime) +
+                  absl::DurationFromTimeval(usage.ru_stime),
+      // On Linux, `ru_maxrss` is in kilobytes.
+      .peak_rss_kb = usage.ru_maxrss,
+  };
+}
+
+}  // namespace
+
+TimingReport::TimingReport() : start_(absl::Now()) {}
+
+TimingReport::ScopedPhase::ScopedPhase(TimingReport* report,
+                                       absl::string_view name)
+    : report_(report) {
+  if (report_ == nullptr) return;
+  index_ = report_->phases_.size();
+  report_->phases_.push_back(Phase{
+      .name = std::string(name),
+      .depth = report_->depth_++,
+      .start = absl::Now(),
+  });
+  cpu_start_ = GetResourceUsage().cpu_time;
+}
+
+TimingReport::ScopedPhase::~ScopedPhase() {
+  if (report_ == nullptr) return;
+  ResourceUsage usage = GetResourceUsage();
+  Phase& phase = report_->phases_[index_];
+  phase.wall_time = absl::Now() - phase.start;
+  phase.cpu_time = usage.cpu_time - cpu_start_;
+  phase.peak_rss_kb = usage.peak_rss_kb;
+  --report_->depth_;
+}
+
+absl::Status TimingReport::AddGeneratorReport(
+    absl::string_view generator_report_json) {
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse(llvm::StringRef(generator_report_json.data(),
+                                        generator_report_json.size()));
+  if (!json) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid generator timing report: ",
+                     llvm::toString(json.takeError())));
+  }
+  const llvm::json::Object* report = json->getAsObject();
+  if (report == nullptr) {
+    return absl::InvalidArgumentError(
+        "Expected the generator timing report to be an object");
+  }
+  if (const llvm::json::Array* phases = report->getArray("phases")) {
+    for (const llvm::json::Value& value : *phases) {
+      const llvm::json::Object* phase = value.getAsObject();
+      if (phase == nullptr) {
+        return absl::InvalidArgumentError(
+            "Expected the phases of the generator timing report to be "
+            "objects");
+      }
+      auto name = phase->getString("name");
+      auto start_unix_us = phase->getInteger("start_unix_us");
+      auto wall_us = phase->getInteger("wall_us");
+      if (!name || !start_unix_us || !wall_us) {
+        return absl::InvalidArgumentError(
+            "Expected `name`, `start_unix_us` and `wall_us` in each phase of "
+            "the generator timing report");
+      }
+      phases_.push_back(Phase{
+          .name = name->str(),
+          .depth = depth_,
+          .start = absl::FromUnixMicros(*start_unix_us),
+          .wall_time = absl::Microseconds(*wall_us),
+      });
+    }
+  }
+  if (const llvm::json::Object* item_kinds = report->getObject("item_kinds")) {
+    for (const auto& [kind, value] : *item_kinds) {
+      const llvm::json::Object* item_kind = value.getAsObject();
+      if (item_kind == nullptr) {
+        return absl::InvalidArgumentError(
+            "Expected the item kinds of the generator timing report to be "
+            "objects");
+      }
+      auto count = item_kind->getInteger("count");
+      auto generation_us = item_kind->getInteger("generation_us");
+      if (!count || !generation_us) {
+        return absl::InvalidArgumentError(
+            "Expected `count` and `generation_us` in each item kind of the "
+            "generator timing report");
+      }
+      ItemKind& total = item_kinds_[kind.str()];
+      total.count += *count;
+      total.generation_time += absl::Microseconds(*generation_us);
+    }
+  }
+  if (const llvm::json::Object* queries = report->getObject("queries")) {
+    for (const auto& [name, value] : *queries) {
+      const llvm::json::Object* query = value.getAsObject();
+      if (query == nullptr) {
+        return absl::InvalidArgumentError(
+            "Expected the queries of the generator timing report to be "
+            "objects");
+      }
+      auto count = query->getInteger("count");
+      auto computation_us = query->getInteger("computation_us");
+      if (!count || !computation_us) {
+        return absl::InvalidArgumentError(
+            "Expected `count` and `computation_us` in each query of the "
+            "generator timing report");
+      }
+      Query& total = queries_[name.str()];
+      total.count += *count;
+      total.computation_time += absl::Microseconds(*computation_us);
+    }
+  }
+  return absl::OkStatus();
+}
+
+std::string TimingReport::ToJson() const {
+  llvm::json::Array phases;
+  for (const Phase& phase : phases_) {
+    llvm::json::Object json_phase{
+        {"name", phase.name},
+        {"depth", phase.depth},
+        {"start_ms", absl::ToDoubleMilliseconds(phase.start - start_)},
+        {"wall_ms", absl::ToDoubleMilliseconds(phase.wall_time)},
+    };
+    if (phase.cpu_time.has_value()) {
+      json_phase["cpu_ms"] = absl::ToDoubleMilliseconds(*phase.cpu_time);
+    }
+    if (phase.peak_rss_kb.has_value()) {
+      json_phase["peak_rss_kb"] = *phase.peak_rss_kb;
+    }
+    phases.push_back(std::move(json_phase));
+  }
+  llvm::json::Object item_kinds;
+  for (const auto& [kind, item_kind] : item_kinds_) {
+    item_kinds[kind] = llvm::json::Object{
+        {"count", item_kind.count},
+        {"generation_ms",
+         absl::ToDoubleMilliseconds(item_kind.generation_time)},
+    };
+  }
+  llvm::json::Object queries;
+  for (const auto& [name, query] : queries_) {
+    queries[name] = llvm::json::Object{
+        {"count", query.count},
+        {"computation_ms", absl::ToDoubleMilliseconds(query.computation_time)},
+    };
+  }
+  llvm::json::Object report{
+      {"phases", std::move(phases)},
+      {"item_kinds", std::move(item_kinds)},
+      {"queries", std::move(queries)},
+  };
+  return std::string(
+      llvm::formatv("{0:2}", llvm::json::Value(std::move(report))));
+}
+
+std::string TimingReport::ToChromeTrace() const {
+  llvm::json::Array events;
+  for (const Phase& phase : phases_) {
+    // A "complete" event (`"ph": "X"`) covers the whole phase.
+    llvm::json::Object args;
+    if (phase.cpu_time.has_value()) {
+      args["cpu_ms"] = absl::ToDoubleMilliseconds(*phase.cpu_time);
+    }
+    if (phase.peak_rss_kb.has_value()) {
+      args["peak_rss_kb"] = *phase.peak_rss_kb;
+    }
+    events.push_back(llvm::json::Object{
+        {"name", phase.name},
+        {"ph", "X"},
+        {"pid", 1},
+        {"tid", 1},
+        {"ts", absl::ToInt64Microseconds(phase.start - start_)},
+        {"dur", absl::ToInt64Microseconds(phase.wall_time)},
+        {"args", std::move(args)},
+    });
+  }
+  llvm::json::Object trace{{"traceEvents", std::move(events)}};
+  return std::string(
+      llvm::formatv("{0:2}", llvm::json::Value(std::move(trace))));
+}
+
+}  // namespace crubit
@@ -0,0 +1,99 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_TIMING_REPORT_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_TIMING_REPORT_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace crubit {
+
+// Collects the wall time, CPU time and peak RSS of the phases of bindings
+// generation (see `--timing_report_out` and `--timing_trace_out`), plus the
+// number of items of each kind and the time spent generating them, and the
+// number of computations of memoized queries of the Rust bindings generator
+// and the time spent in them.
+//
+// Not thread-safe.
+class TimingReport {
+ public:
+  TimingReport();
+
+  // Records the phase `name`, from the construction of the `ScopedPhase` to
+  // its destruction. Phases can be nested. Does nothing if `report` is null,
+  // so that callers don't have to check whether timing is requested.
+  class ScopedPhase {
+   public:
+    ScopedPhase(TimingReport* report, absl::string_view name);
+    ~ScopedPhase();
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+   private:
+    TimingReport* report_;
+    size_t index_;
+    absl::Duration cpu_start_;
+  };
+
+  // Adds the phases and the per-item-kind and per-query profiles reported by
+  // the Rust bindings generator (see `generation_profile.rs`). The phases are
+  // nested in the innermost `ScopedPhase` that is currently open.
+  absl::Status AddGeneratorReport(absl::string_view generator_report_json);
+
+  // Returns the report as JSON:
+  //
+  //   {
+  //     "phases": [{"name": "ir_from_cc", "depth": 1, "start_ms": 1.5,
+  //                 "wall_ms": 1234.5, "cpu_ms": 1200.0,
+  //                 "peak_rss_kb": 500000}, ...],
+  //     "item_kinds": {"Func": {"count": 12, "generation_ms": 3.5}, ...},
+  //     "queries": {"has_bindings": {"count": 40, "computation_ms": 0.5}, ...}
+  //   }
+  //
+  // `cpu_ms` and `peak_rss_kb` are only measured for phases of the C++ side,
+  // and `peak_rss_kb` is the peak of the whole process up to the end of the
+  // phase.
+  std::string ToJson() const;
+
+  // Returns the phases in the Chrome trace event format, which can be loaded
+  // into chrome://tracing or Perfetto.
+  std::string ToChromeTrace() const;
+
+ private:
+  struct Phase {
+    std::string name;
+    int depth;
+    absl::Time start;
+    absl::Duration wall_time;
+    std::optional<absl::Duration> cpu_time;
+    std::optional<int64_t> peak_rss_kb;
+  };
+  struct ItemKind {
+    int64_t count = 0;
+    absl::Duration generation_time;
+  };
+  struct Query {
+    int64_t count = 0;
+    absl::Duration computation_time;
+  };
+
+  absl::Time start_;
+  int depth_ = 0;
+  std::vector<Phase> phases_;
+  std::map<std::string, ItemKind> item_kinds_;
+  std::map<std::string, Query> queries_;
+};
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_TIMING_REPORT_H_
@@ -0,0 +1,74 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/timing_report.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "common/status_test_matchers.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+TEST(TimingReportTest, NestedPhases) {
+  TimingReport report;
+  {
+    TimingReport::ScopedPhase outer(&report, "outer");
+    TimingReport::ScopedPhase inner(&report, "inner");
+  }
+  std::string json = report.ToJson();
+  EXPECT_THAT(json, AllOf(HasSubstr(R"("name": "outer")"),
+                          HasSubstr(R"("name": "inner")"),
+                          HasSubstr(R"("depth": 1)"), HasSubstr(R"("cpu_ms")"),
+                          HasSubstr(R"("peak_rss_kb")")));
+  EXPECT_THAT(report.ToChromeTrace(),
+              AllOf(HasSubstr(R"("traceEvents")"), HasSubstr(R"("ph": "X")"),
+                    HasSubstr(R"("name": "inner")")));
+}
+
+TEST(TimingReportTest, NullReportIsIgnored) {
+  TimingReport::ScopedPhase phase(nullptr, "phase");
+}
+
+TEST(TimingReportTest, GeneratorReport) {
+  TimingReport report;
+  {
+    TimingReport::ScopedPhase phase(&report, "generate_bindings");
+    ASSERT_OK(report.AddGeneratorReport(R"({
+      "phases": [
+        {"name": "format", "start_unix_us": 1700000000000000, "wall_us": 12}
+      ],
+      "item_kinds": {"Func": {"count": 3, "generation_us": 40}},
+      "queries": {"has_bindings": {"count": 5, "computation_us": 7}}
+    })"));
+  }
+  std::string json = report.ToJson();
+  EXPECT_THAT(json, AllOf(HasSubstr(R"("name": "format")"),
+                          HasSubstr(R"("Func")"), HasSubstr(R"("count": 3)"),
+                          HasSubstr(R"("generation_ms")"),
+                          HasSubstr(R"("has_bindings")"),
+                          HasSubstr(R"("count": 5)"),
+                          HasSubstr(R"("computation_ms")")));
+}
+
+TEST(TimingReportTest, InvalidGeneratorReport) {
+  TimingReport report;
+  EXPECT_THAT(report.AddGeneratorReport("["),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid generator timing report")));
+  EXPECT_THAT(report.AddGeneratorReport(R"({"phases": [{"name": "x"}]})"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("start_unix_us")));
+  EXPECT_THAT(report.ToJson(), Not(HasSubstr(R"("name": "x")")));
+}
+
+}  // namespace
+}  // namespace crubit
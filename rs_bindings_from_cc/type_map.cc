@@ -10,7 +10,10 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "clang/AST/Decl.h"
 #include "clang/AST/Type.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Casting.h"
 
 namespace crubit {
 
@@ -60,9 +63,49 @@ std::optional<absl::string_view> MapKnownCcTypeToRsType(
   return it->second;
 }
 
+// Returns the name of the type alias (typedef or using declaration) that
+// `type` is spelled as, or nullopt if it isn't spelled as a type alias.
+std::optional<llvm::StringRef> GetTypeAliasName(const clang::Type& type) {
+  const clang::Type* spelled_type = &type;
+  while (true) {
+    if (const auto* elaborated =
+            llvm::dyn_cast<clang::ElaboratedType>(spelled_type)) {
+      spelled_type = elaborated->getNamedType().getTypePtr();
+    } else if (const auto* subst =
+                   llvm::dyn_cast<clang::SubstTemplateTypeParmType>(
+                       spelled_type)) {
+      spelled_type = subst->getReplacementType().getTypePtr();
+    } else if (const auto* paren =
+                   llvm::dyn_cast<clang::ParenType>(spelled_type)) {
+      spelled_type = paren->getInnerType().getTypePtr();
+    } else if (const auto* macro_qualified =
+                   llvm::dyn_cast<clang::MacroQualifiedType>(spelled_type)) {
+      spelled_type = macro_qualified->getUnderlyingType().getTypePtr();
+    } else {
+      break;
+    }
+  }
+  if (const auto* typedef_type =
+          llvm::dyn_cast<clang::TypedefType>(spelled_type)) {
+    return typedef_type->getDecl()->getName();
+  } else if (const auto* using_type =
+                 llvm::dyn_cast<clang::UsingType>(spelled_type)) {
+    return using_type->getFoundDecl()->getName();
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
 std::optional<MappedType> GetTypeMapOverride(const clang::Type& cpp_type) {
+  // This is called for every type that is converted, but the well-known types
+  // are all type aliases, whose unqualified names are well-known type names
+  // too. Checking that first avoids printing all other types as strings.
+  std::optional<llvm::StringRef> alias_name = GetTypeAliasName(cpp_type);
+  if (!alias_name.has_value() ||
+      !MapKnownCcTypeToRsType(*alias_name).has_value()) {
+    return std::nullopt;
+  }
   std::string type_string = clang::QualType(&cpp_type, 0).getAsString();
   std::optional<absl::string_view> rust_type =
       MapKnownCcTypeToRsType(type_string);
@@ -6,6 +6,9 @@ use import_internal::{ImportMacroInput, Mode};
 use merged_namespaces::{JsonNamespaceHierarchy, MergedNamespaceHierarchy};
 use proc_macro2::TokenStream;
 use quote::ToTokens;
+use std::cell::RefCell;
+use std::rc::Rc;
+use std::time::SystemTime;
 use syn::parse::{Parse, ParseStream};
 use syn::Result;
 
@@ -28,12 +31,51 @@ impl CcImportMacroInput {
     }
 }
 
-fn get_namespace_hierarchy() -> MergedNamespaceHierarchy {
+/// Identifies the namespace files that a `MergedNamespaceHierarchy` was built
+/// from: the value of `CC_IMPORT_NAMESPACES` and the modification time of each
+/// file.
+#[derive(PartialEq)]
+struct NamespaceHierarchyKey {
+    namespace_json_files: String,
+    modified: Vec<Option<SystemTime>>,
+}
+
+type CachedNamespaceHierarchy = (NamespaceHierarchyKey, Rc<MergedNamespaceHierarchy>);
+
+thread_local! {
+    /// The hierarchy of the last `cc_import!` expansion. All expansions in a
+    /// crate see the same dependencies, so they only parse and merge the
+    /// namespace files once.
+    static NAMESPACE_HIERARCHY_CACHE: RefCell<Option<CachedNamespaceHierarchy>> =
+        const { RefCell::new(None) };
+}
+
+fn get_namespace_hierarchy() -> Rc<MergedNamespaceHierarchy> {
     let namespace_json_files = std::env::var("CC_IMPORT_NAMESPACES")
         .expect("Missing CC_IMPORT_NAMESPACES environment variable");
     let files: Vec<String> = serde_json::from_str(&namespace_json_files)
         .expect("Could not parse CC_IMPORT_NAMESPACES environment variable");
+    let key = NamespaceHierarchyKey {
+        modified: files
+            .iter()
+            .map(|file_path| std::fs::metadata(file_path).and_then(|m| m.modified()).ok())
+            .collect(),
+        namespace_json_files,
+    };
+
+    NAMESPACE_HIERARCHY_CACHE.with(|cache| {
+        if let Some((cached_key, hierarchy)) = &*cache.borrow() {
+            if *cached_key == key {
+                return hierarchy.clone();
+            }
+        }
+        let hierarchy = Rc::new(merge_namespace_hierarchies(&files));
+        *cache.borrow_mut() = Some((key, hierarchy.clone()));
+        hierarchy
+    })
+}
 
+fn merge_namespace_hierarchies(files: &[String]) -> MergedNamespaceHierarchy {
     let merged_hierarchy = files
         .iter()
         .map(|file_path| {
@@ -6,6 +6,7 @@ use import_internal::{AbsoluteLabel, Mode};
 use proc_macro2::{Span, TokenStream};
 use quote::{quote, ToTokens, TokenStreamExt};
 use serde::Deserialize;
+use std::collections::btree_map::Entry;
 use std::collections::BTreeMap;
 use std::collections::BTreeSet;
 use std::rc::Rc;
@@ -81,16 +82,17 @@ impl MergedNamespace {
     }
 
     fn add_child(&mut self, namespace: MergedNamespace) {
-        self.labels.append(&mut namespace.labels.iter().cloned().collect());
-        match self.children.get_mut(&namespace.name) {
-            Some(child_namespace) => {
+        self.labels.extend(namespace.labels.iter().cloned());
+        match self.children.entry(namespace.name.clone()) {
+            Entry::Occupied(mut child_namespace) => {
                 let MergedNamespace { name: _, children, labels: _ } = namespace;
+                let child_namespace = child_namespace.get_mut();
                 for child in children.into_values() {
                     child_namespace.add_child(child);
                 }
             }
-            None => {
-                self.children.insert(namespace.name.clone(), namespace);
+            Entry::Vacant(vacant) => {
+                vacant.insert(namespace);
             }
         }
     }
@@ -112,12 +114,12 @@ impl MergedNamespaceHierarchy {
     // Merges the namespace hierarchy passed as an argument into the current one.
     pub fn merge(&mut self, other: MergedNamespaceHierarchy) {
         for (name, namespace) in other.top_level_namespaces {
-            match self.top_level_namespaces.get_mut(&name) {
-                Some(child_namespace) => {
-                    child_namespace.merge(namespace);
+            match self.top_level_namespaces.entry(name) {
+                Entry::Occupied(mut child_namespace) => {
+                    child_namespace.get_mut().merge(namespace);
                 }
-                None => {
-                    self.top_level_namespaces.insert(name, namespace);
+                Entry::Vacant(vacant) => {
+                    vacant.insert(namespace);
                 }
             }
         }
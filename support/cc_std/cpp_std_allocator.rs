@@ -4,8 +4,8 @@
 // #![feature(allocator_api)]
 
 use crate::crubit_cc_std_internal::std_allocator::{
-    cpp_delete, cpp_delete_with_alignment, cpp_new, cpp_new_with_alignment,
-    StdCppDefaultNewAlignment,
+    cpp_delete, cpp_delete_unsized, cpp_delete_unsized_with_alignment, cpp_delete_with_alignment,
+    cpp_new, cpp_new_with_alignment, cpp_try_realloc, StdCppDefaultNewAlignment,
 };
 use core::alloc::AllocError;
 use core::alloc::Allocator;
@@ -47,4 +47,87 @@ unsafe impl Allocator for StdAllocator {
             }
         }
     }
+
+    unsafe fn grow(
+        &self,
+        ptr: NonNull<u8>,
+        old_layout: Layout,
+        new_layout: Layout,
+    ) -> Result<NonNull<[u8]>, AllocError> {
+        unsafe { self.resize(ptr, old_layout, new_layout) }
+    }
+
+    unsafe fn shrink(
+        &self,
+        ptr: NonNull<u8>,
+        old_layout: Layout,
+        new_layout: Layout,
+    ) -> Result<NonNull<[u8]>, AllocError> {
+        unsafe { self.resize(ptr, old_layout, new_layout) }
+    }
+}
+
+impl StdAllocator {
+    /// Frees memory allocated by C++ `new` for an object whose alignment is
+    /// `align`, without passing its size to `operator delete`.
+    ///
+    /// Unlike `deallocate`, this is correct when the size of the allocation
+    /// isn't known, e.g. when a `unique_ptr<Base>` owns a `Derived`.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must have been allocated by C++ `new` (or `StdAllocator`), for an
+    /// object whose alignment is `align`, and must not be used afterwards.
+    pub unsafe fn deallocate_unsized(&self, ptr: NonNull<u8>, align: usize) {
+        unsafe {
+            if align > StdCppDefaultNewAlignment::Value.into() {
+                // overaligned allocation
+                cpp_delete_unsized_with_alignment(ptr.as_ptr() as *mut c_void, align)
+            } else {
+                cpp_delete_unsized(ptr.as_ptr() as *mut c_void)
+            }
+        }
+    }
+
+    /// Implementation of `grow` and `shrink`.
+    ///
+    /// The default implementations of `grow` and `shrink` always allocate new
+    /// memory, copy the bytes and deallocate the old memory.  `cpp_try_realloc`
+    /// can instead resize the allocation in place (when `operator new` is
+    /// known to be `malloc`), which matters when a large vector grows.  Moving
+    /// the bytes is always okay, because Rust values are trivially
+    /// relocatable.
+    unsafe fn resize(
+        &self,
+        ptr: NonNull<u8>,
+        old_layout: Layout,
+        new_layout: Layout,
+    ) -> Result<NonNull<[u8]>, AllocError> {
+        // `realloc` can't change the alignment, and it only guarantees the default
+        // alignment.  `realloc(ptr, 0)` may free `ptr` and return null, which would be
+        // indistinguishable from a failure to resize, so shrinking to zero bytes
+        // always goes through `allocate`.
+        if old_layout.align() == new_layout.align()
+            && new_layout.align() <= StdCppDefaultNewAlignment::Value.into()
+            && new_layout.size() != 0
+        {
+            let raw_ptr = unsafe {
+                cpp_try_realloc(ptr.as_ptr() as *mut c_void, old_layout.size(), new_layout.size())
+            } as *mut u8;
+            if let Some(new_ptr) = NonNull::new(raw_ptr) {
+                return Ok(NonNull::slice_from_raw_parts(new_ptr, new_layout.size()));
+            }
+        }
+
+        let new_ptr = self.allocate(new_layout)?;
+        unsafe {
+            core::ptr::copy_nonoverlapping(
+                ptr.as_ptr(),
+                new_ptr.as_ptr() as *mut u8,
+                core::cmp::min(old_layout.size(), new_layout.size()),
+            );
+            self.deallocate(ptr, old_layout);
+        }
+        Ok(new_ptr)
+    }
 }
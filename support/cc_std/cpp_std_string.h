@@ -22,12 +22,31 @@ class StdString final {
   const char* data() const { return value_->data(); }
   size_t size() const { return value_->size(); }
 
+  // Copies `value` straight into the heap-allocated `std::string`, without a
+  // temporary `std::string` to move from.
   static inline StdString FromStringView(std::string_view value) {
-    return StdString(std::string(value));
+    return StdString(std::make_unique<std::string>(value));
   }
 
  private:
+  explicit StdString(std::unique_ptr<std::string> value)
+      : value_(std::move(value)) {}
+
   std::unique_ptr<std::string> value_;
 };
 
+// `StdString::data_and_len` in `cpp_std_string.rs` can read the fields of the
+// `std::string` directly (instead of calling `data()` and `size()` through
+// thunks) when built with `--cfg cc_std_string_layout="libcxx"` or
+// `--cfg cc_std_string_layout="libstdcxx"`. The build must only pass the cfg
+// that matches the C++ standard library in use: the cfg isn't visible here, so
+// the assertions below can only check that the size of `std::string` is the
+// one of the layout of the library this header is compiled with.
+static_assert(sizeof(StdString) == sizeof(void*));
+#if defined(_LIBCPP_VERSION) && !defined(_LIBCPP_ABI_ALTERNATE_STRING_LAYOUT)
+static_assert(sizeof(std::string) == 3 * sizeof(size_t));
+#elif defined(__GLIBCXX__) && _GLIBCXX_USE_CXX11_ABI
+static_assert(sizeof(std::string) == 4 * sizeof(size_t));
+#endif
+
 #endif  // THIRD_PARTY_CRUBIT_SUPPORT_CC_STD_CPP_STD_STRING_H_
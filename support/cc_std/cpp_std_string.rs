@@ -11,8 +11,54 @@ use std::string::String;
 use std::vec::Vec;
 
 impl StdString {
+    /// Returns the pointer to the bytes of the string and its length.
+    ///
+    /// When the layout of `std::string` is known at build time (see the
+    /// `cc_std_string_layout` cfg), the fields of the `std::string` are read
+    /// directly, so that no FFI calls are needed.  Otherwise this calls
+    /// `std::string::data()` and `std::string::size()` through thunks.
+    fn data_and_len(&self) -> (*const u8, usize) {
+        // SAFETY (for the direct field reads below): `StdString` holds a non-null
+        // `std::unique_ptr<std::string>` as its only field (`static_assert`ed in
+        // `cpp_std_string.h`). This assumes that the build only passes the
+        // `cc_std_string_layout` cfg that matches the C++ standard library that
+        // `cpp_std_string.h` is compiled with: nothing checks the cfg against
+        // the C++ side, and the `static_assert`s there only rule out string
+        // sizes that differ from the layout of that library.
+        #[cfg(all(cc_std_string_layout = "libcxx", target_endian = "little"))]
+        unsafe {
+            // The default (not "alternate") libc++ layout is a union of:
+            // - long strings: `{ is_long: 1 bit, capacity: 63 bits, size, data }`,
+            // - short strings: `{ is_long: 1 bit, size: 7 bits, inline data[23] }`.
+            let string = *(self as *const Self as *const *const u8);
+            let first_byte = *string;
+            if first_byte & 1 == 0 {
+                (string.add(1), (first_byte >> 1) as usize)
+            } else {
+                let words = string as *const usize;
+                (*words.add(2) as *const u8, *words.add(1))
+            }
+        }
+        #[cfg(cc_std_string_layout = "libstdcxx")]
+        unsafe {
+            // The libstdc++ layout (with `_GLIBCXX_USE_CXX11_ABI`) is
+            // `{ data, size, union { inline data[16], capacity } }` - `data` points
+            // at the inline buffer for short strings.
+            let words = *(self as *const Self as *const *const usize);
+            (*words as *const u8, *words.add(1))
+        }
+        #[cfg(not(any(
+            all(cc_std_string_layout = "libcxx", target_endian = "little"),
+            cc_std_string_layout = "libstdcxx"
+        )))]
+        unsafe {
+            // SAFETY: self is a valid reference.
+            (StdString::data(self) as *const u8, StdString::size(self))
+        }
+    }
+
     pub fn as_slice(&self) -> &[u8] {
-        let len = self.len();
+        let (data, len) = self.data_and_len();
         assert!(
             len <= isize::MAX as usize,
             "The string length does not fit in an `isize`: {}",
@@ -21,7 +67,7 @@ impl StdString {
         unsafe {
             // SAFETY:
             //
-            // * `StdString::data` returns the pointer of the C++ `std::string::data()`,
+            // * `data_and_len` returns the pointer of the C++ `std::string::data()`,
             //   which is guaranteed to be non-null and point to a continuous memory region.
             //   Every byte from `StdString` (i.e., [data, data + len)) is intialized.
             //   (See https://en.cppreference.com/w/cpp/string/basic_string/data)
@@ -31,12 +77,12 @@ impl StdString {
             // * `len` is guaranteed to be less than `isize::MAX` because C++
             //   implementations guarantee in practice that the object won't go past the end
             //   of the address space.
-            slice::from_raw_parts(StdString::data(self) as _, len)
+            slice::from_raw_parts(data, len)
         }
     }
 
     pub fn as_slice_mut(&mut self) -> &mut [u8] {
-        let len = self.len();
+        let (data, len) = self.data_and_len();
         assert!(
             len <= isize::MAX as usize,
             "The string length does not fit in an `isize`: {}",
@@ -45,22 +91,19 @@ impl StdString {
         unsafe {
             // SAFETY:
             //
-            // * `StdString::data` returns the pointer of the C++ `std::string::data()`,
+            // * `data_and_len` returns the pointer of the C++ `std::string::data()`,
             //   which is guaranteed to be non-null and point to a continuous memory region.
             //   And every byte from `StdString` (i.e., [data, data + len)) is intialized.
             //  (See https://en.cppreference.com/w/cpp/string/basic_string/data)
             // * `len` is guaranteed to be less than `isize::MAX` because C++
             //   implementations guarantee in practice that the object won't go past the end
             //   of the address space.
-            slice::from_raw_parts_mut(StdString::data(self) as _, len)
+            slice::from_raw_parts_mut(data as *mut u8, len)
         }
     }
 
     pub fn len(&self) -> usize {
-        unsafe {
-            // SAFETY: self is a valid reference.
-            StdString::size(self)
-        }
+        self.data_and_len().1
     }
 }
 
@@ -82,6 +125,15 @@ impl From<&String> for StdString {
     }
 }
 
+/// Copies the bytes of `s` (with a single allocation and a single copy, like
+/// the other conversions): a `std::string` can't take ownership of a buffer
+/// allocated by Rust.
+impl From<String> for StdString {
+    fn from(s: String) -> Self {
+        s.as_bytes().into()
+    }
+}
+
 impl From<&Vec<u8>> for StdString {
     fn from(s: &Vec<u8>) -> Self {
         s.as_slice().into()
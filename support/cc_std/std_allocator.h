@@ -8,6 +8,7 @@
 #include <stdio.h>
 
 #include <cstddef>
+#include <cstdlib>
 #include <new>
 
 namespace crubit_cc_std_internal::std_allocator {
@@ -26,10 +27,66 @@ inline void* cpp_new_with_alignment(size_t n, size_t align) {
   return operator new(n, static_cast<std::align_val_t>(align));
 }
 
-inline void cpp_delete(void* ptr, size_t n) { operator delete(ptr); }
+// `n` must be the size that was passed to `cpp_new` (or
+// `cpp_new_with_alignment`), which `StdAllocator` knows for the buffers it
+// allocates itself (e.g. those of `Vector`). It is passed on to sized
+// `operator delete` when it is available (`__cpp_sized_deallocation`, e.g.
+// `-fsized-deallocation`, which recent versions of Clang enable by default),
+// which lets allocators like tcmalloc skip looking up the size of the
+// allocation.
+//
+// There is no separate hook for a custom allocator backend: buffers allocated
+// here are also freed by C++ (e.g. by `std::vector`), and vice versa, so they
+// have to go through `operator new` and `operator delete`. Replacing those is
+// how allocators like tcmalloc plug in, and it applies here as well.
+inline void cpp_delete(void* ptr, size_t n) {
+#ifdef __cpp_sized_deallocation
+  operator delete(ptr, n);
+#else
+  operator delete(ptr);
+#endif
+}
 
 inline void cpp_delete_with_alignment(void* ptr, size_t n, size_t align) {
+#ifdef __cpp_sized_deallocation
+  operator delete(ptr, n, static_cast<std::align_val_t>(align));
+#else
   operator delete(ptr, static_cast<std::align_val_t>(align));
+#endif
+}
+
+// Like `cpp_delete` and `cpp_delete_with_alignment`, for when the size of the
+// allocation isn't known, e.g. because a `std::unique_ptr<Base>` may own a
+// `Derived` allocated by C++ `new`. Passing the wrong size to sized
+// `operator delete` is undefined behavior (and aborts under tcmalloc).
+inline void cpp_delete_unsized(void* ptr) { operator delete(ptr); }
+
+inline void cpp_delete_unsized_with_alignment(void* ptr, size_t align) {
+  operator delete(ptr, static_cast<std::align_val_t>(align));
+}
+
+// Resizes an allocation returned by `cpp_new` to `new_n` bytes, moving the
+// bytes to a new location if it can't be resized in place.
+//
+// This is only possible when `operator new` and `operator delete` are known to
+// be implemented on top of `malloc` and `free` (this is the case for the
+// default implementations in libc++ and libstdc++, and for tcmalloc and
+// jemalloc), which is opted into by defining
+// `CRUBIT_CC_STD_OPERATOR_NEW_IS_MALLOC`. `realloc` then lets the `malloc`
+// implementation grow the allocation in place, which avoids copying the
+// elements of large vectors.
+//
+// Returns `nullptr` if the allocation couldn't be resized (in which case `ptr`
+// is still valid), and the only thing the caller can do is to allocate new
+// memory with `cpp_new` and copy the bytes. If `new_n` is 0, returns `nullptr`
+// without touching `ptr`, because `realloc(ptr, 0)` may free `ptr`.
+inline void* cpp_try_realloc(void* ptr, size_t old_n, size_t new_n) {
+#ifdef CRUBIT_CC_STD_OPERATOR_NEW_IS_MALLOC
+  if (new_n == 0) return nullptr;
+  return realloc(ptr, new_n);
+#else
+  return nullptr;
+#endif
 }
 }  // namespace crubit_cc_std_internal::std_allocator
 
@@ -26,10 +26,59 @@ impl string_view {
     ///
     /// Behavior is undefined if the `string_view` has an invalid pointer.
     pub unsafe fn to_str(&self) -> Result<*const str, core::str::Utf8Error> {
-        let bytes: &[u8] = unsafe { &*self.as_raw_bytes() };
-        let res: *const str = core::str::from_utf8(bytes)?;
+        let res: *const str = unsafe { self.as_str()? };
         Ok(res)
     }
+
+    /// Borrows the bytes of the `string_view` without copying them.
+    ///
+    /// # Safety
+    ///
+    /// Behavior is undefined if the `string_view` has an invalid pointer, or if
+    /// the pointed-to bytes are mutated or freed during the lifetime `'a`.
+    #[inline(always)]
+    pub unsafe fn as_bytes<'a>(self) -> &'a [u8] {
+        unsafe { &*self.as_raw_bytes() }
+    }
+
+    /// Borrows the `string_view` as a `&str` without copying it, after
+    /// checking that it is valid UTF-8 (with `core::str::from_utf8`, which is
+    /// vectorized by the standard library).
+    ///
+    /// # Safety
+    ///
+    /// The same as for [`string_view::as_bytes`].
+    #[inline]
+    pub unsafe fn as_str<'a>(self) -> Result<&'a str, core::str::Utf8Error> {
+        core::str::from_utf8(unsafe { self.as_bytes() })
+    }
+
+    /// Iterates over the parts of the `string_view` separated by `separator`,
+    /// without copying or allocating (like `<[u8]>::split`).
+    ///
+    /// # Safety
+    ///
+    /// The same as for [`string_view::as_bytes`].
+    pub unsafe fn split<'a>(self, separator: u8) -> impl Iterator<Item = &'a [u8]> + 'a {
+        unsafe { self.as_bytes() }.split(move |&byte| byte == separator)
+    }
+
+    /// Iterates over the lines of the `string_view` (separated by `\n`, with a
+    /// trailing `\r` removed), without copying or allocating.
+    ///
+    /// # Safety
+    ///
+    /// The same as for [`string_view::as_bytes`].
+    pub unsafe fn lines<'a>(self) -> impl Iterator<Item = &'a [u8]> + 'a {
+        let bytes = unsafe { self.as_bytes() };
+        // Like `str::lines`, a trailing newline doesn't start a new (empty) line.
+        let bytes = bytes.strip_suffix(b"\n").unwrap_or(bytes);
+        let is_empty = bytes.is_empty();
+        bytes
+            .split(|&byte| byte == b'\n')
+            .map(|line| line.strip_suffix(b"\r").unwrap_or(line))
+            .filter(move |_| !is_empty)
+    }
 }
 
 /// Equivalent to `as_raw_bytes()`.
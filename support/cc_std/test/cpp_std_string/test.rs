@@ -19,6 +19,29 @@ fn test_ffi_round_trip_handle_non_utf8(#[case] input: &[u8]) {
     expect_eq!(s.as_slice(), s2.as_slice());
 }
 
+/// Tests strings around the small-string-optimization thresholds of libc++ (22
+/// bytes) and libstdc++ (15 bytes), which `StdString::data_and_len` handles
+/// differently when it reads the fields of the `std::string` directly.
+#[googletest::test]
+#[rstest]
+#[case(15)]
+#[case(16)]
+#[case(22)]
+#[case(23)]
+#[case(24)]
+#[case(1000)]
+fn test_len_and_as_slice_around_sso_threshold(#[case] len: usize) {
+    let input: Vec<u8> = (0..len).map(|i| i as u8).collect();
+    let mut s = StdString::from(&input);
+    expect_eq!(s.len(), len);
+    expect_eq!(s.as_slice(), &input[..]);
+
+    s.as_slice_mut()[len - 1] = 42;
+    let s2 = RoundTrip(s.clone());
+    expect_eq!(s2.as_slice()[len - 1], 42);
+    expect_eq!(s2.len(), len);
+}
+
 #[gtest]
 fn test_from_string() {
     let input: String = String::from("A string");
@@ -26,6 +49,12 @@ fn test_from_string() {
     assert_eq!(s.as_slice(), b"A string");
 }
 
+#[gtest]
+fn test_from_owned_string() {
+    let s = StdString::from(String::from("A string that is too long for the small string buffer"));
+    assert_eq!(s.as_slice(), b"A string that is too long for the small string buffer");
+}
+
 #[gtest]
 fn test_from_vec() {
     let input: Vec<u8> = vec![1, 2, 3, 4, 5];
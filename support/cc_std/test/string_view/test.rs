@@ -49,3 +49,29 @@ fn test_round_trip_cstr() {
 fn test_ffi() {
     assert_eq!(unsafe { to_str(GetHelloWorld()) }, "Hello, world!");
 }
+
+#[gtest]
+fn test_as_str() {
+    let original: &'static str = "this is a string";
+    let sv: std::string_view = original.into();
+    let s = unsafe { sv.as_str() }.unwrap();
+    assert_eq!(s, original);
+    assert_eq!(s.as_ptr(), original.as_ptr()); // The string is not copied.
+
+    let invalid: std::string_view = b"\xff"[..].into();
+    assert!(unsafe { invalid.as_str() }.is_err());
+}
+
+#[gtest]
+fn test_split_and_lines() {
+    let sv: std::string_view = "a,bc,,d".into();
+    let parts: Vec<&[u8]> = unsafe { sv.split(b',') }.collect();
+    assert_eq!(parts, [&b"a"[..], b"bc", b"", b"d"]);
+
+    let sv: std::string_view = "first\r\nsecond\n\nlast\n".into();
+    let lines: Vec<&[u8]> = unsafe { sv.lines() }.collect();
+    assert_eq!(lines, [&b"first"[..], b"second", b"", b"last"]);
+
+    let empty: std::string_view = "".into();
+    assert_eq!(unsafe { empty.lines() }.count(), 0);
+}
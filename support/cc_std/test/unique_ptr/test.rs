@@ -68,3 +68,50 @@ fn test_unique_ptr_get_returns_owned_pointer() {
     drop(up);
     assert_eq!(*counter.borrow(), 0);
 }
+
+#[gtest]
+fn test_unique_ptr_reset() {
+    let counter = Rc::new(RefCell::new(0i32));
+    let mut up = unsafe {
+        cc_std::std::unique_ptr::new(InstanceCounted::new_from_cpp_allocator(counter.clone()))
+    };
+    up.reset();
+    assert_eq!(*counter.borrow(), 0);
+    assert!(up.get().is_null());
+
+    // Resetting (or dropping) a null `unique_ptr` is a no-op.
+    up.reset();
+    drop(up);
+    assert_eq!(*counter.borrow(), 0);
+}
+
+#[gtest]
+fn test_unique_ptrs_in_vec_can_be_dropped() {
+    let counter = Rc::new(RefCell::new(0i32));
+    let ptrs: Vec<_> = (0..1000)
+        .map(|_| unsafe {
+            cc_std::std::unique_ptr::new(InstanceCounted::new_from_cpp_allocator(counter.clone()))
+        })
+        .collect();
+    assert_eq!(*counter.borrow(), 1000);
+    drop(ptrs);
+    assert_eq!(*counter.borrow(), 0);
+}
+
+#[gtest]
+fn test_unique_ptr_of_overaligned_type_can_be_dropped() {
+    #[repr(C, align(64))]
+    struct Overaligned {
+        value: i32,
+    }
+    let buffer = cc_std::crubit_cc_std_internal::std_allocator::cpp_new_with_alignment(
+        core::mem::size_of::<Overaligned>(),
+        core::mem::align_of::<Overaligned>(),
+    ) as *mut Overaligned;
+    unsafe {
+        buffer.write(Overaligned { value: 42 });
+    }
+    let up = unsafe { cc_std::std::unique_ptr::new(buffer) };
+    assert_eq!(unsafe { (*up.get()).value }, 42);
+    drop(up);
+}
@@ -139,6 +139,111 @@ fn test_vector_to_vec() {
     expect_eq!(v2, vec![4, 5, 6]);
 }
 
+#[gtest]
+fn test_vector_raw_parts_round_trip() {
+    let mut v = vector::Vector::<i32>::with_capacity(10);
+    v.extend([1, 2, 3]);
+    let data = v.as_ptr();
+    let (begin, len, capacity) = v.into_raw_parts();
+    expect_eq!(begin as *const i32, data);
+    expect_eq!(len, 3);
+    expect_that!(capacity, ge(10));
+
+    let mut v = unsafe { vector::Vector::from_raw_parts(begin, len, capacity) };
+    expect_eq!(v, [1, 2, 3]);
+    expect_eq!(v.as_ptr(), data);
+    // The adopted buffer can still grow.
+    v.extend(4..100);
+    expect_eq!(v.len(), 99);
+}
+
+#[gtest]
+fn test_empty_vector_raw_parts_round_trip() {
+    let (begin, len, capacity) = vector::Vector::<i32>::new().into_raw_parts();
+    expect_eq!(begin, std::ptr::null_mut());
+    let v = unsafe { vector::Vector::from_raw_parts(begin, len, capacity) };
+    expect_eq!(v.is_empty(), true);
+    expect_eq!(v.capacity(), 0);
+}
+
+#[gtest]
+fn test_vector_into_vec_in_cpp_allocator_does_not_copy() {
+    let v = vector::Vector::from(vec![4, 5, 6]);
+    let data = v.as_ptr();
+    let u = v.into_vec_in_cpp_allocator();
+    expect_eq!(u, [4, 5, 6]);
+    expect_eq!(u.as_ptr(), data);
+
+    let v = vector::Vector::from(u);
+    expect_eq!(v, [4, 5, 6]);
+    expect_eq!(v.as_ptr(), data);
+}
+
+/// A type that is not `Unpin`, like most C++ classes.
+struct NotUnpin {
+    value: i32,
+    _pinned: std::marker::PhantomPinned,
+}
+
+impl NotUnpin {
+    fn set_value(self: std::pin::Pin<&mut Self>, value: i32) {
+        unsafe { self.get_unchecked_mut().value = value }
+    }
+}
+
+fn make_not_unpin_vector(len: usize) -> vector::Vector<NotUnpin> {
+    // A `Vector<NotUnpin>` can't grow (that would move its elements), so take over the
+    // buffer of a `Vector<i32>`, which has the same layout.
+    let (begin, _, capacity) = vector::Vector::<i32>::with_capacity(len).into_raw_parts();
+    let begin = begin as *mut NotUnpin;
+    unsafe {
+        for i in 0..len {
+            begin.add(i).write(NotUnpin { value: i as i32, _pinned: std::marker::PhantomPinned });
+        }
+        vector::Vector::from_raw_parts(begin, len, capacity)
+    }
+}
+
+#[gtest]
+fn test_vector_get_pin_mut() {
+    let mut v = make_not_unpin_vector(3);
+    v.get_pin_mut(1).unwrap().set_value(10);
+    expect_eq!(v[1].value, 10);
+    expect_eq!(v.get_pin_mut(3).is_none(), true);
+}
+
+#[gtest]
+fn test_vector_iter_pin_mut() {
+    let mut v = make_not_unpin_vector(3);
+    expect_eq!(v.iter_pin_mut().len(), 3);
+    for element in v.iter_pin_mut() {
+        let value = element.value;
+        element.set_value(value * 2);
+    }
+    expect_eq!(v.iter().map(|element| element.value).collect::<Vec<_>>(), vec![0, 2, 4]);
+    expect_eq!(vector::Vector::<NotUnpin>::new().iter_pin_mut().next().is_none(), true);
+}
+
+#[gtest]
+fn test_vector_filled_in_parallel() {
+    const LEN: usize = 10000;
+    let mut v = vector::Vector::<usize>::new();
+    v.try_reserve(LEN).unwrap();
+    std::thread::scope(|scope| {
+        for (chunk_index, chunk) in v.spare_capacity_mut()[..LEN].chunks_mut(1000).enumerate() {
+            scope.spawn(move || {
+                for (i, element) in chunk.iter_mut().enumerate() {
+                    element.write(chunk_index * 1000 + i);
+                }
+            });
+        }
+    });
+    unsafe {
+        v.set_len(LEN);
+    }
+    expect_eq!(v.iter().copied().eq(0..LEN), true);
+}
+
 #[gtest]
 #[should_panic]
 fn test_vector_mut_index_out_of_bounds() {
@@ -611,6 +716,53 @@ fn test_as_mut_slice() {
     expect_eq!(v[1], 1);
 }
 
+#[gtest]
+fn test_vector_extend_from_slice() {
+    let mut v = vector::Vector::<f32>::new();
+    v.extend_from_slice(&[]);
+    expect_eq!(v.len(), 0);
+    v.extend_from_slice(&[1.0, 2.0]);
+    v.extend_from_slice(&[3.0]);
+    expect_eq!(v, [1.0, 2.0, 3.0]);
+}
+
+#[gtest]
+fn test_vector_extend_from_refs() {
+    let mut v = vector::Vector::<i32>::new();
+    v.extend([1, 2, 3].iter());
+    expect_eq!(v, [1, 2, 3]);
+}
+
+#[gtest]
+fn test_vector_resize_zeroed() {
+    let mut v = vector::Vector::<u64>::new();
+    v.push(7);
+    unsafe {
+        v.resize_zeroed(4);
+    }
+    expect_eq!(v, [7, 0, 0, 0]);
+    unsafe {
+        v.resize_zeroed(2);
+    }
+    expect_eq!(v, [7, 0]);
+}
+
+#[gtest]
+fn test_vector_spare_capacity_mut() {
+    let mut v = vector::Vector::<i32>::new();
+    expect_eq!(v.spare_capacity_mut().len(), 0);
+    v.reserve(10);
+    v.push(1);
+    let spare = v.spare_capacity_mut();
+    expect_that!(spare.len(), ge(9));
+    spare[0].write(2);
+    spare[1].write(3);
+    unsafe {
+        v.set_len(3);
+    }
+    expect_eq!(v, [1, 2, 3]);
+}
+
 mod layout_tests {
     use crate::to_void_ptr;
     use googletest::prelude::*;
@@ -732,6 +884,26 @@ mod allocation_tests {
             v.push(i);
         }
     }
+
+    /// Tests that growing and shrinking the allocation (which may resize it in
+    /// place - see `StdAllocator::resize`) preserves the elements.
+    #[gtest]
+    fn test_grow_and_shrink_preserve_elements() {
+        let mut v = vector::Vector::<i32>::new();
+        for i in 0..1000000 {
+            v.push(i);
+        }
+        v.truncate(10);
+        v.shrink_to_fit();
+        expect_eq!(v.capacity(), 10);
+        v.reserve_exact(100000);
+        expect_eq!(v, [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
+        unsafe {
+            expect_eq!(cc_helper_functions::crubit_test::vector_int32_sum(to_void_ptr(&v)), 45);
+            cc_helper_functions::crubit_test::vector_int32_push_back(to_void_ptr(&v), 10);
+        }
+        expect_eq!(v.len(), 11);
+    }
 }
 
 mod alignment_tests {
@@ -2,8 +2,8 @@
 // Exceptions. See /LICENSE for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-use crate::crubit_cc_std_internal::std_allocator;
-use core::ptr::null_mut;
+use crate::crubit_cc_std_internal::std_allocator::StdAllocator;
+use core::ptr::{null_mut, NonNull};
 
 /// A smart pointer that owns and manages another object of type `T` via a
 /// pointer, ABI-compatible with `std::unique_ptr` using default deleter from
@@ -35,17 +35,26 @@ impl<T> unique_ptr<T> {
     pub fn release(&mut self) -> *mut T {
         core::mem::replace(&mut self.ptr, null_mut())
     }
-}
 
-impl<T> Drop for unique_ptr<T> {
-    fn drop(&mut self) {
-        if !self.ptr.is_null() {
+    /// Destroys the owned object, if any, leaving `self` null.
+    pub fn reset(&mut self) {
+        let ptr = self.release();
+        if let Some(ptr) = NonNull::new(ptr) {
             unsafe {
                 // SAFETY: a non-null `self.ptr` is a pointer to a `T` allocated with C++ `new`,
                 // which should be satisfied by the constructor.
-                core::ptr::drop_in_place(self.ptr);
-                std_allocator::cpp_delete(self.ptr as _, core::mem::size_of::<T>());
+                core::ptr::drop_in_place(ptr.as_ptr());
+                // Like C++ `delete`, this uses the aligned `operator delete` for over-aligned
+                // types. The size isn't passed on, as the object may be larger than a `T`
+                // (e.g. a derived class).
+                StdAllocator {}.deallocate_unsized(ptr.cast(), core::mem::align_of::<T>());
             }
         }
     }
 }
+
+impl<T> Drop for unique_ptr<T> {
+    fn drop(&mut self) {
+        self.reset();
+    }
+}
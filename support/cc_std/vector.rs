@@ -10,6 +10,7 @@ use std::mem::ManuallyDrop;
 use std::ops::RangeBounds;
 use std::ops::{Deref, DerefMut};
 use std::ops::{Index, IndexMut};
+use std::pin::Pin;
 use std::slice;
 
 use cc_std::crubit_cc_std_internal::std_allocator as cpp_std_allocator;
@@ -244,6 +245,78 @@ impl<T> Vector<T> {
     }
 }
 
+impl<T> Vector<T> {
+    // Methods transferring the ownership of the buffer.
+
+    /// Decomposes `self` into its raw components: a pointer to the buffer (or
+    /// null, if no buffer was allocated), the length and the capacity. The
+    /// elements are neither moved nor dropped.
+    ///
+    /// The buffer was allocated with C++'s `std::allocator<T>`, and the caller
+    /// becomes responsible for freeing it, e.g. by passing the components back
+    /// to [`Vector::from_raw_parts`]. If `T` is not `Unpin`, the elements are
+    /// still pinned, and must not be moved.
+    pub fn into_raw_parts(self) -> (*mut T, usize, usize) {
+        let this = ManuallyDrop::new(self);
+        if !this.begin.is_null() {
+            // Like the tail of a `Vec`, the tail of the released buffer may be
+            // written to.
+            this.asan_unpoison_tail();
+        }
+        (this.begin, this.len(), this.capacity())
+    }
+
+    /// Creates a `Vector` that takes over the ownership of a buffer, without
+    /// moving or copying its elements.
+    ///
+    /// # Safety
+    ///
+    /// - Either `begin` is null and `len` and `capacity` are 0, or `begin` points
+    ///   to a buffer for `capacity` elements that was allocated with C++'s
+    ///   `std::allocator<T>` (e.g. by [`Vector::into_raw_parts`] or by a
+    ///   `Vec<T, StdAllocator>`), and is owned by the caller.
+    /// - `len` must be less than or equal to `capacity`, and the first `len`
+    ///   elements must be initialized.
+    pub unsafe fn from_raw_parts(begin: *mut T, len: usize, capacity: usize) -> Vector<T> {
+        let mut result = Vector::new();
+        if !begin.is_null() {
+            result.set_begin_len_capacity(begin, len, capacity);
+            result.asan_poison_tail();
+        }
+        result
+    }
+}
+
+// Methods for mutating elements in place, which also work for types that are not
+// `Unpin` (e.g. most C++ classes).
+//
+// `Vector` only moves its elements (e.g. when growing the buffer) in methods that
+// require `T: Unpin`, so the elements of a `Vector<T>` stay at the same address for
+// as long as they are in the vector, which makes them pinned.
+impl<T> Vector<T> {
+    /// Returns a pinned mutable reference to the element at `index`, or `None`
+    /// if `index` is out of bounds.
+    pub fn get_pin_mut(&mut self, index: usize) -> Option<Pin<&mut T>> {
+        self.elements_mut().get_mut(index).map(|element| unsafe { Pin::new_unchecked(element) })
+    }
+
+    /// Returns an iterator over pinned mutable references to the elements.
+    pub fn iter_pin_mut(
+        &mut self,
+    ) -> impl DoubleEndedIterator<Item = Pin<&mut T>> + ExactSizeIterator {
+        self.elements_mut().iter_mut().map(|element| unsafe { Pin::new_unchecked(element) })
+    }
+
+    /// Returns the elements as a slice. The caller must not move them.
+    fn elements_mut(&mut self) -> &mut [T] {
+        if self.is_empty() {
+            &mut []
+        } else {
+            unsafe { std::slice::from_raw_parts_mut(self.begin, self.len()) }
+        }
+    }
+}
+
 impl<T: Unpin> Vector<T> {
     /// Mutates `self` as if it were a `Vec<T>`.
     fn mutate_self_as_vec<F, R>(&mut self, mutate_self: F) -> R
@@ -360,6 +433,13 @@ impl<T: Unpin> Vector<T> {
         result
     }
 
+    /// Converts `self` into a `Vec` that uses the C++ allocator, without moving
+    /// or copying the elements.
+    pub fn into_vec_in_cpp_allocator(self) -> Vec<T, cpp_std_allocator::StdAllocator> {
+        let (begin, len, capacity) = self.into_raw_parts();
+        create_vec_from_raw_parts(begin, len, capacity)
+    }
+
     pub fn as_ptr(&self) -> *const T {
         self.begin
     }
@@ -397,6 +477,73 @@ impl<T: Unpin + Clone> Vector<T> {
     }
 }
 
+impl<T: Unpin + Copy> Vector<T> {
+    /// Appends all the elements of `other` with a single `memcpy` (after
+    /// reserving the capacity for them).
+    pub fn extend_from_slice(&mut self, other: &[T]) {
+        if other.is_empty() {
+            return;
+        }
+        self.reserve(other.len());
+        unsafe {
+            self.asan_unpoison_tail();
+            std::ptr::copy_nonoverlapping(other.as_ptr(), self.end(), other.len());
+            self.set_len(self.len() + other.len());
+        }
+    }
+
+    /// Resizes the vector to `new_len` elements, filling the new elements with
+    /// zero bytes (using a single `memset`).
+    ///
+    /// # Safety
+    ///
+    /// The all-zero byte pattern must be a valid value of `T` (see
+    /// [`std::mem::zeroed`]).
+    pub unsafe fn resize_zeroed(&mut self, new_len: usize) {
+        let len = self.len();
+        if new_len <= len {
+            self.truncate(new_len);
+            return;
+        }
+        self.reserve(new_len - len);
+        unsafe {
+            self.asan_unpoison_tail();
+            std::ptr::write_bytes(self.end(), 0, new_len - len);
+            self.set_len(new_len);
+        }
+    }
+}
+
+impl<T: Unpin> Vector<T> {
+    /// Returns the remaining spare capacity of the vector as a slice of
+    /// `MaybeUninit<T>`.
+    ///
+    /// The returned slice can be used to fill the vector with data (e.g. by
+    /// reading from a file) before marking the data as initialized using
+    /// [`Vector::set_len`].  This calls [`Vector::prepare_to_write_into_tail`],
+    /// so the tail can be written to until the next call to `set_len`.
+    ///
+    /// This is also the way to fill a vector in parallel without collecting
+    /// the elements into a `Vec` first: reserve the capacity, split the spare
+    /// capacity into chunks (e.g. with `chunks_mut`), initialize each chunk in
+    /// its own worker (e.g. with `std::thread::scope`, or rayon's
+    /// `par_chunks_mut`), and then call `set_len`.
+    ///
+    /// See [`std::vec::Vec::spare_capacity_mut`] for more details.
+    pub fn spare_capacity_mut(&mut self) -> &mut [std::mem::MaybeUninit<T>] {
+        if self.begin.is_null() {
+            return &mut [];
+        }
+        self.prepare_to_write_into_tail();
+        unsafe {
+            std::slice::from_raw_parts_mut(
+                self.end() as *mut std::mem::MaybeUninit<T>,
+                self.capacity() - self.len(),
+            )
+        }
+    }
+}
+
 impl<T: Unpin + PartialEq> Vector<T> {
     pub fn dedup(&mut self) {
         self.mutate_self_as_vec(|v| v.dedup());
@@ -451,11 +598,7 @@ impl<T> Deref for Vector<T> {
 
 impl<T: Unpin> DerefMut for Vector<T> {
     fn deref_mut(&mut self) -> &mut Self::Target {
-        if self.is_empty() {
-            &mut []
-        } else {
-            unsafe { std::slice::from_raw_parts_mut(self.begin, self.len()) }
-        }
+        self.elements_mut()
     }
 }
 
@@ -473,6 +616,17 @@ impl<T: Unpin> From<Vec<T>> for Vector<T> {
     }
 }
 
+impl<T: Unpin> From<Vec<T, cpp_std_allocator::StdAllocator>> for Vector<T> {
+    /// Takes over the buffer of `v`, which uses the same allocator as `Vector`.
+    fn from(v: Vec<T, cpp_std_allocator::StdAllocator>) -> Self {
+        if v.capacity() == 0 {
+            return Vector::new();
+        }
+        let mut v = ManuallyDrop::new(v);
+        unsafe { Vector::from_raw_parts(v.as_mut_ptr(), v.len(), v.capacity()) }
+    }
+}
+
 impl<T: Clone> Vector<T> {
     /// Clone elements from `self` to `Vec<T>`.
     pub fn to_vec(&self) -> Vec<T> {
@@ -493,6 +647,15 @@ impl<T: Unpin> Extend<T> for Vector<T> {
     }
 }
 
+impl<'a, T: Unpin + Copy + 'a> Extend<&'a T> for Vector<T> {
+    fn extend<I>(&mut self, iter: I)
+    where
+        I: IntoIterator<Item = &'a T>,
+    {
+        self.mutate_self_as_vec(|v| v.extend(iter));
+    }
+}
+
 /// Helper method for creating a `Vec<T>` from raw parts.
 fn create_vec_from_raw_parts<T>(
     begin: *mut T,
@@ -8,11 +8,13 @@ use std::collections::HashMap;
 use std::env;
 use std::fs::File;
 use std::io::BufReader;
+use std::sync::{Arc, Mutex};
+use std::time::SystemTime;
 
 pub fn to_private_struct_path(input: TokenStream) -> Result<TokenStream, syn::Error> {
     validate_user_input(&input)?;
     let instantiations = read_instantiations_map()?;
-    get_instantiation_struct_name(input, instantiations)
+    get_instantiation_struct_name(input, &instantiations)
 }
 
 fn validate_user_input(_input: &TokenStream) -> Result<(), syn::Error> {
@@ -21,21 +23,54 @@ fn validate_user_input(_input: &TokenStream) -> Result<(), syn::Error> {
     Ok(())
 }
 
-fn read_instantiations_map() -> Result<HashMap<String, String>, syn::Error> {
+/// The parsed contents of `CRUBIT_INSTANTIATIONS_FILE`, together with what
+/// identifies the version of the file that they were parsed from.
+struct CachedInstantiations {
+    path: String,
+    modified: Option<SystemTime>,
+    len: u64,
+    instantiations: Arc<HashMap<String, String>>,
+}
+
+/// The proc macro is loaded once per compilation, so caching the map here
+/// avoids re-parsing the (possibly large) file for every `cc_template!`
+/// invocation.
+static INSTANTIATIONS_CACHE: Mutex<Option<CachedInstantiations>> = Mutex::new(None);
+
+fn read_instantiations_map() -> Result<Arc<HashMap<String, String>>, syn::Error> {
     let path = env::var("CRUBIT_INSTANTIATIONS_FILE").map_err(|err| {
         make_syn_error(format!("Couldn't read 'CRUBIT_INSTANTIATIONS_FILE': {}.", err))
     })?;
     let file = File::open(&path).map_err(|err| {
         make_syn_error(format!("Couldn't read C++ instantiations from '{}': {}", path, err))
     })?;
+    let metadata = file.metadata().ok();
+    let modified = metadata.as_ref().and_then(|metadata| metadata.modified().ok());
+    let len = metadata.as_ref().map_or(0, |metadata| metadata.len());
+
+    let mut cache = INSTANTIATIONS_CACHE.lock().unwrap_or_else(|err| err.into_inner());
+    if let Some(cached) = cache.as_ref() {
+        if cached.path == path
+            && cached.modified.is_some()
+            && cached.modified == modified
+            && cached.len == len
+        {
+            return Ok(cached.instantiations.clone());
+        }
+    }
     let reader = BufReader::new(file);
-    serde_json::from_reader(reader)
-        .map_err(|err| make_syn_error(format!("Couldn't deserialize JSON from {}: {}", path, err)))
+    let instantiations: Arc<HashMap<String, String>> =
+        Arc::new(serde_json::from_reader(reader).map_err(|err| {
+            make_syn_error(format!("Couldn't deserialize JSON from {}: {}", path, err))
+        })?);
+    *cache =
+        Some(CachedInstantiations { path, modified, len, instantiations: instantiations.clone() });
+    Ok(instantiations)
 }
 
 fn get_instantiation_struct_name(
     input: TokenStream,
-    instantiations: HashMap<String, String>,
+    instantiations: &HashMap<String, String>,
 ) -> Result<TokenStream, syn::Error> {
     // In theory `TokenStream` -> `instantiation_name` translation could go through
     // `token_stream_printer::tokens_to_string`.  This route is not used because:
@@ -134,14 +169,28 @@ mod tests {
         let deserialized_map =
             read_instantiations_map().expect("Expected successful deserialization.");
 
-        assert_eq!(deserialized_map, hashmap! { key.to_string() => value.to_string() });
+        assert_eq!(*deserialized_map, hashmap! { key.to_string() => value.to_string() });
+    }
+
+    #[gtest]
+    fn test_instantiations_map_is_reread_after_change() {
+        let path = Path::join(Path::new(&env::var("TEST_TMPDIR").unwrap()), "changing.json");
+        std::fs::write(&path, r#"{"a<int>": "__a_int"}"#).unwrap();
+        env::set_var("CRUBIT_INSTANTIATIONS_FILE", &path);
+        let first = read_instantiations_map().unwrap();
+        let second = read_instantiations_map().unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+
+        std::fs::write(&path, r#"{"a<int>": "__a_int", "b<int>": "__b_int"}"#).unwrap();
+        let third = read_instantiations_map().unwrap();
+        assert_eq!(third.get("b<int>").map(String::as_str), Some("__b_int"));
     }
 
     #[gtest]
     fn test_successful_expansion() {
         let expanded = get_instantiation_struct_name(
             quote! { std::vector<bool> },
-            hashmap! {
+            &hashmap! {
                 quote!{ std::vector<bool> }.to_string().replace(' ', "") => "__std_vector__bool__".to_string(),
             },
         )
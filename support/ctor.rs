@@ -105,10 +105,13 @@
 extern crate alloc;
 
 use alloc::boxed::Box;
+use alloc::vec::Vec;
+use core::cell::{Cell, UnsafeCell};
 use core::marker::{PhantomData, Unpin};
 use core::mem::{ManuallyDrop, MaybeUninit};
 use core::ops::{Deref, DerefMut};
 use core::pin::Pin;
+use core::ptr::NonNull;
 
 pub use ctor_proc_macros::*;
 
@@ -467,6 +470,95 @@ impl<C: Ctor, F: FnOnce(Pin<&mut C::Output>)> Ctor for CtorThen<C, F> {
 
 impl<C: Ctor, F: FnOnce(Pin<&mut C::Output>)> !Unpin for CtorThen<C, F> {}
 
+// =====================================
+// array_from_fn() / box_slice_from_fn()
+// =====================================
+
+/// Returns a `Ctor` for an array, which constructs each element `i` in place,
+/// in order, using the `Ctor` returned by `f(i)`.
+///
+/// If constructing an element panics, the elements that were already
+/// constructed are dropped, in the reverse order of their construction.
+///
+/// For example:
+///
+/// ```
+/// // Any `Unpin` value is a `Ctor` for itself.
+/// emplace! { let squares = ctor::array_from_fn::<_, _, 4>(|i| i * i); }
+/// assert_eq!(*squares, [0, 1, 4, 9]);
+/// ```
+pub fn array_from_fn<C: Ctor, F: FnMut(usize) -> C, const N: usize>(f: F) -> ArrayFromFn<F, N> {
+    ArrayFromFn(f)
+}
+
+/// A `Ctor` for an array, which constructs each element using a `Ctor` returned
+/// by a function.
+///
+/// This struct is created by `array_from_fn`. See its documentation for more.
+#[must_use = must_use_ctor!()]
+pub struct ArrayFromFn<F, const N: usize>(F);
+
+impl<C: Ctor, F: FnMut(usize) -> C, const N: usize> Ctor for ArrayFromFn<F, N> {
+    type Output = [C::Output; N];
+    unsafe fn ctor(self, dest: Pin<&mut MaybeUninit<Self::Output>>) {
+        // Safety: `[MaybeUninit<T>; N]` has the same layout as `MaybeUninit<[T; N]>`, and the
+        // elements are structurally pinned within the pinned array.
+        let elements =
+            Pin::into_inner_unchecked(dest).as_mut_ptr().cast::<MaybeUninit<C::Output>>();
+        ctor_elements(elements, N, self.0);
+    }
+}
+
+impl<F, const N: usize> !Unpin for ArrayFromFn<F, N> {}
+
+/// Constructs a boxed slice of `len` elements, constructing each element `i` in
+/// place, in order, using the `Ctor` returned by `f(i)`.
+///
+/// Unlike collecting into a `Vec`, this works for types that can only be
+/// constructed in place (e.g. C++ classes that aren't trivially relocatable). If
+/// constructing an element panics, the elements that were already constructed
+/// are dropped, in the reverse order of their construction.
+pub fn box_slice_from_fn<C: Ctor, F: FnMut(usize) -> C>(len: usize, f: F) -> Pin<Box<[C::Output]>> {
+    let mut uninit = Box::<[C::Output]>::new_uninit_slice(len);
+    unsafe {
+        ctor_elements(uninit.as_mut_ptr(), len, f);
+        Pin::new_unchecked(uninit.assume_init())
+    }
+}
+
+/// Constructs `len` elements starting at `elements`, using the `Ctor` returned by
+/// `f(i)` for the element `i`. If this panics, the constructed elements are
+/// dropped again.
+///
+/// Safety: `elements` must point to `len` uninitialized elements, which satisfy
+/// the Pin guarantee.
+unsafe fn ctor_elements<C: Ctor, F: FnMut(usize) -> C>(
+    elements: *mut MaybeUninit<C::Output>,
+    len: usize,
+    mut f: F,
+) {
+    /// Drops the first `len` elements, in reverse order, unless forgotten.
+    struct ConstructedElementsGuard<T> {
+        elements: *mut MaybeUninit<T>,
+        len: usize,
+    }
+    impl<T> Drop for ConstructedElementsGuard<T> {
+        fn drop(&mut self) {
+            for i in (0..self.len).rev() {
+                // SAFETY: the first `len` elements were initialized by `ctor_elements`.
+                unsafe { (*self.elements.add(i)).assume_init_drop() };
+            }
+        }
+    }
+
+    let mut guard = ConstructedElementsGuard { elements, len: 0 };
+    for i in 0..len {
+        f(i).ctor(Pin::new_unchecked(&mut *elements.add(i)));
+        guard.len += 1;
+    }
+    core::mem::forget(guard);
+}
+
 // ========
 // emplace!
 // ========
@@ -661,6 +753,170 @@ impl<T> Slot<T> {
     }
 }
 
+/// An arena which owns many objects constructed in place by a `Ctor`, and
+/// destroys them all together when the arena itself is dropped.
+///
+/// Objects are constructed directly in chunks of memory that are never moved
+/// or freed while the arena is alive, so every object stays pinned at its
+/// address. This is a cheaper alternative to one `Box::emplace` per object
+/// when many non-movable objects (e.g. C++ objects) share the same lifetime:
+/// there is one heap allocation per chunk rather than per object, and
+/// chunks grow geometrically.
+///
+/// (`CtorArena` can't implement `Emplace`, as `Emplace::emplace` returns an
+/// owning pointer and has no receiver for the arena.)
+///
+/// ```
+/// let arena = CtorArena::new();
+/// let x: Pin<&mut u32> = arena.emplace(copy(&1));
+/// let y: Pin<&mut u32> = arena.emplace(copy(&*x));
+/// assert_eq!(*y, 1);
+/// ```
+pub struct CtorArena<T> {
+    /// The chunks backing the arena. Only the last chunk may have room left:
+    /// the first `last_chunk_len` elements of the last chunk, and all elements
+    /// of the other chunks, are initialized.
+    ///
+    /// The chunks are kept as raw pointers rather than `Box`es, so that
+    /// reaching a new slot never reborrows the whole chunk, which would
+    /// invalidate the references to the objects that were handed out before.
+    chunks: UnsafeCell<Vec<ArenaChunk<T>>>,
+    last_chunk_len: Cell<usize>,
+    /// Whether a `Ctor` is running, i.e. whether `emplace` was called
+    /// reentrantly.
+    is_constructing: Cell<bool>,
+    /// The arena owns its objects.
+    _owns: PhantomData<T>,
+}
+
+/// A chunk of a `CtorArena`: a `Box<[MaybeUninit<T>]>` that was turned into a
+/// raw pointer by `Box::into_raw`, and is freed by the arena's `Drop`.
+struct ArenaChunk<T> {
+    ptr: NonNull<MaybeUninit<T>>,
+    capacity: usize,
+}
+
+impl<T> ArenaChunk<T> {
+    fn new(capacity: usize) -> Self {
+        let raw: *mut [MaybeUninit<T>] = Box::into_raw(Box::new_uninit_slice(capacity));
+        // SAFETY: `Box::into_raw` never returns null.
+        let ptr = unsafe { NonNull::new_unchecked(raw as *mut MaybeUninit<T>) };
+        ArenaChunk { ptr, capacity }
+    }
+
+    /// Returns a pointer to the slot at `index`, without creating a reference
+    /// to any other slot.
+    ///
+    /// Safety: `index < self.capacity`.
+    unsafe fn slot(&self, index: usize) -> *mut MaybeUninit<T> {
+        self.ptr.as_ptr().add(index)
+    }
+}
+
+impl<T> CtorArena<T> {
+    /// The number of elements in the first chunk.
+    const MIN_CHUNK_CAPACITY: usize = 8;
+
+    pub fn new() -> Self {
+        CtorArena {
+            chunks: UnsafeCell::new(Vec::new()),
+            last_chunk_len: Cell::new(0),
+            is_constructing: Cell::new(false),
+            _owns: PhantomData,
+        }
+    }
+
+    /// Constructs an object in the arena, and returns a reference to it which
+    /// lives as long as the arena.
+    ///
+    /// If `ctor` panics, no object is added to the arena.
+    ///
+    /// Panics if `ctor` itself calls `emplace` on the same arena.
+    pub fn emplace<C: Ctor<Output = T>>(&self, ctor: C) -> Pin<&mut T> {
+        assert!(!self.is_constructing.get(), "CtorArena::emplace called from within a Ctor");
+        let len = self.last_chunk_len.get();
+        // SAFETY: `chunks` is only accessed here and in `len`/`drop`, none of which can run
+        // while this reference is alive.
+        let chunks = unsafe { &mut *self.chunks.get() };
+        let chunk = match chunks.last() {
+            Some(chunk) if len < chunk.capacity => chunk,
+            last => {
+                let capacity = last.map_or(Self::MIN_CHUNK_CAPACITY, |chunk| chunk.capacity * 2);
+                chunks.push(ArenaChunk::new(capacity));
+                self.last_chunk_len.set(0);
+                chunks.last().unwrap()
+            }
+        };
+        // SAFETY: `last_chunk_len < chunk.capacity`, checked above.
+        let slot: *mut MaybeUninit<T> = unsafe { chunk.slot(self.last_chunk_len.get()) };
+
+        /// Clears `is_constructing` even if the `Ctor` panics.
+        struct ConstructingGuard<'a>(&'a Cell<bool>);
+        impl Drop for ConstructingGuard<'_> {
+            fn drop(&mut self) {
+                self.0.set(false);
+            }
+        }
+        self.is_constructing.set(true);
+        let guard = ConstructingGuard(&self.is_constructing);
+        // SAFETY: `slot` is uninitialized, and is never moved or reused until the arena is
+        // dropped, at which point the object is dropped in place.
+        unsafe {
+            ctor.ctor(Pin::new_unchecked(&mut *slot));
+        }
+        drop(guard);
+        self.last_chunk_len.set(self.last_chunk_len.get() + 1);
+        // SAFETY: the object was initialized above, and each slot is handed out at most once.
+        unsafe { Pin::new_unchecked((*slot).assume_init_mut()) }
+    }
+
+    /// Returns the number of objects in the arena.
+    pub fn len(&self) -> usize {
+        // SAFETY: see `emplace`.
+        let chunks = unsafe { &*self.chunks.get() };
+        match chunks.split_last() {
+            None => 0,
+            Some((_, full_chunks)) => {
+                full_chunks.iter().map(|chunk| chunk.capacity).sum::<usize>()
+                    + self.last_chunk_len.get()
+            }
+        }
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+impl<T> Default for CtorArena<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<T> Drop for CtorArena<T> {
+    /// Drops the objects in the reverse order of their construction, like C++ does for objects
+    /// with automatic storage duration, and then frees the chunks.
+    fn drop(&mut self) {
+        let last_chunk_len = self.last_chunk_len.get();
+        let chunks = self.chunks.get_mut();
+        let num_chunks = chunks.len();
+        for (i, chunk) in chunks.iter().enumerate().rev() {
+            if core::mem::needs_drop::<T>() {
+                let len = if i + 1 == num_chunks { last_chunk_len } else { chunk.capacity };
+                for index in (0..len).rev() {
+                    // SAFETY: see the invariant on `chunks`.
+                    unsafe { (*chunk.slot(index)).assume_init_drop() };
+                }
+            }
+            // SAFETY: `chunk` was created by `ArenaChunk::new` from a `Box` of this length, and
+            // is freed only once. Dropping the `Box` doesn't drop the `MaybeUninit` elements.
+            let raw = core::ptr::slice_from_raw_parts_mut(chunk.ptr.as_ptr(), chunk.capacity);
+            drop(unsafe { Box::from_raw(raw) });
+        }
+    }
+}
+
 #[doc(hidden)]
 pub mod macro_internal {
     use super::*;
@@ -1728,4 +1984,130 @@ mod test {
         }
         assert_eq!(*sum, 42);
     }
+
+    #[gtest]
+    fn test_ctor_arena_emplace() {
+        let arena = CtorArena::new();
+        assert!(arena.is_empty());
+        let x = arena.emplace(copy(&1_u32));
+        let y = arena.emplace(copy(&*x));
+        assert_eq!(*x, 1);
+        assert_eq!(*y, 1);
+        assert_eq!(arena.len(), 2);
+    }
+
+    /// Tests that objects keep their address while the arena grows.
+    #[gtest]
+    fn test_ctor_arena_addresses_are_stable() {
+        let arena = CtorArena::new();
+        let objects: Vec<Pin<&mut usize>> = (0..1000).map(|i| arena.emplace(copy(&i))).collect();
+        assert_eq!(arena.len(), 1000);
+        for (i, object) in objects.iter().enumerate() {
+            assert_eq!(**object, i);
+        }
+    }
+
+    /// Tests that the arena drops its objects in the reverse order of their construction.
+    #[gtest]
+    fn test_ctor_arena_drop_order() {
+        struct DropRecorder<'a>(&'a RefCell<Vec<usize>>, usize);
+        impl Drop for DropRecorder<'_> {
+            fn drop(&mut self) {
+                self.0.borrow_mut().push(self.1);
+            }
+        }
+
+        let dropped = RefCell::new(vec![]);
+        {
+            let arena = CtorArena::new();
+            for i in 0..20 {
+                arena.emplace(DropRecorder(&dropped, i));
+            }
+            assert!(dropped.borrow().is_empty());
+        }
+        assert_eq!(*dropped.borrow(), (0..20).rev().collect::<Vec<_>>());
+    }
+
+    /// Tests that when a Ctor panics, the arena doesn't drop the uninitialized value.
+    #[gtest]
+    fn test_ctor_arena_no_drop_on_panic() {
+        let is_dropped = Mutex::new(false);
+        let arena = CtorArena::new();
+        let panic_result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            arena.emplace(PanicCtor(DropNotify(&is_dropped)));
+        }));
+        assert!(panic_result.is_err());
+        assert!(arena.is_empty());
+        drop(arena);
+        assert!(!*is_dropped.lock().unwrap());
+    }
+
+    #[gtest]
+    fn test_ctor_arena_reentrant_emplace_panics() {
+        let arena = CtorArena::new();
+        let panic_result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            arena.emplace(FnCtor::new(|mut dest: Pin<&mut MaybeUninit<u32>>| {
+                arena.emplace(copy(&1));
+                dest.write(2);
+            }));
+        }));
+        assert!(panic_result.is_err());
+        assert!(arena.is_empty());
+        assert_eq!(*arena.emplace(copy(&3)), 3);
+    }
+
+    #[gtest]
+    fn test_array_from_fn() {
+        emplace! {
+            let squares = array_from_fn::<_, _, 4>(|i| i * i);
+        }
+        assert_eq!(*squares, [0, 1, 4, 9]);
+
+        emplace! {
+            let empty = array_from_fn::<_, _, 0>(|i| i);
+        }
+        assert_eq!(*empty, [0_usize; 0]);
+    }
+
+    #[gtest]
+    fn test_box_slice_from_fn() {
+        let values = box_slice_from_fn(1000, |i| i);
+        assert_eq!(values.len(), 1000);
+        assert!(values.iter().copied().eq(0..1000));
+        assert!(box_slice_from_fn(0, |i| i).is_empty());
+    }
+
+    /// Tests that when constructing an element panics, the elements that were already
+    /// constructed are dropped in reverse order, and the others are not dropped.
+    #[gtest]
+    fn test_array_from_fn_drops_constructed_elements_on_panic() {
+        struct DropRecorder<'a>(&'a RefCell<Vec<usize>>, usize);
+        impl Drop for DropRecorder<'_> {
+            fn drop(&mut self) {
+                self.0.borrow_mut().push(self.1);
+            }
+        }
+
+        let dropped = &RefCell::new(vec![]);
+        let ctor_for = |i: usize| {
+            FnCtor::new(move |mut dest: Pin<&mut MaybeUninit<DropRecorder>>| {
+                assert!(i != 3, "constructing the element 3 panics");
+                unsafe { dest.as_mut().get_unchecked_mut() }.write(DropRecorder(dropped, i));
+            })
+        };
+        let panic_result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            emplace! {
+                let _array = array_from_fn::<_, _, 5>(ctor_for);
+            }
+        }));
+        assert!(panic_result.is_err());
+        assert_eq!(*dropped.borrow(), vec![2, 1, 0]);
+
+        dropped.borrow_mut().clear();
+        let panic_result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            box_slice_from_fn(5, ctor_for);
+        }));
+        assert!(panic_result.is_err());
+        assert_eq!(*dropped.borrow(), vec![2, 1, 0]);
+    }
 }
@@ -0,0 +1,17 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/ffi_overhead_benchmark/cc_api.h"
+
+#include <cstdint>
+
+namespace ffi_overhead {
+
+int32_t AddOutOfLine(int32_t x, int32_t y) { return x + y; }
+
+TrivialRecord SwapOutOfLine(TrivialRecord record) {
+  return {record.y, record.x};
+}
+
+}  // namespace ffi_overhead
@@ -0,0 +1,77 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_FFI_OVERHEAD_BENCHMARK_CC_API_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_FFI_OVERHEAD_BENCHMARK_CC_API_H_
+
+#include <stddef.h>
+
+#include <cstdint>
+
+#include "support/cc_std/cpp_std_string.h"
+
+#pragma clang lifetime_elision
+
+// The C++ side of the Rust-calls-C++ benchmarks in `rust_calls_cc.rs`. Every
+// function does as little work as possible, so that the benchmarks measure
+// the cost of the call itself.
+namespace ffi_overhead {
+
+// Defined out of line, so that Rust calls it directly through its mangled
+// name, without a thunk.
+int32_t AddOutOfLine(int32_t x, int32_t y);
+
+// Inline, so that Rust calls it through a thunk in `..._rust_api_impl.cc`.
+inline int32_t AddInline(int32_t x, int32_t y) { return x + y; }
+
+// Trivial, and therefore `Unpin` in Rust.
+struct TrivialRecord final {
+  int32_t x;
+  int32_t y;
+};
+
+TrivialRecord SwapOutOfLine(TrivialRecord record);
+inline TrivialRecord SwapInline(TrivialRecord record) {
+  return {record.y, record.x};
+}
+inline int32_t SumByReference(const TrivialRecord& record) {
+  return record.x + record.y;
+}
+
+// Nontrivial and not final, and therefore `!Unpin` in Rust: it can only be
+// constructed through `ctor::CtorNew`.
+struct NontrivialRecord {
+  explicit NontrivialRecord(int32_t value) : value(value) {}
+  ~NontrivialRecord() {}
+
+  int32_t value;
+};
+
+inline int32_t ReadNontrivial(const NontrivialRecord& record) {
+  return record.value;
+}
+
+struct Base {
+  int32_t base_value = 1;
+};
+
+// Upcasts from `Derived` are a constant offset, which is computed at bindings
+// generation time.
+struct Derived : Base {
+  int32_t derived_value = 2;
+};
+
+// Upcasts from `VirtualDerived` need to read the vtable, which goes through a
+// thunk.
+struct VirtualDerived : virtual Base {
+  int32_t derived_value = 3;
+};
+
+inline int32_t ReadBase(const Base& base) { return base.base_value; }
+
+inline size_t StringSize(const StdString& s) { return s.size(); }
+
+}  // namespace ffi_overhead
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_FFI_OVERHEAD_BENCHMARK_CC_API_H_
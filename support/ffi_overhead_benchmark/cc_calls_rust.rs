@@ -0,0 +1,49 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! The Rust side of the C++-calls-Rust benchmarks in
+//! `ffi_overhead_benchmark.cc`, called through the bindings generated by
+//! `cc_bindings_from_rs`. Every function does as little work as possible, so
+//! that the benchmarks measure the cost of the call itself.
+
+pub fn add(x: i32, y: i32) -> i32 {
+    x + y
+}
+
+#[derive(Clone, Copy, Default)]
+pub struct Point {
+    pub x: i32,
+    pub y: i32,
+}
+
+impl Point {
+    pub fn create(x: i32, y: i32) -> Point {
+        Point { x, y }
+    }
+}
+
+pub fn swap(point: Point) -> Point {
+    Point { x: point.y, y: point.x }
+}
+
+pub fn sum_by_reference(point: &Point) -> i32 {
+    point.x + point.y
+}
+
+/// A record that is not `Copy`, and therefore needs move constructors and a
+/// destructor in C++.
+#[derive(Default)]
+pub struct Accumulator {
+    values: Vec<i32>,
+}
+
+impl Accumulator {
+    pub fn push(&mut self, value: i32) {
+        self.values.push(value);
+    }
+
+    pub fn len(&self) -> usize {
+        self.values.len()
+    }
+}
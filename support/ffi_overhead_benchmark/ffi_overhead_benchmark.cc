@@ -0,0 +1,146 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks of the per-call overhead of Crubit bindings, in both directions.
+//
+// The `BM_CcCallsRust*` benchmarks call the `cc_bindings_from_rs` bindings of
+// `cc_calls_rust.rs` once per iteration, next to a C++ baseline.
+//
+// The `BM_RustCallsCc*` benchmarks call a loop in `rust_calls_cc.rs`, which
+// calls the `rs_bindings_from_cc` bindings of `cc_api.h` `kBatchSize` times.
+// They report items per second, so that the per-call cost can be read off
+// directly and compared with `BM_RustCallsCcBaseline`.
+
+#include <cstdint>
+
+#include "support/ffi_overhead_benchmark/cc_calls_rust.h"
+#include "support/ffi_overhead_benchmark/rust_calls_cc.h"
+#include "third_party/benchmark/include/benchmark/benchmark.h"
+
+namespace crubit {
+namespace {
+
+constexpr uint64_t kBatchSize = 1000;
+
+// Not inline, like a call that crosses the language boundary.
+[[gnu::noinline]] int32_t CcAdd(int32_t x, int32_t y) { return x + y; }
+
+void BM_CcCallsCcBaseline(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CcAdd(1, 2));
+  }
+}
+BENCHMARK(BM_CcCallsCcBaseline);
+
+void BM_CcCallsRustAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cc_calls_rust::add(1, 2));
+  }
+}
+BENCHMARK(BM_CcCallsRustAdd);
+
+void BM_CcCallsRustRecordByValue(benchmark::State& state) {
+  cc_calls_rust::Point point = cc_calls_rust::Point::create(1, 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(point);
+    benchmark::DoNotOptimize(cc_calls_rust::swap(point));
+  }
+}
+BENCHMARK(BM_CcCallsRustRecordByValue);
+
+void BM_CcCallsRustRecordByReference(benchmark::State& state) {
+  cc_calls_rust::Point point = cc_calls_rust::Point::create(1, 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cc_calls_rust::sum_by_reference(point));
+  }
+}
+BENCHMARK(BM_CcCallsRustRecordByReference);
+
+// Default-constructs, mutates, reads and destroys a non-`Copy` Rust record.
+void BM_CcCallsRustNonCopyRecord(benchmark::State& state) {
+  for (auto _ : state) {
+    cc_calls_rust::Accumulator accumulator;
+    accumulator.push(1);
+    benchmark::DoNotOptimize(accumulator.len());
+  }
+}
+BENCHMARK(BM_CcCallsRustNonCopyRecord);
+
+// Runs `loop` once per iteration, and reports one item per call in the loop.
+template <typename Loop>
+void RunRustCallsCc(benchmark::State& state, Loop loop) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loop(kBatchSize));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+void BM_RustCallsCcBaseline(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::rust_baseline);
+}
+BENCHMARK(BM_RustCallsCcBaseline);
+
+void BM_RustCallsCcDirect(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::add_out_of_line);
+}
+BENCHMARK(BM_RustCallsCcDirect);
+
+void BM_RustCallsCcThunk(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::add_inline);
+}
+BENCHMARK(BM_RustCallsCcThunk);
+
+void BM_RustCallsCcRecordByValueDirect(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::swap_out_of_line);
+}
+BENCHMARK(BM_RustCallsCcRecordByValueDirect);
+
+void BM_RustCallsCcRecordByValueThunk(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::swap_inline);
+}
+BENCHMARK(BM_RustCallsCcRecordByValueThunk);
+
+void BM_RustCallsCcRecordByReference(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::sum_by_reference);
+}
+BENCHMARK(BM_RustCallsCcRecordByReference);
+
+void BM_RustCallsCcCtorNew(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::construct_nontrivial);
+}
+BENCHMARK(BM_RustCallsCcCtorNew);
+
+void BM_RustCallsCcUpcast(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::upcast);
+}
+BENCHMARK(BM_RustCallsCcUpcast);
+
+void BM_RustCallsCcVirtualUpcast(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::virtual_upcast);
+}
+BENCHMARK(BM_RustCallsCcVirtualUpcast);
+
+void BM_RustCallsCcVectorAccess(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::vector_access);
+}
+BENCHMARK(BM_RustCallsCcVectorAccess);
+
+void BM_RustCallsCcStdStringAccess(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::std_string_access);
+}
+BENCHMARK(BM_RustCallsCcStdStringAccess);
+
+void BM_RustCallsCcStdStringByReference(benchmark::State& state) {
+  RunRustCallsCc(state, rust_calls_cc::std_string_by_reference);
+}
+BENCHMARK(BM_RustCallsCcStdStringByReference);
+
+}  // namespace
+}  // namespace crubit
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,145 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! Loops that call the C++ API in `cc_api.h` from Rust, through the bindings
+//! generated by `rs_bindings_from_cc`.
+//!
+//! Every function makes `iterations` calls, so that the single C++-to-Rust
+//! call that `ffi_overhead_benchmark.cc` uses to invoke it is amortized. The
+//! `rust_baseline` loop measures the cost of the loop itself.
+
+use cc_api::ffi_overhead::*;
+use cpp_std_string::StdString;
+use ctor::CtorNew as _;
+use oops::Upcast as _;
+use std::hint::black_box;
+
+/// The same loop as `add_out_of_line`, without crossing the language boundary.
+pub fn rust_baseline(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        sum += i64::from(black_box(1i32) + black_box(2i32));
+    }
+    sum
+}
+
+/// Calls a non-inline C++ function, which Rust calls without a thunk.
+pub fn add_out_of_line(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        sum += i64::from(AddOutOfLine(black_box(1), black_box(2)));
+    }
+    sum
+}
+
+/// Calls an inline C++ function, which Rust calls through a thunk.
+pub fn add_inline(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        sum += i64::from(AddInline(black_box(1), black_box(2)));
+    }
+    sum
+}
+
+/// Passes and returns a trivial record by value, without a thunk.
+pub fn swap_out_of_line(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        let record = SwapOutOfLine(black_box(TrivialRecord { x: 1, y: 2 }));
+        sum += i64::from(record.x);
+    }
+    sum
+}
+
+/// Passes and returns a trivial record by value, through a thunk.
+pub fn swap_inline(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        let record = SwapInline(black_box(TrivialRecord { x: 1, y: 2 }));
+        sum += i64::from(record.x);
+    }
+    sum
+}
+
+/// Passes a trivial record by reference.
+pub fn sum_by_reference(iterations: u64) -> i64 {
+    let record = TrivialRecord { x: 1, y: 2 };
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        sum += i64::from(SumByReference(black_box(&record)));
+    }
+    sum
+}
+
+/// Constructs a `!Unpin` record through `ctor::CtorNew` and `emplace!`.
+pub fn construct_nontrivial(iterations: u64) -> i64 {
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        ctor::emplace! {
+            let record = NontrivialRecord::ctor_new(black_box(1));
+        }
+        sum += i64::from(ReadNontrivial(&record));
+    }
+    sum
+}
+
+/// Upcasts to a non-virtual base, which is a constant offset.
+pub fn upcast(iterations: u64) -> i64 {
+    let derived = Derived::default();
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        let base: &Base = black_box(&derived).upcast();
+        sum += i64::from(base.base_value);
+    }
+    sum
+}
+
+/// Upcasts to a virtual base, which goes through a thunk.
+pub fn virtual_upcast(iterations: u64) -> i64 {
+    ctor::emplace! {
+        let derived = VirtualDerived::ctor_new(());
+    }
+    let derived: &VirtualDerived = &derived;
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        let base: &Base = black_box(derived).upcast();
+        sum += i64::from(base.base_value);
+    }
+    sum
+}
+
+/// Reads the elements of a `cc_std::Vector` from Rust.
+pub fn vector_access(iterations: u64) -> i64 {
+    let mut vector = vector::Vector::<i32>::new();
+    for i in 0..16 {
+        vector.push(i);
+    }
+    let mut sum = 0i64;
+    for i in 0..iterations {
+        let vector = black_box(&vector);
+        sum += i64::from(vector.as_slice()[(i % 16) as usize]);
+    }
+    sum
+}
+
+/// Reads the contents of a `StdString` from Rust.
+pub fn std_string_access(iterations: u64) -> i64 {
+    let s = StdString::from("a string that is too long for the small string optimization");
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        let s = black_box(&s);
+        sum += i64::from(s.as_slice()[0]) + s.len() as i64;
+    }
+    sum
+}
+
+/// Passes a `StdString` to C++ by reference.
+pub fn std_string_by_reference(iterations: u64) -> i64 {
+    let s = StdString::from("a string that is too long for the small string optimization");
+    let mut sum = 0i64;
+    for _ in 0..iterations {
+        sum += StringSize(black_box(&s)) as i64;
+    }
+    sum
+}
@@ -71,6 +71,137 @@
 #define CRUBIT_INTERNAL_SAME_ABI \
   CRUBIT_INTERNAL_ANNOTATE("crubit_internal_same_abi")
 
+// Unsafe: asserts that the C++ library emits a definition of the function.
+//
+// Inline functions and members of class templates are normally called through
+// a thunk, which forces their definition to be emitted into the bindings, but
+// also costs an extra call in builds without cross-language LTO. With this
+// attribute, Rust calls such a function directly by its mangled name instead,
+// as long as its signature is otherwise C ABI compatible.
+//
+// For example:
+//
+// ```c++
+// CRUBIT_INTERNAL_NO_THUNK [[gnu::used]] inline int Add(int a, int b) {
+//   return a + b;
+// }
+// ```
+//
+// This has no effect on virtual functions, functions with a non-C calling
+// convention, or functions that take or return types by value which are not C
+// ABI compatible: these always require a thunk.
+//
+// SAFETY:
+//   If no definition of the function is emitted for the mangled name, e.g.
+//   by `[[gnu::used]]` or by an explicit template instantiation, linking the
+//   Rust code fails.
+#define CRUBIT_INTERNAL_NO_THUNK \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_no_thunk")
+
+// Generates an additional entry point that calls a function over a slice.
+//
+// This can be applied to a free function that takes a single parameter, either
+// a primitive type by value or any type by const reference, and returns a
+// primitive type. The loop over the elements runs in C++, so a single call
+// across the language boundary processes the whole slice, and the C++ compiler
+// can inline and vectorize the calls.
+//
+// For example, this C++ header:
+//
+// ```c++
+// CRUBIT_INTERNAL_BATCH int Hash(const Foo& foo);
+// ```
+//
+// Becomes this Rust interface:
+//
+// ```rust
+// pub fn Hash(foo: &Foo) -> i32;
+// // Panics if `inputs` and `outputs` have different lengths.
+// pub fn Hash_batch(inputs: &[Foo], outputs: &mut [i32]);
+// ```
+#define CRUBIT_INTERNAL_BATCH CRUBIT_INTERNAL_ANNOTATE("crubit_internal_batch")
+
+// Generates an additional Rust `enum` for a C++ enum whose enumerators form a
+// dense range of distinct values.
+//
+// The newtype bindings of the enum are unchanged, since C++ code can still
+// produce values that have no enumerator. The additional `<Name>Enum` has a
+// variant per enumerator, and converts from the newtype with a range-checked
+// `TryFrom`, so that Rust code can `match` on it exhaustively (and the compiler
+// can use a jump table).
+//
+// For example, this C++ header:
+//
+// ```c++
+// enum class CRUBIT_INTERNAL_DENSE_ENUM Color { kRed, kGreen, kBlue };
+// ```
+//
+// Becomes this Rust interface:
+//
+// ```rust
+// pub struct Color(i32);  // With the `Color::kRed` etc. constants, as usual.
+// pub enum ColorEnum { kRed = 0, kGreen = 1, kBlue = 2 }
+// impl TryFrom<Color> for ColorEnum { type Error = Color; ... }
+// impl From<ColorEnum> for Color { ... }
+// ```
+#define CRUBIT_INTERNAL_DENSE_ENUM \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_dense_enum")
+
+// Generates column views of the fields of a struct, for code that scans one
+// field over many elements (e.g. of a `cc_std::Vector<T>`).
+//
+// This can be applied to a struct or class. Each public field of a primitive
+// type gets an associated function that iterates over that field across a
+// slice of the struct, by value. Unlike calls to accessor functions, this
+// compiles to plain strided loads that the Rust compiler can inline and
+// vectorize. Structs that are `Unpin` in Rust also get a mutable column view.
+//
+// For example, this C++ header:
+//
+// ```c++
+// struct CRUBIT_INTERNAL_COLUMN_VIEW Point {
+//   float x;
+//   float y;
+// };
+// ```
+//
+// Becomes this Rust interface:
+//
+// ```rust
+// impl Point {
+//   pub fn x_column(points: &[Point]) -> impl ExactSizeIterator<Item = f32>;
+//   pub fn x_column_mut(points: &mut [Point])
+//       -> impl ExactSizeIterator<Item = &mut f32>;
+//   // Likewise for `y`.
+// }
+// ```
+#define CRUBIT_INTERNAL_COLUMN_VIEW \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_column_view")
+
+// Gives a function a different name in Rust.
+//
+// This can be applied to named (free or member) functions. In particular, it
+// lets overloaded functions, which otherwise get no bindings, be imported as
+// plain, distinctly named Rust functions.
+//
+// For example, this C++ header:
+//
+// ```c++
+// CRUBIT_INTERNAL_RUST_NAME("StrCat2")
+// std::string StrCat(const AlphaNum& a, const AlphaNum& b);
+// CRUBIT_INTERNAL_RUST_NAME("StrCat3")
+// std::string StrCat(const AlphaNum& a, const AlphaNum& b, const AlphaNum& c);
+// ```
+//
+// Becomes this Rust interface:
+//
+// ```rust
+// pub fn StrCat2(a: &AlphaNum, b: &AlphaNum) -> string;
+// pub fn StrCat3(a: &AlphaNum, b: &AlphaNum, c: &AlphaNum) -> string;
+// ```
+#define CRUBIT_INTERNAL_RUST_NAME(name) \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_rust_name", name)
+
 #define CRUBIT_INTERNAL_BRIDGE_TYPE(t) \
   CRUBIT_INTERNAL_ANNOTATE("crubit_bridge_type", t)
 
@@ -0,0 +1,43 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_SUPPORT_INTERNAL_CHECK_LAYOUT_H_
+#define CRUBIT_SUPPORT_INTERNAL_CHECK_LAYOUT_H_
+
+#include <cstddef>
+
+namespace crubit::details {
+
+// A single row of a layout table: a `sizeof`, `alignof` or `offsetof` of a C++
+// type (`actual`), and the value that the Rust bindings were generated for
+// (`expected`).
+struct LayoutCheck {
+  std::size_t actual;
+  std::size_t expected;
+};
+
+// Returns the index of the first row of `checks` whose `actual` and `expected`
+// values differ, or -1 if all of them match.
+//
+// This lets the bindings of a whole target verify the layout of all of their
+// types with a single `static_assert`, e.g.:
+//
+//    static_assert(crubit::details::FindLayoutMismatch({
+//                      {CRUBIT_SIZEOF(struct ns::S), 8},
+//                      {alignof(struct ns::S), 4},
+//                      {CRUBIT_OFFSET_OF(field, struct ns::S), 4},
+//                  }) == -1);
+//
+// When the assertion fails, Clang prints the index of the offending row.
+template <std::size_t N>
+constexpr int FindLayoutMismatch(const LayoutCheck (&checks)[N]) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (checks[i].actual != checks[i].expected) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+}  // namespace crubit::details
+
+#endif  // CRUBIT_SUPPORT_INTERNAL_CHECK_LAYOUT_H_
@@ -0,0 +1,39 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/internal/check_layout.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "support/internal/offsetof.h"
+#include "support/internal/sizeof.h"
+
+namespace {
+
+struct TestStruct {
+  std::int32_t x;
+  std::int64_t y;
+};
+
+TEST(CheckLayoutTest, AllRowsMatch) {
+  constexpr int kMismatch = crubit::details::FindLayoutMismatch({
+      {CRUBIT_SIZEOF(TestStruct), 16},
+      {alignof(TestStruct), 8},
+      {CRUBIT_OFFSET_OF(x, TestStruct), 0},
+      {CRUBIT_OFFSET_OF(y, TestStruct), 8},
+  });
+  EXPECT_EQ(kMismatch, -1);
+}
+
+TEST(CheckLayoutTest, ReportsFirstMismatch) {
+  constexpr int kMismatch = crubit::details::FindLayoutMismatch({
+      {CRUBIT_SIZEOF(TestStruct), 16},
+      {CRUBIT_OFFSET_OF(y, TestStruct), 4},
+      {alignof(TestStruct), 1},
+  });
+  EXPECT_EQ(kMismatch, 1);
+}
+
+}  // namespace
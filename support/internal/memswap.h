@@ -5,11 +5,35 @@
 #ifndef THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_MEMSWAP_H_
 #define THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_MEMSWAP_H_
 
+#include <cstddef>
 #include <cstring>
 
 #include "absl/base/optimization.h"
 
 namespace crubit {
+namespace memswap_internal {
+
+// Objects up to this size are swapped through a single temporary, which the
+// compiler keeps in (general purpose or vector) registers.
+inline constexpr size_t kMaxWholeSwapSize = 64;
+
+// Larger objects are swapped `kChunkSize` bytes at a time, so that each byte
+// is loaded and stored once (instead of round-tripping the whole object through
+// a stack buffer), and so that the stack usage doesn't depend on `sizeof(T)`.
+// The constant size lets the compiler turn each chunk into a few vector loads
+// and stores.
+inline constexpr size_t kChunkSize = 64;
+
+// Swaps `N` bytes at `a` and `b`, which must not overlap.
+template <size_t N>
+inline void SwapBytes(char* a, char* b) {
+  char tmp[N];
+  std::memcpy(tmp, a, N);
+  std::memcpy(a, b, N);
+  std::memcpy(b, tmp, N);
+}
+
+}  // namespace memswap_internal
 
 // Like `std::swap`, but the implementation is guaranteed to have no
 // dependencies on `T`-specific code (e.g. it does *not* call into
@@ -25,10 +49,42 @@ void MemSwap(T& a, T& b) {
     return;
   }
 
-  char tmp[sizeof(T)];
-  std::memcpy(tmp, &a, sizeof(T));
-  std::memcpy(&a, &b, sizeof(T));
-  std::memcpy(&b, tmp, sizeof(T));
+  char* a_bytes = reinterpret_cast<char*>(&a);
+  char* b_bytes = reinterpret_cast<char*>(&b);
+  if constexpr (sizeof(T) <= memswap_internal::kMaxWholeSwapSize) {
+    memswap_internal::SwapBytes<sizeof(T)>(a_bytes, b_bytes);
+  } else {
+    constexpr size_t kChunkSize = memswap_internal::kChunkSize;
+    constexpr size_t kFullChunksSize = sizeof(T) / kChunkSize * kChunkSize;
+    for (size_t i = 0; i < kFullChunksSize; i += kChunkSize) {
+      memswap_internal::SwapBytes<kChunkSize>(a_bytes + i, b_bytes + i);
+    }
+    if constexpr (sizeof(T) % kChunkSize != 0) {
+      memswap_internal::SwapBytes<sizeof(T) % kChunkSize>(
+          a_bytes + kFullChunksSize, b_bytes + kFullChunksSize);
+    }
+  }
+}
+
+// Relocates `count` objects from `src` to `dest`: after the call, the objects
+// live at `dest`, and the memory at `src` holds no objects (their destructors
+// must not run). The two ranges may overlap, e.g. when shifting the elements
+// of an array.
+//
+// This is equivalent to move-constructing each object at `dest` and
+// destroying the object at `src`, but it is a single `memmove`, and it has no
+// dependencies on `T`-specific code.
+//
+// SAFETY REQUIREMENTS: Same as `MemSwap`. Additionally, `dest` must point to
+// storage for `count` objects of type `T` that holds no live objects (other
+// than, possibly, the objects being relocated).
+template <typename T>
+void MemRelocate(T* dest, T* src, size_t count) {
+  if (ABSL_PREDICT_FALSE(dest == src || count == 0)) {
+    return;
+  }
+  std::memmove(static_cast<void*>(dest), static_cast<const void*>(src),
+               count * sizeof(T));
 }
 
 }  // namespace crubit
@@ -4,6 +4,10 @@
 
 #include "support/internal/memswap.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -23,4 +27,50 @@ TEST(MemSwapTest, Aliasing) {
   EXPECT_EQ(a, 123);
 }
 
+template <size_t N>
+struct Bytes {
+  std::array<uint8_t, N> bytes;
+};
+
+template <size_t N>
+Bytes<N> MakeBytes(uint8_t first) {
+  Bytes<N> result;
+  for (size_t i = 0; i < N; ++i) {
+    result.bytes[i] = static_cast<uint8_t>(first + i);
+  }
+  return result;
+}
+
+template <typename T>
+class MemSwapSizeTest : public testing::Test {};
+
+// Sizes around the boundaries between whole-object and chunked swaps.
+using SwapSizes = testing::Types<Bytes<1>, Bytes<63>, Bytes<64>, Bytes<65>,
+                                 Bytes<128>, Bytes<1000>>;
+TYPED_TEST_SUITE(MemSwapSizeTest, SwapSizes);
+
+TYPED_TEST(MemSwapSizeTest, SwapsAllBytes) {
+  constexpr size_t kSize = sizeof(TypeParam);
+  auto a = MakeBytes<kSize>(0);
+  auto b = MakeBytes<kSize>(100);
+  crubit::MemSwap(a, b);
+  EXPECT_EQ(a.bytes, MakeBytes<kSize>(100).bytes);
+  EXPECT_EQ(b.bytes, MakeBytes<kSize>(0).bytes);
+}
+
+TEST(MemRelocateTest, Basic) {
+  int src[] = {1, 2, 3};
+  int dest[3];
+  crubit::MemRelocate(dest, src, 3);
+  EXPECT_THAT(dest, testing::ElementsAre(1, 2, 3));
+}
+
+TEST(MemRelocateTest, Overlapping) {
+  int array[] = {1, 2, 3, 4, 0};
+  crubit::MemRelocate(array + 1, array, 4);
+  EXPECT_THAT(array, testing::ElementsAre(1, 1, 2, 3, 4));
+  crubit::MemRelocate(array, array + 1, 4);
+  EXPECT_THAT(array, testing::ElementsAre(1, 2, 3, 4, 4));
+}
+
 }  // namespace
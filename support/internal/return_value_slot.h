@@ -107,6 +107,36 @@ class ReturnValueSlot {
   };
 };
 
+// `InPlaceInitTag` selects the constructor that the generated bindings of Rust
+// structs declare when `cc_bindings_from_rs` runs with
+// `--return-values-in-place`:
+//
+//     ```cc
+//     template <typename F>
+//     SomeStruct(crubit::InPlaceInitTag, F&& init) {
+//       std::forward<F>(init)(this);
+//     }
+//     ```
+//
+// The constructor doesn't initialize any fields, and `init` calls a Rust thunk
+// which writes the return value through the pointer. Unlike
+// `ReturnValueSlot`, this doesn't need a move constructor call: thanks to
+// guaranteed copy elision, `this` is the caller's return location:
+//
+//     ```cc
+//     inline SomeStruct foo(int32_t arg1, int32_t arg2) {
+//       return SomeStruct(crubit::InPlaceInitTag(), [&](SomeStruct* __ret_ptr) {
+//         __rust_thunk_for_foo(arg1, arg2, __ret_ptr);
+//       });
+//     }
+//     ```
+//
+// SAFETY REQUIREMENTS: `init` must initialize the object at the pointer it is
+// given (or not return, e.g. abort on a Rust panic).
+struct InPlaceInitTag {
+  explicit InPlaceInitTag() = default;
+};
+
 }  // namespace crubit
 
 #endif  // CRUBIT_SUPPORT_INTERNAL_RETURN_VALUE_SLOT_H_
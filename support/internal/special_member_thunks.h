@@ -0,0 +1,60 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_SPECIAL_MEMBER_THUNKS_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_SPECIAL_MEMBER_THUNKS_H_
+
+#include <memory>
+#include <utility>
+
+#include "support/internal/cxx20_backports.h"
+
+// The bodies of the thunks that `rs_bindings_from_cc` generates for the special
+// member functions of C++ records. Each generated `extern "C"` thunk is a call
+// to one of these templates, so that the C++ front end instantiates one body
+// per record and kind of special member function, and the linker can fold the
+// identical instantiations of different records.
+//
+// The parameters use the same types as the generated thunks: references are
+// passed as pointers.
+//
+// `construct_at` and `destroy_at` avoid spelling out the name of the record,
+// which, for the destructor in particular, can be difficult (impossible?) to
+// spell in the general case.
+
+namespace crubit {
+
+template <typename T>
+void DefaultCtorThunk(T* __this) {
+  crubit::construct_at(__this);
+}
+
+template <typename T>
+void CopyCtorThunk(T* __this, const T* other) {
+  crubit::construct_at(__this, *other);
+}
+
+template <typename T>
+void MoveCtorThunk(T* __this, T* other) {
+  crubit::construct_at(__this, std::move(*other));
+}
+
+template <typename T>
+T* CopyAssignThunk(T* __this, const T* other) {
+  return &__this->operator=(*other);
+}
+
+template <typename T>
+T* MoveAssignThunk(T* __this, T* other) {
+  return &__this->operator=(std::move(*other));
+}
+
+template <typename T>
+void DtorThunk(T* __this) {
+  std::destroy_at(__this);
+}
+
+}  // namespace crubit
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_SPECIAL_MEMBER_THUNKS_H_
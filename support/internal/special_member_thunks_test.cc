@@ -0,0 +1,76 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/internal/special_member_thunks.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Records which special member function was called last.
+struct Tracker {
+  Tracker() : last_call("default ctor") {}
+  Tracker(const Tracker&) : last_call("copy ctor") {}
+  Tracker(Tracker&&) : last_call("move ctor") {}
+  Tracker& operator=(const Tracker&) {
+    last_call = "copy assign";
+    return *this;
+  }
+  Tracker& operator=(Tracker&&) {
+    last_call = "move assign";
+    return *this;
+  }
+  ~Tracker() { ++*destructor_calls; }
+
+  std::string last_call;
+  int* destructor_calls = &unused_destructor_calls;
+  int unused_destructor_calls = 0;
+};
+
+// Storage for a `Tracker` that isn't constructed or destroyed implicitly.
+union TrackerSlot {
+  TrackerSlot() {}
+  ~TrackerSlot() {}
+  Tracker tracker;
+};
+
+TEST(SpecialMemberThunksTest, Constructors) {
+  Tracker other;
+  TrackerSlot slot;
+
+  crubit::DefaultCtorThunk(&slot.tracker);
+  EXPECT_EQ(slot.tracker.last_call, "default ctor");
+  std::destroy_at(&slot.tracker);
+
+  crubit::CopyCtorThunk(&slot.tracker, &other);
+  EXPECT_EQ(slot.tracker.last_call, "copy ctor");
+  std::destroy_at(&slot.tracker);
+
+  crubit::MoveCtorThunk(&slot.tracker, &other);
+  EXPECT_EQ(slot.tracker.last_call, "move ctor");
+  std::destroy_at(&slot.tracker);
+}
+
+TEST(SpecialMemberThunksTest, Assignment) {
+  Tracker tracker;
+  Tracker other;
+  EXPECT_EQ(crubit::CopyAssignThunk(&tracker, &other), &tracker);
+  EXPECT_EQ(tracker.last_call, "copy assign");
+  EXPECT_EQ(crubit::MoveAssignThunk(&tracker, &other), &tracker);
+  EXPECT_EQ(tracker.last_call, "move assign");
+}
+
+TEST(SpecialMemberThunksTest, Destructor) {
+  int destructor_calls = 0;
+  TrackerSlot slot;
+  crubit::DefaultCtorThunk(&slot.tracker);
+  slot.tracker.destructor_calls = &destructor_calls;
+  crubit::DtorThunk(&slot.tracker);
+  EXPECT_EQ(destructor_calls, 1);
+}
+
+}  // namespace
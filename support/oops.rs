@@ -24,10 +24,18 @@
 //!
 //! ## Downcasting
 //!
-//! TODO(b/216195042): dynamic downcasting
-//! TODO(b/216195042): static downcasting
+//! To cast a reference to a base class to a reference to a derived class, as
+//! with `static_cast` in C++, use `unsafe { my_reference.static_downcast() }`.
+//! It is pointer arithmetic with the constant offset of a non-virtual base,
+//! and is implemented by implementing the `InheritsNonVirtually` trait.
+//!
+//! To check the dynamic type of the object instead, as with `dynamic_cast` in
+//! C++, use `my_reference.dynamic_downcast()`, which returns `None` if the
+//! object is not a `Derived`. It is implemented by implementing the
+//! `InheritsDynamically` trait, usually with the help of a `DowncastCache`.
 
 use std::pin::Pin;
+use std::sync::atomic::{AtomicU64, Ordering};
 
 /// Upcast a reference or smart pointer. This operation cannot fail at runtime.
 ///
@@ -202,6 +210,255 @@ unsafe impl<T> Inherits<T> for T {
     }
 }
 
+/// `Derived : InheritsNonVirtually<Base>` means that `Base` is a non-virtual
+/// base class of `Derived`, at the constant offset `BASE_OFFSET`. This makes
+/// upcasts and static downcasts between them pointer arithmetic.
+///
+/// ## Safety
+///
+/// `BASE_OFFSET` must be the offset, in bytes, of the `Base` subobject within
+/// `Derived`, and `Derived::upcast_ptr` must add it to the pointer.
+pub unsafe trait InheritsNonVirtually<Base>: Inherits<Base> {
+    /// The offset of the `Base` subobject within `Self`, in bytes.
+    const BASE_OFFSET: isize;
+}
+
+/// All classes are their own improper base, at offset 0.
+unsafe impl<T> InheritsNonVirtually<T> for T {
+    const BASE_OFFSET: isize = 0;
+}
+
+/// Statically downcasts a pointer to a `Base` subobject to a pointer to the
+/// `Derived` object that contains it, like `static_cast` in C++.
+///
+/// The offset is checked at compile time to lie within `Derived`.
+///
+/// ## Safety
+///
+/// If `base` is null, this returns null. Otherwise, `base` must point to the
+/// `Base` subobject of a `Derived` object, which is what the returned pointer
+/// points to.
+#[inline(always)]
+pub unsafe fn static_downcast_ptr<Derived, Base>(base: *const Base) -> *const Derived
+where
+    Derived: InheritsNonVirtually<Base>,
+{
+    let offset = const {
+        assert!(
+            0 <= Derived::BASE_OFFSET
+                && Derived::BASE_OFFSET as usize <= std::mem::size_of::<Derived>(),
+            "the offset of a base class must lie within the derived class"
+        );
+        Derived::BASE_OFFSET
+    };
+    if base.is_null() {
+        return std::ptr::null();
+    }
+    (base as *const u8).offset(-offset) as *const Derived
+}
+
+/// Statically downcast a reference or pointer, like `static_cast` in C++.
+///
+/// If `Derived : InheritsNonVirtually<Base>`, then:
+///
+/// ```ignore
+/// &Base : StaticDowncast<&Derived>
+/// Pin<&mut Base> : StaticDowncast<Pin<&mut Derived>>
+/// *const Base : StaticDowncast<*const Derived>
+/// *mut Base : StaticDowncast<*mut Derived>
+/// ```
+///
+/// ## Safety
+///
+/// `self` must not be dangling, and if it is not null, it must refer to the
+/// `Base` subobject of a `Derived` object.
+pub unsafe trait StaticDowncast<Target> {
+    /// # Safety
+    ///
+    /// See the trait documentation.
+    unsafe fn static_downcast(self) -> Target;
+}
+
+/// Downcast `&` -> `&`.
+unsafe impl<'a, Derived, Base> StaticDowncast<&'a Derived> for &'a Base
+where
+    Derived: InheritsNonVirtually<Base>,
+{
+    #[inline(always)]
+    unsafe fn static_downcast(self: &'a Base) -> &'a Derived {
+        &*static_downcast_ptr::<Derived, Base>(self)
+    }
+}
+
+/// Downcast `Pin<&mut>` -> `Pin<&mut>`.
+unsafe impl<'a, Derived, Base> StaticDowncast<Pin<&'a mut Derived>> for Pin<&'a mut Base>
+where
+    Derived: InheritsNonVirtually<Base>,
+{
+    #[inline(always)]
+    unsafe fn static_downcast(self: Pin<&'a mut Base>) -> Pin<&'a mut Derived> {
+        let inner = Pin::into_inner_unchecked(self) as *mut Base;
+        Pin::new_unchecked(&mut *(static_downcast_ptr::<Derived, Base>(inner) as *mut Derived))
+    }
+}
+
+/// Downcast `*const` -> `*const`.
+unsafe impl<Derived, Base> StaticDowncast<*const Derived> for *const Base
+where
+    Derived: InheritsNonVirtually<Base>,
+{
+    #[inline(always)]
+    unsafe fn static_downcast(self: *const Base) -> *const Derived {
+        static_downcast_ptr::<Derived, Base>(self)
+    }
+}
+
+/// Downcast `*mut` -> `*mut`.
+unsafe impl<Derived, Base> StaticDowncast<*mut Derived> for *mut Base
+where
+    Derived: InheritsNonVirtually<Base>,
+{
+    #[inline(always)]
+    unsafe fn static_downcast(self: *mut Base) -> *mut Derived {
+        static_downcast_ptr::<Derived, Base>(self) as *mut Derived
+    }
+}
+
+/// `Derived : InheritsDynamically<Base>` means that `Base` is a polymorphic
+/// base class of `Derived`, so that a `Base` can be checked at runtime for
+/// being a subobject of a `Derived`, like with `dynamic_cast` in C++.
+///
+/// ## Safety
+///
+/// `dynamic_downcast_ptr` must uphold its documented contract.
+pub unsafe trait InheritsDynamically<Base>: Inherits<Base> {
+    /// Returns the `Derived` object whose subobject `base` points to, or null
+    /// if `*base` is not a subobject of a `Derived` (or `base` is null).
+    ///
+    /// ## Safety
+    ///
+    /// `base` must be null or a dereferencable pointer. If the returned
+    /// pointer is not null, it is dereferencable with the same lifetime.
+    unsafe fn dynamic_downcast_ptr(base: *const Base) -> *const Self;
+}
+
+/// Dynamically downcast a reference, like `dynamic_cast` in C++.
+///
+/// If `Derived : InheritsDynamically<Base>`, then:
+///
+/// ```ignore
+/// &Base : DynamicDowncast<&Derived>
+/// Pin<&mut Base> : DynamicDowncast<Pin<&mut Derived>>
+/// ```
+pub trait DynamicDowncast<Target> {
+    /// Returns `None` if `self` does not refer to a subobject of the target
+    /// type.
+    fn dynamic_downcast(self) -> Option<Target>;
+}
+
+/// Downcast `&` -> `&`.
+impl<'a, Derived, Base> DynamicDowncast<&'a Derived> for &'a Base
+where
+    Derived: InheritsDynamically<Base>,
+{
+    fn dynamic_downcast(self: &'a Base) -> Option<&'a Derived> {
+        unsafe { Derived::dynamic_downcast_ptr(self).as_ref() }
+    }
+}
+
+/// Downcast `Pin<&mut>` -> `Pin<&mut>`.
+impl<'a, Derived, Base> DynamicDowncast<Pin<&'a mut Derived>> for Pin<&'a mut Base>
+where
+    Derived: InheritsDynamically<Base>,
+{
+    fn dynamic_downcast(self: Pin<&'a mut Base>) -> Option<Pin<&'a mut Derived>> {
+        unsafe {
+            let inner = Pin::into_inner_unchecked(self) as *mut Base;
+            let derived = Derived::dynamic_downcast_ptr(inner) as *mut Derived;
+            derived.as_mut().map(|derived| Pin::new_unchecked(derived))
+        }
+    }
+}
+
+/// Caches the result of the last successful dynamic downcast between a pair
+/// of types, so that downcasting another object of the same dynamic type is
+/// pointer arithmetic instead of a call to the RTTI-based `dynamic_cast`.
+///
+/// The cache is keyed on the vtable pointer of the `Base` subobject: the
+/// vtable pointer of a subobject determines both the dynamic type of the
+/// complete object and the position of the subobject within it, and therefore
+/// the offset to the `Derived` object.
+///
+/// The vtable pointer and the offset are packed into a single atomic word, so
+/// the cache is only used for vtable pointers that fit in 48 bits and offsets
+/// that fit in 16 bits. Other downcasts always go through `dynamic_cast`.
+///
+/// For example:
+///
+/// ```ignore
+/// unsafe impl oops::InheritsDynamically<Base> for Derived {
+///     unsafe fn dynamic_downcast_ptr(base: *const Base) -> *const Self {
+///         static CACHE: oops::DowncastCache = oops::DowncastCache::new();
+///         CACHE.downcast(base, |base| detail::__crubit_dynamic_cast(base))
+///     }
+/// }
+/// ```
+pub struct DowncastCache {
+    // The vtable pointer shifted left by 16 bits, or'ed with the offset as a
+    // `u16`. 0 if the cache is empty.
+    packed: AtomicU64,
+}
+
+impl DowncastCache {
+    pub const fn new() -> Self {
+        DowncastCache { packed: AtomicU64::new(0) }
+    }
+
+    /// Returns the `Derived` object whose subobject `base` points to, or null
+    /// if `*base` is not a subobject of a `Derived` (or `base` is null).
+    /// Calls `dynamic_cast` unless the vtable pointer of `*base` is that of
+    /// the last successful downcast.
+    ///
+    /// ## Safety
+    ///
+    /// `base` must be null or a dereferencable pointer to a polymorphic
+    /// object, whose first word is its vtable pointer, and `dynamic_cast` must
+    /// uphold the contract of `InheritsDynamically::dynamic_downcast_ptr`. The
+    /// same `DowncastCache` must only be used for a single pair of types.
+    #[inline]
+    pub unsafe fn downcast<Base, Derived>(
+        &self,
+        base: *const Base,
+        dynamic_cast: impl FnOnce(*const Base) -> *const Derived,
+    ) -> *const Derived {
+        if base.is_null() {
+            return std::ptr::null();
+        }
+        let vptr = *(base as *const usize) as u64;
+        let packed = self.packed.load(Ordering::Relaxed);
+        if packed != 0 && packed >> 16 == vptr {
+            let offset = packed as u16 as i16 as isize;
+            return (base as *const u8).offset(offset) as *const Derived;
+        }
+        let derived = dynamic_cast(base);
+        if !derived.is_null() {
+            let offset = (derived as *const u8 as isize).wrapping_sub(base as *const u8 as isize);
+            if vptr >> 48 == 0 {
+                if let Ok(offset) = i16::try_from(offset) {
+                    self.packed.store(vptr << 16 | u64::from(offset as u16), Ordering::Relaxed);
+                }
+            }
+        }
+        derived
+    }
+}
+
+impl Default for DowncastCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -281,4 +538,121 @@ mod test {
         }
         assert_eq!(derived.base.0, 42);
     }
+
+    #[gtest]
+    fn test_static_downcast() {
+        #[derive(Default)]
+        struct Base(i32);
+        impl !Unpin for Base {}
+
+        #[derive(Default)]
+        #[repr(C)]
+        struct Derived {
+            other_field: u32,
+            base: Base,
+        }
+        impl Unpin for Derived {}
+
+        unsafe impl Inherits<Base> for Derived {
+            unsafe fn upcast_ptr(derived: *const Self) -> *const Base {
+                &(*derived).base
+            }
+        }
+        unsafe impl InheritsNonVirtually<Base> for Derived {
+            const BASE_OFFSET: isize = std::mem::offset_of!(Derived, base) as isize;
+        }
+
+        let mut derived = Derived { other_field: 7, base: Base(1) };
+        let derived_location = ptr_location(&derived);
+        let base: &Base = (&derived).upcast();
+        let downcast: &Derived = unsafe { base.static_downcast() };
+        assert_eq!(ptr_location(downcast), derived_location);
+        assert_eq!(downcast.other_field, 7);
+
+        let base: Pin<&mut Base> = (&mut derived).upcast();
+        let downcast: Pin<&mut Derived> = unsafe { base.static_downcast() };
+        unsafe { Pin::into_inner_unchecked(downcast).other_field = 42 };
+        assert_eq!(derived.other_field, 42);
+
+        let null: *const Derived = unsafe { std::ptr::null::<Base>().static_downcast() };
+        assert!(null.is_null());
+        let base: *mut Base = &mut derived.base;
+        let downcast: *mut Derived = unsafe { base.static_downcast() };
+        assert_eq!(downcast as usize, derived_location);
+
+        let improper: &Base = unsafe { (&derived.base).static_downcast() };
+        assert_eq!(improper.0, 1);
+    }
+
+    #[gtest]
+    fn test_dynamic_downcast() {
+        // Stand-ins for the vtables of the `Base` subobjects of a `Derived`
+        // and of an `Other`.
+        static DERIVED_VTABLE: u64 = 0;
+        static OTHER_VTABLE: u64 = 0;
+        static DYNAMIC_CASTS: std::sync::atomic::AtomicUsize =
+            std::sync::atomic::AtomicUsize::new(0);
+
+        #[repr(C)]
+        struct Base {
+            vptr: *const u64,
+        }
+        impl !Unpin for Base {}
+
+        #[repr(C)]
+        struct Derived {
+            other_field: u32,
+            base: Base,
+        }
+        impl Derived {
+            fn new() -> Self {
+                Derived { other_field: 7, base: Base { vptr: &DERIVED_VTABLE } }
+            }
+        }
+
+        unsafe impl Inherits<Base> for Derived {
+            unsafe fn upcast_ptr(derived: *const Self) -> *const Base {
+                &(*derived).base
+            }
+        }
+        unsafe impl InheritsDynamically<Base> for Derived {
+            unsafe fn dynamic_downcast_ptr(base: *const Base) -> *const Self {
+                static CACHE: DowncastCache = DowncastCache::new();
+                CACHE.downcast(base, |base| {
+                    DYNAMIC_CASTS.fetch_add(1, Ordering::Relaxed);
+                    if std::ptr::eq((*base).vptr, &DERIVED_VTABLE) {
+                        (base as *const u8).sub(std::mem::offset_of!(Derived, base))
+                            as *const Derived
+                    } else {
+                        std::ptr::null()
+                    }
+                })
+            }
+        }
+
+        let other = Base { vptr: &OTHER_VTABLE };
+        assert!(DynamicDowncast::<&Derived>::dynamic_downcast(&other).is_none());
+        assert_eq!(DYNAMIC_CASTS.load(Ordering::Relaxed), 1);
+
+        let first = Derived::new();
+        let mut second = Derived::new();
+        for derived in [&first, &second] {
+            let base: &Base = derived.upcast();
+            let downcast: &Derived = base.dynamic_downcast().unwrap();
+            assert_eq!(ptr_location(downcast), ptr_location(derived));
+        }
+        // The second downcast hits the cache.
+        assert_eq!(DYNAMIC_CASTS.load(Ordering::Relaxed), 2);
+
+        let base: Pin<&mut Base> = unsafe { Pin::new_unchecked(&mut second.base) };
+        let downcast: Pin<&mut Derived> = base.dynamic_downcast().unwrap();
+        unsafe { Pin::into_inner_unchecked(downcast).other_field = 42 };
+        assert_eq!(second.other_field, 42);
+        assert_eq!(DYNAMIC_CASTS.load(Ordering::Relaxed), 2);
+
+        // A miss doesn't evict the cached downcast.
+        assert!(DynamicDowncast::<&Derived>::dynamic_downcast(&other).is_none());
+        let _: &Derived = (&first.base).dynamic_downcast().unwrap();
+        assert_eq!(DYNAMIC_CASTS.load(Ordering::Relaxed), 3);
+    }
 }
@@ -0,0 +1,130 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDFUTURE_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDFUTURE_H_
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace rs_std {
+
+// `rs_std::BoxedFuture<T>` owns a boxed Rust future - e.g. the future returned
+// by an `async fn` with a `T` output, or `BoxedFuture<void>` for a `()` output.
+//
+// `BoxedFuture` doesn't run the future by itself: the C++ caller drives it
+// with `poll`, typically from its own event loop or executor. Each call runs
+// the future until it either completes, or has to wait (e.g. for I/O). In the
+// latter case, the Rust future arranges for the `wake` hook that was passed to
+// `poll` to be called once it can make progress, and the hook should then
+// schedule another `poll` (e.g. by posting a task to the executor). Many
+// futures can be multiplexed this way over a few threads, without blocking a
+// thread per future.
+//
+// `wake` may be called from any thread, possibly before `poll` returns, and
+// more than once. The Rust future may also keep copies of its waker (e.g. in a
+// timer or an I/O reactor) that outlive the call to `poll`, or even the future
+// itself, so each call to `poll` is also passed a `release` hook: `context`
+// must stay valid until `release(context)` is called. `release` is called
+// exactly once per call to `poll`, from any thread, once no copy of that
+// call's waker is left - before `poll` returns if the future didn't keep one.
+// `wake` isn't called for that `context` after `release`.
+//
+// The output is moved out of Rust bitwise, so `T` must not have drop glue in
+// Rust (and so, be trivially destructible in C++).
+//
+// `BoxedFuture` is move-only. It is created by the generated C++ bindings of
+// Rust functions, which initialize it in place (see the `__CrubitBoxedFuture`
+// struct in the thunks generated by `cc_bindings_from_rs`), so changing its
+// layout requires changing `cc_bindings_from_rs` as well.
+template <typename T>
+class BoxedFuture final {
+ public:
+  // Schedules another `poll` of the future.
+  using WakeFn = void (*)(void* context);
+  // Releases the `context` passed to `poll`, which `wake` won't be called
+  // with anymore.
+  using ReleaseFn = void (*)(void* context);
+  // The result of `poll`: the output if the future completed, or
+  // `std::nullopt` if it is still pending. For `BoxedFuture<void>`, whether
+  // the future completed.
+  using PollResult =
+      std::conditional_t<std::is_void_v<T>, bool, std::optional<T>>;
+
+  // Creates a default `BoxedFuture` - one that doesn't own a Rust future, and
+  // is `done()`.
+  constexpr BoxedFuture() noexcept = default;
+
+  BoxedFuture(const BoxedFuture&) = delete;
+  BoxedFuture& operator=(const BoxedFuture&) = delete;
+
+  BoxedFuture(BoxedFuture&& other) noexcept
+      : state_(std::exchange(other.state_, nullptr)),
+        poll_(std::exchange(other.poll_, nullptr)),
+        drop_(std::exchange(other.drop_, nullptr)) {}
+
+  BoxedFuture& operator=(BoxedFuture&& other) noexcept {
+    BoxedFuture tmp(std::move(other));
+    std::swap(state_, tmp.state_);
+    std::swap(poll_, tmp.poll_);
+    std::swap(drop_, tmp.drop_);
+    return *this;
+  }
+
+  ~BoxedFuture() { reset(); }
+
+  // Whether the future has completed (or was moved from), and so must not be
+  // polled anymore.
+  bool done() const { return state_ == nullptr; }
+
+  // Runs the future until it completes or has to wait. If it has to wait,
+  // `wake(context)` will be called once `poll` should be called again.
+  // `release(context)` is called once `wake(context)` can't be called anymore.
+  //
+  // Requires `!done()`. The Rust future is dropped as soon as it completes.
+  PollResult poll(WakeFn wake, ReleaseFn release, void* context) {
+    if constexpr (std::is_void_v<T>) {
+      if (!poll_(state_, nullptr, wake, release, context)) return false;
+      reset();
+      return true;
+    } else {
+      // The union (and the user-provided constructor and destructor) keep
+      // `output` from being initialized by C++.
+      union Output {
+        Output() {}
+        ~Output() {}
+        T value;
+      } output;
+      if (!poll_(state_, &output.value, wake, release, context)) {
+        return std::nullopt;
+      }
+      reset();
+      return std::move(output.value);
+    }
+  }
+
+ private:
+  // Polls the Rust future once. Returns true and moves the output into `out`
+  // if the future completed.
+  using PollFn = bool (*)(void* state, void* out, WakeFn wake,
+                          ReleaseFn release, void* context);
+  // Drops the Rust future.
+  using DropFn = void (*)(void* state);
+
+  void reset() {
+    if (state_ != nullptr) drop_(std::exchange(state_, nullptr));
+  }
+
+  // Stick to the following invariant when changing the data member values:
+  // if `state_` is not null, then it points to a pending Rust future owned by
+  // this `BoxedFuture`, which `poll_` polls and `drop_` drops.
+  void* state_ = nullptr;
+  PollFn poll_ = nullptr;
+  DropFn drop_ = nullptr;
+};
+
+}  // namespace rs_std
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDFUTURE_H_
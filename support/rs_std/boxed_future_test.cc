@@ -0,0 +1,166 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/boxed_future.h"
+
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "support/internal/return_value_slot.h"
+
+namespace {
+
+static_assert(!std::is_copy_constructible_v<rs_std::BoxedFuture<int>>);
+static_assert(!std::is_copy_assignable_v<rs_std::BoxedFuture<int>>);
+static_assert(std::is_nothrow_move_constructible_v<rs_std::BoxedFuture<int>>);
+static_assert(std::is_nothrow_move_assignable_v<rs_std::BoxedFuture<int>>);
+
+// The generated thunks initialize `BoxedFuture`s in place, with a struct that
+// has the following layout (see `__CrubitBoxedFuture` in
+// `cc_bindings_from_rs/bindings.rs`).
+struct BoxedFutureFields {
+  void* state;
+  bool (*poll)(void* state, void* out, void (*wake)(void* context),
+               void (*release)(void* context), void* context);
+  void (*drop)(void* state);
+};
+static_assert(sizeof(rs_std::BoxedFuture<int>) == sizeof(BoxedFutureFields));
+static_assert(alignof(rs_std::BoxedFuture<int>) == alignof(BoxedFutureFields));
+static_assert(std::is_standard_layout_v<rs_std::BoxedFuture<int>>);
+
+// Stands in for a Rust future that is pending for `polls_until_ready` polls,
+// and then completes with `output`. It wakes its waker right away whenever it
+// is pending, and doesn't keep it, so each poll releases its context before
+// returning.
+struct FakeRustFuture {
+  int polls_until_ready = 0;
+  int output = 0;
+};
+int drop_count = 0;
+int poll_count = 0;
+
+bool FakeRustPoll(void* state, void* out, void (*wake)(void* context),
+                  void (*release)(void* context), void* context) {
+  ++poll_count;
+  auto* future = static_cast<FakeRustFuture*>(state);
+  if (future->polls_until_ready-- > 0) {
+    wake(context);
+    release(context);
+    return false;
+  }
+  if (out != nullptr) *static_cast<int*>(out) = future->output;
+  release(context);
+  return true;
+}
+
+void FakeRustDrop(void* state) {
+  ++drop_count;
+  delete static_cast<FakeRustFuture*>(state);
+}
+
+// Mimics the generated C++ bindings of an `async fn` that returns `T` (an
+// `int` or `()`).
+template <typename T>
+rs_std::BoxedFuture<T> MakeFuture(int polls_until_ready, int output) {
+  crubit::ReturnValueSlot<rs_std::BoxedFuture<T>> slot;
+  const BoxedFutureFields fields = {
+      new FakeRustFuture{polls_until_ready, output}, FakeRustPoll,
+      FakeRustDrop};
+  std::memcpy(static_cast<void*>(slot.Get()), &fields, sizeof(fields));
+  return std::move(slot).AssumeInitAndTakeValue();
+}
+
+// A minimal executor: `wake` queues the future to be polled again.
+struct Executor {
+  static void Wake(void* context) {
+    auto* executor = static_cast<Executor*>(context);
+    executor->queue.push_back(executor->future);
+  }
+
+  static void Release(void* context) {
+    if (context != nullptr) ++static_cast<Executor*>(context)->release_count;
+  }
+
+  rs_std::BoxedFuture<int>* future = nullptr;
+  std::deque<rs_std::BoxedFuture<int>*> queue;
+  int release_count = 0;
+};
+
+class BoxedFutureTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    drop_count = 0;
+    poll_count = 0;
+  }
+};
+
+TEST_F(BoxedFutureTest, Default) {
+  rs_std::BoxedFuture<int> future;
+  EXPECT_TRUE(future.done());
+}
+
+TEST_F(BoxedFutureTest, Ready) {
+  rs_std::BoxedFuture<int> future = MakeFuture<int>(0, 42);
+  EXPECT_FALSE(future.done());
+  EXPECT_EQ(future.poll(Executor::Wake, Executor::Release, nullptr), 42);
+  EXPECT_TRUE(future.done());
+  // The Rust future is dropped as soon as it completes.
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedFutureTest, DrivenByWake) {
+  rs_std::BoxedFuture<int> future = MakeFuture<int>(2, 42);
+  Executor executor;
+  executor.future = &future;
+  executor.queue.push_back(&future);
+  std::optional<int> output;
+  while (!executor.queue.empty()) {
+    rs_std::BoxedFuture<int>* next = executor.queue.front();
+    executor.queue.pop_front();
+    output = next->poll(Executor::Wake, Executor::Release, &executor);
+  }
+  EXPECT_EQ(output, 42);
+  EXPECT_EQ(poll_count, 3);
+  EXPECT_EQ(drop_count, 1);
+  // Each poll releases its context once.
+  EXPECT_EQ(executor.release_count, 3);
+}
+
+TEST_F(BoxedFutureTest, Void) {
+  rs_std::BoxedFuture<void> future = MakeFuture<void>(1, 0);
+  Executor executor;
+  EXPECT_FALSE(future.poll(Executor::Wake, Executor::Release, &executor));
+  EXPECT_TRUE(future.poll(Executor::Wake, Executor::Release, &executor));
+  EXPECT_TRUE(future.done());
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedFutureTest, DropsPendingFuture) {
+  {
+    rs_std::BoxedFuture<int> future = MakeFuture<int>(1, 42);
+    Executor executor;
+    EXPECT_EQ(future.poll(Executor::Wake, Executor::Release, &executor),
+              std::nullopt);
+    EXPECT_EQ(drop_count, 0);
+  }
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedFutureTest, Move) {
+  rs_std::BoxedFuture<int> future = MakeFuture<int>(0, 1);
+  rs_std::BoxedFuture<int> moved = std::move(future);
+  EXPECT_TRUE(future.done());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(moved.poll(Executor::Wake, Executor::Release, nullptr), 1);
+
+  rs_std::BoxedFuture<int> assigned = MakeFuture<int>(0, 2);
+  assigned = MakeFuture<int>(0, 3);
+  EXPECT_EQ(drop_count, 2);
+  EXPECT_EQ(assigned.poll(Executor::Wake, Executor::Release, nullptr), 3);
+}
+
+}  // namespace
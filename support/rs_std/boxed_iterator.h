@@ -0,0 +1,167 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDITERATOR_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDITERATOR_H_
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace rs_std {
+
+// `rs_std::BoxedIterator<T>` is a C++ input range over the items of a boxed
+// Rust iterator - e.g. of a `Box<dyn Iterator<Item = T>>` returned by a Rust
+// function. Instead of calling into Rust for every item, `BoxedIterator` pulls
+// up to `kBatchSize` items at a time into a C++-side buffer, so that iterating
+// costs one (non-inlinable) call per batch. It drops the Rust iterator when it
+// is destroyed, or as soon as the Rust iterator is exhausted.
+//
+// The items are moved out of Rust bitwise, so `T` must not have drop glue in
+// Rust (and so, be trivially destructible in C++). Items that are pulled into
+// the buffer but never read are simply discarded.
+//
+// Iteration stops at the first `None` returned by the Rust iterator, even if
+// the iterator isn't `FusedIterator`.
+//
+// `BoxedIterator` is move-only. It is created by the generated C++ bindings of
+// Rust functions, which initialize it in place (see the `__CrubitBoxedIterator`
+// struct in the thunks generated by `cc_bindings_from_rs`), so changing its
+// layout requires changing `cc_bindings_from_rs` as well.
+template <typename T>
+class BoxedIterator final {
+ public:
+  // The maximum number of items pulled from Rust at a time.
+  static constexpr size_t kBatchSize = 64;
+
+  // An input iterator over the remaining items of a `BoxedIterator`. All the
+  // iterators of a `BoxedIterator` share its position: incrementing one of
+  // them consumes the current item.
+  class iterator final {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // Creates the end iterator.
+    iterator() = default;
+
+    T& operator*() const { return range_->batch_->current(); }
+    T* operator->() const { return &range_->batch_->current(); }
+
+    iterator& operator++() {
+      ++range_->batch_->pos;
+      if (!range_->fill()) range_ = nullptr;
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.range_ == b.range_;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return !(a == b);
+    }
+
+   private:
+    friend class BoxedIterator;
+    explicit iterator(BoxedIterator* range) : range_(range) {}
+
+    // Null for the end iterator, and for iterators that ran past the last
+    // item.
+    BoxedIterator* range_ = nullptr;
+  };
+
+  // Creates a default `BoxedIterator` - an empty range that doesn't own a Rust
+  // iterator.
+  constexpr BoxedIterator() noexcept = default;
+
+  BoxedIterator(const BoxedIterator&) = delete;
+  BoxedIterator& operator=(const BoxedIterator&) = delete;
+
+  BoxedIterator(BoxedIterator&& other) noexcept
+      : state_(std::exchange(other.state_, nullptr)),
+        next_batch_(std::exchange(other.next_batch_, nullptr)),
+        drop_(std::exchange(other.drop_, nullptr)),
+        batch_(std::exchange(other.batch_, nullptr)) {}
+
+  BoxedIterator& operator=(BoxedIterator&& other) noexcept {
+    BoxedIterator tmp(std::move(other));
+    std::swap(state_, tmp.state_);
+    std::swap(next_batch_, tmp.next_batch_);
+    std::swap(drop_, tmp.drop_);
+    std::swap(batch_, tmp.batch_);
+    return *this;
+  }
+
+  ~BoxedIterator() {
+    release();
+    delete batch_;
+  }
+
+  iterator begin() { return iterator(fill() ? this : nullptr); }
+  iterator end() { return iterator(); }
+
+  // Returns the next item, or `std::nullopt` if there are no more items.
+  std::optional<T> next() {
+    if (!fill()) return std::nullopt;
+    return std::move(batch_->items[batch_->pos++]);
+  }
+
+ private:
+  // Moves up to `capacity` items of the Rust iterator into `out`, and returns
+  // how many it moved. Returning fewer than `capacity` items means that the
+  // Rust iterator is exhausted.
+  using NextBatchFn = size_t (*)(void* state, T* out, size_t capacity);
+  // Drops the Rust iterator.
+  using DropFn = void (*)(void* state);
+
+  // The items pulled from Rust that haven't been consumed yet: `items[pos]`
+  // through `items[size - 1]`. The union (and the user-provided constructor)
+  // keep `items` from being default-constructed.
+  struct Batch {
+    Batch() {}
+    T& current() { return items[pos]; }
+
+    size_t pos = 0;
+    size_t size = 0;
+    union {
+      T items[kBatchSize];
+    };
+  };
+
+  // Makes sure that the buffer holds the current item, pulling the next batch
+  // from Rust if needed. Returns false if there are no more items.
+  bool fill() {
+    if (batch_ != nullptr && batch_->pos < batch_->size) return true;
+    if (state_ == nullptr) return false;
+    if (batch_ == nullptr) batch_ = new Batch();
+    batch_->pos = 0;
+    batch_->size = next_batch_(state_, batch_->items, kBatchSize);
+    if (batch_->size < kBatchSize) release();
+    return batch_->size > 0;
+  }
+
+  void release() {
+    if (state_ != nullptr) drop_(std::exchange(state_, nullptr));
+  }
+
+  // Stick to the following invariant when changing the data member values:
+  // if `state_` is not null, then it points to a Rust iterator owned by this
+  // `BoxedIterator`, which `next_batch_` advances and `drop_` drops.
+  //
+  // The Rust thunk initializes `batch_` to null; it is allocated when the
+  // first batch is pulled.
+  void* state_ = nullptr;
+  NextBatchFn next_batch_ = nullptr;
+  DropFn drop_ = nullptr;
+  Batch* batch_ = nullptr;
+};
+
+}  // namespace rs_std
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_BOXEDITERATOR_H_
@@ -0,0 +1,155 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/boxed_iterator.h"
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "support/internal/return_value_slot.h"
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+static_assert(!std::is_copy_constructible_v<rs_std::BoxedIterator<int>>);
+static_assert(!std::is_copy_assignable_v<rs_std::BoxedIterator<int>>);
+static_assert(std::is_nothrow_move_constructible_v<rs_std::BoxedIterator<int>>);
+static_assert(std::is_nothrow_move_assignable_v<rs_std::BoxedIterator<int>>);
+
+// The generated thunks initialize `BoxedIterator`s in place, with a struct that
+// has the following layout (see `__CrubitBoxedIterator` in
+// `cc_bindings_from_rs/bindings.rs`).
+template <typename T>
+struct BoxedIteratorFields {
+  void* state;
+  size_t (*next_batch)(void* state, T* out, size_t capacity);
+  void (*drop)(void* state);
+  void* batch;
+};
+static_assert(sizeof(rs_std::BoxedIterator<int>) ==
+              sizeof(BoxedIteratorFields<int>));
+static_assert(alignof(rs_std::BoxedIterator<int>) ==
+              alignof(BoxedIteratorFields<int>));
+static_assert(std::is_standard_layout_v<rs_std::BoxedIterator<int>>);
+
+// Stands in for a Rust iterator over `0..size` in the tests below.
+struct FakeRustRange {
+  int next = 0;
+  int size = 0;
+};
+int drop_count = 0;
+int next_batch_count = 0;
+
+size_t FakeRustNextBatch(void* state, int* out, size_t capacity) {
+  ++next_batch_count;
+  auto* range = static_cast<FakeRustRange*>(state);
+  size_t n = 0;
+  while (n < capacity && range->next < range->size) out[n++] = range->next++;
+  return n;
+}
+
+void FakeRustDrop(void* state) {
+  ++drop_count;
+  delete static_cast<FakeRustRange*>(state);
+}
+
+// Mimics the generated C++ bindings of a Rust function returning a
+// `Box<dyn Iterator<Item = i32>>` over `0..size`.
+rs_std::BoxedIterator<int> MakeRange(int size) {
+  crubit::ReturnValueSlot<rs_std::BoxedIterator<int>> slot;
+  const BoxedIteratorFields<int> fields = {new FakeRustRange{0, size},
+                                           FakeRustNextBatch, FakeRustDrop,
+                                           nullptr};
+  std::memcpy(static_cast<void*>(slot.Get()), &fields, sizeof(fields));
+  return std::move(slot).AssumeInitAndTakeValue();
+}
+
+std::vector<int> Collect(rs_std::BoxedIterator<int>& range) {
+  std::vector<int> items;
+  for (int item : range) items.push_back(item);
+  return items;
+}
+
+class BoxedIteratorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    drop_count = 0;
+    next_batch_count = 0;
+  }
+};
+
+TEST_F(BoxedIteratorTest, Default) {
+  rs_std::BoxedIterator<int> range;
+  EXPECT_THAT(Collect(range), IsEmpty());
+  EXPECT_EQ(range.next(), std::nullopt);
+}
+
+TEST_F(BoxedIteratorTest, Empty) {
+  {
+    rs_std::BoxedIterator<int> range = MakeRange(0);
+    EXPECT_EQ(range.begin(), range.end());
+    EXPECT_EQ(drop_count, 1);
+  }
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedIteratorTest, PullsItemsInBatches) {
+  constexpr int kSize = 2 * rs_std::BoxedIterator<int>::kBatchSize + 1;
+  rs_std::BoxedIterator<int> range = MakeRange(kSize);
+  EXPECT_EQ(next_batch_count, 0);
+
+  std::vector<int> items = Collect(range);
+  ASSERT_EQ(items.size(), kSize);
+  for (int i = 0; i < kSize; ++i) EXPECT_EQ(items[i], i);
+  EXPECT_EQ(next_batch_count, 3);
+  // The Rust iterator is dropped as soon as it runs out of items.
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedIteratorTest, Next) {
+  rs_std::BoxedIterator<int> range = MakeRange(2);
+  EXPECT_EQ(range.next(), 0);
+  EXPECT_EQ(range.next(), 1);
+  EXPECT_EQ(range.next(), std::nullopt);
+  EXPECT_EQ(next_batch_count, 1);
+}
+
+TEST_F(BoxedIteratorTest, NextAndIterationShareThePosition) {
+  rs_std::BoxedIterator<int> range = MakeRange(4);
+  EXPECT_EQ(range.next(), 0);
+  EXPECT_THAT(Collect(range), ElementsAre(1, 2, 3));
+}
+
+TEST_F(BoxedIteratorTest, DropsUnfinishedIterator) {
+  constexpr int kSize = 2 * rs_std::BoxedIterator<int>::kBatchSize;
+  {
+    rs_std::BoxedIterator<int> range = MakeRange(kSize);
+    EXPECT_EQ(range.next(), 0);
+    EXPECT_EQ(drop_count, 0);
+  }
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(BoxedIteratorTest, Move) {
+  rs_std::BoxedIterator<int> range = MakeRange(3);
+  EXPECT_EQ(range.next(), 0);
+
+  rs_std::BoxedIterator<int> moved = std::move(range);
+  EXPECT_THAT(Collect(range), IsEmpty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_THAT(Collect(moved), ElementsAre(1, 2));
+
+  rs_std::BoxedIterator<int> assigned = MakeRange(1);
+  assigned = MakeRange(2);
+  EXPECT_EQ(drop_count, 2);
+  EXPECT_THAT(Collect(assigned), ElementsAre(0, 1));
+}
+
+}  // namespace
@@ -0,0 +1,122 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_DYNCALLBACK_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_DYNCALLBACK_H_
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace rs_std {
+namespace internal {
+
+// Whether a `DynFnMut` or `DynFn` of type `Self` can refer to a callable of
+// type `F`. Functions have to be passed as function pointers instead, because
+// `void*` can't point to a function.
+template <typename Self, typename F>
+constexpr bool kCanReferTo =
+    !std::is_same_v<std::remove_cv_t<std::remove_reference_t<F>>, Self> &&
+    !std::is_function_v<std::remove_reference_t<F>>;
+
+}  // namespace internal
+
+// `rs_std::DynFnMut<R(Args...)>` is a non-owning reference to a C++ callable
+// (e.g. a lambda), which is passed to a Rust function that takes a
+// `&mut dyn FnMut(Args...) -> R` parameter.
+//
+// It holds a pointer to the callable, and a pointer to a function that invokes
+// it, so the callable is neither copied nor allocated, and each call from Rust
+// is a single indirect call. The callable must outlive the `DynFnMut`, which in
+// practice means that `DynFnMut` should only be used as the type of a function
+// parameter:
+//
+// ```c++
+// int total = 0;
+// rust_crate::for_each_item([&](std::int32_t item) { total += item; });
+// ```
+//
+// The callable must not throw: an exception that would escape into Rust
+// terminates the program instead.
+//
+// The generated thunks of the Rust functions read the pointers out of the
+// `DynFnMut` (see the `__CrubitDynCallback` struct in the thunks generated by
+// `cc_bindings_from_rs`), so changing its layout requires changing
+// `cc_bindings_from_rs` as well.
+template <typename Signature>
+class DynFnMut;
+
+template <typename R, typename... Args>
+class DynFnMut<R(Args...)> final {
+ public:
+  // Invokes `callable` - a pointer to the C++ callable.
+  using InvokeFn = R (*)(void* callable, Args... args);
+
+  template <typename F,
+            typename = std::enable_if_t<
+                internal::kCanReferTo<DynFnMut, F> &&
+                std::is_invocable_r_v<R, std::remove_reference_t<F>&, Args...>>>
+  DynFnMut(F&& f) noexcept  // NOLINT(google-explicit-constructor)
+      : callable_(const_cast<void*>(
+            static_cast<const void*>(std::addressof(f)))),
+        invoke_([](void* callable, Args... args) noexcept -> R {
+          return std::invoke(
+              *static_cast<std::remove_reference_t<F>*>(callable),
+              std::forward<Args>(args)...);
+        }) {}
+
+  DynFnMut(const DynFnMut&) = default;
+  DynFnMut& operator=(const DynFnMut&) = default;
+
+  R operator()(Args... args) const {
+    return invoke_(callable_, std::forward<Args>(args)...);
+  }
+
+ private:
+  void* callable_;
+  InvokeFn invoke_;
+};
+
+// `rs_std::DynFn<R(Args...)>` is like `rs_std::DynFnMut<R(Args...)>`, but for
+// Rust functions that take a `&dyn Fn(Args...) -> R` parameter: it only calls
+// the C++ callable through a `const` reference.
+template <typename Signature>
+class DynFn;
+
+template <typename R, typename... Args>
+class DynFn<R(Args...)> final {
+ public:
+  // Invokes `callable` - a pointer to the C++ callable.
+  using InvokeFn = R (*)(void* callable, Args... args);
+
+  template <typename F,
+            typename = std::enable_if_t<
+                internal::kCanReferTo<DynFn, F> &&
+                std::is_invocable_r_v<R, const std::remove_reference_t<F>&,
+                                      Args...>>>
+  DynFn(F&& f) noexcept  // NOLINT(google-explicit-constructor)
+      : callable_(const_cast<void*>(
+            static_cast<const void*>(std::addressof(f)))),
+        invoke_([](void* callable, Args... args) noexcept -> R {
+          return std::invoke(
+              *static_cast<const std::remove_reference_t<F>*>(callable),
+              std::forward<Args>(args)...);
+        }) {}
+
+  DynFn(const DynFn&) = default;
+  DynFn& operator=(const DynFn&) = default;
+
+  R operator()(Args... args) const {
+    return invoke_(callable_, std::forward<Args>(args)...);
+  }
+
+ private:
+  void* callable_;
+  InvokeFn invoke_;
+};
+
+}  // namespace rs_std
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_DYNCALLBACK_H_
@@ -0,0 +1,124 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/dyn_callback.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<rs_std::DynFnMut<int(int)>>);
+static_assert(std::is_trivially_destructible_v<rs_std::DynFnMut<int(int)>>);
+static_assert(std::is_trivially_copyable_v<rs_std::DynFn<int(int)>>);
+static_assert(std::is_trivially_destructible_v<rs_std::DynFn<int(int)>>);
+
+// The generated thunks read the callable and its invoker out of a `DynFnMut` or
+// a `DynFn`, with a struct that has the following layout (see
+// `__CrubitDynCallback` in `cc_bindings_from_rs/bindings.rs`).
+struct DynCallbackFields {
+  void* callable;
+  int (*invoke)(void* callable, int arg);
+};
+static_assert(sizeof(rs_std::DynFnMut<int(int)>) == sizeof(DynCallbackFields));
+static_assert(alignof(rs_std::DynFnMut<int(int)>) ==
+              alignof(DynCallbackFields));
+static_assert(std::is_standard_layout_v<rs_std::DynFnMut<int(int)>>);
+static_assert(sizeof(rs_std::DynFn<int(int)>) == sizeof(DynCallbackFields));
+static_assert(alignof(rs_std::DynFn<int(int)>) == alignof(DynCallbackFields));
+static_assert(std::is_standard_layout_v<rs_std::DynFn<int(int)>>);
+
+// Only callables that are invocable with the right signature convert.
+static_assert(
+    std::is_convertible_v<int (*)(int), rs_std::DynFnMut<int(int)>>);
+static_assert(
+    !std::is_convertible_v<int (*)(int, int), rs_std::DynFnMut<int(int)>>);
+struct MutableOnly {
+  int operator()(int x) { return x; }
+};
+static_assert(std::is_convertible_v<MutableOnly&, rs_std::DynFnMut<int(int)>>);
+static_assert(!std::is_convertible_v<int (&)(int), rs_std::DynFn<int(int)>>);
+static_assert(!std::is_convertible_v<MutableOnly&, rs_std::DynFn<int(int)>>);
+
+// Mimics the generated thunk of a Rust function that calls `callback` for each
+// of `0..n`.
+template <typename Callback>
+void ForEachIndex(const Callback* callback, int n) {
+  DynCallbackFields fields;
+  std::memcpy(&fields, static_cast<const void*>(callback), sizeof(fields));
+  for (int i = 0; i < n; ++i) fields.invoke(fields.callable, i);
+}
+
+TEST(DynCallbackTest, DynFnMutCallsTheCallableInPlace) {
+  int sum = 0;
+  int calls = 0;
+  auto add = [&sum, &calls](int x) {
+    sum += x;
+    return ++calls;
+  };
+  rs_std::DynFnMut<int(int)> callback = add;
+  ForEachIndex(&callback, 4);
+  EXPECT_EQ(sum, 6);
+  EXPECT_EQ(calls, 4);
+  EXPECT_EQ(callback(10), 5);
+  EXPECT_EQ(sum, 16);
+}
+
+TEST(DynCallbackTest, DynFnMutOfMutableLambda) {
+  int last = 0;
+  auto counter = [count = 0, &last](int) mutable {
+    last = ++count;
+    return count;
+  };
+  rs_std::DynFnMut<int(int)> callback = counter;
+  ForEachIndex(&callback, 3);
+  EXPECT_EQ(last, 3);
+  // The lambda is called in place, rather than a copy of it.
+  EXPECT_EQ(counter(0), 4);
+}
+
+TEST(DynCallbackTest, DynFn) {
+  int sum = 0;
+  const auto add = [&sum](int x) {
+    sum += x;
+    return sum;
+  };
+  rs_std::DynFn<int(int)> callback = add;
+  ForEachIndex(&callback, 4);
+  EXPECT_EQ(sum, 6);
+}
+
+int Square(int x) { return x * x; }
+
+TEST(DynCallbackTest, FunctionPointer) {
+  int (*square)(int) = Square;
+  rs_std::DynFn<int(int)> callback = square;
+  EXPECT_EQ(callback(3), 9);
+}
+
+TEST(DynCallbackTest, VoidResult) {
+  int sum = 0;
+  auto add = [&sum](int x) { sum += x; };
+  rs_std::DynFnMut<void(int)> callback = add;
+  callback(1);
+  callback(2);
+  EXPECT_EQ(sum, 3);
+}
+
+TEST(DynCallbackTest, CopyRefersToTheSameCallable) {
+  int sum = 0;
+  auto add = [&sum](int x) {
+    sum += x;
+    return sum;
+  };
+  rs_std::DynFnMut<int(int)> callback = add;
+  rs_std::DynFnMut<int(int)> copy = callback;
+  callback(1);
+  copy(2);
+  EXPECT_EQ(sum, 3);
+}
+
+}  // namespace
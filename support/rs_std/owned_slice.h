@@ -0,0 +1,142 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_OWNEDSLICE_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_OWNEDSLICE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "absl/types/span.h"
+#include "support/rs_std/slice_ref.h"
+#include "support/rs_std/str_ref.h"
+
+namespace rs_std {
+
+// `rs_std::OwnedSlice<T>` is a C++ representation of an owned, heap-allocated
+// Rust buffer of `T`s - e.g. of a `Vec<T>` returned by a Rust function. The
+// elements are not copied when the buffer crosses from Rust into C++: instead,
+// `OwnedSlice` takes over the allocation, and hands it back to Rust (which
+// frees it with the Rust allocator) when it is destroyed.
+//
+// `OwnedSlice` is move-only. It is created by the generated C++ bindings of
+// Rust functions, which initialize it in place (see the `__CrubitOwnedSlice`
+// struct in the thunks generated by `cc_bindings_from_rs`), so changing its
+// layout requires changing `cc_bindings_from_rs` as well.
+template <typename T>
+class OwnedSlice final {
+ public:
+  // Creates a default `OwnedSlice` - one that represents an empty buffer that
+  // doesn't own any allocation. To mirror slices in Rust, the data pointer is
+  // not null.
+  constexpr OwnedSlice() noexcept = default;
+
+  OwnedSlice(const OwnedSlice&) = delete;
+  OwnedSlice& operator=(const OwnedSlice&) = delete;
+
+  OwnedSlice(OwnedSlice&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, alignof(T))),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        drop_(std::exchange(other.drop_, nullptr)) {}
+
+  OwnedSlice& operator=(OwnedSlice&& other) noexcept {
+    OwnedSlice tmp(std::move(other));
+    std::swap(ptr_, tmp.ptr_);
+    std::swap(size_, tmp.size_);
+    std::swap(capacity_, tmp.capacity_);
+    std::swap(drop_, tmp.drop_);
+    return *this;
+  }
+
+  ~OwnedSlice() {
+    if (drop_ != nullptr) {
+      drop_(reinterpret_cast<T*>(ptr_), size_, capacity_);
+    }
+  }
+
+  // The `reinterpret_cast`s are safe thanks to invariant (2) (see the
+  // definition of `ptr_`).
+  T* data() { return size_ > 0 ? reinterpret_cast<T*>(ptr_) : nullptr; }
+  const T* data() const {
+    return size_ > 0 ? reinterpret_cast<const T*>(ptr_) : nullptr;
+  }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size_; }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size_; }
+
+  T& operator[](size_t i) { return data()[i]; }
+  const T& operator[](size_t i) const { return data()[i]; }
+
+  absl::Span<T> to_span() { return absl::Span<T>(data(), size()); }
+  absl::Span<const T> to_span() const {
+    return absl::Span<const T>(data(), size());
+  }
+
+  // Borrows the elements, e.g. to pass them back to Rust as a `&[T]`.
+  SliceRef<const T> as_slice_ref() const { return to_span(); }
+
+ private:
+  // Frees the allocation (`Vec::from_raw_parts(ptr, size, capacity)` on the
+  // Rust side).
+  using DropFn = void (*)(T* ptr, size_t size, size_t capacity);
+
+  // Stick to the following invariants when changing the data member values:
+  // (1) `ptr_` is never 0 (to mirror slices in Rust).
+  // (2) if `size_ > 0` then `reinterpret_cast<T*>(ptr_)` is a valid pointer to
+  //     `size_` elements.
+  // (3) if `drop_` is not null, then `ptr_`, `size_` and `capacity_` describe
+  //     an allocation owned by this `OwnedSlice`, which `drop_` frees.
+  uintptr_t ptr_ = alignof(T);
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  DropFn drop_ = nullptr;
+};
+
+// `rs_std::OwnedStr` is a C++ representation of an owned Rust `String`
+// returned by a Rust function. Like `rs_std::OwnedSlice`, it takes over the
+// allocation of the string (instead of copying it) and hands it back to Rust
+// when it is destroyed. It converts to `std::string_view` and to
+// `rs_std::StrRef` without copying.
+//
+// `OwnedStr` is move-only, and it only gives `const` access to its contents, to
+// preserve the guarantee that they are valid UTF-8.
+class OwnedStr final {
+ public:
+  // Creates a default `OwnedStr` - one that represents an empty string.
+  constexpr OwnedStr() noexcept = default;
+
+  OwnedStr(OwnedStr&&) noexcept = default;
+  OwnedStr& operator=(OwnedStr&&) noexcept = default;
+  ~OwnedStr() = default;
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  operator std::string_view() const { return to_string_view(); }
+
+  const char* data() const { return bytes_.data(); }
+  size_t size() const { return bytes_.size(); }
+  bool empty() const { return bytes_.empty(); }
+
+  std::string_view to_string_view() const {
+    return std::string_view(data(), size());
+  }
+
+  // Borrows the string, e.g. to pass it back to Rust as a `&str`.
+  StrRef as_str_ref() const {
+    return StrRef::from_utf8_unchecked(to_string_view());
+  }
+
+ private:
+  OwnedSlice<char> bytes_;
+};
+
+}  // namespace rs_std
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_OWNEDSLICE_H_
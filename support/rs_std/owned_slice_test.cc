@@ -0,0 +1,141 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/owned_slice.h"
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "support/internal/return_value_slot.h"
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+static_assert(!std::is_copy_constructible_v<rs_std::OwnedSlice<int>>);
+static_assert(!std::is_copy_assignable_v<rs_std::OwnedSlice<int>>);
+static_assert(std::is_nothrow_move_constructible_v<rs_std::OwnedSlice<int>>);
+static_assert(std::is_nothrow_move_assignable_v<rs_std::OwnedSlice<int>>);
+static_assert(!std::is_copy_constructible_v<rs_std::OwnedStr>);
+static_assert(std::is_nothrow_move_constructible_v<rs_std::OwnedStr>);
+static_assert(std::is_convertible_v<const rs_std::OwnedStr&, std::string_view>);
+
+// The generated thunks initialize `OwnedSlice`s and `OwnedStr`s in place, with
+// a struct that has the following layout (see `__CrubitOwnedSlice` in
+// `cc_bindings_from_rs/bindings.rs`).
+template <typename T>
+struct OwnedSliceFields {
+  T* ptr;
+  size_t size;
+  size_t capacity;
+  void (*drop)(T* ptr, size_t size, size_t capacity);
+};
+static_assert(sizeof(rs_std::OwnedSlice<int>) ==
+              sizeof(OwnedSliceFields<int>));
+static_assert(alignof(rs_std::OwnedSlice<int>) ==
+              alignof(OwnedSliceFields<int>));
+static_assert(std::is_standard_layout_v<rs_std::OwnedSlice<int>>);
+static_assert(sizeof(rs_std::OwnedStr) == sizeof(OwnedSliceFields<char>));
+static_assert(alignof(rs_std::OwnedStr) == alignof(OwnedSliceFields<char>));
+static_assert(std::is_standard_layout_v<rs_std::OwnedStr>);
+
+// Stands in for the allocation of a Rust `Vec` in the tests below.
+int drop_count = 0;
+int* dropped_ptr = nullptr;
+size_t dropped_capacity = 0;
+
+void FakeRustDrop(int* ptr, size_t size, size_t capacity) {
+  ++drop_count;
+  dropped_ptr = ptr;
+  dropped_capacity = capacity;
+}
+
+void FakeRustDropStr(char* ptr, size_t size, size_t capacity) {
+  ++drop_count;
+}
+
+// Mimics the generated C++ bindings of a Rust function returning a `Vec` or a
+// `String`.
+template <typename Owned, typename T>
+Owned MakeOwned(T* ptr, size_t size, size_t capacity,
+                void (*drop)(T*, size_t, size_t)) {
+  crubit::ReturnValueSlot<Owned> slot;
+  const OwnedSliceFields<T> fields = {ptr, size, capacity, drop};
+  std::memcpy(static_cast<void*>(slot.Get()), &fields, sizeof(fields));
+  return std::move(slot).AssumeInitAndTakeValue();
+}
+
+class OwnedSliceTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    drop_count = 0;
+    dropped_ptr = nullptr;
+    dropped_capacity = 0;
+  }
+};
+
+TEST_F(OwnedSliceTest, DefaultConstructedIsEmpty) {
+  {
+    rs_std::OwnedSlice<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.data(), nullptr);
+    EXPECT_THAT(empty.to_span(), IsEmpty());
+  }
+  EXPECT_EQ(drop_count, 0);
+}
+
+TEST_F(OwnedSliceTest, AccessAndDrop) {
+  int buffer[4] = {1, 2, 3, 0};
+  {
+    rs_std::OwnedSlice<int> owned =
+        MakeOwned<rs_std::OwnedSlice<int>>(buffer, 3, 4, &FakeRustDrop);
+    EXPECT_EQ(drop_count, 0);
+    EXPECT_EQ(owned.size(), 3);
+    EXPECT_EQ(owned.data(), buffer);
+    EXPECT_THAT(owned.to_span(), ElementsAre(1, 2, 3));
+    owned[0] = 42;
+    EXPECT_THAT(owned.as_slice_ref().to_span(), ElementsAre(42, 2, 3));
+  }
+  EXPECT_EQ(drop_count, 1);
+  EXPECT_EQ(dropped_ptr, buffer);
+  EXPECT_EQ(dropped_capacity, 4);
+}
+
+TEST_F(OwnedSliceTest, MoveTransfersOwnership) {
+  int buffer[2] = {1, 2};
+  {
+    rs_std::OwnedSlice<int> owned =
+        MakeOwned<rs_std::OwnedSlice<int>>(buffer, 2, 2, &FakeRustDrop);
+    rs_std::OwnedSlice<int> moved = std::move(owned);
+    EXPECT_TRUE(owned.empty());  // NOLINT(bugprone-use-after-move)
+    EXPECT_THAT(moved.to_span(), ElementsAre(1, 2));
+
+    rs_std::OwnedSlice<int> assigned;
+    assigned = std::move(moved);
+    EXPECT_THAT(assigned.to_span(), ElementsAre(1, 2));
+    EXPECT_EQ(drop_count, 0);
+  }
+  EXPECT_EQ(drop_count, 1);
+}
+
+TEST_F(OwnedSliceTest, OwnedStr) {
+  char buffer[] = "hello";
+  {
+    rs_std::OwnedStr owned =
+        MakeOwned<rs_std::OwnedStr>(buffer, 5, 6, &FakeRustDropStr);
+    EXPECT_EQ(std::string_view(owned), "hello");
+    EXPECT_EQ(owned.as_str_ref().to_string_view(), "hello");
+    EXPECT_EQ(owned.data(), buffer);
+  }
+  EXPECT_EQ(drop_count, 1);
+}
+
+}  // namespace
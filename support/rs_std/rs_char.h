@@ -12,6 +12,21 @@
 #include "support/internal/attribute_macros.h"
 
 namespace rs_std {
+namespace internal {
+
+// Returns whether `value` is a valid Rust `char`, i.e. neither above
+// `char::MAX` (0x10ffff) nor a surrogate (0xd800..=0xdfff).
+//
+// This mimics `char_try_from_u32` from the Rust standard library, which
+// needs a single comparison: XOR-ing with 0xd800 maps the surrogates to
+// 0..0x800 (and keeps all other values at or above 0x800), so the wrapping
+// subtraction turns them into huge values, like the values above `char::MAX`.
+// The lack of branches also lets compilers vectorize loops over many values.
+constexpr bool IsValidCharValue(std::uint32_t value) {
+  return (value ^ 0xd800) - 0x800 < 0x110000 - 0x800;
+}
+
+}  // namespace internal
 
 // `rs_std::rs_char` is a C++ representation of the `char` type from Rust.
 // `rust_builtin_type_abi_assumptions.md` documents the ABI compatibility of
@@ -40,16 +55,7 @@ class CRUBIT_INTERNAL_RUST_TYPE("char") CRUBIT_INTERNAL_SAME_ABI rs_char final {
   // This function mimics Rust's `char::from_u32`:
   // https://doc.rust-lang.org/std/primitive.char.html#method.from_u32
   static constexpr std::optional<rs_char> from_u32(char32_t c) {
-    // TODO(lukasza): Consider using slightly more efficient checks similarly
-    // to how `char_try_from_u32` is implemented in Rust standard library.
-    if (ABSL_PREDICT_FALSE(c > 0x10ffff)) {
-      // Value greater than Rust's `char::MAX`:
-      // https://doc.rust-lang.org/std/primitive.char.html#associatedconstant.MAX
-      return std::nullopt;
-    }
-
-    if (ABSL_PREDICT_FALSE(c >= 0xd800 && c <= 0xdfff)) {
-      // Surrogate characters.
+    if (ABSL_PREDICT_FALSE(!internal::IsValidCharValue(c))) {
       return std::nullopt;
     }
 
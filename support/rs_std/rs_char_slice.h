@@ -0,0 +1,74 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_SUPPORT_RS_STD_RS_CHAR_SLICE_H_
+#define CRUBIT_SUPPORT_RS_STD_RS_CHAR_SLICE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "absl/base/optimization.h"
+#include "absl/types/span.h"
+#include "support/rs_std/rs_char.h"
+#include "support/rs_std/slice_ref.h"
+
+// Bulk conversions between `char32_t` buffers and slices of Rust `char`s
+// (`&[char]`), which validate all the values in one pass instead of calling
+// `rs_char::from_u32` for each of them.
+//
+// These live in a separate header from `rs_char.h`, so that `rs_char` doesn't
+// depend on `slice_ref` (which requires C++20).
+
+namespace rs_std {
+
+static_assert(sizeof(char32_t) == sizeof(rs_char));
+static_assert(alignof(char32_t) == alignof(rs_char));
+
+// Returns whether all of `chars` are valid `rs_char`s (see
+// `rs_char::from_u32`).
+inline bool is_valid_u32_span(absl::Span<const char32_t> chars) {
+  // The values of a block are checked without branching on each of them, so
+  // that the compiler can vectorize the range checks. Checking the result
+  // once per block still stops early at the first invalid block.
+  constexpr size_t kBlockSize = 64;
+  const char32_t* data = chars.data();
+  const size_t size = chars.size();
+  size_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize) {
+    uint32_t invalid = 0;
+    for (size_t j = 0; j < kBlockSize; ++j) {
+      invalid |= !internal::IsValidCharValue(data[i + j]);
+    }
+    if (ABSL_PREDICT_FALSE(invalid != 0)) return false;
+  }
+  uint32_t invalid = 0;
+  for (; i < size; ++i) {
+    invalid |= !internal::IsValidCharValue(data[i]);
+  }
+  return invalid == 0;
+}
+
+// Returns `chars` as a slice of `rs_char`s (e.g. to pass them to Rust as a
+// `&[char]`), or `std::nullopt` if any of them is not a valid `rs_char`.
+//
+// The values are not copied: the returned slice points into `chars`.
+inline std::optional<SliceRef<const rs_char>> from_u32_span(
+    absl::Span<const char32_t> chars) {
+  if (ABSL_PREDICT_FALSE(!is_valid_u32_span(chars))) return std::nullopt;
+  return SliceRef<const rs_char>(absl::Span<const rs_char>(
+      reinterpret_cast<const rs_char*>(chars.data()), chars.size()));
+}
+
+// Returns the values of `chars` (e.g. of a `&[char]` received from Rust) as
+// `char32_t`s. All `rs_char`s are valid `char32_t`s, so no validation is
+// needed, and the values are not copied.
+inline absl::Span<const char32_t> to_u32_span(SliceRef<const rs_char> chars) {
+  return absl::Span<const char32_t>(
+      reinterpret_cast<const char32_t*>(chars.data()), chars.size());
+}
+
+}  // namespace rs_std
+
+#endif  // CRUBIT_SUPPORT_RS_STD_RS_CHAR_SLICE_H_
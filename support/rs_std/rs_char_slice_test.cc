@@ -0,0 +1,75 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/rs_char_slice.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/types/span.h"
+#include "support/rs_std/rs_char.h"
+#include "support/rs_std/slice_ref.h"
+
+namespace {
+
+TEST(RsCharSliceTest, Empty) {
+  EXPECT_TRUE(rs_std::is_valid_u32_span({}));
+  std::optional<rs_std::SliceRef<const rs_std::rs_char>> slice =
+      rs_std::from_u32_span({});
+  ASSERT_TRUE(slice.has_value());
+  EXPECT_EQ(slice->size(), 0);
+}
+
+TEST(RsCharSliceTest, RoundTripDoesNotCopy) {
+  std::vector<char32_t> chars(1000, U'🦀');
+  chars[0] = 0;
+  chars.back() = 0x10ffff;
+  std::optional<rs_std::SliceRef<const rs_std::rs_char>> slice =
+      rs_std::from_u32_span(chars);
+  ASSERT_TRUE(slice.has_value());
+  EXPECT_EQ(static_cast<const void*>(slice->data()), chars.data());
+  ASSERT_EQ(slice->size(), chars.size());
+  EXPECT_EQ(uint32_t{slice->data()[1]}, 0x1F980);
+  EXPECT_EQ(slice->data()[999], rs_std::rs_char::MAX);
+
+  absl::Span<const char32_t> u32s = rs_std::to_u32_span(*slice);
+  EXPECT_EQ(u32s.data(), chars.data());
+  EXPECT_EQ(u32s.size(), chars.size());
+}
+
+// Checks that an invalid value is detected at every position, both in the
+// blocks that are checked together and in the remainder after them.
+TEST(RsCharSliceTest, InvalidValuesAtEveryPosition) {
+  for (char32_t invalid : {char32_t{0xd800}, char32_t{0xdfff},
+                           char32_t{0x110000}, char32_t{0xffffffff}}) {
+    std::vector<char32_t> chars(150, U'a');
+    for (size_t i = 0; i < chars.size(); ++i) {
+      chars[i] = invalid;
+      EXPECT_FALSE(rs_std::is_valid_u32_span(chars)) << i;
+      EXPECT_FALSE(rs_std::from_u32_span(chars).has_value()) << i;
+      chars[i] = U'a';
+    }
+    EXPECT_TRUE(rs_std::is_valid_u32_span(chars));
+  }
+}
+
+// Checks that the bulk validation agrees with `rs_char::from_u32` around the
+// boundaries of the valid ranges.
+TEST(RsCharSliceTest, AgreesWithFromU32) {
+  for (uint32_t boundary : {0x0u, 0xd800u, 0xe000u, 0x110000u, 0xffffffffu}) {
+    for (uint32_t delta = 0; delta < 4; ++delta) {
+      for (uint32_t value : {boundary + delta, boundary - delta - 1}) {
+        char32_t c = value;
+        EXPECT_EQ(rs_std::is_valid_u32_span(absl::MakeConstSpan(&c, 1)),
+                  rs_std::rs_char::from_u32(c).has_value())
+            << value;
+      }
+    }
+  }
+}
+
+}  // namespace
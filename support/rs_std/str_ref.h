@@ -0,0 +1,137 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_STRREF_H_
+#define THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_STRREF_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+
+namespace rs_std {
+
+// `rs_std::StrRef` is a C++ representation of a reference to a Rust string
+// slice (a `&str`): a borrowed sequence of bytes that is always valid UTF-8.
+// `StrRef` is trivially destructible, copyable, and moveable, and it converts to
+// `std::string_view` without copying the string.
+// `rust_builtin_type_abi_assumptions.md` documents the ABI compatibility of
+// these types.
+class ABSL_ATTRIBUTE_TRIVIAL_ABI StrRef final {
+ public:
+  // Creates a default `StrRef` - one that represents an empty string.
+  // To mirror `&str` in Rust, the data pointer is not null.
+  constexpr StrRef() noexcept : ptr_(1), size_(0) {}
+
+  // Converts a `std::string_view` into a `rs_std::StrRef`.
+  //
+  // Returns `std::nullopt` if `s` is not valid UTF-8. This function mimics
+  // Rust's `std::str::from_utf8`:
+  // https://doc.rust-lang.org/std/str/fn.from_utf8.html
+  static std::optional<StrRef> from_utf8(std::string_view s) noexcept {
+    if (ABSL_PREDICT_FALSE(!IsValidUtf8(s))) {
+      return std::nullopt;
+    }
+    return from_utf8_unchecked(s);
+  }
+
+  // Converts a `std::string_view` into a `rs_std::StrRef`, without checking
+  // that `s` is valid UTF-8.
+  //
+  // SAFETY REQUIREMENTS: `s` is valid UTF-8.
+  //
+  // This function cannot be constexpr because it calls `reinterpret_cast` (see
+  // also the constructors of `rs_std::SliceRef`).
+  static StrRef from_utf8_unchecked(std::string_view s) noexcept {
+    return StrRef(s.empty() ? 1 : reinterpret_cast<uintptr_t>(s.data()),
+                  s.size());
+  }
+
+  constexpr StrRef(const StrRef&) = default;
+  constexpr StrRef& operator=(const StrRef&) = default;
+  constexpr StrRef(StrRef&&) = default;
+  constexpr StrRef& operator=(StrRef&&) = default;
+  ~StrRef() = default;
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  operator std::string_view() const { return to_string_view(); }
+
+  // The `reinterpret_cast` is safe thanks to invariant (2) (see the definition
+  // of `ptr_`).
+  const char* data() const {
+    return size_ > 0 ? reinterpret_cast<const char*>(ptr_) : nullptr;
+  }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  std::string_view to_string_view() const {
+    return std::string_view(data(), size());
+  }
+
+ private:
+  constexpr StrRef(uintptr_t ptr, size_t size) noexcept
+      : ptr_(ptr), size_(size) {}
+
+  // Returns whether `s` is valid UTF-8, using the same rules as Rust (i.e.
+  // rejecting overlong encodings, surrogates, and code points above
+  // `char::MAX`).
+  static constexpr bool IsValidUtf8(std::string_view s) noexcept {
+    size_t i = 0;
+    while (i < s.size()) {
+      const unsigned char lead = static_cast<unsigned char>(s[i]);
+      if (lead < 0x80) {
+        ++i;
+        continue;
+      }
+
+      // The number of bytes in the encoding of the code point, and the range
+      // of valid values of its second byte.
+      size_t len;
+      unsigned char min_second = 0x80;
+      unsigned char max_second = 0xBF;
+      if (lead >= 0xC2 && lead <= 0xDF) {
+        len = 2;
+      } else if (lead >= 0xE0 && lead <= 0xEF) {
+        len = 3;
+        if (lead == 0xE0) min_second = 0xA0;  // Overlong encodings.
+        if (lead == 0xED) max_second = 0x9F;  // Surrogates.
+      } else if (lead >= 0xF0 && lead <= 0xF4) {
+        len = 4;
+        if (lead == 0xF0) min_second = 0x90;  // Overlong encodings.
+        if (lead == 0xF4) max_second = 0x8F;  // Above `char::MAX`.
+      } else {
+        return false;
+      }
+
+      if (s.size() - i < len) {
+        return false;
+      }
+      const unsigned char second = static_cast<unsigned char>(s[i + 1]);
+      if (second < min_second || second > max_second) {
+        return false;
+      }
+      for (size_t j = 2; j < len; ++j) {
+        if ((static_cast<unsigned char>(s[i + j]) & 0xC0) != 0x80) {
+          return false;
+        }
+      }
+      i += len;
+    }
+    return true;
+  }
+
+  // Stick to the following invariants when changing the data member values:
+  // (1) `ptr_` is never 0 (to mirror `&str` in Rust).
+  // (2) if `size_ > 0` then `reinterpret_cast<const char*>(ptr_)` is a valid
+  //     pointer to `size_` bytes of valid UTF-8.
+  uintptr_t ptr_;
+  size_t size_;
+};
+
+}  // namespace rs_std
+
+#endif  // THIRD_PARTY_CRUBIT_SUPPORT_RS_STD_STRREF_H_
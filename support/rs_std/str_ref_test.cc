@@ -0,0 +1,96 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "support/rs_std/str_ref.h"
+
+#include <stdint.h>
+
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+using ::testing::IsNull;
+using ::testing::Not;
+
+// Check that `rs_std::StrRef` is trivially destructible, copyable, and
+// moveable, like `rs_std::SliceRef`.
+static_assert(std::is_nothrow_constructible_v<rs_std::StrRef>);
+static_assert(std::is_trivially_destructible_v<rs_std::StrRef>);
+static_assert(std::is_trivially_copyable_v<rs_std::StrRef>);
+static_assert(std::is_trivially_copy_constructible_v<rs_std::StrRef>);
+static_assert(std::is_trivially_copy_assignable_v<rs_std::StrRef>);
+static_assert(std::is_trivially_move_constructible_v<rs_std::StrRef>);
+static_assert(std::is_trivially_move_assignable_v<rs_std::StrRef>);
+
+// There is no implicit conversion from `std::string_view`, because not every
+// `std::string_view` is valid UTF-8.
+static_assert(!std::is_convertible_v<std::string_view, rs_std::StrRef>);
+static_assert(std::is_convertible_v<rs_std::StrRef, std::string_view>);
+
+// Verify that the layout of `rs_std::StrRef` is the same as the layout of
+// `rs_std::SliceRef<const char>`, as described in
+// `rust_builtin_type_abi_assumptions.md`.
+static_assert(sizeof(rs_std::StrRef) == sizeof(uintptr_t) * 2);
+static_assert(alignof(rs_std::StrRef) == alignof(uintptr_t));
+static_assert(std::is_standard_layout_v<rs_std::StrRef>);
+
+// To test the value of `ptr_`, the test includes the knowledge of `StrRef`'s
+// layout to extract it via a peeker struct.
+struct StrRefFields {
+  const void* ptr;
+  size_t size;
+};
+
+TEST(StrRefTest, FromUtf8) {
+  static constexpr std::string_view kStr = "Hello, wörld! \U0001F980";
+  const std::optional<rs_std::StrRef> s = rs_std::StrRef::from_utf8(kStr);
+  ASSERT_TRUE(s.has_value());
+  EXPECT_EQ(s->to_string_view(), kStr);
+  EXPECT_EQ(std::string_view(*s), kStr);
+  EXPECT_EQ(s->size(), kStr.size());
+
+  const auto fields = std::bit_cast<StrRefFields>(*s);
+  EXPECT_EQ(fields.ptr, kStr.data());
+  EXPECT_EQ(fields.size, kStr.size());
+}
+
+TEST(StrRefTest, FromInvalidUtf8) {
+  for (std::string_view invalid : {
+           std::string_view("\x80"),              // Continuation byte.
+           std::string_view("\xC0\xAF"),          // Overlong encoding.
+           std::string_view("\xE0\x80\xAF"),      // Overlong encoding.
+           std::string_view("\xED\xA0\x80"),      // Surrogate.
+           std::string_view("\xF4\x90\x80\x80"),  // Above `char::MAX`.
+           std::string_view("\xF5\x80\x80\x80"),  // Invalid lead byte.
+           std::string_view("abc\xE2\x82"),       // Truncated.
+           std::string_view("\xE2\x28\xA1"),      // Invalid continuation.
+       }) {
+    EXPECT_EQ(rs_std::StrRef::from_utf8(invalid), std::nullopt)
+        << "Unexpectedly valid: " << testing::PrintToString(std::string(invalid));
+  }
+}
+
+TEST(StrRefTest, Empty) {
+  const rs_std::StrRef empty = *rs_std::StrRef::from_utf8("");
+  static constexpr rs_std::StrRef default_constructed;
+  EXPECT_EQ(empty.to_string_view(), default_constructed.to_string_view());
+  EXPECT_TRUE(empty.empty());
+
+  const auto fields = std::bit_cast<StrRefFields>(empty);
+  EXPECT_THAT(fields.ptr, Not(IsNull()));
+  EXPECT_EQ(fields.size, 0);
+
+  // While `empty.ptr_` is not null, `data()` converts it to null for
+  // compatibility with `std::string_view`.
+  EXPECT_THAT(empty.data(), IsNull());
+}
+
+}  // namespace